@@ -128,6 +128,24 @@ typedef struct EbSvtAv1DecConfiguration {
  *
  * Default is 0. */
     EbBool is_16bit_pipeline;
+
+    /* Callbacks used to allocate and release the memory holding the decoded
+     * frames. When both are set, reference and output pictures live in buffers
+     * owned by the application and svt_av1_dec_get_picture() returns pointers
+     * into them instead of copying (unless film grain has to be applied or an
+     * 8-bit output is produced from the 16-bit pipeline). In that mode the
+     * application must not allocate or free the planes of the output
+     * EbSvtIOFormat, and the planes are only valid until the next call to
+     * svt_av1_dec_frame(). Either both or none of the callbacks must be set.
+     *
+     * Default is NULL. */
+    EbAllocateFrameBuffer get_frame_buffer;
+    EbReleaseFrameBuffer  release_frame_buffer;
+
+    /* Private data passed back to the frame buffer callbacks.
+     *
+     * Default is NULL. */
+    void *frame_buffer_priv;
 } EbSvtAv1DecConfiguration;
 
 /* STEP 1: Call the library to construct a Component Handle.
@@ -82,6 +82,68 @@ typedef struct SvtAv1FixedBuf {
     uint64_t sz; /**< Length of the buffer, in chars */
 } SvtAv1FixedBuf; /**< alias for struct aom_fixed_buf */
 
+/*!\brief Statistics of one pipeline stage
+ *
+ * Collected on the input queue of the stage when
+ * EbSvtAv1EncConfiguration.stage_stats is set. Times are in microseconds.
+ */
+typedef struct SvtAv1StageStats {
+    const char *name; /**< Name of the stage */
+    uint32_t    process_count; /**< Threads of the stage, 0 on the task scheduler */
+    uint32_t    max_queue_depth; /**< Most objects waiting in the input queue */
+    uint64_t    posted_count; /**< Objects posted to the stage */
+    uint64_t    queue_depth_sum; /**< Sum of the queue depths seen by each post */
+    uint64_t    queue_time; /**< Total time objects waited in the input queue */
+    uint64_t    max_queue_time; /**< Longest time an object waited in the input queue */
+    uint64_t    busy_time; /**< Total time the stage spent processing objects */
+    uint64_t    empty_wait_time; /**< Time the previous stages waited for a free object */
+} SvtAv1StageStats;
+
+/* Callback giving back input planes referenced by the encoder, see
+ * EbSvtAv1EncConfiguration.release_input.
+ * Parameters:
+ * @  priv          EbSvtAv1EncConfiguration.release_input_priv.
+ * @  planes        copy of the EbSvtIOFormat passed to svt_av1_enc_send_picture().
+ * @  p_app_private p_app_private of the EbBufferHeaderType passed with the planes. */
+typedef void (*EbReleaseInput)(void *priv, const EbSvtIOFormat *planes, void *p_app_private);
+
+/*!\brief Layout of the input planes referenced by the encoder
+ *
+ * See EbSvtAv1EncConfiguration.release_input. Paddings are in luma samples, the
+ * chroma planes use half of each.
+ */
+typedef struct SvtAv1InputLayout {
+    uint32_t y_stride; /**< Luma stride, in samples */
+    uint32_t chroma_stride; /**< Stride of both chroma planes, in samples */
+    uint32_t left_padding; /**< Writable columns before the first column of the picture */
+    uint32_t top_padding; /**< Writable rows above the first row of the picture */
+    uint32_t bottom_padding; /**< Writable rows below the last row of the picture */
+} SvtAv1InputLayout;
+
+/* Callback receiving a temporal unit of the bitstream, see
+ * EbSvtAv1EncConfiguration.write_packet.
+ * Parameters:
+ * @  priv            EbSvtAv1EncConfiguration.write_packet_priv.
+ * @  packet          pts, flags and statistics of the temporal unit, n_filled_len is its size.
+ * @  chunk_array     the temporal unit is the concatenation of these chunk_count chunks,
+ *                    only valid during the call.
+ * @  chunk_size_array size of each chunk in bytes. */
+typedef void (*EbWritePacket)(void *priv, const EbBufferHeaderType *packet,
+                              const uint8_t *const *chunk_array,
+                              const uint32_t *chunk_size_array, uint32_t chunk_count);
+
+/*!\brief Rate control targets that can change while encoding
+ *
+ * See svt_av1_enc_update_rate_control(). The fields have the meaning and the
+ * limits of the EbSvtAv1EncConfiguration fields of the same name.
+ */
+typedef struct SvtAv1RateControlTargets {
+    uint32_t target_bit_rate; /**< Target bitrate, in bits/second */
+    uint32_t vbv_bufsize; /**< VBV buffer size, in bits, 0 to follow target_bit_rate */
+    uint32_t max_qp_allowed; /**< Maximum QP given to a picture */
+    uint32_t min_qp_allowed; /**< Minimum QP given to a picture */
+} SvtAv1RateControlTargets;
+
 // Will contain the EbEncApi which will live in the EncHandle class
 // Only modifiable during config-time.
 typedef struct EbSvtAv1EncConfiguration {
@@ -637,6 +699,90 @@ typedef struct EbSvtAv1EncConfiguration {
      * Default is -1. */
     int32_t target_socket;
 
+    /* Run motion estimation, encdec, cdef, entropy coding and the quality
+     * metrics on one pool of worker threads, one per logical processor, instead
+     * of a thread pool per stage. The other stages keep their own threads.
+     * Each worker has its own locked task queue and idle workers steal the
+     * oldest task of the other queues.
+     *
+     * Default is 0. */
+    uint32_t task_scheduler;
+
+    /* Collect the queue depth, queue latency and busy time of every pipeline
+     * stage, read back with svt_av1_enc_get_stage_stats.
+     *
+     * Default is 0. */
+    uint32_t stage_stats;
+
+    /* Called by the packetization thread with each temporal unit, in output order,
+     * straight from the encoder's frame buffers. The packets returned by
+     * svt_av1_enc_get_packet() then carry no bitstream: p_buffer is NULL and
+     * n_filled_len is the size of the temporal unit already handed to the callback.
+     *
+     * Default is NULL. */
+    EbWritePacket write_packet;
+
+    /* Private data passed back to write_packet.
+     *
+     * Default is NULL. */
+    void *write_packet_priv;
+
+    /* When set, svt_av1_enc_send_picture() does not copy the input planes: the
+     * encoder works on the planes of the application and calls release_input,
+     * from one of its threads, once it is done with them. The planes must follow
+     * the layout returned by svt_av1_enc_get_input_layout(), including the
+     * padding around the picture, and stay valid until they are released.
+     * svt_av1_enc_send_picture() rejects planes with other strides or whose
+     * padded areas overlap. The encoder writes into the padding and may filter
+     * the picture in place.
+     * Pictures still in the encoder at svt_av1_enc_deinit() are not released.
+     * Only 8-bit 4:2:0 input is supported.
+     *
+     * Default is NULL. */
+    EbReleaseInput release_input;
+
+    /* Private data passed back to release_input.
+     *
+     * Default is NULL. */
+    void *release_input_priv;
+
+    /* Construct only the input, picture control set and reference picture buffers
+     * the pipeline needs to make progress at init, and add more, up to the usual
+     * counts, when a stage has to wait for a free buffer.
+     *
+     * Default is 0. */
+    uint32_t elastic_buffers;
+
+    /* With elastic_buffers, time in milliseconds a buffer pool has to go without
+     * any stage waiting for a free buffer before its extra buffers are freed again.
+     * 0 keeps them until svt_av1_enc_deinit().
+     *
+     * Default is 0. */
+    uint32_t elastic_shrink_time;
+
+    /* Non zero id of a shared engine. The encoders of one process initialized with
+     * the same shared_engine, active_channel_count and logical processor count run
+     * on one task scheduler, taking turns on its worker threads, and take their
+     * reference picture buffers from common pools when their resolution and
+     * coding tools match. Each encoder needs its own channel_id, below
+     * active_channel_count. Implies task_scheduler.
+     *
+     * Default is 0. */
+    uint32_t shared_engine;
+
+    /* Back the picture buffers with huge pages, which cuts the TLB misses of the
+     * motion search and filtering passes on large frames. With target_socket set,
+     * the buffers are also placed on the memory node of that socket. Each encoder
+     * keeps its own setting, encoders of a shared engine only share reference
+     * pictures when their settings match.
+     *
+     * 0 = Off.
+     * 1 = Transparent huge pages, where the OS provides them.
+     * 2 = Explicit huge pages, falling back to 1 when none are reserved.
+     *
+     * Default is 0. */
+    uint32_t huge_pages;
+
     // Debug tools
 
     /* Output reconstructed yuv used for debug purposes. The value is set through
@@ -649,6 +795,12 @@ typedef struct EbSvtAv1EncConfiguration {
         * Default is 0. */
     int32_t tile_columns;
     int32_t tile_rows;
+    /* Encode decode each tile as an independent work unit with its own segment
+     * wavefront, instead of one wavefront across all the tile columns. Removes
+     * the wavefront start-up and drain phases between tiles of a tile row.
+     *
+     * Default is 0. */
+    uint32_t tile_parallel_enc_dec;
 
     /* To be deprecated.
  * Encoder configuration parameters below this line are to be deprecated. */
@@ -803,6 +955,53 @@ EB_API EbErrorType svt_av1_get_recon(EbComponentType *   svt_enc_component,
 EB_API EbErrorType svt_av1_enc_get_stream_info(EbComponentType *svt_enc_component,
                                                uint32_t stream_info_id, void *info);
 
+/* OPTIONAL: get the statistics of the pipeline stages
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *stats              output, array of stage_count entries, may be NULL.
+     * @ *stage_count        input, size of stats. output, number of stages.
+     * Returns EB_ErrorBadParameter when stage_stats is not enabled. */
+EB_API EbErrorType svt_av1_enc_get_stage_stats(EbComponentType *svt_enc_component,
+                                               SvtAv1StageStats *stats, uint32_t *stage_count);
+
+/* OPTIONAL: get the layout of the input planes when release_input is set
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler, after svt_av1_enc_init().
+     * @ *layout             output, layout the input planes must follow.
+     * Returns EB_ErrorBadParameter when release_input is not set. */
+EB_API EbErrorType svt_av1_enc_get_input_layout(EbComponentType *  svt_enc_component,
+                                                SvtAv1InputLayout *layout);
+
+/* OPTIONAL: Get the encoder ready for a new stream with the same configuration,
+     * keeping its threads and buffers. The next picture sent starts a new sequence
+     * with a key frame, sequence header and fresh rate control, as after
+     * svt_av1_enc_init(). Only valid once svt_av1_enc_get_packet() returned the
+     * packet flagged EB_BUFFERFLAG_EOS and, with recon_enabled, every recon was
+     * read back with svt_av1_get_recon(). Input planes still referenced with
+     * release_input are released. Not available with multi-pass encoding.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler, after svt_av1_enc_init().
+     * Returns EB_ErrorBadParameter when the stream is not finished. */
+EB_API EbErrorType svt_av1_enc_reset(EbComponentType *svt_enc_component);
+
+/* OPTIONAL: Change the rate control targets of the stream being encoded, without
+     * re-initializing the encoder or forcing a key frame. The new targets apply from
+     * the first mini-GOP starting with, or after, the next picture sent; the pictures
+     * before it keep their targets. Only available with rate control
+     * (rate_control_mode 1 or 2) and single-pass encoding. Call it from the thread
+     * sending the pictures. A stream started by svt_av1_enc_reset() goes back to the
+     * configured targets, unless an update is still pending.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler, after svt_av1_enc_init().
+     * @ *targets            new targets, copied by the library.
+     * Returns EB_ErrorBadParameter for invalid targets or configuration. */
+EB_API EbErrorType svt_av1_enc_update_rate_control(EbComponentType *svt_enc_component,
+                                                   const SvtAv1RateControlTargets *targets);
+
 /* STEP 6: Deinitialize encoder library.
      *
      * Parameter:
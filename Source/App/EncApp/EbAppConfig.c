@@ -17,6 +17,7 @@
 #include "EbAppConfig.h"
 #include "EbAppContext.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputReader.h"
 #ifdef _WIN32
 #include <windows.h>
 #include <io.h>
@@ -56,6 +57,11 @@
 #define HEIGHT_TOKEN "-h"
 #define NUMBER_OF_PICTURES_TOKEN "-n"
 #define BUFFERED_INPUT_TOKEN "-nb"
+#define MMAP_INPUT_TOKEN "-mmap-input"
+#define DIRECT_OUTPUT_TOKEN "-direct-output"
+#define ZERO_COPY_INPUT_TOKEN "-zero-copy-input"
+#define SEGMENT_FRAMES_TOKEN "-segment-frames"
+#define RC_UPDATE_TOKEN "-rc-update"
 #define NO_PROGRESS_TOKEN "--no-progress" // tbd if it should be removed
 #define PROGRESS_TOKEN "--progress"
 #define BASE_LAYER_SWITCH_MODE_TOKEN "-base-layer-switch-mode" // no Eval
@@ -147,6 +153,7 @@
 #define SUPER_BLOCK_SIZE_TOKEN "-sb-size"
 #define TILE_ROW_TOKEN "-tile-rows"
 #define TILE_COL_TOKEN "-tile-columns"
+#define TILE_PARALLEL_TOKEN "-tile-parallel"
 
 #define SQ_WEIGHT_TOKEN "-sqw"
 #define CHROMA_MODE_TOKEN "-chroma-mode"
@@ -160,6 +167,12 @@
 #define THREAD_MGMNT "-lp"
 #define UNPIN_TOKEN "-unpin"
 #define TARGET_SOCKET "-ss"
+#define TASK_SCHEDULER_TOKEN "-task-scheduler"
+#define STAGE_STATS_TOKEN "-stage-stats"
+#define ELASTIC_BUFFERS_TOKEN "-elastic-buffers"
+#define ELASTIC_SHRINK_TIME_TOKEN "-elastic-shrink-time"
+#define SHARED_ENGINE_TOKEN "-shared-engine"
+#define HUGE_PAGES_TOKEN "-huge-pages"
 #define UNRESTRICTED_MOTION_VECTOR "-umv"
 #define CONFIG_FILE_COMMENT_CHAR '#'
 #define CONFIG_FILE_NEWLINE_CHAR '\n'
@@ -363,6 +376,23 @@ static void set_cfg_frames_to_be_encoded(const char *value, EbConfig *cfg) {
 static void set_buffered_input(const char *value, EbConfig *cfg) {
     cfg->buffered_input = strtol(value, NULL, 0);
 };
+static void set_mmap_input(const char *value, EbConfig *cfg) {
+    cfg->mmap_input = (EbBool)strtol(value, NULL, 0);
+};
+static void set_direct_output(const char *value, EbConfig *cfg) {
+    cfg->direct_output = (EbBool)strtol(value, NULL, 0);
+};
+static void set_zero_copy_input(const char *value, EbConfig *cfg) {
+    cfg->zero_copy_input = (EbBool)strtol(value, NULL, 0);
+};
+static void set_segment_frames(const char *value, EbConfig *cfg) {
+    cfg->segment_frames = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_rc_update(const char *value, EbConfig *cfg) {
+    char *end;
+    cfg->rc_update_frame = strtoull(value, &end, 0);
+    cfg->rc_update_bit_rate = *end == ':' ? 1000 * (uint32_t)strtoul(end + 1, NULL, 0) : 0;
+};
 static void set_no_progress(const char *value, EbConfig *cfg) {
     switch (value ? *value : '1') {
     case '0': cfg->progress = 1; break; // equal to --progress 1
@@ -523,6 +553,9 @@ static void set_tile_row(const char *value, EbConfig *cfg) {
 static void set_tile_col(const char *value, EbConfig *cfg) {
     cfg->config.tile_columns = strtoul(value, NULL, 0);
 };
+static void set_tile_parallel(const char *value, EbConfig *cfg) {
+    cfg->config.tile_parallel_enc_dec = (uint32_t)strtoul(value, NULL, 0);
+};
 static void set_scene_change_detection(const char *value, EbConfig *cfg) {
     cfg->config.scene_change_detection = strtoul(value, NULL, 0);
 }
@@ -703,6 +736,24 @@ static void set_unpin_execution(const char *value, EbConfig *cfg) {
 static void set_target_socket(const char *value, EbConfig *cfg) {
     cfg->config.target_socket = (int32_t)strtol(value, NULL, 0);
 };
+static void set_task_scheduler(const char *value, EbConfig *cfg) {
+    cfg->config.task_scheduler = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_stage_stats(const char *value, EbConfig *cfg) {
+    cfg->config.stage_stats = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_elastic_buffers(const char *value, EbConfig *cfg) {
+    cfg->config.elastic_buffers = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_elastic_shrink_time(const char *value, EbConfig *cfg) {
+    cfg->config.elastic_shrink_time = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_shared_engine(const char *value, EbConfig *cfg) {
+    cfg->config.shared_engine = (uint32_t)strtoul(value, NULL, 0);
+};
+static void set_huge_pages(const char *value, EbConfig *cfg) {
+    cfg->config.huge_pages = (uint32_t)strtoul(value, NULL, 0);
+};
 static void set_unrestricted_motion_vector(const char *value, EbConfig *cfg) {
     cfg->config.unrestricted_motion_vector = (EbBool)strtol(value, NULL, 0);
 };
@@ -759,6 +810,32 @@ ConfigEntry config_entry_global_options[] = {
      set_cfg_frames_to_be_encoded},
 
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "Buffer n input frames", set_buffered_input},
+    {SINGLE_INPUT,
+     MMAP_INPUT_TOKEN,
+     "Map input files to memory and read pipes ahead on a separate thread, instead of reading "
+     "every plane with fread (0: OFF [default], 1: ON)",
+     set_mmap_input},
+    {SINGLE_INPUT,
+     DIRECT_OUTPUT_TOKEN,
+     "Write the bitstream from the encoder's frame buffers through the write_packet callback, "
+     "instead of copying every temporal unit into the output packet (0: OFF [default], 1: ON)",
+     set_direct_output},
+    {SINGLE_INPUT,
+     ZERO_COPY_INPUT_TOKEN,
+     "Read 8-bit 4:2:0 files into padded frames the encoder uses in place, and gets back "
+     "through the release_input callback, instead of copying every picture (0: OFF [default], "
+     "1: ON)",
+     set_zero_copy_input},
+    {SINGLE_INPUT,
+     SEGMENT_FRAMES_TOKEN,
+     "Encode the input as independent streams of n frames, resetting the encoder between "
+     "them instead of creating a new one (0: OFF [default])",
+     set_segment_frames},
+    {SINGLE_INPUT,
+     RC_UPDATE_TOKEN,
+     "Change the target bitrate while encoding, given as frame:kbps, with "
+     "svt_av1_enc_update_rate_control (VBR and CVBR only)",
+     set_rc_update},
     {SINGLE_INPUT,
      PROGRESS_TOKEN,
      "Change verbosity of the output (0: no progress is printed, 1: default, 2: aomenc style "
@@ -833,6 +910,37 @@ ConfigEntry config_entry_global_options[] = {
      "Specify  which socket the encoder runs on"
      "--unpin is overwritten to 0 when --ss is set to 0 or 1",
      set_target_socket},
+    {SINGLE_INPUT,
+     TASK_SCHEDULER_TOKEN,
+     "Run motion estimation, encdec, cdef, entropy coding and the quality metrics on one pool "
+     "of --lp worker threads with work stealing, the other stages keep their own threads ( 0: "
+     "OFF [default], 1: ON)",
+     set_task_scheduler},
+    {SINGLE_INPUT,
+     STAGE_STATS_TOKEN,
+     "Print the queue depth, queue latency and busy time of every pipeline stage at the end "
+     "of the encode ( 0: OFF [default], 1: ON)",
+     set_stage_stats},
+    {SINGLE_INPUT,
+     ELASTIC_BUFFERS_TOKEN,
+     "Allocate the minimum picture buffers at init and add more only when a stage waits for "
+     "one ( 0: OFF [default], 1: ON)",
+     set_elastic_buffers},
+    {SINGLE_INPUT,
+     ELASTIC_SHRINK_TIME_TOKEN,
+     "With --elastic-buffers, free the added picture buffers of a pool after it goes this many "
+     "ms without waiting ( 0: never [default])",
+     set_elastic_shrink_time},
+    {SINGLE_INPUT,
+     SHARED_ENGINE_TOKEN,
+     "Run the channels of -nch with the same non zero id on one task scheduler, sharing its "
+     "worker threads and the reference picture buffers ( 0: OFF [default])",
+     set_shared_engine},
+    {SINGLE_INPUT,
+     HUGE_PAGES_TOKEN,
+     "Back the picture buffers with huge pages, on the node of --ss when set ( 0: OFF "
+     "[default], 1: transparent, 2: explicit, falling back to transparent)",
+     set_huge_pages},
     // Termination
     {SINGLE_INPUT, NULL, NULL, NULL}};
 
@@ -916,6 +1024,10 @@ ConfigEntry config_entry_specific[] = {
      set_compressed_ten_bit_format},
     {SINGLE_INPUT, TILE_ROW_TOKEN, "Number of tile rows to use, log2[0-6]", set_tile_row},
     {SINGLE_INPUT, TILE_COL_TOKEN, "Number of tile columns to use, log2[0-4]", set_tile_col},
+    {SINGLE_INPUT,
+     TILE_PARALLEL_TOKEN,
+     "Encode decode each tile as an independent work unit (0: OFF[default], 1: ON)",
+     set_tile_parallel},
     {SINGLE_INPUT, QP_TOKEN, "Constant/Constrained Quality level", set_cfg_qp},
     {SINGLE_INPUT, QP_LONG_TOKEN, "Constant/Constrained Quality level", set_cfg_qp},
 
@@ -1188,6 +1300,11 @@ ConfigEntry config_entry[] = {
     // Prediction Structure
     {SINGLE_INPUT, NUMBER_OF_PICTURES_TOKEN, "FrameToBeEncoded", set_cfg_frames_to_be_encoded},
     {SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "BufferedInput", set_buffered_input},
+    {SINGLE_INPUT, MMAP_INPUT_TOKEN, "MmapInput", set_mmap_input},
+    {SINGLE_INPUT, DIRECT_OUTPUT_TOKEN, "DirectOutput", set_direct_output},
+    {SINGLE_INPUT, ZERO_COPY_INPUT_TOKEN, "ZeroCopyInput", set_zero_copy_input},
+    {SINGLE_INPUT, SEGMENT_FRAMES_TOKEN, "SegmentFrames", set_segment_frames},
+    {SINGLE_INPUT, RC_UPDATE_TOKEN, "RateControlUpdate", set_rc_update},
     {SINGLE_INPUT, PROGRESS_TOKEN, "Progress", set_progress},
     {SINGLE_INPUT, NO_PROGRESS_TOKEN, "NoProgress", set_no_progress},
     {SINGLE_INPUT, ENCMODE_TOKEN, "EncoderMode", set_enc_mode},
@@ -1210,6 +1327,7 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, PRED_STRUCT_TOKEN, "PredStructure", set_cfg_pred_structure},
     {SINGLE_INPUT, TILE_ROW_TOKEN, "TileRow", set_tile_row},
     {SINGLE_INPUT, TILE_COL_TOKEN, "TileCol", set_tile_col},
+    {SINGLE_INPUT, TILE_PARALLEL_TOKEN, "TileParallel", set_tile_parallel},
     // Rate Control
     {SINGLE_INPUT,
      SCENE_CHANGE_DETECTION_TOKEN,
@@ -1327,6 +1445,12 @@ ConfigEntry config_entry[] = {
     {SINGLE_INPUT, THREAD_MGMNT, "LogicalProcessors", set_logical_processors},
     {SINGLE_INPUT, UNPIN_TOKEN, "UnpinExecution", set_unpin_execution},
     {SINGLE_INPUT, TARGET_SOCKET, "TargetSocket", set_target_socket},
+    {SINGLE_INPUT, TASK_SCHEDULER_TOKEN, "TaskScheduler", set_task_scheduler},
+    {SINGLE_INPUT, STAGE_STATS_TOKEN, "StageStats", set_stage_stats},
+    {SINGLE_INPUT, ELASTIC_BUFFERS_TOKEN, "ElasticBuffers", set_elastic_buffers},
+    {SINGLE_INPUT, ELASTIC_SHRINK_TIME_TOKEN, "ElasticShrinkTime", set_elastic_shrink_time},
+    {SINGLE_INPUT, SHARED_ENGINE_TOKEN, "SharedEngine", set_shared_engine},
+    {SINGLE_INPUT, HUGE_PAGES_TOKEN, "HugePages", set_huge_pages},
     // Optional Features
     {SINGLE_INPUT,
      UNRESTRICTED_MOTION_VECTOR,
@@ -1469,6 +1593,8 @@ void svt_config_dtor(EbConfig *config_ptr) {
         config_ptr->config_file = (FILE *)NULL;
     }
 
+    input_reader_close(config_ptr);
+    input_pool_close(config_ptr);
     if (config_ptr->input_file) {
         if (!config_ptr->input_file_is_fifo)
             fclose(config_ptr->input_file);
@@ -1928,6 +2054,24 @@ static EbErrorType verify_settings(EbConfig *config, uint32_t channel_number) {
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->segment_frames &&
+        (config->pass != DEFAULT || config->input_stat_file || config->output_stat_file)) {
+        fprintf(config->error_log_file,
+                "Error instance %u: --segment-frames does not support multi-pass encoding\n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->rc_update_frame &&
+        (config->rc_update_bit_rate == 0 || config->config.rate_control_mode == 0 ||
+         config->pass != DEFAULT || config->input_stat_file || config->output_stat_file)) {
+        fprintf(config->error_log_file,
+                "Error instance %u: --rc-update takes frame:kbps, with VBR or CVBR single-pass "
+                "encoding\n",
+                channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->input_stat_file && config->output_stat_file) {
         fprintf(config->error_log_file,
                 "Error instance %u: do not set input_stat_file and output_stat_file at same time\n",
@@ -162,6 +162,9 @@ typedef struct EbPerformanceContext {
 
 } EbPerformanceContext;
 
+typedef struct InputReader InputReader;
+typedef struct InputPool   InputPool;
+
 typedef struct EbConfig {
     /****************************************
      * File I/O
@@ -201,6 +204,14 @@ typedef struct EbConfig {
     int32_t   frames_encoded;
     int32_t   buffered_input;
     uint8_t **sequence_buffer;
+    EbBool       mmap_input;
+    InputReader *input_reader; // NULL when the input is read with fread
+    EbBool       direct_output;
+    EbBool       zero_copy_input;
+    InputPool *  input_pool; // frames lent to the encoder with --zero-copy-input
+    uint32_t     segment_frames; // frames per stream, svt_av1_enc_reset between them
+    uint64_t     rc_update_frame; // frame sent with the --rc-update bitrate, 0 when unused
+    uint32_t     rc_update_bit_rate;
 
     uint32_t injector_frame_rate;
     uint32_t injector;
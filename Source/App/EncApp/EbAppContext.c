@@ -18,6 +18,7 @@
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
+#include "EbAppInputReader.h"
 
 #define IS_16_BIT(bit_depth) (bit_depth == 10 ? 1 : 0)
 
@@ -168,8 +169,8 @@ EbErrorType allocate_input_buffers(EbConfig *config, EbAppContext *callback_data
                   EB_N_PTR,
                   EB_ErrorInsufficientResources);
 
-    // Allocate frame buffer for the p_buffer
-    if (config->buffered_input == -1)
+    // Allocate frame buffer for the p_buffer, mapped input points the planes to the reader
+    if (config->buffered_input == -1 && !config->mmap_input && !config->zero_copy_input)
         allocate_frame_buffer(config, callback_data->input_buffer_pool->p_buffer);
 
     // Assign the variables
@@ -259,6 +260,9 @@ EbErrorType preload_frames_info_ram(EbConfig *config) {
 /***************************************
 * Functions Implementation
 ***************************************/
+void write_packet_to_file(void *priv, const EbBufferHeaderType *packet,
+                          const uint8_t *const *chunk_array, const uint32_t *chunk_size_array,
+                          uint32_t chunk_count);
 
 /***********************************
  * Initialize Core & Component
@@ -271,6 +275,23 @@ EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t
     // Initialize Port Activity Flags
     callback_data->output_stream_port_active = APP_PortActive;
 
+    // Let the encoder write the bitstream file from its own buffers
+    if (config->direct_output && config->bitstream_file) {
+        config->config.write_packet      = write_packet_to_file;
+        config->config.write_packet_priv = config;
+    }
+
+    // Lend padded frames to the encoder, the other input modes hold their own frames
+    if (config->zero_copy_input) {
+        if (config->config.encoder_bit_depth == 8 &&
+            config->config.encoder_color_format == EB_YUV420 && config->buffered_input == -1 &&
+            !config->mmap_input && config->input_file != stdin && !config->input_file_is_fifo) {
+            config->config.release_input      = input_pool_release;
+            config->config.release_input_priv = config;
+        } else
+            config->zero_copy_input = EB_FALSE;
+    }
+
     // Send over all configuration parameters
     // Set the Parameters
     EbErrorType return_error = svt_av1_enc_set_parameter(callback_data->svt_encoder_handle,
@@ -284,6 +305,16 @@ EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t
         return return_error;
     }
 
+    if (config->zero_copy_input) {
+        SvtAv1InputLayout layout;
+        return_error = svt_av1_enc_get_input_layout(callback_data->svt_encoder_handle, &layout);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+        return_error = input_pool_open(config, &layout);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+
     ///************************* LIBRARY INIT [END] *********************///
 
     ///********************** APPLICATION INIT [START] ******************///
@@ -302,8 +333,14 @@ EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t
     if (config->buffered_input != -1) {
         // Preload frames into the ram for a faster yuv access time
         preload_frames_info_ram(config);
-    } else
+    } else {
         config->sequence_buffer = 0;
+        if (config->mmap_input) {
+            return_error = input_reader_open(config);
+            if (return_error == EB_ErrorNone && !config->input_reader)
+                allocate_frame_buffer(config, callback_data->input_buffer_pool->p_buffer);
+        }
+    }
     ///********************** APPLICATION INIT [END] ******************////////
 
     return return_error;
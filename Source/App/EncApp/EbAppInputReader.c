@@ -0,0 +1,535 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/***************************************
+ * Includes
+ ***************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAppInputReader.h"
+#include "EbAppInputy4m.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define INPUT_READ_AHEAD_FRAMES 3
+#define Y4M_FRAME_DELIMITER_MAX 4096
+#define YUV4MPEG2_IND_SIZE 9
+
+typedef struct InputFrameSlot {
+    uint8_t *buffer;
+    uint32_t filled_len;
+} InputFrameSlot;
+
+struct InputReader {
+    uint32_t frame_size;
+
+    /* Memory mapped regular file */
+    uint8_t *map_ptr;
+    uint64_t map_size;
+    uint64_t data_offset; // first byte after the y4m header
+    uint64_t read_offset;
+#ifdef _WIN32
+    HANDLE map_handle;
+#endif
+
+    /* Read-ahead for pipes: slots are filled by the thread in order, and released
+     * by the encoder thread in the same order */
+    InputFrameSlot slot_array[INPUT_READ_AHEAD_FRAMES];
+    uint32_t       filled_count; // filled slots not released yet, the held one included
+    uint32_t       write_index;
+    uint32_t       read_index;
+    EbBool         holding_slot;
+    EbBool         end_of_stream;
+    volatile EbBool quit;
+#ifdef _WIN32
+    HANDLE             thread_handle;
+    CRITICAL_SECTION   lock;
+    CONDITION_VARIABLE slot_cond;
+#else
+    pthread_t       thread_handle;
+    pthread_mutex_t lock;
+    pthread_cond_t  slot_cond;
+#endif
+};
+
+#ifdef _WIN32
+#define READER_LOCK(r) EnterCriticalSection(&(r)->lock)
+#define READER_UNLOCK(r) LeaveCriticalSection(&(r)->lock)
+#define READER_WAIT(r) SleepConditionVariableCS(&(r)->slot_cond, &(r)->lock, INFINITE)
+#define READER_SIGNAL(r) WakeAllConditionVariable(&(r)->slot_cond)
+#else
+#define READER_LOCK(r) pthread_mutex_lock(&(r)->lock)
+#define READER_UNLOCK(r) pthread_mutex_unlock(&(r)->lock)
+#define READER_WAIT(r) pthread_cond_wait(&(r)->slot_cond, &(r)->lock)
+#define READER_SIGNAL(r) pthread_cond_broadcast(&(r)->slot_cond)
+#endif
+
+uint32_t assign_frame_planes(EbConfig *config, uint8_t is_16bit, EbSvtIOFormat *input_ptr,
+                             uint8_t *frame) {
+    const uint32_t input_padded_width  = config->input_padded_width;
+    const uint32_t input_padded_height = config->input_padded_height;
+    const uint8_t  color_format        = config->config.encoder_color_format;
+    const uint8_t  subsampling_x       = (color_format == EB_YUV444 ? 1 : 2) - 1;
+
+    input_ptr->y_stride  = input_padded_width;
+    input_ptr->cr_stride = input_padded_width >> subsampling_x;
+    input_ptr->cb_stride = input_padded_width >> subsampling_x;
+
+    if (is_16bit && config->config.compressed_ten_bit_format == 1) {
+        // Determine size of each plane
+        const size_t luma_8bit_size   = input_padded_width * input_padded_height;
+        const size_t chroma_8bit_size = luma_8bit_size >> (3 - color_format);
+        const size_t luma_2bit_size   = luma_8bit_size / 4; //4-2bit pixels into 1 byte
+        const size_t chroma_2bit_size = luma_2bit_size >> (3 - color_format);
+
+        input_ptr->luma     = frame;
+        input_ptr->cb       = input_ptr->luma + luma_8bit_size;
+        input_ptr->cr       = input_ptr->cb + chroma_8bit_size;
+        input_ptr->luma_ext = input_ptr->cr + chroma_8bit_size;
+        input_ptr->cb_ext   = input_ptr->luma_ext + luma_2bit_size;
+        input_ptr->cr_ext   = input_ptr->cb_ext + chroma_2bit_size;
+
+        return (uint32_t)(luma_8bit_size + luma_2bit_size +
+                          2 * (chroma_8bit_size + chroma_2bit_size));
+    } else {
+        //Normal unpacked mode:yuv420p10le yuv422p10le yuv444p10le
+        const size_t luma_size   = (input_padded_width * input_padded_height) << is_16bit;
+        const size_t chroma_size = luma_size >> (3 - color_format);
+
+        input_ptr->luma = frame;
+        input_ptr->cb   = input_ptr->luma + luma_size;
+        input_ptr->cr   = input_ptr->cb + chroma_size;
+
+        return (uint32_t)(luma_size + 2 * chroma_size);
+    }
+}
+
+/* Skips the "FRAME" line in front of a mapped y4m frame, returns EB_FALSE when it is missing */
+static EbBool skip_y4m_frame_delimiter(InputReader *reader, FILE *error_log_file) {
+    const uint8_t *line   = reader->map_ptr + reader->read_offset;
+    const uint64_t remain = reader->map_size - reader->read_offset;
+    const uint8_t *end    = memchr(
+        line, '\n', (size_t)(remain < Y4M_FRAME_DELIMITER_MAX ? remain : Y4M_FRAME_DELIMITER_MAX));
+
+    if (!end)
+        return EB_FALSE;
+    if (strncmp((const char *)line, "FRAME", sizeof("FRAME") - 1))
+        fprintf(error_log_file, "Failed to read proper y4m frame delimeter. Read broken.\n");
+    reader->read_offset += end + 1 - line;
+    return EB_TRUE;
+}
+
+static void read_mapped_frame(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr) {
+    InputReader *reader = config->input_reader;
+
+    // Loop over the file when it ends, as the fread path does
+    for (int32_t pass = 0; pass < 2; pass++) {
+        if (config->y4m_input && !skip_y4m_frame_delimiter(reader, config->error_log_file))
+            reader->read_offset = reader->map_size;
+        if (reader->read_offset + reader->frame_size <= reader->map_size)
+            break;
+        reader->read_offset = reader->data_offset;
+    }
+    if (reader->read_offset + reader->frame_size > reader->map_size) {
+        header_ptr->n_filled_len = 0;
+        return;
+    }
+
+    header_ptr->n_filled_len = assign_frame_planes(config,
+                                                   is_16bit,
+                                                   (EbSvtIOFormat *)header_ptr->p_buffer,
+                                                   reader->map_ptr + reader->read_offset);
+    reader->read_offset += reader->frame_size;
+}
+
+/* Maps a regular input file, returns EB_FALSE if the platform refuses */
+static EbBool map_input_file(EbConfig *config, InputReader *reader) {
+#ifdef _WIN32
+    HANDLE        file_handle = (HANDLE)_get_osfhandle(_fileno(config->input_file));
+    LARGE_INTEGER file_size;
+    if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &file_size) ||
+        file_size.QuadPart == 0 || (uint64_t)file_size.QuadPart > SIZE_MAX)
+        return EB_FALSE;
+    reader->map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!reader->map_handle)
+        return EB_FALSE;
+    reader->map_ptr = (uint8_t *)MapViewOfFile(reader->map_handle, FILE_MAP_READ, 0, 0, 0);
+    if (!reader->map_ptr) {
+        CloseHandle(reader->map_handle);
+        return EB_FALSE;
+    }
+    reader->map_size = (uint64_t)file_size.QuadPart;
+#else
+    struct stat statbuf;
+    int         fd = fileno(config->input_file);
+    if (fstat(fd, &statbuf) || !S_ISREG(statbuf.st_mode) || statbuf.st_size == 0 ||
+        (uint64_t)statbuf.st_size > SIZE_MAX)
+        return EB_FALSE;
+    void *map_ptr = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map_ptr == MAP_FAILED)
+        return EB_FALSE;
+    // Frames are read once, front to back
+    madvise(map_ptr, (size_t)statbuf.st_size, MADV_SEQUENTIAL);
+    reader->map_ptr  = (uint8_t *)map_ptr;
+    reader->map_size = (uint64_t)statbuf.st_size;
+#endif
+
+    if (config->y4m_input) {
+        const uint8_t *end = memchr(reader->map_ptr, '\n', (size_t)reader->map_size);
+        reader->data_offset = end ? (uint64_t)(end + 1 - reader->map_ptr) : reader->map_size;
+    }
+    reader->read_offset = reader->data_offset;
+    return EB_TRUE;
+}
+
+static void unmap_input_file(InputReader *reader) {
+#ifdef _WIN32
+    UnmapViewOfFile(reader->map_ptr);
+    CloseHandle(reader->map_handle);
+#else
+    munmap(reader->map_ptr, (size_t)reader->map_size);
+#endif
+    reader->map_ptr = NULL;
+}
+
+/* Reads one whole frame of a pipe into slot, returns EB_FALSE at the end of the stream */
+static EbBool read_pipe_frame(EbConfig *config, InputReader *reader, InputFrameSlot *slot,
+                              EbBool first_frame) {
+    uint8_t *dst      = slot->buffer;
+    uint32_t to_read  = reader->frame_size;
+    slot->filled_len = 0;
+
+    /* if input is a y4m file, read next line which contains "FRAME" */
+    if (config->y4m_input == EB_TRUE)
+        read_y4m_frame_delimiter(config->input_file, config->error_log_file);
+    else if (first_frame) {
+        /* 9 bytes were already buffered during the the YUV4MPEG2 header probe */
+        memcpy(dst, config->y4m_buf, YUV4MPEG2_IND_SIZE);
+        slot->filled_len = YUV4MPEG2_IND_SIZE;
+        dst += YUV4MPEG2_IND_SIZE;
+        to_read -= YUV4MPEG2_IND_SIZE;
+    }
+    slot->filled_len += (uint32_t)fread(dst, 1, to_read, config->input_file);
+
+    return slot->filled_len == reader->frame_size;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI input_read_ahead_kernel(LPVOID input_ptr) {
+#else
+static void *input_read_ahead_kernel(void *input_ptr) {
+#endif
+    EbConfig *   config      = (EbConfig *)input_ptr;
+    InputReader *reader      = config->input_reader;
+    EbBool       first_frame = EB_TRUE;
+
+    for (;;) {
+        READER_LOCK(reader);
+        while (reader->filled_count == INPUT_READ_AHEAD_FRAMES && !reader->quit)
+            READER_WAIT(reader);
+        READER_UNLOCK(reader);
+        if (reader->quit)
+            break;
+
+        // The slot is not shared until filled_count covers it
+        InputFrameSlot *slot     = &reader->slot_array[reader->write_index];
+        EbBool          complete = read_pipe_frame(config, reader, slot, first_frame);
+        first_frame              = EB_FALSE;
+        reader->write_index      = (reader->write_index + 1) % INPUT_READ_AHEAD_FRAMES;
+
+        READER_LOCK(reader);
+        reader->filled_count++;
+        READER_SIGNAL(reader);
+        READER_UNLOCK(reader);
+        if (!complete)
+            break;
+    }
+    return 0;
+}
+
+static void read_ahead_frame(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr) {
+    InputReader *reader = config->input_reader;
+
+    header_ptr->n_filled_len = 0;
+    if (reader->end_of_stream)
+        return;
+
+    READER_LOCK(reader);
+    // The library copied the previous frame in svt_av1_enc_send_picture, give its slot back
+    if (reader->holding_slot) {
+        reader->filled_count--;
+        reader->read_index   = (reader->read_index + 1) % INPUT_READ_AHEAD_FRAMES;
+        reader->holding_slot = EB_FALSE;
+        READER_SIGNAL(reader);
+    }
+    while (reader->filled_count == 0)
+        READER_WAIT(reader);
+    reader->holding_slot = EB_TRUE;
+    READER_UNLOCK(reader);
+
+    InputFrameSlot *slot = &reader->slot_array[reader->read_index];
+    if (slot->filled_len != reader->frame_size) {
+        //for a fifo, we only know this when we reach eof
+        config->frames_to_be_encoded = config->frames_encoded;
+        reader->end_of_stream        = EB_TRUE;
+        return;
+    }
+    header_ptr->n_filled_len = assign_frame_planes(
+        config, is_16bit, (EbSvtIOFormat *)header_ptr->p_buffer, slot->buffer);
+}
+
+static uint32_t get_input_frame_size(EbConfig *config, uint8_t is_16bit) {
+    const uint8_t color_format = config->config.encoder_color_format;
+    const size_t  luma_size    = (size_t)config->input_padded_width * config->input_padded_height;
+    const size_t  frame_size   = luma_size + 2 * (luma_size >> (3 - color_format));
+
+    if (is_16bit && config->config.compressed_ten_bit_format == 1)
+        return (uint32_t)(frame_size + frame_size / 4);
+    return (uint32_t)(frame_size << is_16bit);
+}
+
+EbErrorType input_reader_open(EbConfig *config) {
+    const uint8_t is_16bit = (uint8_t)(config->config.encoder_bit_depth > 8);
+    InputReader * reader   = (InputReader *)calloc(1, sizeof(InputReader));
+    if (!reader)
+        return EB_ErrorInsufficientResources;
+    reader->frame_size = get_input_frame_size(config, is_16bit);
+    config->input_reader = reader;
+
+    if (config->input_file != stdin && !config->input_file_is_fifo) {
+        if (map_input_file(config, reader))
+            return EB_ErrorNone;
+        fprintf(stderr, "Warning: could not map the input file, reading it with fread\n");
+        free(reader);
+        config->input_reader = NULL;
+        return EB_ErrorNone;
+    }
+
+    for (uint32_t slot_index = 0; slot_index < INPUT_READ_AHEAD_FRAMES; slot_index++) {
+        reader->slot_array[slot_index].buffer = (uint8_t *)malloc(reader->frame_size);
+        if (!reader->slot_array[slot_index].buffer) {
+            input_reader_close(config);
+            return EB_ErrorInsufficientResources;
+        }
+    }
+#ifdef _WIN32
+    InitializeCriticalSection(&reader->lock);
+    InitializeConditionVariable(&reader->slot_cond);
+    reader->thread_handle = CreateThread(NULL, 0, input_read_ahead_kernel, config, 0, NULL);
+    if (!reader->thread_handle) {
+        DeleteCriticalSection(&reader->lock);
+#else
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->slot_cond, NULL);
+    if (pthread_create(&reader->thread_handle, NULL, input_read_ahead_kernel, config)) {
+        pthread_mutex_destroy(&reader->lock);
+        pthread_cond_destroy(&reader->slot_cond);
+#endif
+        for (uint32_t slot_index = 0; slot_index < INPUT_READ_AHEAD_FRAMES; slot_index++)
+            free(reader->slot_array[slot_index].buffer);
+        free(reader);
+        config->input_reader = NULL;
+        return EB_ErrorInsufficientResources;
+    }
+    return EB_ErrorNone;
+}
+
+void input_reader_read_frame(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr) {
+    if (config->input_reader->map_ptr)
+        read_mapped_frame(config, is_16bit, header_ptr);
+    else
+        read_ahead_frame(config, is_16bit, header_ptr);
+}
+
+void input_reader_close(EbConfig *config) {
+    InputReader *reader = config->input_reader;
+    if (!reader)
+        return;
+
+    if (reader->map_ptr)
+        unmap_input_file(reader);
+    else if (reader->slot_array[INPUT_READ_AHEAD_FRAMES - 1].buffer) {
+        // A thread blocked in fread keeps the close waiting, as the fread path would
+        READER_LOCK(reader);
+        reader->quit = EB_TRUE;
+        READER_SIGNAL(reader);
+        READER_UNLOCK(reader);
+#ifdef _WIN32
+        WaitForSingleObject(reader->thread_handle, INFINITE);
+        CloseHandle(reader->thread_handle);
+        DeleteCriticalSection(&reader->lock);
+#else
+        pthread_join(reader->thread_handle, NULL);
+        pthread_mutex_destroy(&reader->lock);
+        pthread_cond_destroy(&reader->slot_cond);
+#endif
+    }
+    for (uint32_t slot_index = 0; slot_index < INPUT_READ_AHEAD_FRAMES; slot_index++)
+        free(reader->slot_array[slot_index].buffer);
+    free(reader);
+    config->input_reader = NULL;
+}
+
+typedef struct InputPoolFrame {
+    struct InputPoolFrame *next_free;
+    struct InputPoolFrame *next_allocated;
+    uint8_t *              buffer;
+} InputPoolFrame;
+
+struct InputPool {
+    SvtAv1InputLayout layout;
+    size_t            luma_size;
+    size_t            chroma_size;
+    size_t            luma_offset; // from the buffer to the first sample of the picture
+    size_t            chroma_offset;
+    InputPoolFrame *  free_list; // frames released by the encoder
+    InputPoolFrame *  allocated_list;
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+#else
+    pthread_mutex_t lock;
+#endif
+};
+
+EbErrorType input_pool_open(EbConfig *config, const SvtAv1InputLayout *layout) {
+    InputPool *pool = (InputPool *)calloc(1, sizeof(InputPool));
+    if (!pool)
+        return EB_ErrorInsufficientResources;
+    const size_t rows   = layout->top_padding + config->input_padded_height +
+        layout->bottom_padding;
+    pool->layout        = *layout;
+    pool->luma_size     = (size_t)layout->y_stride * rows;
+    pool->chroma_size   = (size_t)layout->chroma_stride * ((rows + 1) >> 1);
+    pool->luma_offset   = (size_t)layout->y_stride * layout->top_padding + layout->left_padding;
+    pool->chroma_offset = (size_t)layout->chroma_stride * (layout->top_padding >> 1) +
+        (layout->left_padding >> 1);
+#ifdef _WIN32
+    InitializeCriticalSection(&pool->lock);
+#else
+    pthread_mutex_init(&pool->lock, NULL);
+#endif
+    config->input_pool = pool;
+    return EB_ErrorNone;
+}
+
+/* Takes a released frame, or allocates one more: the encoder bounds the frames in flight
+ * by blocking svt_av1_enc_send_picture, so the pool never grows past its input queue */
+static InputPoolFrame *get_pool_frame(InputPool *pool) {
+    READER_LOCK(pool);
+    InputPoolFrame *frame = pool->free_list;
+    if (frame)
+        pool->free_list = frame->next_free;
+    READER_UNLOCK(pool);
+    if (frame)
+        return frame;
+
+    frame = (InputPoolFrame *)malloc(sizeof(InputPoolFrame));
+    if (!frame)
+        return NULL;
+    frame->buffer = (uint8_t *)malloc(pool->luma_size + 2 * pool->chroma_size);
+    if (!frame->buffer) {
+        free(frame);
+        return NULL;
+    }
+    frame->next_allocated = pool->allocated_list;
+    pool->allocated_list  = frame;
+    return frame;
+}
+
+static void put_pool_frame(InputPool *pool, InputPoolFrame *frame) {
+    READER_LOCK(pool);
+    frame->next_free = pool->free_list;
+    pool->free_list  = frame;
+    READER_UNLOCK(pool);
+}
+
+static size_t read_plane_rows(FILE *input_file, uint8_t *dst, uint32_t stride, uint32_t width,
+                              uint32_t height) {
+    size_t filled_len = 0;
+    for (uint32_t row = 0; row < height; row++, dst += stride)
+        filled_len += fread(dst, 1, width, input_file);
+    return filled_len;
+}
+
+void input_pool_read_frame(EbConfig *config, EbBufferHeaderType *header_ptr) {
+    InputPool *     pool       = config->input_pool;
+    EbSvtIOFormat * input_ptr  = (EbSvtIOFormat *)header_ptr->p_buffer;
+    const uint32_t  width      = config->input_padded_width;
+    const uint32_t  height     = config->input_padded_height;
+    const size_t    frame_size = (size_t)width * height * 3 / 2;
+    InputPoolFrame *frame      = get_pool_frame(pool);
+
+    header_ptr->n_filled_len = 0;
+    if (!frame)
+        return;
+    input_ptr->y_stride  = pool->layout.y_stride;
+    input_ptr->cb_stride = pool->layout.chroma_stride;
+    input_ptr->cr_stride = pool->layout.chroma_stride;
+    input_ptr->luma      = frame->buffer + pool->luma_offset;
+    input_ptr->cb        = frame->buffer + pool->luma_size + pool->chroma_offset;
+    input_ptr->cr        = input_ptr->cb + pool->chroma_size;
+
+    // Loop over the file when it ends, as the fread path does
+    size_t filled_len = 0;
+    for (int32_t pass = 0; pass < 2 && filled_len != frame_size; pass++) {
+        if (pass) {
+            fseek(config->input_file, 0, SEEK_SET);
+            if (config->y4m_input == EB_TRUE)
+                read_and_skip_y4m_header(config->input_file);
+        }
+        if (config->y4m_input == EB_TRUE)
+            read_y4m_frame_delimiter(config->input_file, config->error_log_file);
+        filled_len = read_plane_rows(
+            config->input_file, input_ptr->luma, input_ptr->y_stride, width, height);
+        filled_len += read_plane_rows(
+            config->input_file, input_ptr->cb, input_ptr->cb_stride, width >> 1, height >> 1);
+        filled_len += read_plane_rows(
+            config->input_file, input_ptr->cr, input_ptr->cr_stride, width >> 1, height >> 1);
+    }
+    if (filled_len != frame_size) {
+        put_pool_frame(pool, frame);
+        return;
+    }
+    header_ptr->n_filled_len  = (uint32_t)filled_len;
+    header_ptr->p_app_private = frame;
+}
+
+void input_pool_release(void *priv, const EbSvtIOFormat *planes, void *p_app_private) {
+    (void)planes;
+    put_pool_frame(((EbConfig *)priv)->input_pool, (InputPoolFrame *)p_app_private);
+}
+
+void input_pool_close(EbConfig *config) {
+    InputPool *pool = config->input_pool;
+    if (!pool)
+        return;
+
+    while (pool->allocated_list) {
+        InputPoolFrame *frame = pool->allocated_list;
+        pool->allocated_list  = frame->next_allocated;
+        free(frame->buffer);
+        free(frame);
+    }
+#ifdef _WIN32
+    DeleteCriticalSection(&pool->lock);
+#else
+    pthread_mutex_destroy(&pool->lock);
+#endif
+    free(pool);
+    config->input_pool = NULL;
+}
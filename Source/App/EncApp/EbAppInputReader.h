@@ -0,0 +1,48 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbAppInputReader_h
+#define EbAppInputReader_h
+
+#include "EbAppConfig.h"
+
+/* Opens the input reader of --mmap-input: regular files are mapped into memory,
+ * pipes and stdin are read ahead by a separate thread. Leaves config->input_reader
+ * NULL, and the plain fread path in use, when the input can not be mapped. */
+EbErrorType input_reader_open(EbConfig *config);
+
+/* Points the planes of header_ptr to the next frame, without copying it. The frame
+ * stays valid until the next call. Sets n_filled_len to 0 at the end of a pipe. */
+void input_reader_read_frame(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *header_ptr);
+
+/* Stops the read-ahead thread and unmaps the input */
+void input_reader_close(EbConfig *config);
+
+/* Points the planes of input_ptr into one frame stored plane after plane,
+ * returns the size of the frame */
+uint32_t assign_frame_planes(EbConfig *config, uint8_t is_16bit, EbSvtIOFormat *input_ptr,
+                             uint8_t *frame);
+
+/* Opens the frame pool of --zero-copy-input, its frames follow the padded layout
+ * returned by svt_av1_enc_get_input_layout and are lent to the encoder */
+EbErrorType input_pool_open(EbConfig *config, const SvtAv1InputLayout *layout);
+
+/* Reads the next frame into a free frame of the pool, and points the planes of
+ * header_ptr to it. Sets n_filled_len to 0 when no whole frame could be read. */
+void input_pool_read_frame(EbConfig *config, EbBufferHeaderType *header_ptr);
+
+/* release_input callback of the encoder, priv is the EbConfig owning the pool */
+void input_pool_release(void *priv, const EbSvtIOFormat *planes, void *p_app_private);
+
+/* Frees every frame of the pool, the encoder must not hold any */
+void input_pool_close(EbConfig *config);
+
+#endif // EbAppInputReader_h
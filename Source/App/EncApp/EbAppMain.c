@@ -302,6 +302,45 @@ static void print_performance(const EncContext* const enc_context) {
     }
 }
 
+static void print_stage_stats(const EncContext* const enc_context) {
+    for (uint32_t inst_cnt = 0; inst_cnt < enc_context->num_channels; ++inst_cnt) {
+        const EncChannel* c = enc_context->channels + inst_cnt;
+        SvtAv1StageStats  stats[32];
+        uint32_t          stage_count = sizeof(stats) / sizeof(stats[0]);
+        if (!c->config->config.stage_stats || c->exit_cond != APP_ExitConditionFinished ||
+            svt_av1_enc_get_stage_stats(
+                c->app_callback->svt_encoder_handle, stats, &stage_count) != EB_ErrorNone)
+            continue;
+        fprintf(stderr,
+                "\nChannel %u Stages (times in ms)\n%-26s %7s %8s %9s %9s %9s %9s %10s %10s\n",
+                inst_cnt + 1,
+                "Stage",
+                "Threads",
+                "Objects",
+                "AvgDepth",
+                "MaxDepth",
+                "AvgWait",
+                "MaxWait",
+                "Busy",
+                "Stalled");
+        for (uint32_t i = 0; i < stage_count; i++) {
+            const SvtAv1StageStats* s     = &stats[i];
+            const double            count = s->posted_count ? (double)s->posted_count : 1.0;
+            fprintf(stderr,
+                    "%-26s %7u %8llu %9.2f %9u %9.2f %9.2f %10.1f %10.1f\n",
+                    s->name,
+                    s->process_count,
+                    (unsigned long long)s->posted_count,
+                    (double)s->queue_depth_sum / count,
+                    s->max_queue_depth,
+                    (double)s->queue_time / count / 1000,
+                    (double)s->max_queue_time / 1000,
+                    (double)s->busy_time / 1000,
+                    (double)s->empty_wait_time / 1000);
+        }
+    }
+}
+
 static void print_warnnings(const EncContext* const enc_context) {
     char* const* warning = enc_context->warning;
     for (uint32_t warning_id = 0;; warning_id++) {
@@ -323,12 +362,36 @@ static EbBool has_active_channel(const EncContext* const enc_context) {
     return EB_FALSE;
 }
 
+/* A segment of --segment-frames is done and more frames are left to encode */
+static EbBool segment_finished(const EncChannel* c) {
+    const EbConfig* config = c->config;
+    return config->segment_frames && !config->stop_encoder &&
+        config->processed_frame_count < (uint64_t)config->frames_to_be_encoded &&
+        c->exit_cond_input == APP_ExitConditionFinished &&
+        c->exit_cond_output == APP_ExitConditionFinished &&
+        (c->exit_cond_recon == APP_ExitConditionFinished || !config->recon_file);
+}
+
 static void enc_channel_step(EncChannel* c, EncApp* enc_app, EncContext* enc_context) {
     EbConfig* config = c->config;
     process_input_buffer(c);
     process_output_recon_buffer(c);
     process_output_stream_buffer(c, enc_app, &enc_context->total_frames);
 
+    if (segment_finished(c)) {
+        // The next segment goes to the same encoder, as a new stream
+        c->return_error = svt_av1_enc_reset(c->app_callback->svt_encoder_handle);
+        if (c->return_error != EB_ErrorNone)
+            c->exit_cond_input = APP_ExitConditionError;
+        else {
+            c->exit_cond_output = APP_ExitConditionNone;
+            c->exit_cond_recon  = config->recon_file ? APP_ExitConditionNone
+                                                     : APP_ExitConditionError;
+            c->exit_cond_input  = APP_ExitConditionNone;
+            return;
+        }
+    }
+
     if (((c->exit_cond_recon == APP_ExitConditionFinished || !config->recon_file) &&
          c->exit_cond_output == APP_ExitConditionFinished &&
          c->exit_cond_input == APP_ExitConditionFinished) ||
@@ -394,6 +457,7 @@ static EbErrorType encode(EncApp* enc_app, EncContext* enc_context) {
     }
     print_summary(enc_context);
     print_performance(enc_context);
+    print_stage_stats(enc_context);
     return return_error;
 }
 
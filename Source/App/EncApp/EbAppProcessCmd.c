@@ -21,6 +21,7 @@
 #include "EbAppConfig.h"
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputReader.h"
 #include "EbTime.h"
 /***************************************
  * Macros
@@ -647,7 +648,11 @@ void read_input_frames(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *h
     input_ptr->cr_stride = input_padded_width >> subsampling_x;
     input_ptr->cb_stride = input_padded_width >> subsampling_x;
 
-    if (config->buffered_input == -1) {
+    if (config->input_pool)
+        input_pool_read_frame(config, header_ptr);
+    else if (config->input_reader)
+        input_reader_read_frame(config, is_16bit, header_ptr);
+    else if (config->buffered_input == -1) {
         uint64_t read_size;
         if (is_16bit == 0 || (is_16bit == 1 && config->config.compressed_ten_bit_format == 0)) {
             read_size = (uint64_t)SIZE_OF_ONE_FRAME_IN_BYTES(
@@ -750,61 +755,11 @@ void read_input_frames(EbConfig *config, uint8_t is_16bit, EbBufferHeaderType *h
         }
 
     } else {
-        if (is_16bit && config->config.compressed_ten_bit_format == 1) {
-            // Determine size of each plane
-            const size_t luma_8bit_size   = input_padded_width * input_padded_height;
-            const size_t chroma_8bit_size = luma_8bit_size >> (3 - color_format);
-            const size_t luma_2bit_size   = luma_8bit_size / 4; //4-2bit pixels into 1 byte
-            const size_t chroma_2bit_size = luma_2bit_size >> (3 - color_format);
-
-            input_ptr            = (EbSvtIOFormat *)header_ptr->p_buffer;
-            input_ptr->y_stride  = input_padded_width;
-            input_ptr->cr_stride = input_padded_width >> subsampling_x;
-            input_ptr->cb_stride = input_padded_width >> subsampling_x;
-
-            input_ptr->luma =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input];
-            input_ptr->cb =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_8bit_size;
-            input_ptr->cr =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_8bit_size + chroma_8bit_size;
-
-            input_ptr->luma_ext =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_8bit_size + 2 * chroma_8bit_size;
-            input_ptr->cb_ext =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_8bit_size + 2 * chroma_8bit_size + luma_2bit_size;
-            input_ptr->cr_ext =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_8bit_size + 2 * chroma_8bit_size + luma_2bit_size + chroma_2bit_size;
-
-            header_ptr->n_filled_len = (uint32_t)(luma_8bit_size + luma_2bit_size +
-                                                  2 * (chroma_8bit_size + chroma_2bit_size));
-        } else {
-            //Normal unpacked mode:yuv420p10le yuv422p10le yuv444p10le
-            const size_t luma_size   = (input_padded_width * input_padded_height) << is_16bit;
-            const size_t chroma_size = luma_size >> (3 - color_format);
-
-            input_ptr = (EbSvtIOFormat *)header_ptr->p_buffer;
-
-            input_ptr->y_stride  = input_padded_width;
-            input_ptr->cr_stride = input_padded_width >> subsampling_x;
-            input_ptr->cb_stride = input_padded_width >> subsampling_x;
-
-            input_ptr->luma =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input];
-            input_ptr->cb =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_size;
-            input_ptr->cr =
-                config->sequence_buffer[config->processed_frame_count % config->buffered_input] +
-                luma_size + chroma_size;
-
-            header_ptr->n_filled_len = (uint32_t)(luma_size + 2 * chroma_size);
-        }
+        header_ptr->n_filled_len = assign_frame_planes(
+            config,
+            is_16bit,
+            input_ptr,
+            config->sequence_buffer[config->processed_frame_count % config->buffered_input]);
     }
 
     return;
@@ -925,16 +880,25 @@ void process_input_buffer(EncChannel *channel) {
 
     // If there are bytes left to encode, configure the header
     if (remaining_byte_count != 0 && config->stop_encoder == EB_FALSE) {
+        // The frame pool tags its frames through p_app_private
+        header_ptr->p_app_private = (EbPtr)NULL;
         read_input_frames(config, is_16bit, header_ptr);
         if (header_ptr->n_filled_len) {
             // Update the context parameters
             config->processed_byte_count += header_ptr->n_filled_len;
-            header_ptr->p_app_private = (EbPtr)NULL;
             config->frames_encoded    = (int32_t)(++config->processed_frame_count);
 
             // Configuration parameters changed on the fly
             if (config->config.use_qp_file && config->qp_file)
                 header_ptr->qp = send_qp_on_the_fly(config->qp_file, &config->config.use_qp_file);
+            if (config->rc_update_frame &&
+                config->processed_frame_count == config->rc_update_frame + 1) {
+                const SvtAv1RateControlTargets targets = {config->rc_update_bit_rate,
+                                                          config->config.vbv_bufsize,
+                                                          config->config.max_qp_allowed,
+                                                          config->config.min_qp_allowed};
+                svt_av1_enc_update_rate_control(component_handle, &targets);
+            }
 
             if (keep_running == 0 && !config->stop_encoder)
                 config->stop_encoder = EB_TRUE;
@@ -947,8 +911,14 @@ void process_input_buffer(EncChannel *channel) {
             svt_av1_enc_send_picture(component_handle, header_ptr);
         }
 
+        // With --segment-frames every segment is a stream of its own
+        const EbBool segment_done = config->segment_frames && header_ptr->n_filled_len &&
+            config->processed_frame_count % config->segment_frames == 0;
         if ((config->processed_frame_count == (uint64_t)config->frames_to_be_encoded) ||
-            config->stop_encoder) {
+            config->stop_encoder || segment_done) {
+            // The next segment reads its frames into the same buffer
+            const uint32_t n_alloc_len = header_ptr->n_alloc_len;
+            uint8_t *const p_buffer    = header_ptr->p_buffer;
             header_ptr->n_alloc_len   = 0;
             header_ptr->n_filled_len  = 0;
             header_ptr->n_tick_count  = 0;
@@ -958,6 +928,10 @@ void process_input_buffer(EncChannel *channel) {
             header_ptr->pic_type      = EB_AV1_INVALID_PICTURE;
 
             svt_av1_enc_send_picture(component_handle, header_ptr);
+            if (segment_done) {
+                header_ptr->n_alloc_len = n_alloc_len;
+                header_ptr->p_buffer    = p_buffer;
+            }
         }
 
         return_value = (header_ptr->flags == EB_BUFFERFLAG_EOS) ? APP_ExitConditionFinished
@@ -1041,6 +1015,19 @@ static void write_ivf_frame_header(EbConfig *config, uint32_t byte_count) {
     if (config->bitstream_file)
         fwrite(header, 1, IVF_FRAME_HEADER_SIZE, config->bitstream_file);
 }
+
+/* write_packet callback of --direct-output, called on the packetization thread of the
+ * encoder with each temporal unit */
+void write_packet_to_file(void *priv, const EbBufferHeaderType *packet,
+                          const uint8_t *const *chunk_array, const uint32_t *chunk_size_array,
+                          uint32_t chunk_count) {
+    EbConfig *config = (EbConfig *)priv;
+    if (!config->ivf_count && !(packet->flags & EB_BUFFERFLAG_IS_ALT_REF))
+        write_ivf_stream_header(config);
+    write_ivf_frame_header(config, packet->n_filled_len);
+    for (uint32_t i = 0; i < chunk_count; i++)
+        fwrite(chunk_array[i], 1, chunk_size_array[i], config->bitstream_file);
+}
 double get_psnr(double sse, double max) {
     double psnr;
     if (sse == 0)
@@ -1181,8 +1168,8 @@ void process_output_stream_buffer(EncChannel *channel, EncApp *enc_app, int32_t
                     finish_s_time,
                     finish_u_time);
 
-            // Write Stream Data to file
-            if (stream_file) {
+            // Write Stream Data to file, unless the encoder already did through write_packet
+            if (stream_file && !config->config.write_packet) {
                 if (config->performance_context.frame_count == 1 &&
                     !(flags & EB_BUFFERFLAG_IS_ALT_REF)) {
                     write_ivf_stream_header(config);
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+ */
+#include <immintrin.h>
+
+#include "EbDefinitions.h"
+#include "common_dsp_rtcd.h"
+
+// scaling_lut[x] for 8-bit samples
+static INLINE __m256i scale_lut_8x32(const int32_t *scaling_lut, __m256i index) {
+    return _mm256_i32gather_epi32(scaling_lut, index, 4);
+}
+
+// scaling_lut interpolated between the entries for 10- and 12-bit samples, the
+// lut holds 257 entries so the last one needs no special case
+static INLINE __m256i scale_lut_hbd_8x32(const int32_t *scaling_lut, __m256i index,
+                                         int32_t bit_depth) {
+    const __m128i shift = _mm_cvtsi32_si128(bit_depth - 8);
+    const __m256i x     = _mm256_srl_epi32(index, shift);
+    const __m256i lut0  = _mm256_i32gather_epi32(scaling_lut, x, 4);
+    if (bit_depth == 8)
+        return lut0;
+    const __m256i lut1  = _mm256_i32gather_epi32(scaling_lut + 1, x, 4);
+    const __m256i frac  = _mm256_and_si256(index, _mm256_set1_epi32((1 << (bit_depth - 8)) - 1));
+    const __m256i round = _mm256_set1_epi32(1 << (bit_depth - 9));
+    const __m256i delta = _mm256_mullo_epi32(_mm256_sub_epi32(lut1, lut0), frac);
+    return _mm256_add_epi32(lut0, _mm256_sra_epi32(_mm256_add_epi32(delta, round), shift));
+}
+
+static INLINE __m256i add_scaled_grain(__m256i pix, __m256i scale, const int32_t *grain,
+                                       __m256i round, __m128i shift, __m256i min_val,
+                                       __m256i max_val) {
+    __m256i noise = _mm256_mullo_epi32(scale, _mm256_loadu_si256((const __m256i *)grain));
+    noise         = _mm256_sra_epi32(_mm256_add_epi32(noise, round), shift);
+    pix           = _mm256_add_epi32(pix, noise);
+    return _mm256_min_epi32(_mm256_max_epi32(pix, min_val), max_val);
+}
+
+static INLINE __m256i load_8x8(const uint8_t *src) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+}
+
+static INLINE __m256i load_8x16(const uint16_t *src) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+}
+
+static INLINE __m128i pack_8x32_to_16(__m256i pix) {
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(pix, pix), 0x88);
+    return _mm256_castsi256_si128(packed);
+}
+
+static INLINE void store_8x8(uint8_t *dst, __m256i pix) {
+    const __m128i pix16 = pack_8x32_to_16(pix);
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(pix16, pix16));
+}
+
+static INLINE void store_8x16(uint16_t *dst, __m256i pix) {
+    _mm_storeu_si128((__m128i *)dst, pack_8x32_to_16(pix));
+}
+
+// Luma of the 8 chroma samples at chroma column j, averaged in pairs when the
+// chroma is horizontally subsampled
+static INLINE __m256i average_luma_8x8(const uint8_t *luma, int32_t j, int32_t chroma_subsamp_x) {
+    if (!chroma_subsamp_x)
+        return load_8x8(luma + j);
+    const __m256i pix  = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(luma + (j << 1))));
+    const __m256i sums = _mm256_madd_epi16(pix, _mm256_set1_epi16(1));
+    return _mm256_srli_epi32(_mm256_add_epi32(sums, _mm256_set1_epi32(1)), 1);
+}
+
+static INLINE __m256i average_luma_8x16(const uint16_t *luma, int32_t j,
+                                        int32_t chroma_subsamp_x) {
+    if (!chroma_subsamp_x)
+        return load_8x16(luma + j);
+    const __m256i pix  = _mm256_loadu_si256((const __m256i *)(luma + (j << 1)));
+    const __m256i sums = _mm256_madd_epi16(pix, _mm256_set1_epi16(1));
+    return _mm256_srli_epi32(_mm256_add_epi32(sums, _mm256_set1_epi32(1)), 1);
+}
+
+// Scaling function index of the chroma samples
+static INLINE __m256i chroma_index(__m256i average_luma, __m256i chroma, __m256i luma_mult,
+                                   __m256i mult, __m256i offset, __m256i max_index) {
+    __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(average_luma, luma_mult),
+                                     _mm256_mullo_epi32(chroma, mult));
+    index         = _mm256_add_epi32(_mm256_srai_epi32(index, 6), offset);
+    return _mm256_min_epi32(_mm256_max_epi32(index, _mm256_setzero_si256()), max_index);
+}
+
+void svt_av1_add_luma_grain_avx2(uint8_t *luma, int32_t luma_stride, const int32_t *grain,
+                                 int32_t grain_stride, int32_t width, int32_t height,
+                                 const int32_t *scaling_lut, int32_t scaling_shift,
+                                 int32_t min_luma, int32_t max_luma) {
+    const int32_t w8      = width & ~7;
+    const __m256i round   = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift   = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min_val = _mm256_set1_epi32(min_luma);
+    const __m256i max_val = _mm256_set1_epi32(max_luma);
+
+    if (w8) {
+        uint8_t *      dst = luma;
+        const int32_t *grn = grain;
+        for (int32_t i = 0; i < height; i++) {
+            for (int32_t j = 0; j < w8; j += 8) {
+                const __m256i pix   = load_8x8(dst + j);
+                const __m256i scale = scale_lut_8x32(scaling_lut, pix);
+                store_8x8(dst + j,
+                          add_scaled_grain(pix, scale, grn + j, round, shift, min_val, max_val));
+            }
+            dst += luma_stride;
+            grn += grain_stride;
+        }
+    }
+    if (width > w8)
+        svt_av1_add_luma_grain_c(luma + w8,
+                                 luma_stride,
+                                 grain + w8,
+                                 grain_stride,
+                                 width - w8,
+                                 height,
+                                 scaling_lut,
+                                 scaling_shift,
+                                 min_luma,
+                                 max_luma);
+}
+
+void svt_av1_add_luma_grain_hbd_avx2(uint16_t *luma, int32_t luma_stride, const int32_t *grain,
+                                     int32_t grain_stride, int32_t width, int32_t height,
+                                     const int32_t *scaling_lut, int32_t scaling_shift,
+                                     int32_t min_luma, int32_t max_luma, int32_t bit_depth) {
+    const int32_t w8      = width & ~7;
+    const __m256i round   = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift   = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min_val = _mm256_set1_epi32(min_luma);
+    const __m256i max_val = _mm256_set1_epi32(max_luma);
+
+    if (w8) {
+        uint16_t *     dst = luma;
+        const int32_t *grn = grain;
+        for (int32_t i = 0; i < height; i++) {
+            for (int32_t j = 0; j < w8; j += 8) {
+                const __m256i pix   = load_8x16(dst + j);
+                const __m256i scale = scale_lut_hbd_8x32(scaling_lut, pix, bit_depth);
+                store_8x16(dst + j,
+                           add_scaled_grain(pix, scale, grn + j, round, shift, min_val, max_val));
+            }
+            dst += luma_stride;
+            grn += grain_stride;
+        }
+    }
+    if (width > w8)
+        svt_av1_add_luma_grain_hbd_c(luma + w8,
+                                     luma_stride,
+                                     grain + w8,
+                                     grain_stride,
+                                     width - w8,
+                                     height,
+                                     scaling_lut,
+                                     scaling_shift,
+                                     min_luma,
+                                     max_luma,
+                                     bit_depth);
+}
+
+void svt_av1_add_chroma_grain_avx2(const uint8_t *luma, int32_t luma_stride, uint8_t *chroma,
+                                   int32_t chroma_stride, const int32_t *grain,
+                                   int32_t grain_stride, int32_t width, int32_t height,
+                                   const int32_t *scaling_lut, int32_t mult, int32_t luma_mult,
+                                   int32_t offset, int32_t scaling_shift, int32_t min_chroma,
+                                   int32_t max_chroma, int32_t chroma_subsamp_y,
+                                   int32_t chroma_subsamp_x) {
+    const int32_t w8        = width & ~7;
+    const __m256i round     = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift     = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min_val   = _mm256_set1_epi32(min_chroma);
+    const __m256i max_val   = _mm256_set1_epi32(max_chroma);
+    const __m256i mult_v    = _mm256_set1_epi32(mult);
+    const __m256i lmult_v   = _mm256_set1_epi32(luma_mult);
+    const __m256i offset_v  = _mm256_set1_epi32(offset);
+    const __m256i max_index = _mm256_set1_epi32(255);
+
+    if (w8) {
+        const uint8_t *src = luma;
+        uint8_t *      dst = chroma;
+        const int32_t *grn = grain;
+        for (int32_t i = 0; i < height; i++) {
+            for (int32_t j = 0; j < w8; j += 8) {
+                const __m256i avg   = average_luma_8x8(src, j, chroma_subsamp_x);
+                const __m256i pix   = load_8x8(dst + j);
+                const __m256i index = chroma_index(avg, pix, lmult_v, mult_v, offset_v, max_index);
+                const __m256i scale = scale_lut_8x32(scaling_lut, index);
+                store_8x8(dst + j,
+                          add_scaled_grain(pix, scale, grn + j, round, shift, min_val, max_val));
+            }
+            src += luma_stride << chroma_subsamp_y;
+            dst += chroma_stride;
+            grn += grain_stride;
+        }
+    }
+    if (width > w8)
+        svt_av1_add_chroma_grain_c(luma + (w8 << chroma_subsamp_x),
+                                   luma_stride,
+                                   chroma + w8,
+                                   chroma_stride,
+                                   grain + w8,
+                                   grain_stride,
+                                   width - w8,
+                                   height,
+                                   scaling_lut,
+                                   mult,
+                                   luma_mult,
+                                   offset,
+                                   scaling_shift,
+                                   min_chroma,
+                                   max_chroma,
+                                   chroma_subsamp_y,
+                                   chroma_subsamp_x);
+}
+
+void svt_av1_add_chroma_grain_hbd_avx2(const uint16_t *luma, int32_t luma_stride,
+                                       uint16_t *chroma, int32_t chroma_stride,
+                                       const int32_t *grain, int32_t grain_stride, int32_t width,
+                                       int32_t height, const int32_t *scaling_lut, int32_t mult,
+                                       int32_t luma_mult, int32_t offset, int32_t scaling_shift,
+                                       int32_t min_chroma, int32_t max_chroma, int32_t bit_depth,
+                                       int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    const int32_t w8        = width & ~7;
+    const __m256i round     = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift     = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min_val   = _mm256_set1_epi32(min_chroma);
+    const __m256i max_val   = _mm256_set1_epi32(max_chroma);
+    const __m256i mult_v    = _mm256_set1_epi32(mult);
+    const __m256i lmult_v   = _mm256_set1_epi32(luma_mult);
+    const __m256i offset_v  = _mm256_set1_epi32(offset);
+    const __m256i max_index = _mm256_set1_epi32((256 << (bit_depth - 8)) - 1);
+
+    if (w8) {
+        const uint16_t *src = luma;
+        uint16_t *      dst = chroma;
+        const int32_t * grn = grain;
+        for (int32_t i = 0; i < height; i++) {
+            for (int32_t j = 0; j < w8; j += 8) {
+                const __m256i avg   = average_luma_8x16(src, j, chroma_subsamp_x);
+                const __m256i pix   = load_8x16(dst + j);
+                const __m256i index = chroma_index(avg, pix, lmult_v, mult_v, offset_v, max_index);
+                const __m256i scale = scale_lut_hbd_8x32(scaling_lut, index, bit_depth);
+                store_8x16(dst + j,
+                           add_scaled_grain(pix, scale, grn + j, round, shift, min_val, max_val));
+            }
+            src += luma_stride << chroma_subsamp_y;
+            dst += chroma_stride;
+            grn += grain_stride;
+        }
+    }
+    if (width > w8)
+        svt_av1_add_chroma_grain_hbd_c(luma + (w8 << chroma_subsamp_x),
+                                       luma_stride,
+                                       chroma + w8,
+                                       chroma_stride,
+                                       grain + w8,
+                                       grain_stride,
+                                       width - w8,
+                                       height,
+                                       scaling_lut,
+                                       mult,
+                                       luma_mult,
+                                       offset,
+                                       scaling_shift,
+                                       min_chroma,
+                                       max_chroma,
+                                       bit_depth,
+                                       chroma_subsamp_y,
+                                       chroma_subsamp_x);
+}
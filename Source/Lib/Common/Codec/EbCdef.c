@@ -293,9 +293,10 @@ void copy_rect(uint16_t *dst, int32_t dstride, const uint16_t *src, int32_t sstr
 
 void svt_cdef_filter_fb(uint8_t *dst8, uint16_t *dst16, int32_t dstride, uint16_t *in, int32_t xdec,
                         int32_t ydec, int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS], int32_t *dirinit,
-                        int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS], int32_t pli, CdefList *dlist,
-                        int32_t cdef_count, int32_t level, int32_t sec_strength,
-                        int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift) {
+                        int32_t dir_ready, int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS], int32_t pli,
+                        CdefList *dlist, int32_t cdef_count, int32_t level,
+                        int32_t sec_strength, int32_t pri_damping, int32_t sec_damping,
+                        int32_t coeff_shift) {
     int32_t bi;
     int32_t bx;
     int32_t by;
@@ -332,7 +333,7 @@ void svt_cdef_filter_fb(uint8_t *dst8, uint16_t *dst16, int32_t dstride, uint16_
         return;
     }
 
-    if (pli == 0) {
+    if (pli == 0 && !dir_ready) {
         if (!dirinit || !*dirinit) {
             for (bi = 0; bi < cdef_count; bi++) {
                 by = dlist[bi].by;
@@ -10,6 +10,16 @@
 */
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
 
 #include "EbMalloc.h"
 #include "EbThreads.h"
@@ -20,6 +30,156 @@ void svt_print_alloc_fail(const char* file, int line) {
     SVT_FATAL("allocate memory failed, at %s, L%d\n", file, line);
 }
 
+/*********************************************************************
+ * Large Allocations
+ *   With huge pages or a NUMA node, large buffers are mapped straight
+ *   from the OS, zeroed and on a huge page boundary. A header in front
+ *   of each buffer keeps the length of its mapping, 0 for a buffer of
+ *   the aligned heap. Each encoder passes its own policy, so encoders
+ *   of one process can differ.
+ *********************************************************************/
+#define LARGE_ALLOC_HEADER ALVALUE
+#define LARGE_ALLOC_MIN_SIZE (256 << 10)
+#define HUGE_PAGE_SIZE (2 << 20)
+// Linux memory policy, the kernel prefers the node and falls back to the others
+#define SVT_MPOL_PREFERRED 1
+
+EbLargeAllocPolicy svt_large_alloc_policy(uint32_t huge_pages, int32_t numa_node) {
+    EbLargeAllocPolicy policy;
+    policy.huge_pages     = huge_pages;
+    policy.numa_node_mask = numa_node >= 0 && numa_node < 32 ? 1u << numa_node : 0;
+    return policy;
+}
+
+#ifdef _WIN32
+static void* map_large(size_t size, size_t* length, const EbLargeAllocPolicy* policy) {
+    DWORD        node  = NUMA_NO_PREFERRED_NODE;
+    const SIZE_T large = policy->huge_pages ? GetLargePageMinimum() : 0;
+    void*        p     = NULL;
+
+    if (policy->numa_node_mask)
+        for (node = 0; !(policy->numa_node_mask & (1u << node)); ++node) {}
+
+    // Large pages need the SeLockMemoryPrivilege, go on with normal pages without it
+    if (large) {
+        *length = (size + large - 1) & ~(large - 1);
+        p       = VirtualAllocExNuma(GetCurrentProcess(),
+                               NULL,
+                               *length,
+                               MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                               PAGE_READWRITE,
+                               node);
+    }
+    if (!p) {
+        *length = size;
+        p       = VirtualAllocExNuma(
+            GetCurrentProcess(), NULL, *length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+    }
+    return p;
+}
+
+static void unmap_large(void* p, size_t length) {
+    (void)length;
+    VirtualFree(p, 0, MEM_RELEASE);
+}
+
+static void* heap_alloc_aligned(size_t size) { return _aligned_malloc(size, ALVALUE); }
+
+static void heap_free_aligned(void* p) { _aligned_free(p); }
+#else
+static void* map_large(size_t size, size_t* length, const EbLargeAllocPolicy* policy) {
+#ifdef __linux__
+    const size_t page = policy->huge_pages ? HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t*     p    = MAP_FAILED;
+
+    *length = (size + page - 1) & ~(page - 1);
+#ifdef MAP_HUGETLB
+    // Explicit huge pages come from the pool reserved in /proc/sys/vm/nr_hugepages
+    if (policy->huge_pages == 2)
+        p = mmap(NULL,
+                 *length,
+                 PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                 -1,
+                 0);
+#endif
+    if (p == MAP_FAILED) {
+        // Map one page more and trim it, so the buffer starts on a huge page boundary
+        uint8_t* base = mmap(
+            NULL, *length + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+            return NULL;
+        p = (uint8_t*)(((uintptr_t)base + page - 1) & ~(uintptr_t)(page - 1));
+        if (p > base)
+            munmap(base, p - base);
+        if (base + page > p)
+            munmap(p + *length, base + page - p);
+#ifdef MADV_HUGEPAGE
+        if (policy->huge_pages)
+            madvise(p, *length, MADV_HUGEPAGE);
+#endif
+    }
+#ifdef SYS_mbind
+    // Set before the first touch, the pages are then allocated on the node
+    if (policy->numa_node_mask) {
+        const unsigned long node_mask = policy->numa_node_mask;
+        syscall(SYS_mbind,
+                p,
+                *length,
+                SVT_MPOL_PREFERRED,
+                &node_mask,
+                (unsigned long)(sizeof(node_mask) * CHAR_BIT),
+                0);
+    }
+#endif
+    return p;
+#else
+    (void)size;
+    (void)length;
+    (void)policy;
+    return NULL;
+#endif
+}
+
+static void unmap_large(void* p, size_t length) { munmap(p, length); }
+
+static void* heap_alloc_aligned(size_t size) {
+    void* p;
+    return posix_memalign(&p, ALVALUE, size) ? NULL : p;
+}
+
+static void heap_free_aligned(void* p) { free(p); }
+#endif
+
+void* svt_large_calloc(size_t size, const EbLargeAllocPolicy* policy) {
+    uint8_t* base   = NULL;
+    size_t   length = 0;
+
+    if (size >= LARGE_ALLOC_MIN_SIZE && policy &&
+        (policy->huge_pages || policy->numa_node_mask))
+        base = map_large(size + LARGE_ALLOC_HEADER, &length, policy);
+    if (!base) {
+        length = 0;
+        base   = heap_alloc_aligned(size + LARGE_ALLOC_HEADER);
+        if (!base)
+            return NULL;
+        memset(base, 0, size + LARGE_ALLOC_HEADER);
+    }
+    *(size_t*)base = length;
+    return base + LARGE_ALLOC_HEADER;
+}
+
+void svt_large_free(void* ptr) {
+    if (!ptr)
+        return;
+    uint8_t*     base   = (uint8_t*)ptr - LARGE_ALLOC_HEADER;
+    const size_t length = *(size_t*)base;
+    if (length)
+        unmap_large(base, length);
+    else
+        heap_free_aligned(base);
+}
+
 #ifdef DEBUG_MEMORY_USAGE
 
 static EbHandle g_malloc_mutex;
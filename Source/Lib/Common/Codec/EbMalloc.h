@@ -194,4 +194,30 @@ void svt_remove_mem_entry(void* ptr, EbPtrType type);
 
 #define EB_FREE_ALIGNED_ARRAY(pa) EB_FREE_ALIGNED(pa)
 
+/* Large buffers, e.g. the picture planes. Served from huge pages and bound to
+ * a NUMA node as the policy of the encoder asks, else (or with a NULL or zeroed
+ * policy) from the aligned heap. Always zeroed and ALVALUE aligned. */
+typedef struct EbLargeAllocPolicy {
+    uint32_t huge_pages; // 0 off, 1 transparent, 2 explicit
+    uint32_t numa_node_mask; // bit n prefers NUMA node n, 0 for any node
+} EbLargeAllocPolicy;
+
+EbLargeAllocPolicy svt_large_alloc_policy(uint32_t huge_pages, int32_t numa_node);
+
+void* svt_large_calloc(size_t size, const EbLargeAllocPolicy* policy);
+void  svt_large_free(void* ptr);
+
+#define EB_CALLOC_LARGE_ARRAY(pa, count, policy)                \
+    do {                                                        \
+        pa = svt_large_calloc(sizeof(*(pa)) * (count), policy); \
+        EB_ADD_MEM(pa, sizeof(*(pa)) * (count), EB_A_PTR);      \
+    } while (0)
+
+#define EB_FREE_LARGE_ARRAY(pa)            \
+    do {                                   \
+        EB_REMOVE_MEM_ENTRY(pa, EB_A_PTR); \
+        svt_large_free(pa);                \
+        pa = NULL;                         \
+    } while (0)
+
 #endif //EbMalloc_h
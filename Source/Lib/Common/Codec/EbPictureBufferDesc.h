@@ -292,6 +292,8 @@ typedef struct EbPictureBufferDescInitData {
     EbBool         down_sampled_filtered;
     uint8_t        mfmv;
     EbBool         is_16bit_pipeline;
+    // alloc_policy - large allocation policy of the encoder, zeroed for the heap
+    EbLargeAllocPolicy alloc_policy;
 } EbPictureBufferDescInitData;
 
 /**************************************
@@ -1258,6 +1258,7 @@ typedef struct {
     uint8_t *               data8, *dst8;
     int32_t                 data_stride, dst_stride;
     int32_t *               tmpbuf;
+    int32_t                 v_start, v_end;
 } FilterFrameCtxt;
 
 static void filter_frame_on_tile(int32_t tile_row, int32_t tile_col, void *priv) {
@@ -1271,8 +1272,16 @@ static void filter_frame_on_unit(const RestorationTileLimits *limits, const Av1P
     FilterFrameCtxt *      ctxt = (FilterFrameCtxt *)priv;
     const RestorationInfo *rsi  = ctxt->rsi;
 
+    // Units and bands both start on processing stripe boundaries, so clipping
+    // the unit to the band keeps the stripe layout of the whole-frame pass
+    RestorationTileLimits band_limits = *limits;
+    band_limits.v_start               = AOMMAX(limits->v_start, ctxt->v_start);
+    band_limits.v_end                 = AOMMIN(limits->v_end, ctxt->v_end);
+    if (band_limits.v_start >= band_limits.v_end)
+        return;
+
     svt_av1_loop_restoration_filter_unit(1,
-                                         limits,
+                                         &band_limits,
                                          &rsi->unit_info[rest_unit_idx],
                                          &rsi->boundaries,
                                          ctxt->rlbs,
@@ -1351,6 +1360,8 @@ void svt_av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *c
         ctxt.data_stride = frame->strides[is_uv];
         ctxt.dst_stride  = dst->strides[is_uv];
         ctxt.tmpbuf      = cm->rst_tmpbuf;
+        ctxt.v_start     = 0;
+        ctxt.v_end       = plane_height;
 
         av1_foreach_rest_unit_in_frame(
             cm, plane, filter_frame_on_tile, filter_frame_on_unit, &ctxt);
@@ -1363,6 +1374,139 @@ void svt_av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *c
     }
 }
 
+/* Band based application of the loop restoration filter.
+ * The frame is split in bands of whole processing stripes which can be filtered
+ * concurrently. setup_processing_stripe_boundary() temporarily overwrites the
+ * rows around each stripe, so a band reads from its own copy of the source rows
+ * and writes to cm->rst_frame; the result is copied back once all bands are done.
+ */
+void svt_av1_loop_restoration_filter_frame_init(Yv12BufferConfig *frame, Av1Common *cm,
+                                                int32_t optimized_lr) {
+    const int32_t num_planes = 3; // av1_num_planes(cm);
+    if (svt_aom_realloc_frame_buffer(&cm->rst_frame,
+                                     frame->crop_widths[0],
+                                     frame->crop_heights[0],
+                                     cm->subsampling_x,
+                                     cm->subsampling_y,
+                                     cm->use_highbitdepth,
+                                     AOM_BORDER_IN_PIXELS,
+                                     cm->byte_alignment,
+                                     NULL,
+                                     NULL,
+                                     NULL) < 0)
+        SVT_LOG("Failed to allocate restoration dst buffer\n");
+
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        RestorationInfo *rsi = &cm->rst_info[plane];
+        rsi->optimized_lr    = optimized_lr;
+        if (rsi->frame_restoration_type == RESTORE_NONE)
+            continue;
+        const int32_t is_uv = plane > 0;
+        svt_extend_frame(frame->buffers[plane],
+                         frame->crop_widths[is_uv],
+                         frame->crop_heights[is_uv],
+                         frame->strides[is_uv],
+                         RESTORATION_BORDER,
+                         RESTORATION_BORDER,
+                         cm->use_highbitdepth);
+    }
+}
+
+// Luma rows [*y_start, *y_end) of band band_idx out of band_cnt, aligned on processing stripes
+static void get_lr_band_rows(const Yv12BufferConfig *frame, int32_t band_idx, int32_t band_cnt,
+                             int32_t is_uv, int32_t ss_y, int32_t *y_start, int32_t *y_end) {
+    const int32_t height      = frame->crop_heights[0];
+    const int32_t stripe_cnt  = (height + RESTORATION_UNIT_OFFSET + RESTORATION_PROC_UNIT_SIZE - 1) /
+        RESTORATION_PROC_UNIT_SIZE;
+    const int32_t stripe_start = band_idx * stripe_cnt / band_cnt;
+    const int32_t stripe_end   = (band_idx + 1) * stripe_cnt / band_cnt;
+    const int32_t plane_height = frame->crop_heights[is_uv];
+
+    *y_start = stripe_start == 0
+        ? 0
+        : (stripe_start * RESTORATION_PROC_UNIT_SIZE - RESTORATION_UNIT_OFFSET) >> ss_y;
+    *y_end = stripe_end == stripe_cnt
+        ? plane_height
+        : (stripe_end * RESTORATION_PROC_UNIT_SIZE - RESTORATION_UNIT_OFFSET) >> ss_y;
+}
+
+void svt_av1_loop_restoration_filter_band(Yv12BufferConfig *frame, Yv12BufferConfig *band_src,
+                                          Av1Common *cm, int32_t *tmpbuf, int32_t band_idx,
+                                          int32_t band_cnt) {
+    const int32_t          num_planes = 3; // av1_num_planes(cm);
+    Yv12BufferConfig *     dst        = &cm->rst_frame;
+    RestorationLineBuffers rlbs;
+    const int32_t          highbd = cm->use_highbitdepth;
+    const int32_t          border = AOMMIN(frame->border, band_src->border);
+
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        RestorationInfo *rsi = &cm->rst_info[plane];
+        if (rsi->frame_restoration_type == RESTORE_NONE)
+            continue;
+        const int32_t is_uv        = plane > 0;
+        const int32_t ss_y         = is_uv && cm->subsampling_y;
+        const int32_t plane_width  = frame->crop_widths[is_uv];
+        const int32_t plane_height = frame->crop_heights[is_uv];
+        int32_t       y_start, y_end;
+        get_lr_band_rows(frame, band_idx, band_cnt, is_uv, ss_y, &y_start, &y_end);
+        if (y_start >= y_end)
+            continue;
+
+        // Copy the band with its context rows; the extended frame border is
+        // RESTORATION_BORDER rows high
+        const int32_t copy_start = AOMMAX(y_start - RESTORATION_BORDER, -RESTORATION_BORDER);
+        const int32_t copy_end   = AOMMIN(y_end + RESTORATION_BORDER,
+                                        plane_height + RESTORATION_BORDER);
+        const int32_t src_stride = frame->strides[is_uv];
+        const int32_t cpy_stride = band_src->strides[is_uv];
+        uint8_t *     src_row    = REAL_PTR(highbd, frame->buffers[plane]) +
+            ((copy_start * src_stride - border) << highbd);
+        uint8_t *cpy_row = REAL_PTR(highbd, band_src->buffers[plane]) +
+            ((copy_start * cpy_stride - border) << highbd);
+        for (int32_t row = copy_start; row < copy_end; ++row) {
+            svt_memcpy(cpy_row, src_row, (plane_width + 2 * border) << highbd);
+            src_row += src_stride << highbd;
+            cpy_row += cpy_stride << highbd;
+        }
+
+        FilterFrameCtxt ctxt;
+        ctxt.rsi         = rsi;
+        ctxt.rlbs        = &rlbs;
+        ctxt.cm          = cm;
+        ctxt.ss_x        = is_uv && cm->subsampling_x;
+        ctxt.ss_y        = ss_y;
+        ctxt.highbd      = highbd;
+        ctxt.bit_depth   = cm->bit_depth;
+        ctxt.data8       = band_src->buffers[plane];
+        ctxt.dst8        = dst->buffers[plane];
+        ctxt.data_stride = cpy_stride;
+        ctxt.dst_stride  = dst->strides[is_uv];
+        ctxt.tmpbuf      = tmpbuf;
+        ctxt.v_start     = y_start;
+        ctxt.v_end       = y_end;
+
+        av1_foreach_rest_unit_in_frame(
+            cm, plane, filter_frame_on_tile, filter_frame_on_unit, &ctxt);
+    }
+}
+
+void svt_av1_loop_restoration_filter_frame_finish(Yv12BufferConfig *frame, Av1Common *cm) {
+    const int32_t num_planes = 3; // av1_num_planes(cm);
+    typedef void (*CopyFun)(const Yv12BufferConfig *src, Yv12BufferConfig *dst);
+    static const CopyFun copy_funs[3] = {
+        svt_aom_yv12_copy_y_c, svt_aom_yv12_copy_u_c, svt_aom_yv12_copy_v_c};
+
+    Yv12BufferConfig *dst = &cm->rst_frame;
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        if (cm->rst_info[plane].frame_restoration_type != RESTORE_NONE)
+            copy_funs[plane](dst, frame);
+    }
+    if (dst->buffer_alloc_sz) {
+        dst->buffer_alloc_sz = 0;
+        EB_FREE_ARRAY(dst->buffer_alloc);
+    }
+}
+
 static void foreach_rest_unit_in_tile(const Av1PixelRect *tile_rect, int32_t tile_row,
                                       int32_t tile_col, int32_t tile_cols, int32_t hunits_per_tile,
                                       int32_t units_per_tile, int32_t unit_size, int32_t ss_y,
@@ -11,10 +11,14 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbSystemResourceManager.h"
 #include "EbDefinitions.h"
 #include "EbThreads.h"
+#include "EbTaskScheduler.h"
+#include "EbTime.h"
+#include "EbUtility.h"
 
 static void svt_fifo_dctor(EbPtr p) {
     EbFifo *obj = (EbFifo *)p;
@@ -167,6 +171,26 @@ static EbErrorType svt_circular_buffer_push_back(EbCircularBuffer *bufferPtr, Eb
     return return_error;
 }
 
+/**************************************
+ * svt_circular_buffer_pop_back
+ **************************************/
+static EbErrorType svt_circular_buffer_pop_back(EbCircularBuffer *bufferPtr, EbPtr *object_ptr) {
+    EbErrorType return_error = EB_ErrorNone;
+
+    // Decrement the tail & check for rollover
+    bufferPtr->tail_index = (bufferPtr->tail_index == 0) ? bufferPtr->buffer_total_count - 1
+                                                         : bufferPtr->tail_index - 1;
+
+    // Copy the tail of the buffer into the object_ptr
+    *object_ptr                                 = bufferPtr->array_ptr[bufferPtr->tail_index];
+    bufferPtr->array_ptr[bufferPtr->tail_index] = NULL;
+
+    // Decrement the Current Count
+    --bufferPtr->current_count;
+
+    return return_error;
+}
+
 /**************************************
  * svt_circular_buffer_push_front
  **************************************/
@@ -191,6 +215,7 @@ void svt_muxing_queue_dctor(EbPtr p) {
     EB_DELETE_PTR_ARRAY(obj->process_fifo_ptr_array, obj->process_total_count);
     EB_DELETE(obj->object_queue);
     EB_DELETE(obj->process_queue);
+    EB_FREE(obj->ring);
     EB_DESTROY_MUTEX(obj->lockout_mutex);
 }
 
@@ -289,11 +314,152 @@ static EbErrorType svt_muxing_queue_object_push_front(EbMuxingQueue *  queue_ptr
     return return_error;
 }
 
+/**************************************
+ * svt_muxing_queue_ring_ctor
+ *   Switches a queue with a single consumer process to the ring. The
+ *   ring can hold every object of the SystemResource, so it never
+ *   overflows.
+ **************************************/
+static EbErrorType svt_muxing_queue_ring_ctor(EbMuxingQueue *queue_ptr,
+                                              uint32_t       object_total_count) {
+    uint32_t ring_size = 1;
+    while (ring_size < object_total_count) ring_size <<= 1;
+
+    EB_CALLOC(queue_ptr->ring, ring_size, sizeof(EbObjectWrapper *));
+    queue_ptr->ring_mask = ring_size - 1;
+    queue_ptr->ring_head = 0;
+    queue_ptr->ring_tail = 0;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_muxing_queue_ring_push_back
+ **************************************/
+static void svt_muxing_queue_ring_push_back(EbMuxingQueue *queue_ptr, EbObjectWrapper *object_ptr) {
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+
+    uint32_t head = queue_ptr->ring_head;
+    assert(head - queue_ptr->ring_tail <= queue_ptr->ring_mask);
+    queue_ptr->ring[head & queue_ptr->ring_mask] = object_ptr;
+    // Publish the object to the consumer
+    svt_atomic_store_u32(&queue_ptr->ring_head, head + 1);
+
+    svt_release_mutex(queue_ptr->lockout_mutex);
+
+    // Wake up the consumer, only a syscall when it is blocked
+    svt_post_semaphore(queue_ptr->process_fifo_ptr_array[0]->counting_semaphore);
+}
+
+/**************************************
+ * svt_muxing_queue_ring_pop_front
+ **************************************/
+static void svt_muxing_queue_ring_pop_front(EbMuxingQueue *queue_ptr, EbObjectWrapper **object_ptr) {
+    uint32_t tail = queue_ptr->ring_tail;
+    assert(tail != svt_atomic_load_u32(&queue_ptr->ring_head));
+    *object_ptr           = queue_ptr->ring[tail & queue_ptr->ring_mask];
+    queue_ptr->ring_tail = tail + 1;
+}
+
+/**************************************
+ * svt_resource_stats_time
+ *   current time in us
+ **************************************/
+static uint64_t svt_resource_stats_time(void) {
+    uint64_t seconds, useconds;
+    svt_av1_get_time(&seconds, &useconds);
+    return seconds * 1000000 + useconds;
+}
+
+static void svt_resource_stats_dctor(EbPtr p) {
+    EbResourceStats *obj = (EbResourceStats *)p;
+    EB_DESTROY_MUTEX(obj->lockout_mutex);
+}
+
+/**************************************
+ * svt_resource_stats_ctor
+ **************************************/
+static EbErrorType svt_resource_stats_ctor(EbResourceStats *stats, const char *name) {
+    stats->dctor = svt_resource_stats_dctor;
+    stats->name  = name;
+    EB_CREATE_MUTEX(stats->lockout_mutex);
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_resource_stats_post
+ *   Called before the object is queued, so a consumer
+ *   can not take it before it is counted
+ **************************************/
+static void svt_resource_stats_post(EbResourceStats *stats, EbObjectWrapper *wrapper_ptr) {
+    wrapper_ptr->post_time = svt_resource_stats_time();
+
+    svt_block_on_mutex(stats->lockout_mutex);
+    ++stats->posted_count;
+    ++stats->queue_depth;
+    stats->max_queue_depth = MAX(stats->max_queue_depth, stats->queue_depth);
+    stats->queue_depth_sum += stats->queue_depth;
+    svt_release_mutex(stats->lockout_mutex);
+}
+
+/**************************************
+ * svt_resource_stats_dequeue
+ *   Accounts an object taken from the full queue,
+ *   returns the time it was taken
+ **************************************/
+static uint64_t svt_resource_stats_dequeue(EbResourceStats *stats, EbObjectWrapper *wrapper_ptr) {
+    const uint64_t dequeue_time = svt_resource_stats_time();
+    const uint64_t queue_time   = dequeue_time - wrapper_ptr->post_time;
+
+    svt_block_on_mutex(stats->lockout_mutex);
+    --stats->queue_depth;
+    stats->queue_time += queue_time;
+    stats->max_queue_time = MAX(stats->max_queue_time, queue_time);
+    svt_release_mutex(stats->lockout_mutex);
+
+    return dequeue_time;
+}
+
+/**************************************
+ * svt_resource_stats_add_time
+ **************************************/
+static void svt_resource_stats_add_time(EbResourceStats *stats, uint64_t *time_ptr,
+                                        uint64_t start_time) {
+    const uint64_t time = svt_resource_stats_time() - start_time;
+
+    svt_block_on_mutex(stats->lockout_mutex);
+    *time_ptr += time;
+    svt_release_mutex(stats->lockout_mutex);
+}
+
 static EbFifo *svt_muxing_queue_get_fifo(EbMuxingQueue *queue_ptr, uint32_t index) {
     assert(queue_ptr->process_fifo_ptr_array && (queue_ptr->process_total_count > index));
     return queue_ptr->process_fifo_ptr_array[index];
 }
 
+// The read of waiting is a read-modify-write: when it reads 0, the waiter's increment
+// comes later in the order of waiting and sees this decrement of active_count
+static void svt_muxing_queue_finish_object(EbMuxingQueue *queue_ptr) {
+    if (queue_ptr->idle_signal &&
+        svt_atomic_add_u32(&queue_ptr->active_count, (uint32_t)-1) == 0 &&
+        svt_atomic_add_u32(&queue_ptr->idle_signal->waiting, 0))
+        svt_post_semaphore(queue_ptr->idle_signal->semaphore);
+}
+
+// Asking for the next full object means the consumer is done with the previous one
+static void svt_fifo_finish_object(EbFifo *full_fifo_ptr) {
+    EbResourceStats *stats = full_fifo_ptr->queue_ptr->stats;
+
+    if (stats && full_fifo_ptr->dequeue_time) {
+        svt_resource_stats_add_time(stats, &stats->busy_time, full_fifo_ptr->dequeue_time);
+        full_fifo_ptr->dequeue_time = 0;
+    }
+    if (full_fifo_ptr->active) {
+        full_fifo_ptr->active = EB_FALSE;
+        svt_muxing_queue_finish_object(full_fifo_ptr->queue_ptr);
+    }
+}
+
 /*********************************************************************
  * svt_object_release_enable
  *   Enables the release_enable member of EbObjectWrapper.  Used by
@@ -407,52 +573,34 @@ static EbErrorType svt_object_wrapper_ctor(EbObjectWrapper *wrapper, EbSystemRes
 
 static void svt_system_resource_dctor(EbPtr p) {
     EbSystemResource *obj = (EbSystemResource *)p;
+    EB_DELETE(obj->stats);
     EB_DELETE(obj->full_queue);
     EB_DELETE(obj->empty_queue);
     EB_DELETE_PTR_ARRAY(obj->wrapper_ptr_pool, obj->object_total_count);
+    EB_FREE(obj->object_init_data_copy);
+    EB_DESTROY_MUTEX(obj->elastic_mutex);
 }
 
 /*********************************************************************
- * svt_system_resource_ctor
- *   Constructor for EbSystemResource.  Fully constructs all members
- *   of EbSystemResource including the object with the passed
- *   object_ctor function.
- *
- *   resource_ptr
- *     pointer that will contain the SystemResource to be constructed.
- *
- *   object_total_count
- *     Number of objects to be managed by the SystemResource.
- *
- *   object_ctor
- *     Function pointer to the constructor of the object managed by
- *     SystemResource referenced by resource_ptr. No object level
- *     construction is performed if object_ctor is NULL.
- *
- *   object_init_data_ptr
-
- *     pointer to data block to be used during the construction of
- *     the object. object_init_data_ptr is passed to object_ctor when
- *     object_ctor is called.
- *   object_destroyer
- *     object destroyer, will call dctor if this is null
+ * svt_system_resource_construct
+ *   Constructs the queues for object_total_count objects, and the
+ *   first object_count objects
  *********************************************************************/
-EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t object_total_count,
-                                     uint32_t  producer_process_total_count,
-                                     uint32_t  consumer_process_total_count,
-                                     EbCreator object_creator, EbPtr object_init_data_ptr,
-                                     EbDctor object_destroyer) {
+static EbErrorType svt_system_resource_construct(EbSystemResource *resource_ptr,
+                                                 uint32_t          object_count,
+                                                 uint32_t          producer_process_total_count,
+                                                 uint32_t          consumer_process_total_count,
+                                                 EbCreator         object_creator,
+                                                 EbPtr             object_init_data_ptr,
+                                                 EbDctor           object_destroyer) {
     uint32_t    wrapper_index;
     EbErrorType return_error = EB_ErrorNone;
-    resource_ptr->dctor      = svt_system_resource_dctor;
-
-    resource_ptr->object_total_count = object_total_count;
 
     // Allocate array for wrapper pointers
     EB_ALLOC_PTR_ARRAY(resource_ptr->wrapper_ptr_pool, resource_ptr->object_total_count);
 
     // Initialize each wrapper
-    for (wrapper_index = 0; wrapper_index < resource_ptr->object_total_count; ++wrapper_index) {
+    for (wrapper_index = 0; wrapper_index < object_count; ++wrapper_index) {
         EB_NEW(resource_ptr->wrapper_ptr_pool[wrapper_index],
                svt_object_wrapper_ctor,
                resource_ptr,
@@ -467,7 +615,7 @@ EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t ob
            resource_ptr->object_total_count,
            producer_process_total_count);
     // Fill the Empty Fifo with every ObjectWrapper
-    for (wrapper_index = 0; wrapper_index < resource_ptr->object_total_count; ++wrapper_index) {
+    for (wrapper_index = 0; wrapper_index < object_count; ++wrapper_index) {
         svt_muxing_queue_object_push_back(resource_ptr->empty_queue,
                                           resource_ptr->wrapper_ptr_pool[wrapper_index]);
     }
@@ -478,6 +626,13 @@ EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t ob
                svt_muxing_queue_ctor,
                resource_ptr->object_total_count,
                consumer_process_total_count);
+        // A single consumer doesn't need the muxing, it reads the ring without the lock
+        if (consumer_process_total_count == 1) {
+            return_error = svt_muxing_queue_ring_ctor(resource_ptr->full_queue,
+                                                      resource_ptr->object_total_count);
+            if (return_error != EB_ErrorNone)
+                return return_error;
+        }
     } else {
         resource_ptr->full_queue = (EbMuxingQueue *)NULL;
     }
@@ -485,6 +640,126 @@ EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t ob
     return return_error;
 }
 
+/*********************************************************************
+ * svt_system_resource_ctor
+ *   Constructor for EbSystemResource.  Fully constructs all members
+ *   of EbSystemResource including the object with the passed
+ *   object_ctor function.
+ *
+ *   resource_ptr
+ *     pointer that will contain the SystemResource to be constructed.
+ *
+ *   object_total_count
+ *     Number of objects to be managed by the SystemResource.
+ *
+ *   object_ctor
+ *     Function pointer to the constructor of the object managed by
+ *     SystemResource referenced by resource_ptr. No object level
+ *     construction is performed if object_ctor is NULL.
+ *
+ *   object_init_data_ptr
+
+ *     pointer to data block to be used during the construction of
+ *     the object. object_init_data_ptr is passed to object_ctor when
+ *     object_ctor is called.
+ *   object_destroyer
+ *     object destroyer, will call dctor if this is null
+ *********************************************************************/
+EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr, uint32_t object_total_count,
+                                     uint32_t  producer_process_total_count,
+                                     uint32_t  consumer_process_total_count,
+                                     EbCreator object_creator, EbPtr object_init_data_ptr,
+                                     EbDctor object_destroyer) {
+    resource_ptr->dctor = svt_system_resource_dctor;
+
+    resource_ptr->object_total_count = object_total_count;
+
+    return svt_system_resource_construct(resource_ptr,
+                                         object_total_count,
+                                         producer_process_total_count,
+                                         consumer_process_total_count,
+                                         object_creator,
+                                         object_init_data_ptr,
+                                         object_destroyer);
+}
+
+EbErrorType svt_system_resource_elastic_ctor(
+    EbSystemResource *resource_ptr, uint32_t object_min_count, uint32_t object_max_count,
+    uint32_t producer_process_total_count, uint32_t consumer_process_total_count,
+    EbCreator object_creator, EbPtr object_init_data_ptr, size_t object_init_data_size,
+    EbDctor object_destroyer, uint32_t shrink_time) {
+    EbErrorType return_error;
+
+    if (object_min_count >= object_max_count)
+        return svt_system_resource_ctor(resource_ptr,
+                                        object_max_count,
+                                        producer_process_total_count,
+                                        consumer_process_total_count,
+                                        object_creator,
+                                        object_init_data_ptr,
+                                        object_destroyer);
+
+    resource_ptr->dctor = svt_system_resource_dctor;
+
+    resource_ptr->object_total_count = object_max_count;
+    resource_ptr->object_count       = object_min_count;
+    resource_ptr->object_min_count   = object_min_count;
+    resource_ptr->object_creator     = object_creator;
+    resource_ptr->object_destroyer   = object_destroyer;
+    resource_ptr->shrink_time        = (uint64_t)shrink_time * 1000;
+
+    // The init data of the caller is usually gone by the time the resource grows
+    resource_ptr->object_init_data_ptr = object_init_data_ptr;
+    if (object_init_data_size) {
+        EB_MALLOC(resource_ptr->object_init_data_copy, object_init_data_size);
+        memcpy(resource_ptr->object_init_data_copy, object_init_data_ptr, object_init_data_size);
+        resource_ptr->object_init_data_ptr = resource_ptr->object_init_data_copy;
+    }
+    EB_CREATE_MUTEX(resource_ptr->elastic_mutex);
+
+    return_error = svt_system_resource_construct(resource_ptr,
+                                                 object_min_count,
+                                                 producer_process_total_count,
+                                                 consumer_process_total_count,
+                                                 object_creator,
+                                                 resource_ptr->object_init_data_ptr,
+                                                 object_destroyer);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    resource_ptr->empty_queue->elastic_resource_ptr = resource_ptr;
+    return EB_ErrorNone;
+}
+
+EbErrorType svt_system_resource_enable_stats(EbSystemResource *resource_ptr, const char *name) {
+    EB_NEW(resource_ptr->stats, svt_resource_stats_ctor, name);
+
+    resource_ptr->empty_queue->stats = resource_ptr->stats;
+    if (resource_ptr->full_queue)
+        resource_ptr->full_queue->stats = resource_ptr->stats;
+
+    return EB_ErrorNone;
+}
+
+void svt_system_resource_set_release_callback(EbSystemResource *resource_ptr,
+                                              EbObjectRelease object_release, void *priv) {
+    resource_ptr->object_release      = object_release;
+    resource_ptr->object_release_priv = priv;
+}
+
+uint64_t svt_resource_stats_start_task(EbSystemResource *resource_ptr,
+                                       EbObjectWrapper * wrapper_ptr) {
+    if (!resource_ptr->stats)
+        return 0;
+    return svt_resource_stats_dequeue(resource_ptr->stats, wrapper_ptr);
+}
+
+void svt_resource_stats_finish_task(EbSystemResource *resource_ptr, uint64_t start_time) {
+    if (resource_ptr->stats)
+        svt_resource_stats_add_time(
+            resource_ptr->stats, &resource_ptr->stats->busy_time, start_time);
+}
+
 EbFifo *svt_system_resource_get_producer_fifo(const EbSystemResource *resource_ptr,
                                               uint32_t                index) {
     return svt_muxing_queue_get_fifo(resource_ptr->empty_queue, index);
@@ -542,6 +817,29 @@ static EbErrorType svt_release_process(EbFifo *process_fifo_ptr) {
 EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
     EbErrorType return_error = EB_ErrorNone;
 
+    // Count the object active before it is posted, see svt_system_resource_is_idle.
+    // Only the queues a thread may wait on are counted.
+    if (object_ptr->system_resource_ptr->full_queue->idle_signal) {
+        svt_atomic_add_u32(&object_ptr->system_resource_ptr->full_queue->active_count, 1);
+        svt_atomic_add_u32(&object_ptr->system_resource_ptr->full_queue->post_count, 1);
+    }
+
+    if (object_ptr->system_resource_ptr->full_queue->stats)
+        svt_resource_stats_post(object_ptr->system_resource_ptr->full_queue->stats, object_ptr);
+
+    if (object_ptr->system_resource_ptr->full_queue->task_stage_ptr) {
+        return_error = svt_task_scheduler_post(
+            object_ptr->system_resource_ptr->full_queue->task_stage_ptr, object_ptr);
+        if (return_error != EB_ErrorNone)
+            svt_muxing_queue_finish_object(object_ptr->system_resource_ptr->full_queue);
+        return return_error;
+    }
+
+    if (object_ptr->system_resource_ptr->full_queue->ring) {
+        svt_muxing_queue_ring_push_back(object_ptr->system_resource_ptr->full_queue, object_ptr);
+        return return_error;
+    }
+
     svt_block_on_mutex(object_ptr->system_resource_ptr->full_queue->lockout_mutex);
 
     svt_muxing_queue_object_push_back(object_ptr->system_resource_ptr->full_queue, object_ptr);
@@ -551,6 +849,103 @@ EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
     return return_error;
 }
 
+/*********************************************************************
+ * svt_system_resource_grow
+ *   Constructs one more object of an elastic SystemResource when a
+ *   producer is left waiting in the process queue of the empty queue.
+ *   The object is reserved under elastic_mutex and constructed without
+ *   it, so the other producers and svt_system_resource_reclaim do not
+ *   wait for the construction.
+ *********************************************************************/
+static void svt_system_resource_grow(EbSystemResource *resource_ptr) {
+    EbMuxingQueue *  empty_queue = resource_ptr->empty_queue;
+    EbObjectWrapper *wrapper_ptr;
+    EbBool           reserved = EB_FALSE;
+
+    svt_block_on_mutex(resource_ptr->elastic_mutex);
+
+    svt_block_on_mutex(empty_queue->lockout_mutex);
+    const EbBool waiting = !svt_circular_buffer_empty_check(empty_queue->process_queue);
+    if (waiting && resource_ptr->shrink_time)
+        resource_ptr->last_wait_time = svt_resource_stats_time();
+    svt_release_mutex(empty_queue->lockout_mutex);
+
+    if (waiting && resource_ptr->object_count + resource_ptr->object_reserved_count <
+                       resource_ptr->object_total_count) {
+        ++resource_ptr->object_reserved_count;
+        reserved = EB_TRUE;
+    }
+
+    svt_release_mutex(resource_ptr->elastic_mutex);
+
+    if (!reserved)
+        return;
+
+    EB_NO_THROW_NEW(wrapper_ptr,
+                    svt_object_wrapper_ctor,
+                    resource_ptr,
+                    resource_ptr->object_creator,
+                    resource_ptr->object_init_data_ptr,
+                    resource_ptr->object_destroyer);
+
+    svt_block_on_mutex(resource_ptr->elastic_mutex);
+    --resource_ptr->object_reserved_count;
+    // Out of memory, the producer waits for a release as with a fixed count
+    if (wrapper_ptr) {
+        uint32_t wrapper_index = 0;
+        while (resource_ptr->wrapper_ptr_pool[wrapper_index]) ++wrapper_index;
+        resource_ptr->wrapper_ptr_pool[wrapper_index] = wrapper_ptr;
+        ++resource_ptr->object_count;
+
+        svt_block_on_mutex(empty_queue->lockout_mutex);
+        svt_muxing_queue_object_push_back(empty_queue, wrapper_ptr);
+        svt_release_mutex(empty_queue->lockout_mutex);
+    }
+    svt_release_mutex(resource_ptr->elastic_mutex);
+}
+
+/*********************************************************************
+ * svt_system_resource_shrink
+ *   Destructs the least recently used empty object of an idle elastic
+ *   SystemResource, unless it is down to object_min_count. Called by
+ *   the producers as they ask for an empty object, without any lock
+ *   held, rather than by the stages releasing the objects.
+ *********************************************************************/
+static void svt_system_resource_shrink(EbSystemResource *resource_ptr) {
+    EbMuxingQueue *  empty_queue = resource_ptr->empty_queue;
+    EbObjectWrapper *wrapper_ptr = NULL;
+    EbBool           destruct    = EB_FALSE;
+
+    // The count is only a hint here, it is checked again under elastic_mutex
+    svt_block_on_mutex(empty_queue->lockout_mutex);
+    if (resource_ptr->object_count > resource_ptr->object_min_count &&
+        empty_queue->object_queue->current_count > 1 &&
+        svt_resource_stats_time() - resource_ptr->last_wait_time > resource_ptr->shrink_time)
+        svt_circular_buffer_pop_back(empty_queue->object_queue, (EbPtr *)&wrapper_ptr);
+    svt_release_mutex(empty_queue->lockout_mutex);
+
+    if (!wrapper_ptr)
+        return;
+
+    svt_block_on_mutex(resource_ptr->elastic_mutex);
+    if (resource_ptr->object_count > resource_ptr->object_min_count) {
+        uint32_t wrapper_index = 0;
+        while (resource_ptr->wrapper_ptr_pool[wrapper_index] != wrapper_ptr) ++wrapper_index;
+        resource_ptr->wrapper_ptr_pool[wrapper_index] = NULL;
+        --resource_ptr->object_count;
+        destruct = EB_TRUE;
+    }
+    svt_release_mutex(resource_ptr->elastic_mutex);
+
+    if (destruct) {
+        EB_DELETE(wrapper_ptr);
+    } else {
+        svt_block_on_mutex(empty_queue->lockout_mutex);
+        svt_muxing_queue_object_push_back(empty_queue, wrapper_ptr);
+        svt_release_mutex(empty_queue->lockout_mutex);
+    }
+}
+
 /*********************************************************************
  * EbSystemResourceReleaseObject
  *   Queues an empty EbObjectWrapper to the SystemResource. This
@@ -562,9 +957,10 @@ EbErrorType svt_post_full_object(EbObjectWrapper *object_ptr) {
  *      pointer to EbObjectWrapper to be released.
  *********************************************************************/
 EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType       return_error = EB_ErrorNone;
+    EbSystemResource *resource_ptr = object_ptr->system_resource_ptr;
 
-    svt_block_on_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+    svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
 
     // Decrement live_count
     object_ptr->live_count = (object_ptr->live_count == 0) ? object_ptr->live_count
@@ -574,15 +970,121 @@ EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
         // Set live_count to EB_ObjectWrapperReleasedValue
         object_ptr->live_count = EB_ObjectWrapperReleasedValue;
 
-        svt_muxing_queue_object_push_front(object_ptr->system_resource_ptr->empty_queue,
-                                           object_ptr);
+        if (resource_ptr->object_release) {
+            // Nobody else holds the object, the callback may block without the lock
+            svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
+            resource_ptr->object_release(object_ptr->object_ptr,
+                                         resource_ptr->object_release_priv);
+            svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
+        }
+
+        object_ptr->owner_fifo_ptr = NULL;
+        svt_muxing_queue_object_push_front(resource_ptr->empty_queue, object_ptr);
     }
 
-    svt_release_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+    svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
 
     return return_error;
 }
 
+/*********************************************************************
+ * svt_system_resource_reclaim
+ *********************************************************************/
+void svt_system_resource_reclaim(EbSystemResource *resource_ptr, EbFifo *empty_fifo_ptr) {
+    // The elastic mutex keeps wrapper_ptr_pool stable during the search
+    if (resource_ptr->elastic_mutex)
+        svt_block_on_mutex(resource_ptr->elastic_mutex);
+    svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
+
+    for (uint32_t wrapper_index = 0; wrapper_index < resource_ptr->object_total_count;
+         ++wrapper_index) {
+        EbObjectWrapper *wrapper_ptr = resource_ptr->wrapper_ptr_pool[wrapper_index];
+        if (wrapper_ptr && wrapper_ptr->owner_fifo_ptr &&
+            (!empty_fifo_ptr || wrapper_ptr->owner_fifo_ptr == empty_fifo_ptr)) {
+            wrapper_ptr->live_count = EB_ObjectWrapperReleasedValue;
+            if (resource_ptr->object_release) {
+                // Not queued yet, the callback may block without the lock
+                svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
+                resource_ptr->object_release(wrapper_ptr->object_ptr,
+                                             resource_ptr->object_release_priv);
+                svt_block_on_mutex(resource_ptr->empty_queue->lockout_mutex);
+            }
+            wrapper_ptr->owner_fifo_ptr = NULL;
+            svt_muxing_queue_object_push_front(resource_ptr->empty_queue, wrapper_ptr);
+        }
+    }
+
+    svt_release_mutex(resource_ptr->empty_queue->lockout_mutex);
+    if (resource_ptr->elastic_mutex)
+        svt_release_mutex(resource_ptr->elastic_mutex);
+}
+
+/*********************************************************************
+ * svt_system_resource_is_idle
+ *   Returns EB_TRUE when no posted object of the SystemResource is
+ *   queued or being processed. The number of posts is returned in
+ *   post_count_ptr; a caller checking several resources repeats the
+ *   check until no post happened in between.
+ *********************************************************************/
+EbBool svt_system_resource_is_idle(EbSystemResource *resource_ptr, uint32_t *post_count_ptr) {
+    EbMuxingQueue *full_queue = resource_ptr->full_queue;
+    // Read before active_count: a post hidden by the check changes post_count
+    *post_count_ptr = svt_atomic_load_u32(&full_queue->post_count);
+    return svt_atomic_load_u32(&full_queue->active_count) == 0 ? EB_TRUE : EB_FALSE;
+}
+
+static void svt_idle_signal_dctor(EbPtr p) {
+    EbIdleSignal *obj = (EbIdleSignal *)p;
+    EB_DESTROY_SEMAPHORE(obj->semaphore);
+}
+
+EbErrorType svt_idle_signal_ctor(EbIdleSignal *signal_ptr) {
+    signal_ptr->dctor = svt_idle_signal_dctor;
+    EB_CREATE_SEMAPHORE(signal_ptr->semaphore, 0, ~0u >> 1);
+    return EB_ErrorNone;
+}
+
+void svt_system_resource_set_idle_signal(EbSystemResource *resource_ptr,
+                                         EbIdleSignal *    signal_ptr) {
+    resource_ptr->full_queue->idle_signal = signal_ptr;
+}
+
+/*********************************************************************
+ * svt_system_resource_wait_idle
+ *   A stage may post between two checks of the resources, the check is
+ *   repeated until the post counts did not move. A resource seen busy
+ *   goes idle after waiting was raised, and then posts the semaphore;
+ *   posts left from a previous wait only cost one more check.
+ *********************************************************************/
+void svt_system_resource_wait_idle(EbSystemResource *const *resource_array,
+                                   uint32_t resource_count, EbIdleSignal *signal_ptr) {
+    svt_atomic_add_u32(&signal_ptr->waiting, 1);
+    for (;;) {
+        EbBool   idle       = EB_TRUE;
+        uint32_t post_count = 0, last_post_count = 0, count;
+        for (uint32_t i = 0; i < resource_count; i++) {
+            if (!resource_array[i])
+                continue;
+            idle = svt_system_resource_is_idle(resource_array[i], &count) && idle;
+            post_count += count;
+        }
+        for (uint32_t i = 0; i < resource_count; i++) {
+            if (!resource_array[i])
+                continue;
+            svt_system_resource_is_idle(resource_array[i], &count);
+            last_post_count += count;
+        }
+        if (idle && post_count == last_post_count)
+            break;
+        svt_block_on_semaphore(signal_ptr->semaphore);
+    }
+    svt_atomic_add_u32(&signal_ptr->waiting, (uint32_t)-1);
+}
+
+void svt_system_resource_finish_task(EbSystemResource *resource_ptr) {
+    svt_muxing_queue_finish_object(resource_ptr->full_queue);
+}
+
 /*********************************************************************
  * EbSystemResourceGetEmptyObject
  *   Dequeues an empty EbObjectWrapper from the SystemResource.  This
@@ -599,14 +1101,28 @@ EbErrorType svt_release_object(EbObjectWrapper *object_ptr) {
  *      EbObjectWrapper pointer.
  *********************************************************************/
 EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType       return_error         = EB_ErrorNone;
+    EbResourceStats * stats                = empty_fifo_ptr->queue_ptr->stats;
+    const uint64_t    wait_start           = stats ? svt_resource_stats_time() : 0;
+    EbSystemResource *elastic_resource_ptr = empty_fifo_ptr->queue_ptr->elastic_resource_ptr;
+
+    // Idle elastic resource, take back one of its empty objects
+    if (elastic_resource_ptr && elastic_resource_ptr->shrink_time)
+        svt_system_resource_shrink(elastic_resource_ptr);
 
     // Queue the Fifo requesting the empty fifo
     svt_release_process(empty_fifo_ptr);
 
+    // Construct an object rather than block, as long as the resource may grow
+    if (elastic_resource_ptr)
+        svt_system_resource_grow(elastic_resource_ptr);
+
     // Block on the counting Semaphore until an empty buffer is available
     svt_block_on_semaphore(empty_fifo_ptr->counting_semaphore);
 
+    if (stats)
+        svt_resource_stats_add_time(stats, &stats->empty_wait_time, wait_start);
+
     // Acquire lockout Mutex
     svt_block_on_mutex(empty_fifo_ptr->lockout_mutex);
 
@@ -619,12 +1135,27 @@ EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapp
     // Object release enable
     (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
 
+    (*wrapper_dbl_ptr)->owner_fifo_ptr = empty_fifo_ptr;
+
     // Release Mutex
     svt_release_mutex(empty_fifo_ptr->lockout_mutex);
 
     return return_error;
 }
 
+/**************************************
+ * svt_fifo_ring_take
+ *   Takes the next object of the ring, the caller made sure there is one
+ **************************************/
+static void svt_fifo_ring_take(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
+    EbResourceStats *stats = full_fifo_ptr->queue_ptr->stats;
+
+    svt_muxing_queue_ring_pop_front(full_fifo_ptr->queue_ptr, wrapper_dbl_ptr);
+    full_fifo_ptr->active = EB_TRUE;
+    if (stats)
+        full_fifo_ptr->dequeue_time = svt_resource_stats_dequeue(stats, *wrapper_dbl_ptr);
+}
+
 /*********************************************************************
  * EbSystemResourceGetFullObject
  *   Dequeues an full EbObjectWrapper from the SystemResource. This
@@ -641,7 +1172,24 @@ EbErrorType svt_get_empty_object(EbFifo *empty_fifo_ptr, EbObjectWrapper **wrapp
  *      EbObjectWrapper pointer.
  *********************************************************************/
 EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper_dbl_ptr) {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType      return_error = EB_ErrorNone;
+    EbResourceStats *stats        = full_fifo_ptr->queue_ptr->stats;
+
+    // The consumer is done with its previous object
+    svt_fifo_finish_object(full_fifo_ptr);
+
+    if (full_fifo_ptr->queue_ptr->ring) {
+        // Only block when the ring is empty
+        svt_block_on_semaphore(full_fifo_ptr->counting_semaphore);
+
+        if (!full_fifo_ptr->quit_signal) {
+            svt_fifo_ring_take(full_fifo_ptr, wrapper_dbl_ptr);
+        } else {
+            *wrapper_dbl_ptr = NULL;
+            return_error     = EB_NoErrorFifoShutdown;
+        }
+        return return_error;
+    }
 
     // Queue the Fifo requesting the full fifo
     svt_release_process(full_fifo_ptr);
@@ -654,6 +1202,7 @@ EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper
 
     if (!full_fifo_ptr->quit_signal) {
         svt_fifo_pop_front(full_fifo_ptr, wrapper_dbl_ptr);
+        full_fifo_ptr->active = EB_TRUE;
     } else {
         *wrapper_dbl_ptr = NULL;
         return_error     = EB_NoErrorFifoShutdown;
@@ -662,6 +1211,9 @@ EbErrorType svt_get_full_object(EbFifo *full_fifo_ptr, EbObjectWrapper **wrapper
     // Release Mutex
     svt_release_mutex(full_fifo_ptr->lockout_mutex);
 
+    if (stats && *wrapper_dbl_ptr)
+        full_fifo_ptr->dequeue_time = svt_resource_stats_dequeue(stats, *wrapper_dbl_ptr);
+
     return return_error;
 }
 
@@ -680,6 +1232,21 @@ EbErrorType svt_get_full_object_non_blocking(EbFifo *          full_fifo_ptr,
                                              EbObjectWrapper **wrapper_dbl_ptr) {
     EbErrorType return_error = EB_ErrorNone;
     EbBool      fifo_empty;
+
+    svt_fifo_finish_object(full_fifo_ptr);
+
+    if (full_fifo_ptr->queue_ptr->ring) {
+        // The objects are published in order before their counts are posted, a
+        // count means the next object of the ring is there
+        if (!full_fifo_ptr->quit_signal &&
+            svt_try_block_on_semaphore(full_fifo_ptr->counting_semaphore) &&
+            !full_fifo_ptr->quit_signal)
+            svt_fifo_ring_take(full_fifo_ptr, wrapper_dbl_ptr);
+        else
+            *wrapper_dbl_ptr = (EbObjectWrapper *)NULL;
+        return return_error;
+    }
+
     // Queue the Fifo requesting the full fifo
     svt_release_process(full_fifo_ptr);
 
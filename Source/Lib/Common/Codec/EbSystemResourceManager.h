@@ -22,6 +22,8 @@ extern "C" {
      *********************************/
 #define EB_ObjectWrapperReleasedValue ~0u
 
+typedef void (*EbObjectRelease)(EbPtr object_ptr, void *priv);
+
 /*********************************************************************
       * Object Wrapper
       *   Provides state information for each type of object in the
@@ -52,8 +54,43 @@ typedef struct EbObjectWrapper {
     // next_ptr - a pointer to a different EbObjectWrapper.  Used
     //   only in the implemenation of a single-linked Fifo.
     struct EbObjectWrapper *next_ptr;
+
+    // post_time - time in us the object was posted to the full queue.
+    //   Only set when the SystemResource collects statistics.
+    uint64_t post_time;
+
+    // owner_fifo_ptr - the producer fifo that got the object from the
+    //   empty queue, NULL once the object is released
+    struct EbFifo *owner_fifo_ptr;
 } EbObjectWrapper;
 
+/*********************************************************************
+     * ResourceStats
+     *   Optional statistics of the stage fed by a SystemResource. The
+     *   full queue time stamps every posted object and its consumers
+     *   account the time they spend between two dequeues as busy time.
+     *   All times are in microseconds.
+     *********************************************************************/
+typedef struct EbResourceStats {
+    EbDctor     dctor;
+    EbHandle    lockout_mutex;
+    const char *name;
+    // posted_count - number of objects posted to the full queue
+    uint64_t posted_count;
+    // queue_depth - objects posted and not yet taken by a consumer
+    uint32_t queue_depth;
+    uint32_t max_queue_depth;
+    // queue_depth_sum - sum of the queue depths seen by each post
+    uint64_t queue_depth_sum;
+    // queue_time - sum of the times objects waited in the full queue
+    uint64_t queue_time;
+    uint64_t max_queue_time;
+    // busy_time - sum of the times consumers spent processing objects
+    uint64_t busy_time;
+    // empty_wait_time - sum of the times producers waited for an empty object
+    uint64_t empty_wait_time;
+} EbResourceStats;
+
 /*********************************************************************
      * Fifo
      *   Defines a static (i.e. no dynamic memory allocation) single
@@ -82,6 +119,14 @@ typedef struct EbFifo {
     // quit_signal - a flag that main thread sets to break out from kernels
     EbBool quit_signal;
 
+    // dequeue_time - time the consumer got its last object, 0 when it
+    //   is not processing any. Only used to collect statistics.
+    uint64_t dequeue_time;
+
+    // active - the consumer got an object and did not ask for the next
+    //   one yet, i.e. it may still be processing it
+    EbBool active;
+
     // queue_ptr - pointer to MuxingQueue that the EbFifo is
     //   associated with.
     struct EbMuxingQueue *queue_ptr;
@@ -99,6 +144,20 @@ typedef struct EbCircularBuffer {
     uint32_t current_count;
 } EbCircularBuffer;
 
+/*********************************************************************
+     * IdleSignal
+     *   Wakes a thread waiting for a set of SystemResources to go idle,
+     *   see svt_system_resource_wait_idle.
+     *********************************************************************/
+typedef struct EbIdleSignal {
+    EbDctor dctor;
+    // semaphore - posted when an active_count drops to zero while a
+    //   thread waits
+    EbHandle semaphore;
+    // waiting - threads in svt_system_resource_wait_idle
+    volatile uint32_t waiting;
+} EbIdleSignal;
+
 /*********************************************************************
      * MuxingQueue
      *********************************************************************/
@@ -109,6 +168,41 @@ typedef struct EbMuxingQueue {
     EbCircularBuffer *process_queue;
     uint32_t          process_total_count;
     EbFifo **         process_fifo_ptr_array;
+
+    // ring - single consumer fast path. When only one process consumes
+    //   the queue, objects are pushed straight to this ring and its process
+    //   reads them back without taking lockout_mutex. The producers still
+    //   serialize on lockout_mutex, the ring is not lock free. NULL when the
+    //   queue goes through the process fifos.
+    EbObjectWrapper **ring;
+    uint32_t          ring_mask;
+    // ring_head - next slot to write, only modified by the producers
+    volatile uint32_t ring_head;
+    // ring_tail - next slot to read, only modified by the consumer
+    uint32_t ring_tail;
+
+    // task_stage_ptr - set when the consumers of the queue run on the
+    //   task scheduler. Posted objects become scheduler tasks.
+    struct EbTaskStage *task_stage_ptr;
+
+    // stats - statistics of the SystemResource, NULL when not collected
+    EbResourceStats *stats;
+
+    // active_count - objects posted to the full queue that are not
+    //   finished yet. A consumer finishes its object when it asks for the
+    //   next one, a task when it returns. Only counted with idle_signal.
+    volatile uint32_t active_count;
+    // post_count - objects posted to the full queue so far, wraps around.
+    //   Only counted with idle_signal.
+    volatile uint32_t post_count;
+    // idle_signal - posted when active_count drops to zero, NULL when no
+    //   thread waits for the queue to go idle. The posts to the queue
+    //   are not counted then.
+    EbIdleSignal *idle_signal;
+
+    // elastic_resource_ptr - set on the empty queue of an elastic
+    //   SystemResource, which constructs objects for blocked producers
+    struct EbSystemResource *elastic_resource_ptr;
 } EbMuxingQueue;
 
 /*********************************************************************
@@ -135,6 +229,38 @@ typedef struct EbSystemResource {
 
     // The full FIFO contains a queue of completed buffers
     EbMuxingQueue *full_queue;
+
+    // stats - owned statistics, NULL unless enabled by
+    //   svt_system_resource_enable_stats
+    EbResourceStats *stats;
+
+    // object_release - called with each object released by the pipeline,
+    //   before it goes back to the empty queue. NULL unless set by
+    //   svt_system_resource_set_release_callback
+    EbObjectRelease object_release;
+    void *          object_release_priv;
+
+    // Elastic SystemResource, see svt_system_resource_elastic_ctor.
+    //   object_total_count is the maximum count, the NULL entries of
+    //   wrapper_ptr_pool are not constructed. elastic_mutex protects
+    //   object_count, object_reserved_count and wrapper_ptr_pool, it is
+    //   NULL for a fixed count.
+    EbHandle  elastic_mutex;
+    uint32_t  object_count;
+    // object_reserved_count - objects being constructed, not in
+    //   wrapper_ptr_pool yet
+    uint32_t  object_reserved_count;
+    uint32_t  object_min_count;
+    EbCreator object_creator;
+    EbPtr     object_init_data_ptr;
+    EbPtr     object_init_data_copy;
+    EbDctor   object_destroyer;
+    // shrink_time - idle time in us before objects above object_min_count
+    //   are destructed, 0 to keep them
+    uint64_t shrink_time;
+    // last_wait_time - last time a producer found no empty object,
+    //   protected by the empty queue lockout_mutex
+    uint64_t last_wait_time;
 } EbSystemResource;
 
 /*********************************************************************
@@ -218,6 +344,126 @@ extern EbErrorType svt_system_resource_ctor(EbSystemResource *resource_ptr,
                                             EbCreator object_ctor, EbPtr object_init_data_ptr,
                                             EbDctor object_destroyer);
 
+/*********************************************************************
+     * svt_system_resource_elastic_ctor
+     *   Constructor of an elastic EbSystemResource. Only object_min_count
+     *   objects are constructed up front, one more is constructed each
+     *   time a producer would block on svt_get_empty_object, up to
+     *   object_max_count. Behaves like svt_system_resource_ctor when
+     *   object_min_count is not below object_max_count.
+     *
+     *   object_init_data_size
+     *     size of the data block at object_init_data_ptr, which is copied
+     *     as the objects are constructed after the ctor returns. 0 keeps
+     *     the pointer, the block must then outlive the SystemResource.
+     *
+     *   shrink_time
+     *     time in ms without any producer finding the empty queue empty,
+     *     after which the empty objects above object_min_count are
+     *     destructed by the producers, one per svt_get_empty_object call.
+     *     0 never shrinks the SystemResource.
+     *********************************************************************/
+extern EbErrorType svt_system_resource_elastic_ctor(
+    EbSystemResource *resource_ptr, uint32_t object_min_count, uint32_t object_max_count,
+    uint32_t producer_process_total_count, uint32_t consumer_process_total_count,
+    EbCreator object_ctor, EbPtr object_init_data_ptr, size_t object_init_data_size,
+    EbDctor object_destroyer, uint32_t shrink_time);
+
+/*********************************************************************
+     * svt_system_resource_reclaim
+     *   Releases every object still held through the producer fifo
+     *   empty_fifo_ptr, whatever its live_count. Used when a producer
+     *   leaves a SystemResource shared with other producers, once none
+     *   of its threads can access these objects any more. A NULL
+     *   empty_fifo_ptr releases the objects held through any producer.
+     *   The object_release callback is called for each of them.
+     *********************************************************************/
+extern void svt_system_resource_reclaim(EbSystemResource *resource_ptr, EbFifo *empty_fifo_ptr);
+
+/*********************************************************************
+     * svt_system_resource_is_idle
+     *   EB_TRUE when every object posted to the full queue is finished,
+     *   see active_count. post_count_ptr returns the objects posted so
+     *   far: a caller checking several SystemResources reads the counts
+     *   again afterwards, unchanged counts rule out a post in between.
+     *********************************************************************/
+extern EbBool svt_system_resource_is_idle(EbSystemResource *resource_ptr,
+                                          uint32_t *        post_count_ptr);
+
+/*********************************************************************
+     * svt_idle_signal_ctor
+     *********************************************************************/
+extern EbErrorType svt_idle_signal_ctor(EbIdleSignal *signal_ptr);
+
+/*********************************************************************
+     * svt_system_resource_set_idle_signal
+     *   Posts idle_signal each time the full queue of the SystemResource
+     *   goes idle while a thread waits on it, and starts counting the
+     *   posts of the queue. Must be called before the pipeline runs.
+     *********************************************************************/
+extern void svt_system_resource_set_idle_signal(EbSystemResource *resource_ptr,
+                                                EbIdleSignal *    signal_ptr);
+
+/*********************************************************************
+     * svt_system_resource_wait_idle
+     *   Blocks until no object posted to the SystemResources of
+     *   resource_array is queued or being processed. NULL entries are
+     *   skipped. The SystemResources must post signal_ptr, see
+     *   svt_system_resource_set_idle_signal.
+     *********************************************************************/
+extern void svt_system_resource_wait_idle(EbSystemResource *const *resource_array,
+                                          uint32_t resource_count, EbIdleSignal *signal_ptr);
+
+/*********************************************************************
+     * svt_system_resource_finish_task
+     *   Marks a scheduler task of the SystemResource as finished, see
+     *   active_count.
+     *********************************************************************/
+extern void svt_system_resource_finish_task(EbSystemResource *resource_ptr);
+
+/*********************************************************************
+     * svt_system_resource_enable_stats
+     *   Starts collecting the statistics of the stage fed by the
+     *   SystemResource. Must be called before the pipeline runs.
+     *
+     *   resource_ptr
+     *     pointer to SystemResource
+     *
+     *   name
+     *     name of the stage, not copied
+     */
+EbErrorType svt_system_resource_enable_stats(EbSystemResource *resource_ptr, const char *name);
+
+/*********************************************************************
+     * svt_system_resource_set_release_callback
+     *   Calls object_release, without holding the SystemResource lock,
+     *   each time the last reference to an object is released. Must be
+     *   called before the pipeline runs.
+     *
+     *   resource_ptr
+     *     pointer to SystemResource
+     *
+     *   object_release
+     *     callback receiving the object and priv
+     */
+void svt_system_resource_set_release_callback(EbSystemResource *resource_ptr,
+                                              EbObjectRelease object_release, void *priv);
+
+/*********************************************************************
+     * svt_resource_stats_start_task
+     *   Accounts an object taken by the task scheduler instead of a
+     *   consumer fifo. Returns the start time to pass to
+     *   svt_resource_stats_finish_task, 0 if statistics are off.
+     */
+uint64_t svt_resource_stats_start_task(EbSystemResource *resource_ptr,
+                                       EbObjectWrapper * wrapper_ptr);
+
+/*********************************************************************
+     * svt_resource_stats_finish_task
+     *   Adds the processing time of a scheduler task to the busy time.
+     */
+void svt_resource_stats_finish_task(EbSystemResource *resource_ptr, uint64_t start_time);
+
 /*********************************************************************
      * svt_system_resource_get_producer_fifo
      *   get producer fifo
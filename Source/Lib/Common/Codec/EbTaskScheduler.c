@@ -0,0 +1,460 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <stdlib.h>
+
+#include "EbTaskScheduler.h"
+#include "EbDefinitions.h"
+#include "EbThreads.h"
+#define LOG_TAG "SvtTaskScheduler"
+#include "EbLog.h"
+
+// Queue index + 1 of the calling thread, 0 until the thread posts its first task
+#ifdef _WIN32
+static __declspec(thread) uint32_t task_queue_home;
+#else
+static __thread uint32_t task_queue_home;
+#endif
+
+static void svt_task_queue_dctor(EbPtr p) {
+    EbTaskQueue *obj = (EbTaskQueue *)p;
+    EB_DESTROY_MUTEX(obj->lockout_mutex);
+    EB_FREE_ARRAY(obj->task_array);
+}
+
+/**************************************
+ * svt_task_queue_ctor
+ **************************************/
+static EbErrorType svt_task_queue_ctor(EbTaskQueue *queue_ptr) {
+    queue_ptr->dctor = svt_task_queue_dctor;
+
+    EB_CREATE_MUTEX(queue_ptr->lockout_mutex);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_task_queue_resize
+ *   Moves the queued tasks, oldest first, to an array with room for
+ *   task_total_count tasks. Called with the queue lock held.
+ **************************************/
+static EbErrorType svt_task_queue_resize(EbTaskQueue *queue_ptr, uint32_t task_total_count) {
+    EbTask *task_array;
+
+    EB_NO_THROW_MALLOC(task_array, sizeof(*task_array) * task_total_count);
+    if (!task_array)
+        return EB_ErrorInsufficientResources;
+    for (uint32_t task_index = 0; task_index < queue_ptr->current_count; ++task_index) {
+        uint32_t old_index = queue_ptr->head_index + task_index;
+        if (old_index >= queue_ptr->task_total_count)
+            old_index -= queue_ptr->task_total_count;
+        task_array[task_index] = queue_ptr->task_array[old_index];
+    }
+    EB_FREE_ARRAY(queue_ptr->task_array);
+    queue_ptr->task_array       = task_array;
+    queue_ptr->task_total_count = task_total_count;
+    queue_ptr->head_index       = 0;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_task_queue_reserve
+ *   Makes room for task_total_count tasks. The workers may look at the
+ *   queue meanwhile, the array is swapped under the queue lock.
+ **************************************/
+static EbErrorType svt_task_queue_reserve(EbTaskQueue *queue_ptr, uint32_t task_total_count) {
+    EbErrorType return_error = EB_ErrorNone;
+
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    if (queue_ptr->task_total_count < task_total_count)
+        return_error = svt_task_queue_resize(queue_ptr, task_total_count);
+    svt_release_mutex(queue_ptr->lockout_mutex);
+
+    return return_error;
+}
+
+/**************************************
+ * svt_task_queue_push_back
+ *   The queue is sized for every object of the channel stages when the
+ *   channel is attached, but an elastic pool or a slot reused by an
+ *   encoder with bigger pools may post more: a full queue doubles its
+ *   room, the task is not queued if it cannot.
+ **************************************/
+static EbErrorType svt_task_queue_push_back(EbTaskQueue *queue_ptr, EbTask *task_ptr) {
+    EbErrorType return_error = EB_ErrorNone;
+
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    if (queue_ptr->current_count == queue_ptr->task_total_count)
+        return_error = svt_task_queue_resize(queue_ptr,
+                                             AOMMAX(queue_ptr->task_total_count * 2, 1));
+    if (return_error == EB_ErrorNone) {
+        uint32_t tail_index = queue_ptr->head_index + queue_ptr->current_count;
+        if (tail_index >= queue_ptr->task_total_count)
+            tail_index -= queue_ptr->task_total_count;
+        queue_ptr->task_array[tail_index] = *task_ptr;
+        queue_ptr->current_count++;
+    }
+    svt_release_mutex(queue_ptr->lockout_mutex);
+
+    return return_error;
+}
+
+/**************************************
+ * svt_task_queue_pop_front
+ **************************************/
+static EbBool svt_task_queue_pop_front(EbTaskQueue *queue_ptr, EbTask *task_ptr) {
+    EbBool found = EB_FALSE;
+
+    svt_block_on_mutex(queue_ptr->lockout_mutex);
+    if (queue_ptr->current_count) {
+        *task_ptr             = queue_ptr->task_array[queue_ptr->head_index];
+        queue_ptr->head_index = (queue_ptr->head_index == queue_ptr->task_total_count - 1)
+            ? 0
+            : queue_ptr->head_index + 1;
+        queue_ptr->current_count--;
+        found = EB_TRUE;
+    }
+    svt_release_mutex(queue_ptr->lockout_mutex);
+
+    return found;
+}
+
+static void svt_task_scheduler_dctor(EbPtr p) {
+    EbTaskScheduler *obj = (EbTaskScheduler *)p;
+    if (obj->slot_array) {
+        for (uint32_t slot_index = 0; slot_index < obj->channel_total_count; ++slot_index)
+            EB_DELETE_PTR_ARRAY(obj->slot_array[slot_index].queue_ptr_array, obj->worker_count);
+    }
+    EB_FREE_ARRAY(obj->slot_array);
+    EB_FREE_ARRAY(obj->channel_ptr_array);
+    EB_FREE_ARRAY(obj->worker_ptr_array);
+    EB_FREE_ARRAY(obj->worker_array);
+    EB_DESTROY_SEMAPHORE(obj->task_semaphore);
+    EB_DESTROY_SEMAPHORE(obj->stall_semaphore);
+    EB_DESTROY_MUTEX(obj->stall_mutex);
+    EB_DESTROY_MUTEX(obj->queue_mutex);
+    EB_DESTROY_MUTEX(obj->channel_mutex);
+}
+
+/**************************************
+ * svt_task_scheduler_ctor
+ **************************************/
+EbErrorType svt_task_scheduler_ctor(EbTaskScheduler *scheduler_ptr, uint32_t worker_count,
+                                    uint32_t channel_total_count) {
+    scheduler_ptr->dctor               = svt_task_scheduler_dctor;
+    scheduler_ptr->worker_count        = worker_count;
+    scheduler_ptr->channel_total_count = channel_total_count;
+    scheduler_ptr->channel_worker_cap  = worker_count;
+
+    // Channels come and go, the semaphore count is only bounded by the queues
+    EB_CREATE_SEMAPHORE(scheduler_ptr->task_semaphore, 0, INT32_MAX);
+    EB_CREATE_SEMAPHORE(scheduler_ptr->stall_semaphore, 0, INT32_MAX);
+    EB_CREATE_MUTEX(scheduler_ptr->stall_mutex);
+    EB_CREATE_MUTEX(scheduler_ptr->queue_mutex);
+    EB_CREATE_MUTEX(scheduler_ptr->channel_mutex);
+    EB_CALLOC_ARRAY(scheduler_ptr->channel_ptr_array, channel_total_count);
+    EB_CALLOC_ARRAY(scheduler_ptr->slot_array, channel_total_count);
+
+    EB_MALLOC_ARRAY(scheduler_ptr->worker_array, worker_count);
+    EB_ALLOC_PTR_ARRAY(scheduler_ptr->worker_ptr_array, worker_count);
+    for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index) {
+        scheduler_ptr->worker_array[worker_index].scheduler_ptr   = scheduler_ptr;
+        scheduler_ptr->worker_array[worker_index].index           = worker_index;
+        scheduler_ptr->worker_array[worker_index].next_slot_index = 0;
+        scheduler_ptr->worker_ptr_array[worker_index] = &scheduler_ptr->worker_array[worker_index];
+    }
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_task_scheduler_wake_stalled
+ *   Lets one stalled worker, or all of them, search again.
+ **************************************/
+static void svt_task_scheduler_wake_stalled(EbTaskScheduler *scheduler_ptr, EbBool all) {
+    svt_block_on_mutex(scheduler_ptr->stall_mutex);
+    uint32_t wake_count = all ? scheduler_ptr->stalled_count
+                              : AOMMIN(scheduler_ptr->stalled_count, 1);
+    svt_atomic_store_u32(&scheduler_ptr->stalled_count, scheduler_ptr->stalled_count - wake_count);
+    while (wake_count--) svt_post_semaphore(scheduler_ptr->stall_semaphore);
+    svt_release_mutex(scheduler_ptr->stall_mutex);
+}
+
+/**************************************
+ * svt_task_scheduler_share_workers
+ *   Splits the workers between the attached channels, called with
+ *   channel_mutex held on attach and detach.
+ **************************************/
+static void svt_task_scheduler_share_workers(EbTaskScheduler *scheduler_ptr) {
+    uint32_t attached_count = 0;
+    for (uint32_t slot_index = 0; slot_index < scheduler_ptr->channel_total_count; ++slot_index)
+        attached_count += svt_atomic_load_u32(&scheduler_ptr->slot_array[slot_index].attached);
+    svt_atomic_store_u32(&scheduler_ptr->channel_worker_cap,
+                         AOMMAX(scheduler_ptr->worker_count / AOMMAX(attached_count, 1), 1));
+    // A detach raises the cap of the remaining channels
+    svt_task_scheduler_wake_stalled(scheduler_ptr, EB_TRUE);
+}
+
+static void svt_task_channel_dctor(EbPtr p) {
+    EbTaskChannel *  obj           = (EbTaskChannel *)p;
+    EbTaskScheduler *scheduler_ptr = obj->scheduler_ptr;
+
+    if (obj->pending_mutex && obj->idle_semaphore) {
+        // The workers of a running scheduler may still process tasks of the channel
+        svt_block_on_mutex(obj->pending_mutex);
+        const EbBool wait = obj->pending_count && !scheduler_ptr->quit_signal;
+        obj->detaching    = EB_TRUE;
+        svt_release_mutex(obj->pending_mutex);
+        if (wait) {
+            svt_block_on_semaphore(obj->idle_semaphore);
+            // The last worker posts the semaphore before it lets the mutex go
+            svt_block_on_mutex(obj->pending_mutex);
+            svt_release_mutex(obj->pending_mutex);
+        }
+    }
+
+    // The queues stay with the slot, a worker may still be searching them
+    if (obj->index < scheduler_ptr->channel_total_count &&
+        scheduler_ptr->channel_ptr_array[obj->index] == obj) {
+        svt_block_on_mutex(scheduler_ptr->channel_mutex);
+        scheduler_ptr->channel_ptr_array[obj->index] = NULL;
+        svt_atomic_store_u32(&scheduler_ptr->slot_array[obj->index].attached, 0);
+        svt_task_scheduler_share_workers(scheduler_ptr);
+        svt_release_mutex(scheduler_ptr->channel_mutex);
+    }
+
+    EB_FREE_ARRAY(obj->stage_array);
+    EB_DESTROY_SEMAPHORE(obj->idle_semaphore);
+    EB_DESTROY_MUTEX(obj->pending_mutex);
+}
+
+/**************************************
+ * svt_task_channel_ctor
+ **************************************/
+EbErrorType svt_task_channel_ctor(EbTaskChannel *channel_ptr, EbTaskScheduler *scheduler_ptr,
+                                  uint32_t                   channel_index,
+                                  const EbTaskStageInitData *stage_init_array,
+                                  uint32_t                   stage_count) {
+    const uint32_t worker_count     = scheduler_ptr->worker_count;
+    uint32_t       task_total_count = 0;
+
+    channel_ptr->dctor         = svt_task_channel_dctor;
+    channel_ptr->scheduler_ptr = scheduler_ptr;
+    channel_ptr->index         = channel_index;
+    channel_ptr->stage_count   = stage_count;
+
+    // Every object of the stages may be waiting in the same queue
+    EB_MALLOC_ARRAY(channel_ptr->stage_array, stage_count);
+    for (uint32_t stage_index = 0; stage_index < stage_count; ++stage_index) {
+        const EbTaskStageInitData *init_ptr  = &stage_init_array[stage_index];
+        EbTaskStage *              stage_ptr = &channel_ptr->stage_array[stage_index];
+        stage_ptr->channel_ptr               = channel_ptr;
+        stage_ptr->process                   = init_ptr->process;
+        stage_ptr->context_ptr_array         = init_ptr->context_ptr_array;
+        task_total_count += init_ptr->resource_ptr->object_total_count;
+    }
+
+    EB_CREATE_MUTEX(channel_ptr->pending_mutex);
+    EB_CREATE_SEMAPHORE(channel_ptr->idle_semaphore, 0, 1);
+
+    svt_block_on_mutex(scheduler_ptr->channel_mutex);
+    const EbBool taken = channel_index >= scheduler_ptr->channel_total_count ||
+        scheduler_ptr->channel_ptr_array[channel_index];
+    if (!taken)
+        scheduler_ptr->channel_ptr_array[channel_index] = channel_ptr;
+    svt_release_mutex(scheduler_ptr->channel_mutex);
+    if (taken)
+        return EB_ErrorBadParameter;
+
+    // The slot is ours, the workers skip its queues until it is attached
+    EbTaskSlot *slot_ptr = &scheduler_ptr->slot_array[channel_index];
+    if (!slot_ptr->queue_ptr_array) {
+        EB_ALLOC_PTR_ARRAY(slot_ptr->queue_ptr_array, worker_count);
+        for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+            EB_NEW(slot_ptr->queue_ptr_array[worker_index], svt_task_queue_ctor);
+    }
+    for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index) {
+        EbErrorType return_error = svt_task_queue_reserve(slot_ptr->queue_ptr_array[worker_index],
+                                                          task_total_count);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+    channel_ptr->queue_ptr_array = slot_ptr->queue_ptr_array;
+
+    svt_block_on_mutex(scheduler_ptr->channel_mutex);
+    svt_atomic_store_u32(&slot_ptr->attached, 1);
+    svt_task_scheduler_share_workers(scheduler_ptr);
+    svt_release_mutex(scheduler_ptr->channel_mutex);
+
+    for (uint32_t stage_index = 0; stage_index < stage_count; ++stage_index)
+        stage_init_array[stage_index].resource_ptr->full_queue->task_stage_ptr =
+            &channel_ptr->stage_array[stage_index];
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_task_scheduler_post
+ **************************************/
+EbErrorType svt_task_scheduler_post(EbTaskStage *stage_ptr, EbObjectWrapper *wrapper_ptr) {
+    EbTaskChannel *  channel_ptr   = stage_ptr->channel_ptr;
+    EbTaskScheduler *scheduler_ptr = channel_ptr->scheduler_ptr;
+    EbTask           task;
+
+    // Threads outside of the pool are spread over the queues once, on their first post
+    if (task_queue_home == 0) {
+        svt_block_on_mutex(scheduler_ptr->queue_mutex);
+        task_queue_home = ++scheduler_ptr->next_queue_index;
+        svt_release_mutex(scheduler_ptr->queue_mutex);
+    }
+
+    svt_block_on_mutex(channel_ptr->pending_mutex);
+    channel_ptr->pending_count++;
+    svt_release_mutex(channel_ptr->pending_mutex);
+
+    task.stage_ptr   = stage_ptr;
+    task.wrapper_ptr = wrapper_ptr;
+    EbErrorType return_error = svt_task_queue_push_back(
+        channel_ptr->queue_ptr_array[(task_queue_home - 1) % scheduler_ptr->worker_count],
+        &task);
+    if (return_error != EB_ErrorNone) {
+        SVT_ERROR("no memory to grow the task queue, the task is dropped\n");
+        svt_block_on_mutex(channel_ptr->pending_mutex);
+        if (--channel_ptr->pending_count == 0 && channel_ptr->detaching)
+            svt_post_semaphore(channel_ptr->idle_semaphore);
+        svt_release_mutex(channel_ptr->pending_mutex);
+        return return_error;
+    }
+
+    svt_post_semaphore(scheduler_ptr->task_semaphore);
+
+    // The idle workers may all be stalled on the channels at their cap. A worker
+    // registers as stalled before it searches the queues, if it searched this queue
+    // before the push the queue lock makes the count visible here.
+    if (svt_atomic_load_u32(&scheduler_ptr->stalled_count))
+        svt_task_scheduler_wake_stalled(scheduler_ptr, EB_FALSE);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * svt_task_scheduler_shutdown
+ *   Wakes up the workers and lets them quit.
+ **************************************/
+void svt_task_scheduler_shutdown(EbTaskScheduler *scheduler_ptr) {
+    if (!scheduler_ptr)
+        return;
+    scheduler_ptr->quit_signal = EB_TRUE;
+    for (uint32_t worker_index = 0; worker_index < scheduler_ptr->worker_count; ++worker_index) {
+        svt_post_semaphore(scheduler_ptr->task_semaphore);
+        svt_post_semaphore(scheduler_ptr->stall_semaphore);
+    }
+}
+
+/**************************************
+ * svt_task_scheduler_take
+ *   Takes the oldest task of the worker queue, else steals one from
+ *   the other queues of the slot. Only the queue locks are taken. The
+ *   channels take turns, the search starts with the slot after the one
+ *   the worker served last and skips the channels holding their share
+ *   of the workers.
+ **************************************/
+static EbBool svt_task_scheduler_take(EbTaskScheduler *scheduler_ptr, EbTaskWorker *worker_ptr,
+                                      EbTask *task_ptr) {
+    const uint32_t worker_count = scheduler_ptr->worker_count;
+    const uint32_t slot_count   = scheduler_ptr->channel_total_count;
+    const uint32_t worker_cap   = svt_atomic_load_u32(&scheduler_ptr->channel_worker_cap);
+    uint32_t       slot_index   = worker_ptr->next_slot_index;
+
+    for (uint32_t slot_pass = 0; slot_pass < slot_count; ++slot_pass) {
+        EbTaskSlot *slot_ptr = &scheduler_ptr->slot_array[slot_index];
+        slot_index           = (slot_index + 1 == slot_count) ? 0 : slot_index + 1;
+        if (!svt_atomic_load_u32(&slot_ptr->attached) ||
+            svt_atomic_load_u32(&slot_ptr->running_count) >= worker_cap)
+            continue;
+        uint32_t queue_index = worker_ptr->index;
+        do {
+            if (svt_task_queue_pop_front(slot_ptr->queue_ptr_array[queue_index], task_ptr)) {
+                svt_atomic_add_u32(&slot_ptr->running_count, 1);
+                worker_ptr->next_slot_index = slot_index;
+                return EB_TRUE;
+            }
+            queue_index = (queue_index + 1 == worker_count) ? 0 : queue_index + 1;
+        } while (queue_index != worker_ptr->index);
+    }
+    return EB_FALSE;
+}
+
+/******************************************************
+ * Task Worker Kernel
+ *   Each semaphore count matches one queued task. The worker
+ *   takes it from its own queue first, then steals the oldest
+ *   task of the next non empty queue. When every waiting task
+ *   belongs to a channel at its cap, the worker keeps the count
+ *   and stalls until a task finishes or a new one is posted.
+ ******************************************************/
+void *svt_task_worker_kernel(void *input_ptr) {
+    EbTaskWorker *   worker_ptr    = (EbTaskWorker *)input_ptr;
+    EbTaskScheduler *scheduler_ptr = worker_ptr->scheduler_ptr;
+    EbTask           task;
+
+    task_queue_home = worker_ptr->index + 1;
+
+    for (;;) {
+        svt_block_on_semaphore(scheduler_ptr->task_semaphore);
+        if (scheduler_ptr->quit_signal)
+            break;
+
+        EbBool found = svt_task_scheduler_take(scheduler_ptr, worker_ptr, &task);
+        while (!found && !scheduler_ptr->quit_signal) {
+            // Registered before the search, see svt_task_scheduler_post
+            svt_block_on_mutex(scheduler_ptr->stall_mutex);
+            svt_atomic_add_u32(&scheduler_ptr->stalled_count, 1);
+            found = svt_task_scheduler_take(scheduler_ptr, worker_ptr, &task);
+            if (found)
+                svt_atomic_add_u32(&scheduler_ptr->stalled_count, (uint32_t)-1);
+            svt_release_mutex(scheduler_ptr->stall_mutex);
+            if (!found)
+                svt_block_on_semaphore(scheduler_ptr->stall_semaphore);
+        }
+        if (!found)
+            break;
+
+        // The task may release its object, keep the resource for the statistics
+        EbSystemResource *resource_ptr = task.wrapper_ptr->system_resource_ptr;
+        EbTaskChannel *   channel_ptr  = task.stage_ptr->channel_ptr;
+        EbTaskSlot *      slot_ptr     = &scheduler_ptr->slot_array[channel_ptr->index];
+        const uint64_t    start_time   = svt_resource_stats_start_task(resource_ptr,
+                                                                     task.wrapper_ptr);
+
+        task.stage_ptr->process(task.stage_ptr->context_ptr_array[worker_ptr->index],
+                                task.wrapper_ptr);
+
+        svt_resource_stats_finish_task(resource_ptr, start_time);
+        svt_system_resource_finish_task(resource_ptr);
+
+        // A worker that found the channel at its cap read running_count before this
+        // decrement, so the count was at the cap, and it registered as stalled under
+        // stall_mutex before reading it
+        const uint32_t worker_cap = svt_atomic_load_u32(&scheduler_ptr->channel_worker_cap);
+        if (svt_atomic_add_u32(&slot_ptr->running_count, (uint32_t)-1) + 1 >= worker_cap &&
+            worker_cap < scheduler_ptr->worker_count)
+            svt_task_scheduler_wake_stalled(scheduler_ptr, EB_FALSE);
+
+        svt_block_on_mutex(channel_ptr->pending_mutex);
+        if (--channel_ptr->pending_count == 0 && channel_ptr->detaching)
+            svt_post_semaphore(channel_ptr->idle_semaphore);
+        svt_release_mutex(channel_ptr->pending_mutex);
+    }
+
+    return NULL;
+}
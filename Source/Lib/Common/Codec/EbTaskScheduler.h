@@ -0,0 +1,197 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbTaskScheduler_h
+#define EbTaskScheduler_h
+
+#include "EbSystemResourceManager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+     * Task Process
+     *   Processes one full object of a stage. context_ptr is the stage
+     *   context owned by the calling worker, so a stage context is never
+     *   used by two workers at the same time.
+     *********************************************************************/
+typedef void (*EbTaskProcess)(EbPtr context_ptr, EbObjectWrapper *wrapper_ptr);
+
+/*********************************************************************
+     * Task Stage Init Data
+     *   resource_ptr - the stage input. Its full objects are turned into
+     *   tasks instead of being queued to the stage processes.
+     *   context_ptr_array - one context per worker.
+     *********************************************************************/
+typedef struct EbTaskStageInitData {
+    EbSystemResource *resource_ptr;
+    EbTaskProcess     process;
+    EbPtr *           context_ptr_array;
+} EbTaskStageInitData;
+
+typedef struct EbTaskStage {
+    struct EbTaskChannel *channel_ptr;
+    EbTaskProcess         process;
+    EbPtr *               context_ptr_array;
+} EbTaskStage;
+
+typedef struct EbTask {
+    EbTaskStage *    stage_ptr;
+    EbObjectWrapper *wrapper_ptr;
+} EbTask;
+
+/*********************************************************************
+     * Task Queue
+     *   Per worker fifo of tasks with its own lock, not a lock free
+     *   deque: a post takes the channel pending lock, the queue lock and
+     *   the task semaphore. The owner and the thieves both take the
+     *   oldest task. Stealing does not keep the posting order across
+     *   queues, so a scheduled stage must not wait on another task of
+     *   its own stage: the stages with SB row waits (DLF, restoration,
+     *   TPL) stay on their own thread pools.
+     *********************************************************************/
+typedef struct EbTaskQueue {
+    EbDctor  dctor;
+    EbHandle lockout_mutex;
+    EbTask * task_array;
+    uint32_t task_total_count;
+    uint32_t head_index;
+    uint32_t current_count;
+} EbTaskQueue;
+
+/*********************************************************************
+     * Task Channel
+     *   The stages of one encoder on a scheduler, posted to the task
+     *   queues of its slot. Several channels may share the workers of a
+     *   scheduler, the workers then serve the channels in turn.
+     *********************************************************************/
+typedef struct EbTaskChannel {
+    EbDctor                 dctor;
+    struct EbTaskScheduler *scheduler_ptr;
+    uint32_t                index;
+    EbTaskStage *           stage_array;
+    uint32_t                stage_count;
+    // queue_ptr_array - the queues of the channel slot, owned by the scheduler
+    EbTaskQueue **queue_ptr_array;
+    // pending_mutex - protects pending_count and detaching
+    EbHandle pending_mutex;
+    // pending_count - tasks posted and not finished yet
+    uint32_t pending_count;
+    EbBool   detaching;
+    // idle_semaphore - posted when the last pending task of a detaching
+    //   channel finishes
+    EbHandle idle_semaphore;
+} EbTaskChannel;
+
+typedef struct EbTaskWorker {
+    struct EbTaskScheduler *scheduler_ptr;
+    uint32_t                index;
+    // next_slot_index - where the worker starts its next search
+    uint32_t next_slot_index;
+} EbTaskWorker;
+
+/*********************************************************************
+     * Task Slot
+     *   The queues of one channel slot. They live as long as the
+     *   scheduler, so a worker never looks at a channel while it
+     *   searches for a task and only takes the queue locks.
+     *********************************************************************/
+typedef struct EbTaskSlot {
+    // queue_ptr_array - one queue per worker, created on the first attach
+    EbTaskQueue **queue_ptr_array;
+    // attached - set once the queues are ready for the channel of the slot
+    volatile uint32_t attached;
+    // running_count - tasks of the slot being processed by the workers
+    volatile uint32_t running_count;
+} EbTaskSlot;
+
+/*********************************************************************
+     * Task Scheduler
+     *   Runs the objects posted to the stages of its channels on one
+     *   pool of worker threads. Only the stages hooked by a channel run
+     *   on the workers, in the encoder motion estimation, EncDec, CDEF,
+     *   entropy coding and the quality metrics; the other stages keep
+     *   their own threads. Each worker owns a locked task queue in every
+     *   channel slot; a thread posts to its own queue and an idle worker
+     *   steals from the other queues, so the workers follow whichever
+     *   stage has work. A channel holds at most channel_worker_cap
+     *   workers, so the tasks of a stalled channel (e.g. waiting on an
+     *   output buffer the application does not release) cannot take
+     *   the workers of the other channels.
+     *********************************************************************/
+typedef struct EbTaskScheduler {
+    EbDctor        dctor;
+    uint32_t       worker_count;
+    EbTaskWorker * worker_array;
+    EbPtr *        worker_ptr_array;
+    // channel_mutex - protects channel_ptr_array, only taken on attach and detach
+    EbHandle        channel_mutex;
+    EbTaskChannel **channel_ptr_array;
+    uint32_t        channel_total_count;
+    EbTaskSlot *    slot_array;
+    // channel_worker_cap - worker_count shared by the attached channels
+    volatile uint32_t channel_worker_cap;
+    // task_semaphore - counts the tasks waiting in the queues
+    EbHandle task_semaphore;
+    // stall_mutex - protects stalled_count
+    //   stalled_count - workers holding a task count while every waiting
+    //   task belongs to a channel at its cap, they block on stall_semaphore
+    EbHandle          stall_mutex;
+    volatile uint32_t stalled_count;
+    EbHandle          stall_semaphore;
+    // queue_mutex - protects next_queue_index
+    EbHandle        queue_mutex;
+    uint32_t        next_queue_index;
+    volatile EbBool quit_signal;
+} EbTaskScheduler;
+
+/*********************************************************************
+     * svt_task_scheduler_ctor
+     *   Constructs a scheduler with room for channel_total_count
+     *   channels. The worker threads are created by the caller with
+     *   svt_task_worker_kernel and worker_ptr_array.
+     *********************************************************************/
+extern EbErrorType svt_task_scheduler_ctor(EbTaskScheduler *scheduler_ptr, uint32_t worker_count,
+                                           uint32_t channel_total_count);
+
+/*********************************************************************
+     * svt_task_channel_ctor
+     *   Hooks the full queue of every stage resource to the scheduler,
+     *   in the channel slot channel_index. The stages need one context
+     *   per worker of the scheduler. The dctor waits for the pending
+     *   tasks of the channel, unless the scheduler is shut down.
+     *********************************************************************/
+extern EbErrorType svt_task_channel_ctor(EbTaskChannel *channel_ptr,
+                                         EbTaskScheduler *scheduler_ptr, uint32_t channel_index,
+                                         const EbTaskStageInitData *stage_init_array,
+                                         uint32_t                   stage_count);
+
+extern void *svt_task_worker_kernel(void *input_ptr);
+
+/*********************************************************************
+     * svt_task_scheduler_post
+     *   Queues a full object of a scheduled stage as a task. Returns
+     *   EB_ErrorInsufficientResources, with the object left unqueued, if
+     *   a full task queue cannot grow.
+     *********************************************************************/
+extern EbErrorType svt_task_scheduler_post(EbTaskStage *stage_ptr, EbObjectWrapper *wrapper_ptr);
+
+/*********************************************************************
+     * svt_task_scheduler_shutdown
+     *   Wakes up the workers and lets them quit.
+     *********************************************************************/
+extern void svt_task_scheduler_shutdown(EbTaskScheduler *scheduler_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbTaskScheduler_h
@@ -257,6 +257,23 @@ EbErrorType svt_block_on_semaphore(EbHandle semaphore_handle) {
     return return_error;
 }
 
+/***************************************
+ * svt_try_block_on_semaphore
+ ***************************************/
+EbBool svt_try_block_on_semaphore(EbHandle semaphore_handle) {
+#ifdef _WIN32
+    return WaitForSingleObject((HANDLE)semaphore_handle, 0) == WAIT_OBJECT_0 ? EB_TRUE : EB_FALSE;
+#elif defined(__APPLE__)
+    return dispatch_semaphore_wait((dispatch_semaphore_t)semaphore_handle, DISPATCH_TIME_NOW)
+        ? EB_FALSE
+        : EB_TRUE;
+#else
+    int ret;
+    do { ret = sem_trywait((sem_t *)semaphore_handle); } while (ret == -1 && errno == EINTR);
+    return ret ? EB_FALSE : EB_TRUE;
+#endif
+}
+
 /***************************************
  * svt_destroy_semaphore
  ***************************************/
@@ -45,6 +45,9 @@ extern EbErrorType svt_post_semaphore(EbHandle semaphore_handle);
 
 extern EbErrorType svt_block_on_semaphore(EbHandle semaphore_handle);
 
+// Takes a count of the semaphore if there is one, without blocking
+extern EbBool svt_try_block_on_semaphore(EbHandle semaphore_handle);
+
 extern EbErrorType svt_destroy_semaphore(EbHandle semaphore_handle);
 
 /**************************************
@@ -120,6 +123,43 @@ extern uint64_t *        total_lib_memory; // library Memory malloc'd
     } while (0)
 
 void atomic_set_u32(AtomicVarU32 *var, uint32_t in);
+
+/**************************************
+     * Lock-free helpers
+     *   load with acquire and store with release semantics, used to
+     *   publish data between threads without a mutex
+     **************************************/
+#ifdef _WIN32
+static INLINE uint32_t svt_atomic_load_u32(volatile uint32_t *ptr) {
+    return (uint32_t)InterlockedCompareExchange((volatile LONG *)ptr, 0, 0);
+}
+static INLINE void svt_atomic_store_u32(volatile uint32_t *ptr, uint32_t value) {
+    InterlockedExchange((volatile LONG *)ptr, (LONG)value);
+}
+// Returns the new value
+static INLINE uint32_t svt_atomic_add_u32(volatile uint32_t *ptr, uint32_t value) {
+    return (uint32_t)InterlockedExchangeAdd((volatile LONG *)ptr, (LONG)value) + value;
+}
+// Returns the new value
+static INLINE int64_t svt_atomic_add_i64(volatile int64_t *ptr, int64_t value) {
+    return InterlockedExchangeAdd64((volatile LONG64 *)ptr, value) + value;
+}
+#else
+static INLINE uint32_t svt_atomic_load_u32(volatile uint32_t *ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+static INLINE void svt_atomic_store_u32(volatile uint32_t *ptr, uint32_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+// Returns the new value
+static INLINE uint32_t svt_atomic_add_u32(volatile uint32_t *ptr, uint32_t value) {
+    return __atomic_add_fetch(ptr, value, __ATOMIC_ACQ_REL);
+}
+// Returns the new value
+static INLINE int64_t svt_atomic_add_i64(volatile int64_t *ptr, int64_t value) {
+    return __atomic_add_fetch(ptr, value, __ATOMIC_ACQ_REL);
+}
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -514,6 +514,10 @@ void setup_common_rtcd_internal(CPU_FLAGS flags) {
 #endif
 
     SET_AVX2(svt_copy_rect8_8bit_to_16bit, svt_copy_rect8_8bit_to_16bit_c, svt_copy_rect8_8bit_to_16bit_avx2);
+    SET_AVX2(svt_av1_add_luma_grain, svt_av1_add_luma_grain_c, svt_av1_add_luma_grain_avx2);
+    SET_AVX2(svt_av1_add_luma_grain_hbd, svt_av1_add_luma_grain_hbd_c, svt_av1_add_luma_grain_hbd_avx2);
+    SET_AVX2(svt_av1_add_chroma_grain, svt_av1_add_chroma_grain_c, svt_av1_add_chroma_grain_avx2);
+    SET_AVX2(svt_av1_add_chroma_grain_hbd, svt_av1_add_chroma_grain_hbd_c, svt_av1_add_chroma_grain_hbd_avx2);
     SET_AVX2(svt_av1_highbd_warp_affine, svt_av1_highbd_warp_affine_c, svt_av1_highbd_warp_affine_avx2);
     SET_AVX2(svt_av1_warp_affine, svt_av1_warp_affine_c, svt_av1_warp_affine_avx2);
 
@@ -185,11 +185,8 @@ static const int32_t gaussian_sequence[2048] = {
 
 static const int32_t gauss_bits = 11;
 
-static int32_t luma_subblock_size_y = 32;
-static int32_t luma_subblock_size_x = 32;
-
-static int32_t chroma_subblock_size_y = 16;
-static int32_t chroma_subblock_size_x = 16;
+static const int32_t luma_subblock_size_y = 32;
+static const int32_t luma_subblock_size_x = 32;
 
 static const int32_t min_luma_legal_range = 16;
 static const int32_t max_luma_legal_range = 235;
@@ -197,16 +194,6 @@ static const int32_t max_luma_legal_range = 235;
 static const int32_t min_chroma_legal_range = 16;
 static const int32_t max_chroma_legal_range = 240;
 
-static int32_t scaling_lut_y[256];
-static int32_t scaling_lut_cb[256];
-static int32_t scaling_lut_cr[256];
-
-static int32_t grain_center;
-static int32_t grain_min;
-static int32_t grain_max;
-
-static uint16_t random_register = 0; // random number generator register
-
 //----------------------------------------------------------------------
 // todo: aomlib memory functions (to be replaced by Eb functions)
 /*
@@ -270,18 +257,8 @@ void svt_aom_free(void *memblk) {
 */
 //--------------------------------------------------------------------
 
-static void init_arrays(AomFilmGrain *params, int32_t luma_stride, int32_t chroma_stride,
-                        int32_t ***pred_pos_luma_p, int32_t ***pred_pos_chroma_p,
-                        int32_t **luma_grain_block, int32_t **cb_grain_block,
-                        int32_t **cr_grain_block, int32_t **y_line_buf, int32_t **cb_line_buf,
-                        int32_t **cr_line_buf, int32_t **y_col_buf, int32_t **cb_col_buf,
-                        int32_t **cr_col_buf, int32_t luma_grain_samples,
-                        int32_t chroma_grain_samples, int32_t chroma_subsamp_y,
-                        int32_t chroma_subsamp_x) {
-    memset(scaling_lut_y, 0, sizeof(*scaling_lut_y) * 256);
-    memset(scaling_lut_cb, 0, sizeof(*scaling_lut_cb) * 256);
-    memset(scaling_lut_cr, 0, sizeof(*scaling_lut_cr) * 256);
-
+static void init_pred_pos(AomFilmGrain *params, int32_t ***pred_pos_luma_p,
+                          int32_t ***pred_pos_chroma_p) {
     int32_t num_pos_luma   = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
     int32_t num_pos_chroma = num_pos_luma;
     if (params->num_y_points > 0)
@@ -339,94 +316,105 @@ static void init_arrays(AomFilmGrain *params, int32_t luma_stride, int32_t chrom
 
     *pred_pos_luma_p   = pred_pos_luma;
     *pred_pos_chroma_p = pred_pos_chroma;
-
-    *y_line_buf  = (int32_t *)malloc(sizeof(**y_line_buf) * luma_stride * 2);
-    *cb_line_buf = (int32_t *)malloc(sizeof(**cb_line_buf) * chroma_stride *
-                                     (2 >> chroma_subsamp_y));
-    *cr_line_buf = (int32_t *)malloc(sizeof(**cr_line_buf) * chroma_stride *
-                                     (2 >> chroma_subsamp_y));
-
-    *y_col_buf  = (int32_t *)malloc(sizeof(**y_col_buf) * (luma_subblock_size_y + 2) * 2);
-    *cb_col_buf = (int32_t *)malloc(sizeof(**cb_col_buf) *
-                                    (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                                    (2 >> chroma_subsamp_x));
-    *cr_col_buf = (int32_t *)malloc(sizeof(**cr_col_buf) *
-                                    (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                                    (2 >> chroma_subsamp_x));
-
-    *luma_grain_block = (int32_t *)malloc(sizeof(**luma_grain_block) * luma_grain_samples);
-    *cb_grain_block   = (int32_t *)malloc(sizeof(**cb_grain_block) * chroma_grain_samples);
-    *cr_grain_block   = (int32_t *)malloc(sizeof(**cr_grain_block) * chroma_grain_samples);
 }
 
-static void dealloc_arrays(AomFilmGrain *params, int32_t ***pred_pos_luma,
-                           int32_t ***pred_pos_chroma, int32_t **luma_grain_block,
-                           int32_t **cb_grain_block, int32_t **cr_grain_block, int32_t **y_line_buf,
-                           int32_t **cb_line_buf, int32_t **cr_line_buf, int32_t **y_col_buf,
-                           int32_t **cb_col_buf, int32_t **cr_col_buf) {
+static void dealloc_pred_pos(AomFilmGrain *params, int32_t **pred_pos_luma,
+                             int32_t **pred_pos_chroma) {
     int32_t num_pos_luma   = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
     int32_t num_pos_chroma = num_pos_luma;
     if (params->num_y_points > 0)
         ++num_pos_chroma;
 
-    for (int32_t row = 0; row < num_pos_luma; row++) free((*pred_pos_luma)[row]);
-    free(*pred_pos_luma);
-
-    for (int32_t row = 0; row < num_pos_chroma; row++) free((*pred_pos_chroma)[row]);
-    free((*pred_pos_chroma));
+    for (int32_t row = 0; row < num_pos_luma; row++) free(pred_pos_luma[row]);
+    free(pred_pos_luma);
 
-    free(*y_line_buf);
-
-    free(*cb_line_buf);
-
-    free(*cr_line_buf);
-
-    free(*y_col_buf);
-
-    free(*cb_col_buf);
+    for (int32_t row = 0; row < num_pos_chroma; row++) free(pred_pos_chroma[row]);
+    free(pred_pos_chroma);
+}
 
-    free(*cr_col_buf);
+// Grain of the bottom rows and right columns of the last blocks, kept for the
+// overlap with the blocks below and to the right. Owned by a single thread.
+typedef struct FilmGrainLineBufs {
+    int32_t *y_line_buf;
+    int32_t *cb_line_buf;
+    int32_t *cr_line_buf;
 
-    free(*luma_grain_block);
+    int32_t *y_col_buf;
+    int32_t *cb_col_buf;
+    int32_t *cr_col_buf;
+} FilmGrainLineBufs;
+
+static void init_line_bufs(const FilmGrainFrame *fg, FilmGrainLineBufs *bufs) {
+    int32_t chroma_subsamp_y       = fg->chroma_subsamp_y;
+    int32_t chroma_subsamp_x       = fg->chroma_subsamp_x;
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+
+    bufs->y_line_buf  = (int32_t *)malloc(sizeof(*bufs->y_line_buf) * fg->luma_stride * 2);
+    bufs->cb_line_buf = (int32_t *)malloc(sizeof(*bufs->cb_line_buf) * fg->chroma_stride *
+                                          (2 >> chroma_subsamp_y));
+    bufs->cr_line_buf = (int32_t *)malloc(sizeof(*bufs->cr_line_buf) * fg->chroma_stride *
+                                          (2 >> chroma_subsamp_y));
+
+    bufs->y_col_buf  = (int32_t *)malloc(sizeof(*bufs->y_col_buf) * (luma_subblock_size_y + 2) *
+                                        2);
+    bufs->cb_col_buf = (int32_t *)malloc(sizeof(*bufs->cb_col_buf) *
+                                         (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                                         (2 >> chroma_subsamp_x));
+    bufs->cr_col_buf = (int32_t *)malloc(sizeof(*bufs->cr_col_buf) *
+                                         (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                                         (2 >> chroma_subsamp_x));
+}
 
-    free(*cb_grain_block);
+static void dealloc_line_bufs(FilmGrainLineBufs *bufs) {
+    free(bufs->y_line_buf);
+    free(bufs->cb_line_buf);
+    free(bufs->cr_line_buf);
 
-    free(*cr_grain_block);
+    free(bufs->y_col_buf);
+    free(bufs->cb_col_buf);
+    free(bufs->cr_col_buf);
 }
 
 // get a number between 0 and 2^bits - 1
-static INLINE int32_t get_random_number(int32_t bits) {
+static INLINE int32_t get_random_number(uint16_t *random_register, int32_t bits) {
     uint16_t bit;
-    bit = ((random_register >> 0) ^ (random_register >> 1) ^ (random_register >> 3) ^
-           (random_register >> 12)) &
+    bit = ((*random_register >> 0) ^ (*random_register >> 1) ^ (*random_register >> 3) ^
+           (*random_register >> 12)) &
         1;
-    random_register = (random_register >> 1) | (bit << 15);
-    return (random_register >> (16 - bits)) & ((1 << bits) - 1);
+    *random_register = (*random_register >> 1) | (bit << 15);
+    return (*random_register >> (16 - bits)) & ((1 << bits) - 1);
 }
 
-static void init_random_generator(int32_t luma_line, uint16_t seed) {
+static uint16_t init_random_generator(int32_t luma_line, uint16_t seed) {
     // same for the picture
 
     uint16_t msb = (seed >> 8) & 255;
     uint16_t lsb = seed & 255;
 
-    random_register = (msb << 8) + lsb;
+    uint16_t random_register = (msb << 8) + lsb;
 
     //  changes for each row
     int32_t luma_num = luma_line >> 5;
 
     random_register ^= ((luma_num * 37 + 178) & 255) << 8;
     random_register ^= ((luma_num * 173 + 105) & 255);
+    return random_register;
 }
 
-static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_luma,
-                                      int32_t *luma_grain_block, int32_t luma_block_size_y,
-                                      int32_t luma_block_size_x, int32_t luma_grain_stride,
+static void generate_luma_grain_block(const FilmGrainFrame *fg, int32_t **pred_pos_luma,
+                                      int32_t luma_block_size_y, int32_t luma_block_size_x,
                                       int32_t left_pad, int32_t top_pad, int32_t right_pad,
                                       int32_t bottom_pad) {
+    const AomFilmGrain *params = fg->params;
     if (params->num_y_points == 0)
         return;
 
+    int32_t *luma_grain_block  = fg->luma_grain_block;
+    int32_t  luma_grain_stride = fg->luma_grain_stride;
+    int32_t  grain_min         = fg->grain_min;
+    int32_t  grain_max         = fg->grain_max;
+    uint16_t random_register   = params->random_seed;
+
     int32_t bit_depth       = params->bit_depth;
     int32_t gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
@@ -436,7 +424,7 @@ static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_l
     for (int32_t i = 0; i < luma_block_size_y; i++)
         for (int32_t j = 0; j < luma_block_size_x; j++)
             luma_grain_block[i * luma_grain_stride + j] =
-                (gaussian_sequence[get_random_number(gauss_bits)] +
+                (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
                  ((1 << gauss_sec_shift) >> 1)) >>
                 gauss_sec_shift;
 
@@ -457,13 +445,22 @@ static void generate_luma_grain_block(AomFilmGrain *params, int32_t **pred_pos_l
         }
 }
 
-static void generate_chroma_grain_blocks(
-    AomFilmGrain *params,
-    //                                  int32_t** pred_pos_luma,
-    int32_t **pred_pos_chroma, int32_t *luma_grain_block, int32_t *cb_grain_block,
-    int32_t *cr_grain_block, int32_t luma_grain_stride, int32_t chroma_block_size_y,
-    int32_t chroma_block_size_x, int32_t chroma_grain_stride, int32_t left_pad, int32_t top_pad,
-    int32_t right_pad, int32_t bottom_pad, int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+static void generate_chroma_grain_blocks(const FilmGrainFrame *fg, int32_t **pred_pos_chroma,
+                                         int32_t chroma_block_size_y, int32_t chroma_block_size_x,
+                                         int32_t left_pad, int32_t top_pad, int32_t right_pad,
+                                         int32_t bottom_pad) {
+    const AomFilmGrain *params              = fg->params;
+    int32_t *           luma_grain_block    = fg->luma_grain_block;
+    int32_t *           cb_grain_block      = fg->cb_grain_block;
+    int32_t *           cr_grain_block      = fg->cr_grain_block;
+    int32_t             luma_grain_stride   = fg->luma_grain_stride;
+    int32_t             chroma_grain_stride = fg->chroma_grain_stride;
+    int32_t             chroma_subsamp_y    = fg->chroma_subsamp_y;
+    int32_t             chroma_subsamp_x    = fg->chroma_subsamp_x;
+    int32_t             grain_min           = fg->grain_min;
+    int32_t             grain_max           = fg->grain_max;
+    uint16_t            random_register;
+
     int32_t bit_depth       = params->bit_depth;
     int32_t gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
@@ -475,24 +472,24 @@ static void generate_chroma_grain_blocks(
     int chroma_grain_block_size = chroma_block_size_y * chroma_grain_stride;
 
     if (params->num_cb_points || params->chroma_scaling_from_luma) {
-        init_random_generator(7 << 5, params->random_seed);
+        random_register = init_random_generator(7 << 5, params->random_seed);
 
         for (int32_t i = 0; i < chroma_block_size_y; i++)
             for (int32_t j = 0; j < chroma_block_size_x; j++)
                 cb_grain_block[i * chroma_grain_stride + j] =
-                    (gaussian_sequence[get_random_number(gauss_bits)] +
+                    (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
                      ((1 << gauss_sec_shift) >> 1)) >>
                     gauss_sec_shift;
     } else {
         memset(cb_grain_block, 0, sizeof(*cb_grain_block) * chroma_grain_block_size);
     }
     if (params->num_cr_points || params->chroma_scaling_from_luma) {
-        init_random_generator(11 << 5, params->random_seed);
+        random_register = init_random_generator(11 << 5, params->random_seed);
 
         for (int32_t i = 0; i < chroma_block_size_y; i++)
             for (int32_t j = 0; j < chroma_block_size_x; j++)
                 cr_grain_block[i * chroma_grain_stride + j] =
-                    (gaussian_sequence[get_random_number(gauss_bits)] +
+                    (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
                      ((1 << gauss_sec_shift) >> 1)) >>
                     gauss_sec_shift;
     } else {
@@ -574,7 +571,7 @@ static void init_scaling_function(int32_t scaling_points[][2], int32_t num_point
 
 // function that extracts samples from a lut (and interpolates intemediate
 // frames for 10- and 12-bit video)
-static int32_t scale_lut(int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
+static int32_t scale_lut(const int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
     int32_t x = index >> (bit_depth - 8);
 
     if (!(bit_depth - 8) || x == 255)
@@ -586,120 +583,133 @@ static int32_t scale_lut(int32_t *scaling_lut, int32_t index, int32_t bit_depth)
              (bit_depth - 8));
 }
 
-static void add_noise_to_block(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
-                               int32_t luma_stride, int32_t chroma_stride, int32_t *luma_grain,
-                               int32_t *cb_grain, int32_t *cr_grain, int32_t luma_grain_stride,
-                               int32_t chroma_grain_stride, int32_t half_luma_height,
-                               int32_t half_luma_width, int32_t bit_depth, int32_t chroma_subsamp_y,
-                               int32_t chroma_subsamp_x) {
-    int32_t cb_mult      = params->cb_mult - 128; // fixed scale
-    int32_t cb_luma_mult = params->cb_luma_mult - 128; // fixed scale
-    int32_t cb_offset    = params->cb_offset - 256;
-
-    int32_t cr_mult      = params->cr_mult - 128; // fixed scale
-    int32_t cr_luma_mult = params->cr_luma_mult - 128; // fixed scale
-    int32_t cr_offset    = params->cr_offset - 256;
-
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
-
-    int32_t apply_y  = params->num_y_points > 0 ? 1 : 0;
-    int32_t apply_cb = (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-    int32_t apply_cr = (params->num_cr_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-
-    if (params->chroma_scaling_from_luma) {
-        cb_mult      = 0; // fixed scale
-        cb_luma_mult = 64; // fixed scale
-        cb_offset    = 0;
-
-        cr_mult      = 0; // fixed scale
-        cr_luma_mult = 64; // fixed scale
-        cr_offset    = 0;
+void svt_av1_add_luma_grain_c(uint8_t *luma, int32_t luma_stride, const int32_t *grain,
+                              int32_t grain_stride, int32_t width, int32_t height,
+                              const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma,
+                              int32_t max_luma) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            luma[j] = clamp(
+                luma[j] +
+                    ((scale_lut(scaling_lut, luma[j], 8) * grain[j] + rounding_offset) >>
+                     scaling_shift),
+                min_luma,
+                max_luma);
+        }
+        luma += luma_stride;
+        grain += grain_stride;
     }
+}
 
-    int32_t min_luma, max_luma, min_chroma, max_chroma;
-
-    if (params->clip_to_restricted_range) {
-        min_luma = min_luma_legal_range;
-        max_luma = max_luma_legal_range;
-
-        min_chroma = min_chroma_legal_range;
-        max_chroma = max_chroma_legal_range;
-    } else {
-        min_luma = min_chroma = 0;
-        max_luma = max_chroma = 255;
+void svt_av1_add_luma_grain_hbd_c(uint16_t *luma, int32_t luma_stride, const int32_t *grain,
+                                  int32_t grain_stride, int32_t width, int32_t height,
+                                  const int32_t *scaling_lut, int32_t scaling_shift,
+                                  int32_t min_luma, int32_t max_luma, int32_t bit_depth) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            luma[j] = clamp(
+                luma[j] +
+                    ((scale_lut(scaling_lut, luma[j], bit_depth) * grain[j] + rounding_offset) >>
+                     scaling_shift),
+                min_luma,
+                max_luma);
+        }
+        luma += luma_stride;
+        grain += grain_stride;
     }
+}
+
+void svt_av1_add_chroma_grain_c(const uint8_t *luma, int32_t luma_stride, uint8_t *chroma,
+                                int32_t chroma_stride, const int32_t *grain, int32_t grain_stride,
+                                int32_t width, int32_t height, const int32_t *scaling_lut,
+                                int32_t mult, int32_t luma_mult, int32_t offset,
+                                int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma,
+                                int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
 
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
             int32_t average_luma = 0;
             if (chroma_subsamp_x) {
-                average_luma =
-                    (luma[(i << chroma_subsamp_y) * luma_stride + (j << chroma_subsamp_x)] +
-                     luma[(i << chroma_subsamp_y) * luma_stride + (j << chroma_subsamp_x) + 1] +
-                     1) >>
+                average_luma = (luma[(j << chroma_subsamp_x)] +
+                                luma[(j << chroma_subsamp_x) + 1] + 1) >>
                     1;
             } else
-                average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cb,
-                                    clamp(((average_luma * cb_luma_mult +
-                                            cb_mult * cb[i * chroma_stride + j]) >>
-                                           6) +
-                                              cb_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    8) *
-                              cb_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cr,
-                                    clamp(((average_luma * cr_luma_mult +
-                                            cr_mult * cr[i * chroma_stride + j]) >>
-                                           6) +
-                                              cr_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    8) *
-                              cr_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
+                average_luma = luma[j];
+            chroma[j] = clamp(
+                chroma[j] +
+                    ((scale_lut(scaling_lut,
+                                clamp(((average_luma * luma_mult + mult * chroma[j]) >> 6) +
+                                          offset,
+                                      0,
+                                      255),
+                                8) *
+                          grain[j] +
+                      rounding_offset) >>
+                     scaling_shift),
+                min_chroma,
+                max_chroma);
         }
+        luma += luma_stride << chroma_subsamp_y;
+        chroma += chroma_stride;
+        grain += grain_stride;
     }
+}
 
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] = clamp(
-                    luma[i * luma_stride + j] +
-                        ((scale_lut(scaling_lut_y, luma[i * luma_stride + j], 8) *
-                              luma_grain[i * luma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_luma,
-                    max_luma);
-            }
+void svt_av1_add_chroma_grain_hbd_c(const uint16_t *luma, int32_t luma_stride, uint16_t *chroma,
+                                    int32_t chroma_stride, const int32_t *grain,
+                                    int32_t grain_stride, int32_t width, int32_t height,
+                                    const int32_t *scaling_lut, int32_t mult, int32_t luma_mult,
+                                    int32_t offset, int32_t scaling_shift, int32_t min_chroma,
+                                    int32_t max_chroma, int32_t bit_depth,
+                                    int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t i = 0; i < height; i++) {
+        for (int32_t j = 0; j < width; j++) {
+            int32_t average_luma = 0;
+            if (chroma_subsamp_x) {
+                average_luma = (luma[(j << chroma_subsamp_x)] +
+                                luma[(j << chroma_subsamp_x) + 1] + 1) >>
+                    1;
+            } else
+                average_luma = luma[j];
+            chroma[j] = clamp(
+                chroma[j] +
+                    ((scale_lut(scaling_lut,
+                                clamp(((average_luma * luma_mult + mult * chroma[j]) >> 6) +
+                                          offset,
+                                      0,
+                                      (256 << (bit_depth - 8)) - 1),
+                                bit_depth) *
+                          grain[j] +
+                      rounding_offset) >>
+                     scaling_shift),
+                min_chroma,
+                max_chroma);
         }
+        luma += luma_stride << chroma_subsamp_y;
+        chroma += chroma_stride;
+        grain += grain_stride;
     }
 }
 
-static void add_noise_to_block_hbd(AomFilmGrain *params, uint16_t *luma, uint16_t *cb, uint16_t *cr,
-                                   int32_t luma_stride, int32_t chroma_stride, int32_t *luma_grain,
-                                   int32_t *cb_grain, int32_t *cr_grain, int32_t luma_grain_stride,
-                                   int32_t chroma_grain_stride, int32_t half_luma_height,
-                                   int32_t half_luma_width, int32_t bit_depth,
-                                   int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+// Adds grain to the block at (half_y, half_x) in units of 2 luma samples
+static void add_noise_to_block(const FilmGrainFrame *fg, int32_t half_y, int32_t half_x,
+                               int32_t *luma_grain, int32_t *cb_grain, int32_t *cr_grain,
+                               int32_t luma_grain_stride, int32_t chroma_grain_stride,
+                               int32_t half_luma_height, int32_t half_luma_width) {
+    const AomFilmGrain *params           = fg->params;
+    int32_t             bit_depth        = params->bit_depth;
+    int32_t             chroma_subsamp_y = fg->chroma_subsamp_y;
+    int32_t             chroma_subsamp_x = fg->chroma_subsamp_x;
+    int32_t             luma_stride      = fg->luma_stride;
+    int32_t             chroma_stride    = fg->chroma_stride;
+
     int32_t cb_mult      = params->cb_mult - 128; // fixed scale
     int32_t cb_luma_mult = params->cb_luma_mult - 128; // fixed scale
     // offset value depends on the bit depth
@@ -710,12 +720,14 @@ static void add_noise_to_block_hbd(AomFilmGrain *params, uint16_t *luma, uint16_
     // offset value depends on the bit depth
     int32_t cr_offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
 
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
-
     int32_t apply_y  = params->num_y_points > 0 ? 1 : 0;
     int32_t apply_cb = params->num_cb_points > 0 ? 1 : 0;
     int32_t apply_cr = params->num_cr_points > 0 ? 1 : 0;
 
+    // the 8-bit path also scales chroma from luma without chroma points
+    if (!fg->use_high_bit_depth && params->chroma_scaling_from_luma)
+        apply_cb = apply_cr = 1;
+
     if (params->chroma_scaling_from_luma) {
         cb_mult      = 0; // fixed scale
         cb_luma_mult = 64; // fixed scale
@@ -739,67 +751,120 @@ static void add_noise_to_block_hbd(AomFilmGrain *params, uint16_t *luma, uint16_
         max_luma = max_chroma = (256 << (bit_depth - 8)) - 1;
     }
 
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
-            int32_t average_luma = 0;
-            if (chroma_subsamp_x) {
-                average_luma =
-                    (luma[(i << chroma_subsamp_y) * luma_stride + (j << chroma_subsamp_x)] +
-                     luma[(i << chroma_subsamp_y) * luma_stride + (j << chroma_subsamp_x) + 1] +
-                     1) >>
-                    1;
-            } else
-                average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cb,
-                                    clamp(((average_luma * cb_luma_mult +
-                                            cb_mult * cb[i * chroma_stride + j]) >>
-                                           6) +
-                                              cb_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    bit_depth) *
-                              cb_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                        ((scale_lut(scaling_lut_cr,
-                                    clamp(((average_luma * cr_luma_mult +
-                                            cr_mult * cr[i * chroma_stride + j]) >>
-                                           6) +
-                                              cr_offset,
-                                          0,
-                                          (256 << (bit_depth - 8)) - 1),
-                                    bit_depth) *
-                              cr_grain[i * chroma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_chroma,
-                    max_chroma);
-            }
-        }
-    }
+    int32_t luma_offset   = (half_y << 1) * luma_stride + (half_x << 1);
+    int32_t chroma_offset = (half_y << (1 - chroma_subsamp_y)) * chroma_stride +
+        (half_x << (1 - chroma_subsamp_x));
+    int32_t chroma_height = half_luma_height << (1 - chroma_subsamp_y);
+    int32_t chroma_width  = half_luma_width << (1 - chroma_subsamp_x);
 
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] = clamp(
-                    luma[i * luma_stride + j] +
-                        ((scale_lut(scaling_lut_y, luma[i * luma_stride + j], bit_depth) *
-                              luma_grain[i * luma_grain_stride + j] +
-                          rounding_offset) >>
-                         params->scaling_shift),
-                    min_luma,
-                    max_luma);
-            }
-        }
+    // chroma first, it is scaled by the luma samples without grain
+    if (fg->use_high_bit_depth) {
+        uint16_t *luma = (uint16_t *)fg->luma + luma_offset;
+        uint16_t *cb   = (uint16_t *)fg->cb + chroma_offset;
+        uint16_t *cr   = (uint16_t *)fg->cr + chroma_offset;
+
+        if (apply_cb)
+            svt_av1_add_chroma_grain_hbd(luma,
+                                         luma_stride,
+                                         cb,
+                                         chroma_stride,
+                                         cb_grain,
+                                         chroma_grain_stride,
+                                         chroma_width,
+                                         chroma_height,
+                                         fg->scaling_lut_cb,
+                                         cb_mult,
+                                         cb_luma_mult,
+                                         cb_offset,
+                                         params->scaling_shift,
+                                         min_chroma,
+                                         max_chroma,
+                                         bit_depth,
+                                         chroma_subsamp_y,
+                                         chroma_subsamp_x);
+        if (apply_cr)
+            svt_av1_add_chroma_grain_hbd(luma,
+                                         luma_stride,
+                                         cr,
+                                         chroma_stride,
+                                         cr_grain,
+                                         chroma_grain_stride,
+                                         chroma_width,
+                                         chroma_height,
+                                         fg->scaling_lut_cr,
+                                         cr_mult,
+                                         cr_luma_mult,
+                                         cr_offset,
+                                         params->scaling_shift,
+                                         min_chroma,
+                                         max_chroma,
+                                         bit_depth,
+                                         chroma_subsamp_y,
+                                         chroma_subsamp_x);
+        if (apply_y)
+            svt_av1_add_luma_grain_hbd(luma,
+                                       luma_stride,
+                                       luma_grain,
+                                       luma_grain_stride,
+                                       half_luma_width << 1,
+                                       half_luma_height << 1,
+                                       fg->scaling_lut_y,
+                                       params->scaling_shift,
+                                       min_luma,
+                                       max_luma,
+                                       bit_depth);
+    } else {
+        uint8_t *luma = fg->luma + luma_offset;
+        uint8_t *cb   = fg->cb + chroma_offset;
+        uint8_t *cr   = fg->cr + chroma_offset;
+
+        if (apply_cb)
+            svt_av1_add_chroma_grain(luma,
+                                     luma_stride,
+                                     cb,
+                                     chroma_stride,
+                                     cb_grain,
+                                     chroma_grain_stride,
+                                     chroma_width,
+                                     chroma_height,
+                                     fg->scaling_lut_cb,
+                                     cb_mult,
+                                     cb_luma_mult,
+                                     cb_offset,
+                                     params->scaling_shift,
+                                     min_chroma,
+                                     max_chroma,
+                                     chroma_subsamp_y,
+                                     chroma_subsamp_x);
+        if (apply_cr)
+            svt_av1_add_chroma_grain(luma,
+                                     luma_stride,
+                                     cr,
+                                     chroma_stride,
+                                     cr_grain,
+                                     chroma_grain_stride,
+                                     chroma_width,
+                                     chroma_height,
+                                     fg->scaling_lut_cr,
+                                     cr_mult,
+                                     cr_luma_mult,
+                                     cr_offset,
+                                     params->scaling_shift,
+                                     min_chroma,
+                                     max_chroma,
+                                     chroma_subsamp_y,
+                                     chroma_subsamp_x);
+        if (apply_y)
+            svt_av1_add_luma_grain(luma,
+                                   luma_stride,
+                                   luma_grain,
+                                   luma_grain_stride,
+                                   half_luma_width << 1,
+                                   half_luma_height << 1,
+                                   fg->scaling_lut_y,
+                                   params->scaling_shift,
+                                   min_luma,
+                                   max_luma);
     }
 }
 
@@ -897,7 +962,8 @@ static void copy_area(int32_t *src, int32_t src_stride, int32_t *dst, int32_t ds
 
 static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride, int32_t *right_block,
                                  int32_t right_stride, int32_t *dst_block, int32_t dst_stride,
-                                 int32_t width, int32_t height) {
+                                 int32_t width, int32_t height, int32_t grain_min,
+                                 int32_t grain_max) {
     if (width == 1) {
         while (height) {
             *dst_block = clamp(
@@ -925,7 +991,8 @@ static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride, int32
 
 static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride, int32_t *bottom_block,
                                  int32_t bottom_stride, int32_t *dst_block, int32_t dst_stride,
-                                 int32_t width, int32_t height) {
+                                 int32_t width, int32_t height, int32_t grain_min,
+                                 int32_t grain_max) {
     if (height == 1) {
         while (width) {
             *dst_block = clamp(
@@ -953,25 +1020,318 @@ static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride, int32_t
     }
 }
 
-void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
-                                int32_t height, int32_t width, int32_t luma_stride,
-                                int32_t chroma_stride, int32_t use_high_bit_depth,
-                                int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    int32_t **pred_pos_luma;
-    int32_t **pred_pos_chroma;
-    int32_t * luma_grain_block;
-    int32_t * cb_grain_block;
-    int32_t * cr_grain_block;
+// Adds grain to the stripe starting at half luma row y. The line buffers must
+// hold the bottom grain of the stripe above; when apply is 0 only the buffers
+// are updated, which lets a thread start at any stripe.
+static void add_grain_to_stripe(const FilmGrainFrame *fg, FilmGrainLineBufs *bufs, int32_t y,
+                                int32_t apply) {
+    const AomFilmGrain *params = fg->params;
 
-    int32_t *y_line_buf;
-    int32_t *cb_line_buf;
-    int32_t *cr_line_buf;
+    int32_t left_pad   = 3;
+    int32_t top_pad    = 3;
+    int32_t ar_padding = 3;
+
+    int32_t chroma_subsamp_y       = fg->chroma_subsamp_y;
+    int32_t chroma_subsamp_x       = fg->chroma_subsamp_x;
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+
+    int32_t height              = fg->height;
+    int32_t width               = fg->width;
+    int32_t luma_stride         = fg->luma_stride;
+    int32_t chroma_stride       = fg->chroma_stride;
+    int32_t luma_grain_stride   = fg->luma_grain_stride;
+    int32_t chroma_grain_stride = fg->chroma_grain_stride;
+    int32_t grain_min           = fg->grain_min;
+    int32_t grain_max           = fg->grain_max;
+
+    int32_t *luma_grain_block = fg->luma_grain_block;
+    int32_t *cb_grain_block   = fg->cb_grain_block;
+    int32_t *cr_grain_block   = fg->cr_grain_block;
+
+    int32_t *y_line_buf  = bufs->y_line_buf;
+    int32_t *cb_line_buf = bufs->cb_line_buf;
+    int32_t *cr_line_buf = bufs->cr_line_buf;
+    int32_t *y_col_buf   = bufs->y_col_buf;
+    int32_t *cb_col_buf  = bufs->cb_col_buf;
+    int32_t *cr_col_buf  = bufs->cr_col_buf;
+
+    int32_t overlap = params->overlap_flag;
+
+    uint16_t random_register = init_random_generator(y * 2, params->random_seed);
+
+    for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+        int32_t offset_y = get_random_number(&random_register, 8);
+        int32_t offset_x = (offset_y >> 4) & 15;
+        offset_y &= 15;
+
+        int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
+        int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
+
+        int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+            offset_y * (2 >> chroma_subsamp_y);
+        int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+            offset_x * (2 >> chroma_subsamp_x);
+
+        if (overlap && x) {
+            ver_boundary_overlap(y_col_buf,
+                                 2,
+                                 luma_grain_block + luma_offset_y * luma_grain_stride +
+                                     luma_offset_x,
+                                 luma_grain_stride,
+                                 y_col_buf,
+                                 2,
+                                 2,
+                                 AOMMIN(luma_subblock_size_y + 2, height - (y << 1)),
+                                 grain_min,
+                                 grain_max);
+
+            ver_boundary_overlap(
+                cb_col_buf,
+                2 >> chroma_subsamp_x,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
+                chroma_grain_stride,
+                cb_col_buf,
+                2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min,
+                grain_max);
 
-    int32_t *y_col_buf;
-    int32_t *cb_col_buf;
-    int32_t *cr_col_buf;
+            ver_boundary_overlap(
+                cr_col_buf,
+                2 >> chroma_subsamp_x,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
+                chroma_grain_stride,
+                cr_col_buf,
+                2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min,
+                grain_max);
+
+            int32_t i = y ? 1 : 0;
+
+            if (apply)
+                add_noise_to_block(fg,
+                                   y + i,
+                                   x,
+                                   y_col_buf + i * 4,
+                                   cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                                   cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                                   2,
+                                   (2 - chroma_subsamp_x),
+                                   AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+                                   1);
+        }
+
+        if (overlap && y && apply) {
+            if (x) {
+                ASSERT(y_col_buf != NULL);
+                hor_boundary_overlap(y_line_buf + (x << 1),
+                                     luma_stride,
+                                     y_col_buf,
+                                     2,
+                                     y_line_buf + (x << 1),
+                                     luma_stride,
+                                     2,
+                                     2,
+                                     grain_min,
+                                     grain_max);
+
+                hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     cb_col_buf,
+                                     2 >> chroma_subsamp_x,
+                                     cb_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     2 >> chroma_subsamp_x,
+                                     2 >> chroma_subsamp_y,
+                                     grain_min,
+                                     grain_max);
+
+                hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     cr_col_buf,
+                                     2 >> chroma_subsamp_x,
+                                     cr_line_buf + x * (2 >> chroma_subsamp_x),
+                                     chroma_stride,
+                                     2 >> chroma_subsamp_x,
+                                     2 >> chroma_subsamp_y,
+                                     grain_min,
+                                     grain_max);
+            }
+
+            hor_boundary_overlap(y_line_buf + ((x ? x + 1 : 0) << 1),
+                                 luma_stride,
+                                 luma_grain_block + luma_offset_y * luma_grain_stride +
+                                     luma_offset_x + (x ? 2 : 0),
+                                 luma_grain_stride,
+                                 y_line_buf + ((x ? x + 1 : 0) << 1),
+                                 luma_stride,
+                                 AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
+                                        width - ((x ? x + 1 : 0) << 1)),
+                                 2,
+                                 grain_min,
+                                 grain_max);
+
+            hor_boundary_overlap(
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                       (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y,
+                grain_min,
+                grain_max);
+
+            hor_boundary_overlap(
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                       (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y,
+                grain_min,
+                grain_max);
+
+            add_noise_to_block(fg,
+                               y,
+                               x,
+                               y_line_buf + (x << 1),
+                               cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                               cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                               luma_stride,
+                               chroma_stride,
+                               1,
+                               AOMMIN(luma_subblock_size_x >> 1, width / 2 - x));
+        }
+
+        int32_t i = overlap && y ? 1 : 0;
+        int32_t j = overlap && x ? 1 : 0;
+
+        if (apply)
+            add_noise_to_block(
+                fg,
+                y + i,
+                x + j,
+                luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
+                    luma_offset_x + (j << 1),
+                cb_grain_block +
+                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
+                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+                cr_grain_block +
+                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
+                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+                luma_grain_stride,
+                chroma_grain_stride,
+                AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+                AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j);
+
+        if (overlap) {
+            if (x) {
+                // Copy overlapped column bufer to line buffer
+                copy_area(y_col_buf + (luma_subblock_size_y << 1),
+                          2,
+                          y_line_buf + (x << 1),
+                          luma_stride,
+                          2,
+                          2);
 
-    random_register = params->random_seed;
+                copy_area(cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+                          2 >> chroma_subsamp_x,
+                          cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                          chroma_stride,
+                          2 >> chroma_subsamp_x,
+                          2 >> chroma_subsamp_y);
+
+                copy_area(cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+                          2 >> chroma_subsamp_x,
+                          cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                          chroma_stride,
+                          2 >> chroma_subsamp_x,
+                          2 >> chroma_subsamp_y);
+            }
+
+            // Copy grain to the line buffer for overlap with a bottom block
+            copy_area(luma_grain_block +
+                          (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
+                          luma_offset_x + ((x ? 2 : 0)),
+                      luma_grain_stride,
+                      y_line_buf + ((x ? x + 1 : 0) << 1),
+                      luma_stride,
+                      AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0),
+                      2);
+
+            copy_area(cb_grain_block +
+                          (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+                          chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                      chroma_grain_stride,
+                      cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                      chroma_stride,
+                      AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
+                          (x ? 2 >> chroma_subsamp_x : 0),
+                      2 >> chroma_subsamp_y);
+
+            copy_area(cr_grain_block +
+                          (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+                          chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                      chroma_grain_stride,
+                      cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                      chroma_stride,
+                      AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
+                          (x ? 2 >> chroma_subsamp_x : 0),
+                      2 >> chroma_subsamp_y);
+
+            // Copy grain to the column buffer for overlap with the next block to
+            // the right
+
+            copy_area(luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x +
+                          luma_subblock_size_x,
+                      luma_grain_stride,
+                      y_col_buf,
+                      2,
+                      2,
+                      AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+            copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                          chroma_subblock_size_x,
+                      chroma_grain_stride,
+                      cb_col_buf,
+                      2 >> chroma_subsamp_x,
+                      2 >> chroma_subsamp_x,
+                      AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                             (height - (y << 1)) >> chroma_subsamp_y));
+
+            copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
+                          chroma_subblock_size_x,
+                      chroma_grain_stride,
+                      cr_col_buf,
+                      2 >> chroma_subsamp_x,
+                      2 >> chroma_subsamp_x,
+                      AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                             (height - (y << 1)) >> chroma_subsamp_y));
+        }
+    }
+}
+
+int32_t svt_av1_film_grain_frame_init(FilmGrainFrame *fg, AomFilmGrain *params, uint8_t *luma,
+                                      uint8_t *cb, uint8_t *cr, int32_t height, int32_t width,
+                                      int32_t luma_stride, int32_t chroma_stride,
+                                      int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+                                      int32_t chroma_subsamp_x) {
+    int32_t **pred_pos_luma;
+    int32_t **pred_pos_chroma;
 
     int32_t left_pad   = 3;
     int32_t right_pad  = 3; // padding to offset for AR coefficients
@@ -980,11 +1340,8 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
 
     int32_t ar_padding = 3; // maximum lag used for stabilization of AR coefficients
 
-    luma_subblock_size_y = 32;
-    luma_subblock_size_x = 32;
-
-    chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
-    chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
 
     // Initial padding is only needed for generation of
     // film grain templates (to stabilize the AR process)
@@ -1000,428 +1357,118 @@ void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb
     int32_t chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
         chroma_subblock_size_x * 2 + (2 >> chroma_subsamp_x) * ar_padding + right_pad;
 
-    int32_t luma_grain_stride   = luma_block_size_x;
-    int32_t chroma_grain_stride = chroma_block_size_x;
-
-    int32_t overlap   = params->overlap_flag;
-    int32_t bit_depth = params->bit_depth;
-
-    grain_center = 128 << (bit_depth - 8);
-    grain_min    = 0 - grain_center;
-    grain_max    = (256 << (bit_depth - 8)) - 1 - grain_center;
-
-    init_arrays(params,
-                luma_stride,
-                chroma_stride,
-                &pred_pos_luma,
-                &pred_pos_chroma,
-                &luma_grain_block,
-                &cb_grain_block,
-                &cr_grain_block,
-                &y_line_buf,
-                &cb_line_buf,
-                &cr_line_buf,
-                &y_col_buf,
-                &cb_col_buf,
-                &cr_col_buf,
-                luma_block_size_y * luma_block_size_x,
-                chroma_block_size_y * chroma_block_size_x,
-                chroma_subsamp_y,
-                chroma_subsamp_x);
-
-    generate_luma_grain_block(params,
+    int32_t bit_depth    = params->bit_depth;
+    int32_t grain_center = 128 << (bit_depth - 8);
+
+    fg->params              = params;
+    fg->luma                = luma;
+    fg->cb                  = cb;
+    fg->cr                  = cr;
+    fg->height              = height;
+    fg->width               = width;
+    fg->luma_stride         = luma_stride;
+    fg->chroma_stride       = chroma_stride;
+    fg->use_high_bit_depth  = use_high_bit_depth;
+    fg->chroma_subsamp_y    = chroma_subsamp_y;
+    fg->chroma_subsamp_x    = chroma_subsamp_x;
+    fg->luma_grain_stride   = luma_block_size_x;
+    fg->chroma_grain_stride = chroma_block_size_x;
+    fg->grain_min           = 0 - grain_center;
+    fg->grain_max           = (256 << (bit_depth - 8)) - 1 - grain_center;
+
+    fg->luma_grain_block = (int32_t *)malloc(sizeof(*fg->luma_grain_block) * luma_block_size_y *
+                                             luma_block_size_x);
+    fg->cb_grain_block   = (int32_t *)malloc(sizeof(*fg->cb_grain_block) * chroma_block_size_y *
+                                           chroma_block_size_x);
+    fg->cr_grain_block   = (int32_t *)malloc(sizeof(*fg->cr_grain_block) * chroma_block_size_y *
+                                           chroma_block_size_x);
+
+    init_pred_pos(params, &pred_pos_luma, &pred_pos_chroma);
+
+    generate_luma_grain_block(fg,
                               pred_pos_luma,
-                              luma_grain_block,
                               luma_block_size_y,
                               luma_block_size_x,
-                              luma_grain_stride,
                               left_pad,
                               top_pad,
                               right_pad,
                               bottom_pad);
 
-    generate_chroma_grain_blocks(params,
-                                 //                               pred_pos_luma,
+    generate_chroma_grain_blocks(fg,
                                  pred_pos_chroma,
-                                 luma_grain_block,
-                                 cb_grain_block,
-                                 cr_grain_block,
-                                 luma_grain_stride,
                                  chroma_block_size_y,
                                  chroma_block_size_x,
-                                 chroma_grain_stride,
                                  left_pad,
                                  top_pad,
                                  right_pad,
-                                 bottom_pad,
-                                 chroma_subsamp_y,
-                                 chroma_subsamp_x);
+                                 bottom_pad);
+
+    dealloc_pred_pos(params, pred_pos_luma, pred_pos_chroma);
+
+    memset(fg->scaling_lut_y, 0, sizeof(fg->scaling_lut_y));
+    memset(fg->scaling_lut_cb, 0, sizeof(fg->scaling_lut_cb));
+    memset(fg->scaling_lut_cr, 0, sizeof(fg->scaling_lut_cr));
 
-    init_scaling_function(params->scaling_points_y, params->num_y_points, scaling_lut_y);
+    init_scaling_function(params->scaling_points_y, params->num_y_points, fg->scaling_lut_y);
 
     if (params->chroma_scaling_from_luma) {
-        svt_memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-        svt_memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+        svt_memcpy(fg->scaling_lut_cb, fg->scaling_lut_y, sizeof(fg->scaling_lut_y));
+        svt_memcpy(fg->scaling_lut_cr, fg->scaling_lut_y, sizeof(fg->scaling_lut_y));
     } else {
-        init_scaling_function(params->scaling_points_cb, params->num_cb_points, scaling_lut_cb);
-        init_scaling_function(params->scaling_points_cr, params->num_cr_points, scaling_lut_cr);
+        init_scaling_function(
+            params->scaling_points_cb, params->num_cb_points, fg->scaling_lut_cb);
+        init_scaling_function(
+            params->scaling_points_cr, params->num_cr_points, fg->scaling_lut_cr);
     }
-    for (int32_t y = 0; y < height / 2; y += (luma_subblock_size_y >> 1)) {
-        init_random_generator(y * 2, params->random_seed);
-
-        for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
-            int32_t offset_y = get_random_number(8);
-            int32_t offset_x = (offset_y >> 4) & 15;
-            offset_y &= 15;
-
-            int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
-            int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
-
-            int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                offset_y * (2 >> chroma_subsamp_y);
-            int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                offset_x * (2 >> chroma_subsamp_x);
-
-            if (overlap && x) {
-                ver_boundary_overlap(
-                    y_col_buf,
-                    2,
-                    luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x,
-                    luma_grain_stride,
-                    y_col_buf,
-                    2,
-                    2,
-                    AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-                ver_boundary_overlap(
-                    cb_col_buf,
-                    2 >> chroma_subsamp_x,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
-                    chroma_grain_stride,
-                    cb_col_buf,
-                    2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                           (height - (y << 1)) >> chroma_subsamp_y));
-
-                ver_boundary_overlap(
-                    cr_col_buf,
-                    2 >> chroma_subsamp_x,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x,
-                    chroma_grain_stride,
-                    cr_col_buf,
-                    2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                           (height - (y << 1)) >> chroma_subsamp_y));
-
-                int32_t i = y ? 1 : 0;
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params,
-                        (uint16_t *)luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        (uint16_t *)cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2,
-                        (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                        1,
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                } else {
-                    add_noise_to_block(
-                        params,
-                        luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2,
-                        (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                        1,
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                }
-            }
-
-            if (overlap && y) {
-                if (x) {
-                    ASSERT(y_col_buf != NULL);
-                    hor_boundary_overlap(y_line_buf + (x << 1),
-                                         luma_stride,
-                                         y_col_buf,
-                                         2,
-                                         y_line_buf + (x << 1),
-                                         luma_stride,
-                                         2,
-                                         2);
-
-                    hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         cb_col_buf,
-                                         2 >> chroma_subsamp_x,
-                                         cb_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         2 >> chroma_subsamp_x,
-                                         2 >> chroma_subsamp_y);
-
-                    hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         cr_col_buf,
-                                         2 >> chroma_subsamp_x,
-                                         cr_line_buf + x * (2 >> chroma_subsamp_x),
-                                         chroma_stride,
-                                         2 >> chroma_subsamp_x,
-                                         2 >> chroma_subsamp_y);
-                }
-
-                hor_boundary_overlap(y_line_buf + ((x ? x + 1 : 0) << 1),
-                                     luma_stride,
-                                     luma_grain_block + luma_offset_y * luma_grain_stride +
-                                         luma_offset_x + (x ? 2 : 0),
-                                     luma_grain_stride,
-                                     y_line_buf + ((x ? x + 1 : 0) << 1),
-                                     luma_stride,
-                                     AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
-                                            width - ((x ? x + 1 : 0) << 1)),
-                                     2);
-
-                hor_boundary_overlap(
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                        ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                           (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                hor_boundary_overlap(
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                        ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x - ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                           (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params,
-                        (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << ((1 - chroma_subsamp_x))),
-                        (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                            (x << ((1 - chroma_subsamp_x))),
-                        luma_stride,
-                        chroma_stride,
-                        y_line_buf + (x << 1),
-                        cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                        cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                        luma_stride,
-                        chroma_stride,
-                        1,
-                        AOMMIN(luma_subblock_size_x >> 1, width / 2 - x),
-                        bit_depth,
-                        chroma_subsamp_y,
-                        chroma_subsamp_x);
-                } else {
-                    add_noise_to_block(params,
-                                       luma + (y << 1) * luma_stride + (x << 1),
-                                       cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                                           (x << ((1 - chroma_subsamp_x))),
-                                       cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                                           (x << ((1 - chroma_subsamp_x))),
-                                       luma_stride,
-                                       chroma_stride,
-                                       y_line_buf + (x << 1),
-                                       cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                                       cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                                       luma_stride,
-                                       chroma_stride,
-                                       1,
-                                       AOMMIN(luma_subblock_size_x >> 1, width / 2 - x),
-                                       bit_depth,
-                                       chroma_subsamp_y,
-                                       chroma_subsamp_x);
-                }
-            }
-
-            int32_t i = overlap && y ? 1 : 0;
-            int32_t j = overlap && x ? 1 : 0;
-
-            if (use_high_bit_depth) {
-                add_noise_to_block_hbd(
-                    params,
-                    (uint16_t *)luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    (uint16_t *)cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    (uint16_t *)cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride,
-                    chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                        luma_offset_x + (j << 1),
-                    cb_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride,
-                    chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j,
-                    bit_depth,
-                    chroma_subsamp_y,
-                    chroma_subsamp_x);
-            } else {
-                add_noise_to_block(
-                    params,
-                    luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride,
-                    chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                        luma_offset_x + (j << 1),
-                    cb_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                        (chroma_offset_y + (i << (1 - chroma_subsamp_y))) * chroma_grain_stride +
-                        chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride,
-                    chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j,
-                    bit_depth,
-                    chroma_subsamp_y,
-                    chroma_subsamp_x);
-            }
-
-            if (overlap) {
-                if (x) {
-                    // Copy overlapped column bufer to line buffer
-                    copy_area(y_col_buf + (luma_subblock_size_y << 1),
-                              2,
-                              y_line_buf + (x << 1),
-                              luma_stride,
-                              2,
-                              2);
-
-                    copy_area(cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                              2 >> chroma_subsamp_x,
-                              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                              chroma_stride,
-                              2 >> chroma_subsamp_x,
-                              2 >> chroma_subsamp_y);
-
-                    copy_area(cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                              2 >> chroma_subsamp_x,
-                              cr_line_buf + (x << (1 - chroma_subsamp_x)),
-                              chroma_stride,
-                              2 >> chroma_subsamp_x,
-                              2 >> chroma_subsamp_y);
-                }
+    fg->scaling_lut_y[256]  = fg->scaling_lut_y[255];
+    fg->scaling_lut_cb[256] = fg->scaling_lut_cb[255];
+    fg->scaling_lut_cr[256] = fg->scaling_lut_cr[255];
 
-                // Copy grain to the line buffer for overlap with a bottom block
-                copy_area(luma_grain_block +
-                              (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
-                              luma_offset_x + ((x ? 2 : 0)),
-                          luma_grain_stride,
-                          y_line_buf + ((x ? x + 1 : 0) << 1),
-                          luma_stride,
-                          AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0),
-                          2);
-
-                copy_area(cb_grain_block +
-                              (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
-                              chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                          chroma_grain_stride,
-                          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                          chroma_stride,
-                          AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
-                              (x ? 2 >> chroma_subsamp_x : 0),
-                          2 >> chroma_subsamp_y);
-
-                copy_area(cr_grain_block +
-                              (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
-                              chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                          chroma_grain_stride,
-                          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                          chroma_stride,
-                          AOMMIN(chroma_subblock_size_x, ((width - (x << 1)) >> chroma_subsamp_x)) -
-                              (x ? 2 >> chroma_subsamp_x : 0),
-                          2 >> chroma_subsamp_y);
+    return (height / 2 + (luma_subblock_size_y >> 1) - 1) / (luma_subblock_size_y >> 1);
+}
 
-                // Copy grain to the column buffer for overlap with the next block to
-                // the right
+void svt_av1_film_grain_frame_free(FilmGrainFrame *fg) {
+    free(fg->luma_grain_block);
+    free(fg->cb_grain_block);
+    free(fg->cr_grain_block);
+}
 
-                copy_area(luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x +
-                              luma_subblock_size_x,
-                          luma_grain_stride,
-                          y_col_buf,
-                          2,
-                          2,
-                          AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+void svt_av1_add_film_grain_stripe(const FilmGrainFrame *fg, int32_t stripe) {
+    FilmGrainLineBufs bufs;
+    int32_t           y = stripe * (luma_subblock_size_y >> 1);
 
-                copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                              chroma_subblock_size_x,
-                          chroma_grain_stride,
-                          cb_col_buf,
-                          2 >> chroma_subsamp_x,
-                          2 >> chroma_subsamp_x,
-                          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                                 (height - (y << 1)) >> chroma_subsamp_y));
-
-                copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride + chroma_offset_x +
-                              chroma_subblock_size_x,
-                          chroma_grain_stride,
-                          cr_col_buf,
-                          2 >> chroma_subsamp_x,
-                          2 >> chroma_subsamp_x,
-                          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                                 (height - (y << 1)) >> chroma_subsamp_y));
-            }
-        }
-    }
+    init_line_bufs(fg, &bufs);
+    // rebuild the overlap with the stripe above without touching its samples
+    if (fg->params->overlap_flag && y)
+        add_grain_to_stripe(fg, &bufs, y - (luma_subblock_size_y >> 1), 0);
+    add_grain_to_stripe(fg, &bufs, y, 1);
+    dealloc_line_bufs(&bufs);
+}
 
-    dealloc_arrays(params,
-                   &pred_pos_luma,
-                   &pred_pos_chroma,
-                   &luma_grain_block,
-                   &cb_grain_block,
-                   &cr_grain_block,
-                   &y_line_buf,
-                   &cb_line_buf,
-                   &cr_line_buf,
-                   &y_col_buf,
-                   &cb_col_buf,
-                   &cr_col_buf);
+void svt_av1_add_film_grain_run(AomFilmGrain *params, uint8_t *luma, uint8_t *cb, uint8_t *cr,
+                                int32_t height, int32_t width, int32_t luma_stride,
+                                int32_t chroma_stride, int32_t use_high_bit_depth,
+                                int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    FilmGrainFrame    fg;
+    FilmGrainLineBufs bufs;
+
+    const int32_t num_stripes = svt_av1_film_grain_frame_init(&fg,
+                                                              params,
+                                                              luma,
+                                                              cb,
+                                                              cr,
+                                                              height,
+                                                              width,
+                                                              luma_stride,
+                                                              chroma_stride,
+                                                              use_high_bit_depth,
+                                                              chroma_subsamp_y,
+                                                              chroma_subsamp_x);
+    init_line_bufs(&fg, &bufs);
+    for (int32_t stripe = 0; stripe < num_stripes; stripe++)
+        add_grain_to_stripe(&fg, &bufs, stripe * (luma_subblock_size_y >> 1), 1);
+    dealloc_line_bufs(&bufs);
+    svt_av1_film_grain_frame_free(&fg);
 }
 
 /*
@@ -102,12 +102,65 @@ void svt_av1_add_film_grain_run(AomFilmGrain *grain_params, uint8_t *luma, uint8
                                 int32_t chroma_stride, int32_t use_high_bit_depth,
                                 int32_t chroma_subsamp_y, int32_t chroma_subsamp_x);
 
+/*!\brief Grain templates and scaling tables of a picture
+     *
+     * Read only once built, so the stripes of the picture can get their
+     * grain from different threads
+     */
+typedef struct FilmGrainFrame {
+    AomFilmGrain *params;
+
+    uint8_t *luma;
+    uint8_t *cb;
+    uint8_t *cr;
+    int32_t  height;
+    int32_t  width;
+    int32_t  luma_stride;
+    int32_t  chroma_stride;
+    int32_t  use_high_bit_depth;
+    int32_t  chroma_subsamp_y;
+    int32_t  chroma_subsamp_x;
+
+    int32_t *luma_grain_block;
+    int32_t *cb_grain_block;
+    int32_t *cr_grain_block;
+    int32_t  luma_grain_stride;
+    int32_t  chroma_grain_stride;
+
+    // one extra entry repeats the last one, for the high bit depth interpolation
+    int32_t scaling_lut_y[257];
+    int32_t scaling_lut_cb[257];
+    int32_t scaling_lut_cr[257];
+
+    int32_t grain_min;
+    int32_t grain_max;
+} FilmGrainFrame;
+
+/*!\brief Build the grain templates of a picture
+     *
+     * Takes the same arguments as svt_av1_add_film_grain_run()
+     *
+     * \return Number of 32 luma row stripes to pass to
+     *         svt_av1_add_film_grain_stripe()
+     */
+int32_t svt_av1_film_grain_frame_init(FilmGrainFrame *fg, AomFilmGrain *grain_params,
+                                      uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t height,
+                                      int32_t width, int32_t luma_stride, int32_t chroma_stride,
+                                      int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+                                      int32_t chroma_subsamp_x);
+
+/*!\brief Add film grain to one stripe of 32 luma rows, in any order
+     */
+void svt_av1_add_film_grain_stripe(const FilmGrainFrame *fg, int32_t stripe);
+
+void svt_av1_film_grain_frame_free(FilmGrainFrame *fg);
+
 /*!\brief Add film grain
      *
      * Add film grain to an image
      *
      * \param[in]    grain_params     Grain parameters
-     * \param[in]    src              Source image
+     * \param[in]    src             Source image
      * \param[in]    dst              Resulting image with grain
      */
 
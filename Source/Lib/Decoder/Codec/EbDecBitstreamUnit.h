@@ -15,6 +15,9 @@
 
 #include "EbCabacContextModel.h"
 #include "EbBitstreamUnit.h"
+#ifdef ARCH_X86_64
+#include <emmintrin.h>
+#endif
 //Added this EbBitstreamUnit.h because OdEcWindow is defined in it, but
 //we also defining it, so it leads to warning,  so i commented our defination & added EbBitstreamUnit.h file.
 
@@ -44,6 +47,13 @@ extern "C" {
 /*The size in bits of OdEcWindow.*/
 //#define OD_EC_WINDOW_SIZE ((int)sizeof(OdEcWindow) * CHAR_BIT)
 
+/*The decoder keeps its own 64-bit window, so a refill brings in up to 8 bytes
+   at once and is needed about once every 6 bytes of symbols instead of once
+   every 2. The encoder keeps the 32-bit OdEcWindow.*/
+typedef uint64_t DecEcWindow;
+
+#define DEC_EC_WINDOW_SIZE ((int)sizeof(DecEcWindow) * CHAR_BIT)
+
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
@@ -70,23 +80,79 @@ extern int   enable_dump;
   inverse).*/
 #define AOM_ICDF(x) (CDF_PROB_TOP - (x))
 
+#ifdef ARCH_X86_64
+/*EC_MIN_PROB * (N - i) for lane i of a CDF with N + 1 symbols is read from
+   od_ec_min_prob + 15 - N, and the lanes past the last symbol, whose CDF
+   entries are not part of the table, are masked off with od_ec_lane_mask + 15 - N.*/
+static const uint16_t od_ec_min_prob[31] = {60, 56, 52, 48, 44, 40, 36, 32, 28, 24, 20,
+                                            16, 12, 8,  4,  0,  0,  0,  0,  0,  0,  0,
+                                            0,  0,  0,  0,  0,  0,  0,  0,  0};
+static const uint16_t od_ec_lane_mask[31] = {
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0,      0,      0,      0,      0,      0,
+    0,      0,      0,      0,      0,      0,      0,      0,      0};
+
+/*Loads CDF entries 8 to 15 of an alphabet of 14 to 16 symbols. The CDF of
+   14 symbols ends with the counter at entry 14, so entries 7 to 14 are loaded
+   instead and shifted down, leaving entry 15 at 0.*/
+static INLINE __m128i dec_load_cdf_hi(const AomCdfProb *cdf, int nsymbs) {
+    if (nsymbs == 14)
+        return _mm_srli_si128(_mm_loadu_si128((const __m128i *)(cdf + 7)), 2);
+    return _mm_loadu_si128((const __m128i *)(cdf + 8));
+}
+
+/*Adapts the 8 CDF entries c starting at entry i. Entries from the last symbol
+   on are returned unchanged, except for the counter which is incremented.*/
+static INLINE __m128i dec_update_cdf_sse2(__m128i c, int i, int val, int nsymbs, int rate,
+                                          int count) {
+    const __m128i idx   = _mm_add_epi16(_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7),
+                                      _mm_set1_epi16((int16_t)i));
+    const __m128i below = _mm_cmpgt_epi16(_mm_set1_epi16((int16_t)val), idx);
+    const __m128i keep  = _mm_cmpgt_epi16(idx, _mm_set1_epi16((int16_t)(nsymbs - 2)));
+    const __m128i above = _mm_xor_si128(below, _mm_set1_epi16(-1));
+    const __m128i up    = _mm_sub_epi16(_mm_set1_epi16((int16_t)0x8000), c);
+    __m128i d = _mm_or_si128(_mm_and_si128(below, up), _mm_and_si128(above, c));
+    d         = _mm_srl_epi16(d, _mm_cvtsi32_si128(rate));
+    d         = _mm_sub_epi16(_mm_xor_si128(d, above), above);
+    d         = _mm_andnot_si128(keep, d);
+    d         = _mm_sub_epi16(d,
+                      _mm_and_si128(_mm_cmpeq_epi16(idx, _mm_set1_epi16((int16_t)nsymbs)),
+                                    _mm_set1_epi16((int16_t)-(count < 32))));
+    return _mm_add_epi16(c, d);
+}
+#endif
+
 static INLINE void dec_update_cdf(AomCdfProb *cdf, int8_t val, int nsymbs) {
     int rate;
-    int i, tmp;
+    int i;
 
     static const int nsymbs2speed[17] = {0, 0, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
     assert(nsymbs < 17);
     rate = 3 + (cdf[nsymbs] > 15) + (cdf[nsymbs] > 31) + nsymbs2speed[nsymbs]; // + get_msb(nsymbs);
-    tmp  = AOM_ICDF(0);
-
-    // Single loop (faster)
-    for (i = 0; i < nsymbs - 1; ++i) {
-        tmp = (i == val) ? 0 : tmp;
-        if (tmp < cdf[i]) {
-            cdf[i] -= (AomCdfProb)((cdf[i] - tmp) >> rate);
-        } else
-            cdf[i] += (AomCdfProb)((tmp - cdf[i]) >> rate);
+#ifdef ARCH_X86_64
+    /*The CDFs the symbol search loads as vectors are written back as vectors,
+       so the next search of the same CDF reads them straight from the store
+       buffer rather than stall on several narrow stores.*/
+    if (nsymbs > 13) {
+        const int     count = cdf[nsymbs];
+        const __m128i lo    = dec_update_cdf_sse2(
+            _mm_loadu_si128((const __m128i *)cdf), 0, val, nsymbs, rate, count);
+        const __m128i hi = dec_update_cdf_sse2(
+            dec_load_cdf_hi(cdf, nsymbs), 8, val, nsymbs, rate, count);
+        _mm_storeu_si128((__m128i *)cdf, lo);
+        if (nsymbs == 14)
+            _mm_storeu_si128((__m128i *)(cdf + 7),
+                             _mm_or_si128(_mm_slli_si128(hi, 2), _mm_srli_si128(lo, 14)));
+        else
+            _mm_storeu_si128((__m128i *)(cdf + 8), hi);
+        if (nsymbs == 16)
+            cdf[nsymbs] += (cdf[nsymbs] < 32);
+        return;
     }
+#endif
+    // Entries below val move up towards 32768, the others down towards 0
+    for (i = 0; i < val; ++i) cdf[i] += (AomCdfProb)((AOM_ICDF(0) - cdf[i]) >> rate);
+    for (; i < nsymbs - 1; ++i) cdf[i] -= (AomCdfProb)(cdf[i] >> rate);
     cdf[nsymbs] += (cdf[nsymbs] < 32);
 }
 
@@ -119,7 +185,7 @@ typedef struct OdEcDec {
     As we shift up during renormalization, if we don't have enough bits left in
     the window to fill the top 16, we'll read in more bits of the coded
     value.*/
-    OdEcWindow dif;
+    DecEcWindow dif;
     /*The number of values in the current range.*/
     uint16_t rng;
     /*The number of bits of data in the current value.*/
@@ -136,7 +202,7 @@ static void od_ec_dec_refill(OdEcDec *dec);
   ret: The value to return.
   Return: ret.
           This allows the compiler to jump to this function via a tail-call.*/
-static int od_ec_dec_normalize(OdEcDec *dec, OdEcWindow dif, unsigned rng, int ret) {
+static int od_ec_dec_normalize(OdEcDec *dec, DecEcWindow dif, unsigned rng, int ret) {
     int d;
     assert(rng <= 65535U);
     /*The number of leading zeros in the 16-bit binary representation of rng.*/
@@ -155,21 +221,21 @@ static int od_ec_dec_normalize(OdEcDec *dec, OdEcWindow dif, unsigned rng, int r
   f: The probability that the bit is one, scaled by 32768.
   Return: The value decoded (0 or 1).*/
 static int od_ec_decode_bool_q15(OdEcDec *dec, unsigned f) {
-    OdEcWindow dif;
-    OdEcWindow vw;
-    unsigned   r;
-    unsigned   r_new;
-    unsigned   v;
-    int        ret;
+    DecEcWindow dif;
+    DecEcWindow vw;
+    unsigned    r;
+    unsigned    r_new;
+    unsigned    v;
+    int         ret;
     assert(0 < f);
     assert(f < 32768U);
     dif = dec->dif;
     r   = dec->rng;
-    assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+    assert(dif >> (DEC_EC_WINDOW_SIZE - 16) < r);
     assert(32768U <= r);
     v = ((r >> 8) * (uint32_t)(f >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT));
     v += EC_MIN_PROB;
-    vw    = (OdEcWindow)v << (OD_EC_WINDOW_SIZE - 16);
+    vw    = (DecEcWindow)v << (DEC_EC_WINDOW_SIZE - 16);
     ret   = 1;
     r_new = v;
     if (dif >= vw) {
@@ -180,6 +246,25 @@ static int od_ec_decode_bool_q15(OdEcDec *dec, unsigned f) {
     return od_ec_dec_normalize(dec, dif, r_new, ret);
 }
 
+#ifdef ARCH_X86_64
+/*Computes the (non-increasing) interval bounds of 8 symbols starting at
+   symbol i, stores them to v_out and returns a mask with 2 bits set for each
+   symbol whose bound is above c.*/
+static INLINE int od_ec_cdf_bounds_sse2(__m128i icdf, __m128i r_hi, __m128i c_s,
+                                        const uint16_t *min_prob, const uint16_t *mask,
+                                        uint16_t *v_out) {
+    /*((r >> 8) * (icdf >> EC_PROB_SHIFT) >> 1) as the high half of a 16x16
+       multiply of (r >> 8) << 8 by (icdf >> EC_PROB_SHIFT) << 7.*/
+    __m128i v = _mm_mulhi_epu16(_mm_slli_epi16(_mm_srli_epi16(icdf, EC_PROB_SHIFT), 7), r_hi);
+    v         = _mm_add_epi16(v, _mm_loadu_si128((const __m128i *)min_prob));
+    v         = _mm_and_si128(v, _mm_loadu_si128((const __m128i *)mask));
+    _mm_storeu_si128((__m128i *)v_out, v);
+    /*Unsigned c < v as a signed compare with the sign bits flipped.*/
+    v = _mm_xor_si128(v, _mm_set1_epi16((int16_t)0x8000));
+    return _mm_movemask_epi8(_mm_cmpgt_epi16(v, c_s));
+}
+#endif
+
 /*Decodes a symbol given an inverse cumulative distribution function (CDF)
    table in Q15.
   icdf: CDF_PROB_TOP minus the CDF, such that symbol s falls in the range
@@ -190,34 +275,68 @@ static int od_ec_decode_bool_q15(OdEcDec *dec, unsigned f) {
          This should be at most 16.
   Return: The decoded symbol s.*/
 static int od_ec_decode_cdf_q15(OdEcDec *dec, const uint16_t *icdf, int nsyms) {
-    OdEcWindow dif;
-    unsigned   r;
-    unsigned   c;
-    unsigned   u;
-    unsigned   v;
-    int        ret;
-    (void)nsyms;
+    DecEcWindow dif;
+    unsigned    r;
+    unsigned    c;
+    unsigned    u;
+    unsigned    v;
+    int         ret;
     dif         = dec->dif;
     r           = dec->rng;
     const int N = nsyms - 1;
 
-    assert(dif >> (OD_EC_WINDOW_SIZE - 16) < r);
+    assert(dif >> (DEC_EC_WINDOW_SIZE - 16) < r);
     assert(icdf[nsyms - 1] == OD_ICDF(CDF_PROB_TOP));
     assert(32768U <= r);
     assert(7 - EC_PROB_SHIFT - CDF_SHIFT >= 0);
-    c   = (unsigned)(dif >> (OD_EC_WINDOW_SIZE - 16));
-    v   = r;
-    ret = -1;
-    do {
-        u = v;
-        v = ((r >> 8) * (uint32_t)(icdf[++ret] >> EC_PROB_SHIFT) >>
-             (7 - EC_PROB_SHIFT - CDF_SHIFT));
-        v += EC_MIN_PROB * (N - ret);
-    } while (c < v);
+    /*A binary symbol is a bool with probability icdf[0], whose interval bound
+       works out the same.*/
+    if (nsyms == 2)
+        return od_ec_decode_bool_q15(dec, icdf[0]);
+    c = (unsigned)(dif >> (DEC_EC_WINDOW_SIZE - 16));
+#ifdef ARCH_X86_64
+    /*Most symbols are decided within the first few bounds, which the search
+       loop gets to quicker than the vector setup; only the largest alphabets
+       gain from computing them all at once.*/
+    if (nsyms > 13) {
+        /*All the interval bounds are computed at once and the symbol is the
+           number of bounds above c, as the bounds are decreasing.
+          The lanes past the CDF are masked off.*/
+        DECLARE_ALIGNED(16, uint16_t, bounds[16]);
+        const __m128i   r_hi     = _mm_set1_epi16((int16_t)(r & 0xff00));
+        const __m128i   c_s      = _mm_set1_epi16((int16_t)(c ^ 0x8000));
+        const uint16_t *min_prob = od_ec_min_prob + 15 - N;
+        const uint16_t *mask     = od_ec_lane_mask + 15 - N;
+        uint32_t        gt = od_ec_cdf_bounds_sse2(
+            _mm_loadu_si128((const __m128i *)icdf), r_hi, c_s, min_prob, mask, bounds);
+        gt |= (uint32_t)od_ec_cdf_bounds_sse2(dec_load_cdf_hi(icdf, nsyms),
+                                              r_hi,
+                                              c_s,
+                                              min_prob + 8,
+                                              mask + 8,
+                                              bounds + 8)
+            << 16;
+        /*The bound of the last symbol is 0, so at most 2 * N bits are set and
+           the shift cannot overflow.*/
+        ret = get_msb((gt << 1) | 1) >> 1;
+        u   = ret ? bounds[ret - 1] : r;
+        v   = bounds[ret];
+    } else
+#endif
+    {
+        v   = r;
+        ret = -1;
+        do {
+            u = v;
+            v = ((r >> 8) * (uint32_t)(icdf[++ret] >> EC_PROB_SHIFT) >>
+                 (7 - EC_PROB_SHIFT - CDF_SHIFT));
+            v += EC_MIN_PROB * (N - ret);
+        } while (c < v);
+    }
     assert(v < u);
     assert(u <= r);
     r = u - v;
-    dif -= (OdEcWindow)v << (OD_EC_WINDOW_SIZE - 16);
+    dif -= (DecEcWindow)v << (DEC_EC_WINDOW_SIZE - 16);
     return od_ec_dec_normalize(dec, dif, r, ret);
 }
 
@@ -236,7 +355,7 @@ static int od_ec_decode_cdf_q15(OdEcDec *dec, const uint16_t *icdf, int nsyms) {
    call.*/
 static void od_ec_dec_refill(OdEcDec *dec) {
     int                  s;
-    OdEcWindow           dif;
+    DecEcWindow          dif;
     int16_t              cnt;
     const unsigned char *bptr;
     const unsigned char *end;
@@ -244,13 +363,28 @@ static void od_ec_dec_refill(OdEcDec *dec) {
     cnt  = dec->cnt;
     bptr = dec->bptr;
     end  = dec->end;
-    s    = OD_EC_WINDOW_SIZE - 9 - (cnt + 15);
+    s    = DEC_EC_WINDOW_SIZE - 9 - (cnt + 15);
+    if (end - bptr >= 8) {
+        /*Insert the (s >> 3) + 1 bytes the loop below would, from one big-endian
+           load.*/
+        const int         n     = (s >> 3) + 1;
+        const DecEcWindow bytes = ((DecEcWindow)bptr[0] << 56) | ((DecEcWindow)bptr[1] << 48) |
+            ((DecEcWindow)bptr[2] << 40) | ((DecEcWindow)bptr[3] << 32) |
+            ((DecEcWindow)bptr[4] << 24) | ((DecEcWindow)bptr[5] << 16) |
+            ((DecEcWindow)bptr[6] << 8) | (DecEcWindow)bptr[7];
+        assert(s >= 0 && s <= DEC_EC_WINDOW_SIZE - 8);
+        dif ^= bytes >> (DEC_EC_WINDOW_SIZE - 8 * n) << (s & 7);
+        dec->dif  = dif;
+        dec->cnt  = cnt + 8 * n;
+        dec->bptr = bptr + n;
+        return;
+    }
     for (; s >= 0 && bptr < end; s -= 8, bptr++) {
         /*Each time a byte is inserted into the window (dif), bptr advances and cnt
        is incremented by 8, so the total number of consumed bits (the return
        value of od_ec_dec_tell) does not change.*/
-        assert(s <= OD_EC_WINDOW_SIZE - 8);
-        dif ^= (OdEcWindow)bptr[0] << s;
+        assert(s <= DEC_EC_WINDOW_SIZE - 8);
+        dif ^= (DecEcWindow)bptr[0] << s;
         cnt += 8;
     }
     if (bptr >= end) {
@@ -278,10 +412,10 @@ static void od_ec_dec_refill(OdEcDec *dec) {
   storage: The size in bytes of the input buffer.*/
 static void od_ec_dec_init(OdEcDec *dec, const unsigned char *buf, uint32_t storage) {
     dec->buf       = buf;
-    dec->tell_offs = 10 - (OD_EC_WINDOW_SIZE - 8);
+    dec->tell_offs = 10 - (DEC_EC_WINDOW_SIZE - 8);
     dec->end       = buf + storage;
     dec->bptr      = buf;
-    dec->dif       = ((OdEcWindow)1 << (OD_EC_WINDOW_SIZE - 1)) - 1;
+    dec->dif       = ((DecEcWindow)1 << (DEC_EC_WINDOW_SIZE - 1)) - 1;
     dec->rng       = 0x8000;
     dec->cnt       = -15;
     od_ec_dec_refill(dec);
@@ -426,6 +426,7 @@ void svt_cdef_block(EbDecHandle *dec_handle, int32_t *mi_wide_l2, int32_t *mi_hi
                                sub_y,
                                dir,
                                NULL,
+                               0,
                                var,
                                pli,
                                dlist,
@@ -447,6 +448,7 @@ void svt_cdef_block(EbDecHandle *dec_handle, int32_t *mi_wide_l2, int32_t *mi_hi
                                sub_y,
                                dir,
                                NULL,
+                               0,
                                var,
                                pli,
                                dlist,
@@ -79,6 +79,11 @@ void        asm_set_convolve_hbd_asm_table(void);
 void        init_intra_predictors_internal(void);
 extern void svt_av1_init_wedge_masks(void);
 void        dec_sync_all_threads(EbDecHandle *dec_handle_ptr);
+void        dec_add_film_grain_mt(EbDecHandle *dec_handle, AomFilmGrain *film_grain_ptr,
+                                  uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t height,
+                                  int32_t width, int32_t luma_stride, int32_t chroma_stride,
+                                  int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+                                  int32_t chroma_subsamp_x);
 
 EbErrorType decode_multiple_obu(EbDecHandle *dec_handle_ptr, uint8_t **data, size_t data_size,
                                 uint32_t is_annexb);
@@ -119,6 +124,8 @@ static EbErrorType svt_dec_handle_ctor(EbDecHandle **   decHandleDblPtr,
     svt_dec_lib_malloc_count = 0;
 
     dec_handle_ptr->start_thread_process = EB_FALSE;
+    dec_handle_ptr->pv_pic_mgr           = NULL;
+    memset(&dec_handle_ptr->ext_out_img, 0, sizeof(EbSvtIOFormat));
     memory_map_start_address             = NULL;
     memory_map_end_address               = NULL;
 
@@ -391,23 +398,102 @@ int svt_dec_out_buf(EbDecHandle *dec_handle_ptr, EbBufferHeaderType *p_buffer) {
             default: assert(0);
             }
             copy_even(luma, wd, ht, out_img->y_stride, use_high_bit_depth);
-            svt_av1_add_film_grain_run(film_grain_ptr,
-                                       luma,
-                                       cb,
-                                       cr,
-                                       even_h, /*(ht & 1 ? ht + 1 : ht),*/
-                                       even_w, /*(wd & 1 ? wd + 1 : ht),*/
-                                       out_img->y_stride,
-                                       out_img->cb_stride,
-                                       use_high_bit_depth,
-                                       sy,
-                                       sx);
+            if (dec_handle_ptr->dec_config.threads > 1)
+                dec_add_film_grain_mt(dec_handle_ptr,
+                                      film_grain_ptr,
+                                      luma,
+                                      cb,
+                                      cr,
+                                      even_h,
+                                      even_w,
+                                      out_img->y_stride,
+                                      out_img->cb_stride,
+                                      use_high_bit_depth,
+                                      sy,
+                                      sx);
+            else
+                svt_av1_add_film_grain_run(film_grain_ptr,
+                                           luma,
+                                           cb,
+                                           cr,
+                                           even_h, /*(ht & 1 ? ht + 1 : ht),*/
+                                           even_w, /*(wd & 1 ? wd + 1 : ht),*/
+                                           out_img->y_stride,
+                                           out_img->cb_stride,
+                                           use_high_bit_depth,
+                                           sy,
+                                           sx);
         }
     }
 
     return 1;
 }
 
+/* Point the output at the recon buffer held in application memory.
+ * Falls back to a decoder owned copy when the output samples differ from
+ * the reference ones (film grain, 8-bit output of the 16-bit pipeline). */
+static int svt_dec_out_ext_buf(EbDecHandle *dec_handle_ptr, EbBufferHeaderType *p_buffer) {
+    EbPictureBufferDesc *recon_picture_buf = dec_handle_ptr->cur_pic_buf[0]->ps_pic_buf;
+    EbSvtIOFormat *      out_img           = (EbSvtIOFormat *)p_buffer->p_buffer;
+    AomFilmGrain *       film_grain_ptr    = &dec_handle_ptr->cur_pic_buf[0]->film_grain_params;
+
+    if (0 == dec_handle_ptr->show_frame)
+        return 0;
+
+    if ((!dec_handle_ptr->dec_config.skip_film_grain && film_grain_ptr->apply_grain) ||
+        (recon_picture_buf->bit_depth == EB_8BIT && dec_handle_ptr->is_16bit_pipeline)) {
+        EbSvtIOFormat *    copy_img    = &dec_handle_ptr->ext_out_img;
+        EbBufferHeaderType copy_buffer = *p_buffer;
+        copy_img->bit_depth            = (EbBitDepth)recon_picture_buf->bit_depth;
+        copy_buffer.p_buffer           = (uint8_t *)copy_img;
+        if (0 == svt_dec_out_buf(dec_handle_ptr, &copy_buffer))
+            return 0;
+        *out_img = *copy_img;
+        return 1;
+    }
+
+    uint32_t wd = dec_handle_ptr->frame_header.frame_size.superres_upscaled_width;
+    uint32_t ht = dec_handle_ptr->frame_header.frame_size.frame_height;
+    int32_t  use_high_bit_depth = recon_picture_buf->bit_depth == EB_8BIT ? 0 : 1;
+    int      sx = 0, sy = 0;
+    switch (recon_picture_buf->color_format) {
+    case EB_YUV400: break;
+    case EB_YUV420: sx = sy = 1; break;
+    case EB_YUV422: sx = 1; break;
+    case EB_YUV444: break;
+    default: SVT_LOG("Unsupported colour format. \n"); return 0;
+    }
+
+    out_img->width     = wd;
+    out_img->height    = ht;
+    out_img->origin_x  = 0;
+    out_img->origin_y  = 0;
+    out_img->color_fmt = recon_picture_buf->color_format;
+    out_img->bit_depth = (EbBitDepth)recon_picture_buf->bit_depth;
+    out_img->y_stride  = recon_picture_buf->stride_y;
+    out_img->luma      = recon_picture_buf->buffer_y +
+        ((recon_picture_buf->origin_x + recon_picture_buf->origin_y * recon_picture_buf->stride_y)
+         << use_high_bit_depth);
+    if (recon_picture_buf->color_format == EB_YUV400) {
+        out_img->cb_stride = INT32_MAX;
+        out_img->cr_stride = INT32_MAX;
+        out_img->cb        = NULL;
+        out_img->cr        = NULL;
+    } else {
+        out_img->cb_stride = recon_picture_buf->stride_cb;
+        out_img->cr_stride = recon_picture_buf->stride_cr;
+        out_img->cb        = recon_picture_buf->buffer_cb +
+            (((recon_picture_buf->origin_x >> sx) +
+              (recon_picture_buf->origin_y >> sy) * recon_picture_buf->stride_cb)
+             << use_high_bit_depth);
+        out_img->cr = recon_picture_buf->buffer_cr +
+            (((recon_picture_buf->origin_x >> sx) +
+              (recon_picture_buf->origin_y >> sy) * recon_picture_buf->stride_cr)
+             << use_high_bit_depth);
+    }
+    return 1;
+}
+
 /**********************************
 Set Default Library Params
 **********************************/
@@ -437,6 +523,11 @@ EbErrorType svt_svt_dec_set_default_parameter(EbSvtAv1DecConfiguration *config_p
     config_ptr->active_channel_count = 1;
     config_ptr->stat_report          = 0;
 
+    /* External frame buffers */
+    config_ptr->get_frame_buffer     = NULL;
+    config_ptr->release_frame_buffer = NULL;
+    config_ptr->frame_buffer_priv    = NULL;
+
     /* Multi-thread parameters */
     config_ptr->threads      = 1;
     config_ptr->num_p_frames = 1;
@@ -520,6 +611,9 @@ EB_API EbErrorType svt_av1_dec_set_parameter(EbComponentType *         svt_dec_c
 
     EbDecHandle *dec_handle_ptr = (EbDecHandle *)svt_dec_component->p_component_private;
 
+    if ((config_struct->get_frame_buffer == NULL) != (config_struct->release_frame_buffer == NULL))
+        return EB_ErrorBadParameter;
+
     dec_handle_ptr->dec_config        = *config_struct;
     dec_handle_ptr->is_16bit_pipeline = config_struct->is_16bit_pipeline;
 
@@ -629,8 +723,12 @@ EB_API EbErrorType svt_av1_dec_get_picture(EbComponentType *   svt_dec_component
         return EB_ErrorBadParameter;
 
     EbDecHandle *dec_handle_ptr = (EbDecHandle *)svt_dec_component->p_component_private;
+    if (dec_handle_ptr->dec_config.get_frame_buffer) {
+        if (0 == svt_dec_out_ext_buf(dec_handle_ptr, p_buffer))
+            return_error = EB_DecNoOutputPicture;
+    }
     /* Copy from recon pointer and return! TODO: Should remove the svt_memcpy! */
-    if (0 == svt_dec_out_buf(dec_handle_ptr, p_buffer))
+    else if (0 == svt_dec_out_buf(dec_handle_ptr, p_buffer))
         return_error = EB_DecNoOutputPicture;
     return return_error;
 }
@@ -645,6 +743,13 @@ EB_API EbErrorType svt_av1_dec_deinit(EbComponentType *svt_dec_component) {
         return EB_ErrorNone;
     if (dec_handle_ptr->dec_config.threads > 1)
         dec_sync_all_threads(dec_handle_ptr);
+
+    dec_pic_mgr_release_ext_bufs(dec_handle_ptr);
+    free(dec_handle_ptr->ext_out_img.luma);
+    free(dec_handle_ptr->ext_out_img.cb);
+    free(dec_handle_ptr->ext_out_img.cr);
+    memset(&dec_handle_ptr->ext_out_img, 0, sizeof(EbSvtIOFormat));
+
     if (!svt_dec_memory_map)
         return EB_ErrorNone;
 
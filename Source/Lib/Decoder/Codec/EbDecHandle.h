@@ -61,6 +61,10 @@ typedef struct EbDecPicBuf {
 
     EbPictureBufferDesc *ps_pic_buf;
 
+    /* Application memory holding the planes of ps_pic_buf, when external
+     * frame buffers are in use */
+    EbExtFrameBuf ext_frame_buf;
+
     FRAME_CONTEXT final_frm_ctx;
 
     GlobalMotionParams global_motion[REF_FRAMES];
@@ -247,6 +251,10 @@ typedef struct EbDecHandle {
 
     EbBool
         is_16bit_pipeline; // internal bit-depth: when equals 1 internal bit-depth is 16bits regardless of the input bit-depth
+
+    /* Decoder owned output copy, used with external frame buffers when the
+     * output can't point into the reference picture */
+    EbSvtIOFormat ext_out_img;
 } EbDecHandle;
 
 /* Thread level context data */
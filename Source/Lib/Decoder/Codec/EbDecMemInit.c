@@ -46,8 +46,11 @@
 EbErrorType dec_eb_recon_picture_buffer_desc_ctor(
     EbPtr  *object_dbl_ptr,
     EbPtr   object_init_data_ptr,
-    EbBool is_16bit_pipeline /* can be removed as an extra argument once
+    EbBool is_16bit_pipeline, /* can be removed as an extra argument once
                                 EbPictureBufferDescInitData adds the support for this */
+    const EbSvtAv1DecConfiguration *dec_config,
+    EbExtFrameBuf *ext_frame_buf /* planes are carved out of an application buffer
+                                    when the frame buffer callbacks are set */
 )
 {
     EbPictureBufferDesc          *picture_buffer_desc_ptr;
@@ -102,6 +105,46 @@ EbErrorType dec_eb_recon_picture_buffer_desc_ctor(
     picture_buffer_desc_ptr->stride_bit_inc_cb = 0;
     picture_buffer_desc_ptr->stride_bit_inc_cr = 0;
 
+    if (dec_config->get_frame_buffer) {
+        uint32_t luma_bytes = ALIGN_POWER_OF_TWO(picture_buffer_desc_ptr->luma_size * bytes_per_pixel, 6);
+        uint32_t chroma_bytes = ALIGN_POWER_OF_TWO(picture_buffer_desc_ptr->chroma_size * bytes_per_pixel, 6);
+        uint32_t buf_size = ALVALUE;
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG)
+            buf_size += luma_bytes;
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG)
+            buf_size += chroma_bytes;
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cr_FLAG)
+            buf_size += chroma_bytes;
+
+        ext_frame_buf->buffer = NULL;
+        ext_frame_buf->buffer_size = 0;
+        if (dec_config->get_frame_buffer(ext_frame_buf, buf_size, dec_config->frame_buffer_priv) ||
+            ext_frame_buf->buffer == NULL || ext_frame_buf->buffer_size < buf_size) {
+            if (ext_frame_buf->buffer)
+                dec_config->release_frame_buffer(ext_frame_buf, dec_config->frame_buffer_priv);
+            ext_frame_buf->buffer = NULL;
+            return EB_ErrorInsufficientResources;
+        }
+        memset(ext_frame_buf->buffer, 0, buf_size);
+
+        // Carve the planes out of the application buffer, keeping each one aligned
+        EbByte buf = (EbByte)ALIGN_POWER_OF_TWO((uintptr_t)ext_frame_buf->buffer, 6);
+        picture_buffer_desc_ptr->buffer_y = 0;
+        picture_buffer_desc_ptr->buffer_cb = 0;
+        picture_buffer_desc_ptr->buffer_cr = 0;
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
+            picture_buffer_desc_ptr->buffer_y = buf;
+            buf += luma_bytes;
+        }
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cb_FLAG) {
+            picture_buffer_desc_ptr->buffer_cb = buf;
+            buf += chroma_bytes;
+        }
+        if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Cr_FLAG)
+            picture_buffer_desc_ptr->buffer_cr = buf;
+        return EB_ErrorNone;
+    }
+
     // Allocate the Picture Buffers (luma & chroma)
     if (picture_buffer_desc_init_data_ptr->buffer_enable_mask & PICTURE_BUFFER_DESC_Y_FLAG) {
         EB_ALLIGN_MALLOC_DEC(EbByte, picture_buffer_desc_ptr->buffer_y, picture_buffer_desc_ptr->luma_size * bytes_per_pixel, EB_A_PTR);
@@ -39,6 +39,8 @@ FILE *temp_fp;
 int   enable_dump;
 #endif
 
+void dec_film_grain_stripes_mt(EbDecHandle *dec_handle);
+
 #define READ_REF_BIT(pname) svt_read_symbol(r, get_pred_cdf_##pname(pi), 2, ACCT_STR)
 #define SQR_BLOCK_SIZES 6
 
@@ -986,9 +988,13 @@ void svt_setup_motion_field(EbDecHandle *dec_handle, DecThreadCtxt *thread_ctxt)
     if (is_mt) {
         volatile EbBool *start_motion_proj = &dec_mt_frame_data->start_motion_proj;
 
-        while (*start_motion_proj != EB_TRUE)
+        while (*start_motion_proj != EB_TRUE) {
             svt_block_on_semaphore(NULL == thread_ctxt ? dec_handle->thread_semaphore
                                                        : thread_ctxt->thread_semaphore);
+            /* Lib threads help with the film grain of the output picture */
+            if (NULL != thread_ctxt)
+                dec_film_grain_stripes_mt(dec_handle);
+        }
 
         DecMtMotionProjInfo *motion_proj_info = &dec_mt_frame_data->motion_proj_info;
         do_memset                             = EB_FALSE;
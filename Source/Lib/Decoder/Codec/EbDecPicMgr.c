@@ -68,6 +68,7 @@ EbErrorType dec_pic_mgr_init(EbDecHandle *dec_handle_ptr) {
         ps_pic_mgr->as_dec_pic[i].size       = 0;
         ps_pic_mgr->as_dec_pic[i].ref_count  = 0;
         ps_pic_mgr->as_dec_pic[i].mvs        = NULL;
+        memset(&ps_pic_mgr->as_dec_pic[i].ext_frame_buf, 0, sizeof(EbExtFrameBuf));
         EB_MALLOC_DEC(
             uint8_t *, ps_pic_mgr->as_dec_pic[i].segment_maps, size * sizeof(uint8_t), EB_N_PTR);
         memset(ps_pic_mgr->as_dec_pic[i].segment_maps, 0, size);
@@ -156,10 +157,20 @@ EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr) {
 
         input_pic_buf_desc_init_data.split_mode = EB_FALSE;
 
+        /* Hand the previous application buffer back before replacing it */
+        EbSvtAv1DecConfiguration *dec_config = &dec_handle_ptr->dec_config;
+        if (ps_pic_mgr->as_dec_pic[i].ext_frame_buf.buffer != NULL) {
+            dec_config->release_frame_buffer(&ps_pic_mgr->as_dec_pic[i].ext_frame_buf,
+                                             dec_config->frame_buffer_priv);
+            ps_pic_mgr->as_dec_pic[i].ext_frame_buf.buffer = NULL;
+        }
+
         EbErrorType return_error = dec_eb_recon_picture_buffer_desc_ctor(
             (EbPtr *)&(ps_pic_mgr->as_dec_pic[i].ps_pic_buf),
             (EbPtr)&input_pic_buf_desc_init_data,
-            dec_handle_ptr->is_16bit_pipeline);
+            dec_handle_ptr->is_16bit_pipeline,
+            dec_config,
+            &ps_pic_mgr->as_dec_pic[i].ext_frame_buf);
 
         if (return_error != EB_ErrorNone)
             return NULL;
@@ -183,6 +194,41 @@ EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr) {
     return pic_buf;
 }
 
+/**
+*******************************************************************************
+*
+* @brief
+*  Release external frame buffers
+*
+* @par Description:
+*  Hands every application frame buffer held by the pool back through the
+*  release callback
+*
+* @param[in] dec_handle_ptr
+*  Pointer to the decoder handle
+*
+* @returns
+*
+* @remarks
+*
+*******************************************************************************
+*/
+
+void dec_pic_mgr_release_ext_bufs(EbDecHandle *dec_handle_ptr) {
+    EbDecPicMgr *             ps_pic_mgr = (EbDecPicMgr *)dec_handle_ptr->pv_pic_mgr;
+    EbSvtAv1DecConfiguration *dec_config = &dec_handle_ptr->dec_config;
+
+    if (ps_pic_mgr == NULL || dec_config->release_frame_buffer == NULL)
+        return;
+    for (int32_t i = 0; i < MAX_PIC_BUFS; i++) {
+        EbExtFrameBuf *ext_frame_buf = &ps_pic_mgr->as_dec_pic[i].ext_frame_buf;
+        if (ext_frame_buf->buffer != NULL) {
+            dec_config->release_frame_buffer(ext_frame_buf, dec_config->frame_buffer_priv);
+            ext_frame_buf->buffer = NULL;
+        }
+    }
+}
+
 static INLINE void dec_ref_count_and_rel(EbDecPicBuf *ps_pic_buf) {
     if (ps_pic_buf != NULL) {
         ps_pic_buf->ref_count--;
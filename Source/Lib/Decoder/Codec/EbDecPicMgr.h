@@ -37,6 +37,8 @@ EbErrorType dec_pic_mgr_init(EbDecHandle *dec_handle_ptr);
 
 EbDecPicBuf *dec_pic_mgr_get_cur_pic(EbDecHandle *dec_handle_ptr);
 
+void dec_pic_mgr_release_ext_bufs(EbDecHandle *dec_handle_ptr);
+
 void dec_pic_mgr_update_ref_pic(EbDecHandle *dec_handle_ptr, int32_t frame_decoded,
                                 int32_t refresh_frame_flags);
 
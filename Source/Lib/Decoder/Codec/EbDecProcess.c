@@ -344,6 +344,15 @@ EbErrorType dec_system_resource_init(EbDecHandle *dec_handle_ptr, TilesInfo *til
     lr_sb_row_info->num_sb_rows       = picture_height_in_sb;
     lr_sb_row_info->sb_row_to_process = 0;
 
+    /* Film grain */
+    DecMtRowInfo *film_grain_row_info = &dec_mt_frame_data->film_grain_row_info;
+
+    EB_CREATE_MUTEX(film_grain_row_info->sbrow_mutex);
+
+    film_grain_row_info->num_sb_rows        = 0;
+    film_grain_row_info->sb_row_to_process  = 0;
+    dec_mt_frame_data->film_grain_rows_done = 0;
+
     dec_mt_frame_data->temp_mutex = svt_create_mutex();
 
     dec_mt_frame_data->start_motion_proj  = EB_FALSE;
@@ -1311,6 +1320,62 @@ void dec_av1_loop_restoration_filter_frame_mt(EbDecHandle *dec_handle, DecThread
         ;
 }
 
+/* Add film grain to the stripes of the output picture until none is left */
+void dec_film_grain_stripes_mt(EbDecHandle *dec_handle) {
+    DecMtFrameData *dec_mt_frame_data =
+        &dec_handle->main_frame_buf.cur_frame_bufs[0].dec_mt_frame_data;
+
+    int32_t stripe;
+    while ((stripe = get_sb_row_to_process(&dec_mt_frame_data->film_grain_row_info)) != -1) {
+        svt_av1_add_film_grain_stripe(&dec_mt_frame_data->film_grain_frame, stripe);
+
+        svt_block_on_mutex(dec_mt_frame_data->temp_mutex);
+        dec_mt_frame_data->film_grain_rows_done++;
+        svt_release_mutex(dec_mt_frame_data->temp_mutex);
+    }
+}
+
+/* Add film grain to the output picture with the lib threads, which are
+   idle between the LR of a frame and the motion projection of the next */
+void dec_add_film_grain_mt(EbDecHandle *dec_handle, AomFilmGrain *film_grain_ptr, uint8_t *luma,
+                           uint8_t *cb, uint8_t *cr, int32_t height, int32_t width,
+                           int32_t luma_stride, int32_t chroma_stride, int32_t use_high_bit_depth,
+                           int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+    DecMtFrameData *dec_mt_frame_data =
+        &dec_handle->main_frame_buf.cur_frame_bufs[0].dec_mt_frame_data;
+    DecMtRowInfo *film_grain_row_info = &dec_mt_frame_data->film_grain_row_info;
+
+    int32_t num_stripes = svt_av1_film_grain_frame_init(&dec_mt_frame_data->film_grain_frame,
+                                                        film_grain_ptr,
+                                                        luma,
+                                                        cb,
+                                                        cr,
+                                                        height,
+                                                        width,
+                                                        luma_stride,
+                                                        chroma_stride,
+                                                        use_high_bit_depth,
+                                                        chroma_subsamp_y,
+                                                        chroma_subsamp_x);
+    dec_mt_frame_data->film_grain_rows_done = 0;
+
+    svt_block_on_mutex(film_grain_row_info->sbrow_mutex);
+    film_grain_row_info->num_sb_rows       = num_stripes;
+    film_grain_row_info->sb_row_to_process = 0;
+    svt_release_mutex(film_grain_row_info->sbrow_mutex);
+
+    for (uint32_t lib_thrd = 0; lib_thrd < dec_handle->dec_config.threads - 1; lib_thrd++)
+        svt_post_semaphore(dec_handle->thread_ctxt_pa[lib_thrd].thread_semaphore);
+
+    dec_film_grain_stripes_mt(dec_handle);
+
+    volatile uint32_t *film_grain_rows_done = &dec_mt_frame_data->film_grain_rows_done;
+    while (*film_grain_rows_done != (uint32_t)num_stripes)
+        ;
+
+    svt_av1_film_grain_frame_free(&dec_mt_frame_data->film_grain_frame);
+}
+
 void *dec_all_stage_kernel(void *input_ptr) {
     // Context
     DecThreadCtxt * thread_ctxt    = (DecThreadCtxt *)input_ptr;
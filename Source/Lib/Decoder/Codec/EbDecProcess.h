@@ -17,6 +17,7 @@ extern "C" {
 #endif
 #include "EbDefinitions.h"
 #include "EbSystemResourceManager.h"
+#include "grainSynthesis.h"
 
 #define MT_WAIT_PROFILE 0
 
@@ -236,6 +237,12 @@ typedef struct DecMTFrameData {
     /* LR SB row level map for rows finished LR */
     uint32_t *lr_row_map;
 
+    /* Film grain stage : stripes of 32 luma rows of the output picture,
+       picked up by the lib threads waiting for the next frame */
+    FilmGrainFrame film_grain_frame;
+    DecMtRowInfo   film_grain_row_info;
+    uint32_t       film_grain_rows_done;
+
     PrevFrameMtCheck prev_frame_info;
 
     int32_t sb_cols;
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+ */
+
+#include <emmintrin.h> // SSE2
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+
+static INLINE uint32_t hadd_epi32_sse2(__m128i sum) {
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+    return (uint32_t)_mm_cvtsi128_si32(sum);
+}
+
+// The 16 bit lanes hold at most 8 samples of 10 bits
+static INLINE uint32_t hadd_epi16_sse2(const __m128i sum) {
+    return hadd_epi32_sse2(_mm_madd_epi16(sum, _mm_set1_epi16(1)));
+}
+
+static INLINE void ssim_parms_row_sse2(const __m128i s, const __m128i r, __m128i *sum_s,
+                                       __m128i *sum_r, __m128i *sum_sq_s, __m128i *sum_sq_r,
+                                       __m128i *sum_sxr) {
+    *sum_s    = _mm_add_epi16(*sum_s, s);
+    *sum_r    = _mm_add_epi16(*sum_r, r);
+    *sum_sq_s = _mm_add_epi32(*sum_sq_s, _mm_madd_epi16(s, s));
+    *sum_sq_r = _mm_add_epi32(*sum_sq_r, _mm_madd_epi16(r, r));
+    *sum_sxr  = _mm_add_epi32(*sum_sxr, _mm_madd_epi16(s, r));
+}
+
+void svt_aom_ssim_parms_8x8_sse2(const uint8_t *s, int sp, const uint8_t *r, int rp,
+                                 uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    const __m128i zero  = _mm_setzero_si128();
+    __m128i       s_sum = zero, r_sum = zero, ss_sum = zero, rr_sum = zero, sr_sum = zero;
+
+    for (int i = 0; i < 8; i++, s += sp, r += rp) {
+        const __m128i s16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)s), zero);
+        const __m128i r16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)r), zero);
+        ssim_parms_row_sse2(s16, r16, &s_sum, &r_sum, &ss_sum, &rr_sum, &sr_sum);
+    }
+
+    *sum_s += hadd_epi16_sse2(s_sum);
+    *sum_r += hadd_epi16_sse2(r_sum);
+    *sum_sq_s += hadd_epi32_sse2(ss_sum);
+    *sum_sq_r += hadd_epi32_sse2(rr_sum);
+    *sum_sxr += hadd_epi32_sse2(sr_sum);
+}
+
+void svt_aom_highbd_ssim_parms_8x8_sse2(const uint8_t *s, int sp, const uint8_t *sinc,
+                                        int spinc, const uint16_t *r, int rp, uint32_t *sum_s,
+                                        uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                                        uint32_t *sum_sxr) {
+    const __m128i zero  = _mm_setzero_si128();
+    __m128i       s_sum = zero, r_sum = zero, ss_sum = zero, rr_sum = zero, sr_sum = zero;
+
+    for (int i = 0; i < 8; i++, s += sp, sinc += spinc, r += rp) {
+        // 10 bit source: 8 msb from s, 2 lsb from the top of sinc
+        const __m128i s8   = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)s), zero);
+        const __m128i inc8 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)sinc), zero);
+        const __m128i s16  = _mm_add_epi16(_mm_slli_epi16(s8, 2), _mm_srli_epi16(inc8, 6));
+        const __m128i r16  = _mm_loadu_si128((const __m128i *)r);
+        ssim_parms_row_sse2(s16, r16, &s_sum, &r_sum, &ss_sum, &rr_sum, &sr_sum);
+    }
+
+    *sum_s += hadd_epi16_sse2(s_sum);
+    *sum_r += hadd_epi16_sse2(r_sum);
+    *sum_sq_s += hadd_epi32_sse2(ss_sum);
+    *sum_sq_r += hadd_epi32_sse2(rr_sum);
+    *sum_sxr += hadd_epi32_sse2(sr_sum);
+}
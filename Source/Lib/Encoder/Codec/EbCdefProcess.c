@@ -244,6 +244,7 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                                        ydec[pli],
                                        dir,
                                        &dirinit,
+                                       0,
                                        var,
                                        pli,
                                        dlist,
@@ -271,6 +272,9 @@ void cdef_seg_search(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
                     else
                         pcs_ptr->mse_seg[1][fbr * nhfb + fbc][gi] += curr_mse;
                 }
+                // The application filters with the directions of the search
+                if (pli == 0 && dirinit)
+                    svt_cdef_store_dirs(pcs_ptr, fbr, fbc, dlist, cdef_count, dir, var);
 
                 //if (ppcs->picture_number == 15)
                 //    SVT_LOG(" bs:%i count:%i  mse:%I64i\n", bs, cdef_count,pcs_ptr->mse_seg[0][fbr*nhfb + fbc][4]);
@@ -441,6 +445,7 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
                                        ydec[pli],
                                        dir,
                                        &dirinit,
+                                       0,
                                        var,
                                        pli,
                                        dlist,
@@ -468,15 +473,18 @@ void cdef_seg_search16bit(PictureControlSet *pcs_ptr, SequenceControlSet *scs_pt
                     else
                         pcs_ptr->mse_seg[1][fbr * nhfb + fbc][gi] += curr_mse;
                 }
+                // The application filters with the directions of the search
+                if (pli == 0 && dirinit)
+                    svt_cdef_store_dirs(pcs_ptr, fbr, fbc, dlist, cdef_count, dir, var);
             }
         }
     }
 }
 
 /******************************************************
- * CDEF Kernel
+ * CDEF Task
  ******************************************************/
-void *cdef_kernel(void *input_ptr) {
+void cdef_task(EbPtr input_ptr, EbObjectWrapper *dlf_results_wrapper_ptr) {
     // Context & SCS & PCS
     EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
     CdefContext *       context_ptr        = (CdefContext *)thread_context_ptr->priv;
@@ -484,7 +492,6 @@ void *cdef_kernel(void *input_ptr) {
     SequenceControlSet *scs_ptr;
 
     //// Input
-    EbObjectWrapper *dlf_results_wrapper_ptr;
     DlfResults *     dlf_results_ptr;
 
     //// Output
@@ -493,102 +500,125 @@ void *cdef_kernel(void *input_ptr) {
 
     // SB Loop variables
 
-    for (;;) {
-        FrameHeader *frm_hdr;
+    FrameHeader *frm_hdr;
 
-        // Get DLF Results
-        EB_GET_FULL_OBJECT(context_ptr->cdef_input_fifo_ptr, &dlf_results_wrapper_ptr);
+    dlf_results_ptr = (DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+    pcs_ptr         = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr         = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
 
-        dlf_results_ptr = (DlfResults *)dlf_results_wrapper_ptr->object_ptr;
-        pcs_ptr         = (PictureControlSet *)dlf_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr         = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbBool     is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    frm_hdr             = &pcs_ptr->parent_pcs_ptr->frm_hdr;
 
-        EbBool     is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common *cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
-        frm_hdr             = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
+        if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+            cdef_seg_search16bit(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
+        else
+            cdef_seg_search(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
+    }
 
-        if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-            if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                cdef_seg_search16bit(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
-            else
-                cdef_seg_search(pcs_ptr, scs_ptr, dlf_results_ptr->segment_index);
-        }
+    //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
+    svt_block_on_mutex(pcs_ptr->cdef_search_mutex);
 
-        //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
-        svt_block_on_mutex(pcs_ptr->cdef_search_mutex);
-
-        pcs_ptr->tot_seg_searched_cdef++;
-        if (pcs_ptr->tot_seg_searched_cdef == pcs_ptr->cdef_segments_total_count) {
-            // SVT_LOG("    CDEF all seg here  %i\n", pcs_ptr->picture_number);
-            if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-                int32_t selected_strength_cnt[64] = {0};
-                finish_cdef_search(0, pcs_ptr, selected_strength_cnt);
-
-                if (scs_ptr->seq_header.enable_restoration != 0 ||
-                    pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
-                    scs_ptr->static_config.recon_enabled) {
-                    if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                        av1_cdef_frame16bit(0, scs_ptr, pcs_ptr);
-                    else
-                        svt_av1_cdef_frame(0, scs_ptr, pcs_ptr);
-                }
-            } else {
-                frm_hdr->cdef_params.cdef_bits             = 0;
-                frm_hdr->cdef_params.cdef_y_strength[0]    = 0;
-                pcs_ptr->parent_pcs_ptr->nb_cdef_strengths = 1;
-                frm_hdr->cdef_params.cdef_uv_strength[0]   = 0;
+    pcs_ptr->tot_seg_searched_cdef++;
+    if (pcs_ptr->tot_seg_searched_cdef == pcs_ptr->cdef_segments_total_count) {
+        // SVT_LOG("    CDEF all seg here  %i\n", pcs_ptr->picture_number);
+        if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
+            int32_t selected_strength_cnt[64] = {0};
+            finish_cdef_search(0, pcs_ptr, selected_strength_cnt);
+
+            if (scs_ptr->seq_header.enable_restoration != 0 ||
+                pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
+                scs_ptr->static_config.recon_enabled) {
+                if (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+                    av1_cdef_frame16bit(0, scs_ptr, pcs_ptr);
+                else
+                    svt_av1_cdef_frame(0, scs_ptr, pcs_ptr);
             }
+        } else {
+            frm_hdr->cdef_params.cdef_bits             = 0;
+            frm_hdr->cdef_params.cdef_y_strength[0]    = 0;
+            pcs_ptr->parent_pcs_ptr->nb_cdef_strengths = 1;
+            frm_hdr->cdef_params.cdef_uv_strength[0]   = 0;
+        }
 
-            //restoration prep
-
-            if (scs_ptr->seq_header.enable_restoration) {
-                svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 1);
-
-                //are these still needed here?/!!!
-                svt_extend_frame(cm->frame_to_show->buffers[0],
-                                 cm->frame_to_show->crop_widths[0],
-                                 cm->frame_to_show->crop_heights[0],
-                                 cm->frame_to_show->strides[0],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-                svt_extend_frame(cm->frame_to_show->buffers[1],
-                                 cm->frame_to_show->crop_widths[1],
-                                 cm->frame_to_show->crop_heights[1],
-                                 cm->frame_to_show->strides[1],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-                svt_extend_frame(cm->frame_to_show->buffers[2],
-                                 cm->frame_to_show->crop_widths[1],
-                                 cm->frame_to_show->crop_heights[1],
-                                 cm->frame_to_show->strides[1],
-                                 RESTORATION_BORDER,
-                                 RESTORATION_BORDER,
-                                 scs_ptr->static_config.is_16bit_pipeline || is_16bit);
-            }
+        //restoration prep
+
+        if (scs_ptr->seq_header.enable_restoration) {
+            svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 1);
+
+            //are these still needed here?/!!!
+            svt_extend_frame(cm->frame_to_show->buffers[0],
+                             cm->frame_to_show->crop_widths[0],
+                             cm->frame_to_show->crop_heights[0],
+                             cm->frame_to_show->strides[0],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+            svt_extend_frame(cm->frame_to_show->buffers[1],
+                             cm->frame_to_show->crop_widths[1],
+                             cm->frame_to_show->crop_heights[1],
+                             cm->frame_to_show->strides[1],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+            svt_extend_frame(cm->frame_to_show->buffers[2],
+                             cm->frame_to_show->crop_widths[1],
+                             cm->frame_to_show->crop_heights[1],
+                             cm->frame_to_show->strides[1],
+                             RESTORATION_BORDER,
+                             RESTORATION_BORDER,
+                             scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+        }
 
-            pcs_ptr->rest_segments_column_count = scs_ptr->rest_segment_column_count;
-            pcs_ptr->rest_segments_row_count    = scs_ptr->rest_segment_row_count;
-            pcs_ptr->rest_segments_total_count  = (uint16_t)(pcs_ptr->rest_segments_column_count *
-                                                            pcs_ptr->rest_segments_row_count);
-            pcs_ptr->tot_seg_searched_rest      = 0;
-            uint32_t segment_index;
-            for (segment_index = 0; segment_index < pcs_ptr->rest_segments_total_count;
-                 ++segment_index) {
-                // Get Empty Cdef Results to Rest
-                svt_get_empty_object(context_ptr->cdef_output_fifo_ptr, &cdef_results_wrapper_ptr);
-                cdef_results_ptr = (struct CdefResults *)cdef_results_wrapper_ptr->object_ptr;
-                cdef_results_ptr->pcs_wrapper_ptr = dlf_results_ptr->pcs_wrapper_ptr;
-                cdef_results_ptr->segment_index   = segment_index;
-                // Post Cdef Results
-                svt_post_full_object(cdef_results_wrapper_ptr);
-            }
+        pcs_ptr->rest_segments_column_count = scs_ptr->rest_segment_column_count;
+        pcs_ptr->rest_segments_row_count    = scs_ptr->rest_segment_row_count;
+        pcs_ptr->rest_segments_total_count  = (uint16_t)(pcs_ptr->rest_segments_column_count *
+                                                        pcs_ptr->rest_segments_row_count);
+        pcs_ptr->tot_seg_searched_rest      = 0;
+        // The restoration filter is applied in bands of 64 luma rows stripes once the
+        // search is done; bands are posted after the search segments
+        const uint32_t stripe_cnt = (cm->frm_size.frame_height + RESTORATION_UNIT_OFFSET +
+                                     RESTORATION_PROC_UNIT_SIZE - 1) /
+            RESTORATION_PROC_UNIT_SIZE;
+        pcs_ptr->rest_bands_total_count = scs_ptr->seq_header.enable_restoration
+            ? (uint16_t)MAX(MIN(scs_ptr->rest_process_init_count, stripe_cnt), 1)
+            : 1;
+        pcs_ptr->tot_bands_filtered_rest = 0;
+        pcs_ptr->rest_search_done        = EB_FALSE;
+        pcs_ptr->rest_search_wait_count  = 0;
+        uint32_t segment_index;
+        for (segment_index = 0; segment_index < (uint32_t)pcs_ptr->rest_segments_total_count +
+                 pcs_ptr->rest_bands_total_count;
+             ++segment_index) {
+            // Get Empty Cdef Results to Rest
+            svt_get_empty_object(context_ptr->cdef_output_fifo_ptr, &cdef_results_wrapper_ptr);
+            cdef_results_ptr = (struct CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+            cdef_results_ptr->pcs_wrapper_ptr = dlf_results_ptr->pcs_wrapper_ptr;
+            cdef_results_ptr->segment_index   = segment_index;
+            // Post Cdef Results
+            svt_post_full_object(cdef_results_wrapper_ptr);
         }
-        svt_release_mutex(pcs_ptr->cdef_search_mutex);
+    }
+    svt_release_mutex(pcs_ptr->cdef_search_mutex);
+
+    // Release Dlf Results
+    svt_release_object(dlf_results_wrapper_ptr);
+}
+
+/******************************************************
+ * CDEF Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *cdef_kernel(void *input_ptr) {
+    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
+    CdefContext *       context_ptr        = (CdefContext *)thread_context_ptr->priv;
+    EbObjectWrapper *   dlf_results_wrapper_ptr;
 
-        // Release Dlf Results
-        svt_release_object(dlf_results_wrapper_ptr);
+    for (;;) {
+        // Get DLF Results
+        EB_GET_FULL_OBJECT(context_ptr->cdef_input_fifo_ptr, &dlf_results_wrapper_ptr);
+        cdef_task(input_ptr, dlf_results_wrapper_ptr);
     }
 
     return NULL;
@@ -751,6 +751,52 @@ void svt_av1_loop_filter_frame(EbPictureBufferDesc *frame_buffer, PictureControl
         }
     }
 }
+
+/* Deblock one SB row. Rows of the same picture may be filtered concurrently by
+ * several DLF threads: before filtering a SB, wait until the row above has been
+ * filtered past the top-right SB, since the horizontal edges of the current row
+ * read pixels that the vertical edges of the row above modify. The wait blocks
+ * on the semaphore of the row above, which is posted once per deblocked SB.
+ * svt_av1_loop_filter_frame_init() must have been called for the picture. */
+void svt_av1_loop_filter_sb_row(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                uint32_t y_sb_index, int32_t plane_start, int32_t plane_end) {
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)
+                                      pcs_ptr->parent_pcs_ptr->scs_wrapper_ptr->object_ptr;
+    uint8_t  sb_size_log2     = (uint8_t)svt_log2f(scs_ptr->sb_size_pix);
+    int32_t  pic_width_in_sb  = (int32_t)((pcs_ptr->parent_pcs_ptr->aligned_width +
+                                         scs_ptr->sb_size_pix - 1) /
+                                        scs_ptr->sb_size_pix);
+    uint32_t pic_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                 scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+    uint32_t sb_origin_y      = y_sb_index << sb_size_log2;
+    // Number of SBs of the row above known to be deblocked
+    int32_t sb_done_in_prev_row = 0;
+
+    for (int32_t x_sb_index = 0; x_sb_index < pic_width_in_sb; ++x_sb_index) {
+        uint32_t sb_origin_x     = x_sb_index << sb_size_log2;
+        EbBool   end_of_row_flag = (x_sb_index == pic_width_in_sb - 1) ? EB_TRUE : EB_FALSE;
+
+        /* Top-Right Sync */
+        if (y_sb_index) {
+            while (sb_done_in_prev_row <= MIN(x_sb_index + 2, pic_width_in_sb - 1)) {
+                svt_block_on_semaphore(pcs_ptr->dlf_sb_row_semaphore[y_sb_index - 1]);
+                sb_done_in_prev_row++;
+            }
+        }
+        loop_filter_sb(frame_buffer,
+                       pcs_ptr,
+                       NULL,
+                       sb_origin_y >> 2,
+                       sb_origin_x >> 2,
+                       plane_start,
+                       plane_end,
+                       end_of_row_flag);
+        /* Update Top-Right Sync */
+        if (y_sb_index < pic_height_in_sb - 1)
+            svt_post_semaphore(pcs_ptr->dlf_sb_row_semaphore[y_sb_index]);
+    }
+}
 extern int16_t svt_av1_ac_quant_q3(int32_t qindex, int32_t delta, AomBitDepth bit_depth);
 
 void svt_copy_buffer(EbPictureBufferDesc *srcBuffer, EbPictureBufferDesc *dstBuffer,
@@ -54,6 +54,9 @@ void svt_av1_loop_filter_frame(
         /*MacroBlockD *xd,*/ int32_t plane_start, int32_t plane_end/*,
         int32_t partial_frame*/);
 
+void svt_av1_loop_filter_sb_row(EbPictureBufferDesc *frame_buffer, PictureControlSet *pcs_ptr,
+                                uint32_t y_sb_index, int32_t plane_start, int32_t plane_end);
+
 void svt_av1_pick_filter_level(DlfContext *         context_ptr,
                                EbPictureBufferDesc *srcBuffer, // source input
                                PictureControlSet *pcs_ptr, LpfPickMethod method);
@@ -65,6 +65,7 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
 
     temp_lf_recon_desc_init_data.split_mode   = EB_FALSE;
     temp_lf_recon_desc_init_data.color_format = color_format;
+    temp_lf_recon_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
     if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
         temp_lf_recon_desc_init_data.bit_depth = EB_16BIT;
@@ -83,256 +84,336 @@ EbErrorType dlf_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHan
     return EB_ErrorNone;
 }
 
-/******************************************************
- * Dlf Kernel
- ******************************************************/
-void *dlf_kernel(void *input_ptr) {
-    // Context & SCS & PCS
-    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
-    DlfContext *        context_ptr        = (DlfContext *)thread_context_ptr->priv;
-    PictureControlSet * pcs_ptr;
-    SequenceControlSet *scs_ptr;
-
-    //// Input
-    EbObjectWrapper *enc_dec_results_wrapper_ptr;
-    EncDecResults *  enc_dec_results_ptr;
-
-    //// Output
-    EbObjectWrapper *  dlf_results_wrapper_ptr;
-    struct DlfResults *dlf_results_ptr;
-
-    // SB Loop variables
-    for (;;) {
-        // Get EncDec Results
-        EB_GET_FULL_OBJECT(context_ptr->dlf_input_fifo_ptr, &enc_dec_results_wrapper_ptr);
+static EbPictureBufferDesc *get_dlf_recon_buffer(PictureControlSet * pcs_ptr,
+                                                  SequenceControlSet *scs_ptr) {
+    EbBool is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+        return (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
+            ? ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                  ->reference_picture16bit
+            : ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                  ->reference_picture;
+    return (scs_ptr->static_config.is_16bit_pipeline || is_16bit) ? pcs_ptr->recon_picture16bit_ptr
+                                                                  : pcs_ptr->recon_picture_ptr;
+}
 
-        enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-        pcs_ptr             = (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr             = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-
-        EbBool is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-
-        if (scs_ptr->static_config.is_16bit_pipeline &&
-            scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
-            // //copy input from 8bit to 16bit
-            uint8_t *            input_8bit;
-            int32_t              input_stride_8bit;
-            uint16_t *           input_16bit;
-            int32_t              input_stride_16bit;
-            EbPictureBufferDesc *input_buffer_8bit =
-                (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-            EbPictureBufferDesc *input_buffer = (EbPictureBufferDesc *)pcs_ptr->input_frame16bit;
-            // Y
-            input_16bit = (uint16_t *)(input_buffer->buffer_y) + input_buffer->origin_x +
-                input_buffer->origin_y * input_buffer->stride_y;
-            input_stride_16bit = input_buffer->stride_y;
-            input_8bit         = input_buffer_8bit->buffer_y + input_buffer_8bit->origin_x +
-                input_buffer_8bit->origin_y * input_buffer_8bit->stride_y;
-            input_stride_8bit = input_buffer_8bit->stride_y;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width,
-                                      input_buffer->height);
-
-            // Cb
-            input_16bit = (uint16_t *)(input_buffer->buffer_cb) + input_buffer->origin_x / 2 +
-                input_buffer->origin_y / 2 * input_buffer->stride_cb;
-            input_stride_16bit = input_buffer->stride_cb;
-            input_8bit         = input_buffer_8bit->buffer_cb + input_buffer_8bit->origin_x / 2 +
-                input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cb;
-            input_stride_8bit = input_buffer_8bit->stride_cb;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width >> 1,
-                                      input_buffer->height >> 1);
-
-            // Cr
-            input_16bit = (uint16_t *)(input_buffer->buffer_cr) + input_buffer->origin_x / 2 +
-                input_buffer->origin_y / 2 * input_buffer->stride_cr;
-            input_stride_16bit = input_buffer->stride_cr;
-            input_8bit         = input_buffer_8bit->buffer_cr + input_buffer_8bit->origin_x / 2 +
-                input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cr;
-            input_stride_8bit = input_buffer_8bit->stride_cr;
-
-            svt_convert_8bit_to_16bit(input_8bit,
-                                      input_stride_8bit,
-                                      input_16bit,
-                                      input_stride_16bit,
-                                      input_buffer->width >> 1,
-                                      input_buffer->height >> 1);
-        }
+/* Deblocking is applied in the DLF stage unless it is disabled, or done at SB level in EncDec */
+static EbBool dlf_filter_in_dlf_stage(PictureControlSet *pcs_ptr) {
+    EbBool   dlf_enable_flag = (EbBool)pcs_ptr->parent_pcs_ptr->loop_filter_mode;
+    uint16_t total_tile_cnt  = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols *
+        pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
+    // Jing: Move sb level lf to here if tile_parallel
+    return (dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2) ||
+        (dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode == 1 && total_tile_cnt > 1);
+}
 
-        EbBool   dlf_enable_flag = (EbBool)pcs_ptr->parent_pcs_ptr->loop_filter_mode;
-        uint16_t total_tile_cnt  = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols *
-            pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
-        // Jing: Move sb level lf to here if tile_parallel
-        if ((dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode >= 2) ||
-            (dlf_enable_flag && pcs_ptr->parent_pcs_ptr->loop_filter_mode == 1 &&
-             total_tile_cnt > 1)) {
-            EbPictureBufferDesc *recon_buffer;
+/******************************************************
+ * Dlf Frame Init
+ * Frame level part of the DLF stage, run once per picture
+ * before any SB row is deblocked
+ ******************************************************/
+static void dlf_frame_init(DlfContext *context_ptr, PictureControlSet *pcs_ptr,
+                           SequenceControlSet *scs_ptr) {
+    if (scs_ptr->static_config.is_16bit_pipeline &&
+        scs_ptr->static_config.encoder_bit_depth == EB_8BIT) {
+        // //copy input from 8bit to 16bit
+        uint8_t *            input_8bit;
+        int32_t              input_stride_8bit;
+        uint16_t *           input_16bit;
+        int32_t              input_stride_16bit;
+        EbPictureBufferDesc *input_buffer_8bit =
+            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+        EbPictureBufferDesc *input_buffer = (EbPictureBufferDesc *)pcs_ptr->input_frame16bit;
+        // Y
+        input_16bit = (uint16_t *)(input_buffer->buffer_y) + input_buffer->origin_x +
+            input_buffer->origin_y * input_buffer->stride_y;
+        input_stride_16bit = input_buffer->stride_y;
+        input_8bit         = input_buffer_8bit->buffer_y + input_buffer_8bit->origin_x +
+            input_buffer_8bit->origin_y * input_buffer_8bit->stride_y;
+        input_stride_8bit = input_buffer_8bit->stride_y;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width,
+                                  input_buffer->height);
+
+        // Cb
+        input_16bit = (uint16_t *)(input_buffer->buffer_cb) + input_buffer->origin_x / 2 +
+            input_buffer->origin_y / 2 * input_buffer->stride_cb;
+        input_stride_16bit = input_buffer->stride_cb;
+        input_8bit         = input_buffer_8bit->buffer_cb + input_buffer_8bit->origin_x / 2 +
+            input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cb;
+        input_stride_8bit = input_buffer_8bit->stride_cb;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width >> 1,
+                                  input_buffer->height >> 1);
+
+        // Cr
+        input_16bit = (uint16_t *)(input_buffer->buffer_cr) + input_buffer->origin_x / 2 +
+            input_buffer->origin_y / 2 * input_buffer->stride_cr;
+        input_stride_16bit = input_buffer->stride_cr;
+        input_8bit         = input_buffer_8bit->buffer_cr + input_buffer_8bit->origin_x / 2 +
+            input_buffer_8bit->origin_y / 2 * input_buffer_8bit->stride_cr;
+        input_stride_8bit = input_buffer_8bit->stride_cr;
+
+        svt_convert_8bit_to_16bit(input_8bit,
+                                  input_stride_8bit,
+                                  input_16bit,
+                                  input_stride_16bit,
+                                  input_buffer->width >> 1,
+                                  input_buffer->height >> 1);
+    }
 
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                recon_buffer = (scs_ptr->static_config.is_16bit_pipeline || is_16bit)
-                    ? ((EbReferenceObject *)
-                           pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                          ->reference_picture16bit
-                    : ((EbReferenceObject *)
-                           pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                          ->reference_picture;
-            else
-                recon_buffer = scs_ptr->static_config.is_16bit_pipeline || is_16bit
-                    ? pcs_ptr->recon_picture16bit_ptr
-                    : pcs_ptr->recon_picture_ptr;
-
-            svt_av1_loop_filter_init(pcs_ptr);
-
-            if (pcs_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
-                svt_av1_pick_filter_level(
-                    context_ptr,
-                    (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
-                    pcs_ptr,
-                    LPF_PICK_FROM_Q);
-            }
+    if (dlf_filter_in_dlf_stage(pcs_ptr)) {
+        svt_av1_loop_filter_init(pcs_ptr);
 
+        if (pcs_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
             svt_av1_pick_filter_level(
                 context_ptr,
                 (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
                 pcs_ptr,
-                LPF_PICK_FROM_FULL_IMAGE);
+                LPF_PICK_FROM_Q);
+        }
+
+        svt_av1_pick_filter_level(
+            context_ptr,
+            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+            pcs_ptr,
+            LPF_PICK_FROM_FULL_IMAGE);
 
 #if NO_ENCDEC
-            //NO DLF
-            pcs_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level_u  = 0;
-            pcs_ptr->parent_pcs_ptr->lf.filter_level_v  = 0;
+        //NO DLF
+        pcs_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level_u  = 0;
+        pcs_ptr->parent_pcs_ptr->lf.filter_level_v  = 0;
 #endif
-            svt_av1_loop_filter_frame(recon_buffer, pcs_ptr, 0, 3);
-        }
+        svt_av1_loop_filter_frame_init(
+            &pcs_ptr->parent_pcs_ptr->frm_hdr, &pcs_ptr->parent_pcs_ptr->lf_info, 0, 3);
+    }
+}
+
+/******************************************************
+ * Dlf Post Cdef
+ * Run by the thread deblocking the last SB row of a
+ * picture: prepares the CDEF inputs and posts the CDEF
+ * segments
+ ******************************************************/
+static void dlf_post_cdef(DlfContext *context_ptr, PictureControlSet *pcs_ptr,
+                          SequenceControlSet *scs_ptr, EbObjectWrapper *pcs_wrapper_ptr) {
+    EbBool             is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    EbObjectWrapper *  dlf_results_wrapper_ptr;
+    struct DlfResults *dlf_results_ptr;
 
-        //pre-cdef prep
-        {
-            Av1Common *          cm = pcs_ptr->parent_pcs_ptr->av1_cm;
-            EbPictureBufferDesc *recon_picture_ptr;
-            if (is_16bit) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture16bit;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
+    //pre-cdef prep
+    {
+        Av1Common *          cm = pcs_ptr->parent_pcs_ptr->av1_cm;
+        EbPictureBufferDesc *recon_picture_ptr;
+        if (is_16bit) {
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+                recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
+                                         ->reference_picture_wrapper_ptr->object_ptr)
+                                        ->reference_picture16bit;
+            else
+                recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
+        } else {
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+                recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
+                                         ->reference_picture_wrapper_ptr->object_ptr)
+                                        ->reference_picture;
+            else
+                recon_picture_ptr = pcs_ptr->recon_picture_ptr;
+        }
+        if (scs_ptr->static_config.is_16bit_pipeline) {
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+                recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
+                                         ->reference_picture_wrapper_ptr->object_ptr)
+                                        ->reference_picture16bit;
             } else {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture;
-                else
-                    recon_picture_ptr = pcs_ptr->recon_picture_ptr;
+                recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
             }
-            if (scs_ptr->static_config.is_16bit_pipeline) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
-                    recon_picture_ptr = ((EbReferenceObject *)pcs_ptr->parent_pcs_ptr
-                                             ->reference_picture_wrapper_ptr->object_ptr)
-                                            ->reference_picture16bit;
-                } else {
-                    recon_picture_ptr = pcs_ptr->recon_picture16bit_ptr;
-                }
-            }
-            link_eb_to_aom_buffer_desc(recon_picture_ptr,
-                                       cm->frame_to_show,
-                                       scs_ptr->max_input_pad_right,
-                                       scs_ptr->max_input_pad_bottom,
-                                       is_16bit || scs_ptr->static_config.is_16bit_pipeline);
-            if (scs_ptr->seq_header.enable_restoration)
-                svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
-            if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
-                if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
-                    pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
-                        (recon_picture_ptr->origin_x +
-                         recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
-                    pcs_ptr->src[1] = (uint16_t *)recon_picture_ptr->buffer_cb +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
-                    pcs_ptr->src[2] = (uint16_t *)recon_picture_ptr->buffer_cr +
-                        (recon_picture_ptr->origin_x / 2 +
-                         recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
-
-                    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
-                    pcs_ptr->ref_coeff[0] = (uint16_t *)input_picture_ptr->buffer_y +
-                        (input_picture_ptr->origin_x +
-                         input_picture_ptr->origin_y * input_picture_ptr->stride_y);
-                    pcs_ptr->ref_coeff[1] = (uint16_t *)input_picture_ptr->buffer_cb +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
-                    pcs_ptr->ref_coeff[2] = (uint16_t *)input_picture_ptr->buffer_cr +
-                        (input_picture_ptr->origin_x / 2 +
-                         input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
-                } else {
-                    EbByte rec_ptr    = &((
-                        recon_picture_ptr
-                            ->buffer_y)[recon_picture_ptr->origin_x +
-                                        recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
-                    EbByte rec_ptr_cb = &(
-                        (recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
-                                                       recon_picture_ptr->origin_y / 2 *
-                                                           recon_picture_ptr->stride_cb]);
-                    EbByte rec_ptr_cr = &(
-                        (recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
-                                                       recon_picture_ptr->origin_y / 2 *
-                                                           recon_picture_ptr->stride_cr]);
-
-                    EbPictureBufferDesc *input_picture_ptr =
-                        (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-                    EbByte enh_ptr    = &((
-                        input_picture_ptr
-                            ->buffer_y)[input_picture_ptr->origin_x +
-                                        input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-                    EbByte enh_ptr_cb = &(
-                        (input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
-                                                       input_picture_ptr->origin_y / 2 *
-                                                           input_picture_ptr->stride_cb]);
-                    EbByte enh_ptr_cr = &(
-                        (input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
-                                                       input_picture_ptr->origin_y / 2 *
-                                                           input_picture_ptr->stride_cr]);
-
-                    pcs_ptr->src[0] = (uint16_t *)rec_ptr;
-                    pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
-                    pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
-
-                    pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
-                    pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
-                    pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
-                }
+        }
+        link_eb_to_aom_buffer_desc(recon_picture_ptr,
+                                   cm->frame_to_show,
+                                   scs_ptr->max_input_pad_right,
+                                   scs_ptr->max_input_pad_bottom,
+                                   is_16bit || scs_ptr->static_config.is_16bit_pipeline);
+        if (scs_ptr->seq_header.enable_restoration)
+            svt_av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
+        if (scs_ptr->seq_header.cdef_level && pcs_ptr->parent_pcs_ptr->cdef_level) {
+            memset(pcs_ptr->cdef_dir,
+                   -1,
+                   pcs_ptr->cdef_dir_stride * pcs_ptr->cdef_dir_rows * sizeof(*pcs_ptr->cdef_dir));
+            if (scs_ptr->static_config.is_16bit_pipeline || is_16bit) {
+                pcs_ptr->src[0] = (uint16_t *)recon_picture_ptr->buffer_y +
+                    (recon_picture_ptr->origin_x +
+                     recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
+                pcs_ptr->src[1] = (uint16_t *)recon_picture_ptr->buffer_cb +
+                    (recon_picture_ptr->origin_x / 2 +
+                     recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cb);
+                pcs_ptr->src[2] = (uint16_t *)recon_picture_ptr->buffer_cr +
+                    (recon_picture_ptr->origin_x / 2 +
+                     recon_picture_ptr->origin_y / 2 * recon_picture_ptr->stride_cr);
+
+                EbPictureBufferDesc *input_picture_ptr = pcs_ptr->input_frame16bit;
+                pcs_ptr->ref_coeff[0] = (uint16_t *)input_picture_ptr->buffer_y +
+                    (input_picture_ptr->origin_x +
+                     input_picture_ptr->origin_y * input_picture_ptr->stride_y);
+                pcs_ptr->ref_coeff[1] = (uint16_t *)input_picture_ptr->buffer_cb +
+                    (input_picture_ptr->origin_x / 2 +
+                     input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb);
+                pcs_ptr->ref_coeff[2] = (uint16_t *)input_picture_ptr->buffer_cr +
+                    (input_picture_ptr->origin_x / 2 +
+                     input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr);
+            } else {
+                EbByte rec_ptr    = &((
+                    recon_picture_ptr
+                        ->buffer_y)[recon_picture_ptr->origin_x +
+                                    recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
+                EbByte rec_ptr_cb = &(
+                    (recon_picture_ptr->buffer_cb)[recon_picture_ptr->origin_x / 2 +
+                                                   recon_picture_ptr->origin_y / 2 *
+                                                       recon_picture_ptr->stride_cb]);
+                EbByte rec_ptr_cr = &(
+                    (recon_picture_ptr->buffer_cr)[recon_picture_ptr->origin_x / 2 +
+                                                   recon_picture_ptr->origin_y / 2 *
+                                                       recon_picture_ptr->stride_cr]);
+
+                EbPictureBufferDesc *input_picture_ptr =
+                    (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+                EbByte enh_ptr    = &((
+                    input_picture_ptr
+                        ->buffer_y)[input_picture_ptr->origin_x +
+                                    input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
+                EbByte enh_ptr_cb = &(
+                    (input_picture_ptr->buffer_cb)[input_picture_ptr->origin_x / 2 +
+                                                   input_picture_ptr->origin_y / 2 *
+                                                       input_picture_ptr->stride_cb]);
+                EbByte enh_ptr_cr = &(
+                    (input_picture_ptr->buffer_cr)[input_picture_ptr->origin_x / 2 +
+                                                   input_picture_ptr->origin_y / 2 *
+                                                       input_picture_ptr->stride_cr]);
+
+                pcs_ptr->src[0] = (uint16_t *)rec_ptr;
+                pcs_ptr->src[1] = (uint16_t *)rec_ptr_cb;
+                pcs_ptr->src[2] = (uint16_t *)rec_ptr_cr;
+
+                pcs_ptr->ref_coeff[0] = (uint16_t *)enh_ptr;
+                pcs_ptr->ref_coeff[1] = (uint16_t *)enh_ptr_cb;
+                pcs_ptr->ref_coeff[2] = (uint16_t *)enh_ptr_cr;
             }
         }
+    }
 
-        pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
-        pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
-        pcs_ptr->cdef_segments_total_count  = (uint16_t)(pcs_ptr->cdef_segments_column_count *
-                                                        pcs_ptr->cdef_segments_row_count);
-        pcs_ptr->tot_seg_searched_cdef      = 0;
-        uint32_t segment_index;
-
-        for (segment_index = 0; segment_index < pcs_ptr->cdef_segments_total_count;
-             ++segment_index) {
-            // Get Empty DLF Results to Cdef
-            svt_get_empty_object(context_ptr->dlf_output_fifo_ptr, &dlf_results_wrapper_ptr);
-            dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
-            dlf_results_ptr->pcs_wrapper_ptr = enc_dec_results_ptr->pcs_wrapper_ptr;
-            dlf_results_ptr->segment_index   = segment_index;
-            // Post DLF Results
-            svt_post_full_object(dlf_results_wrapper_ptr);
-        }
+    pcs_ptr->cdef_segments_column_count = scs_ptr->cdef_segment_column_count;
+    pcs_ptr->cdef_segments_row_count    = scs_ptr->cdef_segment_row_count;
+    pcs_ptr->cdef_segments_total_count  = (uint16_t)(pcs_ptr->cdef_segments_column_count *
+                                                    pcs_ptr->cdef_segments_row_count);
+    pcs_ptr->tot_seg_searched_cdef      = 0;
+    uint32_t segment_index;
+
+    for (segment_index = 0; segment_index < pcs_ptr->cdef_segments_total_count;
+         ++segment_index) {
+        // Get Empty DLF Results to Cdef
+        svt_get_empty_object(context_ptr->dlf_output_fifo_ptr, &dlf_results_wrapper_ptr);
+        dlf_results_ptr = (struct DlfResults *)dlf_results_wrapper_ptr->object_ptr;
+        dlf_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+        dlf_results_ptr->segment_index   = segment_index;
+        // Post DLF Results
+        svt_post_full_object(dlf_results_wrapper_ptr);
+    }
+
+}
+
+/******************************************************
+ * Dlf Task
+ * EncDec posts one result per SB row (or range of SB rows) of a picture.
+ * The first DLF thread to receive a picture runs the frame level work
+ * while the other ones wait for it, then the SB rows are deblocked in
+ * parallel with a top-right dependency on the row above.
+ ******************************************************/
+void dlf_task(EbPtr input_ptr, EbObjectWrapper *enc_dec_results_wrapper_ptr) {
+    // Context & SCS & PCS
+    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
+    DlfContext *        context_ptr        = (DlfContext *)thread_context_ptr->priv;
+    PictureControlSet * pcs_ptr;
+    SequenceControlSet *scs_ptr;
 
-        // Release EncDec Results
-        svt_release_object(enc_dec_results_wrapper_ptr);
+    //// Input
+    EncDecResults *  enc_dec_results_ptr;
+
+    enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+    pcs_ptr             = (PictureControlSet *)enc_dec_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr             = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+
+    uint32_t picture_height_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_height +
+                                     scs_ptr->sb_size_pix - 1) /
+        scs_ptr->sb_size_pix;
+
+    // The first thread to get the picture does the frame level work, the other ones wait
+    EbBool do_frame_init = EB_FALSE;
+    EbBool wait_frame_init = EB_FALSE;
+    svt_block_on_mutex(pcs_ptr->dlf_mutex);
+    if (!pcs_ptr->dlf_init_started) {
+        pcs_ptr->dlf_init_started = EB_TRUE;
+        do_frame_init             = EB_TRUE;
+    } else if (!pcs_ptr->dlf_init_done) {
+        pcs_ptr->dlf_init_wait_count++;
+        wait_frame_init = EB_TRUE;
+    }
+    svt_release_mutex(pcs_ptr->dlf_mutex);
+
+    if (do_frame_init) {
+        dlf_frame_init(context_ptr, pcs_ptr, scs_ptr);
+        svt_block_on_mutex(pcs_ptr->dlf_mutex);
+        pcs_ptr->dlf_init_done = EB_TRUE;
+        for (uint32_t i = 0; i < pcs_ptr->dlf_init_wait_count; i++)
+            svt_post_semaphore(pcs_ptr->dlf_init_done_semaphore);
+        pcs_ptr->dlf_init_wait_count = 0;
+        svt_release_mutex(pcs_ptr->dlf_mutex);
+    } else if (wait_frame_init)
+        svt_block_on_semaphore(pcs_ptr->dlf_init_done_semaphore);
+
+    if (dlf_filter_in_dlf_stage(pcs_ptr)) {
+        EbPictureBufferDesc *recon_buffer = get_dlf_recon_buffer(pcs_ptr, scs_ptr);
+        for (uint32_t y_sb_index = enc_dec_results_ptr->completed_sb_row_index_start;
+             y_sb_index < enc_dec_results_ptr->completed_sb_row_index_start +
+                 enc_dec_results_ptr->completed_sb_row_count;
+             ++y_sb_index)
+            svt_av1_loop_filter_sb_row(recon_buffer, pcs_ptr, y_sb_index, 0, 3);
+    }
+
+    svt_block_on_mutex(pcs_ptr->dlf_mutex);
+    pcs_ptr->tot_sb_rows_dlf += enc_dec_results_ptr->completed_sb_row_count;
+    EbBool last_sb_row_flag = (pcs_ptr->tot_sb_rows_dlf == picture_height_in_sb);
+    svt_release_mutex(pcs_ptr->dlf_mutex);
+
+    if (last_sb_row_flag)
+        dlf_post_cdef(context_ptr, pcs_ptr, scs_ptr, enc_dec_results_ptr->pcs_wrapper_ptr);
+
+    // Release EncDec Results
+    svt_release_object(enc_dec_results_wrapper_ptr);
+}
+
+/******************************************************
+ * Dlf Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *dlf_kernel(void *input_ptr) {
+    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
+    DlfContext *        context_ptr        = (DlfContext *)thread_context_ptr->priv;
+    EbObjectWrapper *   enc_dec_results_wrapper_ptr;
+
+    for (;;) {
+        // Get EncDec Results
+        EB_GET_FULL_OBJECT(context_ptr->dlf_input_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        dlf_task(input_ptr, enc_dec_results_wrapper_ptr);
     }
 
     return NULL;
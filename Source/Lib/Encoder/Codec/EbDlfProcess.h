@@ -34,5 +34,6 @@ extern EbErrorType dlf_context_ctor(EbThreadContext *  thread_context_ptr,
                                     const EbEncHandle *enc_handle_ptr, int index);
 
 extern void *dlf_kernel(void *input_ptr);
+extern void  dlf_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
 
 #endif // EbEntropyCodingProcess_h
@@ -289,6 +289,42 @@ int32_t svt_sb_compute_cdef_list(PictureControlSet *pcs_ptr, const Av1Common *co
     return count;
 }
 
+/*
+ * The luma direction and variance of a 8x8 block only depend on the deblocked
+ * recon: the search keeps them per picture and the application reads them back
+ */
+static INLINE uint32_t cdef_dir_index(PictureControlSet *pcs_ptr, int32_t fbr, int32_t fbc,
+                                      const CdefList *entry) {
+    return (fbr * (MI_SIZE_64X64 >> 1) + entry->by) * pcs_ptr->cdef_dir_stride +
+        fbc * (MI_SIZE_64X64 >> 1) + entry->bx;
+}
+
+void svt_cdef_store_dirs(PictureControlSet *pcs_ptr, int32_t fbr, int32_t fbc,
+                         const CdefList *dlist, int32_t cdef_count,
+                         int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+                         int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS]) {
+    for (int32_t bi = 0; bi < cdef_count; bi++) {
+        const uint32_t idx     = cdef_dir_index(pcs_ptr, fbr, fbc, &dlist[bi]);
+        pcs_ptr->cdef_dir[idx] = (int8_t)dir[dlist[bi].by][dlist[bi].bx];
+        pcs_ptr->cdef_var[idx] = var[dlist[bi].by][dlist[bi].bx];
+    }
+}
+
+// Returns 1 when every block of dlist was searched, dir and var are then filled
+int32_t svt_cdef_load_dirs(PictureControlSet *pcs_ptr, int32_t fbr, int32_t fbc,
+                           const CdefList *dlist, int32_t cdef_count,
+                           int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+                           int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS]) {
+    for (int32_t bi = 0; bi < cdef_count; bi++) {
+        const uint32_t idx = cdef_dir_index(pcs_ptr, fbr, fbc, &dlist[bi]);
+        if (pcs_ptr->cdef_dir[idx] < 0)
+            return 0;
+        dir[dlist[bi].by][dlist[bi].bx] = pcs_ptr->cdef_dir[idx];
+        var[dlist[bi].by][dlist[bi].bx] = pcs_ptr->cdef_var[idx];
+    }
+    return 1;
+}
+
 void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
                         PictureControlSet *pCs) {
     (void)context_ptr;
@@ -432,6 +468,9 @@ void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
             }
 
             curr_row_cdef[fbc] = 1;
+            // Directions found by the search
+            const int32_t dir_ready = svt_cdef_load_dirs(
+                pCs, fbr, fbc, dlist, cdef_count, dir, var);
             for (int32_t pli = 0; pli < num_planes; pli++) {
                 int32_t coffset;
                 int32_t rend, cend;
@@ -634,6 +673,7 @@ void svt_av1_cdef_frame(EncDecContext *context_ptr, SequenceControlSet *scs_ptr,
                         ydec[pli],
                         dir,
                         NULL,
+                        dir_ready,
                         var,
                         pli,
                         dlist,
@@ -801,6 +841,9 @@ void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr
             }
 
             curr_row_cdef[fbc] = 1;
+            // Directions found by the search
+            const int32_t dir_ready = svt_cdef_load_dirs(
+                pCs, fbr, fbc, dlist, cdef_count, dir, var);
             for (int32_t pli = 0; pli < num_planes; pli++) {
                 int32_t coffset;
                 int32_t rend, cend;
@@ -1001,6 +1044,7 @@ void av1_cdef_frame16bit(EncDecContext *context_ptr, SequenceControlSet *scs_ptr
                                    ydec[pli],
                                    dir,
                                    NULL,
+                                   dir_ready,
                                    var,
                                    pli,
                                    dlist,
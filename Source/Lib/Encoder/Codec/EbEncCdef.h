@@ -26,6 +26,16 @@ typedef void (*CdefFilterBlockFunc)(uint8_t *dst8, uint16_t *dst16, int32_t dstr
 void copy_cdef_16bit_to_16bit(uint16_t *dst, int32_t dstride, uint16_t *src, CdefList *dlist,
                               int32_t cdef_count, int32_t bsize);
 
+struct PictureControlSet;
+void    svt_cdef_store_dirs(struct PictureControlSet *pcs_ptr, int32_t fbr, int32_t fbc,
+                            const CdefList *dlist, int32_t cdef_count,
+                            int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+                            int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS]);
+int32_t svt_cdef_load_dirs(struct PictureControlSet *pcs_ptr, int32_t fbr, int32_t fbc,
+                           const CdefList *dlist, int32_t cdef_count,
+                           int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+                           int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS]);
+
 
 #ifdef __cplusplus
 }
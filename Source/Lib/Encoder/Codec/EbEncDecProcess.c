@@ -574,882 +574,6 @@ void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
     svt_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
 }
 
-//************************************/
-// Calculate Frame SSIM
-/************************************/
-
-void aom_ssim_parms_8x8_c(const uint8_t *s, int sp, const uint8_t *r, int rp,
-                          uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
-                          uint32_t *sum_sq_r, uint32_t *sum_sxr) {
-  int i, j;
-  for (i = 0; i < 8; i++, s += sp, r += rp) {
-    for (j = 0; j < 8; j++) {
-      *sum_s += s[j];
-      *sum_r += r[j];
-      *sum_sq_s += s[j] * s[j];
-      *sum_sq_r += r[j] * r[j];
-      *sum_sxr += s[j] * r[j];
-    }
-  }
-}
-
-void aom_highbd_ssim_parms_8x8_c(const uint8_t *s, int sp, const uint8_t *sinc, int spinc, const uint16_t *r,
-                                 int rp, uint32_t *sum_s, uint32_t *sum_r,
-                                 uint32_t *sum_sq_s, uint32_t *sum_sq_r,
-                                 uint32_t *sum_sxr) {
-  int i, j;
-  uint32_t ss;
-  for (i = 0; i < 8; i++, s += sp, sinc += spinc, r += rp) {
-    for (j = 0; j < 8; j++) {
-      ss = (int64_t)(s[j] << 2) + ((sinc[j]>>6)&0x3);
-      *sum_s += ss;
-      *sum_r += r[j];
-      *sum_sq_s += ss * ss;
-      *sum_sq_r += r[j] * r[j];
-      *sum_sxr += ss * r[j];
-    }
-  }
-}
-
-static const int64_t cc1 = 26634;        // (64^2*(.01*255)^2
-static const int64_t cc2 = 239708;       // (64^2*(.03*255)^2
-static const int64_t cc1_10 = 428658;    // (64^2*(.01*1023)^2
-static const int64_t cc2_10 = 3857925;   // (64^2*(.03*1023)^2
-static const int64_t cc1_12 = 6868593;   // (64^2*(.01*4095)^2
-static const int64_t cc2_12 = 61817334;  // (64^2*(.03*4095)^2
-
-static double similarity(uint32_t sum_s, uint32_t sum_r, uint32_t sum_sq_s,
-                         uint32_t sum_sq_r, uint32_t sum_sxr, int count,
-                         uint32_t bd) {
-  double ssim_n, ssim_d;
-  int64_t c1, c2;
-
-  if (bd == 8) {
-    // scale the constants by number of pixels
-    c1 = (cc1 * count * count) >> 12;
-    c2 = (cc2 * count * count) >> 12;
-  } else if (bd == 10) {
-    c1 = (cc1_10 * count * count) >> 12;
-    c2 = (cc2_10 * count * count) >> 12;
-  } else if (bd == 12) {
-    c1 = (cc1_12 * count * count) >> 12;
-    c2 = (cc2_12 * count * count) >> 12;
-  } else {
-    c1 = c2 = 0;
-    assert(0);
-  }
-
-  ssim_n = (2.0 * sum_s * sum_r + c1) *
-           (2.0 * count * sum_sxr - 2.0 * sum_s * sum_r + c2);
-
-  ssim_d = ((double)sum_s * sum_s + (double)sum_r * sum_r + c1) *
-           ((double)count * sum_sq_s - (double)sum_s * sum_s +
-            (double)count * sum_sq_r - (double)sum_r * sum_r + c2);
-
-  return ssim_n / ssim_d;
-}
-
-static double ssim_8x8(const uint8_t *s, int sp, const uint8_t *r, int rp) {
-  uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
-  aom_ssim_parms_8x8_c(s, sp, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
-  return similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64, 8);
-}
-
-static double highbd_ssim_8x8(const uint8_t *s, int sp, const uint8_t *sinc, int spinc, const uint16_t *r,
-                              int rp, uint32_t bd, uint32_t shift) {
-  uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
-  aom_highbd_ssim_parms_8x8_c(s, sp, sinc, spinc, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
-  return similarity(sum_s >> shift, sum_r >> shift, sum_sq_s >> (2 * shift),
-                    sum_sq_r >> (2 * shift), sum_sxr >> (2 * shift), 64, bd);
-}
-
-// We are using a 8x8 moving window with starting location of each 8x8 window
-// on the 4x4 pixel grid. Such arrangement allows the windows to overlap
-// block boundaries to penalize blocking artifacts.
-static double aom_ssim2(const uint8_t *img1, int stride_img1,
-                        const uint8_t *img2, int stride_img2,
-                        int width, int height) {
-    int i, j;
-    int samples = 0;
-    double ssim_total = 0;
-
-    // sample point start with each 4x4 location
-    for (i = 0; i <= height - 8;
-        i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
-        for (j = 0; j <= width - 8; j += 4) {
-            double v = ssim_8x8(img1 + j, stride_img1, img2 + j, stride_img2);
-            ssim_total += v;
-            samples++;
-        }
-    }
-    assert(samples > 0);
-    ssim_total /= samples;
-    return ssim_total;
-}
-
-static double aom_highbd_ssim2(const uint8_t *img1, int stride_img1,
-                               const uint8_t *img1inc, int stride_img1inc,
-                               const uint16_t *img2, int stride_img2,
-                               int width, int height, uint32_t bd, uint32_t shift) {
-  int i, j;
-  int samples = 0;
-  double ssim_total = 0;
-
-  // sample point start with each 4x4 location
-  for (i = 0; i <= height - 8;
-       i += 4, img1 += stride_img1 * 4, img1inc += stride_img1inc * 4, img2 += stride_img2 * 4) {
-    for (j = 0; j <= width - 8; j += 4) {
-      double v = highbd_ssim_8x8((img1 + j), stride_img1,
-                                 (img1inc + j), stride_img1inc,
-                                 (img2 + j), stride_img2, bd,
-                                 shift);
-      ssim_total += v;
-      samples++;
-    }
-  }
-  assert(samples > 0);
-  ssim_total /= samples;
-  return ssim_total;
-}
-
-void ssim_calculations(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr, EbBool free_memory) {
-    EbBool is_16bit = (scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-
-    const uint32_t ss_x = scs_ptr->subsampling_x;
-    const uint32_t ss_y = scs_ptr->subsampling_y;
-
-    if (!is_16bit) {
-        EbPictureBufferDesc *recon_ptr;
-
-        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject*)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
-        else
-            recon_ptr = pcs_ptr->recon_picture_ptr;
-
-        EbPictureBufferDesc *input_picture_ptr = (EbPictureBufferDesc*)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        EbByte  input_buffer;
-        EbByte  recon_coeff_buffer;
-
-        EbByte buffer_y;
-        EbByte buffer_cb;
-        EbByte buffer_cr;
-
-        double luma_ssim = 0.0;
-        double cb_ssim = 0.0;
-        double cr_ssim = 0.0;
-
-        // if current source picture was temporally filtered, use an alternative buffer which stores
-        // the original source picture
-        if(pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE){
-            buffer_y = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[0];
-            buffer_cb = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[1];
-            buffer_cr = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[2];
-        }
-        else {
-            buffer_y = input_picture_ptr->buffer_y;
-            buffer_cb = input_picture_ptr->buffer_cb;
-            buffer_cr = input_picture_ptr->buffer_cr;
-        }
-
-        recon_coeff_buffer = &((recon_ptr->buffer_y)[recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y]);
-        input_buffer = &(buffer_y[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-        luma_ssim = aom_ssim2(input_buffer, input_picture_ptr->stride_y, recon_coeff_buffer, recon_ptr->stride_y,
-                              scs_ptr->seq_header.max_frame_width, scs_ptr->seq_header.max_frame_height);
-
-        recon_coeff_buffer = &((recon_ptr->buffer_cb)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->stride_cb]);
-        input_buffer = &(buffer_cb[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-        cb_ssim = aom_ssim2(input_buffer, input_picture_ptr->stride_cb, recon_coeff_buffer, recon_ptr->stride_cb,
-                            scs_ptr->chroma_width, scs_ptr->chroma_height);
-
-        recon_coeff_buffer = &((recon_ptr->buffer_cr)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->stride_cr]);
-        input_buffer = &(buffer_cr[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-        cr_ssim = aom_ssim2(input_buffer, input_picture_ptr->stride_cr, recon_coeff_buffer, recon_ptr->stride_cr,
-                            scs_ptr->chroma_width, scs_ptr->chroma_height);
-
-        pcs_ptr->parent_pcs_ptr->luma_ssim = luma_ssim;
-        pcs_ptr->parent_pcs_ptr->cb_ssim = cb_ssim;
-        pcs_ptr->parent_pcs_ptr->cr_ssim = cr_ssim;
-
-        if (free_memory && pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-            EB_FREE_ARRAY(buffer_y);
-            EB_FREE_ARRAY(buffer_cb);
-            EB_FREE_ARRAY(buffer_cr);
-        }
-    }
-    else {
-      EbPictureBufferDesc *recon_ptr;
-
-        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject*)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-        else
-            recon_ptr = pcs_ptr->recon_picture16bit_ptr;
-        EbPictureBufferDesc *input_picture_ptr = (EbPictureBufferDesc*)pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        EbByte    input_buffer;
-        uint16_t *recon_coeff_buffer;
-
-        double luma_ssim = 0.0;
-        double cb_ssim = 0.0;
-        double cr_ssim = 0.0;
-
-        if (scs_ptr->static_config.ten_bit_format == 1) {
-
-            /* SSIM calculation for compressed 10-bit format has not been verified and debugged,
-               since this format is not supported elsewhere in this version. See verify_settings(),
-               which exits with an error if compressed 10-bit format is enabled. To avoid
-               extra complexity of unpacking into a temporary buffer, or having to write
-               new core SSIM functions, we ignore the two least signifcant bits in this
-               case, and set these to zero. One test shows a difference in SSIM
-               of 0.00085 setting the two least significant bits to zero. */
-
-            const uint32_t luma_width        = input_picture_ptr->width - scs_ptr->max_input_pad_right;
-            const uint32_t luma_height       = input_picture_ptr->height - scs_ptr->max_input_pad_bottom;
-            const uint32_t chroma_width      = luma_width >> ss_x;
-            const uint32_t pic_width_in_sb   = (luma_width + 64 - 1) / 64;
-            const uint32_t pic_height_in_sb  = (luma_height + 64 - 1) / 64;
-            const uint32_t chroma_height     = luma_height >> ss_y;
-            uint32_t       sb_num_in_height, sb_num_in_width, bd, shift;
-            uint8_t        zero_buffer[64*64];
-
-            bd = 10;
-            shift = 0 ; // both input and output are 10 bit (bitdepth - input_bd)
-            memset(&zero_buffer[0], 0, sizeof(uint8_t)*64*64);
-
-            EbByte input_buffer_org =
-                &((input_picture_ptr
-                       ->buffer_y)[input_picture_ptr->origin_x +
-                                   input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            uint16_t *recon_buffer_org = (uint16_t *)(&(
-                (recon_ptr->buffer_y)[(recon_ptr->origin_x << is_16bit) +
-                                      (recon_ptr->origin_y << is_16bit) * recon_ptr->stride_y]));
-            ;
-
-            EbByte input_buffer_org_u = &(
-                (input_picture_ptr
-                     ->buffer_cb)[input_picture_ptr->origin_x / 2 +
-                                  input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-            ;
-            uint16_t *recon_buffer_org_u = recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cb)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cb]));
-            ;
-
-            EbByte input_buffer_org_v = &(
-                (input_picture_ptr
-                     ->buffer_cr)[input_picture_ptr->origin_x / 2 +
-                                  input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-            ;
-            uint16_t *recon_buffer_org_v = recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cr)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cr]));
-            ;
-
-           for (sb_num_in_height = 0; sb_num_in_height < pic_height_in_sb; ++sb_num_in_height) {
-                for (sb_num_in_width = 0; sb_num_in_width < pic_width_in_sb; ++sb_num_in_width) {
-                    uint32_t tb_origin_x = sb_num_in_width * 64;
-                    uint32_t tb_origin_y = sb_num_in_height * 64;
-                    uint32_t sb_width =
-                        (luma_width - tb_origin_x) < 64 ? (luma_width - tb_origin_x) : 64;
-                    uint32_t sb_height =
-                        (luma_height - tb_origin_y) < 64 ? (luma_height - tb_origin_y) : 64;
-
-                    input_buffer =
-                        input_buffer_org + tb_origin_y * input_picture_ptr->stride_y + tb_origin_x;
-                    recon_coeff_buffer =
-                        recon_buffer_org + tb_origin_y * recon_ptr->stride_y + tb_origin_x;
-
-                    luma_ssim += aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_y, &zero_buffer[0], 64,
-                                                  recon_coeff_buffer, recon_ptr->stride_y, sb_width, sb_height, bd, shift);
-
-                    //U+V
-                    tb_origin_x = sb_num_in_width * 32;
-                    tb_origin_y = sb_num_in_height * 32;
-                    sb_width =
-                        (chroma_width - tb_origin_x) < 32 ? (chroma_width - tb_origin_x) : 32;
-                    sb_height =
-                        (chroma_height - tb_origin_y) < 32 ? (chroma_height - tb_origin_y) : 32;
-
-                    input_buffer = input_buffer_org_u + tb_origin_y * input_picture_ptr->stride_cb +
-                                   tb_origin_x;
-                    recon_coeff_buffer =
-                        recon_buffer_org_u + tb_origin_y * recon_ptr->stride_cb + tb_origin_x;
-
-                    cb_ssim += aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_cb, &zero_buffer[0], 64,
-                                                recon_coeff_buffer, recon_ptr->stride_cb, sb_width, sb_height, bd, shift);
-
-                    input_buffer = input_buffer_org_v + tb_origin_y * input_picture_ptr->stride_cr +
-                                   tb_origin_x;
-                    recon_coeff_buffer =
-                        recon_buffer_org_v + tb_origin_y * recon_ptr->stride_cr + tb_origin_x;
-
-                    cr_ssim += aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_cr, &zero_buffer[0], 64,
-                                                recon_coeff_buffer, recon_ptr->stride_cr, sb_width, sb_height, bd, shift);
-                }
-            }
-
-            luma_ssim /= pic_height_in_sb * pic_width_in_sb;
-            cb_ssim   /= pic_height_in_sb * pic_width_in_sb;
-            cr_ssim   /= pic_height_in_sb * pic_width_in_sb;
-
-            pcs_ptr->parent_pcs_ptr->luma_ssim = luma_ssim;
-            pcs_ptr->parent_pcs_ptr->cb_ssim = cb_ssim;
-            pcs_ptr->parent_pcs_ptr->cr_ssim = cr_ssim;
-        }
-        else {
-            recon_coeff_buffer = (uint16_t*)(&((recon_ptr->buffer_y)[(recon_ptr->origin_x << is_16bit) + (recon_ptr->origin_y << is_16bit) * recon_ptr->stride_y]));
-
-            // if current source picture was temporally filtered, use an alternative buffer which stores
-            // the original source picture
-            EbByte buffer_y, buffer_bit_inc_y;
-            EbByte buffer_cb, buffer_bit_inc_cb;
-            EbByte buffer_cr, buffer_bit_inc_cr;
-            int bd, shift;
-
-            if(pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE){
-                buffer_y = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[0];
-                buffer_bit_inc_y = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[0];
-                buffer_cb = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[1];
-                buffer_bit_inc_cb = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[1];
-                buffer_cr = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[2];
-                buffer_bit_inc_cr = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[2];
-            }else{
-                buffer_y = input_picture_ptr->buffer_y;
-                buffer_bit_inc_y = input_picture_ptr->buffer_bit_inc_y;
-                buffer_cb = input_picture_ptr->buffer_cb;
-                buffer_bit_inc_cb = input_picture_ptr->buffer_bit_inc_cb;
-                buffer_cr = input_picture_ptr->buffer_cr;
-                buffer_bit_inc_cr = input_picture_ptr->buffer_bit_inc_cr;
-            }
-
-            bd = 10;
-            shift = 0 ; // both input and output are 10 bit (bitdepth - input_bd)
-
-            input_buffer = &((buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            EbByte input_buffer_bit_inc = &(
-                (buffer_bit_inc_y)[input_picture_ptr->origin_x +
-                                   input_picture_ptr->origin_y *
-                                       input_picture_ptr->stride_bit_inc_y]);
-            luma_ssim = aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_y, input_buffer_bit_inc, input_picture_ptr->stride_bit_inc_y,
-                                         recon_coeff_buffer, recon_ptr->stride_y, scs_ptr->seq_header.max_frame_width, scs_ptr->seq_header.max_frame_height, bd, shift);
-
-            recon_coeff_buffer = (uint16_t*)(&((recon_ptr->buffer_cb)[(recon_ptr->origin_x << is_16bit) / 2 + (recon_ptr->origin_y << is_16bit) / 2 * recon_ptr->stride_cb]));
-            input_buffer = &((buffer_cb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-            input_buffer_bit_inc = &((buffer_bit_inc_cb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_bit_inc_cb]);
-            cb_ssim = aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_cb, input_buffer_bit_inc, input_picture_ptr->stride_bit_inc_cb,
-                                       recon_coeff_buffer, recon_ptr->stride_cb, scs_ptr->chroma_width, scs_ptr->chroma_height, bd, shift);
-
-            recon_coeff_buffer = (uint16_t*)(&((recon_ptr->buffer_cr)[(recon_ptr->origin_x << is_16bit) / 2 + (recon_ptr->origin_y << is_16bit) / 2 * recon_ptr->stride_cr]));
-            input_buffer = &((buffer_cr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-            input_buffer_bit_inc = &((buffer_bit_inc_cr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_bit_inc_cr]);
-            cr_ssim = aom_highbd_ssim2(input_buffer, input_picture_ptr->stride_cr, input_buffer_bit_inc, input_picture_ptr->stride_bit_inc_cr,
-                                    recon_coeff_buffer, recon_ptr->stride_cr, scs_ptr->chroma_width, scs_ptr->chroma_height, bd, shift);
-
-            pcs_ptr->parent_pcs_ptr->luma_ssim = luma_ssim;
-            pcs_ptr->parent_pcs_ptr->cb_ssim = cb_ssim;
-            pcs_ptr->parent_pcs_ptr->cr_ssim = cr_ssim;
-
-            if (free_memory && pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-                EB_FREE_ARRAY(buffer_y);
-                EB_FREE_ARRAY(buffer_cb);
-                EB_FREE_ARRAY(buffer_cr);
-                EB_FREE_ARRAY(buffer_bit_inc_y);
-                EB_FREE_ARRAY(buffer_bit_inc_cb);
-                EB_FREE_ARRAY(buffer_bit_inc_cr);
-            }
-        }
-    }
-
-}
-
-void psnr_calculations(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr, EbBool free_memory) {
-    EbBool is_16bit = (scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-
-    const uint32_t ss_x = scs_ptr->subsampling_x;
-    const uint32_t ss_y = scs_ptr->subsampling_y;
-
-    if (!is_16bit) {
-        EbPictureBufferDesc *recon_ptr;
-
-        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->reference_picture;
-        else
-            recon_ptr = pcs_ptr->recon_picture_ptr;
-
-        EbPictureBufferDesc *input_picture_ptr =
-            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr;
-
-        uint64_t sse_total[3] = {0};
-        uint64_t residual_distortion = 0;
-        EbByte   input_buffer;
-        EbByte   recon_coeff_buffer;
-
-        EbByte buffer_y;
-        EbByte buffer_cb;
-        EbByte buffer_cr;
-
-        // if current source picture was temporally filtered, use an alternative buffer which stores
-        // the original source picture
-        if (pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-            buffer_y  = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[0];
-            buffer_cb = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[1];
-            buffer_cr = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[2];
-        } else {
-            buffer_y  = input_picture_ptr->buffer_y;
-            buffer_cb = input_picture_ptr->buffer_cb;
-            buffer_cr = input_picture_ptr->buffer_cr;
-        }
-
-        recon_coeff_buffer = &(
-            (recon_ptr->buffer_y)[recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y]);
-        input_buffer = &(buffer_y[input_picture_ptr->origin_x +
-                                  input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-
-        residual_distortion = 0;
-
-        for (int row_index = 0;
-             row_index < input_picture_ptr->height - scs_ptr->max_input_pad_bottom;
-             ++row_index) {
-            for (int column_index = 0;
-                 column_index < input_picture_ptr->width - scs_ptr->max_input_pad_right;
-                 ++column_index) {
-                residual_distortion += (int64_t)SQR((int64_t)(input_buffer[column_index]) -
-                                                    (recon_coeff_buffer[column_index]));
-            }
-
-            input_buffer += input_picture_ptr->stride_y;
-            recon_coeff_buffer += recon_ptr->stride_y;
-        }
-
-        sse_total[0] = residual_distortion;
-
-        recon_coeff_buffer =
-            &((recon_ptr->buffer_cb)[recon_ptr->origin_x / 2 +
-                                     recon_ptr->origin_y / 2 * recon_ptr->stride_cb]);
-        input_buffer = &(buffer_cb[input_picture_ptr->origin_x / 2 +
-                                   input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-
-        residual_distortion = 0;
-        for (int row_index = 0; row_index <
-             (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >> ss_y;
-             ++row_index) {
-            for (int column_index = 0; column_index <
-                 (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
-                 ++column_index) {
-                residual_distortion += (int64_t)SQR((int64_t)(input_buffer[column_index]) -
-                                                    (recon_coeff_buffer[column_index]));
-            }
-
-            input_buffer += input_picture_ptr->stride_cb;
-            recon_coeff_buffer += recon_ptr->stride_cb;
-        }
-
-        sse_total[1] = residual_distortion;
-
-        recon_coeff_buffer =
-            &((recon_ptr->buffer_cr)[recon_ptr->origin_x / 2 +
-                                     recon_ptr->origin_y / 2 * recon_ptr->stride_cr]);
-        input_buffer        = &(buffer_cr[input_picture_ptr->origin_x / 2 +
-                                   input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-        residual_distortion = 0;
-
-        for (int row_index = 0; row_index <
-             (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >> ss_y;
-             ++row_index) {
-            for (int column_index = 0; column_index <
-                 (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
-                 ++column_index) {
-                residual_distortion += (int64_t)SQR((int64_t)(input_buffer[column_index]) -
-                                                    (recon_coeff_buffer[column_index]));
-            }
-
-            input_buffer += input_picture_ptr->stride_cr;
-            recon_coeff_buffer += recon_ptr->stride_cr;
-        }
-
-        sse_total[2]                      = residual_distortion;
-        pcs_ptr->parent_pcs_ptr->luma_sse = (uint32_t)sse_total[0];
-        pcs_ptr->parent_pcs_ptr->cb_sse   = (uint32_t)sse_total[1];
-        pcs_ptr->parent_pcs_ptr->cr_sse   = (uint32_t)sse_total[2];
-
-        if(free_memory && pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-            EB_FREE_ARRAY(buffer_y);
-            EB_FREE_ARRAY(buffer_cb);
-            EB_FREE_ARRAY(buffer_cr);
-        }
-    }
-    else {
-        EbPictureBufferDesc *recon_ptr;
-
-        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->reference_picture16bit;
-        else
-            recon_ptr = pcs_ptr->recon_picture16bit_ptr;
-        EbPictureBufferDesc *input_picture_ptr =
-            (EbPictureBufferDesc *)pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr;
-
-        uint64_t  sse_total[3] = {0};
-        uint64_t  residual_distortion = 0;
-        EbByte    input_buffer;
-        EbByte    input_buffer_bit_inc;
-        uint16_t *recon_coeff_buffer;
-
-        if (scs_ptr->static_config.ten_bit_format == 1) {
-            const uint32_t luma_width        = input_picture_ptr->width - scs_ptr->max_input_pad_right;
-            const uint32_t luma_height       = input_picture_ptr->height - scs_ptr->max_input_pad_bottom;
-            const uint32_t chroma_width      = luma_width >> ss_x;
-            const uint32_t pic_width_in_sb   = (luma_width + 64 - 1) / 64;
-            const uint32_t pic_height_in_sb  = (luma_height + 64 - 1) / 64;
-            const uint32_t luma_2bit_width   = luma_width / 4;
-            const uint32_t chroma_height     = luma_height >> ss_y;
-            const uint32_t chroma_2bit_width = chroma_width / 4;
-            uint32_t       sb_num_in_height, sb_num_in_width;
-
-            EbByte input_buffer_org =
-                &((input_picture_ptr
-                       ->buffer_y)[input_picture_ptr->origin_x +
-                                   input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            uint16_t *recon_buffer_org = (uint16_t *)(&(
-                (recon_ptr->buffer_y)[(recon_ptr->origin_x << is_16bit) +
-                                      (recon_ptr->origin_y << is_16bit) * recon_ptr->stride_y]));
-            ;
-
-            EbByte input_buffer_org_u = &(
-                (input_picture_ptr
-                     ->buffer_cb)[input_picture_ptr->origin_x / 2 +
-                                  input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-            ;
-            uint16_t *recon_buffer_org_u = recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cb)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cb]));
-            ;
-
-            EbByte input_buffer_org_v = &(
-                (input_picture_ptr
-                     ->buffer_cr)[input_picture_ptr->origin_x / 2 +
-                                  input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-            ;
-            uint16_t *recon_buffer_org_v = recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cr)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cr]));
-            ;
-
-            residual_distortion            = 0;
-            uint64_t residual_distortion_u = 0;
-            uint64_t residual_distortion_v = 0;
-
-            for (sb_num_in_height = 0; sb_num_in_height < pic_height_in_sb; ++sb_num_in_height) {
-                for (sb_num_in_width = 0; sb_num_in_width < pic_width_in_sb; ++sb_num_in_width) {
-                    uint32_t tb_origin_x = sb_num_in_width * 64;
-                    uint32_t tb_origin_y = sb_num_in_height * 64;
-                    uint32_t sb_width =
-                        (luma_width - tb_origin_x) < 64 ? (luma_width - tb_origin_x) : 64;
-                    uint32_t sb_height =
-                        (luma_height - tb_origin_y) < 64 ? (luma_height - tb_origin_y) : 64;
-
-                    input_buffer =
-                        input_buffer_org + tb_origin_y * input_picture_ptr->stride_y + tb_origin_x;
-                    input_buffer_bit_inc = input_picture_ptr->buffer_bit_inc_y +
-                                           tb_origin_y * luma_2bit_width +
-                                           (tb_origin_x / 4) * sb_height;
-                    recon_coeff_buffer =
-                        recon_buffer_org + tb_origin_y * recon_ptr->stride_y + tb_origin_x;
-
-                    uint64_t j, k;
-                    uint16_t out_pixel;
-                    uint8_t  n_bit_pixel;
-                    uint8_t  four_2bit_pels;
-                    uint32_t inn_stride = sb_width / 4;
-
-                    for (j = 0; j < sb_height; j++) {
-                        for (k = 0; k < sb_width / 4; k++) {
-                            four_2bit_pels = input_buffer_bit_inc[k + j * inn_stride];
-
-                            n_bit_pixel = (four_2bit_pels >> 6) & 3;
-                            out_pixel   = input_buffer[k * 4 + 0 + j * input_picture_ptr->stride_y]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 0 + j * recon_ptr->stride_y]);
-
-                            n_bit_pixel = (four_2bit_pels >> 4) & 3;
-                            out_pixel   = input_buffer[k * 4 + 1 + j * input_picture_ptr->stride_y]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 1 + j * recon_ptr->stride_y]);
-
-                            n_bit_pixel = (four_2bit_pels >> 2) & 3;
-                            out_pixel   = input_buffer[k * 4 + 2 + j * input_picture_ptr->stride_y]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 2 + j * recon_ptr->stride_y]);
-
-                            n_bit_pixel = (four_2bit_pels >> 0) & 3;
-                            out_pixel   = input_buffer[k * 4 + 3 + j * input_picture_ptr->stride_y]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 3 + j * recon_ptr->stride_y]);
-                        }
-                    }
-
-                    //U+V
-
-                    tb_origin_x = sb_num_in_width * 32;
-                    tb_origin_y = sb_num_in_height * 32;
-                    sb_width =
-                        (chroma_width - tb_origin_x) < 32 ? (chroma_width - tb_origin_x) : 32;
-                    sb_height =
-                        (chroma_height - tb_origin_y) < 32 ? (chroma_height - tb_origin_y) : 32;
-
-                    inn_stride = sb_width / 4;
-
-                    input_buffer = input_buffer_org_u + tb_origin_y * input_picture_ptr->stride_cb +
-                                   tb_origin_x;
-
-                    input_buffer_bit_inc = input_picture_ptr->buffer_bit_inc_cb +
-                                           tb_origin_y * chroma_2bit_width +
-                                           (tb_origin_x / 4) * sb_height;
-
-                    recon_coeff_buffer =
-                        recon_buffer_org_u + tb_origin_y * recon_ptr->stride_cb + tb_origin_x;
-
-                    for (j = 0; j < sb_height; j++) {
-                        for (k = 0; k < sb_width / 4; k++) {
-                            four_2bit_pels = input_buffer_bit_inc[k + j * inn_stride];
-
-                            n_bit_pixel = (four_2bit_pels >> 6) & 3;
-                            out_pixel   = input_buffer[k * 4 + 0 + j * input_picture_ptr->stride_cb]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_u += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 0 + j * recon_ptr->stride_cb]);
-
-                            n_bit_pixel = (four_2bit_pels >> 4) & 3;
-                            out_pixel   = input_buffer[k * 4 + 1 + j * input_picture_ptr->stride_cb]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_u += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 1 + j * recon_ptr->stride_cb]);
-
-                            n_bit_pixel = (four_2bit_pels >> 2) & 3;
-                            out_pixel   = input_buffer[k * 4 + 2 + j * input_picture_ptr->stride_cb]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_u += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 2 + j * recon_ptr->stride_cb]);
-
-                            n_bit_pixel = (four_2bit_pels >> 0) & 3;
-                            out_pixel   = input_buffer[k * 4 + 3 + j * input_picture_ptr->stride_cb]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_u += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 3 + j * recon_ptr->stride_cb]);
-                        }
-                    }
-
-                    input_buffer = input_buffer_org_v + tb_origin_y * input_picture_ptr->stride_cr +
-                                   tb_origin_x;
-                    input_buffer_bit_inc = input_picture_ptr->buffer_bit_inc_cr +
-                                           tb_origin_y * chroma_2bit_width +
-                                           (tb_origin_x / 4) * sb_height;
-                    recon_coeff_buffer =
-                        recon_buffer_org_v + tb_origin_y * recon_ptr->stride_cr + tb_origin_x;
-
-                    for (j = 0; j < sb_height; j++) {
-                        for (k = 0; k < sb_width / 4; k++) {
-                            four_2bit_pels = input_buffer_bit_inc[k + j * inn_stride];
-
-                            n_bit_pixel = (four_2bit_pels >> 6) & 3;
-                            out_pixel   = input_buffer[k * 4 + 0 + j * input_picture_ptr->stride_cr]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_v += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 0 + j * recon_ptr->stride_cr]);
-
-                            n_bit_pixel = (four_2bit_pels >> 4) & 3;
-                            out_pixel   = input_buffer[k * 4 + 1 + j * input_picture_ptr->stride_cr]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_v += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 1 + j * recon_ptr->stride_cr]);
-
-                            n_bit_pixel = (four_2bit_pels >> 2) & 3;
-                            out_pixel   = input_buffer[k * 4 + 2 + j * input_picture_ptr->stride_cr]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_v += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 2 + j * recon_ptr->stride_cr]);
-
-                            n_bit_pixel = (four_2bit_pels >> 0) & 3;
-                            out_pixel   = input_buffer[k * 4 + 3 + j * input_picture_ptr->stride_cr]
-                                        << 2;
-                            out_pixel = out_pixel | n_bit_pixel;
-                            residual_distortion_v += (int64_t)SQR(
-                                (int64_t)out_pixel -
-                                (int64_t)recon_coeff_buffer[k * 4 + 3 + j * recon_ptr->stride_cr]);
-                        }
-                    }
-                }
-            }
-
-            sse_total[0] = residual_distortion;
-            sse_total[1] = residual_distortion_u;
-            sse_total[2] = residual_distortion_v;
-        } else {
-            recon_coeff_buffer = (uint16_t *)(&(
-                (recon_ptr->buffer_y)[(recon_ptr->origin_x << is_16bit) +
-                                      (recon_ptr->origin_y << is_16bit) * recon_ptr->stride_y]));
-
-            // if current source picture was temporally filtered, use an alternative buffer which stores
-            // the original source picture
-            EbByte buffer_y, buffer_bit_inc_y;
-            EbByte buffer_cb, buffer_bit_inc_cb;
-            EbByte buffer_cr, buffer_bit_inc_cr;
-
-            if (pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-                buffer_y          = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[0];
-                buffer_bit_inc_y  = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[0];
-                buffer_cb         = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[1];
-                buffer_bit_inc_cb = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[1];
-                buffer_cr         = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_ptr[2];
-                buffer_bit_inc_cr = pcs_ptr->parent_pcs_ptr->save_enhanced_picture_bit_inc_ptr[2];
-            } else {
-                buffer_y          = input_picture_ptr->buffer_y;
-                buffer_bit_inc_y  = input_picture_ptr->buffer_bit_inc_y;
-                buffer_cb         = input_picture_ptr->buffer_cb;
-                buffer_bit_inc_cb = input_picture_ptr->buffer_bit_inc_cb;
-                buffer_cr         = input_picture_ptr->buffer_cr;
-                buffer_bit_inc_cr = input_picture_ptr->buffer_bit_inc_cr;
-            }
-
-            input_buffer         = &((buffer_y)[input_picture_ptr->origin_x +
-                                        input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            input_buffer_bit_inc = &((buffer_bit_inc_y)[input_picture_ptr->origin_x +
-                                                        input_picture_ptr->origin_y *
-                                                            input_picture_ptr->stride_bit_inc_y]);
-
-            residual_distortion = 0;
-
-            for (int row_index = 0;
-                 row_index < input_picture_ptr->height - scs_ptr->max_input_pad_bottom;
-                 ++row_index) {
-                for (int column_index = 0; column_index <
-                     input_picture_ptr->width - scs_ptr->max_input_pad_right;
-                     ++column_index) {
-                    residual_distortion +=
-                        (int64_t)SQR((int64_t)((((input_buffer[column_index]) << 2) |
-                                                ((input_buffer_bit_inc[column_index] >> 6) & 3))) -
-                                     (recon_coeff_buffer[column_index]));
-                }
-
-                input_buffer += input_picture_ptr->stride_y;
-                input_buffer_bit_inc += input_picture_ptr->stride_bit_inc_y;
-                recon_coeff_buffer += recon_ptr->stride_y;
-            }
-
-            sse_total[0] = residual_distortion;
-
-            recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cb)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cb]));
-            input_buffer =
-                &((buffer_cb)[input_picture_ptr->origin_x / 2 +
-                              input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cb]);
-            input_buffer_bit_inc = &((buffer_bit_inc_cb)[input_picture_ptr->origin_x / 2 +
-                                                         input_picture_ptr->origin_y / 2 *
-                                                             input_picture_ptr->stride_bit_inc_cb]);
-
-            residual_distortion = 0;
-            for (int row_index = 0; row_index <
-                 (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >> ss_y;
-                 ++row_index) {
-                for (int column_index = 0; column_index <
-                     (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
-                     ++column_index) {
-                    residual_distortion +=
-                        (int64_t)SQR((int64_t)((((input_buffer[column_index]) << 2) |
-                                                ((input_buffer_bit_inc[column_index] >> 6) & 3))) -
-                                     (recon_coeff_buffer[column_index]));
-                }
-
-                input_buffer += input_picture_ptr->stride_cb;
-                input_buffer_bit_inc += input_picture_ptr->stride_bit_inc_cb;
-                recon_coeff_buffer += recon_ptr->stride_cb;
-            }
-
-            sse_total[1] = residual_distortion;
-
-            recon_coeff_buffer =
-                (uint16_t *)(&((recon_ptr->buffer_cr)[(recon_ptr->origin_x << is_16bit) / 2 +
-                                                      (recon_ptr->origin_y << is_16bit) / 2 *
-                                                          recon_ptr->stride_cr]));
-            input_buffer =
-                &((buffer_cr)[input_picture_ptr->origin_x / 2 +
-                              input_picture_ptr->origin_y / 2 * input_picture_ptr->stride_cr]);
-            input_buffer_bit_inc = &((buffer_bit_inc_cr)[input_picture_ptr->origin_x / 2 +
-                                                         input_picture_ptr->origin_y / 2 *
-                                                             input_picture_ptr->stride_bit_inc_cr]);
-
-            residual_distortion = 0;
-
-            for (int row_index = 0; row_index <
-                 (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >> ss_y;
-                 ++row_index) {
-                for (int column_index = 0; column_index <
-                     (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
-                     ++column_index) {
-                    residual_distortion +=
-                        (int64_t)SQR((int64_t)((((input_buffer[column_index]) << 2) |
-                                                ((input_buffer_bit_inc[column_index] >> 6) & 3))) -
-                                     (recon_coeff_buffer[column_index]));
-                }
-
-                input_buffer += input_picture_ptr->stride_cr;
-                input_buffer_bit_inc += input_picture_ptr->stride_bit_inc_cr;
-                recon_coeff_buffer += recon_ptr->stride_cr;
-            }
-
-            sse_total[2] = residual_distortion;
-
-            if (free_memory && pcs_ptr->parent_pcs_ptr->temporal_filtering_on == EB_TRUE) {
-                EB_FREE_ARRAY(buffer_y);
-                EB_FREE_ARRAY(buffer_cb);
-                EB_FREE_ARRAY(buffer_cr);
-                EB_FREE_ARRAY(buffer_bit_inc_y);
-                EB_FREE_ARRAY(buffer_bit_inc_cb);
-                EB_FREE_ARRAY(buffer_bit_inc_cr);
-           }
-        }
-
-        pcs_ptr->parent_pcs_ptr->luma_sse = (uint32_t)sse_total[0];
-        pcs_ptr->parent_pcs_ptr->cb_sse   = (uint32_t)sse_total[1];
-        pcs_ptr->parent_pcs_ptr->cr_sse   = (uint32_t)sse_total[2];
-    }
-}
-
 void pad_ref_and_set_flags(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
     EbReferenceObject *reference_object =
         (EbReferenceObject *)pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
@@ -4238,13 +3362,13 @@ static void recode_loop_decision_maker(PictureControlSet *pcs_ptr,
         ppcs_ptr->loop_count++;
 
         frm_hdr->quantization_params.base_q_idx = (uint8_t)CLIP3(
-                (int32_t)quantizer_to_qindex[scs_ptr->static_config.min_qp_allowed],
-                (int32_t)quantizer_to_qindex[scs_ptr->static_config.max_qp_allowed],
+                (int32_t)quantizer_to_qindex[ppcs_ptr->min_qp_allowed],
+                (int32_t)quantizer_to_qindex[ppcs_ptr->max_qp_allowed],
                 q);
 
         ppcs_ptr->picture_qp =
-            (uint8_t)CLIP3((int32_t)scs_ptr->static_config.min_qp_allowed,
-                    (int32_t)scs_ptr->static_config.max_qp_allowed,
+            (uint8_t)CLIP3((int32_t)ppcs_ptr->min_qp_allowed,
+                    (int32_t)ppcs_ptr->max_qp_allowed,
                     (frm_hdr->quantization_params.base_q_idx + 2) >> 2);
         pcs_ptr->picture_qp = ppcs_ptr->picture_qp;
 
@@ -4274,6 +3398,37 @@ static void init_avail_blk_flag(SequenceControlSet *scs_ptr, ModeDecisionContext
     memset(context_ptr->avail_blk_flag, EB_FALSE, sizeof(uint8_t) * scs_ptr->max_block_cnt);
 }
 /* EncDec (Encode Decode) Kernel */
+/******************************************************
+ * Post EncDec Results
+ * Posts the results of a fully coded picture to DLF, with
+ * sb_row_step SB rows per result so that several DLF
+ * threads can deblock the picture
+ ******************************************************/
+static void post_enc_dec_results(EncDecContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                                 uint32_t picture_height_in_sb, uint32_t sb_row_step) {
+    PictureControlSet *pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    EbObjectWrapper *  enc_dec_results_wrapper_ptr;
+    EncDecResults *    enc_dec_results_ptr;
+
+    // Reset the DLF SB row sync of the picture
+    pcs_ptr->dlf_init_started    = EB_FALSE;
+    pcs_ptr->dlf_init_done       = EB_FALSE;
+    pcs_ptr->dlf_init_wait_count = 0;
+    pcs_ptr->tot_sb_rows_dlf     = 0;
+
+    for (uint32_t y_sb_index = 0; y_sb_index < picture_height_in_sb; y_sb_index += sb_row_step) {
+        // Get Empty EncDec Results
+        svt_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
+        enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
+        enc_dec_results_ptr->pcs_wrapper_ptr              = pcs_wrapper_ptr;
+        enc_dec_results_ptr->completed_sb_row_index_start = y_sb_index;
+        enc_dec_results_ptr->completed_sb_row_count =
+            MIN(sb_row_step, picture_height_in_sb - y_sb_index);
+        // Post EncDec Results
+        svt_post_full_object(enc_dec_results_wrapper_ptr);
+    }
+}
+
 /*********************************************************************************
 *
 * @brief
@@ -4311,17 +3466,11 @@ static void init_avail_blk_flag(SequenceControlSet *scs_ptr, ModeDecisionContext
 *  elements to be sent to the entropy coding engine
 *
 ********************************************************************************/
-void *mode_decision_kernel(void *input_ptr) {
+void mode_decision_task(EbPtr input_ptr, EbObjectWrapper *enc_dec_tasks_wrapper_ptr) {
     // Context & SCS & PCS
     EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
     EncDecContext *     context_ptr        = (EncDecContext *)thread_context_ptr->priv;
 
-    // Input
-    EbObjectWrapper *enc_dec_tasks_wrapper_ptr;
-
-    // Output
-    EbObjectWrapper *enc_dec_results_wrapper_ptr;
-    EncDecResults *  enc_dec_results_ptr;
     // SB Loop variables
     SuperBlock *sb_ptr;
     uint16_t    sb_index;
@@ -4345,223 +3494,280 @@ void *mode_decision_kernel(void *input_ptr) {
 
     segment_index = 0;
 
-    for (;;) {
-        // Get Mode Decision Results
-        EB_GET_FULL_OBJECT(context_ptr->mode_decision_input_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
-
-        EncDecTasks *    enc_dec_tasks_ptr    = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
-        PictureControlSet * pcs_ptr           = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
-        SequenceControlSet *scs_ptr           = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        context_ptr->tile_group_index = enc_dec_tasks_ptr->tile_group_index;
-        context_ptr->coded_sb_count   = 0;
-        segments_ptr = pcs_ptr->enc_dec_segment_ctrl[context_ptr->tile_group_index];
-        // SB Constants
-        uint8_t sb_sz      = (uint8_t)scs_ptr->sb_size_pix;
-        uint8_t sb_size_log2 = (uint8_t)svt_log2f(sb_sz);
-        context_ptr->sb_sz = sb_sz;
-        uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
-            sb_size_log2;
-        uint16_t tile_group_width_in_sb = pcs_ptr->parent_pcs_ptr
-                                              ->tile_group_info[context_ptr->tile_group_index]
-                                              .tile_group_width_in_sb;
-        context_ptr->tot_intra_coded_area       = 0;
-        // Bypass encdec for the first pass
-        if (use_output_stat(scs_ptr)) {
-
-            svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
-            pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
-            // Get Empty EncDec Results
-            svt_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
-            enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-            enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-            enc_dec_results_ptr->completed_sb_row_index_start = 0;
-            enc_dec_results_ptr->completed_sb_row_count =
-                ((pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2);
-            // Post EncDec Results
-            svt_post_full_object(enc_dec_results_wrapper_ptr);
-        }
-        else{
-        memset(context_ptr->md_context->part_cnt, 0, sizeof(uint32_t) * SSEG_NUM * (NUMBER_OF_SHAPES-1) * FB_NUM);
-        generate_nsq_prob(pcs_ptr, context_ptr->md_context);
-        memset(context_ptr->md_context->pred_depth_count, 0, sizeof(uint32_t) * DEPTH_DELTA_NUM * (NUMBER_OF_SHAPES-1));
-        generate_depth_prob(pcs_ptr, context_ptr->md_context);
-        memset( context_ptr->md_context->txt_cnt, 0, sizeof(uint32_t) * TXT_DEPTH_DELTA_NUM * TX_TYPES);
-        generate_txt_prob(pcs_ptr, context_ptr->md_context);
-
-        if (!pcs_ptr->cdf_ctrl.update_mv)
-            copy_mv_rate(pcs_ptr, &context_ptr->md_context->rate_est_table);
-        if (!pcs_ptr->cdf_ctrl.update_se)
-            av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
-                pcs_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
-                &pcs_ptr->md_frame_context);
-        if (!pcs_ptr->cdf_ctrl.update_coef)
-            av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
-                &pcs_ptr->md_frame_context);
-        // Segment-loop
-        while (assign_enc_dec_segments(segments_ptr,
-                                       &segment_index,
-                                       enc_dec_tasks_ptr,
-                                       context_ptr->enc_dec_feedback_fifo_ptr) == EB_TRUE) {
-            x_sb_start_index = segments_ptr->x_start_array[segment_index];
-            y_sb_start_index = segments_ptr->y_start_array[segment_index];
-            sb_start_index = y_sb_start_index * tile_group_width_in_sb + x_sb_start_index;
-            sb_segment_count = segments_ptr->valid_sb_count_array[segment_index];
-
-            segment_row_index = segment_index / segments_ptr->segment_band_count;
-            segment_band_index =
-                segment_index - segment_row_index * segments_ptr->segment_band_count;
-            segment_band_size = (segments_ptr->sb_band_count * (segment_band_index + 1) +
-                                 segments_ptr->segment_band_count - 1) /
-                                segments_ptr->segment_band_count;
-
-            // Reset Coding Loop State
-            reset_mode_decision(scs_ptr,
-                                context_ptr->md_context,
-                                pcs_ptr,
-                                context_ptr->tile_group_index,
-                                segment_index);
-
-            // Reset EncDec Coding State
-            reset_enc_dec( // HT done
-                context_ptr,
-                pcs_ptr,
-                scs_ptr,
-                segment_index);
-
-            if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
-                ((EbReferenceObject *)
-                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                    ->average_intensity = pcs_ptr->parent_pcs_ptr->average_intensity[0];
-            for (y_sb_index = y_sb_start_index, sb_segment_index = sb_start_index;
+    EncDecTasks *    enc_dec_tasks_ptr    = (EncDecTasks *)enc_dec_tasks_wrapper_ptr->object_ptr;
+    PictureControlSet * pcs_ptr           = (PictureControlSet *)enc_dec_tasks_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr           = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    context_ptr->tile_group_index = enc_dec_tasks_ptr->tile_group_index;
+    context_ptr->coded_sb_count   = 0;
+    segments_ptr = pcs_ptr->enc_dec_segment_ctrl[context_ptr->tile_group_index];
+    // SB Constants
+    uint8_t sb_sz      = (uint8_t)scs_ptr->sb_size_pix;
+    uint8_t sb_size_log2 = (uint8_t)svt_log2f(sb_sz);
+    context_ptr->sb_sz = sb_sz;
+    uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
+        sb_size_log2;
+    uint16_t tile_group_width_in_sb = pcs_ptr->parent_pcs_ptr
+                                          ->tile_group_info[context_ptr->tile_group_index]
+                                          .tile_group_width_in_sb;
+    context_ptr->tot_intra_coded_area       = 0;
+    // Bypass encdec for the first pass
+    if (use_output_stat(scs_ptr)) {
+
+        svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
+        pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
+        // Post EncDec Results
+        uint32_t picture_height_in_sb =
+            (pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2;
+        post_enc_dec_results(context_ptr,
+                             enc_dec_tasks_ptr->pcs_wrapper_ptr,
+                             picture_height_in_sb,
+                             picture_height_in_sb);
+    }
+    else{
+    memset(context_ptr->md_context->part_cnt, 0, sizeof(uint32_t) * SSEG_NUM * (NUMBER_OF_SHAPES-1) * FB_NUM);
+    generate_nsq_prob(pcs_ptr, context_ptr->md_context);
+    memset(context_ptr->md_context->pred_depth_count, 0, sizeof(uint32_t) * DEPTH_DELTA_NUM * (NUMBER_OF_SHAPES-1));
+    generate_depth_prob(pcs_ptr, context_ptr->md_context);
+    memset( context_ptr->md_context->txt_cnt, 0, sizeof(uint32_t) * TXT_DEPTH_DELTA_NUM * TX_TYPES);
+    generate_txt_prob(pcs_ptr, context_ptr->md_context);
+
+    if (!pcs_ptr->cdf_ctrl.update_mv)
+        copy_mv_rate(pcs_ptr, &context_ptr->md_context->rate_est_table);
+    if (!pcs_ptr->cdf_ctrl.update_se)
+        av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
+            pcs_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
+            &pcs_ptr->md_frame_context,
+            NULL);
+    if (!pcs_ptr->cdf_ctrl.update_coef)
+        av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
+            &pcs_ptr->md_frame_context,
+            NULL);
+    context_ptr->md_context->rate_est_fc_valid = EB_FALSE;
+    // Segment-loop
+    while (assign_enc_dec_segments(segments_ptr,
+                                   &segment_index,
+                                   enc_dec_tasks_ptr,
+                                   context_ptr->enc_dec_feedback_fifo_ptr) == EB_TRUE) {
+        x_sb_start_index = segments_ptr->x_start_array[segment_index];
+        y_sb_start_index = segments_ptr->y_start_array[segment_index];
+        sb_start_index = y_sb_start_index * tile_group_width_in_sb + x_sb_start_index;
+        sb_segment_count = segments_ptr->valid_sb_count_array[segment_index];
+
+        segment_row_index = segment_index / segments_ptr->segment_band_count;
+        segment_band_index =
+            segment_index - segment_row_index * segments_ptr->segment_band_count;
+        segment_band_size = (segments_ptr->sb_band_count * (segment_band_index + 1) +
+                             segments_ptr->segment_band_count - 1) /
+                            segments_ptr->segment_band_count;
+
+        // Reset Coding Loop State
+        reset_mode_decision(scs_ptr,
+                            context_ptr->md_context,
+                            pcs_ptr,
+                            context_ptr->tile_group_index,
+                            segment_index);
+
+        // Reset EncDec Coding State
+        reset_enc_dec( // HT done
+            context_ptr,
+            pcs_ptr,
+            scs_ptr,
+            segment_index);
+
+        if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
+            ((EbReferenceObject *)
+                 pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                ->average_intensity = pcs_ptr->parent_pcs_ptr->average_intensity[0];
+        for (y_sb_index = y_sb_start_index, sb_segment_index = sb_start_index;
+             sb_segment_index < sb_start_index + sb_segment_count;
+             ++y_sb_index) {
+            for (x_sb_index = x_sb_start_index;
+                 x_sb_index < tile_group_width_in_sb &&
+                 (x_sb_index + y_sb_index < segment_band_size) &&
                  sb_segment_index < sb_start_index + sb_segment_count;
-                 ++y_sb_index) {
-                for (x_sb_index = x_sb_start_index;
-                     x_sb_index < tile_group_width_in_sb &&
-                     (x_sb_index + y_sb_index < segment_band_size) &&
-                     sb_segment_index < sb_start_index + sb_segment_count;
-                     ++x_sb_index, ++sb_segment_index) {
-                    uint16_t tile_group_y_sb_start =
-                        pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
-                            .tile_group_sb_start_y;
-                    uint16_t tile_group_x_sb_start =
-                        pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
-                            .tile_group_sb_start_x;
-                    sb_index = context_ptr->md_context->sb_index =(uint16_t)((y_sb_index + tile_group_y_sb_start) * pic_width_in_sb +
-                        x_sb_index + tile_group_x_sb_start);
-                    sb_ptr = context_ptr->md_context->sb_ptr = pcs_ptr->sb_ptr_array[sb_index];
-                    sb_origin_x = (x_sb_index + tile_group_x_sb_start) << sb_size_log2;
-                    sb_origin_y = (y_sb_index + tile_group_y_sb_start) << sb_size_log2;
-                    //printf("[%ld]:ED sb index %d, (%d, %d), encoded total sb count %d, ctx coded sb count %d\n",
-                    //        pcs_ptr->picture_number,
-                    //        sb_index, sb_origin_x, sb_origin_y,
-                    //        pcs_ptr->enc_dec_coded_sb_count,
-                    //        context_ptr->coded_sb_count);
-                    context_ptr->tile_index             = sb_ptr->tile_info.tile_rs_index;
-                    context_ptr->md_context->tile_index = sb_ptr->tile_info.tile_rs_index;
-                    context_ptr->md_context->sb_origin_x = sb_origin_x;
-                    context_ptr->md_context->sb_origin_y = sb_origin_y;
-                    mdc_ptr = context_ptr->md_context->mdc_sb_array;
-                    context_ptr->sb_index = sb_index;
-                    context_ptr->md_context->sb_class = NONE_CLASS;
-
-                    if (pcs_ptr->cdf_ctrl.enabled) {
-                        if (scs_ptr->seq_header.pic_based_rate_est &&
-                            scs_ptr->enc_dec_segment_row_count_array[pcs_ptr->temporal_layer_index] == 1 &&
-                            scs_ptr->enc_dec_segment_col_count_array[pcs_ptr->temporal_layer_index] == 1) {
-                            if (sb_index == 0)
-                                pcs_ptr->ec_ctx_array[sb_index] =  pcs_ptr->md_frame_context;
-                            else
-                                pcs_ptr->ec_ctx_array[sb_index] = pcs_ptr->ec_ctx_array[sb_index - 1];
-                        }
+                 ++x_sb_index, ++sb_segment_index) {
+                uint16_t tile_group_y_sb_start =
+                    pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
+                        .tile_group_sb_start_y;
+                uint16_t tile_group_x_sb_start =
+                    pcs_ptr->parent_pcs_ptr->tile_group_info[context_ptr->tile_group_index]
+                        .tile_group_sb_start_x;
+                sb_index = context_ptr->md_context->sb_index =(uint16_t)((y_sb_index + tile_group_y_sb_start) * pic_width_in_sb +
+                    x_sb_index + tile_group_x_sb_start);
+                sb_ptr = context_ptr->md_context->sb_ptr = pcs_ptr->sb_ptr_array[sb_index];
+                sb_origin_x = (x_sb_index + tile_group_x_sb_start) << sb_size_log2;
+                sb_origin_y = (y_sb_index + tile_group_y_sb_start) << sb_size_log2;
+                //printf("[%ld]:ED sb index %d, (%d, %d), encoded total sb count %d, ctx coded sb count %d\n",
+                //        pcs_ptr->picture_number,
+                //        sb_index, sb_origin_x, sb_origin_y,
+                //        pcs_ptr->enc_dec_coded_sb_count,
+                //        context_ptr->coded_sb_count);
+                context_ptr->tile_index             = sb_ptr->tile_info.tile_rs_index;
+                context_ptr->md_context->tile_index = sb_ptr->tile_info.tile_rs_index;
+                context_ptr->md_context->sb_origin_x = sb_origin_x;
+                context_ptr->md_context->sb_origin_y = sb_origin_y;
+                mdc_ptr = context_ptr->md_context->mdc_sb_array;
+                context_ptr->sb_index = sb_index;
+                context_ptr->md_context->sb_class = NONE_CLASS;
+
+                if (pcs_ptr->cdf_ctrl.enabled) {
+                    if (scs_ptr->seq_header.pic_based_rate_est &&
+                        scs_ptr->enc_dec_segment_row_count_array[pcs_ptr->temporal_layer_index] == 1 &&
+                        scs_ptr->enc_dec_segment_col_count_array[pcs_ptr->temporal_layer_index] == 1) {
+                        // Chain the CDFs in raster order within the tile group, the SBs of
+                        // the other tile groups may be coded at the same time
+                        if (x_sb_index == 0 && y_sb_index == 0)
+                            pcs_ptr->ec_ctx_array[sb_index] =  pcs_ptr->md_frame_context;
+                        else if (x_sb_index == 0)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb +
+                                                      tile_group_width_in_sb - 1];
+                        else
+                            pcs_ptr->ec_ctx_array[sb_index] = pcs_ptr->ec_ctx_array[sb_index - 1];
+                    }
+                    else {
+                        // Use the latest available CDF for the current SB
+                        // Use the weighted average of left (3x) and top right (1x) if available.
+                        int8_t top_right_available =
+                            ((int32_t)(sb_origin_y >> MI_SIZE_LOG2) >
+                             sb_ptr->tile_info.mi_row_start) &&
+                            ((int32_t)((sb_origin_x + (1 << sb_size_log2)) >> MI_SIZE_LOG2) <
+                             sb_ptr->tile_info.mi_col_end);
+
+                        int8_t left_available = ((int32_t)(sb_origin_x >> MI_SIZE_LOG2) >
+                                                 sb_ptr->tile_info.mi_col_start);
+
+                        if (!left_available && !top_right_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                              pcs_ptr->md_frame_context;
+                        else if (!left_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1];
+                        else if (!top_right_available)
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - 1];
                         else {
-                            // Use the latest available CDF for the current SB
-                            // Use the weighted average of left (3x) and top right (1x) if available.
-                            int8_t top_right_available =
-                                ((int32_t)(sb_origin_y >> MI_SIZE_LOG2) >
-                                 sb_ptr->tile_info.mi_row_start) &&
-                                ((int32_t)((sb_origin_x + (1 << sb_size_log2)) >> MI_SIZE_LOG2) <
-                                 sb_ptr->tile_info.mi_col_end);
-
-                            int8_t left_available = ((int32_t)(sb_origin_x >> MI_SIZE_LOG2) >
-                                                     sb_ptr->tile_info.mi_col_start);
-
-                            if (!left_available && !top_right_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                  pcs_ptr->md_frame_context;
-                            else if (!left_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1];
-                            else if (!top_right_available)
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - 1];
-                            else {
-                                pcs_ptr->ec_ctx_array[sb_index] =
-                                    pcs_ptr->ec_ctx_array[sb_index - 1];
-                                avg_cdf_symbols(
-                                    &pcs_ptr->ec_ctx_array[sb_index],
-                                    &pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1],
-                                    AVG_CDF_WEIGHT_LEFT,
-                                    AVG_CDF_WEIGHT_TOP);
-                            }
+                            pcs_ptr->ec_ctx_array[sb_index] =
+                                pcs_ptr->ec_ctx_array[sb_index - 1];
+                            avg_cdf_symbols(
+                                &pcs_ptr->ec_ctx_array[sb_index],
+                                &pcs_ptr->ec_ctx_array[sb_index - pic_width_in_sb + 1],
+                                AVG_CDF_WEIGHT_LEFT,
+                                AVG_CDF_WEIGHT_TOP);
                         }
-                        // Initial Rate Estimation of the syntax elements
-                        if (pcs_ptr->cdf_ctrl.update_se)
-                        av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
-                            pcs_ptr->slice_type == I_SLICE,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-                        // Initial Rate Estimation of the Motion vectors
-                        if (pcs_ptr->cdf_ctrl.update_mv)
-                        av1_estimate_mv_rate(pcs_ptr,
-                            &context_ptr->md_context->rate_est_table,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-
-                        if (pcs_ptr->cdf_ctrl.update_coef)
-                        av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
-                            &pcs_ptr->ec_ctx_array[sb_index]);
-
-                        //let the candidate point to the new rate table.
-                        uint32_t cand_index;
-                        for (cand_index = 0; cand_index < MODE_DECISION_CANDIDATE_MAX_COUNT;
-                            ++cand_index)
-                            context_ptr->md_context->fast_candidate_ptr_array[cand_index]
-                            ->md_rate_estimation_ptr = &context_ptr->md_context->rate_est_table;
-                        context_ptr->md_context->md_rate_estimation_ptr =
-                            &context_ptr->md_context->rate_est_table;
                     }
-                    // Configure the SB
-                    mode_decision_configure_sb(
-                        context_ptr->md_context, pcs_ptr, (uint8_t)sb_ptr->qindex);
-                    // Multi-Pass PD
-                    if ((pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_0 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
-                         pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4)
-                        ) {
-                        // Save a clean copy of the neighbor arrays
-                        copy_neighbour_arrays(pcs_ptr,
-                                              context_ptr->md_context,
-                                              MD_NEIGHBOR_ARRAY_INDEX,
-                                              MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
-                                              0,
-                                              sb_origin_x,
-                                              sb_origin_y);
+                    // Only the CDFs that changed since the previous SB of this task are
+                    // re-costed, the rest of the table is still valid
+                    const FRAME_CONTEXT *built_fc = context_ptr->md_context->rate_est_fc_valid
+                        ? &context_ptr->md_context->rate_est_fc
+                        : NULL;
+                    // Initial Rate Estimation of the syntax elements
+                    if (pcs_ptr->cdf_ctrl.update_se)
+                    av1_estimate_syntax_rate(&context_ptr->md_context->rate_est_table,
+                        pcs_ptr->slice_type == I_SLICE,
+                        &pcs_ptr->ec_ctx_array[sb_index],
+                        built_fc);
+                    // Initial Rate Estimation of the Motion vectors
+                    if (pcs_ptr->cdf_ctrl.update_mv)
+                    av1_estimate_mv_rate(pcs_ptr,
+                        &context_ptr->md_context->rate_est_table,
+                        &pcs_ptr->ec_ctx_array[sb_index],
+                        built_fc);
+
+                    if (pcs_ptr->cdf_ctrl.update_coef)
+                    av1_estimate_coefficients_rate(&context_ptr->md_context->rate_est_table,
+                        &pcs_ptr->ec_ctx_array[sb_index],
+                        built_fc);
+                    context_ptr->md_context->rate_est_fc       = pcs_ptr->ec_ctx_array[sb_index];
+                    context_ptr->md_context->rate_est_fc_valid = EB_TRUE;
+
+                    //let the candidate point to the new rate table.
+                    uint32_t cand_index;
+                    for (cand_index = 0; cand_index < MODE_DECISION_CANDIDATE_MAX_COUNT;
+                        ++cand_index)
+                        context_ptr->md_context->fast_candidate_ptr_array[cand_index]
+                        ->md_rate_estimation_ptr = &context_ptr->md_context->rate_est_table;
+                    context_ptr->md_context->md_rate_estimation_ptr =
+                        &context_ptr->md_context->rate_est_table;
+                }
+                // Configure the SB
+                mode_decision_configure_sb(
+                    context_ptr->md_context, pcs_ptr, (uint8_t)sb_ptr->qindex);
+                // Multi-Pass PD
+                if ((pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_0 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
+                     pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4)
+                    ) {
+                    // Save a clean copy of the neighbor arrays
+                    copy_neighbour_arrays(pcs_ptr,
+                                          context_ptr->md_context,
+                                          MD_NEIGHBOR_ARRAY_INDEX,
+                                          MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
+                                          0,
+                                          sb_origin_x,
+                                          sb_origin_y);
+
+                    // [PD_PASS_0] Signal(s) derivation
+                    context_ptr->md_context->pd_pass = PD_PASS_0;
+                    signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+
+                    // [PD_PASS_0]
+                    // Input : mdc_blk_ptr built @ mdc process (up to 4421)
+                    // Output: md_blk_arr_nsq reduced set of block(s)
 
-                        // [PD_PASS_0] Signal(s) derivation
-                        context_ptr->md_context->pd_pass = PD_PASS_0;
-                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                    // Build the t=0 cand_block_array
+                    build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                    // Initialize avail_blk_flag to false
+                    init_avail_blk_flag(scs_ptr, context_ptr->md_context);
 
-                        // [PD_PASS_0]
-                        // Input : mdc_blk_ptr built @ mdc process (up to 4421)
-                        // Output: md_blk_arr_nsq reduced set of block(s)
+                    // PD0 MD Tool(s) : ME_MV(s) as INTER candidate(s), DC as INTRA candidate, luma only, Frequency domain SSE,
+                    // no fast rate (no MVP table generation), MDS0 then MDS3, reduced NIC(s), 1 ref per list,..
+                    mode_decision_sb(scs_ptr,
+                                     pcs_ptr,
+                                     mdc_ptr,
+                                     sb_ptr,
+                                     sb_origin_x,
+                                     sb_origin_y,
+                                     sb_index,
+                                     context_ptr->md_context);
+                        context_ptr->md_context->sb_class = determine_sb_class(
+                            scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
-                        // Build the t=0 cand_block_array
-                        build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                    // Perform Pred_0 depth refinement - add depth(s) to be considered in the next stage(s)
+                    perform_pred_depth_refinement(
+                        scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+
+                    // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
+                    // Reset neighnor information to current SB @ position (0,0)
+                    copy_neighbour_arrays(pcs_ptr,
+                                          context_ptr->md_context,
+                                          MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
+                                          MD_NEIGHBOR_ARRAY_INDEX,
+                                          0,
+                                          sb_origin_x,
+                                          sb_origin_y);
+
+                    if (pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
+                        pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4) {
+                        // [PD_PASS_1] Signal(s) derivation
+                        context_ptr->md_context->pd_pass = PD_PASS_1;
+                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                        // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
+                        build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
                         // Initialize avail_blk_flag to false
                         init_avail_blk_flag(scs_ptr, context_ptr->md_context);
 
-                        // PD0 MD Tool(s) : ME_MV(s) as INTER candidate(s), DC as INTRA candidate, luma only, Frequency domain SSE,
-                        // no fast rate (no MVP table generation), MDS0 then MDS3, reduced NIC(s), 1 ref per list,..
+                        // [PD_PASS_1] Mode Decision - Further reduce the number of
+                        // depth(s) to be considered in later PD stages. This pass uses more accurate
+                        // info than PD0 to give a better PD estimate.
+                        // Input : mdc_blk_ptr built @ PD0 refinement
+                        // Output: md_blk_arr_nsq reduced set of block(s)
+
+                        // PD1 MD Tool(s): PME,..
                         mode_decision_sb(scs_ptr,
                                          pcs_ptr,
                                          mdc_ptr,
@@ -4570,14 +3776,10 @@ void *mode_decision_kernel(void *input_ptr) {
                                          sb_origin_y,
                                          sb_index,
                                          context_ptr->md_context);
-                            context_ptr->md_context->sb_class = determine_sb_class(
-                                scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
-                        // Perform Pred_0 depth refinement - add depth(s) to be considered in the next stage(s)
+                        // Perform Pred_1 depth refinement - add depth(s) to be considered in the next stage(s)
                         perform_pred_depth_refinement(
                             scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-
-                        // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
                         // Reset neighnor information to current SB @ position (0,0)
                         copy_neighbour_arrays(pcs_ptr,
                                               context_ptr->md_context,
@@ -4586,211 +3788,183 @@ void *mode_decision_kernel(void *input_ptr) {
                                               0,
                                               sb_origin_x,
                                               sb_origin_y);
-
-                        if (pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_1 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_2 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_3 ||
-                            pcs_ptr->parent_pcs_ptr->multi_pass_pd_level == MULTI_PASS_PD_LEVEL_4) {
-                            // [PD_PASS_1] Signal(s) derivation
-                            context_ptr->md_context->pd_pass = PD_PASS_1;
-                            signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
-                            // Re-build mdc_blk_ptr for the 2nd PD Pass [PD_PASS_1]
-                            build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                            // Initialize avail_blk_flag to false
-                            init_avail_blk_flag(scs_ptr, context_ptr->md_context);
-
-                            // [PD_PASS_1] Mode Decision - Further reduce the number of
-                            // depth(s) to be considered in later PD stages. This pass uses more accurate
-                            // info than PD0 to give a better PD estimate.
-                            // Input : mdc_blk_ptr built @ PD0 refinement
-                            // Output: md_blk_arr_nsq reduced set of block(s)
-
-                            // PD1 MD Tool(s): PME,..
-                            mode_decision_sb(scs_ptr,
-                                             pcs_ptr,
-                                             mdc_ptr,
-                                             sb_ptr,
-                                             sb_origin_x,
-                                             sb_origin_y,
-                                             sb_index,
-                                             context_ptr->md_context);
-
-                            // Perform Pred_1 depth refinement - add depth(s) to be considered in the next stage(s)
-                            perform_pred_depth_refinement(
-                                scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                            // Reset neighnor information to current SB @ position (0,0)
-                            copy_neighbour_arrays(pcs_ptr,
-                                                  context_ptr->md_context,
-                                                  MULTI_STAGE_PD_NEIGHBOR_ARRAY_INDEX,
-                                                  MD_NEIGHBOR_ARRAY_INDEX,
-                                                  0,
-                                                  sb_origin_x,
-                                                  sb_origin_y);
-                        }
                     }
-                    // [PD_PASS_2] Signal(s) derivation
-                    context_ptr->md_context->pd_pass = PD_PASS_2;
-                        signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
-                    // Re-build mdc_blk_ptr for the 3rd PD Pass [PD_PASS_2]
-                    if(pcs_ptr->parent_pcs_ptr->multi_pass_pd_level != MULTI_PASS_PD_OFF)
-                    build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    else
-                        // Build the t=0 cand_block_array
-                        build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    // Initialize avail_blk_flag to false
-                    init_avail_blk_flag(scs_ptr, context_ptr->md_context);
-
-                    // [PD_PASS_2] Mode Decision - Obtain the final partitioning decision using more accurate info
-                    // than previous stages.  Reduce the total number of partitions to 1.
-                    // Input : mdc_blk_ptr built @ PD1 refinement
-                    // Output: md_blk_arr_nsq reduced set of block(s)
-
-                    // PD2 MD Tool(s): default MD Tool(s)
-                    mode_decision_sb(scs_ptr,
-                                     pcs_ptr,
-                                     mdc_ptr,
-                                     sb_ptr,
-                                     sb_origin_x,
-                                     sb_origin_y,
-                                     sb_index,
-                                     context_ptr->md_context);
-                    generate_statistics_nsq(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    generate_statistics_depth(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
-                    generate_statistics_txt(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                }
+                // [PD_PASS_2] Signal(s) derivation
+                context_ptr->md_context->pd_pass = PD_PASS_2;
+                    signal_derivation_enc_dec_kernel_oq(scs_ptr, pcs_ptr, context_ptr->md_context);
+                // Re-build mdc_blk_ptr for the 3rd PD Pass [PD_PASS_2]
+                if(pcs_ptr->parent_pcs_ptr->multi_pass_pd_level != MULTI_PASS_PD_OFF)
+                build_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                else
+                    // Build the t=0 cand_block_array
+                    build_starting_cand_block_array(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                // Initialize avail_blk_flag to false
+                init_avail_blk_flag(scs_ptr, context_ptr->md_context);
+
+                // [PD_PASS_2] Mode Decision - Obtain the final partitioning decision using more accurate info
+                // than previous stages.  Reduce the total number of partitions to 1.
+                // Input : mdc_blk_ptr built @ PD1 refinement
+                // Output: md_blk_arr_nsq reduced set of block(s)
+
+                // PD2 MD Tool(s): default MD Tool(s)
+                mode_decision_sb(scs_ptr,
+                                 pcs_ptr,
+                                 mdc_ptr,
+                                 sb_ptr,
+                                 sb_origin_x,
+                                 sb_origin_y,
+                                 sb_index,
+                                 context_ptr->md_context);
+                generate_statistics_nsq(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                generate_statistics_depth(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
+                generate_statistics_txt(scs_ptr, pcs_ptr, context_ptr->md_context, sb_index);
 
 #if NO_ENCDEC
-                    no_enc_dec_pass(scs_ptr,
-                                    pcs_ptr,
-                                    sb_ptr,
-                                    sb_index,
-                                    sb_origin_x,
-                                    sb_origin_y,
-                                    sb_ptr->qp,
-                                    context_ptr);
+                no_enc_dec_pass(scs_ptr,
+                                pcs_ptr,
+                                sb_ptr,
+                                sb_index,
+                                sb_origin_x,
+                                sb_origin_y,
+                                sb_ptr->qp,
+                                context_ptr);
 #else
-                    // Encode Pass
-                    av1_encode_decode(
-                        scs_ptr, pcs_ptr, sb_ptr, sb_index, sb_origin_x, sb_origin_y, context_ptr);
+                // Encode Pass
+                av1_encode_decode(
+                    scs_ptr, pcs_ptr, sb_ptr, sb_index, sb_origin_x, sb_origin_y, context_ptr);
 #endif
 
-                    context_ptr->coded_sb_count++;
-                    if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
-                        ((EbReferenceObject *)
-                             pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                            ->intra_coded_area_sb[sb_index] = (uint8_t)(
-                            (100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
-                }
-                x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
+                context_ptr->coded_sb_count++;
+                if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL)
+                    ((EbReferenceObject *)
+                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                        ->intra_coded_area_sb[sb_index] = (uint8_t)(
+                        (100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
             }
+            x_sb_start_index = (x_sb_start_index > 0) ? x_sb_start_index - 1 : 0;
         }
+    }
 
-        svt_block_on_mutex(pcs_ptr->intra_mutex);
-        pcs_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
-        // Accumulate block selection
-        for (uint8_t partidx = 0; partidx < NUMBER_OF_SHAPES-1; partidx++)
-            for (uint8_t band = 0; band < FB_NUM; band++)
-                for (uint8_t sse_idx = 0; sse_idx < SSEG_NUM; sse_idx++)
-                    pcs_ptr->part_cnt[partidx][band][sse_idx] += context_ptr->md_context->part_cnt[partidx][band][sse_idx];
-
-        // Accumulate pred depth selection
-        for (uint8_t pred_depth = 0; pred_depth < DEPTH_DELTA_NUM; pred_depth++)
-            for (uint8_t part_idx = 0; part_idx < (NUMBER_OF_SHAPES-1); part_idx++)
-                pcs_ptr->pred_depth_count[pred_depth][part_idx] += context_ptr->md_context->pred_depth_count[pred_depth][part_idx];
-        // Accumulate tx_type selection
-        for (uint8_t depth_delta = 0; depth_delta < TXT_DEPTH_DELTA_NUM; depth_delta++)
-            for (uint8_t txs_idx = 0; txs_idx < TX_TYPES; txs_idx++)
-                pcs_ptr->txt_cnt[depth_delta][txs_idx] += context_ptr->md_context->txt_cnt[depth_delta][txs_idx];
-
-        pcs_ptr->enc_dec_coded_sb_count += (uint32_t)context_ptr->coded_sb_count;
-        EbBool last_sb_flag = (pcs_ptr->sb_total_count_pix == pcs_ptr->enc_dec_coded_sb_count);
-        svt_release_mutex(pcs_ptr->intra_mutex);
-
-        if (last_sb_flag) {
-            EbBool do_recode = EB_FALSE;
-            scs_ptr->encode_context_ptr->recode_loop = scs_ptr->static_config.recode_loop;
-            if ((use_input_stat(scs_ptr) || scs_ptr->lap_enabled) &&
-                scs_ptr->encode_context_ptr->recode_loop != DISALLOW_RECODE) {
-                recode_loop_decision_maker(pcs_ptr, scs_ptr, &do_recode);
-            }
+    svt_block_on_mutex(pcs_ptr->intra_mutex);
+    pcs_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
+    // Accumulate block selection
+    for (uint8_t partidx = 0; partidx < NUMBER_OF_SHAPES-1; partidx++)
+        for (uint8_t band = 0; band < FB_NUM; band++)
+            for (uint8_t sse_idx = 0; sse_idx < SSEG_NUM; sse_idx++)
+                pcs_ptr->part_cnt[partidx][band][sse_idx] += context_ptr->md_context->part_cnt[partidx][band][sse_idx];
 
-            if (do_recode) {
+    // Accumulate pred depth selection
+    for (uint8_t pred_depth = 0; pred_depth < DEPTH_DELTA_NUM; pred_depth++)
+        for (uint8_t part_idx = 0; part_idx < (NUMBER_OF_SHAPES-1); part_idx++)
+            pcs_ptr->pred_depth_count[pred_depth][part_idx] += context_ptr->md_context->pred_depth_count[pred_depth][part_idx];
+    // Accumulate tx_type selection
+    for (uint8_t depth_delta = 0; depth_delta < TXT_DEPTH_DELTA_NUM; depth_delta++)
+        for (uint8_t txs_idx = 0; txs_idx < TX_TYPES; txs_idx++)
+            pcs_ptr->txt_cnt[depth_delta][txs_idx] += context_ptr->md_context->txt_cnt[depth_delta][txs_idx];
+
+    pcs_ptr->enc_dec_coded_sb_count += (uint32_t)context_ptr->coded_sb_count;
+    EbBool last_sb_flag = (pcs_ptr->sb_total_count_pix == pcs_ptr->enc_dec_coded_sb_count);
+    svt_release_mutex(pcs_ptr->intra_mutex);
+
+    if (last_sb_flag) {
+        EbBool do_recode = EB_FALSE;
+        scs_ptr->encode_context_ptr->recode_loop = scs_ptr->static_config.recode_loop;
+        if ((use_input_stat(scs_ptr) || scs_ptr->lap_enabled) &&
+            scs_ptr->encode_context_ptr->recode_loop != DISALLOW_RECODE) {
+            recode_loop_decision_maker(pcs_ptr, scs_ptr, &do_recode);
+        }
 
-                pcs_ptr->enc_dec_coded_sb_count = 0;
-                last_sb_flag = EB_FALSE;
-                // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-                if (context_ptr->is_md_rate_estimation_ptr_owner) {
-                    EB_FREE_ARRAY(context_ptr->md_rate_estimation_ptr);
-                    context_ptr->is_md_rate_estimation_ptr_owner = EB_FALSE;
-                }
-                context_ptr->md_rate_estimation_ptr = pcs_ptr->md_rate_estimation_array;
-                // re-init mode decision configuration for qp update for re-encode frame
-                mode_decision_configuration_init_qp_update(pcs_ptr);
-                // init segment for re-encode frame
-                init_enc_dec_segement(pcs_ptr->parent_pcs_ptr);
-                EbObjectWrapper *enc_dec_re_encode_tasks_wrapper_ptr;
-                uint16_t tg_count =
-                    pcs_ptr->parent_pcs_ptr->tile_group_cols * pcs_ptr->parent_pcs_ptr->tile_group_rows;
-                for (uint16_t tile_group_idx = 0; tile_group_idx < tg_count; tile_group_idx++) {
-                    svt_get_empty_object(context_ptr->enc_dec_feedback_fifo_ptr,
-                            &enc_dec_re_encode_tasks_wrapper_ptr);
-
-                    EncDecTasks *enc_dec_re_encode_tasks_ptr = (EncDecTasks *)enc_dec_re_encode_tasks_wrapper_ptr->object_ptr;
-                    enc_dec_re_encode_tasks_ptr->pcs_wrapper_ptr  = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-                    enc_dec_re_encode_tasks_ptr->input_type       = ENCDEC_TASKS_MDC_INPUT;
-                    enc_dec_re_encode_tasks_ptr->tile_group_index = tile_group_idx;
-
-                    // Post the Full Results Object
-                    svt_post_full_object(enc_dec_re_encode_tasks_wrapper_ptr);
-                }
+        if (do_recode) {
 
+            pcs_ptr->enc_dec_coded_sb_count = 0;
+            last_sb_flag = EB_FALSE;
+            // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
+            if (context_ptr->is_md_rate_estimation_ptr_owner) {
+                EB_FREE_ARRAY(context_ptr->md_rate_estimation_ptr);
+                context_ptr->is_md_rate_estimation_ptr_owner = EB_FALSE;
             }
-            else {
-            // Copy film grain data from parent picture set to the reference object for further reference
-            if (scs_ptr->seq_header.film_grain_params_present) {
-                if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr) {
-                    ((EbReferenceObject *)
-                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                        ->film_grain_params = pcs_ptr->parent_pcs_ptr->frm_hdr.film_grain_params;
-                }
+            context_ptr->md_rate_estimation_ptr = pcs_ptr->md_rate_estimation_array;
+            // re-init mode decision configuration for qp update for re-encode frame
+            mode_decision_configuration_init_qp_update(pcs_ptr);
+            // init segment for re-encode frame
+            init_enc_dec_segement(pcs_ptr->parent_pcs_ptr);
+            EbObjectWrapper *enc_dec_re_encode_tasks_wrapper_ptr;
+            uint16_t tg_count =
+                pcs_ptr->parent_pcs_ptr->tile_group_cols * pcs_ptr->parent_pcs_ptr->tile_group_rows;
+            for (uint16_t tile_group_idx = 0; tile_group_idx < tg_count; tile_group_idx++) {
+                svt_get_empty_object(context_ptr->enc_dec_feedback_fifo_ptr,
+                        &enc_dec_re_encode_tasks_wrapper_ptr);
+
+                EncDecTasks *enc_dec_re_encode_tasks_ptr = (EncDecTasks *)enc_dec_re_encode_tasks_wrapper_ptr->object_ptr;
+                enc_dec_re_encode_tasks_ptr->pcs_wrapper_ptr  = enc_dec_tasks_ptr->pcs_wrapper_ptr;
+                enc_dec_re_encode_tasks_ptr->input_type       = ENCDEC_TASKS_MDC_INPUT;
+                enc_dec_re_encode_tasks_ptr->tile_group_index = tile_group_idx;
+
+                // Post the Full Results Object
+                svt_post_full_object(enc_dec_re_encode_tasks_wrapper_ptr);
             }
-            if (pcs_ptr->parent_pcs_ptr->frame_end_cdf_update_mode &&
-                pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
-                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr)
-                for (int frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
-                    ((EbReferenceObject *)
-                         pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
-                        ->global_motion[frame] = pcs_ptr->parent_pcs_ptr->global_motion[frame];
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->sgrproj_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->sgrproj_restore_fac_bits,
-                       2 * sizeof(int32_t));
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->switchable_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->switchable_restore_fac_bits,
-                       3 * sizeof(int32_t));
-            svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->wiener_restore_cost,
-                       context_ptr->md_rate_estimation_ptr->wiener_restore_fac_bits,
-                       2 * sizeof(int32_t));
-            pcs_ptr->parent_pcs_ptr->av1x->rdmult =
-                context_ptr->pic_full_lambda[(context_ptr->bit_depth == EB_10BIT) ? EB_10_BIT_MD
-                                                                                  : EB_8_BIT_MD];
-            svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
-            pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
-            // Get Empty EncDec Results
-            svt_get_empty_object(context_ptr->enc_dec_output_fifo_ptr, &enc_dec_results_wrapper_ptr);
-            enc_dec_results_ptr = (EncDecResults *)enc_dec_results_wrapper_ptr->object_ptr;
-            enc_dec_results_ptr->pcs_wrapper_ptr = enc_dec_tasks_ptr->pcs_wrapper_ptr;
-            //CHKN these are not needed for DLF
-            enc_dec_results_ptr->completed_sb_row_index_start = 0;
-            enc_dec_results_ptr->completed_sb_row_count =
-                ((pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2);
-            // Post EncDec Results
-            svt_post_full_object(enc_dec_results_wrapper_ptr);
+
+        }
+        else {
+        // Copy film grain data from parent picture set to the reference object for further reference
+        if (scs_ptr->seq_header.film_grain_params_present) {
+            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr) {
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->film_grain_params = pcs_ptr->parent_pcs_ptr->frm_hdr.film_grain_params;
             }
         }
+        if (pcs_ptr->parent_pcs_ptr->frame_end_cdf_update_mode &&
+            pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE &&
+            pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr)
+            for (int frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
+                ((EbReferenceObject *)
+                     pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)
+                    ->global_motion[frame] = pcs_ptr->parent_pcs_ptr->global_motion[frame];
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->sgrproj_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->sgrproj_restore_fac_bits,
+                   2 * sizeof(int32_t));
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->switchable_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->switchable_restore_fac_bits,
+                   3 * sizeof(int32_t));
+        svt_memcpy(pcs_ptr->parent_pcs_ptr->av1x->wiener_restore_cost,
+                   context_ptr->md_rate_estimation_ptr->wiener_restore_fac_bits,
+                   2 * sizeof(int32_t));
+        pcs_ptr->parent_pcs_ptr->av1x->rdmult =
+            context_ptr->pic_full_lambda[(context_ptr->bit_depth == EB_10BIT) ? EB_10_BIT_MD
+                                                                              : EB_8_BIT_MD];
+        svt_release_object(pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr);
+        pcs_ptr->parent_pcs_ptr->me_data_wrapper_ptr = (EbObjectWrapper *)NULL;
+        // Post EncDec Results, one per SB row
+        post_enc_dec_results(
+            context_ptr,
+            enc_dec_tasks_ptr->pcs_wrapper_ptr,
+            (pcs_ptr->parent_pcs_ptr->aligned_height + scs_ptr->sb_size_pix - 1) >> sb_size_log2,
+            1);
         }
-        // Release Mode Decision Results
-        svt_release_object(enc_dec_tasks_wrapper_ptr);
     }
+    }
+    // Release Mode Decision Results
+    svt_release_object(enc_dec_tasks_wrapper_ptr);
+}
+
+/******************************************************
+ * Mode Decision Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *mode_decision_kernel(void *input_ptr) {
+    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
+    EncDecContext *     context_ptr        = (EncDecContext *)thread_context_ptr->priv;
+    EbObjectWrapper *   enc_dec_tasks_wrapper_ptr;
+
+    for (;;) {
+        // Get Mode Decision Results
+        EB_GET_FULL_OBJECT(context_ptr->mode_decision_input_fifo_ptr, &enc_dec_tasks_wrapper_ptr);
+        mode_decision_task(input_ptr, enc_dec_tasks_wrapper_ptr);
+    }
+
     return NULL;
 }
 
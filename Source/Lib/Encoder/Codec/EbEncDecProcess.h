@@ -98,6 +98,7 @@ extern EbErrorType enc_dec_context_ctor(EbThreadContext *  thread_context_ptr,
                                         int tasks_index, int demux_index);
 
 extern void *mode_decision_kernel(void *input_ptr);
+extern void  mode_decision_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
 
 #ifdef __cplusplus
 }
@@ -37,7 +37,7 @@ typedef struct DlfResults {
 typedef struct CdefResults {
     EbDctor          dctor;
     EbObjectWrapper *pcs_wrapper_ptr;
-    uint32_t         segment_index;
+    uint32_t         segment_index; // LR search segment, or application band past the segments
 } CdefResults;
 
 typedef struct RestResults {
@@ -48,6 +48,12 @@ typedef struct RestResults {
     uint16_t         tile_index;
 } RestResults;
 
+typedef struct QualityMetricsTasks {
+    EbDctor          dctor;
+    EbObjectWrapper *pcs_wrapper_ptr;
+    uint32_t         segment_index; // band of QUALITY_METRICS_BAND_HEIGHT luma rows
+} QualityMetricsTasks;
+
 typedef struct EncDecResultsInitData {
     uint32_t junk;
 } EncDecResultsInitData;
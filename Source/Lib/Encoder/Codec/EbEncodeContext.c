@@ -10,6 +10,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbEncodeContext.h"
 #include "EbSvtAv1ErrorCodes.h"
@@ -49,15 +50,7 @@ static void destroy_stats_buffer(STATS_BUFFER_CTX *stats_buf_context,
     EB_FREE_ARRAY(stats_buf_context->total_stats);
     EB_FREE_ARRAY(frame_stats_buffer);
 }
-static void encode_context_dctor(EbPtr p) {
-    EncodeContext *obj = (EncodeContext *)p;
-    EB_DESTROY_MUTEX(obj->total_number_of_recon_frame_mutex);
-    EB_DESTROY_MUTEX(obj->hl_rate_control_historgram_queue_mutex);
-    EB_DESTROY_MUTEX(obj->rate_table_update_mutex);
-    EB_DESTROY_MUTEX(obj->sc_buffer_mutex);
-    EB_DESTROY_MUTEX(obj->shared_reference_mutex);
-    EB_DESTROY_MUTEX(obj->stat_file_mutex);
-    EB_DELETE(obj->prediction_structure_group_ptr);
+static void encode_context_queues_dctor(EncodeContext *obj) {
     EB_DELETE_PTR_ARRAY(obj->picture_decision_reorder_queue,
                         PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH);
     EB_FREE(obj->pre_assignment_buffer);
@@ -71,22 +64,29 @@ static void encode_context_dctor(EbPtr p) {
     EB_DELETE_PTR_ARRAY(obj->hl_rate_control_historgram_queue,
                         HIGH_LEVEL_RATE_CONTROL_HISTOGRAM_QUEUE_MAX_DEPTH);
     EB_DELETE_PTR_ARRAY(obj->packetization_reorder_queue, PACKETIZATION_REORDER_QUEUE_MAX_DEPTH);
+}
+
+static void encode_context_dctor(EbPtr p) {
+    EncodeContext *obj = (EncodeContext *)p;
+    EB_DESTROY_MUTEX(obj->total_number_of_recon_frame_mutex);
+    EB_DESTROY_MUTEX(obj->hl_rate_control_historgram_queue_mutex);
+    EB_DESTROY_MUTEX(obj->rate_table_update_mutex);
+    EB_DESTROY_MUTEX(obj->sc_buffer_mutex);
+    EB_DESTROY_MUTEX(obj->shared_reference_mutex);
+    EB_DESTROY_MUTEX(obj->stat_file_mutex);
+    EB_DESTROY_MUTEX(obj->rc_targets_mutex);
+    EB_DESTROY_SEMAPHORE(obj->tpl_done_semaphore);
+    EB_DELETE(obj->prediction_structure_group_ptr);
+    encode_context_queues_dctor(obj);
     EB_FREE_ARRAY(obj->rate_control_tables_array);
     EB_FREE(obj->stats_out.stat);
     destroy_stats_buffer(&obj->stats_buf_context, obj->frame_stats_buffer);
 }
 
-EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_init_data_ptr) {
-    uint32_t    picture_index;
-    EbErrorType return_error = EB_ErrorNone;
+/* The queues of the pictures in flight, indexed from picture number 0 */
+static EbErrorType encode_context_queues_ctor(EncodeContext *encode_context_ptr) {
+    uint32_t picture_index;
 
-    encode_context_ptr->dctor = encode_context_dctor;
-
-    object_init_data_ptr = 0;
-    CHECK_REPORT_ERROR(
-        (object_init_data_ptr == 0), encode_context_ptr->app_callback_ptr, EB_ENC_EC_ERROR29);
-
-    EB_CREATE_MUTEX(encode_context_ptr->total_number_of_recon_frame_mutex);
     EB_ALLOC_PTR_ARRAY(encode_context_ptr->picture_decision_reorder_queue,
                        PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH);
 
@@ -144,9 +144,6 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
                hl_rate_control_histogram_entry_ctor,
                picture_index);
     }
-    // HLRateControl Historgram Queue Mutex
-    EB_CREATE_MUTEX(encode_context_ptr->hl_rate_control_historgram_queue_mutex);
-
     EB_ALLOC_PTR_ARRAY(encode_context_ptr->packetization_reorder_queue,
                        PACKETIZATION_REORDER_QUEUE_MAX_DEPTH);
 
@@ -156,7 +153,11 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
                packetization_reorder_entry_ctor,
                picture_index);
     }
+    return EB_ErrorNone;
+}
 
+/* Stream state other than the queues, as it is before the first picture */
+static void encode_context_init_stream(EncodeContext *encode_context_ptr) {
     encode_context_ptr->current_input_poc = -1;
     encode_context_ptr->initial_picture   = EB_TRUE;
 
@@ -166,6 +167,29 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
     // Signalling the need for a td structure to be written in the Bitstream - on when the sequence starts
     encode_context_ptr->td_needed = EB_TRUE;
 
+    encode_context_ptr->enc_mode                      = SPEED_CONTROL_INIT_MOD;
+    encode_context_ptr->previous_selected_ref_qp      = 32;
+    encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
+}
+
+EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_init_data_ptr) {
+    EbErrorType return_error = EB_ErrorNone;
+
+    encode_context_ptr->dctor = encode_context_dctor;
+
+    object_init_data_ptr = 0;
+    CHECK_REPORT_ERROR(
+        (object_init_data_ptr == 0), encode_context_ptr->app_callback_ptr, EB_ENC_EC_ERROR29);
+
+    EB_CREATE_MUTEX(encode_context_ptr->total_number_of_recon_frame_mutex);
+    return_error = encode_context_queues_ctor(encode_context_ptr);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    // HLRateControl Historgram Queue Mutex
+    EB_CREATE_MUTEX(encode_context_ptr->hl_rate_control_historgram_queue_mutex);
+
+    encode_context_init_stream(encode_context_ptr);
+
     // Rate Control Bit Tables
     EB_MALLOC_ARRAY(encode_context_ptr->rate_control_tables_array,
                     TOTAL_NUMBER_OF_INITIAL_RC_TABLES_ENTRY);
@@ -177,13 +201,12 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
     EB_CREATE_MUTEX(encode_context_ptr->rate_table_update_mutex);
 
     EB_CREATE_MUTEX(encode_context_ptr->sc_buffer_mutex);
-    encode_context_ptr->enc_mode                      = SPEED_CONTROL_INIT_MOD;
-    encode_context_ptr->previous_selected_ref_qp      = 32;
-    encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
-    encode_context_ptr->recode_tolerance              = 25;
-    encode_context_ptr->rc_cfg.min_cr                 = 0;
+    encode_context_ptr->recode_tolerance = 25;
+    encode_context_ptr->rc_cfg.min_cr    = 0;
     EB_CREATE_MUTEX(encode_context_ptr->shared_reference_mutex);
     EB_CREATE_MUTEX(encode_context_ptr->stat_file_mutex);
+    EB_CREATE_MUTEX(encode_context_ptr->rc_targets_mutex);
+    EB_CREATE_SEMAPHORE(encode_context_ptr->tpl_done_semaphore, 0, MAX_TPL_LA_SW);
     encode_context_ptr->num_lap_buffers = 0; //lap not supported for now
     int *num_lap_buffers                = &encode_context_ptr->num_lap_buffers;
     create_stats_buffer(&encode_context_ptr->frame_stats_buffer,
@@ -191,3 +214,76 @@ EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr, EbPtr object_
                         *num_lap_buffers);
     return EB_ErrorNone;
 }
+
+/*
+ * encode_context_reset
+ *   Takes the encode context back to the start of a stream once the
+ *   pipeline is idle. The queues are rebuilt; the fifos, mutexes,
+ *   prediction structures and rate control configuration are kept.
+ */
+EbErrorType encode_context_reset(EncodeContext *encode_context_ptr) {
+    encode_context_queues_dctor(encode_context_ptr);
+
+    encode_context_ptr->total_number_of_recon_frames = 0;
+
+    encode_context_ptr->picture_decision_reorder_queue_head_index = 0;
+    memset(encode_context_ptr->picture_decision_undisplayed_queue,
+           0,
+           sizeof(encode_context_ptr->picture_decision_undisplayed_queue));
+    encode_context_ptr->picture_decision_undisplayed_queue_count = 0;
+    encode_context_ptr->pre_assignment_buffer_intra_count        = 0;
+    encode_context_ptr->pre_assignment_buffer_idr_count          = 0;
+    encode_context_ptr->pre_assignment_buffer_scene_change_count = 0;
+    encode_context_ptr->pre_assignment_buffer_scene_change_index = 0;
+    encode_context_ptr->pre_assignment_buffer_eos_flag           = 0;
+    encode_context_ptr->decode_base_number                       = 0;
+    encode_context_ptr->pre_assignment_buffer_count              = 0;
+
+    encode_context_ptr->picture_decision_pa_reference_queue_head_index = 0;
+    encode_context_ptr->picture_decision_pa_reference_queue_tail_index = 0;
+    encode_context_ptr->input_picture_queue_head_index                 = 0;
+    encode_context_ptr->input_picture_queue_tail_index                 = 0;
+    encode_context_ptr->reference_picture_queue_head_index             = 0;
+    encode_context_ptr->reference_picture_queue_tail_index             = 0;
+    encode_context_ptr->initial_rate_control_reorder_queue_head_index  = 0;
+    encode_context_ptr->dep_q_head                                     = 0;
+    encode_context_ptr->dep_q_tail                                     = 0;
+    encode_context_ptr->hl_rate_control_historgram_queue_head_index    = 0;
+    encode_context_ptr->packetization_reorder_queue_head_index         = 0;
+
+    // GOP Counters
+    encode_context_ptr->intra_period_position              = 0;
+    encode_context_ptr->pred_struct_position               = 0;
+    encode_context_ptr->elapsed_non_idr_count              = 0;
+    encode_context_ptr->elapsed_non_cra_count              = 0;
+    encode_context_ptr->last_idr_picture                   = 0;
+    encode_context_ptr->terminating_sequence_flag_received = EB_FALSE;
+
+    // The rate control tables are updated with the coded pictures
+    encode_context_ptr->rate_control_tables_array_updated = EB_FALSE;
+    EbErrorType return_error =
+        rate_control_tables_init(encode_context_ptr->rate_control_tables_array);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    encode_context_ptr->sc_buffer     = 0;
+    encode_context_ptr->sc_frame_in   = 0;
+    encode_context_ptr->sc_frame_out  = 0;
+    encode_context_ptr->max_coded_poc = 0;
+
+    encode_context_ptr->previous_mini_gop_hierarchical_levels    = 0;
+    encode_context_ptr->previous_picture_control_set_wrapper_ptr = NULL;
+    encode_context_ptr->picture_number_alt                       = 0;
+
+    memset(encode_context_ptr->dpb_list, 0, sizeof(encode_context_ptr->dpb_list));
+    encode_context_ptr->display_picture_number                  = 0;
+    encode_context_ptr->is_mini_gop_changed                     = EB_FALSE;
+    encode_context_ptr->is_i_slice_in_last_mini_gop             = EB_FALSE;
+    encode_context_ptr->i_slice_picture_number_in_last_mini_gop = 0;
+    memset(&encode_context_ptr->rc, 0, sizeof(encode_context_ptr->rc));
+    memset(&encode_context_ptr->gf_group, 0, sizeof(encode_context_ptr->gf_group));
+
+    encode_context_init_stream(encode_context_ptr);
+
+    return encode_context_queues_ctor(encode_context_ptr);
+}
@@ -172,6 +172,15 @@ typedef struct EncodeContext {
     uint64_t max_coded_poc;
     uint32_t max_coded_poc_selected_ref_qp;
 
+    // Rate control targets given to the pictures entering picture decision, replaced by the
+    // pending ones from svt_av1_enc_update_rate_control() when a mini-GOP starts at or after
+    // rc_targets_pending_picture_number
+    SvtAv1RateControlTargets rc_targets;
+    SvtAv1RateControlTargets rc_targets_pending;
+    EbBool                   rc_targets_pending_flag;
+    uint64_t                 rc_targets_pending_picture_number;
+    EbHandle                 rc_targets_mutex;
+
     // Dynamic GOP
     uint32_t         previous_mini_gop_hierarchical_levels;
     EbObjectWrapper *previous_picture_control_set_wrapper_ptr;
@@ -189,6 +198,10 @@ typedef struct EncodeContext {
     uint64_t             poc_map_idx[MAX_TPL_LA_SW];
     EbPictureBufferDesc *mc_flow_rec_picture_buffer[MAX_TPL_LA_SW];
     EbPictureBufferDesc *mc_flow_rec_picture_buffer_noref;
+    // TPL window handed to the TPL stage, posted once per picture processed
+    struct PictureParentControlSet *tpl_pcs_array[MAX_TPL_LA_SW];
+    uint8_t                         tpl_frames_in_sw;
+    EbHandle                        tpl_done_semaphore;
     FrameInfo            frame_info;
     TwoPassCfg           two_pass_cfg; // two pass datarate control
     RATE_CONTROL         rc;
@@ -217,4 +230,5 @@ typedef struct EncodeContextInitData {
  **************************************/
 extern EbErrorType encode_context_ctor(EncodeContext *encode_context_ptr,
                                        EbPtr          object_init_data_ptr);
+extern EbErrorType encode_context_reset(EncodeContext *encode_context_ptr);
 #endif // EbEncodeContext_h
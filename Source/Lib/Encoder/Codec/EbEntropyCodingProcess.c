@@ -326,198 +326,206 @@ static EbBool update_entropy_coding_rows(PictureControlSet *pcs_ptr, uint32_t *r
 *  Bitstream for each block
 *
 ********************************************************************************/
-void *entropy_coding_kernel(void *input_ptr) {
+void entropy_coding_task(EbPtr input_ptr, EbObjectWrapper *rest_results_wrapper_ptr) {
     // Context & SCS & PCS
     EbThreadContext *     thread_context_ptr = (EbThreadContext *)input_ptr;
     EntropyCodingContext *context_ptr        = (EntropyCodingContext *)thread_context_ptr->priv;
 
-    // Input
-    EbObjectWrapper *rest_results_wrapper_ptr;
-
     // Output
     EbObjectWrapper *     entropy_coding_results_wrapper_ptr;
     EntropyCodingResults *entropy_coding_results_ptr;
 
-    for (;;) {
-        // Get Mode Decision Results
-        EB_GET_FULL_OBJECT(context_ptr->enc_dec_input_fifo_ptr, &rest_results_wrapper_ptr);
-
-        RestResults *      rest_results_ptr = (RestResults *)rest_results_wrapper_ptr->object_ptr;
-        PictureControlSet *pcs_ptr          = (PictureControlSet *)
-                                         rest_results_ptr->pcs_wrapper_ptr->object_ptr;
-        SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        // SB Constants
-
-        uint8_t sb_sz = (uint8_t)scs_ptr->sb_size_pix;
-
-        uint8_t sb_size_log2     = (uint8_t)svt_log2f(sb_sz);
-        context_ptr->sb_sz       = sb_sz;
-        uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
-            sb_size_log2;
-        uint16_t         tile_idx        = rest_results_ptr->tile_index;
-        Av1Common *const cm              = pcs_ptr->parent_pcs_ptr->av1_cm;
-        const uint16_t   tile_cnt        = cm->tiles_info.tile_rows * cm->tiles_info.tile_cols;
-        const uint16_t   tile_col        = tile_idx % cm->tiles_info.tile_cols;
-        const uint16_t   tile_row        = tile_idx / cm->tiles_info.tile_cols;
-        const uint16_t   tile_sb_start_x = cm->tiles_info.tile_col_start_mi[tile_col] >>
-            scs_ptr->seq_header.sb_size_log2;
-        const uint16_t tile_sb_start_y = cm->tiles_info.tile_row_start_mi[tile_row] >>
-            scs_ptr->seq_header.sb_size_log2;
-        uint16_t tile_width_in_sb = (cm->tiles_info.tile_col_start_mi[tile_col + 1] -
-                                     cm->tiles_info.tile_col_start_mi[tile_col]) >>
-            scs_ptr->seq_header.sb_size_log2;
-
-        {
-            EbBool   frame_entropy_done = EB_FALSE, initial_process_call = EB_TRUE;
-            uint32_t y_sb_index = rest_results_ptr->completed_sb_row_index_start;
-
-            // SB-loops
-            while (update_entropy_coding_rows(pcs_ptr,
-                                              &y_sb_index,
-                                              rest_results_ptr->completed_sb_row_count,
-                                              tile_idx,
-                                              &initial_process_call) == EB_TRUE) {
-                uint32_t row_total_bits = 0;
-
-                if (y_sb_index == 0) {
-                    svt_block_on_mutex(pcs_ptr->entropy_coding_pic_mutex);
-                    if (pcs_ptr->entropy_coding_pic_reset_flag) {
-                        pcs_ptr->entropy_coding_pic_reset_flag = EB_FALSE;
-
-                        reset_entropy_coding_picture(context_ptr, pcs_ptr, scs_ptr);
-                    }
-                    svt_release_mutex(pcs_ptr->entropy_coding_pic_mutex);
-                    pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done = EB_FALSE;
+    RestResults *      rest_results_ptr = (RestResults *)rest_results_wrapper_ptr->object_ptr;
+    PictureControlSet *pcs_ptr          = (PictureControlSet *)
+                                     rest_results_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    // SB Constants
+
+    uint8_t sb_sz = (uint8_t)scs_ptr->sb_size_pix;
+
+    uint8_t sb_size_log2     = (uint8_t)svt_log2f(sb_sz);
+    context_ptr->sb_sz       = sb_sz;
+    uint32_t pic_width_in_sb = (pcs_ptr->parent_pcs_ptr->aligned_width + sb_sz - 1) >>
+        sb_size_log2;
+    uint16_t         tile_idx        = rest_results_ptr->tile_index;
+    Av1Common *const cm              = pcs_ptr->parent_pcs_ptr->av1_cm;
+    const uint16_t   tile_cnt        = cm->tiles_info.tile_rows * cm->tiles_info.tile_cols;
+    const uint16_t   tile_col        = tile_idx % cm->tiles_info.tile_cols;
+    const uint16_t   tile_row        = tile_idx / cm->tiles_info.tile_cols;
+    const uint16_t   tile_sb_start_x = cm->tiles_info.tile_col_start_mi[tile_col] >>
+        scs_ptr->seq_header.sb_size_log2;
+    const uint16_t tile_sb_start_y = cm->tiles_info.tile_row_start_mi[tile_row] >>
+        scs_ptr->seq_header.sb_size_log2;
+    uint16_t tile_width_in_sb = (cm->tiles_info.tile_col_start_mi[tile_col + 1] -
+                                 cm->tiles_info.tile_col_start_mi[tile_col]) >>
+        scs_ptr->seq_header.sb_size_log2;
+
+    {
+        EbBool   frame_entropy_done = EB_FALSE, initial_process_call = EB_TRUE;
+        uint32_t y_sb_index = rest_results_ptr->completed_sb_row_index_start;
+
+        // SB-loops
+        while (update_entropy_coding_rows(pcs_ptr,
+                                          &y_sb_index,
+                                          rest_results_ptr->completed_sb_row_count,
+                                          tile_idx,
+                                          &initial_process_call) == EB_TRUE) {
+            uint32_t row_total_bits = 0;
+
+            if (y_sb_index == 0) {
+                svt_block_on_mutex(pcs_ptr->entropy_coding_pic_mutex);
+                if (pcs_ptr->entropy_coding_pic_reset_flag) {
+                    pcs_ptr->entropy_coding_pic_reset_flag = EB_FALSE;
+
+                    reset_entropy_coding_picture(context_ptr, pcs_ptr, scs_ptr);
                 }
+                svt_release_mutex(pcs_ptr->entropy_coding_pic_mutex);
+                pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done = EB_FALSE;
+            }
 
 #if TURN_OFF_EC_FIRST_PASS
-                if (!use_output_stat(scs_ptr)) {
+            if (!use_output_stat(scs_ptr)) {
 #endif
-                    for (uint32_t x_sb_index = 0; x_sb_index < tile_width_in_sb; ++x_sb_index) {
-                        uint16_t    sb_index = (uint16_t)((x_sb_index + tile_sb_start_x) +
-                                                       (y_sb_index + tile_sb_start_y) *
-                                                           pic_width_in_sb);
-                        SuperBlock *sb_ptr   = pcs_ptr->sb_ptr_array[sb_index];
-
-                        context_ptr->sb_origin_x = (x_sb_index + tile_sb_start_x) << sb_size_log2;
-                        context_ptr->sb_origin_y = (y_sb_index + tile_sb_start_y) << sb_size_log2;
-                        if (x_sb_index == 0 && y_sb_index == 0) {
-                            svt_av1_reset_loop_restoration(pcs_ptr, tile_idx);
-                            context_ptr->tok = pcs_ptr->tile_tok[tile_row][tile_col];
-                        }
-                        sb_ptr->total_bits = 0;
-                        uint32_t prev_pos  = (x_sb_index == 0 && y_sb_index == 0)
-                             ? 0
-                             : pcs_ptr->entropy_coding_info[tile_idx]
-                                  ->entropy_coder_ptr->ec_writer.ec.offs; //residual_bc.pos
-
-                        EbPictureBufferDesc *coeff_picture_ptr = sb_ptr->quantized_coeff;
-                        write_sb(context_ptr,
-                                 sb_ptr,
-                                 pcs_ptr,
-                                 tile_idx,
-                                 pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr,
-                                 coeff_picture_ptr);
-                        sb_ptr->total_bits = (pcs_ptr->entropy_coding_info[tile_idx]
-                                                  ->entropy_coder_ptr->ec_writer.ec.offs -
-                                              prev_pos)
-                            << 3;
-
-                        pcs_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
-                        row_total_bits += sb_ptr->total_bits;
+                for (uint32_t x_sb_index = 0; x_sb_index < tile_width_in_sb; ++x_sb_index) {
+                    uint16_t    sb_index = (uint16_t)((x_sb_index + tile_sb_start_x) +
+                                                   (y_sb_index + tile_sb_start_y) *
+                                                       pic_width_in_sb);
+                    SuperBlock *sb_ptr   = pcs_ptr->sb_ptr_array[sb_index];
+
+                    context_ptr->sb_origin_x = (x_sb_index + tile_sb_start_x) << sb_size_log2;
+                    context_ptr->sb_origin_y = (y_sb_index + tile_sb_start_y) << sb_size_log2;
+                    if (x_sb_index == 0 && y_sb_index == 0) {
+                        svt_av1_reset_loop_restoration(pcs_ptr, tile_idx);
+                        context_ptr->tok = pcs_ptr->tile_tok[tile_row][tile_col];
                     }
+                    sb_ptr->total_bits = 0;
+                    uint32_t prev_pos  = (x_sb_index == 0 && y_sb_index == 0)
+                         ? 0
+                         : pcs_ptr->entropy_coding_info[tile_idx]
+                              ->entropy_coder_ptr->ec_writer.ec.offs; //residual_bc.pos
+
+                    EbPictureBufferDesc *coeff_picture_ptr = sb_ptr->quantized_coeff;
+                    write_sb(context_ptr,
+                             sb_ptr,
+                             pcs_ptr,
+                             tile_idx,
+                             pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr,
+                             coeff_picture_ptr);
+                    sb_ptr->total_bits = (pcs_ptr->entropy_coding_info[tile_idx]
+                                              ->entropy_coder_ptr->ec_writer.ec.offs -
+                                          prev_pos)
+                        << 3;
+
+                    pcs_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
+                    row_total_bits += sb_ptr->total_bits;
+                }
 
 #if TURN_OFF_EC_FIRST_PASS
-                }
+            }
 #endif
 
-                // At the end of each SB-row, send the updated bit-count to Entropy Coding
-                {
-                    EbObjectWrapper * rate_control_task_wrapper_ptr;
-                    RateControlTasks *rate_control_task_ptr;
-
-                    // Get Empty EncDec Results
-                    svt_get_empty_object(context_ptr->rate_control_output_fifo_ptr,
-                                         &rate_control_task_wrapper_ptr);
-                    rate_control_task_ptr = (RateControlTasks *)
-                                                rate_control_task_wrapper_ptr->object_ptr;
-                    rate_control_task_ptr->task_type      = RC_ENTROPY_CODING_ROW_FEEDBACK_RESULT;
-                    rate_control_task_ptr->picture_number = pcs_ptr->picture_number;
-                    rate_control_task_ptr->row_number     = y_sb_index;
-                    rate_control_task_ptr->bit_count      = row_total_bits;
-
-                    rate_control_task_ptr->pcs_wrapper_ptr = 0;
-                    rate_control_task_ptr->segment_index   = ~0u;
-
-                    // Post EncDec Results
-                    svt_post_full_object(rate_control_task_wrapper_ptr);
-                }
+            // At the end of each SB-row, send the updated bit-count to Entropy Coding
+            {
+                EbObjectWrapper * rate_control_task_wrapper_ptr;
+                RateControlTasks *rate_control_task_ptr;
+
+                // Get Empty EncDec Results
+                svt_get_empty_object(context_ptr->rate_control_output_fifo_ptr,
+                                     &rate_control_task_wrapper_ptr);
+                rate_control_task_ptr = (RateControlTasks *)
+                                            rate_control_task_wrapper_ptr->object_ptr;
+                rate_control_task_ptr->task_type      = RC_ENTROPY_CODING_ROW_FEEDBACK_RESULT;
+                rate_control_task_ptr->picture_number = pcs_ptr->picture_number;
+                rate_control_task_ptr->row_number     = y_sb_index;
+                rate_control_task_ptr->bit_count      = row_total_bits;
+
+                rate_control_task_ptr->pcs_wrapper_ptr = 0;
+                rate_control_task_ptr->segment_index   = ~0u;
+
+                // Post EncDec Results
+                svt_post_full_object(rate_control_task_wrapper_ptr);
+            }
 
-                svt_block_on_mutex(pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_mutex);
-                if (pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done == EB_FALSE) {
-                    // If the picture is complete, terminate the slice
-                    if (pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_current_row ==
-                        pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_row_count) {
-                        EbBool pic_ready = EB_TRUE;
-
-                        // Current tile ready
-                        encode_slice_finish(
-                            pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr);
-
-                        svt_block_on_mutex(pcs_ptr->entropy_coding_pic_mutex);
-                        pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done = EB_TRUE;
-                        for (uint16_t i = 0; i < tile_cnt; i++) {
-                            if (pcs_ptr->entropy_coding_info[i]->entropy_coding_tile_done ==
-                                EB_FALSE) {
-                                pic_ready = EB_FALSE;
-                                break;
-                            }
+            svt_block_on_mutex(pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_mutex);
+            if (pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done == EB_FALSE) {
+                // If the picture is complete, terminate the slice
+                if (pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_current_row ==
+                    pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_row_count) {
+                    EbBool pic_ready = EB_TRUE;
+
+                    // Current tile ready
+                    encode_slice_finish(
+                        pcs_ptr->entropy_coding_info[tile_idx]->entropy_coder_ptr);
+
+                    svt_block_on_mutex(pcs_ptr->entropy_coding_pic_mutex);
+                    pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_tile_done = EB_TRUE;
+                    for (uint16_t i = 0; i < tile_cnt; i++) {
+                        if (pcs_ptr->entropy_coding_info[i]->entropy_coding_tile_done ==
+                            EB_FALSE) {
+                            pic_ready = EB_FALSE;
+                            break;
                         }
-                        svt_release_mutex(pcs_ptr->entropy_coding_pic_mutex);
-                        if (pic_ready) {
-                            // Release the List 0 Reference Pictures
-                            for (uint32_t ref_idx = 0;
-                                 ref_idx < pcs_ptr->parent_pcs_ptr->ref_list0_count;
-                                 ++ref_idx) {
-                                if (pcs_ptr->ref_pic_ptr_array[0][ref_idx] != NULL) {
-                                    svt_release_object(pcs_ptr->ref_pic_ptr_array[0][ref_idx]);
-                                }
+                    }
+                    svt_release_mutex(pcs_ptr->entropy_coding_pic_mutex);
+                    if (pic_ready) {
+                        // Release the List 0 Reference Pictures
+                        for (uint32_t ref_idx = 0;
+                             ref_idx < pcs_ptr->parent_pcs_ptr->ref_list0_count;
+                             ++ref_idx) {
+                            if (pcs_ptr->ref_pic_ptr_array[0][ref_idx] != NULL) {
+                                svt_release_object(pcs_ptr->ref_pic_ptr_array[0][ref_idx]);
                             }
+                        }
 
-                            // Release the List 1 Reference Pictures
-                            for (uint32_t ref_idx = 0;
-                                 ref_idx < pcs_ptr->parent_pcs_ptr->ref_list1_count;
-                                 ++ref_idx) {
-                                if (pcs_ptr->ref_pic_ptr_array[1][ref_idx] != NULL)
-                                    svt_release_object(pcs_ptr->ref_pic_ptr_array[1][ref_idx]);
-                            }
+                        // Release the List 1 Reference Pictures
+                        for (uint32_t ref_idx = 0;
+                             ref_idx < pcs_ptr->parent_pcs_ptr->ref_list1_count;
+                             ++ref_idx) {
+                            if (pcs_ptr->ref_pic_ptr_array[1][ref_idx] != NULL)
+                                svt_release_object(pcs_ptr->ref_pic_ptr_array[1][ref_idx]);
+                        }
 
-                            //free palette data
-                            if (pcs_ptr->tile_tok[0][0])
-                                EB_FREE_ARRAY(pcs_ptr->tile_tok[0][0]);
+                        //free palette data
+                        if (pcs_ptr->tile_tok[0][0])
+                            EB_FREE_ARRAY(pcs_ptr->tile_tok[0][0]);
 
-                            frame_entropy_done = EB_TRUE;
-                        }
-                    } // End if(PictureCompleteFlag)
-                }
-                svt_release_mutex(pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_mutex);
-            }
-            // Move the post here.
-            // In some cases, PAK ends fast, pcs will be released before we quit the while-loop
-            if (frame_entropy_done) {
-                // Get Empty Entropy Coding Results
-                svt_get_empty_object(context_ptr->entropy_coding_output_fifo_ptr,
-                                     &entropy_coding_results_wrapper_ptr);
-                entropy_coding_results_ptr = (EntropyCodingResults *)
-                                                 entropy_coding_results_wrapper_ptr->object_ptr;
-                entropy_coding_results_ptr->pcs_wrapper_ptr = rest_results_ptr->pcs_wrapper_ptr;
-
-                // Post EntropyCoding Results
-                svt_post_full_object(entropy_coding_results_wrapper_ptr);
+                        frame_entropy_done = EB_TRUE;
+                    }
+                } // End if(PictureCompleteFlag)
             }
+            svt_release_mutex(pcs_ptr->entropy_coding_info[tile_idx]->entropy_coding_mutex);
+        }
+        // Move the post here.
+        // In some cases, PAK ends fast, pcs will be released before we quit the while-loop
+        if (frame_entropy_done) {
+            // Get Empty Entropy Coding Results
+            svt_get_empty_object(context_ptr->entropy_coding_output_fifo_ptr,
+                                 &entropy_coding_results_wrapper_ptr);
+            entropy_coding_results_ptr = (EntropyCodingResults *)
+                                             entropy_coding_results_wrapper_ptr->object_ptr;
+            entropy_coding_results_ptr->pcs_wrapper_ptr = rest_results_ptr->pcs_wrapper_ptr;
+
+            // Post EntropyCoding Results
+            svt_post_full_object(entropy_coding_results_wrapper_ptr);
         }
-        // Release Mode Decision Results
-        svt_release_object(rest_results_wrapper_ptr);
+    }
+    // Release Mode Decision Results
+    svt_release_object(rest_results_wrapper_ptr);
+}
+
+/******************************************************
+ * Entropy Coding Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *entropy_coding_kernel(void *input_ptr) {
+    EbThreadContext *     thread_context_ptr = (EbThreadContext *)input_ptr;
+    EntropyCodingContext *context_ptr        = (EntropyCodingContext *)thread_context_ptr->priv;
+    EbObjectWrapper *     rest_results_wrapper_ptr;
+
+    for (;;) {
+        // Get Mode Decision Results
+        EB_GET_FULL_OBJECT(context_ptr->enc_dec_input_fifo_ptr, &rest_results_wrapper_ptr);
+        entropy_coding_task(input_ptr, rest_results_wrapper_ptr);
     }
 
     return NULL;
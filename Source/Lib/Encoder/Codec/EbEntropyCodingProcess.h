@@ -76,5 +76,6 @@ extern EbErrorType entropy_coding_context_ctor(EbThreadContext *  thread_context
                                                int rate_control_index);
 
 extern void *entropy_coding_kernel(void *input_ptr);
+extern void  entropy_coding_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
 
 #endif // EbEntropyCodingProcess_h
@@ -20,27 +20,16 @@
 #include "EbUtility.h"
 #include "global_motion.h"
 #include "corner_detect.h"
+#include "corner_match.h"
 // Normalized distortion-based thresholds
 #define GMV_ME_SAD_TH_0 0
 #define GMV_ME_SAD_TH_1 5
 #define GMV_ME_SAD_TH_2 10
-void global_motion_estimation(PictureParentControlSet *pcs_ptr,
-                              EbPictureBufferDesc *    input_picture_ptr) {
-    // Get downsampled pictures with a downsampling factor of 2 in each dimension
-    EbPaReferenceObject *pa_reference_object;
-    EbPictureBufferDesc *quarter_ref_pic_ptr;
-    EbPictureBufferDesc *quarter_picture_ptr;
-    EbPictureBufferDesc *sixteenth_ref_pic_ptr;
-    EbPictureBufferDesc *sixteenth_picture_ptr;
-    SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-    pa_reference_object          = (EbPaReferenceObject *)
-                              pcs_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
-    quarter_picture_ptr   = (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
-          ? (EbPictureBufferDesc *)pa_reference_object->quarter_filtered_picture_ptr
-          : (EbPictureBufferDesc *)pa_reference_object->quarter_decimated_picture_ptr;
-    sixteenth_picture_ptr = (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
-        ? (EbPictureBufferDesc *)pa_reference_object->sixteenth_filtered_picture_ptr
-        : (EbPictureBufferDesc *)pa_reference_object->sixteenth_decimated_picture_ptr;
+/* Resets the global motion of the picture and derives, from its ME distortion,
+ * the number of references of each list to search */
+void global_motion_estimation_init(PictureParentControlSet *pcs_ptr,
+                                   EbPictureBufferDesc *    input_picture_ptr,
+                                   uint32_t ref_count[MAX_NUM_OF_REF_PIC_LIST]) {
     uint32_t num_of_list_to_search = (pcs_ptr->slice_type == P_SLICE) ? (uint32_t)REF_LIST_0
                                                                       : (uint32_t)REF_LIST_1;
     // Initilize global motion to be OFF for all references frames.
@@ -80,6 +69,7 @@ void global_motion_estimation(PictureParentControlSet *pcs_ptr,
     else
         global_motion_estimation_level = 3;
 
+    ref_count[REF_LIST_0] = ref_count[REF_LIST_1] = 0;
     if (global_motion_estimation_level)
         for (uint32_t list_index = REF_LIST_0; list_index <= num_of_list_to_search; ++list_index) {
             uint32_t num_of_ref_pic_to_search;
@@ -90,52 +80,64 @@ void global_motion_estimation(PictureParentControlSet *pcs_ptr,
                 num_of_ref_pic_to_search = MIN(num_of_ref_pic_to_search, 1);
             else if (global_motion_estimation_level == 2)
                 num_of_ref_pic_to_search = MIN(num_of_ref_pic_to_search, 2);
-            // Ref Picture Loop
-            for (uint32_t ref_pic_index = 0; ref_pic_index < num_of_ref_pic_to_search;
-                 ++ref_pic_index) {
-                EbPaReferenceObject *reference_object;
-                EbPictureBufferDesc *ref_picture_ptr;
-                reference_object = (EbPaReferenceObject *)pcs_ptr
-                                       ->ref_pa_pic_ptr_array[list_index][ref_pic_index]
-                                       ->object_ptr;
-
-                // Set the source and the reference picture to be used by the global motion search
-                // based on the input search mode
-                if (pcs_ptr->gm_level == GM_DOWN16) {
-                    sixteenth_ref_pic_ptr = (scs_ptr->down_sampling_method_me_search ==
-                                             ME_FILTERED_DOWNSAMPLED)
-                        ? (EbPictureBufferDesc *)reference_object->sixteenth_filtered_picture_ptr
-                        : (EbPictureBufferDesc *)reference_object->sixteenth_decimated_picture_ptr;
-                    ref_picture_ptr       = sixteenth_ref_pic_ptr;
-                    input_picture_ptr     = sixteenth_picture_ptr;
+            ref_count[list_index] = num_of_ref_pic_to_search;
+        }
+}
 
-                } else if (pcs_ptr->gm_level == GM_DOWN) {
-                    quarter_ref_pic_ptr = (scs_ptr->down_sampling_method_me_search ==
-                                           ME_FILTERED_DOWNSAMPLED)
-                        ? (EbPictureBufferDesc *)reference_object->quarter_filtered_picture_ptr
-                        : (EbPictureBufferDesc *)reference_object->quarter_decimated_picture_ptr;
-                    ref_picture_ptr     = quarter_ref_pic_ptr;
-                    input_picture_ptr   = quarter_picture_ptr;
-                } else {
-                    ref_picture_ptr = (EbPictureBufferDesc *)
-                                          reference_object->input_padded_picture_ptr;
-                }
+/* Global motion search of one reference of the picture, the references of a
+ * picture can be searched in parallel */
+void global_motion_estimation_ref(PictureParentControlSet *pcs_ptr,
+                                  EbPictureBufferDesc *input_picture_ptr, uint32_t list_index,
+                                  uint32_t ref_pic_index) {
+    SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    EbPaReferenceObject *pa_reference_object = (EbPaReferenceObject *)
+                                                   pcs_ptr->pa_reference_picture_wrapper_ptr
+                                                       ->object_ptr;
+    EbPaReferenceObject *reference_object    = (EbPaReferenceObject *)pcs_ptr
+                                                ->ref_pa_pic_ptr_array[list_index][ref_pic_index]
+                                                ->object_ptr;
+    // The corners of the downsampled source are kept with its PA reference
+    // object, for the pictures referencing it
+    EbPaReferenceObject *input_corners_object = NULL;
+    EbPictureBufferDesc *ref_picture_ptr;
+
+    // Set the source and the reference picture to be used by the global motion search
+    // based on the input search mode
+    if (pcs_ptr->gm_level == GM_DOWN16) {
+        if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
+            ref_picture_ptr   = reference_object->sixteenth_filtered_picture_ptr;
+            input_picture_ptr = pa_reference_object->sixteenth_filtered_picture_ptr;
+        } else {
+            ref_picture_ptr   = reference_object->sixteenth_decimated_picture_ptr;
+            input_picture_ptr = pa_reference_object->sixteenth_decimated_picture_ptr;
+        }
+        input_corners_object = pa_reference_object;
+    } else if (pcs_ptr->gm_level == GM_DOWN) {
+        if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
+            ref_picture_ptr   = reference_object->quarter_filtered_picture_ptr;
+            input_picture_ptr = pa_reference_object->quarter_filtered_picture_ptr;
+        } else {
+            ref_picture_ptr   = reference_object->quarter_decimated_picture_ptr;
+            input_picture_ptr = pa_reference_object->quarter_decimated_picture_ptr;
+        }
+        input_corners_object = pa_reference_object;
+    } else {
+        ref_picture_ptr = reference_object->input_padded_picture_ptr;
+    }
 
-                compute_global_motion(pcs_ptr,
-                                      input_picture_ptr,
-                                      ref_picture_ptr,
-                                      &pcs_ptr->global_motion_estimation[list_index][ref_pic_index],
-                                      pcs_ptr->frm_hdr.allow_high_precision_mv);
-            }
+    compute_global_motion(pcs_ptr,
+                          input_picture_ptr,
+                          ref_picture_ptr,
+                          input_corners_object,
+                          reference_object,
+                          &pcs_ptr->global_motion_estimation[list_index][ref_pic_index],
+                          pcs_ptr->frm_hdr.allow_high_precision_mv);
+}
 
-            if (pcs_ptr->gm_ctrls.identiy_exit) {
-                if (list_index == 0) {
-                    if (pcs_ptr->global_motion_estimation[0][0].wmtype == IDENTITY) {
-                        break;
-                    }
-                }
-            }
-        }
+/* Flags the references with a global motion, once all of them are searched */
+void global_motion_estimation_finish(PictureParentControlSet *pcs_ptr) {
+    uint32_t num_of_list_to_search = (pcs_ptr->slice_type == P_SLICE) ? (uint32_t)REF_LIST_0
+                                                                      : (uint32_t)REF_LIST_1;
     for (uint32_t list_index = REF_LIST_0; list_index <= num_of_list_to_search; ++list_index) {
         uint32_t num_of_ref_pic_to_search = pcs_ptr->slice_type == P_SLICE
             ? pcs_ptr->ref_list0_count
@@ -152,6 +154,26 @@ void global_motion_estimation(PictureParentControlSet *pcs_ptr,
     }
 }
 
+void global_motion_estimation(PictureParentControlSet *pcs_ptr,
+                              EbPictureBufferDesc *    input_picture_ptr) {
+    uint32_t ref_count[MAX_NUM_OF_REF_PIC_LIST];
+    global_motion_estimation_init(pcs_ptr, input_picture_ptr, ref_count);
+    for (uint32_t list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; ++list_index) {
+        // Ref Picture Loop
+        for (uint32_t ref_pic_index = 0; ref_pic_index < ref_count[list_index]; ++ref_pic_index)
+            global_motion_estimation_ref(pcs_ptr, input_picture_ptr, list_index, ref_pic_index);
+
+        if (pcs_ptr->gm_ctrls.identiy_exit && ref_count[list_index]) {
+            if (list_index == 0) {
+                if (pcs_ptr->global_motion_estimation[0][0].wmtype == IDENTITY) {
+                    break;
+                }
+            }
+        }
+    }
+    global_motion_estimation_finish(pcs_ptr);
+}
+
 // This function performs global motion estimation when in loop me is used
 void global_motion_estimation_inl(PictureParentControlSet *pcs_ptr,
                                   EbPictureBufferDesc *    input_picture_ptr) {
@@ -232,6 +254,8 @@ void global_motion_estimation_inl(PictureParentControlSet *pcs_ptr,
                 compute_global_motion(pcs_ptr,
                                       input_picture_ptr,
                                       ref_picture_ptr,
+                                      NULL,
+                                      NULL,
                                       &pcs_ptr->global_motion_estimation[list_index][ref_pic_index],
                                       pcs_ptr->frm_hdr.allow_high_precision_mv);
             }
@@ -259,8 +283,43 @@ void global_motion_estimation_inl(PictureParentControlSet *pcs_ptr,
     }
 }
 
+/* FAST corners of the luma of a picture. The corners of a PA reference object
+ * picture are detected once, and copied for the other pictures searching it */
+static int get_gm_corners(EbPaReferenceObject *pa_obj, EbPictureBufferDesc *pic,
+                          uint8_t *buffer, int width, int height, int *corners) {
+    int num_corners;
+    if (pa_obj) {
+        svt_block_on_mutex(pa_obj->gm_corners_mutex);
+        if (pa_obj->gm_corners_buffer == buffer && pa_obj->gm_corners_width == width &&
+            pa_obj->gm_corners_height == height) {
+            num_corners = pa_obj->gm_num_corners;
+            svt_memcpy(corners, pa_obj->gm_corners, 2 * num_corners * sizeof(*corners));
+            svt_release_mutex(pa_obj->gm_corners_mutex);
+            return num_corners;
+        }
+        svt_release_mutex(pa_obj->gm_corners_mutex);
+    }
+    num_corners = svt_av1_fast_corner_detect(
+        buffer, width, height, pic->stride_y, corners, MAX_CORNERS);
+    if (pa_obj) {
+        svt_block_on_mutex(pa_obj->gm_corners_mutex);
+        if (!pa_obj->gm_corners)
+            pa_obj->gm_corners = (int *)malloc(2 * MAX_CORNERS * sizeof(*pa_obj->gm_corners));
+        if (pa_obj->gm_corners) {
+            svt_memcpy(pa_obj->gm_corners, corners, 2 * num_corners * sizeof(*corners));
+            pa_obj->gm_num_corners    = num_corners;
+            pa_obj->gm_corners_width  = width;
+            pa_obj->gm_corners_height = height;
+            pa_obj->gm_corners_buffer = buffer;
+        }
+        svt_release_mutex(pa_obj->gm_corners_mutex);
+    }
+    return num_corners;
+}
+
 void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc *input_pic,
-                           EbPictureBufferDesc *ref_pic, EbWarpedMotionParams *bestWarpedMotion,
+                           EbPictureBufferDesc *ref_pic, EbPaReferenceObject *input_pa_obj,
+                           EbPaReferenceObject *ref_pa_obj, EbWarpedMotionParams *bestWarpedMotion,
                            int allow_high_precision_mv) {
     MotionModel params_by_motion[RANSAC_NUM_MOTIONS];
     for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) {
@@ -285,15 +344,32 @@ void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc
     // TODO: check ref_params
     const EbWarpedMotionParams *ref_params = &default_warp_params;
 
+    int *correspondences = NULL;
     {
-        int frm_corners[2 * MAX_CORNERS], inliers_by_motion[RANSAC_NUM_MOTIONS];
+        int frm_corners[2 * MAX_CORNERS], ref_corners[2 * MAX_CORNERS];
+        int inliers_by_motion[RANSAC_NUM_MOTIONS];
         // compute interest points using FAST features
-        int num_frm_corners = svt_av1_fast_corner_detect(frm_buffer,
-                                                         input_pic->width,
-                                                         input_pic->height,
-                                                         input_pic->stride_y,
-                                                         frm_corners,
-                                                         MAX_CORNERS);
+        int num_frm_corners = get_gm_corners(
+            input_pa_obj, input_pic, frm_buffer, input_pic->width, input_pic->height, frm_corners);
+        int num_ref_corners = get_gm_corners(
+            ref_pa_obj, ref_pic, ref_buffer, input_pic->width, input_pic->height, ref_corners);
+
+        // find correspondences between the two images, they do not depend on the model
+        correspondences = (int *)malloc(num_frm_corners * 4 * sizeof(*correspondences));
+        int num_correspondences = correspondences
+            ? svt_av1_determine_correspondence(frm_buffer,
+                                               frm_corners,
+                                               num_frm_corners,
+                                               ref_buffer,
+                                               ref_corners,
+                                               num_ref_corners,
+                                               input_pic->width,
+                                               input_pic->height,
+                                               input_pic->stride_y,
+                                               ref_pic->stride_y,
+                                               correspondences)
+            : 0;
+        int64_t ref_frame_error = -1;
 
         TransformationType   model;
         EbWarpedMotionParams tmp_wm_params;
@@ -313,15 +389,8 @@ void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc
             }
 
             svt_av1_compute_global_motion(model,
-                                          frm_buffer,
-                                          input_pic->width,
-                                          input_pic->height,
-                                          input_pic->stride_y,
-                                          frm_corners,
-                                          num_frm_corners,
-                                          ref_buffer,
-                                          ref_pic->stride_y,
-                                          EB_8BIT,
+                                          correspondences,
+                                          num_correspondences,
                                           gm_estimation_type,
                                           inliers_by_motion,
                                           params_by_motion,
@@ -373,14 +442,15 @@ void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc
             if (global_motion.wmtype == IDENTITY)
                 continue;
 
-            const int64_t ref_frame_error = svt_av1_frame_error(EB_FALSE,
-                                                                EB_8BIT,
-                                                                ref_buffer,
-                                                                ref_pic->stride_y,
-                                                                frm_buffer,
-                                                                input_pic->width,
-                                                                input_pic->height,
-                                                                input_pic->stride_y);
+            if (ref_frame_error < 0)
+                ref_frame_error = svt_av1_frame_error(EB_FALSE,
+                                                      EB_8BIT,
+                                                      ref_buffer,
+                                                      ref_pic->stride_y,
+                                                      frm_buffer,
+                                                      input_pic->width,
+                                                      input_pic->height,
+                                                      input_pic->stride_y);
 
             if (ref_frame_error == 0)
                 continue;
@@ -401,5 +471,7 @@ void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc
 
     *bestWarpedMotion = global_motion;
 
+    free(correspondences);
+
     for (int m = 0; m < RANSAC_NUM_MOTIONS; m++) { free(params_by_motion[m].inliers); }
 }
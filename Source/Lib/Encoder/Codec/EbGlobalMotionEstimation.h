@@ -15,11 +15,23 @@
 
 #include "EbPictureBufferDesc.h"
 #include "EbMotionEstimationContext.h"
+#include "EbReferenceObject.h"
 
 void global_motion_estimation(PictureParentControlSet *pcs_ptr,
                               EbPictureBufferDesc *    input_picture_ptr);
+// global_motion_estimation() in steps: the references counted by
+// global_motion_estimation_init() can be searched in any order, on any thread,
+// before global_motion_estimation_finish()
+void global_motion_estimation_init(PictureParentControlSet *pcs_ptr,
+                                   EbPictureBufferDesc *    input_picture_ptr,
+                                   uint32_t ref_count[MAX_NUM_OF_REF_PIC_LIST]);
+void global_motion_estimation_ref(PictureParentControlSet *pcs_ptr,
+                                  EbPictureBufferDesc *input_picture_ptr, uint32_t list_index,
+                                  uint32_t ref_pic_index);
+void global_motion_estimation_finish(PictureParentControlSet *pcs_ptr);
 void compute_global_motion(PictureParentControlSet *pcs_ptr, EbPictureBufferDesc *input_pic,
-                           EbPictureBufferDesc *ref_pic, EbWarpedMotionParams *bestWarpedMotion,
+                           EbPictureBufferDesc *ref_pic, EbPaReferenceObject *input_pa_obj,
+                           EbPaReferenceObject *ref_pa_obj, EbWarpedMotionParams *bestWarpedMotion,
                            int allow_high_precision_mv);
 void global_motion_estimation_inl(PictureParentControlSet *pcs_ptr,
                                   EbPictureBufferDesc *    input_picture_ptr);
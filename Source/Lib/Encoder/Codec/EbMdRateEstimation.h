@@ -185,18 +185,22 @@ extern "C" {
     /**************************************************************************
     * Estimate the rate for each syntax elements and for
     * all scenarios based on the frame CDF
+    * built_fc: CDFs the table was last estimated from, only the
+    * changed CDFs are re-costed (NULL for a full estimation)
     ***************************************************************************/
     extern void av1_estimate_syntax_rate(
         MdRateEstimationContext      *md_rate_estimation_array,
         EbBool                          is_i_slice,
-        FRAME_CONTEXT                  *fc);
+        FRAME_CONTEXT                  *fc,
+        const FRAME_CONTEXT            *built_fc);
     /**************************************************************************
     * Estimate the rate of the quantised coefficient
     * based on the frame CDF
     ***************************************************************************/
     extern void av1_estimate_coefficients_rate(
         MdRateEstimationContext  *md_rate_estimation_array,
-        FRAME_CONTEXT              *fc);
+        FRAME_CONTEXT              *fc,
+        const FRAME_CONTEXT        *built_fc);
     /**************************************************************************
     * av1_estimate_mv_rate()
     * Estimate the rate of motion vectors
@@ -205,7 +209,8 @@ extern "C" {
 extern void av1_estimate_mv_rate(
         struct PictureControlSet *pcs_ptr,
         MdRateEstimationContext  *md_rate_estimation_array,
-        FRAME_CONTEXT            *fc);
+        FRAME_CONTEXT            *fc,
+        const FRAME_CONTEXT      *built_fc);
 #define AVG_CDF_WEIGHT_LEFT      3
 #define AVG_CDF_WEIGHT_TOP       1
 
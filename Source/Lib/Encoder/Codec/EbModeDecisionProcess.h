@@ -288,6 +288,9 @@ typedef struct ModeDecisionContext {
     MdRateEstimationContext *      md_rate_estimation_ptr;
     EbBool                         is_md_rate_estimation_ptr_owner;
     struct MdRateEstimationContext rate_est_table;
+    // CDFs of the previous SB the rate_est_table was updated from
+    FRAME_CONTEXT                  rate_est_fc;
+    EbBool                         rate_est_fc_valid;
     InterPredictionContext *       inter_prediction_context;
     MdBlkStruct *                  md_local_blk_unit;
     BlkStruct *                    md_blk_arr_nsq;
@@ -541,6 +541,9 @@ EbErrorType motion_estimation_context_ctor(EbThreadContext *  thread_context_ptr
         enc_handle_ptr->picture_decision_results_resource_ptr, index);
     context_ptr->motion_estimation_results_output_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->motion_estimation_results_resource_ptr, index);
+    // Producer 0 is the picture decision, the ME threads post the global motion tasks
+    context_ptr->picture_decision_results_output_fifo_ptr = svt_system_resource_get_producer_fifo(
+        enc_handle_ptr->picture_decision_results_resource_ptr, 1 + index);
     EB_NEW(context_ptr->me_context_ptr,
         me_context_ctor);
     return EB_ErrorNone;
@@ -730,393 +733,498 @@ EbErrorType compute_zz_ssd(/*MotionEstimationContext_t *context_ptr, */PicturePa
  * to the prediction structure pattern.  The Motion Analysis process is multithreaded,
  * so pictures can be processed out of order as long as all inputs are available.
  ************************************************/
-void *motion_estimation_kernel(void *input_ptr) {
+/* Global motion search, once all the SBs of the picture went through ME. The
+ * first reference of list 0 is searched here since it decides whether list 1
+ * is searched at all. With more than one ME thread, the other references are
+ * left to GM tasks: returns their count, and ref_count the references to post. */
+static uint32_t start_global_motion_estimation(SequenceControlSet *     scs_ptr,
+                                               PictureParentControlSet *pcs_ptr,
+                                               EbPictureBufferDesc *    input_picture_ptr,
+                                               uint32_t ref_count[MAX_NUM_OF_REF_PIC_LIST]) {
+    global_motion_estimation_init(pcs_ptr, input_picture_ptr, ref_count);
+    uint32_t first_ref = 0;
+    if (ref_count[REF_LIST_0]) {
+        global_motion_estimation_ref(pcs_ptr, input_picture_ptr, REF_LIST_0, 0);
+        first_ref = 1;
+        if (pcs_ptr->gm_ctrls.identiy_exit &&
+            pcs_ptr->global_motion_estimation[0][0].wmtype == IDENTITY)
+            ref_count[REF_LIST_1] = 0;
+    }
+    const uint32_t task_count = ref_count[REF_LIST_0] + ref_count[REF_LIST_1] - first_ref;
+    if (scs_ptr->motion_estimation_process_init_count > 1 && task_count)
+        return task_count;
+
+    for (uint32_t list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; ++list_index)
+        for (uint32_t ref_pic_index = list_index == REF_LIST_0 ? first_ref : 0;
+             ref_pic_index < ref_count[list_index];
+             ++ref_pic_index)
+            global_motion_estimation_ref(pcs_ptr, input_picture_ptr, list_index, ref_pic_index);
+    global_motion_estimation_finish(pcs_ptr);
+    return 0;
+}
+
+/* One GM task per reference left by start_global_motion_estimation() */
+static void post_global_motion_tasks(MotionEstimationContext_t *context_ptr,
+                                     EbObjectWrapper *          pcs_wrapper_ptr,
+                                     const uint32_t ref_count[MAX_NUM_OF_REF_PIC_LIST]) {
+    for (uint32_t list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; ++list_index)
+        for (uint32_t ref_pic_index = list_index == REF_LIST_0 ? 1 : 0;
+             ref_pic_index < ref_count[list_index];
+             ++ref_pic_index) {
+            EbObjectWrapper *out_results_wrapper_ptr;
+            svt_get_empty_object(context_ptr->picture_decision_results_output_fifo_ptr,
+                                 &out_results_wrapper_ptr);
+            PictureDecisionResults *out_results_ptr = (PictureDecisionResults *)
+                                                          out_results_wrapper_ptr->object_ptr;
+            out_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+            out_results_ptr->segment_index   = 0;
+            out_results_ptr->task_type       = 3;
+            out_results_ptr->list_index      = (uint8_t)list_index;
+            out_results_ptr->ref_pic_index   = (uint8_t)ref_pic_index;
+            svt_post_full_object(out_results_wrapper_ptr);
+        }
+}
+
+void motion_estimation_task(EbPtr input_ptr, EbObjectWrapper *in_results_wrapper_ptr) {
     EbThreadContext *          thread_context_ptr = (EbThreadContext *)input_ptr;
     MotionEstimationContext_t *context_ptr = (MotionEstimationContext_t *)thread_context_ptr->priv;
-    EbObjectWrapper *          in_results_wrapper_ptr;
     EbObjectWrapper *          out_results_wrapper_ptr;
-    for (;;) {
-        // Get Input Full Object
-        EB_GET_FULL_OBJECT(context_ptr->picture_decision_results_input_fifo_ptr,
-                           &in_results_wrapper_ptr);
-        PictureDecisionResults *in_results_ptr = (PictureDecisionResults *)
-                                                     in_results_wrapper_ptr->object_ptr;
-        PictureParentControlSet *pcs_ptr = (PictureParentControlSet *)
-                                               in_results_ptr->pcs_wrapper_ptr->object_ptr;
-        SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        context_ptr->me_context_ptr->me_type =
-            in_results_ptr->task_type == 1 ? ME_MCTF :
-            in_results_ptr->task_type == 0 ? ME_OPEN_LOOP : ME_FIRST_PASS;
-
-        // Lambda Assignement
-        if (scs_ptr->static_config.pred_structure == EB_PRED_RANDOM_ACCESS) {
-            if (pcs_ptr->temporal_layer_index == 0)
-                context_ptr->me_context_ptr->lambda =
-                    lambda_mode_decision_ra_sad[pcs_ptr->picture_qp];
-            else if (pcs_ptr->temporal_layer_index < 3)
-                context_ptr->me_context_ptr->lambda =
-                    lambda_mode_decision_ra_sad_qp_scaling_l1[pcs_ptr->picture_qp];
-            else
-                context_ptr->me_context_ptr->lambda =
-                    lambda_mode_decision_ra_sad_qp_scaling_l3[pcs_ptr->picture_qp];
-        } else {
-            if (pcs_ptr->temporal_layer_index == 0)
-                context_ptr->me_context_ptr->lambda =
-                    lambda_mode_decision_ld_sad[pcs_ptr->picture_qp];
-            else
-                context_ptr->me_context_ptr->lambda =
-                    lambda_mode_decision_ld_sad_qp_scaling[pcs_ptr->picture_qp];
-        }
-        if (in_results_ptr->task_type == 0) {
-            // ME Kernel Signal(s) derivation
-            if (use_output_stat(scs_ptr))
-                first_pass_signal_derivation_me_kernel(scs_ptr, pcs_ptr, context_ptr);
-            else
-                signal_derivation_me_kernel_oq(scs_ptr, pcs_ptr, context_ptr);
-            EbPictureBufferDesc *sixteenth_picture_ptr = NULL;
-            EbPictureBufferDesc *quarter_picture_ptr = NULL;
-            EbPictureBufferDesc *input_padded_picture_ptr = NULL;
-            EbPictureBufferDesc *input_picture_ptr = NULL;
-            EbPaReferenceObject *pa_ref_obj_ = NULL;
-            if (!scs_ptr->in_loop_me) {
-                pa_ref_obj_ = (EbPaReferenceObject *)pcs_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
-                // Set 1/4 and 1/16 ME input buffer(s); filtered or decimated
-                quarter_picture_ptr =
-                    (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
-                    ? (EbPictureBufferDesc *)pa_ref_obj_->quarter_filtered_picture_ptr
-                    : (EbPictureBufferDesc *)pa_ref_obj_->quarter_decimated_picture_ptr;
-
-                sixteenth_picture_ptr =
-                    (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
-                    ? (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_filtered_picture_ptr
-                    : (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_decimated_picture_ptr;
-                input_padded_picture_ptr = (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr;
-            }
-            input_picture_ptr = pcs_ptr->enhanced_unscaled_picture_ptr;
-            // Segments
-            uint32_t segment_index   = in_results_ptr->segment_index;
-            uint32_t pic_width_in_sb = (pcs_ptr->aligned_width + scs_ptr->sb_sz - 1) /
-                scs_ptr->sb_sz;
-            uint32_t picture_height_in_sb = (pcs_ptr->aligned_height + scs_ptr->sb_sz - 1) /
-                scs_ptr->sb_sz;
-            uint32_t y_segment_index;
-            uint32_t x_segment_index;
-            SEGMENT_CONVERT_IDX_TO_XY(
-                segment_index, x_segment_index, y_segment_index, pcs_ptr->me_segments_column_count);
-            uint32_t x_sb_start_index = SEGMENT_START_IDX(
-                x_segment_index, pic_width_in_sb, pcs_ptr->me_segments_column_count);
-            uint32_t x_sb_end_index = SEGMENT_END_IDX(
-                x_segment_index, pic_width_in_sb, pcs_ptr->me_segments_column_count);
-            uint32_t y_sb_start_index = SEGMENT_START_IDX(
-                y_segment_index, picture_height_in_sb, pcs_ptr->me_segments_row_count);
-            uint32_t y_sb_end_index = SEGMENT_END_IDX(
-                y_segment_index, picture_height_in_sb, pcs_ptr->me_segments_row_count);
-            EbBool skip_me = EB_FALSE;
-            if (use_output_stat(scs_ptr))
-                skip_me = EB_TRUE;
-            // skip me for the first pass. ME is already performed
-            if (!skip_me) {
-            // *** MOTION ESTIMATION CODE ***
-            if (pcs_ptr->slice_type != I_SLICE && !scs_ptr->in_loop_me) {
-                // Use scaled source references if resolution of the reference is different that of the input
-                use_scaled_source_refs_if_needed(pcs_ptr,
-                                                 input_picture_ptr,
-                                                 pa_ref_obj_,
-                                                 &input_padded_picture_ptr,
-                                                 &quarter_picture_ptr,
-                                                 &sixteenth_picture_ptr);
 
-                // SB Loop
-                for (uint32_t y_sb_index = y_sb_start_index; y_sb_index < y_sb_end_index;
-                     ++y_sb_index) {
-                    for (uint32_t x_sb_index = x_sb_start_index; x_sb_index < x_sb_end_index;
-                         ++x_sb_index) {
-                        uint32_t sb_index = (uint16_t)(x_sb_index + y_sb_index * pic_width_in_sb);
-                        uint32_t sb_origin_x = x_sb_index * scs_ptr->sb_sz;
-                        uint32_t sb_origin_y = y_sb_index * scs_ptr->sb_sz;
-
-                        uint32_t sb_width = (pcs_ptr->aligned_width - sb_origin_x) < BLOCK_SIZE_64
-                            ? pcs_ptr->aligned_width - sb_origin_x
-                            : BLOCK_SIZE_64;
-
-                        // Load the SB from the input to the intermediate SB buffer
-                        uint32_t buffer_index = (input_picture_ptr->origin_y + sb_origin_y) *
-                                input_picture_ptr->stride_y +
-                            input_picture_ptr->origin_x + sb_origin_x;
-                        for (unsigned sb_row = 0; sb_row < BLOCK_SIZE_64; sb_row++) {
-                            svt_memcpy(
-                                &(context_ptr->me_context_ptr->sb_buffer[sb_row * BLOCK_SIZE_64]),
-                                &(input_picture_ptr
-                                      ->buffer_y[buffer_index +
-                                                 sb_row * input_picture_ptr->stride_y]),
-                                sizeof(uint8_t) * BLOCK_SIZE_64);
-                        }
+    PictureDecisionResults *in_results_ptr = (PictureDecisionResults *)
+                                                 in_results_wrapper_ptr->object_ptr;
+    PictureParentControlSet *pcs_ptr = (PictureParentControlSet *)
+                                           in_results_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet * scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    context_ptr->me_context_ptr->me_type =
+        in_results_ptr->task_type == 1 ? ME_MCTF :
+        in_results_ptr->task_type == 0 ? ME_OPEN_LOOP : ME_FIRST_PASS;
+
+    // Lambda Assignement
+    if (scs_ptr->static_config.pred_structure == EB_PRED_RANDOM_ACCESS) {
+        if (pcs_ptr->temporal_layer_index == 0)
+            context_ptr->me_context_ptr->lambda =
+                lambda_mode_decision_ra_sad[pcs_ptr->picture_qp];
+        else if (pcs_ptr->temporal_layer_index < 3)
+            context_ptr->me_context_ptr->lambda =
+                lambda_mode_decision_ra_sad_qp_scaling_l1[pcs_ptr->picture_qp];
+        else
+            context_ptr->me_context_ptr->lambda =
+                lambda_mode_decision_ra_sad_qp_scaling_l3[pcs_ptr->picture_qp];
+    } else {
+        if (pcs_ptr->temporal_layer_index == 0)
+            context_ptr->me_context_ptr->lambda =
+                lambda_mode_decision_ld_sad[pcs_ptr->picture_qp];
+        else
+            context_ptr->me_context_ptr->lambda =
+                lambda_mode_decision_ld_sad_qp_scaling[pcs_ptr->picture_qp];
+    }
+    if (in_results_ptr->task_type == 0) {
+        // ME Kernel Signal(s) derivation
+        if (use_output_stat(scs_ptr))
+            first_pass_signal_derivation_me_kernel(scs_ptr, pcs_ptr, context_ptr);
+        else
+            signal_derivation_me_kernel_oq(scs_ptr, pcs_ptr, context_ptr);
+        EbPictureBufferDesc *sixteenth_picture_ptr = NULL;
+        EbPictureBufferDesc *quarter_picture_ptr = NULL;
+        EbPictureBufferDesc *input_padded_picture_ptr = NULL;
+        EbPictureBufferDesc *input_picture_ptr = NULL;
+        EbPaReferenceObject *pa_ref_obj_ = NULL;
+        if (!scs_ptr->in_loop_me) {
+            pa_ref_obj_ = (EbPaReferenceObject *)pcs_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
+            // Set 1/4 and 1/16 ME input buffer(s); filtered or decimated
+            quarter_picture_ptr =
+                (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
+                ? (EbPictureBufferDesc *)pa_ref_obj_->quarter_filtered_picture_ptr
+                : (EbPictureBufferDesc *)pa_ref_obj_->quarter_decimated_picture_ptr;
+
+            sixteenth_picture_ptr =
+                (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED)
+                ? (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_filtered_picture_ptr
+                : (EbPictureBufferDesc *)pa_ref_obj_->sixteenth_decimated_picture_ptr;
+            input_padded_picture_ptr = (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr;
+        }
+        input_picture_ptr = pcs_ptr->enhanced_unscaled_picture_ptr;
+        // References left to the GM tasks, when this segment triggers the global motion search
+        uint32_t gm_ref_count[MAX_NUM_OF_REF_PIC_LIST];
+        uint32_t gm_task_count = 0;
+        // Segments
+        uint32_t segment_index   = in_results_ptr->segment_index;
+        uint32_t pic_width_in_sb = (pcs_ptr->aligned_width + scs_ptr->sb_sz - 1) /
+            scs_ptr->sb_sz;
+        uint32_t picture_height_in_sb = (pcs_ptr->aligned_height + scs_ptr->sb_sz - 1) /
+            scs_ptr->sb_sz;
+        uint32_t y_segment_index;
+        uint32_t x_segment_index;
+        SEGMENT_CONVERT_IDX_TO_XY(
+            segment_index, x_segment_index, y_segment_index, pcs_ptr->me_segments_column_count);
+        uint32_t x_sb_start_index = SEGMENT_START_IDX(
+            x_segment_index, pic_width_in_sb, pcs_ptr->me_segments_column_count);
+        uint32_t x_sb_end_index = SEGMENT_END_IDX(
+            x_segment_index, pic_width_in_sb, pcs_ptr->me_segments_column_count);
+        uint32_t y_sb_start_index = SEGMENT_START_IDX(
+            y_segment_index, picture_height_in_sb, pcs_ptr->me_segments_row_count);
+        uint32_t y_sb_end_index = SEGMENT_END_IDX(
+            y_segment_index, picture_height_in_sb, pcs_ptr->me_segments_row_count);
+        EbBool skip_me = EB_FALSE;
+        if (use_output_stat(scs_ptr))
+            skip_me = EB_TRUE;
+        // skip me for the first pass. ME is already performed
+        if (!skip_me) {
+        // *** MOTION ESTIMATION CODE ***
+        if (pcs_ptr->slice_type != I_SLICE && !scs_ptr->in_loop_me) {
+            // Use scaled source references if resolution of the reference is different that of the input
+            use_scaled_source_refs_if_needed(pcs_ptr,
+                                             input_picture_ptr,
+                                             pa_ref_obj_,
+                                             &input_padded_picture_ptr,
+                                             &quarter_picture_ptr,
+                                             &sixteenth_picture_ptr);
+
+            // SB Loop
+            for (uint32_t y_sb_index = y_sb_start_index; y_sb_index < y_sb_end_index;
+                 ++y_sb_index) {
+                for (uint32_t x_sb_index = x_sb_start_index; x_sb_index < x_sb_end_index;
+                     ++x_sb_index) {
+                    uint32_t sb_index = (uint16_t)(x_sb_index + y_sb_index * pic_width_in_sb);
+                    uint32_t sb_origin_x = x_sb_index * scs_ptr->sb_sz;
+                    uint32_t sb_origin_y = y_sb_index * scs_ptr->sb_sz;
+
+                    uint32_t sb_width = (pcs_ptr->aligned_width - sb_origin_x) < BLOCK_SIZE_64
+                        ? pcs_ptr->aligned_width - sb_origin_x
+                        : BLOCK_SIZE_64;
+
+                    // Load the SB from the input to the intermediate SB buffer
+                    uint32_t buffer_index = (input_picture_ptr->origin_y + sb_origin_y) *
+                            input_picture_ptr->stride_y +
+                        input_picture_ptr->origin_x + sb_origin_x;
+                    for (unsigned sb_row = 0; sb_row < BLOCK_SIZE_64; sb_row++) {
+                        svt_memcpy(
+                            &(context_ptr->me_context_ptr->sb_buffer[sb_row * BLOCK_SIZE_64]),
+                            &(input_picture_ptr
+                                  ->buffer_y[buffer_index +
+                                             sb_row * input_picture_ptr->stride_y]),
+                            sizeof(uint8_t) * BLOCK_SIZE_64);
+                    }
 #ifdef ARCH_X86_64
-                        uint8_t *src_ptr   = &input_padded_picture_ptr->buffer_y[buffer_index];
-                        uint32_t sb_height = (pcs_ptr->aligned_height - sb_origin_y) < BLOCK_SIZE_64
-                            ? pcs_ptr->aligned_height - sb_origin_y
-                            : BLOCK_SIZE_64;
-                        //_MM_HINT_T0     //_MM_HINT_T1    //_MM_HINT_T2//_MM_HINT_NTA
-                        for (uint32_t i = 0; i < sb_height; i++) {
-                            char const *p = (char const *)(src_ptr +
-                                                           i * input_padded_picture_ptr->stride_y);
-
-                            _mm_prefetch(p, _MM_HINT_T2);
-                        }
+                    uint8_t *src_ptr   = &input_padded_picture_ptr->buffer_y[buffer_index];
+                    uint32_t sb_height = (pcs_ptr->aligned_height - sb_origin_y) < BLOCK_SIZE_64
+                        ? pcs_ptr->aligned_height - sb_origin_y
+                        : BLOCK_SIZE_64;
+                    //_MM_HINT_T0     //_MM_HINT_T1    //_MM_HINT_T2//_MM_HINT_NTA
+                    for (uint32_t i = 0; i < sb_height; i++) {
+                        char const *p = (char const *)(src_ptr +
+                                                       i * input_padded_picture_ptr->stride_y);
+
+                        _mm_prefetch(p, _MM_HINT_T2);
+                    }
 #endif
 
-                        context_ptr->me_context_ptr->sb_src_ptr =
-                            &input_padded_picture_ptr->buffer_y[buffer_index];
-                        context_ptr->me_context_ptr->sb_src_stride =
-                            input_padded_picture_ptr->stride_y;
-                        // Load the 1/4 decimated SB from the 1/4 decimated input to the 1/4 intermediate SB buffer
-                        if (context_ptr->me_context_ptr->enable_hme_level1_flag) {
-                            buffer_index = (quarter_picture_ptr->origin_y + (sb_origin_y >> 1)) *
-                                    quarter_picture_ptr->stride_y +
-                                quarter_picture_ptr->origin_x + (sb_origin_x >> 1);
-
-                            for (unsigned sb_row = 0; sb_row < (BLOCK_SIZE_64 >> 1); sb_row++) {
-                                svt_memcpy(
-                                    &(context_ptr->me_context_ptr->quarter_sb_buffer
-                                          [sb_row *
-                                           context_ptr->me_context_ptr->quarter_sb_buffer_stride]),
-                                    &(quarter_picture_ptr
-                                          ->buffer_y[buffer_index +
-                                                     sb_row * quarter_picture_ptr->stride_y]),
-                                    sizeof(uint8_t) * (sb_width >> 1));
-                            }
+                    context_ptr->me_context_ptr->sb_src_ptr =
+                        &input_padded_picture_ptr->buffer_y[buffer_index];
+                    context_ptr->me_context_ptr->sb_src_stride =
+                        input_padded_picture_ptr->stride_y;
+                    // Load the 1/4 decimated SB from the 1/4 decimated input to the 1/4 intermediate SB buffer
+                    if (context_ptr->me_context_ptr->enable_hme_level1_flag) {
+                        buffer_index = (quarter_picture_ptr->origin_y + (sb_origin_y >> 1)) *
+                                quarter_picture_ptr->stride_y +
+                            quarter_picture_ptr->origin_x + (sb_origin_x >> 1);
+
+                        for (unsigned sb_row = 0; sb_row < (BLOCK_SIZE_64 >> 1); sb_row++) {
+                            svt_memcpy(
+                                &(context_ptr->me_context_ptr->quarter_sb_buffer
+                                      [sb_row *
+                                       context_ptr->me_context_ptr->quarter_sb_buffer_stride]),
+                                &(quarter_picture_ptr
+                                      ->buffer_y[buffer_index +
+                                                 sb_row * quarter_picture_ptr->stride_y]),
+                                sizeof(uint8_t) * (sb_width >> 1));
                         }
+                    }
 
-                        // Load the 1/16 decimated SB from the 1/16 decimated input to the 1/16 intermediate SB buffer
-                        if (context_ptr->me_context_ptr->enable_hme_level0_flag) {
-                            buffer_index = (sixteenth_picture_ptr->origin_y + (sb_origin_y >> 2)) *
-                                    sixteenth_picture_ptr->stride_y +
-                                sixteenth_picture_ptr->origin_x + (sb_origin_x >> 2);
-
-                            uint8_t *frame_ptr = &sixteenth_picture_ptr->buffer_y[buffer_index];
-                            uint8_t *local_ptr = context_ptr->me_context_ptr->sixteenth_sb_buffer;
-                            for (unsigned sb_row = 0; sb_row < (BLOCK_SIZE_64 >> 2);
-                                 sb_row += context_ptr->me_context_ptr->hme_search_method ==
-                                         FULL_SAD_SEARCH
-                                     ? 1
-                                     : 2) {
-                                svt_memcpy(local_ptr, frame_ptr, (sb_width >> 2) * sizeof(uint8_t));
-                                local_ptr += 16;
-                                frame_ptr += sixteenth_picture_ptr->stride_y
-                                    << (context_ptr->me_context_ptr->hme_search_method !=
-                                        FULL_SAD_SEARCH);
-                            }
+                    // Load the 1/16 decimated SB from the 1/16 decimated input to the 1/16 intermediate SB buffer
+                    if (context_ptr->me_context_ptr->enable_hme_level0_flag) {
+                        buffer_index = (sixteenth_picture_ptr->origin_y + (sb_origin_y >> 2)) *
+                                sixteenth_picture_ptr->stride_y +
+                            sixteenth_picture_ptr->origin_x + (sb_origin_x >> 2);
+
+                        uint8_t *frame_ptr = &sixteenth_picture_ptr->buffer_y[buffer_index];
+                        uint8_t *local_ptr = context_ptr->me_context_ptr->sixteenth_sb_buffer;
+                        for (unsigned sb_row = 0; sb_row < (BLOCK_SIZE_64 >> 2);
+                             sb_row += context_ptr->me_context_ptr->hme_search_method ==
+                                     FULL_SAD_SEARCH
+                                 ? 1
+                                 : 2) {
+                            svt_memcpy(local_ptr, frame_ptr, (sb_width >> 2) * sizeof(uint8_t));
+                            local_ptr += 16;
+                            frame_ptr += sixteenth_picture_ptr->stride_y
+                                << (context_ptr->me_context_ptr->hme_search_method !=
+                                    FULL_SAD_SEARCH);
                         }
-                        context_ptr->me_context_ptr->me_type = ME_OPEN_LOOP;
-                        context_ptr->me_context_ptr->num_of_list_to_search =
-                            (pcs_ptr->slice_type == P_SLICE) ? (uint32_t)REF_LIST_0 : (uint32_t)REF_LIST_1;
-
-                        context_ptr->me_context_ptr->num_of_ref_pic_to_search[0] = pcs_ptr->ref_list0_count_try;
-                        if (pcs_ptr->slice_type == B_SLICE)
-                            context_ptr->me_context_ptr->num_of_ref_pic_to_search[1] = pcs_ptr->ref_list1_count_try;
-                        context_ptr->me_context_ptr->temporal_layer_index = pcs_ptr->temporal_layer_index;
-                        context_ptr->me_context_ptr->is_used_as_reference_flag = pcs_ptr->is_used_as_reference_flag;
-
-                        for (int i = 0; i<= context_ptr->me_context_ptr->num_of_list_to_search; i++) {
-                            for (int j=0; j< context_ptr->me_context_ptr->num_of_ref_pic_to_search[i];j++) {
-                                EbPaReferenceObject* reference_object =
-                                    (EbPaReferenceObject *)pcs_ptr->ref_pa_pic_ptr_array[i][j]->object_ptr;
-                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].picture_ptr =
-                                    reference_object->input_padded_picture_ptr;
-                                if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
-                                    context_ptr->me_context_ptr->me_ds_ref_array[i][j].quarter_picture_ptr =
-                                        reference_object->quarter_filtered_picture_ptr;
-                                    context_ptr->me_context_ptr->me_ds_ref_array[i][j].sixteenth_picture_ptr =
-                                        reference_object->sixteenth_filtered_picture_ptr;
-                                } else {
-                                    context_ptr->me_context_ptr->me_ds_ref_array[i][j].quarter_picture_ptr =
-                                        reference_object->quarter_decimated_picture_ptr;
-                                    context_ptr->me_context_ptr->me_ds_ref_array[i][j].sixteenth_picture_ptr =
-                                        reference_object->sixteenth_decimated_picture_ptr;
-                                }
-                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].picture_number = reference_object->picture_number;
+                    }
+                    context_ptr->me_context_ptr->me_type = ME_OPEN_LOOP;
+                    context_ptr->me_context_ptr->num_of_list_to_search =
+                        (pcs_ptr->slice_type == P_SLICE) ? (uint32_t)REF_LIST_0 : (uint32_t)REF_LIST_1;
+
+                    context_ptr->me_context_ptr->num_of_ref_pic_to_search[0] = pcs_ptr->ref_list0_count_try;
+                    if (pcs_ptr->slice_type == B_SLICE)
+                        context_ptr->me_context_ptr->num_of_ref_pic_to_search[1] = pcs_ptr->ref_list1_count_try;
+                    context_ptr->me_context_ptr->temporal_layer_index = pcs_ptr->temporal_layer_index;
+                    context_ptr->me_context_ptr->is_used_as_reference_flag = pcs_ptr->is_used_as_reference_flag;
+
+                    for (int i = 0; i<= context_ptr->me_context_ptr->num_of_list_to_search; i++) {
+                        for (int j=0; j< context_ptr->me_context_ptr->num_of_ref_pic_to_search[i];j++) {
+                            EbPaReferenceObject* reference_object =
+                                (EbPaReferenceObject *)pcs_ptr->ref_pa_pic_ptr_array[i][j]->object_ptr;
+                            context_ptr->me_context_ptr->me_ds_ref_array[i][j].picture_ptr =
+                                reference_object->input_padded_picture_ptr;
+                            if (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) {
+                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].quarter_picture_ptr =
+                                    reference_object->quarter_filtered_picture_ptr;
+                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].sixteenth_picture_ptr =
+                                    reference_object->sixteenth_filtered_picture_ptr;
+                            } else {
+                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].quarter_picture_ptr =
+                                    reference_object->quarter_decimated_picture_ptr;
+                                context_ptr->me_context_ptr->me_ds_ref_array[i][j].sixteenth_picture_ptr =
+                                    reference_object->sixteenth_decimated_picture_ptr;
                             }
+                            context_ptr->me_context_ptr->me_ds_ref_array[i][j].picture_number = reference_object->picture_number;
                         }
+                    }
 
-                        motion_estimate_sb(pcs_ptr,
-                                           sb_index,
-                                           sb_origin_x,
-                                           sb_origin_y,
-                                           context_ptr->me_context_ptr,
-                                           input_picture_ptr);
-                        svt_block_on_mutex(pcs_ptr->me_processed_sb_mutex);
-                        pcs_ptr->me_processed_sb_count++;
-                        // We need to finish ME for all SBs to do GM
-                        if (pcs_ptr->me_processed_sb_count == pcs_ptr->sb_total_count) {
-                            if (pcs_ptr->gm_ctrls.enabled)
-                                global_motion_estimation(
-
-                                    pcs_ptr, input_picture_ptr);
-                            else
-                            // Initilize global motion to be OFF when GM is OFF
-                                memset(pcs_ptr->is_global_motion, EB_FALSE, MAX_NUM_OF_REF_PIC_LIST * REF_LIST_MAX_DEPTH);
-                        }
+                    motion_estimate_sb(pcs_ptr,
+                                       sb_index,
+                                       sb_origin_x,
+                                       sb_origin_y,
+                                       context_ptr->me_context_ptr,
+                                       input_picture_ptr);
+                    svt_block_on_mutex(pcs_ptr->me_processed_sb_mutex);
+                    pcs_ptr->me_processed_sb_count++;
+                    // We need to finish ME for all SBs to do GM
+                    if (pcs_ptr->me_processed_sb_count == pcs_ptr->sb_total_count) {
+                        if (pcs_ptr->gm_ctrls.enabled)
+                            gm_task_count = start_global_motion_estimation(
+                                scs_ptr, pcs_ptr, input_picture_ptr, gm_ref_count);
+                        else
+                        // Initilize global motion to be OFF when GM is OFF
+                            memset(pcs_ptr->is_global_motion, EB_FALSE, MAX_NUM_OF_REF_PIC_LIST * REF_LIST_MAX_DEPTH);
+                    }
 
-                        svt_release_mutex(pcs_ptr->me_processed_sb_mutex);
+                    svt_release_mutex(pcs_ptr->me_processed_sb_mutex);
 
-                    }
                 }
             }
-            if (
-                scs_ptr->in_loop_ois == 0 &&
-                (!scs_ptr->in_loop_me || pcs_ptr->slice_type == I_SLICE) &&
-                scs_ptr->static_config.enable_tpl_la)
+        }
+        if (
+            scs_ptr->in_loop_ois == 0 &&
+            (!scs_ptr->in_loop_me || pcs_ptr->slice_type == I_SLICE) &&
+            scs_ptr->static_config.enable_tpl_la)
+            for (uint32_t y_sb_index = y_sb_start_index; y_sb_index < y_sb_end_index;
+                 ++y_sb_index)
+                for (uint32_t x_sb_index = x_sb_start_index; x_sb_index < x_sb_end_index;
+                     ++x_sb_index) {
+                    uint32_t sb_index = (uint16_t)(x_sb_index + y_sb_index * pic_width_in_sb);
+                    open_loop_intra_search_mb(pcs_ptr, sb_index, input_picture_ptr);
+                }
+        // ZZ SADs Computation
+        // 1 lookahead frame is needed to get valid (0,0) SAD
+        if (scs_ptr->static_config.look_ahead_distance != 0 &&
+                pcs_ptr->picture_number > 0 &&
+                !scs_ptr->in_loop_me)
+            // when DG is ON, the ZZ SADs are computed @ the PD process
+            // ZZ SADs Computation using decimated picture
+            compute_decimated_zz_sad(
+                context_ptr,
+                pcs_ptr,
+                (EbPictureBufferDesc *)pa_ref_obj_
+                    ->sixteenth_decimated_picture_ptr, // Hsan: always use decimated for ZZ SAD derivation until studying the trade offs and regenerating the activity threshold
+                x_sb_start_index,
+                x_sb_end_index,
+                y_sb_start_index,
+                y_sb_end_index);
+
+        if (scs_ptr->static_config.look_ahead_distance != 0 &&
+                pcs_ptr->picture_number > 0 &&
+                scs_ptr->in_loop_me)
+            compute_decimated_zz_sad(
+                context_ptr,
+                pcs_ptr,
+                pcs_ptr->ds_pics.sixteenth_picture_ptr,
+                x_sb_start_index,
+                x_sb_end_index,
+                y_sb_start_index,
+                y_sb_end_index);
+
+        if (scs_ptr->static_config.rate_control_mode && !use_input_stat(scs_ptr) && !scs_ptr->lap_enabled) {
+            // Calculate the ME Distortion and OIS Historgrams
+            svt_block_on_mutex(pcs_ptr->rc_distortion_histogram_mutex);
+
+            if (scs_ptr->static_config.rate_control_mode
+                && !(use_input_stat(scs_ptr) && scs_ptr->static_config.rate_control_mode == 1) //skip 2pass VBR
+                ) {
                 for (uint32_t y_sb_index = y_sb_start_index; y_sb_index < y_sb_end_index;
-                     ++y_sb_index)
+                    ++y_sb_index)
                     for (uint32_t x_sb_index = x_sb_start_index; x_sb_index < x_sb_end_index;
-                         ++x_sb_index) {
-                        uint32_t sb_index = (uint16_t)(x_sb_index + y_sb_index * pic_width_in_sb);
-                        open_loop_intra_search_mb(pcs_ptr, sb_index, input_picture_ptr);
-                    }
-            // ZZ SADs Computation
-            // 1 lookahead frame is needed to get valid (0,0) SAD
-            if (scs_ptr->static_config.look_ahead_distance != 0 &&
-                    pcs_ptr->picture_number > 0 &&
-                    !scs_ptr->in_loop_me)
-                // when DG is ON, the ZZ SADs are computed @ the PD process
-                // ZZ SADs Computation using decimated picture
-                compute_decimated_zz_sad(
-                    context_ptr,
-                    pcs_ptr,
-                    (EbPictureBufferDesc *)pa_ref_obj_
-                        ->sixteenth_decimated_picture_ptr, // Hsan: always use decimated for ZZ SAD derivation until studying the trade offs and regenerating the activity threshold
-                    x_sb_start_index,
-                    x_sb_end_index,
-                    y_sb_start_index,
-                    y_sb_end_index);
-
-            if (scs_ptr->static_config.look_ahead_distance != 0 &&
-                    pcs_ptr->picture_number > 0 &&
-                    scs_ptr->in_loop_me)
-                compute_decimated_zz_sad(
-                    context_ptr,
-                    pcs_ptr,
-                    pcs_ptr->ds_pics.sixteenth_picture_ptr,
-                    x_sb_start_index,
-                    x_sb_end_index,
-                    y_sb_start_index,
-                    y_sb_end_index);
-
-            if (scs_ptr->static_config.rate_control_mode && !use_input_stat(scs_ptr) && !scs_ptr->lap_enabled) {
-                // Calculate the ME Distortion and OIS Historgrams
-                svt_block_on_mutex(pcs_ptr->rc_distortion_histogram_mutex);
-
-                if (scs_ptr->static_config.rate_control_mode
-                    && !(use_input_stat(scs_ptr) && scs_ptr->static_config.rate_control_mode == 1) //skip 2pass VBR
-                    ) {
-                    for (uint32_t y_sb_index = y_sb_start_index; y_sb_index < y_sb_end_index;
-                        ++y_sb_index)
-                        for (uint32_t x_sb_index = x_sb_start_index; x_sb_index < x_sb_end_index;
-                            ++x_sb_index) {
-                        uint32_t sb_origin_x = x_sb_index * scs_ptr->sb_sz;
-                        uint32_t sb_origin_y = y_sb_index * scs_ptr->sb_sz;
-                        uint32_t sb_width = (pcs_ptr->aligned_width - sb_origin_x) <
-                            BLOCK_SIZE_64
-                            ? pcs_ptr->aligned_width - sb_origin_x
-                            : BLOCK_SIZE_64;
-                        uint32_t sb_height = (pcs_ptr->aligned_height - sb_origin_y) <
-                            BLOCK_SIZE_64
-                            ? pcs_ptr->aligned_height - sb_origin_y
-                            : BLOCK_SIZE_64;
-
-                        uint32_t sb_index = (uint16_t)(x_sb_index +
-                            y_sb_index * pic_width_in_sb);
-                        pcs_ptr->inter_sad_interval_index[sb_index] = 0;
-                        pcs_ptr->intra_sad_interval_index[sb_index] = 0;
-
-                        if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
-                            if (pcs_ptr->slice_type != I_SLICE && !scs_ptr->in_loop_me) {
-                                uint16_t sad_interval_index = (uint16_t)(
-                                    pcs_ptr->rc_me_distortion[sb_index] >>
-                                    (12 - SAD_PRECISION_INTERVAL)); //change 12 to 2*log2(64)
-
-                                sad_interval_index = (uint16_t)(sad_interval_index >> 2);
-                                if (sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
-                                    uint16_t sad_interval_index_temp = sad_interval_index -
-                                        ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
-
-                                    sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) +
-                                        (sad_interval_index_temp >> 3);
-                                }
-                                if (sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
-                                    sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
-
-                                pcs_ptr->inter_sad_interval_index[sb_index] = sad_interval_index;
-
-                                pcs_ptr->me_distortion_histogram[sad_interval_index]++;
-                            }
-
-                            uint32_t intra_sad_interval_index =
-                                pcs_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
-                            intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >>
-                                2);
-                            if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
-                                uint32_t sad_interval_index_temp = intra_sad_interval_index -
+                        ++x_sb_index) {
+                    uint32_t sb_origin_x = x_sb_index * scs_ptr->sb_sz;
+                    uint32_t sb_origin_y = y_sb_index * scs_ptr->sb_sz;
+                    uint32_t sb_width = (pcs_ptr->aligned_width - sb_origin_x) <
+                        BLOCK_SIZE_64
+                        ? pcs_ptr->aligned_width - sb_origin_x
+                        : BLOCK_SIZE_64;
+                    uint32_t sb_height = (pcs_ptr->aligned_height - sb_origin_y) <
+                        BLOCK_SIZE_64
+                        ? pcs_ptr->aligned_height - sb_origin_y
+                        : BLOCK_SIZE_64;
+
+                    uint32_t sb_index = (uint16_t)(x_sb_index +
+                        y_sb_index * pic_width_in_sb);
+                    pcs_ptr->inter_sad_interval_index[sb_index] = 0;
+                    pcs_ptr->intra_sad_interval_index[sb_index] = 0;
+
+                    if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
+                        if (pcs_ptr->slice_type != I_SLICE && !scs_ptr->in_loop_me) {
+                            uint16_t sad_interval_index = (uint16_t)(
+                                pcs_ptr->rc_me_distortion[sb_index] >>
+                                (12 - SAD_PRECISION_INTERVAL)); //change 12 to 2*log2(64)
+
+                            sad_interval_index = (uint16_t)(sad_interval_index >> 2);
+                            if (sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
+                                uint16_t sad_interval_index_temp = sad_interval_index -
                                     ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
 
-                                intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) -
-                                    1) +
+                                sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) +
                                     (sad_interval_index_temp >> 3);
                             }
-                            if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
-                                intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
+                            if (sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
+                                sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
 
-                            pcs_ptr->intra_sad_interval_index[sb_index] =
-                                intra_sad_interval_index;
+                            pcs_ptr->inter_sad_interval_index[sb_index] = sad_interval_index;
 
-                            pcs_ptr->ois_distortion_histogram[intra_sad_interval_index]++;
+                            pcs_ptr->me_distortion_histogram[sad_interval_index]++;
+                        }
 
-                            ++pcs_ptr->full_sb_count;
+                        uint32_t intra_sad_interval_index =
+                            pcs_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
+                        intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >>
+                            2);
+                        if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
+                            uint32_t sad_interval_index_temp = intra_sad_interval_index -
+                                ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
+
+                            intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) -
+                                1) +
+                                (sad_interval_index_temp >> 3);
                         }
+                        if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
+                            intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
+
+                        pcs_ptr->intra_sad_interval_index[sb_index] =
+                            intra_sad_interval_index;
+
+                        pcs_ptr->ois_distortion_histogram[intra_sad_interval_index]++;
+
+                        ++pcs_ptr->full_sb_count;
                     }
                 }
-
-                svt_release_mutex(pcs_ptr->rc_distortion_histogram_mutex);
-            }
             }
+
+            svt_release_mutex(pcs_ptr->rc_distortion_histogram_mutex);
+        }
+        }
+        if (gm_task_count) {
+            // The results of the segment are posted by the last GM task
+            EbObjectWrapper *pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
+            pcs_ptr->gm_task_count           = gm_task_count;
+            pcs_ptr->gm_segment_index        = segment_index;
+            svt_atomic_store_u32(&pcs_ptr->gm_tasks_done, 0);
+
+            // Release the Input Results
+            svt_release_object(in_results_wrapper_ptr);
+
+            post_global_motion_tasks(context_ptr, pcs_wrapper_ptr, gm_ref_count);
+            return;
+        }
+        // Get Empty Results Object
+        svt_get_empty_object(context_ptr->motion_estimation_results_output_fifo_ptr,
+                            &out_results_wrapper_ptr);
+
+        MotionEstimationResults *out_results_ptr = (MotionEstimationResults *)
+                                                       out_results_wrapper_ptr->object_ptr;
+        out_results_ptr->pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
+        out_results_ptr->segment_index   = segment_index;
+
+        // Release the Input Results
+        svt_release_object(in_results_wrapper_ptr);
+
+        // Post the Full Results Object
+        svt_post_full_object(out_results_wrapper_ptr);
+    } else if (in_results_ptr->task_type == 3) {
+        // Global motion search of one reference
+        EbObjectWrapper *pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
+        global_motion_estimation_ref(pcs_ptr,
+                                     pcs_ptr->enhanced_unscaled_picture_ptr,
+                                     in_results_ptr->list_index,
+                                     in_results_ptr->ref_pic_index);
+
+        // Release the Input Results
+        svt_release_object(in_results_wrapper_ptr);
+
+        if (svt_atomic_add_u32(&pcs_ptr->gm_tasks_done, 1) == pcs_ptr->gm_task_count) {
+            global_motion_estimation_finish(pcs_ptr);
+
             // Get Empty Results Object
             svt_get_empty_object(context_ptr->motion_estimation_results_output_fifo_ptr,
-                                &out_results_wrapper_ptr);
+                                 &out_results_wrapper_ptr);
 
             MotionEstimationResults *out_results_ptr = (MotionEstimationResults *)
                                                            out_results_wrapper_ptr->object_ptr;
-            out_results_ptr->pcs_wrapper_ptr = in_results_ptr->pcs_wrapper_ptr;
-            out_results_ptr->segment_index   = segment_index;
-
-            // Release the Input Results
-            svt_release_object(in_results_wrapper_ptr);
+            out_results_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+            out_results_ptr->segment_index   = pcs_ptr->gm_segment_index;
 
             // Post the Full Results Object
             svt_post_full_object(out_results_wrapper_ptr);
-        } else if (in_results_ptr->task_type == 1) {
-            // ME Kernel Signal(s) derivation
-            tf_signal_derivation_me_kernel_oq(scs_ptr, pcs_ptr, context_ptr);
+        }
+    } else if (in_results_ptr->task_type == 1) {
+        // ME Kernel Signal(s) derivation
+        tf_signal_derivation_me_kernel_oq(scs_ptr, pcs_ptr, context_ptr);
 
-            // temporal filtering start
-            context_ptr->me_context_ptr->me_type = ME_MCTF;
-            svt_av1_init_temporal_filtering(
-                pcs_ptr->temp_filt_pcs_list, pcs_ptr, context_ptr, in_results_ptr->segment_index);
+        // temporal filtering start
+        context_ptr->me_context_ptr->me_type = ME_MCTF;
+        svt_av1_init_temporal_filtering(
+            pcs_ptr->temp_filt_pcs_list, pcs_ptr, context_ptr, in_results_ptr->segment_index);
 
-            // Release the Input Results
-            svt_release_object(in_results_wrapper_ptr);
-        }
-        else {
-            // ME Kernel Signal(s) derivation
-            first_pass_signal_derivation_me_kernel(scs_ptr, pcs_ptr, context_ptr);
+        // Release the Input Results
+        svt_release_object(in_results_wrapper_ptr);
+    }
+    else {
+        // ME Kernel Signal(s) derivation
+        first_pass_signal_derivation_me_kernel(scs_ptr, pcs_ptr, context_ptr);
 
-            // first pass start
-            context_ptr->me_context_ptr->me_type = ME_FIRST_PASS;
-            open_loop_first_pass(
-                pcs_ptr, context_ptr, in_results_ptr->segment_index);
+        // first pass start
+        context_ptr->me_context_ptr->me_type = ME_FIRST_PASS;
+        open_loop_first_pass(
+            pcs_ptr, context_ptr, in_results_ptr->segment_index);
 
-            // Release the Input Results
-            svt_release_object(in_results_wrapper_ptr);
-        }
+        // Release the Input Results
+        svt_release_object(in_results_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * Motion Estimation Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *motion_estimation_kernel(void *input_ptr) {
+    EbThreadContext *          thread_context_ptr = (EbThreadContext *)input_ptr;
+    MotionEstimationContext_t *context_ptr = (MotionEstimationContext_t *)thread_context_ptr->priv;
+    EbObjectWrapper *          in_results_wrapper_ptr;
+
+    for (;;) {
+        // Get Input Full Object
+        EB_GET_FULL_OBJECT(context_ptr->picture_decision_results_input_fifo_ptr,
+                           &in_results_wrapper_ptr);
+        motion_estimation_task(input_ptr, in_results_wrapper_ptr);
     }
 
     return NULL;
@@ -22,6 +22,7 @@
 typedef struct MotionEstimationContext {
     EbFifo *   picture_decision_results_input_fifo_ptr;
     EbFifo *   motion_estimation_results_output_fifo_ptr;
+    EbFifo *   picture_decision_results_output_fifo_ptr;
     MeContext *me_context_ptr;
 
     uint8_t *index_table0;
@@ -43,6 +44,7 @@ EbErrorType motion_estimation_context_ctor(EbThreadContext *  thread_context_ptr
                                            const EbEncHandle *enc_handle_ptr, int index);
 
 extern void *motion_estimation_kernel(void *input_ptr);
+extern void  motion_estimation_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
 
 EbErrorType ime_context_ctor(EbThreadContext *thread_context_ptr, const EbEncHandle *enc_handle_ptr,
                              int index);
@@ -10,6 +10,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbEncHandle.h"
 #include "EbPacketizationProcess.h"
@@ -32,6 +33,11 @@ typedef struct EbPPSConfig {
     uint8_t constrained_flag;
 } EbPPSConfig;
 
+typedef struct PacketizationBuffer {
+    uint8_t *data;
+    uint32_t size;
+} PacketizationBuffer;
+
 /**************************************
  * Context
  **************************************/
@@ -44,6 +50,14 @@ typedef struct PacketizationContext {
     uint64_t     dpb_disp_order[8], dpb_dec_order[8];
     uint64_t     tot_shown_frames;
     uint64_t     disp_order_continuity_count;
+    // Frame buffers of the write_packet output, reused instead of allocated per frame
+    PacketizationBuffer *free_buffer_array;
+    uint32_t             free_buffer_count;
+    uint32_t             free_buffer_max_count;
+    // Buffers and chunks of the temporal unit being written
+    PacketizationBuffer *tu_buffer_array;
+    const uint8_t **     chunk_array;
+    uint32_t *           chunk_size_array;
 } PacketizationContext;
 
 static EbBool is_passthrough_data(EbLinkedListNode *data_node) { return data_node->passthrough; }
@@ -62,6 +76,12 @@ static void packetization_context_dctor(EbPtr p) {
     EbThreadContext *     thread_context_ptr = (EbThreadContext *)p;
     PacketizationContext *obj                = (PacketizationContext *)thread_context_ptr->priv;
     EB_FREE_ARRAY(obj->pps_config);
+    for (uint32_t i = 0; i < obj->free_buffer_count; i++)
+        EB_FREE(obj->free_buffer_array[i].data);
+    EB_FREE_ARRAY(obj->free_buffer_array);
+    EB_FREE_ARRAY(obj->tu_buffer_array);
+    EB_FREE_ARRAY(obj->chunk_array);
+    EB_FREE_ARRAY(obj->chunk_size_array);
     EB_FREE_ARRAY(obj);
 }
 
@@ -82,8 +102,28 @@ EbErrorType packetization_context_ctor(EbThreadContext *  thread_context_ptr,
         enc_handle_ptr->picture_demux_results_resource_ptr, demux_index);
     EB_MALLOC_ARRAY(context_ptr->pps_config, 1);
 
+    const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    if (scs_ptr->static_config.write_packet) {
+        // Every output buffer header may hold a frame, plus one for a show existing frame
+        context_ptr->free_buffer_max_count = scs_ptr->output_stream_buffer_fifo_init_count + 1;
+        EB_CALLOC_ARRAY(context_ptr->free_buffer_array, context_ptr->free_buffer_max_count);
+        EB_MALLOC_ARRAY(context_ptr->tu_buffer_array, PACKETIZATION_REORDER_QUEUE_MAX_DEPTH);
+        EB_MALLOC_ARRAY(context_ptr->chunk_array, PACKETIZATION_REORDER_QUEUE_MAX_DEPTH);
+        EB_MALLOC_ARRAY(context_ptr->chunk_size_array, PACKETIZATION_REORDER_QUEUE_MAX_DEPTH);
+    }
+
     return EB_ErrorNone;
 }
+
+/* Clears the display order tracking for a new stream */
+void packetization_context_reset(EbThreadContext *thread_context_ptr) {
+    PacketizationContext *context_ptr = (PacketizationContext *)thread_context_ptr->priv;
+
+    memset(context_ptr->dpb_disp_order, 0, sizeof(context_ptr->dpb_disp_order));
+    memset(context_ptr->dpb_dec_order, 0, sizeof(context_ptr->dpb_dec_order));
+    context_ptr->tot_shown_frames            = 0;
+    context_ptr->disp_order_continuity_count = 0;
+}
 void update_rc_rate_tables(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
     Dequants *const dequants = pcs_ptr->hbd_mode_decision ?
         &scs_ptr->deq_bd :
@@ -143,8 +183,8 @@ void update_rc_rate_tables(PictureControlSet *pcs_ptr, SequenceControlSet *scs_p
                         sad_bits[sad_interval_index] /= count[sad_interval_index];
                         sad_bits_ref_dequant =
                             sad_bits[sad_interval_index] * ref_qindex_dequant;
-                        for (qp_index = scs_ptr->static_config.min_qp_allowed;
-                                qp_index <= (int32_t)scs_ptr->static_config.max_qp_allowed;
+                        for (qp_index = pcs_ptr->parent_pcs_ptr->min_qp_allowed;
+                                qp_index <= (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed;
                                 qp_index++) {
                             encode_context_ptr->rate_control_tables_array[qp_index]
                                 .intra_sad_bits_array[pcs_ptr->temporal_layer_index]
@@ -185,8 +225,8 @@ void update_rc_rate_tables(PictureControlSet *pcs_ptr, SequenceControlSet *scs_p
                         sad_bits[sad_interval_index] /= count[sad_interval_index];
                         sad_bits_ref_dequant =
                             sad_bits[sad_interval_index] * ref_qindex_dequant;
-                        for (qp_index = scs_ptr->static_config.min_qp_allowed;
-                                qp_index <= (int32_t)scs_ptr->static_config.max_qp_allowed;
+                        for (qp_index = pcs_ptr->parent_pcs_ptr->min_qp_allowed;
+                                qp_index <= (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed;
                                 qp_index++) {
                             encode_context_ptr->rate_control_tables_array[qp_index]
                                 .intra_sad_bits_array[pcs_ptr->temporal_layer_index]
@@ -228,8 +268,8 @@ void update_rc_rate_tables(PictureControlSet *pcs_ptr, SequenceControlSet *scs_p
                         sad_bits[sad_interval_index] /= count[sad_interval_index];
                         sad_bits_ref_dequant =
                             sad_bits[sad_interval_index] * ref_qindex_dequant;
-                        for (qp_index = scs_ptr->static_config.min_qp_allowed;
-                                qp_index <= (int32_t)scs_ptr->static_config.max_qp_allowed;
+                        for (qp_index = pcs_ptr->parent_pcs_ptr->min_qp_allowed;
+                                qp_index <= (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed;
                                 qp_index++) {
                             encode_context_ptr->rate_control_tables_array[qp_index]
                                 .sad_bits_array[pcs_ptr->temporal_layer_index]
@@ -268,8 +308,8 @@ void update_rc_rate_tables(PictureControlSet *pcs_ptr, SequenceControlSet *scs_p
                         sad_bits[sad_interval_index] /= count[sad_interval_index];
                         sad_bits_ref_dequant =
                             sad_bits[sad_interval_index] * ref_qindex_dequant;
-                        for (qp_index = scs_ptr->static_config.min_qp_allowed;
-                                qp_index <= (int32_t)scs_ptr->static_config.max_qp_allowed;
+                        for (qp_index = pcs_ptr->parent_pcs_ptr->min_qp_allowed;
+                                qp_index <= (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed;
                                 qp_index++) {
                             encode_context_ptr->rate_control_tables_array[qp_index]
                                 .sad_bits_array[pcs_ptr->temporal_layer_index]
@@ -528,13 +568,15 @@ static EbErrorType encode_tu(EncodeContext *encode_context_ptr, int frames, uint
     }
     uint8_t *dst                    = output_stream_ptr->p_buffer + total_bytes;
     //we use last frame's output_stream_ptr to hold entire tu, so we need copy backward.
+    //a single frame tu is already in place, behind the room left for the td.
     for (int i = frames - 1; i >= 0; i--) {
         PacketizationReorderEntry *queue_entry_ptr = get_reorder_queue_entry(encode_context_ptr, i);
         EbObjectWrapper* wrapper = queue_entry_ptr->output_stream_wrapper_ptr;
         EbBufferHeaderType *       src_stream_ptr = (EbBufferHeaderType *)wrapper->object_ptr;
         uint32_t size = src_stream_ptr->n_filled_len;
         dst -= size;
-        memmove(dst, src_stream_ptr->p_buffer, size);
+        if (dst != src_stream_ptr->p_buffer + TD_SIZE)
+            memmove(dst, src_stream_ptr->p_buffer + TD_SIZE, size);
         //1. The last frame is a displayable frame, others are undisplayed.
         //2. We do not push alt ref frame since the overlay frame will carry the pts.
         if (i != frames - 1 && !queue_entry_ptr->is_alt_ref)
@@ -549,6 +591,87 @@ static EbErrorType encode_tu(EncodeContext *encode_context_ptr, int frames, uint
     return EB_ErrorNone;
 }
 
+/* Takes a frame buffer of at least size bytes from the write_packet pool */
+static EbErrorType get_frame_buffer(PacketizationContext *context_ptr, uint32_t size,
+                                    PacketizationBuffer *buffer) {
+    if (context_ptr->free_buffer_count)
+        *buffer = context_ptr->free_buffer_array[--context_ptr->free_buffer_count];
+    else {
+        buffer->data = NULL;
+        buffer->size = 0;
+    }
+    if (buffer->size < size) {
+        // The buffers only grow, the pool settles at the largest frames
+        EB_FREE(buffer->data);
+        buffer->size = 0;
+        EB_MALLOC(buffer->data, size);
+        buffer->size = size;
+    }
+    return EB_ErrorNone;
+}
+
+static void put_frame_buffer(PacketizationContext *context_ptr, PacketizationBuffer *buffer) {
+    if (context_ptr->free_buffer_count < context_ptr->free_buffer_max_count)
+        context_ptr->free_buffer_array[context_ptr->free_buffer_count++] = *buffer;
+    else
+        EB_FREE(buffer->data);
+}
+
+/* write_packet output of a tu: the frames are handed to the callback where they are,
+ * the td goes into the room left before the first frame */
+static void write_tu(PacketizationContext *context_ptr, EncodeContext *encode_context_ptr,
+                     const EbSvtAv1EncConfiguration *config, int frames, uint32_t total_bytes,
+                     EbBufferHeaderType *output_stream_ptr) {
+    for (int i = 0; i < frames; i++) {
+        PacketizationReorderEntry *queue_entry_ptr = get_reorder_queue_entry(encode_context_ptr, i);
+        EbObjectWrapper *          wrapper = queue_entry_ptr->output_stream_wrapper_ptr;
+        EbBufferHeaderType *       src_stream_ptr = (EbBufferHeaderType *)wrapper->object_ptr;
+        PacketizationBuffer *      buffer         = &context_ptr->tu_buffer_array[i];
+        buffer->data                              = src_stream_ptr->p_buffer;
+        buffer->size                              = src_stream_ptr->n_alloc_len;
+        context_ptr->chunk_array[i]      = i ? buffer->data + TD_SIZE : buffer->data;
+        context_ptr->chunk_size_array[i] = src_stream_ptr->n_filled_len + (i ? 0 : TD_SIZE);
+        src_stream_ptr->p_buffer         = NULL;
+        src_stream_ptr->n_alloc_len      = 0;
+        if (i != frames - 1 && !queue_entry_ptr->is_alt_ref)
+            push_undisplayed_frame(encode_context_ptr, wrapper);
+    }
+    if (frames > 1)
+        sort_undisplayed_frame(encode_context_ptr);
+    encode_td_av1(context_ptr->tu_buffer_array[0].data);
+    output_stream_ptr->n_filled_len = total_bytes + TD_SIZE;
+    output_stream_ptr->flags |= EB_BUFFERFLAG_HAS_TD;
+
+    config->write_packet(config->write_packet_priv,
+                         output_stream_ptr,
+                         context_ptr->chunk_array,
+                         context_ptr->chunk_size_array,
+                         frames);
+    for (int i = 0; i < frames; i++)
+        put_frame_buffer(context_ptr, &context_ptr->tu_buffer_array[i]);
+}
+
+static EbErrorType write_show_existing(PacketizationContext *          context_ptr,
+                                       const EbSvtAv1EncConfiguration *config,
+                                       PacketizationReorderEntry *     queue_entry_ptr,
+                                       EbBufferHeaderType *            output_stream_ptr) {
+    const uint32_t      size = bitstream_get_bytes_count(queue_entry_ptr->bitstream_ptr);
+    PacketizationBuffer buffer;
+    EbErrorType return_error = get_frame_buffer(context_ptr, TD_SIZE + size, &buffer);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    encode_td_av1(buffer.data);
+    bitstream_copy(queue_entry_ptr->bitstream_ptr, buffer.data + TD_SIZE, size);
+    output_stream_ptr->n_filled_len = TD_SIZE + size;
+    output_stream_ptr->flags |= (EB_BUFFERFLAG_SHOW_EXT | EB_BUFFERFLAG_HAS_TD);
+
+    const uint8_t *chunk = buffer.data;
+    config->write_packet(
+        config->write_packet_priv, output_stream_ptr, &chunk, &output_stream_ptr->n_filled_len, 1);
+    put_frame_buffer(context_ptr, &buffer);
+    return EB_ErrorNone;
+}
+
 static EbErrorType copy_data_from_bitstream(EncodeContext *encode_context_ptr, Bitstream *bitstream_ptr, EbBufferHeaderType *output_stream_ptr) {
     EbErrorType          return_error = EB_ErrorNone;
     int size = bitstream_get_bytes_count(bitstream_ptr);
@@ -617,9 +740,6 @@ void *packetization_kernel(void *input_ptr) {
     EbObjectWrapper *    rate_control_tasks_wrapper_ptr;
     EbObjectWrapper *    picture_manager_results_wrapper_ptr;
 
-    context_ptr->tot_shown_frames            = 0;
-    context_ptr->disp_order_continuity_count = 0;
-
     for (;;) {
         // Get EntropyCoding Results
         EB_GET_FULL_OBJECT(context_ptr->entropy_coding_input_fifo_ptr,
@@ -671,6 +791,8 @@ void *packetization_kernel(void *input_ptr) {
         output_stream_ptr->qp            = pcs_ptr->parent_pcs_ptr->picture_qp;
 
         if (scs_ptr->static_config.stat_report) {
+            // Wait for the bands of the quality metrics stage
+            svt_block_on_semaphore(pcs_ptr->metrics_done_semaphore);
             output_stream_ptr->luma_sse = pcs_ptr->parent_pcs_ptr->luma_sse;
             output_stream_ptr->cr_sse   = pcs_ptr->parent_pcs_ptr->cr_sse;
             output_stream_ptr->cb_sse   = pcs_ptr->parent_pcs_ptr->cb_sse;
@@ -730,14 +852,22 @@ void *packetization_kernel(void *input_ptr) {
 
         write_frame_header_av1(pcs_ptr->bitstream_ptr, scs_ptr, pcs_ptr, 0);
 
-        output_stream_ptr->n_alloc_len = bitstream_get_bytes_count(pcs_ptr->bitstream_ptr) + TD_SIZE;
-        malloc_p_buffer(output_stream_ptr);
+        const uint32_t frame_size = bitstream_get_bytes_count(pcs_ptr->bitstream_ptr);
+        if (scs_ptr->static_config.write_packet) {
+            PacketizationBuffer buffer;
+            get_frame_buffer(context_ptr, frame_size + TD_SIZE, &buffer);
+            output_stream_ptr->p_buffer    = buffer.data;
+            output_stream_ptr->n_alloc_len = buffer.size;
+        } else {
+            output_stream_ptr->n_alloc_len = frame_size + TD_SIZE;
+            malloc_p_buffer(output_stream_ptr);
+        }
 
         assert(output_stream_ptr->p_buffer != NULL && "bit-stream memory allocation failure");
 
-        copy_data_from_bitstream(encode_context_ptr,
-                    pcs_ptr->bitstream_ptr,
-                    output_stream_ptr);
+        // Leave room for the td ahead of the frame, so a single frame tu is not moved
+        bitstream_copy(pcs_ptr->bitstream_ptr, output_stream_ptr->p_buffer + TD_SIZE, frame_size);
+        output_stream_ptr->n_filled_len = frame_size;
 
         if (pcs_ptr->parent_pcs_ptr->has_show_existing) {
             // Reset the Bitstream before writing to it
@@ -828,20 +958,30 @@ void *packetization_kernel(void *input_ptr) {
             output_stream_wrapper_ptr = queue_entry_ptr->output_stream_wrapper_ptr;
             output_stream_ptr         = (EbBufferHeaderType *)output_stream_wrapper_ptr->object_ptr;
             EbBool eos                = output_stream_ptr->flags &  EB_BUFFERFLAG_EOS;
-
-            encode_tu(encode_context_ptr, frames, total_bytes, output_stream_ptr);
+            const EbSvtAv1EncConfiguration *config = &scs_ptr->static_config;
 
             if (eos && queue_entry_ptr->has_show_existing)
                 clear_eos_flag(output_stream_ptr);
 
+            if (config->write_packet)
+                write_tu(context_ptr, encode_context_ptr, config, frames, total_bytes,
+                         output_stream_ptr);
+            else
+                encode_tu(encode_context_ptr, frames, total_bytes, output_stream_ptr);
+
             svt_post_full_object(output_stream_wrapper_ptr);
             if (queue_entry_ptr->has_show_existing) {
                 EbObjectWrapper *existed = pop_undisplayed_frame(encode_context_ptr);
                 if (existed) {
                     EbBufferHeaderType *existed_output_stream_ptr = (EbBufferHeaderType *)existed->object_ptr;
-                    encode_show_existing(encode_context_ptr, queue_entry_ptr, existed_output_stream_ptr);
                     if (eos)
                         set_eos_flag(existed_output_stream_ptr);
+                    if (config->write_packet)
+                        write_show_existing(
+                            context_ptr, config, queue_entry_ptr, existed_output_stream_ptr);
+                    else
+                        encode_show_existing(
+                            encode_context_ptr, queue_entry_ptr, existed_output_stream_ptr);
                     svt_post_full_object(existed);
                 }
             }
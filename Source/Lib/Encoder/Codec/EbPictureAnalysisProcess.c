@@ -91,6 +91,7 @@ EbErrorType picture_analysis_context_ctor(EbThreadContext *  thread_context_ptr,
         desc.max_width          = scs_ptr->max_input_luma_width;
         desc.max_height         = scs_ptr->max_input_luma_height;
         desc.bit_depth          = EB_8BIT;
+        desc.alloc_policy       = scs_ptr->large_alloc_policy;
 
         //denoised
         // If 420/422, re-use luma for chroma
@@ -3951,6 +3952,7 @@ void *picture_analysis_kernel(void *input_ptr) {
                 pa_ref_obj_->input_padded_picture_ptr = input_picture_ptr;
                 pa_ref_obj_->quarter_decimated_picture_ptr = pa_ref_obj_->quarter_filtered_picture_ptr = ds_obj->quarter_picture_ptr;
                 pa_ref_obj_->sixteenth_decimated_picture_ptr = pa_ref_obj_->sixteenth_filtered_picture_ptr = ds_obj->sixteenth_picture_ptr;
+                pa_ref_obj_->gm_corners_buffer = NULL;
 
             } else {
                 if (scs_ptr->in_loop_me == 0){
@@ -3965,6 +3967,7 @@ void *picture_analysis_kernel(void *input_ptr) {
                 pa_ref_obj_ =
                     (EbPaReferenceObject *)pcs_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
                 pa_ref_obj_->picture_number = pcs_ptr->picture_number;
+                pa_ref_obj_->gm_corners_buffer = NULL;
                 input_padded_picture_ptr = (EbPictureBufferDesc *)pa_ref_obj_->input_padded_picture_ptr;
                 uint8_t *pa =
                     input_padded_picture_ptr->buffer_y + input_padded_picture_ptr->origin_x +
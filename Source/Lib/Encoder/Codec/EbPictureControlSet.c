@@ -175,6 +175,8 @@ void picture_control_set_dctor(EbPtr p) {
 
     EB_FREE_ARRAY(obj->mse_seg[0]);
     EB_FREE_ARRAY(obj->mse_seg[1]);
+    EB_FREE_ARRAY(obj->cdef_dir);
+    EB_FREE_ARRAY(obj->cdef_var);
 
     EB_FREE_ARRAY(obj->mi_grid_base);
     EB_FREE_ARRAY(obj->mip);
@@ -183,7 +185,20 @@ void picture_control_set_dctor(EbPtr p) {
     EB_DESTROY_MUTEX(obj->entropy_coding_pic_mutex);
     EB_DESTROY_MUTEX(obj->intra_mutex);
     EB_DESTROY_MUTEX(obj->cdef_search_mutex);
+    EB_DESTROY_MUTEX(obj->dlf_mutex);
+    EB_DESTROY_SEMAPHORE(obj->dlf_init_done_semaphore);
+    if (obj->dlf_sb_row_semaphore) {
+        for (uint16_t sb_row = 0; sb_row < obj->dlf_sb_row_count; sb_row++)
+            EB_DESTROY_SEMAPHORE(obj->dlf_sb_row_semaphore[sb_row]);
+        EB_FREE_ARRAY(obj->dlf_sb_row_semaphore);
+    }
     EB_DESTROY_MUTEX(obj->rest_search_mutex);
+    EB_DESTROY_SEMAPHORE(obj->rest_search_done_semaphore);
+    EB_DESTROY_MUTEX(obj->metrics_mutex);
+    EB_DESTROY_SEMAPHORE(obj->metrics_done_semaphore);
+    EB_FREE_ARRAY(obj->metrics_ssim[0]);
+    EB_FREE_ARRAY(obj->metrics_ssim[1]);
+    EB_FREE_ARRAY(obj->metrics_ssim[2]);
 }
 // Token buffer is only used for palette tokens.
 static INLINE unsigned int get_token_alloc(int mb_rows, int mb_cols, int sb_size_log2,
@@ -284,7 +299,8 @@ EbErrorType picture_control_set_ctor(PictureControlSet *object_ptr, EbPtr object
     input_pic_buf_desc_init_data.top_padding   = PAD_VALUE;
     input_pic_buf_desc_init_data.bot_padding   = PAD_VALUE;
 
-    input_pic_buf_desc_init_data.split_mode = EB_FALSE;
+    input_pic_buf_desc_init_data.split_mode   = EB_FALSE;
+    input_pic_buf_desc_init_data.alloc_policy = init_data_ptr->alloc_policy;
 
     coeff_buffer_desc_init_data.max_width          = init_data_ptr->picture_width;
     coeff_buffer_desc_init_data.max_height         = init_data_ptr->picture_height;
@@ -299,6 +315,7 @@ EbErrorType picture_control_set_ctor(PictureControlSet *object_ptr, EbPtr object
 
     coeff_buffer_desc_init_data.split_mode        = EB_FALSE;
     coeff_buffer_desc_init_data.is_16bit_pipeline = init_data_ptr->is_16bit_pipeline;
+    coeff_buffer_desc_init_data.alloc_policy      = init_data_ptr->alloc_policy;
 
     object_ptr->scs_wrapper_ptr = (EbObjectWrapper *)NULL;
 
@@ -1016,13 +1033,41 @@ EbErrorType picture_control_set_ctor(PictureControlSet *object_ptr, EbPtr object
 
     EB_CREATE_MUTEX(object_ptr->cdef_search_mutex);
 
+    EB_CREATE_MUTEX(object_ptr->dlf_mutex);
+    EB_CREATE_SEMAPHORE(object_ptr->dlf_init_done_semaphore, 0, picture_sb_height);
+    EB_CALLOC_ARRAY(object_ptr->dlf_sb_row_semaphore, picture_sb_height);
+    object_ptr->dlf_sb_row_count = picture_sb_height;
+    for (uint16_t sb_row = 0; sb_row < picture_sb_height; sb_row++)
+        EB_CREATE_SEMAPHORE(object_ptr->dlf_sb_row_semaphore[sb_row], 0, picture_sb_width);
+
     //object_ptr->mse_seg[0] = (uint64_t(*)[64])svt_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
     // object_ptr->mse_seg[1] = (uint64_t(*)[64])svt_aom_malloc(sizeof(**object_ptr->mse_seg) *  picture_sb_width * picture_sb_height);
 
     EB_MALLOC_ARRAY(object_ptr->mse_seg[0], picture_sb_width * picture_sb_height);
     EB_MALLOC_ARRAY(object_ptr->mse_seg[1], picture_sb_width * picture_sb_height);
+    object_ptr->cdef_dir_stride = (uint16_t)(((init_data_ptr->picture_width + 63) >> 6) << 3);
+    object_ptr->cdef_dir_rows   = (uint16_t)(((init_data_ptr->picture_height + 63) >> 6) << 3);
+    EB_MALLOC_ARRAY(object_ptr->cdef_dir, object_ptr->cdef_dir_stride * object_ptr->cdef_dir_rows);
+    EB_MALLOC_ARRAY(object_ptr->cdef_var, object_ptr->cdef_dir_stride * object_ptr->cdef_dir_rows);
 
     EB_CREATE_MUTEX(object_ptr->rest_search_mutex);
+    EB_CREATE_SEMAPHORE(object_ptr->rest_search_done_semaphore,
+                        0,
+                        (init_data_ptr->picture_height + RESTORATION_UNIT_OFFSET +
+                         RESTORATION_PROC_UNIT_SIZE - 1) /
+                            RESTORATION_PROC_UNIT_SIZE);
+    EB_CREATE_MUTEX(object_ptr->metrics_mutex);
+    EB_CREATE_SEMAPHORE(object_ptr->metrics_done_semaphore, 0, 1);
+    if (init_data_ptr->stat_report) {
+        // one SSIM per 8x8 window on the 4x4 grid
+        for (int plane = 0; plane < 3; plane++) {
+            const uint32_t ss_x = plane ? subsampling_x : 0;
+            const uint32_t ss_y = plane ? subsampling_y : 0;
+            EB_MALLOC_ARRAY(object_ptr->metrics_ssim[plane],
+                            (((init_data_ptr->picture_width + ss_x) >> ss_x) / 4 + 1) *
+                                (((init_data_ptr->picture_height + ss_y) >> ss_y) / 4 + 1));
+        }
+    }
 
     //the granularity is 4x4
     EB_MALLOC_ARRAY(object_ptr->mi_grid_base,
@@ -1109,6 +1154,11 @@ static void picture_parent_control_set_dctor(EbPtr ptr) {
         EB_FREE_2D(obj->tpl_stats);
     if (obj->tpl_beta)
         EB_FREE_ARRAY(obj->tpl_beta);
+    if (obj->tpl_sb_row_semaphore) {
+        for (uint16_t sb_row = 0; sb_row < obj->tpl_sb_row_count; sb_row++)
+            EB_DESTROY_SEMAPHORE(obj->tpl_sb_row_semaphore[sb_row]);
+        EB_FREE_ARRAY(obj->tpl_sb_row_semaphore);
+    }
     if (obj->tpl_rdmult_scaling_factors)
         EB_FREE_ARRAY(obj->tpl_rdmult_scaling_factors);
     if (obj->tpl_sb_rdmult_scaling_factors)
@@ -1196,6 +1246,7 @@ EbErrorType picture_parent_control_set_ctor(PictureParentControlSet *object_ptr,
         input_pic_buf_desc_init_data.bot_padding        = init_data_ptr->bot_padding;
         input_pic_buf_desc_init_data.color_format       = EB_YUV420; //set to 420 for MD
         input_pic_buf_desc_init_data.split_mode         = EB_FALSE;
+        input_pic_buf_desc_init_data.alloc_policy       = init_data_ptr->alloc_policy;
         EB_NEW(object_ptr->chroma_downsampled_picture_ptr,
                svt_picture_buffer_desc_ctor,
                (EbPtr)&input_pic_buf_desc_init_data);
@@ -1262,6 +1313,10 @@ EbErrorType picture_parent_control_set_ctor(PictureParentControlSet *object_ptr,
                                 (picture_height_in_mb << (1 - object_ptr->is_720p_or_larger))),
                      1);
         EB_MALLOC_ARRAY(object_ptr->tpl_beta, object_ptr->sb_total_count);
+        EB_CALLOC_ARRAY(object_ptr->tpl_sb_row_semaphore, picture_sb_height);
+        object_ptr->tpl_sb_row_count = picture_sb_height;
+        for (uint16_t sb_row = 0; sb_row < picture_sb_height; sb_row++)
+            EB_CREATE_SEMAPHORE(object_ptr->tpl_sb_row_semaphore[sb_row], 0, picture_sb_width);
         EB_MALLOC_ARRAY(object_ptr->tpl_rdmult_scaling_factors,
                         picture_width_in_mb * picture_height_in_mb);
         EB_MALLOC_ARRAY(object_ptr->tpl_sb_rdmult_scaling_factors,
@@ -1272,6 +1327,7 @@ EbErrorType picture_parent_control_set_ctor(PictureParentControlSet *object_ptr,
         object_ptr->ois_mb_results                = NULL;
         object_ptr->tpl_stats                     = NULL;
         object_ptr->tpl_beta                      = NULL;
+        object_ptr->tpl_sb_row_semaphore          = NULL;
         object_ptr->tpl_rdmult_scaling_factors    = NULL;
         object_ptr->tpl_sb_rdmult_scaling_factors = NULL;
     }
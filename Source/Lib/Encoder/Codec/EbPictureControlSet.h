@@ -279,11 +279,27 @@ typedef struct PictureControlSet {
     uint32_t          tot_seg_searched_cdef;
     EbHandle          cdef_search_mutex;
 
+    // DLF SB rows
+    EbHandle          dlf_mutex;
+    EbHandle          dlf_init_done_semaphore;
+    EbBool            dlf_init_started;
+    EbBool            dlf_init_done;
+    uint32_t          dlf_init_wait_count;
+    uint32_t          tot_sb_rows_dlf;
+    EbHandle *        dlf_sb_row_semaphore; // posted for each SB deblocked in the row
+    uint16_t          dlf_sb_row_count;
+
     uint16_t cdef_segments_total_count;
     uint8_t  cdef_segments_column_count;
     uint8_t  cdef_segments_row_count;
 
     uint64_t (*mse_seg[2])[TOTAL_STRENGTHS];
+    // Luma CDEF direction and variance of each 8x8 block, kept by the search for the
+    // application; a negative direction is not known yet
+    int8_t *  cdef_dir;
+    int32_t * cdef_var;
+    uint16_t  cdef_dir_stride;
+    uint16_t  cdef_dir_rows;
 
     uint16_t *src[3]; //dlfed recon in 16bit form
     uint16_t *ref_coeff[3]; //input video in 16bit form
@@ -294,6 +310,22 @@ typedef struct PictureControlSet {
     uint8_t  rest_segments_column_count;
     uint8_t  rest_segments_row_count;
 
+    // LR application bands
+    EbHandle rest_search_done_semaphore;
+    EbBool   rest_search_done;
+    uint32_t rest_search_wait_count;
+    uint16_t rest_bands_total_count;
+    uint16_t tot_bands_filtered_rest;
+
+    // Quality metrics bands (stat_report)
+    EbHandle metrics_mutex;
+    EbHandle metrics_done_semaphore;
+    uint16_t metrics_bands_total_count;
+    uint16_t tot_bands_metrics;
+    uint64_t metrics_sse[3];
+    uint32_t metrics_ssim_count[3];
+    double * metrics_ssim[3]; // per SSIM window in raster order, added up at the end
+
     // Slice Type
     EB_SLICE slice_type;
 
@@ -586,6 +618,8 @@ typedef struct PictureParentControlSet {
     EbBool   percentage_updated;
     uint32_t target_bit_rate;
     uint32_t vbv_bufsize;
+    uint32_t max_qp_allowed;
+    uint32_t min_qp_allowed;
     uint32_t frame_rate;
     uint16_t sb_total_count;
     EbBool   end_of_sequence_region;
@@ -657,6 +691,11 @@ typedef struct PictureParentControlSet {
     // Global motion estimation results
     EbBool               is_global_motion[MAX_NUM_OF_REF_PIC_LIST][REF_LIST_MAX_DEPTH];
     EbWarpedMotionParams global_motion_estimation[MAX_NUM_OF_REF_PIC_LIST][REF_LIST_MAX_DEPTH];
+    // References searched by GM tasks, the last one to finish posts the ME
+    // results of segment gm_segment_index
+    uint32_t gm_task_count;
+    uint32_t gm_tasks_done;
+    uint32_t gm_segment_index;
 
     // Motion Estimation Distortion and OIS Historgram
     uint16_t *            me_distortion_histogram;
@@ -839,6 +878,11 @@ typedef struct PictureParentControlSet {
     EbHandle     pame_done_semaphore;
     uint8_t      num_tpl_grps;
     uint8_t      num_tpl_processed;
+    // TPL rows of the picture, run in parallel on the TPL stage
+    EbHandle *        tpl_sb_row_semaphore; // posted for each SB dispensed in the row
+    uint16_t          tpl_sb_row_count;
+    volatile uint32_t tpl_rows_done;
+    volatile uint32_t tpl_frame_done;
     int16_t      tf_segments_total_count;
     uint8_t      tf_segments_column_count;
     uint8_t      tf_segments_row_count;
@@ -953,6 +997,9 @@ typedef struct PictureControlSetInitData {
     uint16_t non_m8_pad_h;
     uint8_t  enable_tpl_la;
     uint8_t  in_loop_ois;
+    uint8_t  stat_report;
+    // Large allocation policy of the encoder, for the frame size buffers
+    EbLargeAllocPolicy alloc_policy;
 
 } PictureControlSetInitData;
 
@@ -242,8 +242,6 @@ EbErrorType picture_decision_context_ctor(
     EbThreadContext     *thread_context_ptr,
     const EbEncHandle   *enc_handle_ptr)
 {
-    uint32_t arr_row, arr_col;
-
     PictureDecisionContext *context_ptr;
     EB_CALLOC_ARRAY(context_ptr, 1);
     thread_context_ptr->priv = context_ptr;
@@ -258,6 +256,38 @@ EbErrorType picture_decision_context_ctor(
     EB_MALLOC_2D(context_ptr->ahd_running_avg_cr, MAX_NUMBER_OF_REGIONS_IN_WIDTH, MAX_NUMBER_OF_REGIONS_IN_HEIGHT);
     EB_MALLOC_2D(context_ptr->ahd_running_avg, MAX_NUMBER_OF_REGIONS_IN_WIDTH, MAX_NUMBER_OF_REGIONS_IN_HEIGHT);
 
+    context_ptr->me_fifo_ptr = svt_system_resource_get_producer_fifo(
+            enc_handle_ptr->me_pool_ptr_array[0], 0);
+
+    picture_decision_context_reset(thread_context_ptr);
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Picture Decision Context Reset
+ *   Clears the mini GOP and scene state for a new stream,
+ *   the fifos and buffers of the context are kept
+ ************************************************/
+void picture_decision_context_reset(EbThreadContext *thread_context_ptr)
+{
+    uint32_t arr_row, arr_col;
+
+    PictureDecisionContext *context_ptr = (PictureDecisionContext*)thread_context_ptr->priv;
+    EbFifo   *input_fifo_ptr = context_ptr->picture_analysis_results_input_fifo_ptr;
+    EbFifo   *output_fifo_ptr = context_ptr->picture_decision_results_output_fifo_ptr;
+    EbFifo   *me_fifo_ptr = context_ptr->me_fifo_ptr;
+    uint32_t **ahd_running_avg_cb = context_ptr->ahd_running_avg_cb;
+    uint32_t **ahd_running_avg_cr = context_ptr->ahd_running_avg_cr;
+    uint32_t **ahd_running_avg = context_ptr->ahd_running_avg;
+
+    memset(context_ptr, 0, sizeof(*context_ptr));
+    context_ptr->picture_analysis_results_input_fifo_ptr = input_fifo_ptr;
+    context_ptr->picture_decision_results_output_fifo_ptr = output_fifo_ptr;
+    context_ptr->me_fifo_ptr = me_fifo_ptr;
+    context_ptr->ahd_running_avg_cb = ahd_running_avg_cb;
+    context_ptr->ahd_running_avg_cr = ahd_running_avg_cr;
+    context_ptr->ahd_running_avg = ahd_running_avg;
+
     for (arr_row = 0; arr_row < MAX_NUMBER_OF_REGIONS_IN_HEIGHT; arr_row++)
     {
         for (arr_col = 0; arr_col < MAX_NUMBER_OF_REGIONS_IN_WIDTH; arr_col++) {
@@ -268,9 +298,6 @@ EbErrorType picture_decision_context_ctor(
     }
 
     context_ptr->reset_running_avg = EB_TRUE;
-    context_ptr->me_fifo_ptr = svt_system_resource_get_producer_fifo(
-            enc_handle_ptr->me_pool_ptr_array[0], 0);
-    return EB_ErrorNone;
 }
 
 static EbBool scene_transition_detector(
@@ -3691,6 +3718,9 @@ void initialize_overlay_frame(PictureParentControlSet     *pcs_ptr) {
     pcs_ptr->cra_flag = EB_FALSE;
     pcs_ptr->idr_flag = EB_FALSE;
     pcs_ptr->target_bit_rate = pcs_ptr->alt_ref_ppcs_ptr->target_bit_rate;
+    pcs_ptr->vbv_bufsize = pcs_ptr->alt_ref_ppcs_ptr->vbv_bufsize;
+    pcs_ptr->max_qp_allowed = pcs_ptr->alt_ref_ppcs_ptr->max_qp_allowed;
+    pcs_ptr->min_qp_allowed = pcs_ptr->alt_ref_ppcs_ptr->min_qp_allowed;
     pcs_ptr->last_idr_picture = pcs_ptr->alt_ref_ppcs_ptr->last_idr_picture;
     pcs_ptr->pred_structure = pcs_ptr->alt_ref_ppcs_ptr->pred_structure;
     pcs_ptr->pred_struct_ptr = pcs_ptr->alt_ref_ppcs_ptr->pred_struct_ptr;
@@ -3702,6 +3732,28 @@ void initialize_overlay_frame(PictureParentControlSet     *pcs_ptr) {
     perform_simple_picture_analysis_for_overlay(pcs_ptr);
  }
 
+/***************************************************************************************************
+ * Set the rate control targets of the mini-GOP starting with picture_number: the configured
+ * ones at the start of the stream, then the last ones given to svt_av1_enc_update_rate_control()
+***************************************************************************************************/
+static void update_rc_targets(SequenceControlSet *scs_ptr, EncodeContext *encode_context_ptr,
+                              uint64_t picture_number) {
+    SvtAv1RateControlTargets *targets = &encode_context_ptr->rc_targets;
+    if (picture_number == 0) {
+        targets->target_bit_rate = scs_ptr->static_config.target_bit_rate;
+        targets->vbv_bufsize = scs_ptr->static_config.vbv_bufsize;
+        targets->max_qp_allowed = scs_ptr->static_config.max_qp_allowed;
+        targets->min_qp_allowed = scs_ptr->static_config.min_qp_allowed;
+    }
+    svt_block_on_mutex(encode_context_ptr->rc_targets_mutex);
+    if (encode_context_ptr->rc_targets_pending_flag &&
+        encode_context_ptr->rc_targets_pending_picture_number <= picture_number) {
+        *targets = encode_context_ptr->rc_targets_pending;
+        encode_context_ptr->rc_targets_pending_flag = EB_FALSE;
+    }
+    svt_release_mutex(encode_context_ptr->rc_targets_mutex);
+}
+
 /*
   ret number of past picture(not including current) in mg buffer.
 
@@ -4750,7 +4802,12 @@ void* picture_decision_kernel(void *input_ptr)
 
                 pcs_ptr->init_pred_struct_position_flag = EB_FALSE;
 
-                pcs_ptr->target_bit_rate = scs_ptr->static_config.target_bit_rate;
+                if (encode_context_ptr->pre_assignment_buffer_count == 0)
+                    update_rc_targets(scs_ptr, encode_context_ptr, pcs_ptr->picture_number);
+                pcs_ptr->target_bit_rate = encode_context_ptr->rc_targets.target_bit_rate;
+                pcs_ptr->vbv_bufsize = encode_context_ptr->rc_targets.vbv_bufsize;
+                pcs_ptr->max_qp_allowed = encode_context_ptr->rc_targets.max_qp_allowed;
+                pcs_ptr->min_qp_allowed = encode_context_ptr->rc_targets.min_qp_allowed;
 
                 pcs_ptr->self_updated_links = 0;
                 pcs_ptr->other_updated_links_cnt = 0;
@@ -22,6 +22,7 @@
  ***************************************/
 EbErrorType picture_decision_context_ctor(EbThreadContext *  thread_context_ptr,
                                           const EbEncHandle *enc_handle_ptr);
+void        picture_decision_context_reset(EbThreadContext *thread_context_ptr);
 
 extern void *picture_decision_kernel(void *input_ptr);
 
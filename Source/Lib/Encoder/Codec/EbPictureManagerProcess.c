@@ -105,6 +105,16 @@ EbErrorType picture_manager_context_ctor(EbThreadContext *  thread_context_ptr,
     return EB_ErrorNone;
 }
 
+/************************************************
+ * Picture Manager Context Reset
+ ************************************************/
+void picture_manager_context_reset(EbThreadContext *thread_context_ptr) {
+    PictureManagerContext *context_ptr = (PictureManagerContext *)thread_context_ptr->priv;
+
+    context_ptr->pmgr_dec_order = 0;
+    context_ptr->decode_order   = 0;
+}
+
 void copy_buffer_info(EbPictureBufferDesc *src_ptr, EbPictureBufferDesc *dst_ptr){
     dst_ptr->width = src_ptr->width;
     dst_ptr->height = src_ptr->height;
@@ -628,7 +638,6 @@ void *picture_manager_kernel(void *input_ptr) {
     // Initialization
     uint8_t                     pic_width_in_sb;
     uint8_t                     picture_height_in_sb;
-    uint64_t decode_order = 0;
     // Debug
     uint32_t loop_count = 0;
 
@@ -822,8 +831,8 @@ void *picture_manager_kernel(void *input_ptr) {
                 (reference_queue_index != encode_context_ptr->reference_picture_queue_tail_index) &&
                 (reference_entry_ptr->picture_number != input_picture_demux_ptr->picture_number));
             // Update the last decode order
-            if(input_picture_demux_ptr->decode_order == decode_order)
-                decode_order++;
+            if(input_picture_demux_ptr->decode_order == context_ptr->decode_order)
+                context_ptr->decode_order++;
 
             //keep the release of SCS here because we still need the encodeContext structure here
             // Release the Reference's SequenceControlSet
@@ -860,7 +869,7 @@ void *picture_manager_kernel(void *input_ptr) {
                         (SequenceControlSet *)entry_pcs_ptr->scs_wrapper_ptr->object_ptr;
 
                     availability_flag = EB_TRUE;
-                    if (entry_pcs_ptr->decode_order != decode_order &&
+                    if (entry_pcs_ptr->decode_order != context_ptr->decode_order &&
                     (scs_ptr->enable_dec_order || use_input_stat(scs_ptr) || scs_ptr->lap_enabled ))
                         availability_flag = EB_FALSE;
 
@@ -28,12 +28,14 @@ typedef struct PictureManagerContext {
     EbFifo * picture_manager_output_fifo_ptr;
     EbFifo * picture_control_set_fifo_ptr;
     uint64_t pmgr_dec_order;
+    uint64_t decode_order; // next decode order of the reference feedback
 } PictureManagerContext;
 /***************************************
      * Extern Function Declaration
      ***************************************/
 EbErrorType picture_manager_context_ctor(EbThreadContext *  thread_context_ptr,
                                          const EbEncHandle *enc_handle_ptr, int rate_control_index);
+void        picture_manager_context_reset(EbThreadContext *thread_context_ptr);
 
 extern void *picture_manager_kernel(void *input_ptr);
 
@@ -0,0 +1,726 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* Copyright (c) 2016, Alliance for Open Media. All rights reserved
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <stdlib.h>
+
+#include "EbEncHandle.h"
+#include "EbQualityMetricsProcess.h"
+#include "EbEncDecResults.h"
+#include "EbThreads.h"
+#include "EbUtility.h"
+#include "EbReferenceObject.h"
+#include "EbPictureControlSet.h"
+#include "aom_dsp_rtcd.h"
+
+/**************************************
+ * Quality Metrics Context
+ **************************************/
+typedef struct QualityMetricsContext {
+    EbDctor dctor;
+    EbFifo *quality_metrics_input_fifo_ptr;
+} QualityMetricsContext;
+
+void get_recon_pic(PictureControlSet *pcs_ptr, EbPictureBufferDesc **recon_ptr, EbBool is_highbd);
+
+static void quality_metrics_context_dctor(EbPtr p) {
+    EbThreadContext *      thread_context_ptr = (EbThreadContext *)p;
+    QualityMetricsContext *obj = (QualityMetricsContext *)thread_context_ptr->priv;
+    EB_FREE_ARRAY(obj);
+}
+
+/******************************************************
+ * Quality Metrics Context Constructor
+ ******************************************************/
+EbErrorType quality_metrics_context_ctor(EbThreadContext *  thread_context_ptr,
+                                         const EbEncHandle *enc_handle_ptr, int index) {
+    QualityMetricsContext *context_ptr;
+    EB_CALLOC_ARRAY(context_ptr, 1);
+    thread_context_ptr->priv  = context_ptr;
+    thread_context_ptr->dctor = quality_metrics_context_dctor;
+
+    // Input System Resource Manager FIFO
+    context_ptr->quality_metrics_input_fifo_ptr = svt_system_resource_get_consumer_fifo(
+        enc_handle_ptr->quality_metrics_tasks_resource_ptr, index);
+
+    return EB_ErrorNone;
+}
+
+//************************************/
+// SSIM
+/************************************/
+
+void svt_aom_ssim_parms_8x8_c(const uint8_t *s, int sp, const uint8_t *r, int rp,
+                              uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                              uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    int i, j;
+    for (i = 0; i < 8; i++, s += sp, r += rp) {
+        for (j = 0; j < 8; j++) {
+            *sum_s += s[j];
+            *sum_r += r[j];
+            *sum_sq_s += s[j] * s[j];
+            *sum_sq_r += r[j] * r[j];
+            *sum_sxr += s[j] * r[j];
+        }
+    }
+}
+
+void svt_aom_highbd_ssim_parms_8x8_c(const uint8_t *s, int sp, const uint8_t *sinc, int spinc,
+                                     const uint16_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r,
+                                     uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    int      i, j;
+    uint32_t ss;
+    for (i = 0; i < 8; i++, s += sp, sinc += spinc, r += rp) {
+        for (j = 0; j < 8; j++) {
+            ss = (int64_t)(s[j] << 2) + ((sinc[j] >> 6) & 0x3);
+            *sum_s += ss;
+            *sum_r += r[j];
+            *sum_sq_s += ss * ss;
+            *sum_sq_r += r[j] * r[j];
+            *sum_sxr += ss * r[j];
+        }
+    }
+}
+
+static const int64_t cc1    = 26634; // (64^2*(.01*255)^2
+static const int64_t cc2    = 239708; // (64^2*(.03*255)^2
+static const int64_t cc1_10 = 428658; // (64^2*(.01*1023)^2
+static const int64_t cc2_10 = 3857925; // (64^2*(.03*1023)^2
+static const int64_t cc1_12 = 6868593; // (64^2*(.01*4095)^2
+static const int64_t cc2_12 = 61817334; // (64^2*(.03*4095)^2
+
+static double similarity(uint32_t sum_s, uint32_t sum_r, uint32_t sum_sq_s, uint32_t sum_sq_r,
+                         uint32_t sum_sxr, int count, uint32_t bd) {
+    double  ssim_n, ssim_d;
+    int64_t c1, c2;
+
+    if (bd == 8) {
+        // scale the constants by number of pixels
+        c1 = (cc1 * count * count) >> 12;
+        c2 = (cc2 * count * count) >> 12;
+    } else if (bd == 10) {
+        c1 = (cc1_10 * count * count) >> 12;
+        c2 = (cc2_10 * count * count) >> 12;
+    } else if (bd == 12) {
+        c1 = (cc1_12 * count * count) >> 12;
+        c2 = (cc2_12 * count * count) >> 12;
+    } else {
+        c1 = c2 = 0;
+        assert(0);
+    }
+
+    ssim_n = (2.0 * sum_s * sum_r + c1) * (2.0 * count * sum_sxr - 2.0 * sum_s * sum_r + c2);
+
+    ssim_d = ((double)sum_s * sum_s + (double)sum_r * sum_r + c1) *
+        ((double)count * sum_sq_s - (double)sum_s * sum_s + (double)count * sum_sq_r -
+         (double)sum_r * sum_r + c2);
+
+    return ssim_n / ssim_d;
+}
+
+static double ssim_8x8(const uint8_t *s, int sp, const uint8_t *r, int rp) {
+    uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
+    svt_aom_ssim_parms_8x8(s, sp, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
+    return similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64, 8);
+}
+
+static double highbd_ssim_8x8(const uint8_t *s, int sp, const uint8_t *sinc, int spinc,
+                              const uint16_t *r, int rp, uint32_t bd, uint32_t shift) {
+    uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
+    svt_aom_highbd_ssim_parms_8x8(
+        s, sp, sinc, spinc, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
+    return similarity(sum_s >> shift,
+                      sum_r >> shift,
+                      sum_sq_s >> (2 * shift),
+                      sum_sq_r >> (2 * shift),
+                      sum_sxr >> (2 * shift),
+                      64,
+                      bd);
+}
+
+// We are using a 8x8 moving window with starting location of each 8x8 window
+// on the 4x4 pixel grid. Such arrangement allows the windows to overlap
+// block boundaries to penalize blocking artifacts.
+// Stores the SSIM of the windows starting on rows [row_start, row_end), row_start
+// being a multiple of 4, at their raster index. The windows of the last rows reach
+// into the next band.
+// The windows reaching past (edge_x, edge_y) read the non visible samples, which
+// are overwritten when a reference picture is padded. Only those are done when
+// edge is set, and only the others when it is not.
+static uint32_t ssim_band(const uint8_t *img1, int stride_img1, const uint8_t *img2,
+                          int stride_img2, int width, int height, int row_start, int row_end,
+                          int edge_x, int edge_y, EbBool edge, double *ssim) {
+    const int windows_in_row = (width - 8) / 4 + 1;
+    const int last_inner_j   = edge_x - 8;
+    uint32_t  samples        = 0;
+
+    for (int i = row_start; i < row_end && i <= height - 8; i += 4) {
+        const uint8_t *s       = img1 + i * stride_img1;
+        const uint8_t *r       = img2 + i * stride_img2;
+        int            j_start = 0;
+        int            j_end   = width - 8;
+        if (i + 8 <= edge_y) {
+            if (edge)
+                j_start = last_inner_j < 0 ? 0 : (last_inner_j / 4 + 1) * 4;
+            else
+                j_end = MIN(j_end, last_inner_j);
+        } else if (!edge)
+            continue;
+        for (int j = j_start; j <= j_end; j += 4) {
+            ssim[(i / 4) * windows_in_row + j / 4] =
+                ssim_8x8(s + j, stride_img1, r + j, stride_img2);
+            samples++;
+        }
+    }
+    return samples;
+}
+
+static uint32_t highbd_ssim_band(const uint8_t *img1, int stride_img1, const uint8_t *img1inc,
+                                 int stride_img1inc, const uint16_t *img2, int stride_img2,
+                                 int width, int height, int row_start, int row_end, int edge_x,
+                                 int edge_y, EbBool edge, uint32_t bd, uint32_t shift,
+                                 double *ssim) {
+    const int windows_in_row = (width - 8) / 4 + 1;
+    const int last_inner_j   = edge_x - 8;
+    uint32_t  samples        = 0;
+
+    for (int i = row_start; i < row_end && i <= height - 8; i += 4) {
+        const uint8_t * s       = img1 + i * stride_img1;
+        const uint8_t * sinc    = img1inc + i * stride_img1inc;
+        const uint16_t *r       = img2 + i * stride_img2;
+        int             j_start = 0;
+        int             j_end   = width - 8;
+        if (i + 8 <= edge_y) {
+            if (edge)
+                j_start = last_inner_j < 0 ? 0 : (last_inner_j / 4 + 1) * 4;
+            else
+                j_end = MIN(j_end, last_inner_j);
+        } else if (!edge)
+            continue;
+        for (int j = j_start; j <= j_end; j += 4) {
+            ssim[(i / 4) * windows_in_row + j / 4] = highbd_ssim_8x8(
+                s + j, stride_img1, sinc + j, stride_img1inc, r + j, stride_img2, bd, shift);
+            samples++;
+        }
+    }
+    return samples;
+}
+
+// SSIM of a whole block, averaged over its windows in raster order
+static double highbd_ssim_block(const uint8_t *img1, int stride_img1, const uint8_t *img1inc,
+                                int stride_img1inc, const uint16_t *img2, int stride_img2,
+                                int width, int height, uint32_t bd, uint32_t shift) {
+    int    samples    = 0;
+    double ssim_total = 0;
+
+    for (int i = 0; i <= height - 8; i += 4) {
+        const uint8_t * s    = img1 + i * stride_img1;
+        const uint8_t * sinc = img1inc + i * stride_img1inc;
+        const uint16_t *r    = img2 + i * stride_img2;
+        for (int j = 0; j <= width - 8; j += 4) {
+            ssim_total += highbd_ssim_8x8(
+                s + j, stride_img1, sinc + j, stride_img1inc, r + j, stride_img2, bd, shift);
+            samples++;
+        }
+    }
+    assert(samples > 0);
+    return ssim_total / samples;
+}
+
+//************************************/
+// SSE
+/************************************/
+
+// The SIMD kernel takes any height for 64 wide blocks, and pairs of rows for the
+// other multiples of 8. The block width also bounds its 32 bit accumulators.
+static uint64_t sse_band(const uint8_t *a, int a_stride, const uint8_t *b, int b_stride,
+                         int width, int height) {
+    uint64_t sse = 0;
+    int      x   = 0;
+
+    for (; x + 64 <= width; x += 64)
+        sse += svt_aom_sse(a + x, a_stride, b + x, b_stride, 64, height);
+    if (x < width) {
+        const int w = width - x;
+        if ((w & 7) == 0 && (height & 1) == 0)
+            sse += svt_aom_sse(a + x, a_stride, b + x, b_stride, w, height);
+        else
+            sse += svt_aom_sse_c(a + x, a_stride, b + x, b_stride, w, height);
+    }
+    return sse;
+}
+
+static uint64_t highbd_sse_band(const uint8_t *in, int in_stride, const uint8_t *in_inc,
+                                int in_inc_stride, const uint16_t *recon, int recon_stride,
+                                int width, int height) {
+    uint64_t residual_distortion = 0;
+
+    for (int row_index = 0; row_index < height; ++row_index) {
+        for (int column_index = 0; column_index < width; ++column_index) {
+            residual_distortion +=
+                (int64_t)SQR((int64_t)((((in[column_index]) << 2) |
+                                        ((in_inc[column_index] >> 6) & 3))) -
+                             (recon[column_index]));
+        }
+        in += in_stride;
+        in_inc += in_inc_stride;
+        recon += recon_stride;
+    }
+    return residual_distortion;
+}
+
+// SSE of one SB of the compressed 10 bit format, where the 2 bit planes are stored
+// per SB with 4 pixels per byte
+static uint64_t compressed_sse_block(const uint8_t *in, int in_stride, const uint8_t *in_inc,
+                                     const uint16_t *recon, int recon_stride, uint32_t sb_width,
+                                     uint32_t sb_height) {
+    const uint32_t inn_stride          = sb_width / 4;
+    uint64_t       residual_distortion = 0;
+
+    for (uint32_t j = 0; j < sb_height; j++) {
+        for (uint32_t k = 0; k < sb_width / 4; k++) {
+            const uint8_t four_2bit_pels = in_inc[k + j * inn_stride];
+            for (uint32_t p = 0; p < 4; p++) {
+                const uint8_t  n_bit_pixel = (four_2bit_pels >> (6 - 2 * p)) & 3;
+                const uint16_t out_pixel   = (in[k * 4 + p + j * in_stride] << 2) | n_bit_pixel;
+                residual_distortion += (int64_t)SQR(
+                    (int64_t)out_pixel - (int64_t)recon[k * 4 + p + j * recon_stride]);
+            }
+        }
+    }
+    return residual_distortion;
+}
+
+//************************************/
+// Band metrics
+/************************************/
+
+// PSNR is measured over the visible area of the unscaled source, SSIM over the coded
+// frame of the source the picture was encoded from, as the metrics always were.
+// With edge set, only the SSIM windows reading the non visible samples of a reference
+// picture are done, over the whole picture, before it is padded.
+static void metrics_band(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr, uint32_t band,
+                         EbBool edge, uint64_t sse[3], uint32_t ssim_count[3]) {
+    PictureParentControlSet *ppcs_ptr          = pcs_ptr->parent_pcs_ptr;
+    EbPictureBufferDesc *    input_picture_ptr = ppcs_ptr->enhanced_unscaled_picture_ptr;
+    EbPictureBufferDesc *    ssim_picture_ptr  = ppcs_ptr->enhanced_picture_ptr;
+    EbPictureBufferDesc *    recon_ptr;
+
+    get_recon_pic(pcs_ptr, &recon_ptr, EB_FALSE);
+    // a reference picture gets its non visible samples overwritten by the padding
+    const EbBool padded = ppcs_ptr->is_used_as_reference_flag;
+
+    // if current source picture was temporally filtered, use an alternative buffer which stores
+    // the original source picture
+    const EbBool tf              = ppcs_ptr->temporal_filtering_on;
+    const EbByte input_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[0] : input_picture_ptr->buffer_y,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[1] : input_picture_ptr->buffer_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[2] : input_picture_ptr->buffer_cr};
+    const EbByte ssim_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[0] : ssim_picture_ptr->buffer_y,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[1] : ssim_picture_ptr->buffer_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[2] : ssim_picture_ptr->buffer_cr};
+    const int input_stride[3] = {
+        input_picture_ptr->stride_y, input_picture_ptr->stride_cb, input_picture_ptr->stride_cr};
+    const int ssim_stride[3] = {
+        ssim_picture_ptr->stride_y, ssim_picture_ptr->stride_cb, ssim_picture_ptr->stride_cr};
+    const EbByte recon_buffer[3] = {
+        recon_ptr->buffer_y, recon_ptr->buffer_cb, recon_ptr->buffer_cr};
+    const int recon_stride[3] = {
+        recon_ptr->stride_y, recon_ptr->stride_cb, recon_ptr->stride_cr};
+
+    for (int plane = 0; plane < 3; plane++) {
+        const uint32_t ss_x   = plane ? scs_ptr->subsampling_x : 0;
+        const uint32_t ss_y   = plane ? scs_ptr->subsampling_y : 0;
+        const int      width  = (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
+        const int      height = (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >>
+            ss_y;
+        const int ssim_width  = plane ? scs_ptr->chroma_width : scs_ptr->seq_header.max_frame_width;
+        const int ssim_height = plane ? scs_ptr->chroma_height
+                                      : scs_ptr->seq_header.max_frame_height;
+        const int row_start   = edge ? 0 : (band * QUALITY_METRICS_BAND_HEIGHT) >> ss_y;
+        const int row_end     = edge ? ssim_height
+                                     : row_start + (QUALITY_METRICS_BAND_HEIGHT >> ss_y);
+        const int edge_x      = padded ? (int)(recon_ptr->width - scs_ptr->pad_right) >> ss_x
+                                       : ssim_width;
+        const int edge_y      = padded ? (int)(recon_ptr->height - scs_ptr->pad_bottom) >> ss_y
+                                       : ssim_height;
+        const uint8_t *recon  = recon_buffer[plane] + (recon_ptr->origin_x >> ss_x) +
+            (recon_ptr->origin_y >> ss_y) * recon_stride[plane];
+
+        if (!edge && row_start < height) {
+            const uint8_t *in = input_buffer[plane] + (input_picture_ptr->origin_x >> ss_x) +
+                (input_picture_ptr->origin_y >> ss_y) * input_stride[plane];
+            sse[plane] = sse_band(in + row_start * input_stride[plane],
+                                  input_stride[plane],
+                                  recon + row_start * recon_stride[plane],
+                                  recon_stride[plane],
+                                  width,
+                                  MIN(row_end, height) - row_start);
+        }
+
+        const uint8_t *ssim_in = ssim_buffer[plane] + (ssim_picture_ptr->origin_x >> ss_x) +
+            (ssim_picture_ptr->origin_y >> ss_y) * ssim_stride[plane];
+        ssim_count[plane] = ssim_band(ssim_in,
+                                      ssim_stride[plane],
+                                      recon,
+                                      recon_stride[plane],
+                                      ssim_width,
+                                      ssim_height,
+                                      row_start,
+                                      row_end,
+                                      edge_x,
+                                      edge_y,
+                                      edge,
+                                      pcs_ptr->metrics_ssim[plane]);
+    }
+}
+
+static void highbd_metrics_band(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
+                                uint32_t band, EbBool edge, uint64_t sse[3],
+                                uint32_t ssim_count[3]) {
+    PictureParentControlSet *ppcs_ptr          = pcs_ptr->parent_pcs_ptr;
+    EbPictureBufferDesc *    input_picture_ptr = ppcs_ptr->enhanced_unscaled_picture_ptr;
+    EbPictureBufferDesc *    ssim_picture_ptr  = ppcs_ptr->enhanced_picture_ptr;
+    EbPictureBufferDesc *    recon_ptr;
+
+    get_recon_pic(pcs_ptr, &recon_ptr, EB_TRUE);
+    // a reference picture gets its non visible samples overwritten by the padding
+    const EbBool padded = ppcs_ptr->is_used_as_reference_flag;
+
+    // if current source picture was temporally filtered, use an alternative buffer which stores
+    // the original source picture
+    const EbBool tf              = ppcs_ptr->temporal_filtering_on;
+    const EbByte input_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[0] : input_picture_ptr->buffer_y,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[1] : input_picture_ptr->buffer_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[2] : input_picture_ptr->buffer_cr};
+    const EbByte input_bit_inc_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[0] : input_picture_ptr->buffer_bit_inc_y,
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[1] : input_picture_ptr->buffer_bit_inc_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[2] : input_picture_ptr->buffer_bit_inc_cr};
+    const EbByte ssim_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[0] : ssim_picture_ptr->buffer_y,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[1] : ssim_picture_ptr->buffer_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_ptr[2] : ssim_picture_ptr->buffer_cr};
+    const EbByte ssim_bit_inc_buffer[3] = {
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[0] : ssim_picture_ptr->buffer_bit_inc_y,
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[1] : ssim_picture_ptr->buffer_bit_inc_cb,
+        tf ? ppcs_ptr->save_enhanced_picture_bit_inc_ptr[2] : ssim_picture_ptr->buffer_bit_inc_cr};
+    const int input_stride[3] = {
+        input_picture_ptr->stride_y, input_picture_ptr->stride_cb, input_picture_ptr->stride_cr};
+    const int input_bit_inc_stride[3] = {input_picture_ptr->stride_bit_inc_y,
+                                         input_picture_ptr->stride_bit_inc_cb,
+                                         input_picture_ptr->stride_bit_inc_cr};
+    const int ssim_stride[3] = {
+        ssim_picture_ptr->stride_y, ssim_picture_ptr->stride_cb, ssim_picture_ptr->stride_cr};
+    const int ssim_bit_inc_stride[3] = {ssim_picture_ptr->stride_bit_inc_y,
+                                        ssim_picture_ptr->stride_bit_inc_cb,
+                                        ssim_picture_ptr->stride_bit_inc_cr};
+    const EbByte recon_buffer[3] = {
+        recon_ptr->buffer_y, recon_ptr->buffer_cb, recon_ptr->buffer_cr};
+    const int recon_stride[3] = {
+        recon_ptr->stride_y, recon_ptr->stride_cb, recon_ptr->stride_cr};
+
+    for (int plane = 0; plane < 3; plane++) {
+        const uint32_t ss_x   = plane ? scs_ptr->subsampling_x : 0;
+        const uint32_t ss_y   = plane ? scs_ptr->subsampling_y : 0;
+        const int      width  = (input_picture_ptr->width - scs_ptr->max_input_pad_right) >> ss_x;
+        const int      height = (input_picture_ptr->height - scs_ptr->max_input_pad_bottom) >>
+            ss_y;
+        const int ssim_width  = plane ? scs_ptr->chroma_width : scs_ptr->seq_header.max_frame_width;
+        const int ssim_height = plane ? scs_ptr->chroma_height
+                                      : scs_ptr->seq_header.max_frame_height;
+        const int row_start   = edge ? 0 : (band * QUALITY_METRICS_BAND_HEIGHT) >> ss_y;
+        const int row_end     = edge ? ssim_height
+                                     : row_start + (QUALITY_METRICS_BAND_HEIGHT >> ss_y);
+        const int edge_x      = padded ? (int)(recon_ptr->width - scs_ptr->pad_right) >> ss_x
+                                       : ssim_width;
+        const int edge_y      = padded ? (int)(recon_ptr->height - scs_ptr->pad_bottom) >> ss_y
+                                       : ssim_height;
+        const uint16_t *recon = (uint16_t *)recon_buffer[plane] + (recon_ptr->origin_x >> ss_x) +
+            (recon_ptr->origin_y >> ss_y) * recon_stride[plane];
+
+        if (!edge && row_start < height) {
+            const uint8_t *in = input_buffer[plane] + (input_picture_ptr->origin_x >> ss_x) +
+                (input_picture_ptr->origin_y >> ss_y) * input_stride[plane];
+            const uint8_t *in_inc = input_bit_inc_buffer[plane] +
+                (input_picture_ptr->origin_x >> ss_x) +
+                (input_picture_ptr->origin_y >> ss_y) * input_bit_inc_stride[plane];
+            sse[plane] = highbd_sse_band(in + row_start * input_stride[plane],
+                                         input_stride[plane],
+                                         in_inc + row_start * input_bit_inc_stride[plane],
+                                         input_bit_inc_stride[plane],
+                                         recon + row_start * recon_stride[plane],
+                                         recon_stride[plane],
+                                         width,
+                                         MIN(row_end, height) - row_start);
+        }
+
+        const uint8_t *ssim_in = ssim_buffer[plane] + (ssim_picture_ptr->origin_x >> ss_x) +
+            (ssim_picture_ptr->origin_y >> ss_y) * ssim_stride[plane];
+        const uint8_t *ssim_in_inc = ssim_bit_inc_buffer[plane] +
+            (ssim_picture_ptr->origin_x >> ss_x) +
+            (ssim_picture_ptr->origin_y >> ss_y) * ssim_bit_inc_stride[plane];
+        // both input and output are 10 bit (bitdepth - input_bd)
+        ssim_count[plane] = highbd_ssim_band(ssim_in,
+                                             ssim_stride[plane],
+                                             ssim_in_inc,
+                                             ssim_bit_inc_stride[plane],
+                                             recon,
+                                             recon_stride[plane],
+                                             ssim_width,
+                                             ssim_height,
+                                             row_start,
+                                             row_end,
+                                             edge_x,
+                                             edge_y,
+                                             edge,
+                                             10,
+                                             0,
+                                             pcs_ptr->metrics_ssim[plane]);
+    }
+}
+
+/* SSIM calculation for compressed 10-bit format has not been verified and debugged,
+   since this format is not supported elsewhere in this version. See verify_settings(),
+   which exits with an error if compressed 10-bit format is enabled. To avoid
+   extra complexity of unpacking into a temporary buffer, or having to write
+   new core SSIM functions, we ignore the two least signifcant bits in this
+   case, and set these to zero. One test shows a difference in SSIM
+   of 0.00085 setting the two least significant bits to zero.
+   The band is one row of 64x64 SBs, the SSIM is averaged per SB. */
+static void compressed_metrics_band(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr,
+                                    uint32_t band, uint64_t sse[3], uint32_t ssim_count[3]) {
+    EbPictureBufferDesc *input_picture_ptr =
+        pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr;
+    EbPictureBufferDesc *ssim_picture_ptr = pcs_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+    EbPictureBufferDesc *recon_ptr;
+    uint8_t              zero_buffer[64 * 64];
+
+    get_recon_pic(pcs_ptr, &recon_ptr, EB_TRUE);
+    memset(zero_buffer, 0, sizeof(zero_buffer));
+
+    const uint32_t luma_width       = input_picture_ptr->width - scs_ptr->max_input_pad_right;
+    const uint32_t luma_height      = input_picture_ptr->height - scs_ptr->max_input_pad_bottom;
+    const uint32_t pic_width_in_sb  = (luma_width + 64 - 1) / 64;
+    const uint32_t ssim_luma_width  = ssim_picture_ptr->width - scs_ptr->max_input_pad_right;
+    const uint32_t ssim_luma_height = ssim_picture_ptr->height - scs_ptr->max_input_pad_bottom;
+    const uint32_t ssim_width_in_sb = (ssim_luma_width + 64 - 1) / 64;
+
+    const EbByte input_buffer[3] = {
+        input_picture_ptr->buffer_y, input_picture_ptr->buffer_cb, input_picture_ptr->buffer_cr};
+    const EbByte input_bit_inc_buffer[3] = {input_picture_ptr->buffer_bit_inc_y,
+                                            input_picture_ptr->buffer_bit_inc_cb,
+                                            input_picture_ptr->buffer_bit_inc_cr};
+    const int input_stride[3] = {
+        input_picture_ptr->stride_y, input_picture_ptr->stride_cb, input_picture_ptr->stride_cr};
+    const EbByte ssim_buffer[3] = {
+        ssim_picture_ptr->buffer_y, ssim_picture_ptr->buffer_cb, ssim_picture_ptr->buffer_cr};
+    const int ssim_stride[3] = {
+        ssim_picture_ptr->stride_y, ssim_picture_ptr->stride_cb, ssim_picture_ptr->stride_cr};
+    const EbByte recon_buffer[3] = {
+        recon_ptr->buffer_y, recon_ptr->buffer_cb, recon_ptr->buffer_cr};
+    const int recon_stride[3] = {
+        recon_ptr->stride_y, recon_ptr->stride_cb, recon_ptr->stride_cr};
+
+    for (int plane = 0; plane < 3; plane++) {
+        const uint32_t shift       = plane ? 1 : 0;
+        const uint32_t sb_size     = 64 >> shift;
+        const uint32_t ss_x        = plane ? scs_ptr->subsampling_x : 0;
+        const uint32_t ss_y        = plane ? scs_ptr->subsampling_y : 0;
+        const uint32_t tb_origin_y = band * sb_size;
+        const uint16_t *recon      = (uint16_t *)recon_buffer[plane] +
+            recon_ptr->origin_x / (1 + shift) +
+            recon_ptr->origin_y / (1 + shift) * recon_stride[plane];
+
+        const uint32_t width  = luma_width >> ss_x;
+        const uint32_t height = luma_height >> ss_y;
+        if (band * 64 < luma_height) {
+            const uint32_t sb_height = (height - tb_origin_y) < sb_size ? (height - tb_origin_y)
+                                                                        : sb_size;
+            const uint8_t *in = input_buffer[plane] + input_picture_ptr->origin_x / (1 + shift) +
+                input_picture_ptr->origin_y / (1 + shift) * input_stride[plane];
+
+            for (uint32_t sb_num_in_width = 0; sb_num_in_width < pic_width_in_sb;
+                 ++sb_num_in_width) {
+                const uint32_t tb_origin_x = sb_num_in_width * sb_size;
+                const uint32_t sb_width = (width - tb_origin_x) < sb_size ? (width - tb_origin_x)
+                                                                          : sb_size;
+                const uint8_t *sb_in_inc = input_bit_inc_buffer[plane] +
+                    tb_origin_y * (width / 4) + (tb_origin_x / 4) * sb_height;
+
+                sse[plane] += compressed_sse_block(
+                    in + tb_origin_y * input_stride[plane] + tb_origin_x,
+                    input_stride[plane],
+                    sb_in_inc,
+                    recon + tb_origin_y * recon_stride[plane] + tb_origin_x,
+                    recon_stride[plane],
+                    sb_width,
+                    sb_height);
+            }
+        }
+
+        const uint32_t ssim_width  = ssim_luma_width >> ss_x;
+        const uint32_t ssim_height = ssim_luma_height >> ss_y;
+        if (band * 64 < ssim_luma_height) {
+            const uint32_t sb_height = (ssim_height - tb_origin_y) < sb_size
+                ? (ssim_height - tb_origin_y)
+                : sb_size;
+            const uint8_t *in = ssim_buffer[plane] + ssim_picture_ptr->origin_x / (1 + shift) +
+                ssim_picture_ptr->origin_y / (1 + shift) * ssim_stride[plane];
+
+            for (uint32_t sb_num_in_width = 0; sb_num_in_width < ssim_width_in_sb;
+                 ++sb_num_in_width) {
+                const uint32_t tb_origin_x = sb_num_in_width * sb_size;
+                const uint32_t sb_width    = (ssim_width - tb_origin_x) < sb_size
+                       ? (ssim_width - tb_origin_x)
+                       : sb_size;
+
+                pcs_ptr->metrics_ssim[plane][band * ssim_width_in_sb + sb_num_in_width] =
+                    highbd_ssim_block(in + tb_origin_y * ssim_stride[plane] + tb_origin_x,
+                                      ssim_stride[plane],
+                                      zero_buffer,
+                                      64,
+                                      recon + tb_origin_y * recon_stride[plane] + tb_origin_x,
+                                      recon_stride[plane],
+                                      sb_width,
+                                      sb_height,
+                                      10,
+                                      0);
+                ssim_count[plane]++;
+            }
+        }
+    }
+}
+
+/******************************************************
+ * Quality Metrics Finish
+ *   Sums up the bands once they are all done. The SSIM
+ *   values are stored per window (per SB for compressed
+ *   10-bit) and added in raster order, as the picture
+ *   level SSIM always was.
+ ******************************************************/
+static void quality_metrics_finish(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
+    PictureParentControlSet *ppcs_ptr    = pcs_ptr->parent_pcs_ptr;
+    double                   ssim_sum[3] = {0};
+
+    for (int plane = 0; plane < 3; plane++)
+        for (uint32_t i = 0; i < pcs_ptr->metrics_ssim_count[plane]; i++)
+            ssim_sum[plane] += pcs_ptr->metrics_ssim[plane][i];
+    assert(pcs_ptr->metrics_ssim_count[0] > 0);
+
+    ppcs_ptr->luma_sse  = (uint32_t)pcs_ptr->metrics_sse[0];
+    ppcs_ptr->cb_sse    = (uint32_t)pcs_ptr->metrics_sse[1];
+    ppcs_ptr->cr_sse    = (uint32_t)pcs_ptr->metrics_sse[2];
+    ppcs_ptr->luma_ssim = ssim_sum[0] / pcs_ptr->metrics_ssim_count[0];
+    ppcs_ptr->cb_ssim   = ssim_sum[1] / pcs_ptr->metrics_ssim_count[1];
+    ppcs_ptr->cr_ssim   = ssim_sum[2] / pcs_ptr->metrics_ssim_count[2];
+
+    // The copy of the source picture taken before temporal filtering is no longer needed
+    if (ppcs_ptr->temporal_filtering_on == EB_TRUE) {
+        EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_ptr[0]);
+        EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_ptr[1]);
+        EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_ptr[2]);
+        if (scs_ptr->static_config.encoder_bit_depth > EB_8BIT) {
+            EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_bit_inc_ptr[0]);
+            EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_bit_inc_ptr[1]);
+            EB_FREE_ARRAY(ppcs_ptr->save_enhanced_picture_bit_inc_ptr[2]);
+        }
+    }
+
+    // Release the live count taken on the reconstructed reference when the bands were posted
+    if (ppcs_ptr->is_used_as_reference_flag == EB_TRUE)
+        svt_release_object(ppcs_ptr->reference_picture_wrapper_ptr);
+}
+
+/******************************************************
+ * Quality Metrics Edge
+ *   SSIM of the windows reading the non visible samples
+ *   of a reference picture, done before the padding
+ *   overwrites them. Starts the SSIM counts of the picture,
+ *   the bands add theirs.
+ ******************************************************/
+void quality_metrics_edge(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr) {
+    uint64_t sse[3]        = {0};
+    uint32_t ssim_count[3] = {0};
+
+    // compressed 10-bit SSIM only covers the visible area
+    if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        if (scs_ptr->static_config.encoder_bit_depth == EB_8BIT)
+            metrics_band(pcs_ptr, scs_ptr, 0, EB_TRUE, sse, ssim_count);
+        else if (scs_ptr->static_config.ten_bit_format != 1)
+            highbd_metrics_band(pcs_ptr, scs_ptr, 0, EB_TRUE, sse, ssim_count);
+    }
+
+    for (int plane = 0; plane < 3; plane++)
+        pcs_ptr->metrics_ssim_count[plane] = ssim_count[plane];
+}
+
+/******************************************************
+ * Quality Metrics Task
+ *   PSNR and SSIM of one band of the picture
+ ******************************************************/
+void quality_metrics_task(EbPtr input_ptr, EbObjectWrapper *quality_metrics_tasks_wrapper_ptr) {
+    QualityMetricsTasks *tasks_ptr = (QualityMetricsTasks *)
+                                         quality_metrics_tasks_wrapper_ptr->object_ptr;
+    PictureControlSet * pcs_ptr = (PictureControlSet *)tasks_ptr->pcs_wrapper_ptr->object_ptr;
+    SequenceControlSet *scs_ptr = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    const uint32_t      band    = tasks_ptr->segment_index;
+    uint64_t            sse[3]        = {0};
+    uint32_t            ssim_count[3] = {0};
+    EbBool              last_band;
+    (void)input_ptr;
+
+    if (scs_ptr->static_config.encoder_bit_depth == EB_8BIT)
+        metrics_band(pcs_ptr, scs_ptr, band, EB_FALSE, sse, ssim_count);
+    else if (scs_ptr->static_config.ten_bit_format == 1)
+        compressed_metrics_band(pcs_ptr, scs_ptr, band, sse, ssim_count);
+    else
+        highbd_metrics_band(pcs_ptr, scs_ptr, band, EB_FALSE, sse, ssim_count);
+
+    svt_block_on_mutex(pcs_ptr->metrics_mutex);
+    for (int plane = 0; plane < 3; plane++) {
+        pcs_ptr->metrics_sse[plane] += sse[plane];
+        pcs_ptr->metrics_ssim_count[plane] += ssim_count[plane];
+    }
+    last_band = ++pcs_ptr->tot_bands_metrics == pcs_ptr->metrics_bands_total_count;
+    svt_release_mutex(pcs_ptr->metrics_mutex);
+
+    if (last_band) {
+        quality_metrics_finish(pcs_ptr, scs_ptr);
+        // Packetization waits for the metrics before reading them
+        svt_post_semaphore(pcs_ptr->metrics_done_semaphore);
+    }
+
+    // Release input Tasks
+    svt_release_object(quality_metrics_tasks_wrapper_ptr);
+}
+
+/******************************************************
+ * Quality Metrics Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *quality_metrics_kernel(void *input_ptr) {
+    EbThreadContext *      thread_context_ptr = (EbThreadContext *)input_ptr;
+    QualityMetricsContext *context_ptr = (QualityMetricsContext *)thread_context_ptr->priv;
+    EbObjectWrapper *      quality_metrics_tasks_wrapper_ptr;
+
+    for (;;) {
+        // Get Quality Metrics Tasks
+        EB_GET_FULL_OBJECT(context_ptr->quality_metrics_input_fifo_ptr,
+                           &quality_metrics_tasks_wrapper_ptr);
+        quality_metrics_task(input_ptr, quality_metrics_tasks_wrapper_ptr);
+    }
+
+    return NULL;
+}
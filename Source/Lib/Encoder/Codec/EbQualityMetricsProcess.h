@@ -0,0 +1,32 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbQualityMetricsProcess_h
+#define EbQualityMetricsProcess_h
+
+#include "EbDefinitions.h"
+#include "EbSequenceControlSet.h"
+#include "EbPictureControlSet.h"
+
+// PSNR and SSIM are computed in bands of 64 luma rows, one task per band
+#define QUALITY_METRICS_BAND_HEIGHT 64
+
+/**************************************
+ * Extern Function Declarations
+ **************************************/
+extern EbErrorType quality_metrics_context_ctor(EbThreadContext *  thread_context_ptr,
+                                                const EbEncHandle *enc_handle_ptr, int index);
+
+extern void *quality_metrics_kernel(void *input_ptr);
+extern void  quality_metrics_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
+extern void  quality_metrics_edge(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
+
+#endif
@@ -10,6 +10,7 @@
 * PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
 */
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbDefinitions.h"
 #include "EbEncHandle.h"
@@ -337,12 +338,48 @@ void get_best_reference(PictureParentControlSet *pcs_ptr, uint32_t sb_index, uin
     }
     return;
 }
+// Mi rows of one synthesizer row, a 64x64 SB
+#define TPL_SB_ROW_MI_HEIGHT 16
+/************************************************
+* Quantizer of the TPL pass for one picture of the window
+************************************************/
+static int32_t get_tpl_qindex(SequenceControlSet *scs_ptr, PictureParentControlSet *pcs_ptr) {
+    int32_t qIndex = quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp];
+    if (pcs_ptr->tpl_data.tpl_ctrls.enable_tpl_qps) {
+        const double delta_rate_new[7][6] = {
+            {1.0, 1.0, 1.0, 1.0, 1.0, 1.0}, // 1L
+            {0.6, 1.0, 1.0, 1.0, 1.0, 1.0}, // 2L
+            {0.6, 0.8, 1.0, 1.0, 1.0, 1.0}, // 3L
+            {0.6, 0.8, 0.9, 1.0, 1.0, 1.0}, // 4L
+            {0.35, 0.6, 0.8, 0.9, 1.0, 1.0}, //5L
+            {0.35, 0.6, 0.8, 0.9, 0.95, 1.0} //6L
+        };
+        double q_val;
+        q_val = svt_av1_convert_qindex_to_q(qIndex, 8);
+        int32_t delta_qindex;
+        if (pcs_ptr->tpl_data.tpl_slice_type == I_SLICE)
+            delta_qindex = svt_av1_compute_qdelta(q_val, q_val * 0.25, 8);
+        else
+            delta_qindex = svt_av1_compute_qdelta(
+                q_val,
+                q_val *
+                    delta_rate_new[pcs_ptr->hierarchical_levels]
+                                  [pcs_ptr->tpl_data.tpl_temporal_layer_index],
+                8);
+        qIndex = (qIndex + delta_qindex);
+    }
+    return qIndex;
+}
 /************************************************
 * Genrate TPL MC Flow Dispenser  Based on Lookahead
 ** LAD Window: sliding window size
+* Processes one row of 64x64 SBs. The rows of a picture run in a wavefront:
+* the intra recon of a SB reads the recon of the row above, so a SB waits
+* until the row above is done past its top-right SB.
 ************************************************/
-void tpl_mc_flow_dispenser(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
-                           PictureParentControlSet *pcs_ptr, int32_t frame_idx) {
+void tpl_mc_flow_dispenser_sb_row(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
+                                  PictureParentControlSet *pcs_ptr, int32_t frame_idx,
+                                  uint32_t sb_row) {
     uint32_t             picture_width_in_mb = (pcs_ptr->enhanced_picture_ptr->width + 16 - 1) / 16;
     int16_t              x_curr_mv           = 0;
     int16_t              y_curr_mv           = 0;
@@ -367,30 +404,7 @@ void tpl_mc_flow_dispenser(EncodeContext *encode_context_ptr, SequenceControlSet
     blk_geom.bheight = 16;
 
     MacroblockPlane mb_plane;
-    int32_t         qIndex = quantizer_to_qindex[(uint8_t)scs_ptr->static_config.qp];
-    if (pcs_ptr->tpl_data.tpl_ctrls.enable_tpl_qps) {
-        const double delta_rate_new[7][6] = {
-            {1.0, 1.0, 1.0, 1.0, 1.0, 1.0}, // 1L
-            {0.6, 1.0, 1.0, 1.0, 1.0, 1.0}, // 2L
-            {0.6, 0.8, 1.0, 1.0, 1.0, 1.0}, // 3L
-            {0.6, 0.8, 0.9, 1.0, 1.0, 1.0}, // 4L
-            {0.35, 0.6, 0.8, 0.9, 1.0, 1.0}, //5L
-            {0.35, 0.6, 0.8, 0.9, 0.95, 1.0} //6L
-        };
-        double q_val;
-        q_val = svt_av1_convert_qindex_to_q(qIndex, 8);
-        int32_t delta_qindex;
-        if (pcs_ptr->tpl_data.tpl_slice_type == I_SLICE)
-            delta_qindex = svt_av1_compute_qdelta(q_val, q_val * 0.25, 8);
-        else
-            delta_qindex = svt_av1_compute_qdelta(
-                q_val,
-                q_val *
-                    delta_rate_new[pcs_ptr->hierarchical_levels]
-                                  [pcs_ptr->tpl_data.tpl_temporal_layer_index],
-                8);
-        qIndex = (qIndex + delta_qindex);
-    }
+    int32_t         qIndex   = get_tpl_qindex(scs_ptr, pcs_ptr);
     mb_plane.quant_qtx       = scs_ptr->quants_8bit.y_quant[qIndex];
     mb_plane.quant_fp_qtx    = scs_ptr->quants_8bit.y_quant_fp[qIndex];
     mb_plane.round_fp_qtx    = scs_ptr->quants_8bit.y_round_fp[qIndex];
@@ -398,15 +412,25 @@ void tpl_mc_flow_dispenser(EncodeContext *encode_context_ptr, SequenceControlSet
     mb_plane.zbin_qtx        = scs_ptr->quants_8bit.y_zbin[qIndex];
     mb_plane.round_qtx       = scs_ptr->quants_8bit.y_round[qIndex];
     mb_plane.dequant_qtx     = scs_ptr->deq_8bit.y_dequant_qtx[qIndex];
-    pcs_ptr->base_rdmult     = svt_av1_compute_rd_mult_based_on_qindex(
-                               (AomBitDepth)8 /*scs_ptr->static_config.encoder_bit_depth*/,
-                               qIndex) /
-        6;
 
+    const uint32_t pic_width_in_sb = (scs_ptr->seq_header.max_frame_width + scs_ptr->sb_sz - 1) /
+        scs_ptr->sb_sz;
+    const uint32_t sb_row_start = sb_row * pic_width_in_sb;
+    const uint32_t sb_row_end   = MIN(sb_row_start + pic_width_in_sb, pcs_ptr->sb_total_count);
+    const EbBool   last_row     = sb_row_end == pcs_ptr->sb_total_count;
+    // Number of SBs of the row above known to be dispensed
+    uint32_t sb_done_in_prev_row = 0;
     EbPictureBufferDesc *input_ptr = pcs_ptr->enhanced_picture_ptr;
 
     // Walk the first N entries in the sliding window
-    for (uint32_t sb_index = 0; sb_index < pcs_ptr->sb_total_count; ++sb_index) {
+    for (uint32_t sb_index = sb_row_start; sb_index < sb_row_end; ++sb_index) {
+        /* Top-Right Sync */
+        if (sb_row) {
+            while (sb_done_in_prev_row < MIN(sb_index - sb_row_start + 2, pic_width_in_sb)) {
+                svt_block_on_semaphore(pcs_ptr->tpl_sb_row_semaphore[sb_row - 1]);
+                sb_done_in_prev_row++;
+            }
+        }
         {
             SbParams *sb_params    = &scs_ptr->sb_params_array[sb_index];
             uint32_t  pa_blk_index = 0;
@@ -802,8 +826,22 @@ void tpl_mc_flow_dispenser(EncodeContext *encode_context_ptr, SequenceControlSet
                 pa_blk_index++;
             }
         }
+        /* Update Top-Right Sync */
+        if (!last_row)
+            svt_post_semaphore(pcs_ptr->tpl_sb_row_semaphore[sb_row]);
     }
 
+    return;
+}
+
+/************************************************
+* Pad the TPL recon of a picture once all its rows are dispensed, the
+* pictures predicting from it read the padding
+************************************************/
+void tpl_mc_flow_dispenser_finish(EncodeContext *encode_context_ptr, int32_t frame_idx) {
+    EbPictureBufferDesc *recon_picture_ptr =
+        encode_context_ptr->mc_flow_rec_picture_buffer[frame_idx];
+
     // padding current recon picture
     generate_padding(recon_picture_ptr->buffer_y,
                      recon_picture_ptr->stride_y,
@@ -811,8 +849,6 @@ void tpl_mc_flow_dispenser(EncodeContext *encode_context_ptr, SequenceControlSet
                      recon_picture_ptr->height,
                      recon_picture_ptr->origin_x,
                      recon_picture_ptr->origin_y);
-
-    return;
 }
 
 static int get_overlap_area(int grid_pos_row, int grid_pos_col, int ref_pos_row, int ref_pos_col,
@@ -937,11 +973,12 @@ static AOM_INLINE void tpl_model_update_b(PictureParentControlSet *ref_pcs_ptr,
                     ref_tpl_stats_ptr = ref_pcs_ptr->tpl_stats[((ref_mi_row + idy) >> shift) *
                                                                    (mi_cols_sr >> shift) +
                                                                ((ref_mi_col + idx) >> shift)];
-                    ref_tpl_stats_ptr->mc_dep_dist += ((cur_dep_dist + mc_dep_dist) *
-                                                       overlap_area) /
-                        pix_num;
-                    ref_tpl_stats_ptr->mc_dep_rate += ((delta_rate + mc_dep_rate) * overlap_area) /
-                        pix_num;
+                    // Rows of the picture are synthesized in parallel and may hit the
+                    // same reference block, integer sums keep the result deterministic
+                    svt_atomic_add_i64(&ref_tpl_stats_ptr->mc_dep_dist,
+                                       ((cur_dep_dist + mc_dep_dist) * overlap_area) / pix_num);
+                    svt_atomic_add_i64(&ref_tpl_stats_ptr->mc_dep_rate,
+                                       ((delta_rate + mc_dep_rate) * overlap_area) / pix_num);
                     assert(overlap_area >= 0);
                 }
             }
@@ -981,15 +1018,18 @@ static AOM_INLINE void tpl_model_update(PictureParentControlSet *pcs_array[MAX_T
 /************************************************
 * Genrate TPL MC Flow Synthesizer Based on Lookahead
 ** LAD Window: sliding window size
+* Processes one row of TPL_SB_ROW_MI_HEIGHT mi rows
 ************************************************/
-void tpl_mc_flow_synthesizer(PictureParentControlSet *pcs_array[MAX_TPL_LA_SW], int32_t frame_idx,
-                             uint8_t frames_in_sw) {
+void tpl_mc_flow_synthesizer_sb_row(PictureParentControlSet *pcs_array[MAX_TPL_LA_SW],
+                                    int32_t frame_idx, uint8_t frames_in_sw, uint32_t sb_row) {
     Av1Common *              cm        = pcs_array[frame_idx]->av1_cm;
     const int /*BLOCK_SIZE*/ bsize     = BLOCK_16X16;
     const int                mi_height = mi_size_high[bsize];
     const int                mi_width  = mi_size_wide[bsize];
+    const int                row_start = sb_row * TPL_SB_ROW_MI_HEIGHT;
+    const int                row_end   = AOMMIN(row_start + TPL_SB_ROW_MI_HEIGHT, cm->mi_rows);
 
-    for (int mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
+    for (int mi_row = row_start; mi_row < row_end; mi_row += mi_height) {
         for (int mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
             tpl_model_update(pcs_array, frame_idx, mi_row, mi_col, bsize, frames_in_sw);
         }
@@ -1096,13 +1136,17 @@ EbErrorType init_tpl_buffers(EncodeContext *encode_context_ptr, PictureParentCon
     picture_buffer_desc_init_data.top_padding        = pcs_ptr->enhanced_picture_ptr->origin_y;
     picture_buffer_desc_init_data.bot_padding        = pcs_ptr->enhanced_picture_ptr->origin_bot_y;
     picture_buffer_desc_init_data.split_mode         = EB_FALSE;
+    picture_buffer_desc_init_data.alloc_policy       = pcs_ptr->scs_ptr->large_alloc_policy;
 
     EB_NEW(encode_context_ptr->mc_flow_rec_picture_buffer_noref,
            svt_picture_buffer_desc_ctor,
            (EbPtr)&picture_buffer_desc_init_data);
 
+    // Pictures of the window are dispensed in parallel when the TPL stage has several
+    // threads, each one then needs its own recon
+    const EbBool own_recon = pcs_ptr->scs_ptr->tpl_process_init_count > 1;
     for (frame_idx = 0; frame_idx < frames_in_sw; frame_idx++) {
-        if (pcs_array[frame_idx]->tpl_data.is_used_as_reference_flag) {
+        if (pcs_array[frame_idx]->tpl_data.is_used_as_reference_flag || own_recon) {
             EB_NEW(encode_context_ptr->mc_flow_rec_picture_buffer[frame_idx],
                    svt_picture_buffer_desc_ctor,
                    (EbPtr)&picture_buffer_desc_init_data);
@@ -1114,10 +1158,57 @@ EbErrorType init_tpl_buffers(EncodeContext *encode_context_ptr, PictureParentCon
     return EB_ErrorNone;
 }
 /************************************************
+* Post the SB rows of one picture of the window to the TPL stage
+************************************************/
+static void post_tpl_tasks(EbFifo *tpl_tasks_fifo_ptr, PictureParentControlSet *pcs_ptr,
+                           int32_t frame_idx, uint8_t synthesizer, uint32_t sb_row_count) {
+    svt_atomic_store_u32(&pcs_ptr->tpl_rows_done, 0);
+    svt_atomic_store_u32(&pcs_ptr->tpl_frame_done, 0);
+    for (uint32_t sb_row = 0; sb_row < sb_row_count; sb_row++) {
+        EbObjectWrapper *tpl_tasks_wrapper_ptr;
+        svt_get_empty_object(tpl_tasks_fifo_ptr, &tpl_tasks_wrapper_ptr);
+        TplTasks *tpl_tasks_ptr     = (TplTasks *)tpl_tasks_wrapper_ptr->object_ptr;
+        tpl_tasks_ptr->pcs_ptr      = pcs_ptr;
+        tpl_tasks_ptr->frame_idx    = frame_idx;
+        tpl_tasks_ptr->sb_row_index = sb_row;
+        tpl_tasks_ptr->sb_row_count = sb_row_count;
+        tpl_tasks_ptr->synthesizer  = synthesizer;
+        svt_post_full_object(tpl_tasks_wrapper_ptr);
+    }
+}
+/************************************************
+* A picture of the window can be dispensed once the pictures of the
+* window it predicts from have their recon
+************************************************/
+static EbBool tpl_refs_dispensed(EncodeContext *           encode_context_ptr,
+                                 PictureParentControlSet *pcs_ptr, int32_t frame_idx,
+                                 const EbBool *dispensed) {
+    for (uint32_t list_index = 0; list_index < MAX_NUM_OF_REF_PIC_LIST; list_index++) {
+        const uint8_t ref_count = list_index == REF_LIST_0 ? pcs_ptr->tpl_data.tpl_ref0_count
+                                                           : pcs_ptr->tpl_data.tpl_ref1_count;
+        for (uint8_t ref_idx = 0; ref_idx < ref_count; ref_idx++) {
+            if (!pcs_ptr->tpl_data.ref_in_slide_window[list_index][ref_idx])
+                continue;
+            const uint64_t ref_poc =
+                pcs_ptr->tpl_data.tpl_ref_ds_ptr_array[list_index][ref_idx].picture_number;
+            // The window is in decode order, references come first
+            for (int32_t ref_frame_idx = 0; ref_frame_idx < frame_idx; ref_frame_idx++)
+                if (encode_context_ptr->poc_map_idx[ref_frame_idx] == ref_poc &&
+                    !dispensed[ref_frame_idx])
+                    return EB_FALSE;
+        }
+    }
+    return EB_TRUE;
+}
+/************************************************
 * Genrate TPL MC Flow Based on frames in the tpl group
+* The SB rows of the pictures are processed on the TPL stage: the
+* dispenser runs every picture whose references are reconstructed in
+* parallel, the synthesizer goes through the pictures backwards one at a
+* time as each one propagates into its references.
 ************************************************/
 EbErrorType tpl_mc_flow(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
-                        PictureParentControlSet *pcs_ptr) {
+                        PictureParentControlSet *pcs_ptr, EbFifo *tpl_tasks_fifo_ptr) {
     PictureParentControlSet *pcs_array[MAX_TPL_LA_SW] = {
         NULL,
     };
@@ -1147,7 +1238,11 @@ EbErrorType tpl_mc_flow(EncodeContext *encode_context_ptr, SequenceControlSet *s
     init_tpl_buffers(encode_context_ptr, pcs_ptr, pcs_array);
 
     if (pcs_array[0]->tpl_data.tpl_temporal_layer_index == 0) {
-        uint8_t tpl_on;
+        uint8_t  tpl_on[MAX_TPL_LA_SW];
+        EbBool   posted[MAX_TPL_LA_SW]    = {EB_FALSE};
+        EbBool   dispensed[MAX_TPL_LA_SW] = {EB_FALSE};
+        uint32_t dispense_count           = 0;
+        uint32_t dispensed_count          = 0;
         encode_context_ptr->poc_map_idx[0] = pcs_array[0]->picture_number;
         for (frame_idx = 0; frame_idx < frames_in_sw; frame_idx++) {
             encode_context_ptr->poc_map_idx[frame_idx] = pcs_array[frame_idx]->picture_number;
@@ -1156,36 +1251,70 @@ EbErrorType tpl_mc_flow(EncodeContext *encode_context_ptr, SequenceControlSet *s
                        0,
                        (picture_width_in_mb << shift) * sizeof(TplStats));
             }
-            tpl_on = !(pcs_array[0]->tpl_data.tpl_ctrls.disable_tpl_nref);
-            tpl_on = (pcs_array[0]->slice_type == I_SLICE) ? 1 : tpl_on;
-            if (tpl_on == 0) {
-                tpl_on = pcs_array[frame_idx]->tpl_data.is_used_as_reference_flag ? 1
+            tpl_on[frame_idx] = !(pcs_array[0]->tpl_data.tpl_ctrls.disable_tpl_nref);
+            tpl_on[frame_idx] = (pcs_array[0]->slice_type == I_SLICE) ? 1 : tpl_on[frame_idx];
+            if (tpl_on[frame_idx] == 0) {
+                tpl_on[frame_idx] = pcs_array[frame_idx]->tpl_data.is_used_as_reference_flag ? 1
                     : (ABS((int64_t)pcs_array[0]->picture_number -
                            (int64_t)pcs_array[frame_idx]->picture_number) <=
                        pcs_array[0]->tpl_data.tpl_ctrls.disable_tpl_pic_dist)
                     ? 1
-                    : tpl_on;
+                    : tpl_on[frame_idx];
             }
-            if (tpl_on)
-                tpl_mc_flow_dispenser(encode_context_ptr, scs_ptr, pcs_array[frame_idx], frame_idx);
+            if (tpl_on[frame_idx]) {
+                pcs_array[frame_idx]->base_rdmult = svt_av1_compute_rd_mult_based_on_qindex(
+                                                        (AomBitDepth)8,
+                                                        get_tpl_qindex(scs_ptr,
+                                                                       pcs_array[frame_idx])) /
+                    6;
+                dispense_count++;
+            } else
+                dispensed[frame_idx] = EB_TRUE;
 
             pcs_array[frame_idx]->num_tpl_processed++;
         }
 
+        // dispenser
+        const uint32_t pic_width_in_sb = (scs_ptr->seq_header.max_frame_width + scs_ptr->sb_sz -
+                                          1) /
+            scs_ptr->sb_sz;
+        while (dispensed_count < dispense_count) {
+            // The first picture not yet dispensed always has its references, so one is in flight
+            for (frame_idx = 0; frame_idx < frames_in_sw; frame_idx++) {
+                if (posted[frame_idx] || dispensed[frame_idx] ||
+                    !tpl_refs_dispensed(
+                        encode_context_ptr, pcs_array[frame_idx], frame_idx, dispensed))
+                    continue;
+                post_tpl_tasks(tpl_tasks_fifo_ptr,
+                               pcs_array[frame_idx],
+                               frame_idx,
+                               0,
+                               (pcs_array[frame_idx]->sb_total_count + pic_width_in_sb - 1) /
+                                   pic_width_in_sb);
+                posted[frame_idx] = EB_TRUE;
+            }
+            svt_block_on_semaphore(encode_context_ptr->tpl_done_semaphore);
+            dispensed_count++;
+            for (frame_idx = 0; frame_idx < frames_in_sw; frame_idx++)
+                if (posted[frame_idx] && !dispensed[frame_idx] &&
+                    svt_atomic_load_u32(&pcs_array[frame_idx]->tpl_frame_done))
+                    dispensed[frame_idx] = EB_TRUE;
+        }
+
         // synthesizer
+        for (frame_idx = 0; frame_idx < frames_in_sw; frame_idx++)
+            encode_context_ptr->tpl_pcs_array[frame_idx] = pcs_array[frame_idx];
+        encode_context_ptr->tpl_frames_in_sw = (uint8_t)frames_in_sw;
         for (frame_idx = frames_in_sw - 1; frame_idx >= 0; frame_idx--) {
-            tpl_on = !(pcs_array[0]->tpl_data.tpl_ctrls.disable_tpl_nref);
-            tpl_on = (pcs_array[0]->slice_type == I_SLICE) ? 1 : tpl_on;
-            if (tpl_on == 0) {
-                tpl_on = pcs_array[frame_idx]->tpl_data.is_used_as_reference_flag ? 1
-                    : (ABS((int64_t)pcs_array[0]->picture_number -
-                           (int64_t)pcs_array[frame_idx]->picture_number) <=
-                       pcs_array[0]->tpl_data.tpl_ctrls.disable_tpl_pic_dist)
-                    ? 1
-                    : tpl_on;
+            if (tpl_on[frame_idx]) {
+                post_tpl_tasks(tpl_tasks_fifo_ptr,
+                               pcs_array[frame_idx],
+                               frame_idx,
+                               1,
+                               (pcs_array[frame_idx]->av1_cm->mi_rows + TPL_SB_ROW_MI_HEIGHT - 1) /
+                                   TPL_SB_ROW_MI_HEIGHT);
+                svt_block_on_semaphore(encode_context_ptr->tpl_done_semaphore);
             }
-            if (tpl_on)
-                tpl_mc_flow_synthesizer(pcs_array, frame_idx, frames_in_sw);
         }
 
         // generate tpl stats
@@ -1315,6 +1444,7 @@ typedef struct HighLevelRateControlContext {
 typedef struct RateControlContext {
     EbFifo *rate_control_input_tasks_fifo_ptr;
     EbFifo *rate_control_output_results_fifo_ptr;
+    EbFifo *tpl_tasks_output_fifo_ptr;
 
     HighLevelRateControlContext *high_level_rate_control_ptr;
 
@@ -1363,6 +1493,11 @@ typedef struct RateControlContext {
 
     uint32_t qp_scaling_map[EB_MAX_TEMPORAL_LAYERS][MAX_REF_QP_NUM];
     uint32_t qp_scaling_map_i_slice[MAX_REF_QP_NUM];
+
+    // VBV buffer size of the budgets, set with the target bitrate of the high level context
+    uint32_t vbv_bufsize;
+    // First picture planned with the current budgets
+    uint64_t bit_budget_picture_number;
 } RateControlContext;
 
 // calculate the QP based on the QP scaling
@@ -1590,13 +1725,6 @@ static void rate_control_context_dctor(EbPtr p) {
 
 EbErrorType rate_control_context_ctor(EbThreadContext *  thread_context_ptr,
                                       const EbEncHandle *enc_handle_ptr) {
-    uint32_t interval_index;
-
-#if OVERSHOOT_STAT_PRINT
-    uint32_t picture_index;
-#endif
-    int32_t intra_period = enc_handle_ptr->scs_instance_array[0]->scs_ptr->intra_period_length;
-
     RateControlContext *context_ptr;
     EB_CALLOC_ARRAY(context_ptr, 1);
     thread_context_ptr->priv  = context_ptr;
@@ -1606,6 +1734,45 @@ EbErrorType rate_control_context_ctor(EbThreadContext *  thread_context_ptr,
         enc_handle_ptr->rate_control_tasks_resource_ptr, 0);
     context_ptr->rate_control_output_results_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->rate_control_results_resource_ptr, 0);
+    // TPL of the in-loop ME path, after the source based operations producers
+    if (enc_handle_ptr->tpl_tasks_resource_ptr) {
+        const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+        context_ptr->tpl_tasks_output_fifo_ptr = svt_system_resource_get_producer_fifo(
+            enc_handle_ptr->tpl_tasks_resource_ptr,
+            scs_ptr->source_based_operations_process_init_count);
+    }
+
+    return rate_control_context_reset(thread_context_ptr, enc_handle_ptr);
+}
+
+/************************************************
+ * Rate Control Context Reset
+ *   Rebuilds the rate control state for a new stream,
+ *   the fifos of the context are kept
+ ************************************************/
+EbErrorType rate_control_context_reset(EbThreadContext *  thread_context_ptr,
+                                       const EbEncHandle *enc_handle_ptr) {
+    uint32_t interval_index;
+
+#if OVERSHOOT_STAT_PRINT
+    uint32_t picture_index;
+#endif
+    int32_t intra_period = enc_handle_ptr->scs_instance_array[0]->scs_ptr->intra_period_length;
+
+    RateControlContext *context_ptr     = (RateControlContext *)thread_context_ptr->priv;
+    EbFifo *            input_fifo_ptr  = context_ptr->rate_control_input_tasks_fifo_ptr;
+    EbFifo *            output_fifo_ptr = context_ptr->rate_control_output_results_fifo_ptr;
+    EbFifo *            tpl_fifo_ptr    = context_ptr->tpl_tasks_output_fifo_ptr;
+
+#if OVERSHOOT_STAT_PRINT
+    EB_DELETE_PTR_ARRAY(context_ptr->coded_frames_stat_queue, CODED_FRAMES_STAT_QUEUE_MAX_DEPTH);
+#endif
+    EB_DELETE_PTR_ARRAY(context_ptr->rate_control_param_queue, PARALLEL_GOP_MAX_NUMBER);
+    EB_DELETE(context_ptr->high_level_rate_control_ptr);
+    memset(context_ptr, 0, sizeof(*context_ptr));
+    context_ptr->rate_control_input_tasks_fifo_ptr    = input_fifo_ptr;
+    context_ptr->rate_control_output_results_fifo_ptr = output_fifo_ptr;
+    context_ptr->tpl_tasks_output_fifo_ptr            = tpl_fifo_ptr;
 
     // High level RC
     EB_NEW(context_ptr->high_level_rate_control_ptr, high_level_rate_control_context_ctor);
@@ -1761,8 +1928,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                 selected_ref_qp++;
             }
 
-            selected_ref_qp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                              scs_ptr->static_config.max_qp_allowed,
+            selected_ref_qp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                              pcs_ptr->max_qp_allowed,
                                               selected_ref_qp);
 
             int64_t queue_entry_index_head_temp = pcs_ptr->picture_number -
@@ -1788,8 +1955,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                 : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                   ->temporal_layer_index][selected_ref_qp];
 
-            ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                scs_ptr->static_config.max_qp_allowed,
+            ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                pcs_ptr->max_qp_allowed,
                                                 ref_qp_index_temp);
 
             hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] = 0;
@@ -1840,12 +2007,12 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
             // Loop over the QPs and find the best QP
             uint64_t min_la_bit_distance = MAX_UNSIGNED_VALUE;
             uint32_t qp_search_min       = (uint8_t)CLIP3(
-                scs_ptr->static_config.min_qp_allowed,
+                pcs_ptr->min_qp_allowed,
                 MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                 (uint32_t)MAX((int32_t)scs_ptr->static_config.qp - 40, 0));
 
             uint32_t qp_search_max = (uint8_t)CLIP3(
-                scs_ptr->static_config.min_qp_allowed,
+                pcs_ptr->min_qp_allowed,
                 MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                 scs_ptr->static_config.qp + 40);
 
@@ -1878,7 +2045,7 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
             while (ref_qp_table_index >= qp_search_min && ref_qp_table_index <= qp_search_max &&
                    !best_qp_found) {
                 uint32_t ref_qp_index = CLIP3(
-                    scs_ptr->static_config.min_qp_allowed,
+                    pcs_ptr->min_qp_allowed,
                     MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                     ref_qp_table_index);
                 high_level_rate_control_ptr->pred_bits_ref_qp_per_sw[ref_qp_index] = 0;
@@ -1922,8 +2089,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                         : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                           ->temporal_layer_index][ref_qp_index];
 
-                    ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                        scs_ptr->static_config.max_qp_allowed,
+                    ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                        pcs_ptr->max_qp_allowed,
                                                         ref_qp_index_temp);
 
                     hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] = 0;
@@ -2022,8 +2189,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                     : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                       ->temporal_layer_index][ref_qp_index];
 
-                ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                    scs_ptr->static_config.max_qp_allowed,
+                ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                    pcs_ptr->max_qp_allowed,
                                                     ref_qp_index_temp);
 
                 hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] =
@@ -2090,8 +2257,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
                         : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                           ->temporal_layer_index][selected_ref_qp];
 
-                    ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                        scs_ptr->static_config.max_qp_allowed,
+                    ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                        pcs_ptr->max_qp_allowed,
                                                         ref_qp_index_temp);
 
                     if (queue_entry_index_temp == queue_entry_index_head_temp)
@@ -2127,8 +2294,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
         if (expensive_i_slice) {
             selected_ref_qp = tables_updated ? (uint32_t)MAX((int32_t)selected_ref_qp - 1, 0)
                                              : (uint32_t)MAX((int32_t)selected_ref_qp - 3, 0);
-            selected_ref_qp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                              scs_ptr->static_config.max_qp_allowed,
+            selected_ref_qp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                              pcs_ptr->max_qp_allowed,
                                               selected_ref_qp);
         }
         // Set the QP
@@ -2146,8 +2313,8 @@ void high_level_rc_input_picture_vbr(PictureParentControlSet *pcs_ptr, SequenceC
             ? (uint8_t)context_ptr->qp_scaling_map_i_slice[selected_ref_qp]
             : (uint8_t)context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index][selected_ref_qp];
 
-        pcs_ptr->best_pred_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                               scs_ptr->static_config.max_qp_allowed,
+        pcs_ptr->best_pred_qp = (uint8_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                               pcs_ptr->max_qp_allowed,
                                                pcs_ptr->best_pred_qp);
 
         if (pcs_ptr->picture_number == 0) {
@@ -2235,8 +2402,8 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
         if (scs_ptr->static_config.enable_qp_scaling_flag &&
             (pcs_ptr->picture_number != rate_control_param_ptr->first_poc)) {
             pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                (int32_t)scs_ptr->static_config.min_qp_allowed,
-                (int32_t)scs_ptr->static_config.max_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                 (int32_t)(
                     rate_control_param_ptr->intra_frames_qp +
                     context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index]
@@ -2383,8 +2550,8 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                     pcs_ptr->picture_qp = (uint8_t)MAX(
                         (int32_t)pcs_ptr->picture_qp - (int32_t)THRESHOLD2QPINCREASE, 0);
             }
-            pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                 scs_ptr->static_config.max_qp_allowed,
+            pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                 pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                  pcs_ptr->picture_qp);
         } else {
             // SB Loop
@@ -2433,8 +2600,8 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                 pcs_ptr->parent_pcs_ptr->calculated_qp = pcs_ptr->picture_qp;
             }
 
-            pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                 scs_ptr->static_config.max_qp_allowed,
+            pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                 pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                  pcs_ptr->picture_qp);
 
             temp_qp = pcs_ptr->picture_qp;
@@ -2526,8 +2693,8 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
                     ->qp_scaling_map_i_slice[rate_control_param_ptr->intra_frames_qp_bef_scal]);
         if (!rate_control_layer_ptr->feedback_arrived && pcs_ptr->slice_type != I_SLICE) {
             pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                (int32_t)scs_ptr->static_config.min_qp_allowed,
-                (int32_t)scs_ptr->static_config.max_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                 (int32_t)(
                     rate_control_param_ptr->intra_frames_qp +
                     context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index]
@@ -2625,8 +2792,8 @@ void frame_level_rc_input_picture_vbr(PictureControlSet *pcs_ptr, SequenceContro
             //(uint8_t)CLIP3((uint32_t)ref_qp - 1, pcs_ptr->picture_qp, pcs_ptr->picture_qp);
         }
         // limiting the QP between min Qp allowed and max Qp allowed
-        pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                             scs_ptr->static_config.max_qp_allowed,
+        pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                             pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                              pcs_ptr->picture_qp);
 
         rate_control_layer_ptr->delta_qp_fraction = CLIP3(
@@ -2782,7 +2949,8 @@ void frame_level_rc_feedback_picture_vbr(PictureParentControlSet *parentpicture_
             rate_control_layer_ptr->previous_frame_qp;
         previous_frame_ec_bits += rate_control_layer_ptr->previous_frame_bit_actual;
         if (rate_control_layer_ptr->same_distortion_count == 0 ||
-            parentpicture_control_set_ptr->picture_qp != scs_ptr->static_config.min_qp_allowed) {
+            parentpicture_control_set_ptr->picture_qp !=
+                parentpicture_control_set_ptr->min_qp_allowed) {
             picture_min_qp_allowed = EB_FALSE;
         }
         if (picture_min_qp_allowed)
@@ -3283,8 +3451,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                 selected_ref_qp++;
             }
 
-            selected_ref_qp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                              scs_ptr->static_config.max_qp_allowed,
+            selected_ref_qp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                              pcs_ptr->max_qp_allowed,
                                               selected_ref_qp);
 
             int64_t queue_entry_index_head_temp = pcs_ptr->picture_number -
@@ -3311,8 +3479,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                 : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                   ->temporal_layer_index][selected_ref_qp];
 
-            ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                scs_ptr->static_config.max_qp_allowed,
+            ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                pcs_ptr->max_qp_allowed,
                                                 ref_qp_index_temp);
 
             hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] = 0;
@@ -3363,12 +3531,12 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
             // Loop over the QPs and find the best QP
             uint64_t min_la_bit_distance = MAX_UNSIGNED_VALUE;
             uint32_t qp_search_min       = (uint8_t)CLIP3(
-                scs_ptr->static_config.min_qp_allowed,
+                pcs_ptr->min_qp_allowed,
                 MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                 (uint32_t)MAX((int32_t)scs_ptr->static_config.qp - 40, 0));
 
             uint32_t qp_search_max = (uint8_t)CLIP3(
-                scs_ptr->static_config.min_qp_allowed,
+                pcs_ptr->min_qp_allowed,
                 MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                 scs_ptr->static_config.qp + 40);
 
@@ -3404,7 +3572,7 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                 EbBool best_qp_found = EB_FALSE;
                 while (ref_qp_table_index >= qp_search_min && ref_qp_table_index <= qp_search_max &&
                        !best_qp_found) {
-                    ref_qp_index = CLIP3(scs_ptr->static_config.min_qp_allowed,
+                    ref_qp_index = CLIP3(pcs_ptr->min_qp_allowed,
                                          MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                                          ref_qp_table_index);
                     high_level_rate_control_ptr->pred_bits_ref_qp_per_sw[ref_qp_index] = 0;
@@ -3449,8 +3617,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                             : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                               ->temporal_layer_index][ref_qp_index];
 
-                        ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                            scs_ptr->static_config.max_qp_allowed,
+                        ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                            pcs_ptr->max_qp_allowed,
                                                             ref_qp_index_temp);
 
                         hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] = 0;
@@ -3500,7 +3668,7 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                     ref_qp_table_index    = (uint32_t)(ref_qp_table_index + qp_step);
                 }
 
-                if (ref_qp_index == scs_ptr->static_config.max_qp_allowed &&
+                if (ref_qp_index == pcs_ptr->max_qp_allowed &&
                     high_level_rate_control_ptr->pred_bits_ref_qp_per_sw[ref_qp_index] >
                         bit_constraint_per_sw) {
                     delta_qp =
@@ -3561,8 +3729,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                     : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                       ->temporal_layer_index][ref_qp_index];
 
-                ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                    scs_ptr->static_config.max_qp_allowed,
+                ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                    pcs_ptr->max_qp_allowed,
                                                     ref_qp_index_temp);
 
                 hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] =
@@ -3628,8 +3796,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
                         : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                           ->temporal_layer_index][selected_ref_qp];
 
-                    ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                        scs_ptr->static_config.max_qp_allowed,
+                    ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                                        pcs_ptr->max_qp_allowed,
                                                         ref_qp_index_temp);
 
                     pcs_ptr->total_bits_per_gop +=
@@ -3672,8 +3840,8 @@ void high_level_rc_input_picture_cvbr(PictureParentControlSet *pcs_ptr, Sequence
             : (uint8_t)context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index][selected_ref_qp];
 
         pcs_ptr->target_bits_best_pred_qp = pcs_ptr->pred_bits_ref_qp[pcs_ptr->best_pred_qp];
-        pcs_ptr->best_pred_qp             = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                               scs_ptr->static_config.max_qp_allowed,
+        pcs_ptr->best_pred_qp             = (uint8_t)CLIP3(pcs_ptr->min_qp_allowed,
+                                               pcs_ptr->max_qp_allowed,
                                                (uint8_t)((int)pcs_ptr->best_pred_qp + delta_qp));
 
         if (pcs_ptr->picture_number == 0) {
@@ -3758,8 +3926,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
         if (scs_ptr->static_config.enable_qp_scaling_flag &&
             (pcs_ptr->picture_number != rate_control_param_ptr->first_poc)) {
             pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                (int32_t)scs_ptr->static_config.min_qp_allowed,
-                (int32_t)scs_ptr->static_config.max_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                 (int32_t)(
                     rate_control_param_ptr->intra_frames_qp +
                     context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index]
@@ -3807,8 +3975,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                 pcs_ptr->parent_pcs_ptr->calculated_qp = pcs_ptr->picture_qp;
             }
 
-            pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                 scs_ptr->static_config.max_qp_allowed,
+            pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                 pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                  pcs_ptr->picture_qp);
         } else {
             // SB Loop
@@ -3863,12 +4031,13 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
 
         // Loop over the QPs and find the best QP
         min_la_bit_distance = MAX_UNSIGNED_VALUE;
-        qp_search_min       = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
+        qp_search_min       = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
                                        MAX_REF_QP_NUM, //scs_ptr->static_config.max_qp_allowed,
                                        (uint32_t)MAX((int32_t)scs_ptr->static_config.qp - 40, 0));
 
-        qp_search_max = (uint8_t)CLIP3(
-            scs_ptr->static_config.min_qp_allowed, MAX_REF_QP_NUM, scs_ptr->static_config.qp + 40);
+        qp_search_max = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                       MAX_REF_QP_NUM,
+                                       scs_ptr->static_config.qp + 40);
         uint32_t ref_qp_table_index;
         for (ref_qp_table_index = qp_search_min; ref_qp_table_index < qp_search_max;
              ref_qp_table_index++)
@@ -3906,7 +4075,7 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
         while (ref_qp_table_index >= qp_search_min && ref_qp_table_index <= qp_search_max &&
                !best_qp_found) {
             ref_qp_index = CLIP3(
-                scs_ptr->static_config.min_qp_allowed, MAX_REF_QP_NUM - 1, ref_qp_table_index);
+                pcs_ptr->parent_pcs_ptr->min_qp_allowed, MAX_REF_QP_NUM - 1, ref_qp_table_index);
             high_level_rate_control_ptr->pred_bits_ref_qp_per_sw[ref_qp_index] = 0;
 
             uint32_t queue_entry_index_temp = (uint32_t)queue_entry_index_head_temp;
@@ -3934,8 +4103,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                     : context_ptr->qp_scaling_map[hl_rate_control_histogram_ptr_temp
                                                       ->temporal_layer_index][ref_qp_index];
 
-                ref_qp_index_temp = (uint32_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                    scs_ptr->static_config.max_qp_allowed,
+                ref_qp_index_temp = (uint32_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                    pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                     ref_qp_index_temp);
 
                 hl_rate_control_histogram_ptr_temp->pred_bits_ref_qp[ref_qp_index_temp] = 0;
@@ -3984,7 +4153,7 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
         }
 
         int delta_qp = 0;
-        if (ref_qp_index == scs_ptr->static_config.max_qp_allowed &&
+        if (ref_qp_index == pcs_ptr->parent_pcs_ptr->max_qp_allowed &&
             high_level_rate_control_ptr->pred_bits_ref_qp_per_sw[ref_qp_index] >
                 bit_constraint_per_sw) {
             delta_qp =
@@ -4005,8 +4174,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                     context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index][selected_ref_qp];
 
         pcs_ptr->parent_pcs_ptr->best_pred_qp = (uint8_t)CLIP3(
-            scs_ptr->static_config.min_qp_allowed,
-            scs_ptr->static_config.max_qp_allowed,
+            pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+            pcs_ptr->parent_pcs_ptr->max_qp_allowed,
             (uint8_t)((int)pcs_ptr->parent_pcs_ptr->best_pred_qp + delta_qp));
 
         // if the pixture is an I slice, for now we set the QP as the QP of the previous frame
@@ -4018,8 +4187,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                 pcs_ptr->parent_pcs_ptr->calculated_qp = pcs_ptr->picture_qp;
             }
 
-            pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                 scs_ptr->static_config.max_qp_allowed,
+            pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                 pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                  pcs_ptr->picture_qp);
 
             temp_qp = pcs_ptr->picture_qp;
@@ -4114,8 +4283,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
                     ->qp_scaling_map_i_slice[rate_control_param_ptr->intra_frames_qp_bef_scal]);
         if (!rate_control_layer_ptr->feedback_arrived && pcs_ptr->slice_type != I_SLICE) {
             pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                (int32_t)scs_ptr->static_config.min_qp_allowed,
-                (int32_t)scs_ptr->static_config.max_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                 (int32_t)(
                     rate_control_param_ptr->intra_frames_qp +
                     context_ptr->qp_scaling_map[pcs_ptr->temporal_layer_index]
@@ -4204,8 +4373,8 @@ void frame_level_rc_input_picture_cvbr(PictureControlSet *pcs_ptr, SequenceContr
             //(uint8_t)CLIP3((uint32_t)ref_qp - 1, pcs_ptr->picture_qp, pcs_ptr->picture_qp);
         }
         // limiting the QP between min Qp allowed and max Qp allowed
-        pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                             scs_ptr->static_config.max_qp_allowed,
+        pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                             pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                              pcs_ptr->picture_qp);
 
         rate_control_layer_ptr->delta_qp_fraction = CLIP3(
@@ -4361,7 +4530,8 @@ void frame_level_rc_feedback_picture_cvbr(PictureParentControlSet *parentpicture
             rate_control_layer_ptr->previous_frame_qp;
         previous_frame_ec_bits += rate_control_layer_ptr->previous_frame_bit_actual;
         if (rate_control_layer_ptr->same_distortion_count == 0 ||
-            parentpicture_control_set_ptr->picture_qp != scs_ptr->static_config.min_qp_allowed) {
+            parentpicture_control_set_ptr->picture_qp !=
+                parentpicture_control_set_ptr->min_qp_allowed) {
             picture_min_qp_allowed = EB_FALSE;
         }
         if (picture_min_qp_allowed)
@@ -4718,28 +4888,113 @@ void rate_control_refinement(PictureControlSet *pcs_ptr, SequenceControlSet *scs
         }
     }
 }
-// initialize the rate control parameter at the beginning
-void init_rc(RateControlContext *context_ptr, PictureControlSet *pcs_ptr,
-             SequenceControlSet *scs_ptr) {
-    context_ptr->high_level_rate_control_ptr->target_bit_rate =
-        scs_ptr->static_config.target_bit_rate;
-    context_ptr->high_level_rate_control_ptr->frame_rate                 = scs_ptr->frame_rate;
-    context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_frame = (uint64_t)MAX(
+// Derive the bit budgets of the high level rate control and the size of the virtual buffer
+// from the target bitrate and the VBV buffer size of the picture
+static void set_rc_bit_budget(RateControlContext *context_ptr, PictureParentControlSet *ppcs_ptr,
+                              SequenceControlSet *scs_ptr) {
+    HighLevelRateControlContext *high_level_rate_control_ptr =
+        context_ptr->high_level_rate_control_ptr;
+
+    high_level_rate_control_ptr->target_bit_rate            = ppcs_ptr->target_bit_rate;
+    high_level_rate_control_ptr->frame_rate                 = scs_ptr->frame_rate;
+    high_level_rate_control_ptr->channel_bit_rate_per_frame = (uint64_t)MAX(
         (int64_t)1,
-        (int64_t)((context_ptr->high_level_rate_control_ptr->target_bit_rate << RC_PRECISION) /
-                  context_ptr->high_level_rate_control_ptr->frame_rate));
+        (int64_t)((high_level_rate_control_ptr->target_bit_rate << RC_PRECISION) /
+                  high_level_rate_control_ptr->frame_rate));
 
-    context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_sw =
-        context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_frame *
+    high_level_rate_control_ptr->channel_bit_rate_per_sw =
+        high_level_rate_control_ptr->channel_bit_rate_per_frame *
         (scs_ptr->static_config.look_ahead_distance + 1);
-    context_ptr->high_level_rate_control_ptr->bit_constraint_per_sw =
-        context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_sw;
-    context_ptr->high_level_rate_control_ptr->previous_updated_bit_constraint_per_sw =
-        context_ptr->high_level_rate_control_ptr->channel_bit_rate_per_sw;
+    high_level_rate_control_ptr->bit_constraint_per_sw =
+        high_level_rate_control_ptr->channel_bit_rate_per_sw;
+    high_level_rate_control_ptr->previous_updated_bit_constraint_per_sw =
+        high_level_rate_control_ptr->channel_bit_rate_per_sw;
+
+    context_ptr->frame_rate  = scs_ptr->frame_rate;
+    context_ptr->vbv_bufsize = ppcs_ptr->vbv_bufsize;
+    if (scs_ptr->static_config.rate_control_mode == 1) { // VBR
+        context_ptr->virtual_buffer_size = (((uint64_t)ppcs_ptr->target_bit_rate * 3)
+                                            << RC_PRECISION) /
+            (context_ptr->frame_rate);
+        context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
+        context_ptr->vb_fill_threshold1 = (context_ptr->virtual_buffer_size * 6) >> 3;
+        context_ptr->vb_fill_threshold2 = (context_ptr->virtual_buffer_size << 3) >> 3;
+    } else if (scs_ptr->static_config.rate_control_mode == 2) {
+        if (ppcs_ptr->vbv_bufsize > 0)
+            context_ptr->virtual_buffer_size = ((uint64_t)ppcs_ptr->vbv_bufsize); // vbv_buf_size);
+        else
+            context_ptr->virtual_buffer_size =
+                ((uint64_t)ppcs_ptr->target_bit_rate); // vbv_buf_size);
+        context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
+        context_ptr->vb_fill_threshold1 = context_ptr->virtual_buffer_level_initial_value +
+            (context_ptr->virtual_buffer_size / 4);
+        context_ptr->vb_fill_threshold2 = context_ptr->virtual_buffer_level_initial_value +
+            (context_ptr->virtual_buffer_size / 3);
+    }
+}
+
+static int64_t scale_rc_budget(int64_t budget, uint64_t size, uint64_t prev_size) {
+    return prev_size ? budget * (int64_t)size / (int64_t)prev_size : budget;
+}
+
+// Move to the targets given to svt_av1_enc_update_rate_control(), which come with the first
+// picture of a mini-GOP. The virtual buffers keep their fullness, and the budgets of the
+// temporal layers follow the new bitrate.
+static void update_rc_bit_budget(RateControlContext *context_ptr, PictureParentControlSet *ppcs_ptr,
+                                 SequenceControlSet *scs_ptr) {
+    const uint64_t prev_bit_rate    = context_ptr->high_level_rate_control_ptr->target_bit_rate;
+    const uint64_t prev_buffer_size = context_ptr->virtual_buffer_size;
+    set_rc_bit_budget(context_ptr, ppcs_ptr, scs_ptr);
+    const uint64_t bit_rate    = context_ptr->high_level_rate_control_ptr->target_bit_rate;
+    const uint64_t buffer_size = context_ptr->virtual_buffer_size;
+    context_ptr->bit_budget_picture_number = ppcs_ptr->picture_number;
+
+    context_ptr->virtual_buffer_level = scale_rc_budget(
+        context_ptr->virtual_buffer_level, buffer_size, prev_buffer_size);
+    context_ptr->previous_virtual_buffer_level = scale_rc_budget(
+        context_ptr->previous_virtual_buffer_level, buffer_size, prev_buffer_size);
+    context_ptr->extra_bits = scale_rc_budget(
+        context_ptr->extra_bits, buffer_size, prev_buffer_size);
+    context_ptr->extra_bits_gen = scale_rc_budget(
+        context_ptr->extra_bits_gen, buffer_size, prev_buffer_size);
+
+    for (uint32_t interval_index = 0; interval_index < PARALLEL_GOP_MAX_NUMBER; interval_index++) {
+        RateControlIntervalParamContext *rate_control_param_ptr =
+            context_ptr->rate_control_param_queue[interval_index];
+        rate_control_param_ptr->virtual_buffer_level = scale_rc_budget(
+            rate_control_param_ptr->virtual_buffer_level, buffer_size, prev_buffer_size);
+        rate_control_param_ptr->previous_virtual_buffer_level = scale_rc_budget(
+            rate_control_param_ptr->previous_virtual_buffer_level, buffer_size, prev_buffer_size);
+
+        for (uint32_t temporal_index = 0; temporal_index < EB_MAX_TEMPORAL_LAYERS;
+             temporal_index++) {
+            RateControlLayerContext *rate_control_layer_ptr =
+                rate_control_param_ptr->rate_control_layer_array[temporal_index];
+            rate_control_layer_ptr->target_bit_rate = (uint64_t)scale_rc_budget(
+                (int64_t)rate_control_layer_ptr->target_bit_rate, bit_rate, prev_bit_rate);
+            rate_control_layer_ptr->channel_bit_rate = (uint64_t)MAX(
+                1,
+                scale_rc_budget(
+                    (int64_t)rate_control_layer_ptr->channel_bit_rate, bit_rate, prev_bit_rate));
+            rate_control_layer_ptr->previous_bit_constraint = (uint64_t)scale_rc_budget(
+                (int64_t)rate_control_layer_ptr->previous_bit_constraint, bit_rate, prev_bit_rate);
+            rate_control_layer_ptr->bit_constraint = (uint64_t)scale_rc_budget(
+                (int64_t)rate_control_layer_ptr->bit_constraint, bit_rate, prev_bit_rate);
+            rate_control_layer_ptr->ec_bit_constraint = (uint64_t)MAX(
+                1,
+                scale_rc_budget(
+                    (int64_t)rate_control_layer_ptr->ec_bit_constraint, bit_rate, prev_bit_rate));
+        }
+    }
+}
+
+// initialize the rate control parameter at the beginning
+void init_rc(RateControlContext *context_ptr, PictureControlSet *pcs_ptr,
+             SequenceControlSet *scs_ptr) {
+    set_rc_bit_budget(context_ptr, pcs_ptr->parent_pcs_ptr, scs_ptr);
 
     int32_t  total_frame_in_interval = scs_ptr->intra_period_length;
     uint32_t gop_period              = (1 << pcs_ptr->parent_pcs_ptr->hierarchical_levels);
-    context_ptr->frame_rate          = scs_ptr->frame_rate;
     while (total_frame_in_interval >= 0) {
         if (total_frame_in_interval % (gop_period) == 0)
             context_ptr->frames_in_interval[0]++;
@@ -4755,35 +5010,12 @@ void init_rc(RateControlContext *context_ptr, PictureControlSet *pcs_ptr,
             context_ptr->frames_in_interval[5]++;
         total_frame_in_interval--;
     }
-    if (scs_ptr->static_config.rate_control_mode == 1) { // VBR
-        context_ptr->virtual_buffer_size = (((uint64_t)scs_ptr->static_config.target_bit_rate * 3)
-                                            << RC_PRECISION) /
-            (context_ptr->frame_rate);
-        context_ptr->rate_average_periodin_frames =
-            (uint64_t)scs_ptr->static_config.intra_period_length + 1;
-        context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->virtual_buffer_level               = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->previous_virtual_buffer_level      = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->vb_fill_threshold1             = (context_ptr->virtual_buffer_size * 6) >> 3;
-        context_ptr->vb_fill_threshold2             = (context_ptr->virtual_buffer_size << 3) >> 3;
-        context_ptr->base_layer_frames_avg_qp       = scs_ptr->static_config.qp;
-        context_ptr->base_layer_intra_frames_avg_qp = scs_ptr->static_config.qp;
-    } else if (scs_ptr->static_config.rate_control_mode == 2) {
-        if (scs_ptr->static_config.vbv_bufsize > 0)
-            context_ptr->virtual_buffer_size =
-                ((uint64_t)scs_ptr->static_config.vbv_bufsize); // vbv_buf_size);
-        else
-            context_ptr->virtual_buffer_size =
-                ((uint64_t)scs_ptr->static_config.target_bit_rate); // vbv_buf_size);
+    if (scs_ptr->static_config.rate_control_mode) {
         context_ptr->rate_average_periodin_frames =
             (uint64_t)scs_ptr->static_config.intra_period_length + 1;
-        context_ptr->virtual_buffer_level_initial_value = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->virtual_buffer_level               = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->previous_virtual_buffer_level      = context_ptr->virtual_buffer_size >> 1;
-        context_ptr->vb_fill_threshold1 = context_ptr->virtual_buffer_level_initial_value +
-            (context_ptr->virtual_buffer_size / 4);
-        context_ptr->vb_fill_threshold2 = context_ptr->virtual_buffer_level_initial_value +
-            (context_ptr->virtual_buffer_size / 3);
+        context_ptr->virtual_buffer_level = context_ptr->virtual_buffer_level_initial_value;
+        context_ptr->previous_virtual_buffer_level =
+            context_ptr->virtual_buffer_level_initial_value;
         context_ptr->base_layer_frames_avg_qp       = scs_ptr->static_config.qp;
         context_ptr->base_layer_intra_frames_avg_qp = scs_ptr->static_config.qp;
     }
@@ -7159,8 +7391,8 @@ void recode_loop_update_q(PictureParentControlSet *ppcs_ptr, int *const loop, in
         *q = clamp(*q, *q_low, *q_high);
     }
 
-    *q    = (uint8_t)CLIP3((int32_t)quantizer_to_qindex[scs_ptr->static_config.min_qp_allowed],
-                        (int32_t)quantizer_to_qindex[scs_ptr->static_config.max_qp_allowed],
+    *q    = (uint8_t)CLIP3((int32_t)quantizer_to_qindex[ppcs_ptr->min_qp_allowed],
+                        (int32_t)quantizer_to_qindex[ppcs_ptr->max_qp_allowed],
                         *q);
     *loop = (*q != last_q);
 }
@@ -7228,7 +7460,10 @@ void *rate_control_kernel(void *input_ptr) {
 
                 if (/*scs_ptr->in_loop_me &&*/ scs_ptr->static_config.enable_tpl_la &&
                     pcs_ptr->temporal_layer_index == 0) {
-                    tpl_mc_flow(scs_ptr->encode_context_ptr, scs_ptr, pcs_ptr->parent_pcs_ptr);
+                    tpl_mc_flow(scs_ptr->encode_context_ptr,
+                                scs_ptr,
+                                pcs_ptr->parent_pcs_ptr,
+                                context_ptr->tpl_tasks_output_fifo_ptr);
                 }
 
             // Release the down scaled input
@@ -7240,6 +7475,14 @@ void *rate_control_kernel(void *input_ptr) {
             if (pcs_ptr->picture_number == 0) {
                 //init rate control parameters
                 init_rc(context_ptr, pcs_ptr, scs_ptr);
+            } else if (scs_ptr->static_config.rate_control_mode &&
+                       pcs_ptr->picture_number > context_ptr->bit_budget_picture_number &&
+                       (pcs_ptr->parent_pcs_ptr->target_bit_rate !=
+                            context_ptr->high_level_rate_control_ptr->target_bit_rate ||
+                        pcs_ptr->parent_pcs_ptr->vbv_bufsize != context_ptr->vbv_bufsize)) {
+                // The targets changed from this mini-GOP on, the pictures of the previous ones
+                // arriving late keep the budgets they were planned with
+                update_rc_bit_budget(context_ptr, pcs_ptr->parent_pcs_ptr, scs_ptr);
             }
             // SB Loop
             pcs_ptr->parent_pcs_ptr->sad_me = 0;
@@ -7348,20 +7591,20 @@ void *rate_control_kernel(void *input_ptr) {
                             (AomBitDepth)scs_ptr->static_config.encoder_bit_depth);
                     }
                     frm_hdr->quantization_params.base_q_idx = (uint8_t)CLIP3(
-                        (int32_t)quantizer_to_qindex[scs_ptr->static_config.min_qp_allowed],
-                        (int32_t)quantizer_to_qindex[scs_ptr->static_config.max_qp_allowed],
+                        (int32_t)quantizer_to_qindex[pcs_ptr->parent_pcs_ptr->min_qp_allowed],
+                        (int32_t)quantizer_to_qindex[pcs_ptr->parent_pcs_ptr->max_qp_allowed],
                         (int32_t)(new_qindex));
 
                     pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                        (int32_t)scs_ptr->static_config.min_qp_allowed,
-                        (int32_t)scs_ptr->static_config.max_qp_allowed,
+                        (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                        (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                         (frm_hdr->quantization_params.base_q_idx + 2) >> 2);
                 }
 
                 else if (pcs_ptr->parent_pcs_ptr->qp_on_the_fly == EB_TRUE) {
                     pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                        (int32_t)scs_ptr->static_config.min_qp_allowed,
-                        (int32_t)scs_ptr->static_config.max_qp_allowed,
+                        (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                        (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                         pcs_ptr->parent_pcs_ptr->picture_qp);
                     frm_hdr->quantization_params.base_q_idx =
                         quantizer_to_qindex[pcs_ptr->picture_qp];
@@ -7389,13 +7632,13 @@ void *rate_control_kernel(void *input_ptr) {
                         // VBR Qindex calculating
                         new_qindex                              = rc_pick_q_and_bounds(pcs_ptr);
                         frm_hdr->quantization_params.base_q_idx = (uint8_t)CLIP3(
-                            (int32_t)quantizer_to_qindex[scs_ptr->static_config.min_qp_allowed],
-                            (int32_t)quantizer_to_qindex[scs_ptr->static_config.max_qp_allowed],
+                            (int32_t)quantizer_to_qindex[pcs_ptr->parent_pcs_ptr->min_qp_allowed],
+                            (int32_t)quantizer_to_qindex[pcs_ptr->parent_pcs_ptr->max_qp_allowed],
                             (int32_t)(new_qindex));
 
                         pcs_ptr->picture_qp = (uint8_t)CLIP3(
-                            (int32_t)scs_ptr->static_config.min_qp_allowed,
-                            (int32_t)scs_ptr->static_config.max_qp_allowed,
+                            (int32_t)pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                            (int32_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                             (frm_hdr->quantization_params.base_q_idx + 2) >> 2);
 
                     } else {
@@ -7419,8 +7662,8 @@ void *rate_control_kernel(void *input_ptr) {
                                                       rate_control_layer_ptr,
                                                       rate_control_param_ptr);
                 }
-                pcs_ptr->picture_qp = (uint8_t)CLIP3(scs_ptr->static_config.min_qp_allowed,
-                                                     scs_ptr->static_config.max_qp_allowed,
+                pcs_ptr->picture_qp = (uint8_t)CLIP3(pcs_ptr->parent_pcs_ptr->min_qp_allowed,
+                                                     pcs_ptr->parent_pcs_ptr->max_qp_allowed,
                                                      pcs_ptr->picture_qp);
 
                 frm_hdr->quantization_params.base_q_idx = quantizer_to_qindex[pcs_ptr->picture_qp];
@@ -7449,9 +7692,9 @@ void *rate_control_kernel(void *input_ptr) {
                     rate_control_param_ptr->intra_frames_qp         = pcs_ptr->picture_qp;
                     rate_control_param_ptr->next_gop_intra_frame_qp = pcs_ptr->picture_qp;
                     rate_control_param_ptr->intra_frames_qp_bef_scal =
-                        (uint8_t)scs_ptr->static_config.max_qp_allowed;
-                    for (uint32_t qindex = scs_ptr->static_config.min_qp_allowed;
-                         qindex <= scs_ptr->static_config.max_qp_allowed;
+                        (uint8_t)pcs_ptr->parent_pcs_ptr->max_qp_allowed;
+                    for (uint32_t qindex = pcs_ptr->parent_pcs_ptr->min_qp_allowed;
+                         qindex <= pcs_ptr->parent_pcs_ptr->max_qp_allowed;
                          qindex++) {
                         if (rate_control_param_ptr->intra_frames_qp <=
                             context_ptr->qp_scaling_map_i_slice[qindex]) {
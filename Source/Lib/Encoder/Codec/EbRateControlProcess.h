@@ -291,6 +291,8 @@ double svt_av1_get_gfu_boost_projection_factor(double min_factor, double max_fac
 
 EbErrorType rate_control_context_ctor(EbThreadContext *  thread_context_ptr,
                                       const EbEncHandle *enc_handle_ptr);
+EbErrorType rate_control_context_reset(EbThreadContext *  thread_context_ptr,
+                                       const EbEncHandle *enc_handle_ptr);
 
 extern void *rate_control_kernel(void *input_ptr);
 
@@ -29,3 +29,20 @@ EbErrorType rate_control_tasks_creator(EbPtr *object_dbl_ptr, EbPtr object_init_
 
     return EB_ErrorNone;
 }
+
+EbErrorType tpl_tasks_ctor(TplTasks *context_ptr, EbPtr object_init_data_ptr) {
+    (void)context_ptr;
+    (void)object_init_data_ptr;
+
+    return EB_ErrorNone;
+}
+
+EbErrorType tpl_tasks_creator(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr) {
+    TplTasks *obj;
+
+    *object_dbl_ptr = NULL;
+    EB_NEW(obj, tpl_tasks_ctor, object_init_data_ptr);
+    *object_dbl_ptr = obj;
+
+    return EB_ErrorNone;
+}
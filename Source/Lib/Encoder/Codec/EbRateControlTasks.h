@@ -41,6 +41,18 @@ typedef struct RateControlTasks {
     uint32_t bit_count;
 } RateControlTasks;
 
+/**************************************
+ * TPL Tasks
+ **************************************/
+typedef struct TplTasks {
+    EbDctor                         dctor;
+    struct PictureParentControlSet *pcs_ptr;
+    int32_t                         frame_idx; // index of the picture in the TPL window
+    uint32_t                        sb_row_index;
+    uint32_t                        sb_row_count;
+    uint8_t                         synthesizer; // synthesizer row, dispenser row otherwise
+} TplTasks;
+
 typedef struct RateControlTasksInitData {
     int32_t junk;
 } RateControlTasksInitData;
@@ -49,5 +61,6 @@ typedef struct RateControlTasksInitData {
  * Extern Function Declarations
  **************************************/
 extern EbErrorType rate_control_tasks_creator(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr);
+extern EbErrorType tpl_tasks_creator(EbPtr *object_dbl_ptr, EbPtr object_init_data_ptr);
 
 #endif // EbRateControlTasks_h
@@ -313,6 +313,8 @@ EbErrorType svt_reference_object_creator(EbPtr *object_dbl_ptr, EbPtr object_ini
 
 static void svt_pa_reference_object_dctor(EbPtr p) {
     EbPaReferenceObject *obj = (EbPaReferenceObject *)p;
+    EB_DESTROY_MUTEX(obj->gm_corners_mutex);
+    free(obj->gm_corners);
     if (obj->dummy_obj)
         return;
     EB_DELETE(obj->input_padded_picture_ptr);
@@ -347,6 +349,7 @@ EbErrorType svt_pa_reference_object_ctor(EbPaReferenceObject *pa_ref_obj_,
     EbPaReferenceObjectDescInitData *pa_ref_init_data_ptr = (EbPaReferenceObjectDescInitData *)
         object_init_data_ptr;
     pa_ref_obj_->dummy_obj = pa_ref_init_data_ptr->empty_pa_buffers;
+    EB_CREATE_MUTEX(pa_ref_obj_->gm_corners_mutex);
     if (pa_ref_init_data_ptr->empty_pa_buffers)
         return EB_ErrorNone;
 
@@ -85,6 +85,15 @@ typedef struct EbPaReferenceObject {
 
     uint64_t picture_number;
     uint8_t  dummy_obj;
+    // FAST corners of one of the pictures above, kept for the global motion
+    // search of the pictures referencing it; gm_corners_buffer is the first
+    // luma sample of the picture, NULL when no corners are kept
+    EbHandle gm_corners_mutex;
+    uint8_t *gm_corners_buffer;
+    int32_t  gm_corners_width;
+    int32_t  gm_corners_height;
+    int32_t  gm_num_corners;
+    int *    gm_corners;
 } EbPaReferenceObject;
 
 typedef struct EbPaReferenceObjectDescInitData {
@@ -1020,7 +1020,7 @@ static void calc_superres_params(superres_params_type *spr_params, SequenceContr
 
 static EbErrorType downscaled_source_buffer_desc_ctor(
     EbPictureBufferDesc **picture_ptr, EbPictureBufferDesc *picture_ptr_for_reference,
-    superres_params_type spr_params) {
+    superres_params_type spr_params, const EbLargeAllocPolicy *alloc_policy) {
     EbPictureBufferDescInitData initData;
 
     initData.buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
@@ -1033,6 +1033,7 @@ static EbErrorType downscaled_source_buffer_desc_ctor(
     initData.right_padding      = picture_ptr_for_reference->origin_x;
     initData.top_padding        = picture_ptr_for_reference->origin_y;
     initData.bot_padding        = picture_ptr_for_reference->origin_y;
+    initData.alloc_policy       = *alloc_policy;
 
     EB_NEW(*picture_ptr, svt_picture_buffer_desc_ctor, (EbPtr)&initData);
 
@@ -1132,6 +1133,7 @@ static EbErrorType allocate_downscaled_reference_pics(
     ref_pic_buf_desc_init_data.top_padding   = PAD_VALUE;
     ref_pic_buf_desc_init_data.bot_padding   = PAD_VALUE;
     ref_pic_buf_desc_init_data.mfmv          = pcs_ptr->scs_ptr->mfmv_enabled;
+    ref_pic_buf_desc_init_data.alloc_policy  = pcs_ptr->scs_ptr->large_alloc_policy;
 
     if (ref_pic_buf_desc_init_data.bit_depth == EB_10BIT) {
         // Hsan: set split_mode to 0 to construct the packed reference buffer (used @ EP)
@@ -1166,7 +1168,7 @@ static EbErrorType allocate_downscaled_source_reference_pics(
     EbPictureBufferDesc **sixteenth_decimated_picture_ptr,
     EbPictureBufferDesc **sixteenth_filtered_picture_ptr,
     EbPictureBufferDesc *picture_ptr_for_reference, superres_params_type spr_params,
-    uint8_t down_sampling_method_me_search) {
+    uint8_t down_sampling_method_me_search, const EbLargeAllocPolicy *alloc_policy) {
     EbPictureBufferDescInitData initData;
 
     initData.buffer_enable_mask = PICTURE_BUFFER_DESC_LUMA_MASK;
@@ -1179,6 +1181,7 @@ static EbErrorType allocate_downscaled_source_reference_pics(
     initData.right_padding      = picture_ptr_for_reference->origin_x;
     initData.top_padding        = picture_ptr_for_reference->origin_y;
     initData.bot_padding        = picture_ptr_for_reference->origin_y;
+    initData.alloc_policy       = *alloc_policy;
 
     EB_NEW(*input_padded_picture_ptr, svt_picture_buffer_desc_ctor, (EbPtr)&initData);
 
@@ -1288,7 +1291,8 @@ void scale_source_references(SequenceControlSet *scs_ptr, PictureParentControlSe
                         &reference_object->downscaled_sixteenth_filtered_picture_ptr[denom_idx],
                         ref_pic_ptr,
                         spr_params,
-                        scs_ptr->down_sampling_method_me_search);
+                        scs_ptr->down_sampling_method_me_search,
+                        &scs_ptr->large_alloc_policy);
 
                     EbPictureBufferDesc *down_ref_pic_ptr =
                         reference_object->downscaled_input_padded_picture_ptr[denom_idx];
@@ -1354,7 +1358,8 @@ static void scale_input_references(PictureParentControlSet *pcs_ptr,
             &src_object->downscaled_sixteenth_filtered_picture_ptr[denom_idx],
             padded_pic_ptr,
             superres_params,
-            pcs_ptr->scs_ptr->down_sampling_method_me_search);
+            pcs_ptr->scs_ptr->down_sampling_method_me_search,
+            &pcs_ptr->scs_ptr->large_alloc_policy);
     }
 
     padded_pic_ptr = src_object->downscaled_input_padded_picture_ptr[denom_idx];
@@ -1579,8 +1584,10 @@ void init_resize_picture(SequenceControlSet *scs_ptr, PictureParentControlSet *p
         pcs_ptr->superres_denom = spr_params.superres_denom;
 
         // Allocate downsampled picture buffer descriptor
-        downscaled_source_buffer_desc_ctor(
-            &pcs_ptr->enhanced_downscaled_picture_ptr, input_picture_ptr, spr_params);
+        downscaled_source_buffer_desc_ctor(&pcs_ptr->enhanced_downscaled_picture_ptr,
+                                           input_picture_ptr,
+                                           spr_params,
+                                           &scs_ptr->large_alloc_policy);
 
         const int32_t  num_planes = av1_num_planes(&scs_ptr->seq_header.color_config);
         const uint32_t ss_x       = scs_ptr->subsampling_x;
@@ -61,6 +61,10 @@ typedef struct ResourceCoordinationContext {
     uint64_t first_in_pic_arrived_time_seconds;
     uint64_t first_in_pic_arrived_timeu_seconds;
     EbBool   start_flag;
+
+    // Stream state of the kernel
+    EbBool           end_of_sequence_flag;
+    EbObjectWrapper *prev_pcs_wrapper_ptr;
 } ResourceCoordinationContext;
 
 static void resource_coordination_context_dctor(EbPtr p) {
@@ -112,6 +116,27 @@ EbErrorType resource_coordination_context_ctor(EbThreadContext *thread_contxt_pt
 
     EB_CALLOC_ARRAY(context_ptr->picture_number_array, context_ptr->encode_instances_total_count);
 
+    resource_coordination_context_reset(thread_contxt_ptr);
+
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Resource Coordination Context Reset
+ *   Starts a new stream, the objects of the previous
+ *   one were given back to their pools
+ ************************************************/
+void resource_coordination_context_reset(EbThreadContext *thread_contxt_ptr) {
+    ResourceCoordinationContext *context_ptr =
+        (ResourceCoordinationContext *)thread_contxt_ptr->priv;
+
+    for (uint32_t i = 0; i < context_ptr->encode_instances_total_count; i++) {
+        context_ptr->sequence_control_set_active_array[i] = NULL;
+        context_ptr->picture_number_array[i]              = 0;
+    }
+    context_ptr->end_of_sequence_flag = EB_FALSE;
+    context_ptr->prev_pcs_wrapper_ptr = NULL;
+
     context_ptr->average_enc_mod                    = 0;
     context_ptr->prev_enc_mod                       = 0;
     context_ptr->prev_enc_mode_delta                = 0;
@@ -130,8 +155,6 @@ EbErrorType resource_coordination_context_ctor(EbThreadContext *thread_contxt_pt
 
     context_ptr->previous_buffer_check1 = 0;
     context_ptr->prev_change_cond       = 0;
-
-    return EB_ErrorNone;
 }
 
 /******************************************************
@@ -731,10 +754,7 @@ void *resource_coordination_kernel(void *input_ptr) {
     EbObjectWrapper *input_picture_wrapper_ptr;
     EbObjectWrapper *reference_picture_wrapper_ptr;
 
-    EbBool end_of_sequence_flag = EB_FALSE;
-
-    uint32_t         input_size           = 0;
-    EbObjectWrapper *prev_pcs_wrapper_ptr = 0;
+    uint32_t input_size = 0;
 
     for (;;) {
         // Tie instance_index to zero for now...
@@ -876,7 +896,8 @@ void *resource_coordination_kernel(void *input_ptr) {
              context_ptr->scs_instance_array[instance_index]->encode_context_ptr->initial_picture)
             ? 0
             : 1;
-        for (uint8_t loop_index = 0; loop_index <= has_overlay && !end_of_sequence_flag;
+        for (uint8_t loop_index = 0;
+             loop_index <= has_overlay && !context_ptr->end_of_sequence_flag;
              loop_index++) {
             //Get a New ParentPCS where we will hold the new input_picture
             svt_get_empty_object(context_ptr->picture_control_set_fifo_ptr_array[instance_index],
@@ -931,15 +952,16 @@ void *resource_coordination_kernel(void *input_ptr) {
             input_picture_wrapper_ptr     = eb_input_wrapper_ptr;
             pcs_ptr->enhanced_picture_ptr = (EbPictureBufferDesc *)eb_input_ptr->p_buffer;
             pcs_ptr->input_ptr            = eb_input_ptr;
-            end_of_sequence_flag = (pcs_ptr->input_ptr->flags & EB_BUFFERFLAG_EOS) ? EB_TRUE
-                                                                                   : EB_FALSE;
+            context_ptr->end_of_sequence_flag = (pcs_ptr->input_ptr->flags & EB_BUFFERFLAG_EOS)
+                ? EB_TRUE
+                : EB_FALSE;
             svt_av1_get_time(&pcs_ptr->start_time_seconds, &pcs_ptr->start_time_u_seconds);
 
             pcs_ptr->scs_wrapper_ptr =
                 context_ptr->sequence_control_set_active_array[instance_index];
             pcs_ptr->scs_ptr                   = scs_ptr;
             pcs_ptr->input_picture_wrapper_ptr = input_picture_wrapper_ptr;
-            pcs_ptr->end_of_sequence_flag      = end_of_sequence_flag;
+            pcs_ptr->end_of_sequence_flag      = context_ptr->end_of_sequence_flag;
 
             if (loop_index == 1) {
                 // Get a new input picture for overlay.
@@ -1009,7 +1031,7 @@ void *resource_coordination_kernel(void *input_ptr) {
             }
 
             // Picture Stats
-            if (loop_index == has_overlay || end_of_sequence_flag)
+            if (loop_index == has_overlay || context_ptr->end_of_sequence_flag)
                 pcs_ptr->picture_number = context_ptr->picture_number_array[instance_index]++;
             else
                 pcs_ptr->picture_number = context_ptr->picture_number_array[instance_index];
@@ -1086,24 +1108,24 @@ void *resource_coordination_kernel(void *input_ptr) {
             }
 
             // Get Empty Output Results Object
-            if (pcs_ptr->picture_number > 0 && (prev_pcs_wrapper_ptr != NULL)) {
-                PictureParentControlSet *ppcs_out = (PictureParentControlSet *)
-                                                        prev_pcs_wrapper_ptr->object_ptr;
+            if (pcs_ptr->picture_number > 0 && (context_ptr->prev_pcs_wrapper_ptr != NULL)) {
+                PictureParentControlSet *ppcs_out =
+                    (PictureParentControlSet *)context_ptr->prev_pcs_wrapper_ptr->object_ptr;
 
-                ppcs_out->end_of_sequence_flag = end_of_sequence_flag;
+                ppcs_out->end_of_sequence_flag = context_ptr->end_of_sequence_flag;
                 // since overlay frame has the end of sequence set properly, set the end of sequence to true in the alt ref picture
-                if (ppcs_out->is_overlay && end_of_sequence_flag)
+                if (ppcs_out->is_overlay && context_ptr->end_of_sequence_flag)
                     ppcs_out->alt_ref_ppcs_ptr->end_of_sequence_flag = EB_TRUE;
 
                 reset_pcs_av1(ppcs_out);
                 svt_get_empty_object(context_ptr->resource_coordination_results_output_fifo_ptr,
                                      &output_wrapper_ptr);
                 out_results_ptr = (ResourceCoordinationResults *)output_wrapper_ptr->object_ptr;
-                out_results_ptr->pcs_wrapper_ptr = prev_pcs_wrapper_ptr;
+                out_results_ptr->pcs_wrapper_ptr = context_ptr->prev_pcs_wrapper_ptr;
                 // Post the finished Results Object
                 svt_post_full_object(output_wrapper_ptr);
             }
-            prev_pcs_wrapper_ptr = pcs_wrapper_ptr;
+            context_ptr->prev_pcs_wrapper_ptr = pcs_wrapper_ptr;
         }
     }
 
@@ -21,6 +21,7 @@ extern "C" {
      ***************************************/
 EbErrorType resource_coordination_context_ctor(EbThreadContext* thread_context_ptr,
                                                EbEncHandle*     enc_handle_ptr);
+void        resource_coordination_context_reset(EbThreadContext* thread_context_ptr);
 
 extern void* resource_coordination_kernel(void* input_ptr);
 #ifdef __cplusplus
@@ -19,6 +19,7 @@
 #include "EbPictureDemuxResults.h"
 #include "EbReferenceObject.h"
 #include "EbPictureControlSet.h"
+#include "EbQualityMetricsProcess.h"
 
 #define DEBUG_UPSCALING 0
 
@@ -30,6 +31,7 @@ typedef struct RestContext {
     EbFifo *rest_input_fifo_ptr;
     EbFifo *rest_output_fifo_ptr;
     EbFifo *picture_demux_fifo_ptr;
+    EbFifo *quality_metrics_output_fifo_ptr;
 
     EbPictureBufferDesc *trial_frame_rst;
 
@@ -48,11 +50,13 @@ void pack_highbd_pic(const EbPictureBufferDesc *pic_ptr, uint16_t *buffer_16bit[
                      uint32_t ss_y, EbBool include_padding);
 void copy_buffer_info(EbPictureBufferDesc *src_ptr, EbPictureBufferDesc *dst_ptr);
 void recon_output(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
-void svt_av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *cm,
-                                           int32_t optimized_lr);
+void svt_av1_loop_restoration_filter_frame_init(Yv12BufferConfig *frame, Av1Common *cm,
+                                                int32_t optimized_lr);
+void svt_av1_loop_restoration_filter_band(Yv12BufferConfig *frame, Yv12BufferConfig *band_src,
+                                          Av1Common *cm, int32_t *tmpbuf, int32_t band_idx,
+                                          int32_t band_cnt);
+void svt_av1_loop_restoration_filter_frame_finish(Yv12BufferConfig *frame, Av1Common *cm);
 void copy_statistics_to_ref_obj_ect(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
-void psnr_calculations(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr, EbBool free_memory);
-void ssim_calculations(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr, EbBool free_memory);
 void pad_ref_and_set_flags(PictureControlSet *pcs_ptr, SequenceControlSet *scs_ptr);
 void generate_padding(EbByte src_pic, uint32_t src_stride, uint32_t original_src_width,
                       uint32_t original_src_height, uint32_t padding_width,
@@ -106,6 +110,9 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
         enc_handle_ptr->rest_results_resource_ptr, index);
     context_ptr->picture_demux_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->picture_demux_results_resource_ptr, demux_index);
+    if (enc_handle_ptr->quality_metrics_tasks_resource_ptr)
+        context_ptr->quality_metrics_output_fifo_ptr = svt_system_resource_get_producer_fifo(
+            enc_handle_ptr->quality_metrics_tasks_resource_ptr, index);
 
     {
         EbPictureBufferDescInitData init_data;
@@ -121,6 +128,7 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
         init_data.bot_padding        = AOM_BORDER_IN_PIXELS;
         init_data.split_mode         = EB_FALSE;
         init_data.is_16bit_pipeline  = config->is_16bit_pipeline;
+        init_data.alloc_policy       = scs_ptr->large_alloc_policy;
 
         EB_NEW(context_ptr->trial_frame_rst, svt_picture_buffer_desc_ctor, (EbPtr)&init_data);
 
@@ -144,6 +152,7 @@ EbErrorType rest_context_ctor(EbThreadContext *  thread_context_ptr,
     temp_lf_recon_desc_init_data.bot_padding   = PAD_VALUE;
     temp_lf_recon_desc_init_data.split_mode    = EB_FALSE;
     temp_lf_recon_desc_init_data.color_format  = color_format;
+    temp_lf_recon_desc_init_data.alloc_policy  = scs_ptr->large_alloc_policy;
 
     if (config->is_16bit_pipeline || is_16bit) {
         temp_lf_recon_desc_init_data.bit_depth = EB_16BIT;
@@ -451,10 +460,53 @@ void svt_av1_superres_upscale_frame(struct Av1Common *cm, PictureControlSet *pcs
     EB_FREE_ALIGNED_ARRAY(ps_recon_pic_temp->buffer_cr);
 }
 
+static EbBool is_rest_applied(const Av1Common *cm) {
+    return cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+}
+
 /******************************************************
- * Rest Kernel
+ * Post Quality Metrics Tasks
+ *   One task per band of the picture. The last
+ *   band to complete releases the source copy kept for
+ *   temporal filtering and the reference live count taken
+ *   here, since the reference is read after it is handed
+ *   to the picture manager.
  ******************************************************/
-void *rest_kernel(void *input_ptr) {
+static void post_quality_metrics_tasks(RestContext *context_ptr, EbObjectWrapper *pcs_wrapper_ptr,
+                                       SequenceControlSet *scs_ptr) {
+    PictureControlSet *  pcs_ptr = (PictureControlSet *)pcs_wrapper_ptr->object_ptr;
+    EbPictureBufferDesc *input_picture_ptr = pcs_ptr->parent_pcs_ptr->enhanced_unscaled_picture_ptr;
+    EbObjectWrapper *    quality_metrics_tasks_wrapper_ptr;
+
+    // PSNR covers the visible rows, SSIM the rows of the coded frame
+    pcs_ptr->metrics_bands_total_count =
+        (AOMMAX(input_picture_ptr->height - scs_ptr->max_input_pad_bottom,
+                scs_ptr->seq_header.max_frame_height) +
+         QUALITY_METRICS_BAND_HEIGHT - 1) /
+        QUALITY_METRICS_BAND_HEIGHT;
+    pcs_ptr->tot_bands_metrics = 0;
+    memset(pcs_ptr->metrics_sse, 0, sizeof(pcs_ptr->metrics_sse));
+
+    if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+        svt_object_inc_live_count(pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr, 1);
+
+    for (uint16_t band = 0; band < pcs_ptr->metrics_bands_total_count; band++) {
+        svt_get_empty_object(context_ptr->quality_metrics_output_fifo_ptr,
+                             &quality_metrics_tasks_wrapper_ptr);
+        QualityMetricsTasks *tasks_ptr = (QualityMetricsTasks *)
+                                             quality_metrics_tasks_wrapper_ptr->object_ptr;
+        tasks_ptr->pcs_wrapper_ptr = pcs_wrapper_ptr;
+        tasks_ptr->segment_index   = band;
+        svt_post_full_object(quality_metrics_tasks_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * Rest Task
+ ******************************************************/
+void rest_task(EbPtr input_ptr, EbObjectWrapper *cdef_results_wrapper_ptr) {
     // Context & SCS & PCS
     EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
     RestContext *       context_ptr        = (RestContext *)thread_context_ptr->priv;
@@ -462,7 +514,6 @@ void *rest_kernel(void *input_ptr) {
     SequenceControlSet *scs_ptr;
 
     //// Input
-    EbObjectWrapper *cdef_results_wrapper_ptr;
     CdefResults *    cdef_results_ptr;
 
     //// Output
@@ -474,17 +525,14 @@ void *rest_kernel(void *input_ptr) {
     uint8_t tile_cols;
     uint8_t tile_rows;
 
-    for (;;) {
-        // Get Cdef Results
-        EB_GET_FULL_OBJECT(context_ptr->rest_input_fifo_ptr, &cdef_results_wrapper_ptr);
-
-        cdef_results_ptr      = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
-        pcs_ptr               = (PictureControlSet *)cdef_results_ptr->pcs_wrapper_ptr->object_ptr;
-        scs_ptr               = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
-        FrameHeader *frm_hdr  = &pcs_ptr->parent_pcs_ptr->frm_hdr;
-        EbBool       is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common *  cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
+    cdef_results_ptr      = (CdefResults *)cdef_results_wrapper_ptr->object_ptr;
+    pcs_ptr               = (PictureControlSet *)cdef_results_ptr->pcs_wrapper_ptr->object_ptr;
+    scs_ptr               = (SequenceControlSet *)pcs_ptr->scs_wrapper_ptr->object_ptr;
+    FrameHeader *frm_hdr  = &pcs_ptr->parent_pcs_ptr->frm_hdr;
+    EbBool       is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common *  cm       = pcs_ptr->parent_pcs_ptr->av1_cm;
 
+    if (cdef_results_ptr->segment_index < pcs_ptr->rest_segments_total_count) {
         if (scs_ptr->seq_header.enable_restoration && frm_hdr->allow_intrabc == 0) {
             // ------- start: Normative upscaling - super-resolution tool
             if (!av1_superres_unscaled(&cm->frm_size)) {
@@ -532,7 +580,7 @@ void *rest_kernel(void *input_ptr) {
                                    cdef_results_ptr->segment_index);
         }
 
-        //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
+        //all seg based search is done. update total processed segments. if all done, finish the search and release the application bands.
         svt_block_on_mutex(pcs_ptr->rest_search_mutex);
 
         pcs_ptr->tot_seg_searched_rest++;
@@ -542,93 +590,149 @@ void *rest_kernel(void *input_ptr) {
                                    pcs_ptr->parent_pcs_ptr->av1x,
                                    pcs_ptr->parent_pcs_ptr->av1_cm);
 
-                if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
-                    svt_av1_loop_restoration_filter_frame(cm->frame_to_show, cm, 0);
-                }
+                if (is_rest_applied(cm))
+                    svt_av1_loop_restoration_filter_frame_init(cm->frame_to_show, cm, 0);
             } else {
                 cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
                 cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
                 cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
             }
+            pcs_ptr->rest_search_done = EB_TRUE;
+            for (uint32_t i = 0; i < pcs_ptr->rest_search_wait_count; i++)
+                svt_post_semaphore(pcs_ptr->rest_search_done_semaphore);
+        }
+        svt_release_mutex(pcs_ptr->rest_search_mutex);
 
-            uint8_t best_ep_cnt = 0;
-            uint8_t best_ep     = 0;
-            for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
-                if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
-                    best_ep     = i;
-                    best_ep_cnt = cm->sg_frame_ep_cnt[i];
-                }
-            }
-            cm->sg_frame_ep = best_ep;
+        // Release input Results
+        svt_release_object(cdef_results_wrapper_ptr);
+        return;
+    }
 
-            if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
-                // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
-                copy_statistics_to_ref_obj_ect(pcs_ptr, scs_ptr);
-            }
+    // Application band: wait for the frame level search to complete. The search
+    // segments were posted ahead of the bands, so they are all being processed.
+    svt_block_on_mutex(pcs_ptr->rest_search_mutex);
+    if (pcs_ptr->rest_search_done == EB_FALSE) {
+        pcs_ptr->rest_search_wait_count++;
+        svt_release_mutex(pcs_ptr->rest_search_mutex);
+        svt_block_on_semaphore(pcs_ptr->rest_search_done_semaphore);
+    } else
+        svt_release_mutex(pcs_ptr->rest_search_mutex);
 
-            // PSNR and SSIM Calculation.
-            // Note: if temporal_filtering is used, memory needs to be freed in the last of these calls
-            if (scs_ptr->static_config.stat_report) {
-                psnr_calculations(pcs_ptr, scs_ptr, EB_FALSE);
-                ssim_calculations(pcs_ptr, scs_ptr, EB_TRUE /* free memory here */);
-            }
+    if (is_rest_applied(cm)) {
+        Yv12BufferConfig band_src;
+        link_eb_to_aom_buffer_desc(context_ptr->org_rec_frame,
+                                   &band_src,
+                                   scs_ptr->max_input_pad_right,
+                                   scs_ptr->max_input_pad_bottom,
+                                   scs_ptr->static_config.is_16bit_pipeline || is_16bit);
+        svt_av1_loop_restoration_filter_band(
+            cm->frame_to_show,
+            &band_src,
+            cm,
+            context_ptr->rst_tmpbuf,
+            cdef_results_ptr->segment_index - pcs_ptr->rest_segments_total_count,
+            pcs_ptr->rest_bands_total_count);
+    }
+
+    svt_block_on_mutex(pcs_ptr->rest_search_mutex);
 
-            // Pad the reference picture and set ref POC
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                pad_ref_and_set_flags(pcs_ptr, scs_ptr);
-            if (scs_ptr->static_config.recon_enabled) {
-                recon_output(pcs_ptr, scs_ptr);
+    pcs_ptr->tot_bands_filtered_rest++;
+    if (pcs_ptr->tot_bands_filtered_rest == pcs_ptr->rest_bands_total_count) {
+        if (is_rest_applied(cm))
+            svt_av1_loop_restoration_filter_frame_finish(cm->frame_to_show, cm);
+
+        uint8_t best_ep_cnt = 0;
+        uint8_t best_ep     = 0;
+        for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
+            if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
+                best_ep     = i;
+                best_ep_cnt = cm->sg_frame_ep_cnt[i];
             }
+        }
+        cm->sg_frame_ep = best_ep;
 
-            tile_cols = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols;
-            tile_rows = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
+        if (pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
+            // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
+            copy_statistics_to_ref_obj_ect(pcs_ptr, scs_ptr);
+        }
 
-            if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
-                // Get Empty PicMgr Results
-                svt_get_empty_object(context_ptr->picture_demux_fifo_ptr,
-                                     &picture_demux_results_wrapper_ptr);
+        // SSIM of the samples the padding is about to overwrite
+        if (scs_ptr->static_config.stat_report)
+            quality_metrics_edge(pcs_ptr, scs_ptr);
 
-                picture_demux_results_rtr = (PictureDemuxResults *)
-                                                picture_demux_results_wrapper_ptr->object_ptr;
-                picture_demux_results_rtr->reference_picture_wrapper_ptr =
-                    pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
-                picture_demux_results_rtr->scs_wrapper_ptr = pcs_ptr->scs_wrapper_ptr;
-                picture_demux_results_rtr->picture_number  = pcs_ptr->picture_number;
-                picture_demux_results_rtr->picture_type    = EB_PIC_REFERENCE;
+        // Pad the reference picture and set ref POC
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+            pad_ref_and_set_flags(pcs_ptr, scs_ptr);
+        if (scs_ptr->static_config.recon_enabled) {
+            recon_output(pcs_ptr, scs_ptr);
+        }
 
-                // Post Reference Picture
-                svt_post_full_object(picture_demux_results_wrapper_ptr);
-            }
+        // PSNR and SSIM Calculation, in parallel with the entropy coding
+        if (scs_ptr->static_config.stat_report)
+            post_quality_metrics_tasks(context_ptr, cdef_results_ptr->pcs_wrapper_ptr, scs_ptr);
 
-            //Jing: TODO
-            //Consider to add parallelism here, sending line by line, not waiting for a full frame
-            int sb_size_log2 = scs_ptr->seq_header.sb_size_log2;
-            for (int tile_row_idx = 0; tile_row_idx < tile_rows; tile_row_idx++) {
-                uint16_t tile_height_in_sb = (cm->tiles_info.tile_row_start_mi[tile_row_idx + 1] -
-                                              cm->tiles_info.tile_row_start_mi[tile_row_idx] +
-                                              (1 << sb_size_log2) - 1) >>
-                    sb_size_log2;
-                for (int tile_col_idx = 0; tile_col_idx < tile_cols; tile_col_idx++) {
-                    const int tile_idx = tile_row_idx * tile_cols + tile_col_idx;
-                    svt_get_empty_object(context_ptr->rest_output_fifo_ptr,
-                                         &rest_results_wrapper_ptr);
-                    rest_results_ptr = (struct RestResults *)rest_results_wrapper_ptr->object_ptr;
-                    rest_results_ptr->pcs_wrapper_ptr = cdef_results_ptr->pcs_wrapper_ptr;
-                    rest_results_ptr->completed_sb_row_index_start = 0;
-                    // Set to tile rows
-                    rest_results_ptr->completed_sb_row_count = tile_height_in_sb;
-                    rest_results_ptr->tile_index             = tile_idx;
-                    // Post Rest Results
-                    svt_post_full_object(rest_results_wrapper_ptr);
-                }
+        tile_cols = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_cols;
+        tile_rows = pcs_ptr->parent_pcs_ptr->av1_cm->tiles_info.tile_rows;
+
+        if (pcs_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
+            // Get Empty PicMgr Results
+            svt_get_empty_object(context_ptr->picture_demux_fifo_ptr,
+                                 &picture_demux_results_wrapper_ptr);
+
+            picture_demux_results_rtr = (PictureDemuxResults *)
+                                            picture_demux_results_wrapper_ptr->object_ptr;
+            picture_demux_results_rtr->reference_picture_wrapper_ptr =
+                pcs_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+            picture_demux_results_rtr->scs_wrapper_ptr = pcs_ptr->scs_wrapper_ptr;
+            picture_demux_results_rtr->picture_number  = pcs_ptr->picture_number;
+            picture_demux_results_rtr->picture_type    = EB_PIC_REFERENCE;
+
+            // Post Reference Picture
+            svt_post_full_object(picture_demux_results_wrapper_ptr);
+        }
+
+        //Jing: TODO
+        //Consider to add parallelism here, sending line by line, not waiting for a full frame
+        int sb_size_log2 = scs_ptr->seq_header.sb_size_log2;
+        for (int tile_row_idx = 0; tile_row_idx < tile_rows; tile_row_idx++) {
+            uint16_t tile_height_in_sb = (cm->tiles_info.tile_row_start_mi[tile_row_idx + 1] -
+                                          cm->tiles_info.tile_row_start_mi[tile_row_idx] +
+                                          (1 << sb_size_log2) - 1) >>
+                sb_size_log2;
+            for (int tile_col_idx = 0; tile_col_idx < tile_cols; tile_col_idx++) {
+                const int tile_idx = tile_row_idx * tile_cols + tile_col_idx;
+                svt_get_empty_object(context_ptr->rest_output_fifo_ptr,
+                                     &rest_results_wrapper_ptr);
+                rest_results_ptr = (struct RestResults *)rest_results_wrapper_ptr->object_ptr;
+                rest_results_ptr->pcs_wrapper_ptr = cdef_results_ptr->pcs_wrapper_ptr;
+                rest_results_ptr->completed_sb_row_index_start = 0;
+                // Set to tile rows
+                rest_results_ptr->completed_sb_row_count = tile_height_in_sb;
+                rest_results_ptr->tile_index             = tile_idx;
+                // Post Rest Results
+                svt_post_full_object(rest_results_wrapper_ptr);
             }
         }
-        svt_release_mutex(pcs_ptr->rest_search_mutex);
+    }
+    svt_release_mutex(pcs_ptr->rest_search_mutex);
 
-        // Release input Results
-        svt_release_object(cdef_results_wrapper_ptr);
+    // Release input Results
+    svt_release_object(cdef_results_wrapper_ptr);
+}
+
+/******************************************************
+ * Rest Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *rest_kernel(void *input_ptr) {
+    EbThreadContext *   thread_context_ptr = (EbThreadContext *)input_ptr;
+    RestContext *       context_ptr        = (RestContext *)thread_context_ptr->priv;
+    EbObjectWrapper *   cdef_results_wrapper_ptr;
+
+    for (;;) {
+        // Get Cdef Results
+        EB_GET_FULL_OBJECT(context_ptr->rest_input_fifo_ptr, &cdef_results_wrapper_ptr);
+        rest_task(input_ptr, cdef_results_wrapper_ptr);
     }
 
     return NULL;
@@ -214,6 +214,7 @@ EbErrorType svt_sequence_control_set_creator(EbPtr *object_dbl_ptr, EbPtr object
  ************************************************/
 EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSet *src) {
     dst->static_config                = src->static_config;
+    dst->large_alloc_policy           = src->large_alloc_policy;
     dst->encode_context_ptr           = src->encode_context_ptr;
     dst->chroma_format_idc            = src->chroma_format_idc;
     dst->max_temporal_layers          = src->max_temporal_layers;
@@ -259,6 +260,11 @@ EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSe
     dst->overlay_input_picture_buffer_init_count   = src->overlay_input_picture_buffer_init_count;
     dst->output_stream_buffer_fifo_init_count      = src->output_stream_buffer_fifo_init_count;
     dst->output_recon_buffer_fifo_init_count       = src->output_recon_buffer_fifo_init_count;
+    dst->picture_control_set_pool_min_count        = src->picture_control_set_pool_min_count;
+    dst->me_pool_min_count                         = src->me_pool_min_count;
+    dst->pa_reference_picture_buffer_min_count     = src->pa_reference_picture_buffer_min_count;
+    dst->reference_picture_buffer_min_count        = src->reference_picture_buffer_min_count;
+    dst->input_buffer_fifo_min_count               = src->input_buffer_fifo_min_count;
     dst->resource_coordination_fifo_init_count     = src->resource_coordination_fifo_init_count;
     dst->picture_analysis_fifo_init_count          = src->picture_analysis_fifo_init_count;
     dst->picture_decision_fifo_init_count          = src->picture_decision_fifo_init_count;
@@ -280,6 +286,11 @@ EbErrorType copy_sequence_control_set(SequenceControlSet *dst, SequenceControlSe
         src->mode_decision_configuration_process_init_count;
     dst->enc_dec_process_init_count        = src->enc_dec_process_init_count;
     dst->entropy_coding_process_init_count = src->entropy_coding_process_init_count;
+    dst->dlf_process_init_count            = src->dlf_process_init_count;
+    dst->cdef_process_init_count           = src->cdef_process_init_count;
+    dst->rest_process_init_count           = src->rest_process_init_count;
+    dst->quality_metrics_process_init_count = src->quality_metrics_process_init_count;
+    dst->tpl_process_init_count             = src->tpl_process_init_count;
     dst->total_process_init_count          = src->total_process_init_count;
     dst->left_padding                      = src->left_padding;
     dst->right_padding                     = src->right_padding;
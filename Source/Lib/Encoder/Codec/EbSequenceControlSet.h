@@ -33,6 +33,8 @@ typedef struct SequenceControlSet {
 
     /*!< API structure */
     EbSvtAv1EncConfiguration static_config;
+    /*!< Huge pages and NUMA node of the picture buffers, from huge_pages and target_socket */
+    EbLargeAllocPolicy large_alloc_policy;
     /*!< Pointer to prediction structure containing the mini-gop information */
     PredictionStructure *pred_struct_ptr;
     /*!< Super block geomerty pointer */
@@ -168,6 +170,12 @@ typedef struct SequenceControlSet {
     uint32_t overlay_input_picture_buffer_init_count;
     uint32_t output_stream_buffer_fifo_init_count;
     uint32_t output_recon_buffer_fifo_init_count;
+    /*!< Counts the elastic pools start from, equal to the init counts when not elastic */
+    uint32_t picture_control_set_pool_min_count;
+    uint32_t me_pool_min_count;
+    uint32_t pa_reference_picture_buffer_min_count;
+    uint32_t reference_picture_buffer_min_count;
+    uint32_t input_buffer_fifo_min_count;
 
     /*!< Inter processes fifos count */
     uint32_t resource_coordination_fifo_init_count;
@@ -185,6 +193,8 @@ typedef struct SequenceControlSet {
     uint32_t dlf_fifo_init_count;
     uint32_t cdef_fifo_init_count;
     uint32_t rest_fifo_init_count;
+    uint32_t quality_metrics_fifo_init_count;
+    uint32_t tpl_fifo_init_count;
 
     /*!< Thread count for each process */
     uint32_t picture_analysis_process_init_count;
@@ -196,6 +206,8 @@ typedef struct SequenceControlSet {
     uint32_t dlf_process_init_count;
     uint32_t cdef_process_init_count;
     uint32_t rest_process_init_count;
+    uint32_t quality_metrics_process_init_count;
+    uint32_t tpl_process_init_count;
     uint32_t inlme_process_init_count;
     uint32_t total_process_init_count;
     int32_t  lap_enabled;
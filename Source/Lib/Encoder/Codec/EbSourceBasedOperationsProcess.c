@@ -30,6 +30,7 @@ typedef struct SourceBasedOperationsContext {
     EbDctor dctor;
     EbFifo *initial_rate_control_results_input_fifo_ptr;
     EbFifo *picture_demux_results_output_fifo_ptr;
+    EbFifo *tpl_tasks_output_fifo_ptr;
     // local zz cost array
     uint32_t complete_sb_count;
     uint8_t *y_mean_ptr;
@@ -58,6 +59,9 @@ EbErrorType source_based_operations_context_ctor(EbThreadContext *  thread_conte
             enc_handle_ptr->initial_rate_control_results_resource_ptr, index);
     context_ptr->picture_demux_results_output_fifo_ptr = svt_system_resource_get_producer_fifo(
         enc_handle_ptr->picture_demux_results_resource_ptr, index);
+    if (enc_handle_ptr->tpl_tasks_resource_ptr)
+        context_ptr->tpl_tasks_output_fifo_ptr = svt_system_resource_get_producer_fifo(
+            enc_handle_ptr->tpl_tasks_resource_ptr, index);
     return EB_ErrorNone;
 }
 
@@ -106,7 +110,7 @@ void derive_picture_activity_statistics(PictureParentControlSet *pcs_ptr)
 EbErrorType tpl_get_open_loop_me(PictureManagerContext *context_ptr, SequenceControlSet *scs_ptr,
                                  PictureParentControlSet *pcs_tpl_base_ptr);
 EbErrorType tpl_mc_flow(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
-                        PictureParentControlSet *pcs_ptr);
+                        PictureParentControlSet *pcs_ptr, EbFifo *tpl_tasks_fifo_ptr);
 /************************************************
  * Source Based Operations Kernel
  * Source-based operations process involves a number of analysis algorithms
@@ -140,7 +144,10 @@ void *source_based_operations_kernel(void *input_ptr) {
 
             if (/*scs_ptr->in_loop_me &&*/ scs_ptr->static_config.enable_tpl_la &&
                 pcs_ptr->temporal_layer_index == 0) {
-                tpl_mc_flow(scs_ptr->encode_context_ptr, scs_ptr, pcs_ptr);
+                tpl_mc_flow(scs_ptr->encode_context_ptr,
+                            scs_ptr,
+                            pcs_ptr,
+                            context_ptr->tpl_tasks_output_fifo_ptr);
             }
             //any picture not belonging to any TPL group should release its PA references
             if (pcs_ptr->num_tpl_grps == 0) {
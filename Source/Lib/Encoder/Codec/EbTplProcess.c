@@ -0,0 +1,108 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#include <stdlib.h>
+
+#include "EbEncHandle.h"
+#include "EbTplProcess.h"
+#include "EbRateControlTasks.h"
+#include "EbThreads.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+
+/**************************************
+ * TPL Context
+ **************************************/
+typedef struct TplContext {
+    EbDctor dctor;
+    EbFifo *tpl_input_fifo_ptr;
+} TplContext;
+
+void tpl_mc_flow_dispenser_sb_row(EncodeContext *encode_context_ptr, SequenceControlSet *scs_ptr,
+                                  PictureParentControlSet *pcs_ptr, int32_t frame_idx,
+                                  uint32_t sb_row);
+void tpl_mc_flow_dispenser_finish(EncodeContext *encode_context_ptr, int32_t frame_idx);
+void tpl_mc_flow_synthesizer_sb_row(PictureParentControlSet *pcs_array[MAX_TPL_LA_SW],
+                                    int32_t frame_idx, uint8_t frames_in_sw, uint32_t sb_row);
+
+static void tpl_context_dctor(EbPtr p) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)p;
+    TplContext *     obj                = (TplContext *)thread_context_ptr->priv;
+    EB_FREE_ARRAY(obj);
+}
+
+/******************************************************
+ * TPL Context Constructor
+ ******************************************************/
+EbErrorType tpl_context_ctor(EbThreadContext *thread_context_ptr,
+                             const EbEncHandle *enc_handle_ptr, int index) {
+    TplContext *context_ptr;
+    EB_CALLOC_ARRAY(context_ptr, 1);
+    thread_context_ptr->priv  = context_ptr;
+    thread_context_ptr->dctor = tpl_context_dctor;
+
+    // Input System Resource Manager FIFO
+    context_ptr->tpl_input_fifo_ptr = svt_system_resource_get_consumer_fifo(
+        enc_handle_ptr->tpl_tasks_resource_ptr, index);
+
+    return EB_ErrorNone;
+}
+
+/******************************************************
+ * TPL Task
+ *   Dispenser or synthesizer of one SB row of a picture of the TPL
+ *   window, the last row of the picture signals the caller of tpl_mc_flow
+ ******************************************************/
+void tpl_task(EbPtr input_ptr, EbObjectWrapper *tpl_tasks_wrapper_ptr) {
+    TplTasks *               tasks_ptr = (TplTasks *)tpl_tasks_wrapper_ptr->object_ptr;
+    PictureParentControlSet *pcs_ptr   = tasks_ptr->pcs_ptr;
+    SequenceControlSet *     scs_ptr   = pcs_ptr->scs_ptr;
+    EncodeContext *          encode_context_ptr = scs_ptr->encode_context_ptr;
+    const int32_t            frame_idx          = tasks_ptr->frame_idx;
+    const uint8_t            synthesizer        = tasks_ptr->synthesizer;
+    const uint32_t           sb_row_count       = tasks_ptr->sb_row_count;
+    (void)input_ptr;
+
+    if (synthesizer)
+        tpl_mc_flow_synthesizer_sb_row(encode_context_ptr->tpl_pcs_array,
+                                       frame_idx,
+                                       encode_context_ptr->tpl_frames_in_sw,
+                                       tasks_ptr->sb_row_index);
+    else
+        tpl_mc_flow_dispenser_sb_row(
+            encode_context_ptr, scs_ptr, pcs_ptr, frame_idx, tasks_ptr->sb_row_index);
+    svt_release_object(tpl_tasks_wrapper_ptr);
+
+    if (svt_atomic_add_u32(&pcs_ptr->tpl_rows_done, 1) == sb_row_count) {
+        if (!synthesizer)
+            tpl_mc_flow_dispenser_finish(encode_context_ptr, frame_idx);
+        svt_atomic_store_u32(&pcs_ptr->tpl_frame_done, 1);
+        svt_post_semaphore(encode_context_ptr->tpl_done_semaphore);
+    }
+}
+
+/******************************************************
+ * TPL Kernel
+ *   Stage thread of the per-stage thread pools
+ ******************************************************/
+void *tpl_kernel(void *input_ptr) {
+    EbThreadContext *thread_context_ptr = (EbThreadContext *)input_ptr;
+    TplContext *     context_ptr        = (TplContext *)thread_context_ptr->priv;
+    EbObjectWrapper *tpl_tasks_wrapper_ptr;
+
+    for (;;) {
+        // Get TPL Tasks
+        EB_GET_FULL_OBJECT(context_ptr->tpl_input_fifo_ptr, &tpl_tasks_wrapper_ptr);
+        tpl_task(input_ptr, tpl_tasks_wrapper_ptr);
+    }
+
+    return NULL;
+}
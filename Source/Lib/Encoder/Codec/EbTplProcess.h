@@ -0,0 +1,26 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+#ifndef EbTplProcess_h
+#define EbTplProcess_h
+
+#include "EbDefinitions.h"
+
+/**************************************
+ * Extern Function Declarations
+ **************************************/
+extern EbErrorType tpl_context_ctor(EbThreadContext *thread_context_ptr,
+                                    const EbEncHandle *enc_handle_ptr, int index);
+
+extern void *tpl_kernel(void *input_ptr);
+extern void  tpl_task(EbPtr input_ptr, EbObjectWrapper *wrapper_ptr);
+
+#endif
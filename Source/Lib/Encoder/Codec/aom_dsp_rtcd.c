@@ -110,6 +110,8 @@ void setup_rtcd_internal(CPU_FLAGS flags) {
     SET_AVX2(svt_av1_quantize_fp_64x64, svt_av1_quantize_fp_64x64_c, svt_av1_quantize_fp_64x64_avx2);
     SET_AVX2(svt_av1_highbd_quantize_fp, svt_av1_highbd_quantize_fp_c, svt_av1_highbd_quantize_fp_avx2);
     SET_SSE2(svt_aom_highbd_8_mse16x16, svt_aom_highbd_8_mse16x16_c, svt_aom_highbd_8_mse16x16_sse2);
+    SET_SSE2(svt_aom_ssim_parms_8x8, svt_aom_ssim_parms_8x8_c, svt_aom_ssim_parms_8x8_sse2);
+    SET_SSE2(svt_aom_highbd_ssim_parms_8x8, svt_aom_highbd_ssim_parms_8x8_c, svt_aom_highbd_ssim_parms_8x8_sse2);
 
     //SAD
     SET_AVX2(svt_aom_mse16x16, svt_aom_mse16x16_c, svt_aom_mse16x16_avx2);
@@ -350,6 +350,17 @@ static void copy_points_at_indices(double *dest, const double *src, const int *i
 
 static const double k_infinite_variance = 1e12;
 
+// Squared distances between the projected points and their matches. Kept apart
+// from the inlier selection so the loop has no branches and vectorizes.
+static void compute_distances_squared(const double *proj, const double *points,
+                                      double *distance_squared, int n) {
+    for (int i = 0; i < n; ++i) {
+        const double dx     = proj[i * 2] - points[i * 2];
+        const double dy     = proj[i * 2 + 1] - points[i * 2 + 1];
+        distance_squared[i] = dx * dx + dy * dy;
+    }
+}
+
 static void clear_motion(RANSAC_MOTION *motion, int num_points) {
     motion->num_inliers = 0;
     motion->variance    = k_infinite_variance;
@@ -370,6 +381,7 @@ static int ransac(const int *matched_points, int npoints, int *num_inliers_by_mo
     double *points1, *points2;
     double *corners1, *corners2;
     double *image1_coord;
+    double *dist_sq;
 
     // Store information for the num_desired_motions best transformations found
     // and the worst motion among them, as well as the motion currently under
@@ -393,6 +405,7 @@ static int ransac(const int *matched_points, int npoints, int *num_inliers_by_mo
     corners1     = (double *)malloc(sizeof(*corners1) * npoints * 2);
     corners2     = (double *)malloc(sizeof(*corners2) * npoints * 2);
     image1_coord = (double *)malloc(sizeof(*image1_coord) * npoints * 2);
+    dist_sq      = (double *)malloc(sizeof(*dist_sq) * npoints);
 
     motions = (RANSAC_MOTION *)malloc(sizeof(RANSAC_MOTION) * num_desired_motions);
     assert(motions != NULL);
@@ -405,7 +418,7 @@ static int ransac(const int *matched_points, int npoints, int *num_inliers_by_mo
 
     worst_kept_motion = motions;
 
-    if (!(points1 && points2 && corners1 && corners2 && image1_coord && motions &&
+    if (!(points1 && points2 && corners1 && corners2 && image1_coord && dist_sq && motions &&
           current_motion.inlier_indices)) {
         ret_val = 1;
         goto finish_ransac;
@@ -453,10 +466,13 @@ static int ransac(const int *matched_points, int npoints, int *num_inliers_by_mo
 
         projectpoints(params_this_motion, corners1, image1_coord, npoints, 2, 2);
 
+        compute_distances_squared(image1_coord, corners2, dist_sq, npoints);
         for (int i = 0; i < npoints; ++i) {
-            double dx       = image1_coord[i * 2] - corners2[i * 2];
-            double dy       = image1_coord[i * 2 + 1] - corners2[i * 2 + 1];
-            double distance = sqrt(dx * dx + dy * dy);
+            // The square root is only taken for the candidate inliers, a distance
+            // below INLIER_THRESHOLD has its square below INLIER_THRESHOLD^2
+            if (dist_sq[i] >= INLIER_THRESHOLD * INLIER_THRESHOLD)
+                continue;
+            double distance = sqrt(dist_sq[i]);
 
             if (distance < INLIER_THRESHOLD) {
                 current_motion.inlier_indices[current_motion.num_inliers++] = i;
@@ -532,6 +548,7 @@ finish_ransac:
     free(corners1);
     free(corners2);
     free(image1_coord);
+    free(dist_sq);
     free(current_motion.inlier_indices);
     if (motions) {
         for (int i = 0; i < num_desired_motions; ++i) free(motions[i].inlier_indices);
@@ -556,6 +573,7 @@ static int ransac_double_prec(const double *matched_points, int npoints, int *nu
     double *points1, *points2;
     double *corners1, *corners2;
     double *image1_coord;
+    double *dist_sq;
 
     // Store information for the num_desired_motions best transformations found
     // and the worst motion among them, as well as the motion currently under
@@ -579,6 +597,7 @@ static int ransac_double_prec(const double *matched_points, int npoints, int *nu
     corners1     = (double *)malloc(sizeof(*corners1) * npoints * 2);
     corners2     = (double *)malloc(sizeof(*corners2) * npoints * 2);
     image1_coord = (double *)malloc(sizeof(*image1_coord) * npoints * 2);
+    dist_sq      = (double *)malloc(sizeof(*dist_sq) * npoints);
 
     motions = (RANSAC_MOTION *)malloc(sizeof(RANSAC_MOTION) * num_desired_motions);
     assert(motions != NULL);
@@ -591,7 +610,7 @@ static int ransac_double_prec(const double *matched_points, int npoints, int *nu
 
     worst_kept_motion = motions;
 
-    if (!(points1 && points2 && corners1 && corners2 && image1_coord && motions &&
+    if (!(points1 && points2 && corners1 && corners2 && image1_coord && dist_sq && motions &&
           current_motion.inlier_indices)) {
         ret_val = 1;
         goto finish_ransac;
@@ -639,10 +658,13 @@ static int ransac_double_prec(const double *matched_points, int npoints, int *nu
 
         projectpoints(params_this_motion, corners1, image1_coord, npoints, 2, 2);
 
+        compute_distances_squared(image1_coord, corners2, dist_sq, npoints);
         for (int i = 0; i < npoints; ++i) {
-            double dx       = image1_coord[i * 2] - corners2[i * 2];
-            double dy       = image1_coord[i * 2 + 1] - corners2[i * 2 + 1];
-            double distance = sqrt(dx * dx + dy * dy);
+            // The square root is only taken for the candidate inliers, a distance
+            // below INLIER_THRESHOLD has its square below INLIER_THRESHOLD^2
+            if (dist_sq[i] >= INLIER_THRESHOLD * INLIER_THRESHOLD)
+                continue;
+            double distance = sqrt(dist_sq[i]);
 
             if (distance < INLIER_THRESHOLD) {
                 current_motion.inlier_indices[current_motion.num_inliers++] = i;
@@ -716,6 +738,7 @@ finish_ransac:
     free(corners1);
     free(corners2);
     free(image1_coord);
+    free(dist_sq);
     free(current_motion.inlier_indices);
     if (motions) {
         for (int i = 0; i < num_desired_motions; ++i) free(motions[i].inlier_indices);
@@ -52,6 +52,8 @@
 #include "EbRestProcess.h"
 #include "EbCdefProcess.h"
 #include "EbDlfProcess.h"
+#include "EbQualityMetricsProcess.h"
+#include "EbTplProcess.h"
 #include "EbRateControlResults.h"
 #ifdef ARCH_X86_64
 #include <immintrin.h>
@@ -432,7 +434,11 @@ EbErrorType load_default_buffer_configuration_settings(
     // Segments will be parallelized within a tile group
     // We can use tile group to control the threads/parallelism in ED stage
     // NOTE:1 col will have better perf for segments for large resolutions
-    uint8_t tile_group_col_count = 1;//(1 << scs_ptr->static_config.tile_columns)
+    // With tile_parallel_enc_dec every tile is a tile group, i.e. an independent
+    // ED work unit with its own segment wavefront
+    uint8_t tile_group_col_count = scs_ptr->static_config.tile_parallel_enc_dec
+        ? (1 << scs_ptr->static_config.tile_columns)
+        : 1;
     uint8_t tile_group_row_count = (1 << scs_ptr->static_config.tile_rows);
 
     scs_ptr->tile_group_col_count_array[0] = tile_group_col_count;
@@ -599,8 +605,17 @@ EbErrorType load_default_buffer_configuration_settings(
             scs_ptr->me_pool_init_count = MAX(min_me, scs_ptr->picture_control_set_pool_init_count);
         }
     }
+    // Elastic pools start from the minimum counts and grow up to the init counts
+    const EbBool elastic = scs_ptr->static_config.elastic_buffers != 0;
+    scs_ptr->input_buffer_fifo_min_count = elastic ? min_input : scs_ptr->input_buffer_fifo_init_count;
+    scs_ptr->picture_control_set_pool_min_count = elastic ? min_parent : scs_ptr->picture_control_set_pool_init_count;
+    scs_ptr->me_pool_min_count = elastic ? min_me : scs_ptr->me_pool_init_count;
+    scs_ptr->pa_reference_picture_buffer_min_count = elastic ? min_paref : scs_ptr->pa_reference_picture_buffer_init_count;
+    scs_ptr->reference_picture_buffer_min_count = elastic ? min_ref : scs_ptr->reference_picture_buffer_init_count;
 
     //#====================== Inter process Fifos ======================
+    const uint32_t sb_row_count = (scs_ptr->max_input_luma_height +
+        scs_ptr->static_config.super_block_size - 1) / scs_ptr->static_config.super_block_size;
     scs_ptr->resource_coordination_fifo_init_count       = 300;
     scs_ptr->picture_analysis_fifo_init_count            = 300;
     scs_ptr->picture_decision_fifo_init_count            = 300;
@@ -610,13 +625,18 @@ EbErrorType load_default_buffer_configuration_settings(
     scs_ptr->rate_control_tasks_fifo_init_count          = 300;
     scs_ptr->rate_control_fifo_init_count                = 301;
     //Jing: Too many tiles may drain the fifo
-    scs_ptr->mode_decision_configuration_fifo_init_count = 300 * (MIN(9, 1<<scs_ptr->static_config.tile_rows));
+    // MDC posts one ED task per tile group
+    scs_ptr->mode_decision_configuration_fifo_init_count = 300 * (MIN(9, tile_group_col_count * tile_group_row_count));
     scs_ptr->motion_estimation_fifo_init_count           = 300;
     scs_ptr->entropy_coding_fifo_init_count              = 300;
-    scs_ptr->enc_dec_fifo_init_count                     = 300;
+    // EncDec posts up to one DLF task per SB row of each child picture it codes, and
+    // the tasks of a picture are released before its child PCS
+    scs_ptr->enc_dec_fifo_init_count                     = scs_ptr->picture_control_set_pool_init_count_child * sb_row_count;
     scs_ptr->dlf_fifo_init_count                         = 300;
     scs_ptr->cdef_fifo_init_count                        = 300;
     scs_ptr->rest_fifo_init_count                        = 300;
+    scs_ptr->quality_metrics_fifo_init_count             = 300;
+    scs_ptr->tpl_fifo_init_count                         = 300;
     //#====================== Processes number ======================
     scs_ptr->total_process_init_count                    = 0;
     if (core_count > 1){
@@ -631,6 +651,10 @@ EbErrorType load_default_buffer_configuration_settings(
         scs_ptr->total_process_init_count += (scs_ptr->dlf_process_init_count                         = MAX(MIN(40, core_count >> 1), core_count));
         scs_ptr->total_process_init_count += (scs_ptr->cdef_process_init_count                        = MAX(MIN(40, core_count >> 1), core_count));
         scs_ptr->total_process_init_count += (scs_ptr->rest_process_init_count                        = MAX(MIN(40, core_count >> 1), core_count));
+        if (scs_ptr->static_config.stat_report)
+            scs_ptr->total_process_init_count += (scs_ptr->quality_metrics_process_init_count         = MAX(MIN(40, core_count >> 1), core_count));
+        if (scs_ptr->static_config.enable_tpl_la)
+            scs_ptr->total_process_init_count += (scs_ptr->tpl_process_init_count                     = MAX(MIN(40, core_count >> 1), core_count));
         if (core_count < (CONS_CORE_COUNT >> 2)) {
 
             scs_ptr->total_process_init_count += (scs_ptr->motion_estimation_process_init_count = MAX(core_count, MAX(MIN(20, core_count >> 1), core_count / 3)));
@@ -646,6 +670,29 @@ EbErrorType load_default_buffer_configuration_settings(
         scs_ptr->total_process_init_count += (scs_ptr->dlf_process_init_count                         = 1);
         scs_ptr->total_process_init_count += (scs_ptr->cdef_process_init_count                        = 1);
         scs_ptr->total_process_init_count += (scs_ptr->rest_process_init_count                        = 1);
+        if (scs_ptr->static_config.stat_report)
+            scs_ptr->total_process_init_count += (scs_ptr->quality_metrics_process_init_count         = 1);
+        if (scs_ptr->static_config.enable_tpl_la)
+            scs_ptr->total_process_init_count += (scs_ptr->tpl_process_init_count                     = 1);
+    }
+
+    if (scs_ptr->static_config.task_scheduler) {
+        // The scheduled stages share core_count workers, each worker owns one
+        // context of every stage. This is a partial scheduler: DLF, restoration
+        // and TPL wait on the SB rows of their own stage, and they keep their fifo
+        // processes with the other stages.
+        scs_ptr->total_process_init_count -= scs_ptr->motion_estimation_process_init_count +
+            scs_ptr->enc_dec_process_init_count + scs_ptr->entropy_coding_process_init_count +
+            scs_ptr->cdef_process_init_count;
+        if (scs_ptr->static_config.stat_report)
+            scs_ptr->total_process_init_count -= scs_ptr->quality_metrics_process_init_count;
+        scs_ptr->total_process_init_count += core_count;
+        scs_ptr->motion_estimation_process_init_count = core_count;
+        scs_ptr->enc_dec_process_init_count           = core_count;
+        scs_ptr->entropy_coding_process_init_count    = core_count;
+        scs_ptr->cdef_process_init_count              = core_count;
+        if (scs_ptr->static_config.stat_report)
+            scs_ptr->quality_metrics_process_init_count = core_count;
     }
 
     scs_ptr->total_process_init_count += 6; // single processes count
@@ -730,6 +777,218 @@ static uint32_t enc_dec_port_total_count(void){
         total_count += enc_dec_ports[port_index++].count;
     return total_count;
 }
+/**********************************
+* Shared Engine
+*   Task scheduler, worker threads and reference picture pools of the
+*   encoders of one process initialized with the same shared_engine id.
+*   The engines are listed in shared_engine_list, protected by
+*   shared_engine_mutex, and live as long as one encoder uses them.
+**********************************/
+typedef struct EbSharedEngine {
+    EbDctor                dctor;
+    struct EbSharedEngine *next_ptr;
+    uint32_t               id;
+    uint32_t               channel_total_count;
+    uint32_t               user_count;
+    EbTaskScheduler *      task_scheduler_ptr;
+    EbHandle *             task_worker_thread_handle_array;
+    EbSystemResource *     reference_picture_pool_ptr;
+    EbSystemResource *     pa_reference_picture_pool_ptr;
+} EbSharedEngine;
+
+static EbSharedEngine *shared_engine_list;
+static EbHandle        shared_engine_mutex;
+
+#ifdef _WIN32
+static INIT_ONCE shared_engine_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK create_shared_engine_mutex(PINIT_ONCE InitOnce, PVOID Parameter, PVOID* lpContext) {
+    (void)InitOnce;
+    (void)Parameter;
+    (void)lpContext;
+    shared_engine_mutex = svt_create_mutex();
+    return TRUE;
+}
+
+static EbHandle get_shared_engine_mutex(void) {
+    InitOnceExecuteOnce(&shared_engine_once, create_shared_engine_mutex, NULL, NULL);
+    return shared_engine_mutex;
+}
+#else
+static pthread_once_t shared_engine_once = PTHREAD_ONCE_INIT;
+
+static void create_shared_engine_mutex(void) { shared_engine_mutex = svt_create_mutex(); }
+
+static EbHandle get_shared_engine_mutex(void) {
+    pthread_once(&shared_engine_once, create_shared_engine_mutex);
+    return shared_engine_mutex;
+}
+#endif
+
+static void shared_engine_dctor(EbPtr p) {
+    EbSharedEngine *obj = (EbSharedEngine *)p;
+    svt_task_scheduler_shutdown(obj->task_scheduler_ptr);
+    if (obj->task_scheduler_ptr)
+        EB_DESTROY_THREAD_ARRAY(obj->task_worker_thread_handle_array,
+                                obj->task_scheduler_ptr->worker_count);
+    EB_DELETE(obj->task_scheduler_ptr);
+    EB_DELETE(obj->reference_picture_pool_ptr);
+    EB_DELETE(obj->pa_reference_picture_pool_ptr);
+}
+
+static EbErrorType shared_engine_ctor(EbSharedEngine *engine_ptr, uint32_t id,
+                                      uint32_t channel_total_count, uint32_t worker_count) {
+    engine_ptr->dctor               = shared_engine_dctor;
+    engine_ptr->id                  = id;
+    engine_ptr->channel_total_count = channel_total_count;
+
+    EB_NEW(engine_ptr->task_scheduler_ptr, svt_task_scheduler_ctor, worker_count,
+           channel_total_count);
+    EB_CREATE_THREAD_ARRAY(engine_ptr->task_worker_thread_handle_array, worker_count,
+                           svt_task_worker_kernel,
+                           engine_ptr->task_scheduler_ptr->worker_ptr_array);
+    return EB_ErrorNone;
+}
+
+/**********************************
+* shared_engine_attach
+*   Finds the engine of the shared_engine id, or creates it
+**********************************/
+static EbErrorType shared_engine_attach(EbEncHandle *enc_handle_ptr) {
+    const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    const EbSvtAv1EncConfiguration *config_ptr = &scs_ptr->static_config;
+    // Each worker owns one context of every scheduled stage
+    const uint32_t worker_count = scs_ptr->enc_dec_process_init_count;
+    EbErrorType    return_error = EB_ErrorNone;
+    EbHandle       mutex        = get_shared_engine_mutex();
+
+    svt_block_on_mutex(mutex);
+    EbSharedEngine *engine_ptr = shared_engine_list;
+    while (engine_ptr && engine_ptr->id != config_ptr->shared_engine)
+        engine_ptr = engine_ptr->next_ptr;
+    if (!engine_ptr) {
+        EB_NO_THROW_NEW(engine_ptr, shared_engine_ctor, config_ptr->shared_engine,
+                        config_ptr->active_channel_count, worker_count);
+        if (engine_ptr) {
+            engine_ptr->next_ptr = shared_engine_list;
+            shared_engine_list   = engine_ptr;
+        } else
+            return_error = EB_ErrorInsufficientResources;
+    } else if (engine_ptr->channel_total_count != config_ptr->active_channel_count ||
+               engine_ptr->task_scheduler_ptr->worker_count != worker_count) {
+        SVT_ERROR("shared engine %u runs %u channels on %u workers\n", engine_ptr->id,
+                  engine_ptr->channel_total_count, engine_ptr->task_scheduler_ptr->worker_count);
+        engine_ptr   = NULL;
+        return_error = EB_ErrorBadParameter;
+    }
+    if (engine_ptr) {
+        engine_ptr->user_count++;
+        enc_handle_ptr->shared_engine_ptr  = engine_ptr;
+        enc_handle_ptr->task_scheduler_ptr = engine_ptr->task_scheduler_ptr;
+    }
+    svt_release_mutex(mutex);
+
+    return return_error;
+}
+
+/**********************************
+* shared_engine_detach
+*   The last encoder of an engine destructs it
+**********************************/
+static void shared_engine_detach(EbEncHandle *enc_handle_ptr) {
+    EbSharedEngine *engine_ptr = enc_handle_ptr->shared_engine_ptr;
+    EbHandle        mutex      = get_shared_engine_mutex();
+
+    if (!engine_ptr)
+        return;
+    enc_handle_ptr->shared_engine_ptr  = NULL;
+    enc_handle_ptr->task_scheduler_ptr = NULL;
+
+    svt_block_on_mutex(mutex);
+    if (--engine_ptr->user_count == 0) {
+        EbSharedEngine **link_ptr = &shared_engine_list;
+        while (*link_ptr != engine_ptr) link_ptr = &(*link_ptr)->next_ptr;
+        *link_ptr = engine_ptr->next_ptr;
+    } else
+        engine_ptr = NULL;
+    svt_release_mutex(mutex);
+
+    EB_DELETE(engine_ptr);
+}
+
+/**********************************
+* shared_engine_pool
+*   Returns the pool of the engine at pool_dbl_ptr, constructed by the
+*   first caller for object_max_count objects per channel. NULL when the
+*   objects of the pool are built from different init data.
+**********************************/
+static EbSystemResource *shared_engine_pool(EbSharedEngine *engine_ptr,
+                                            EbSystemResource **pool_dbl_ptr,
+                                            uint32_t object_min_count, uint32_t object_max_count,
+                                            uint32_t producer_process_total_count,
+                                            EbCreator object_ctor, EbPtr object_init_data_ptr,
+                                            size_t object_init_data_size, uint32_t shrink_time) {
+    EbHandle          mutex = get_shared_engine_mutex();
+    EbSystemResource *pool_ptr;
+
+    svt_block_on_mutex(mutex);
+    if (!*pool_dbl_ptr)
+        EB_NO_THROW_NEW(*pool_dbl_ptr,
+                        svt_system_resource_elastic_ctor,
+                        object_min_count,
+                        object_max_count * engine_ptr->channel_total_count,
+                        producer_process_total_count * engine_ptr->channel_total_count,
+                        0,
+                        object_ctor,
+                        object_init_data_ptr,
+                        object_init_data_size,
+                        NULL,
+                        shrink_time);
+    pool_ptr = *pool_dbl_ptr;
+    // A single channel pool has a fixed count and keeps no init data to compare
+    if (pool_ptr && (pool_ptr->object_creator != object_ctor || !pool_ptr->object_init_data_copy ||
+                     memcmp(pool_ptr->object_init_data_copy, object_init_data_ptr,
+                            object_init_data_size)))
+        pool_ptr = NULL;
+    svt_release_mutex(mutex);
+
+    return pool_ptr;
+}
+
+/**********************************
+* shared_engine_release_pools
+*   Gives back the shared pool objects still held by the encoder,
+*   once its threads and its scheduled tasks are done
+**********************************/
+static void shared_engine_release_pools(EbEncHandle *enc_handle_ptr) {
+    EbSharedEngine *engine_ptr = enc_handle_ptr->shared_engine_ptr;
+
+    if (!engine_ptr || !enc_handle_ptr->scs_instance_array)
+        return;
+    for (uint32_t instance_index = 0; instance_index < enc_handle_ptr->encode_instance_total_count; ++instance_index) {
+        EncodeContext *encode_context_ptr = enc_handle_ptr->scs_instance_array[instance_index]
+            ? enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr : NULL;
+        EbSystemResource **ref_pool_dbl_ptr = enc_handle_ptr->reference_picture_pool_ptr_array
+            ? &enc_handle_ptr->reference_picture_pool_ptr_array[instance_index] : NULL;
+        EbSystemResource **pa_ref_pool_dbl_ptr = enc_handle_ptr->pa_reference_picture_pool_ptr_array
+            ? &enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index] : NULL;
+
+        // The shared pools are taken out of the arrays, they belong to the engine
+        if (ref_pool_dbl_ptr && *ref_pool_dbl_ptr &&
+            *ref_pool_dbl_ptr == engine_ptr->reference_picture_pool_ptr) {
+            if (encode_context_ptr && encode_context_ptr->reference_picture_pool_fifo_ptr)
+                svt_system_resource_reclaim(*ref_pool_dbl_ptr, encode_context_ptr->reference_picture_pool_fifo_ptr);
+            *ref_pool_dbl_ptr = NULL;
+        }
+        if (pa_ref_pool_dbl_ptr && *pa_ref_pool_dbl_ptr &&
+            *pa_ref_pool_dbl_ptr == engine_ptr->pa_reference_picture_pool_ptr) {
+            if (encode_context_ptr && encode_context_ptr->pa_reference_picture_pool_fifo_ptr)
+                svt_system_resource_reclaim(*pa_ref_pool_dbl_ptr, encode_context_ptr->pa_reference_picture_pool_fifo_ptr);
+            *pa_ref_pool_dbl_ptr = NULL;
+        }
+    }
+}
+
 /*****************************************
  * Input Port Total Count
  *****************************************/
@@ -781,11 +1040,22 @@ static void svt_enc_handle_stop_threads(EbEncHandle *enc_handle_ptr)
     // Rest Process
     EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count);
 
+    // Quality Metrics Process
+    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->quality_metrics_thread_handle_array, control_set_ptr->quality_metrics_process_init_count);
+
+    // TPL Process
+    EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->tpl_thread_handle_array, control_set_ptr->tpl_process_init_count);
+
     // Entropy Coding Process
     EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count);
 
     // Packetization
     EB_DESTROY_THREAD(enc_handle_ptr->packetization_thread_handle);
+
+    // Task Scheduler Workers
+    if (enc_handle_ptr->task_scheduler_ptr)
+        EB_DESTROY_THREAD_ARRAY(enc_handle_ptr->task_worker_thread_handle_array,
+                                enc_handle_ptr->task_scheduler_ptr->worker_count);
 }
 /**********************************
 * Encoder Library Handle Deonstructor
@@ -795,6 +1065,9 @@ static void svt_enc_handle_dctor(EbPtr p)
     EbEncHandle *enc_handle_ptr = (EbEncHandle *)p;
 
     svt_enc_handle_stop_threads(enc_handle_ptr);
+    // The scheduled tasks of the encoder are done once its channel is gone
+    EB_DELETE(enc_handle_ptr->task_channel_ptr);
+    shared_engine_release_pools(enc_handle_ptr);
     EB_FREE_PTR_ARRAY(enc_handle_ptr->app_callback_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE(enc_handle_ptr->scs_pool_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->picture_parent_control_set_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
@@ -804,6 +1077,7 @@ static void svt_enc_handle_dctor(EbPtr p)
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->down_scaled_picture_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->overlay_input_picture_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE(enc_handle_ptr->input_buffer_resource_ptr);
+    EB_DELETE(enc_handle_ptr->blank_input_picture_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->output_stream_buffer_resource_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->output_recon_buffer_resource_ptr_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE(enc_handle_ptr->resource_coordination_results_resource_ptr);
@@ -820,7 +1094,10 @@ static void svt_enc_handle_dctor(EbPtr p)
     EB_DELETE(enc_handle_ptr->dlf_results_resource_ptr);
     EB_DELETE(enc_handle_ptr->cdef_results_resource_ptr);
     EB_DELETE(enc_handle_ptr->rest_results_resource_ptr);
+    EB_DELETE(enc_handle_ptr->quality_metrics_tasks_resource_ptr);
+    EB_DELETE(enc_handle_ptr->tpl_tasks_resource_ptr);
     EB_DELETE(enc_handle_ptr->entropy_coding_results_resource_ptr);
+    EB_DELETE(enc_handle_ptr->pipeline_idle_signal_ptr);
 
     EB_DELETE(enc_handle_ptr->resource_coordination_context_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->picture_analysis_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->picture_analysis_process_init_count);
@@ -832,6 +1109,8 @@ static void svt_enc_handle_dctor(EbPtr p)
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->dlf_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->dlf_process_init_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->cdef_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->cdef_process_init_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->rest_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->rest_process_init_count);
+    EB_DELETE_PTR_ARRAY(enc_handle_ptr->quality_metrics_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->quality_metrics_process_init_count);
+    EB_DELETE_PTR_ARRAY(enc_handle_ptr->tpl_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->tpl_process_init_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->entropy_coding_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->entropy_coding_process_init_count);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->scs_instance_array, enc_handle_ptr->encode_instance_total_count);
     EB_DELETE(enc_handle_ptr->picture_decision_context_ptr);
@@ -839,6 +1118,10 @@ static void svt_enc_handle_dctor(EbPtr p)
     EB_DELETE(enc_handle_ptr->picture_manager_context_ptr);
     EB_DELETE(enc_handle_ptr->rate_control_context_ptr);
     EB_DELETE(enc_handle_ptr->packetization_context_ptr);
+    if (enc_handle_ptr->shared_engine_ptr)
+        shared_engine_detach(enc_handle_ptr);
+    else
+        EB_DELETE(enc_handle_ptr->task_scheduler_ptr);
     EB_DELETE_PTR_ARRAY(enc_handle_ptr->reference_picture_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
 
 }
@@ -883,7 +1166,24 @@ EbErrorType svt_output_buffer_header_creator(
     EbPtr *object_dbl_ptr,
     EbPtr object_init_data_ptr);
 
+EbErrorType svt_app_input_buffer_header_creator(
+    EbPtr *object_dbl_ptr,
+    EbPtr  object_init_data_ptr);
+
+/* Input buffer of the release_input mode, the pipeline only sees the header whose
+ * picture points to the planes of the application */
+typedef struct EbAppInputBuffer {
+    EbBufferHeaderType header;
+    EbSvtIOFormat      app_planes;
+    void              *app_private;
+    EbBool             holds_app_planes;
+} EbAppInputBuffer;
+
 void svt_input_buffer_header_destroyer(    EbPtr p);
+void svt_app_input_buffer_header_destroyer(    EbPtr p);
+static void release_app_input_buffer(EbPtr object_ptr, void *priv);
+static EbErrorType allocate_frame_buffer(SequenceControlSet *scs_ptr,
+                                        EbBufferHeaderType *input_buffer, EbBool alloc_planes);
 void svt_output_recon_buffer_header_destroyer(    EbPtr p);
 void svt_output_buffer_header_destroyer(    EbPtr p);
 
@@ -957,6 +1257,29 @@ EbErrorType rest_results_creator(
     return EB_ErrorNone;
 }
 
+EbErrorType quality_metrics_tasks_ctor(
+    QualityMetricsTasks *context_ptr,
+    EbPtr object_init_data_ptr)
+{
+    (void)context_ptr;
+    (void)object_init_data_ptr;
+
+    return EB_ErrorNone;
+}
+
+EbErrorType quality_metrics_tasks_creator(
+    EbPtr *object_dbl_ptr,
+    EbPtr object_init_data_ptr)
+{
+    QualityMetricsTasks* obj;
+
+    *object_dbl_ptr = NULL;
+    EB_NEW(obj, quality_metrics_tasks_ctor, object_init_data_ptr);
+    *object_dbl_ptr = obj;
+
+    return EB_ErrorNone;
+}
+
 static int create_down_scaled_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_index)
 {
     SequenceControlSet* scs_ptr = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr;
@@ -977,6 +1300,7 @@ static int create_down_scaled_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t in
     quart_pic_buf_desc_init_data.down_sampled_filtered = EB_FALSE;
     quart_pic_buf_desc_init_data.mfmv = 0;
     quart_pic_buf_desc_init_data.is_16bit_pipeline=EB_FALSE;
+    quart_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
     sixteenth_pic_buf_desc_init_data.max_width = scs_ptr->max_input_luma_width >> 2;
     sixteenth_pic_buf_desc_init_data.max_height = scs_ptr->max_input_luma_height >> 2;
@@ -992,6 +1316,7 @@ static int create_down_scaled_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t in
     sixteenth_pic_buf_desc_init_data.down_sampled_filtered = EB_FALSE;
     sixteenth_pic_buf_desc_init_data.mfmv = 0;
     sixteenth_pic_buf_desc_init_data.is_16bit_pipeline = EB_FALSE;
+    sixteenth_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
     eb_down_scale_obj_init_data.quarter_picture_desc_init_data = quart_pic_buf_desc_init_data;
     eb_down_scale_obj_init_data.sixteenth_picture_desc_init_data = sixteenth_pic_buf_desc_init_data;
@@ -999,13 +1324,16 @@ static int create_down_scaled_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t in
     eb_down_scale_obj_init_data.enable_quarter_luma_input = 1;//(scs_ptr->gm_level == GM_DOWN) ? 1 : 0;
     eb_down_scale_obj_init_data.enable_sixteenth_luma_input = 1;//(scs_ptr->gm_level == GM_DOWN16) ? 1 : 0;
     EB_NEW(enc_handle_ptr->down_scaled_picture_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
+            scs_ptr->input_buffer_fifo_min_count,
             scs_ptr->input_buffer_fifo_init_count,
             EB_PictureDecisionProcessInitCount,
             0,
             svt_down_scaled_object_creator,
             &(eb_down_scale_obj_init_data),
-            NULL);
+            sizeof(eb_down_scale_obj_init_data),
+            NULL,
+            scs_ptr->static_config.elastic_shrink_time);
     // Set the SequenceControlSet Picture Pool Fifo Ptrs
     enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->down_scaled_picture_pool_fifo_ptr =
         svt_system_resource_get_producer_fifo(enc_handle_ptr->down_scaled_picture_pool_ptr_array[instance_index], 0);
@@ -1016,10 +1344,16 @@ static int create_pa_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instanc
 {
         SequenceControlSet* scs_ptr = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr;
         EbPaReferenceObjectDescInitData   eb_pa_ref_obj_ect_desc_init_data_structure;
-        eb_pa_ref_obj_ect_desc_init_data_structure.empty_pa_buffers = in_loop_me;
         EbPictureBufferDescInitData       ref_pic_buf_desc_init_data;
         EbPictureBufferDescInitData       quart_pic_buf_desc_init_data;
         EbPictureBufferDescInitData       sixteenth_pic_buf_desc_init_data;
+        EbSystemResource *shared_pool_ptr = NULL;
+        // Cleared, the init data of a shared pool is compared byte per byte
+        memset(&eb_pa_ref_obj_ect_desc_init_data_structure, 0, sizeof(eb_pa_ref_obj_ect_desc_init_data_structure));
+        memset(&ref_pic_buf_desc_init_data, 0, sizeof(ref_pic_buf_desc_init_data));
+        memset(&quart_pic_buf_desc_init_data, 0, sizeof(quart_pic_buf_desc_init_data));
+        memset(&sixteenth_pic_buf_desc_init_data, 0, sizeof(sixteenth_pic_buf_desc_init_data));
+        eb_pa_ref_obj_ect_desc_init_data_structure.empty_pa_buffers = in_loop_me;
         // PA Reference Picture Buffers
         // Currently, only Luma samples are needed in the PA
         ref_pic_buf_desc_init_data.max_width = scs_ptr->max_input_luma_width;
@@ -1032,6 +1366,7 @@ static int create_pa_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instanc
         ref_pic_buf_desc_init_data.top_padding = scs_ptr->sb_sz + ME_FILTER_TAP;
         ref_pic_buf_desc_init_data.bot_padding = scs_ptr->sb_sz + ME_FILTER_TAP;
         ref_pic_buf_desc_init_data.split_mode = EB_FALSE;
+        ref_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
         quart_pic_buf_desc_init_data.max_width = scs_ptr->max_input_luma_width >> 1;
         quart_pic_buf_desc_init_data.max_height = scs_ptr->max_input_luma_height >> 1;
         quart_pic_buf_desc_init_data.bit_depth = EB_8BIT;
@@ -1043,6 +1378,7 @@ static int create_pa_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instanc
         quart_pic_buf_desc_init_data.bot_padding = scs_ptr->sb_sz >> 1;
         quart_pic_buf_desc_init_data.split_mode = EB_FALSE;
         quart_pic_buf_desc_init_data.down_sampled_filtered = (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) ? EB_TRUE : EB_FALSE;
+        quart_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
         sixteenth_pic_buf_desc_init_data.max_width = scs_ptr->max_input_luma_width >> 2;
         sixteenth_pic_buf_desc_init_data.max_height = scs_ptr->max_input_luma_height >> 2;
         sixteenth_pic_buf_desc_init_data.bit_depth = EB_8BIT;
@@ -1054,19 +1390,40 @@ static int create_pa_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instanc
         sixteenth_pic_buf_desc_init_data.bot_padding = scs_ptr->sb_sz >> 2;
         sixteenth_pic_buf_desc_init_data.split_mode = EB_FALSE;
         sixteenth_pic_buf_desc_init_data.down_sampled_filtered = (scs_ptr->down_sampling_method_me_search == ME_FILTERED_DOWNSAMPLED) ? EB_TRUE : EB_FALSE;
+        sixteenth_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
         eb_pa_ref_obj_ect_desc_init_data_structure.reference_picture_desc_init_data = ref_pic_buf_desc_init_data;
         eb_pa_ref_obj_ect_desc_init_data_structure.quarter_picture_desc_init_data = quart_pic_buf_desc_init_data;
         eb_pa_ref_obj_ect_desc_init_data_structure.sixteenth_picture_desc_init_data = sixteenth_pic_buf_desc_init_data;
         // Reference Picture Buffers
+        if (enc_handle_ptr->shared_engine_ptr)
+            shared_pool_ptr = shared_engine_pool(
+                enc_handle_ptr->shared_engine_ptr,
+                &enc_handle_ptr->shared_engine_ptr->pa_reference_picture_pool_ptr,
+                scs_ptr->pa_reference_picture_buffer_min_count,
+                scs_ptr->pa_reference_picture_buffer_init_count,
+                EB_PictureDecisionProcessInitCount,
+                svt_pa_reference_object_creator,
+                &(eb_pa_ref_obj_ect_desc_init_data_structure),
+                sizeof(eb_pa_ref_obj_ect_desc_init_data_structure),
+                scs_ptr->static_config.elastic_shrink_time);
+        if (shared_pool_ptr) {
+            enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index] = shared_pool_ptr;
+            enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->pa_reference_picture_pool_fifo_ptr =
+                svt_system_resource_get_producer_fifo(shared_pool_ptr, scs_ptr->static_config.channel_id * EB_PictureDecisionProcessInitCount);
+            return 0;
+        }
         EB_NEW(enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
+            scs_ptr->pa_reference_picture_buffer_min_count,
             scs_ptr->pa_reference_picture_buffer_init_count,
             EB_PictureDecisionProcessInitCount,
             0,
             svt_pa_reference_object_creator,
             &(eb_pa_ref_obj_ect_desc_init_data_structure),
-            NULL);
+            sizeof(eb_pa_ref_obj_ect_desc_init_data_structure),
+            NULL,
+            scs_ptr->static_config.elastic_shrink_time);
         // Set the SequenceControlSet Picture Pool Fifo Ptrs
         enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->pa_reference_picture_pool_fifo_ptr =
             svt_system_resource_get_producer_fifo(enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index], 0);
@@ -1078,6 +1435,10 @@ static int create_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_i
     EbReferenceObjectDescInitData     eb_ref_obj_ect_desc_init_data_structure;
     EbPictureBufferDescInitData       ref_pic_buf_desc_init_data;
     SequenceControlSet* scs_ptr = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr;
+    EbSystemResource *shared_pool_ptr = NULL;
+    // Cleared, the init data of a shared pool is compared byte per byte
+    memset(&eb_ref_obj_ect_desc_init_data_structure, 0, sizeof(eb_ref_obj_ect_desc_init_data_structure));
+    memset(&ref_pic_buf_desc_init_data, 0, sizeof(ref_pic_buf_desc_init_data));
     EbBool is_16bit = (EbBool)(scs_ptr->static_config.encoder_bit_depth > EB_8BIT);
     // Initialize the various Picture types
     ref_pic_buf_desc_init_data.max_width = scs_ptr->max_input_luma_width;
@@ -1096,6 +1457,7 @@ static int create_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_i
 
     ref_pic_buf_desc_init_data.split_mode = EB_FALSE;
     ref_pic_buf_desc_init_data.down_sampled_filtered = EB_FALSE;
+    ref_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
     if (is_16bit)
         ref_pic_buf_desc_init_data.bit_depth = EB_10BIT;
@@ -1109,21 +1471,115 @@ static int create_ref_buf_descs(EbEncHandle *enc_handle_ptr, uint32_t instance_i
     eb_ref_obj_ect_desc_init_data_structure.hme_sixteenth_luma_recon = scs_ptr->in_loop_me;
 
     // Reference Picture Buffers
+    if (enc_handle_ptr->shared_engine_ptr)
+        shared_pool_ptr = shared_engine_pool(
+            enc_handle_ptr->shared_engine_ptr,
+            &enc_handle_ptr->shared_engine_ptr->reference_picture_pool_ptr,
+            scs_ptr->reference_picture_buffer_min_count,
+            scs_ptr->reference_picture_buffer_init_count,
+            EB_PictureManagerProcessInitCount,
+            svt_reference_object_creator,
+            &(eb_ref_obj_ect_desc_init_data_structure),
+            sizeof(eb_ref_obj_ect_desc_init_data_structure),
+            scs_ptr->static_config.elastic_shrink_time);
+    if (shared_pool_ptr) {
+        // Each channel produces through its own fifos of the shared pool
+        enc_handle_ptr->reference_picture_pool_ptr_array[instance_index] = shared_pool_ptr;
+        enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->reference_picture_pool_fifo_ptr =
+            svt_system_resource_get_producer_fifo(shared_pool_ptr, scs_ptr->static_config.channel_id * EB_PictureManagerProcessInitCount);
+        return 0;
+    }
     EB_NEW(
             enc_handle_ptr->reference_picture_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
+            scs_ptr->reference_picture_buffer_min_count,
             scs_ptr->reference_picture_buffer_init_count,//enc_handle_ptr->ref_pic_pool_total_count,
             EB_PictureManagerProcessInitCount,
             0,
             svt_reference_object_creator,
             &(eb_ref_obj_ect_desc_init_data_structure),
-            NULL);
+            sizeof(eb_ref_obj_ect_desc_init_data_structure),
+            NULL,
+            scs_ptr->static_config.elastic_shrink_time);
 
     enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr->reference_picture_pool_fifo_ptr =
         svt_system_resource_get_producer_fifo(enc_handle_ptr->reference_picture_pool_ptr_array[instance_index], 0);
     return 0;
 }
 
+/**********************************
+* Enable Stage Statistics
+*   Each resource is named after the stage consuming it
+**********************************/
+/**********************************
+* get_pipeline_resources
+*   The input queues of the pipeline stages, NULL for the stages not
+*   created (e.g. no quality metrics without stat report).
+**********************************/
+static void get_pipeline_resources(EbEncHandle *enc_handle_ptr, EbSystemResource **resources) {
+    uint32_t count = 0;
+
+    resources[count++] = enc_handle_ptr->input_buffer_resource_ptr;
+    resources[count++] = enc_handle_ptr->resource_coordination_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->picture_analysis_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->picture_decision_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->motion_estimation_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->initial_rate_control_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->picture_demux_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->pic_mgr_res_srm;
+    resources[count++] = enc_handle_ptr->rate_control_tasks_resource_ptr;
+    resources[count++] = enc_handle_ptr->rate_control_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->enc_dec_tasks_resource_ptr;
+    resources[count++] = enc_handle_ptr->enc_dec_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->dlf_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->cdef_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->rest_results_resource_ptr;
+    resources[count++] = enc_handle_ptr->quality_metrics_tasks_resource_ptr;
+    resources[count++] = enc_handle_ptr->tpl_tasks_resource_ptr;
+    resources[count++] = enc_handle_ptr->entropy_coding_results_resource_ptr;
+    assert(count == PIPELINE_RESOURCE_COUNT);
+}
+
+static EbErrorType enable_stage_stats(EbEncHandle *enc_handle_ptr) {
+    const struct {
+        EbSystemResource *resource_ptr;
+        const char *name;
+    } stages[] = {
+        { enc_handle_ptr->input_buffer_resource_ptr, "ResourceCoordination" },
+        { enc_handle_ptr->resource_coordination_results_resource_ptr, "PictureAnalysis" },
+        { enc_handle_ptr->picture_analysis_results_resource_ptr, "PictureDecision" },
+        { enc_handle_ptr->picture_decision_results_resource_ptr, "MotionEstimation" },
+        { enc_handle_ptr->motion_estimation_results_resource_ptr, "InitialRateControl" },
+        { enc_handle_ptr->initial_rate_control_results_resource_ptr, "SourceBasedOperations" },
+        { enc_handle_ptr->picture_demux_results_resource_ptr, "PictureManager" },
+        { enc_handle_ptr->pic_mgr_res_srm, "InLoopMotionEstimation" },
+        { enc_handle_ptr->tpl_tasks_resource_ptr, "Tpl" },
+        { enc_handle_ptr->rate_control_tasks_resource_ptr, "RateControl" },
+        { enc_handle_ptr->rate_control_results_resource_ptr, "ModeDecisionConfiguration" },
+        { enc_handle_ptr->enc_dec_tasks_resource_ptr, "EncDec" },
+        { enc_handle_ptr->enc_dec_results_resource_ptr, "Deblocking" },
+        { enc_handle_ptr->dlf_results_resource_ptr, "Cdef" },
+        { enc_handle_ptr->cdef_results_resource_ptr, "Restoration" },
+        { enc_handle_ptr->quality_metrics_tasks_resource_ptr, "QualityMetrics" },
+        { enc_handle_ptr->rest_results_resource_ptr, "EntropyCoding" },
+        { enc_handle_ptr->entropy_coding_results_resource_ptr, "Packetization" },
+        { enc_handle_ptr->output_stream_buffer_resource_ptr_array[0], "OutputStream" },
+    };
+    assert(sizeof(stages) / sizeof(stages[0]) <= STAGE_STATS_MAX_COUNT);
+
+    for (uint32_t i = 0; i < sizeof(stages) / sizeof(stages[0]); i++) {
+        // e.g. no quality metrics without stat report
+        if (!stages[i].resource_ptr)
+            continue;
+        EbErrorType return_error = svt_system_resource_enable_stats(stages[i].resource_ptr, stages[i].name);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+        enc_handle_ptr->stage_stats_resource_ptr_array[enc_handle_ptr->stage_stats_count++] =
+            stages[i].resource_ptr;
+    }
+    return EB_ErrorNone;
+}
+
 void init_fn_ptr(void);
 void svt_av1_init_wedge_masks(void);
 /**********************************
@@ -1206,24 +1662,31 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
 
         input_data.enable_tpl_la = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.enable_tpl_la;
         input_data.in_loop_ois = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->in_loop_ois;
+        input_data.alloc_policy = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->large_alloc_policy;
         EB_NEW(
             enc_handle_ptr->picture_parent_control_set_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_min_count,
             enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->picture_control_set_pool_init_count,//enc_handle_ptr->pcs_pool_total_count,
             1,
             0,
             picture_parent_control_set_creator,
             &input_data,
-            NULL);
+            sizeof(input_data),
+            NULL,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.elastic_shrink_time);
         EB_NEW(
             enc_handle_ptr->me_pool_ptr_array[instance_index],
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->me_pool_min_count,
             enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->me_pool_init_count,
             1,
             0,
             me_creator,
             &input_data,
-            NULL);
+            sizeof(input_data),
+            NULL,
+            enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.elastic_shrink_time);
     }
 
     /************************************
@@ -1268,6 +1731,8 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
         input_data.tile_row_count = parent_pcs->av1_cm->tiles_info.tile_rows;
         input_data.tile_column_count = parent_pcs->av1_cm->tiles_info.tile_cols;
         input_data.is_16bit_pipeline = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.is_16bit_pipeline;
+        input_data.alloc_policy = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->large_alloc_policy;
+        input_data.stat_report = enc_handle_ptr->scs_instance_array[instance_index]->scs_ptr->static_config.stat_report;
         EB_NEW(
             enc_handle_ptr->picture_control_set_pool_ptr_array[instance_index],
             svt_system_resource_ctor,
@@ -1283,6 +1748,12 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     * Picture Buffers
     ************************************/
 
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.shared_engine) {
+        return_error = shared_engine_attach(enc_handle_ptr);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+
     // Allocate Resource Arrays
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->reference_picture_pool_ptr_array, enc_handle_ptr->encode_instance_total_count);
     if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->in_loop_me)
@@ -1329,15 +1800,44 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     ************************************/
 
     // EbBufferHeaderType Input
-    EB_NEW(
-        enc_handle_ptr->input_buffer_resource_ptr,
-        svt_system_resource_ctor,
-        enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count,
-        1,
-        EB_ResourceCoordinationProcessInitCount,
-        svt_input_buffer_header_creator,
-        enc_handle_ptr->scs_instance_array[0]->scs_ptr,
-        svt_input_buffer_header_destroyer);
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.release_input) {
+        // The input buffers point to the planes of the application
+        EB_NEW(
+            enc_handle_ptr->input_buffer_resource_ptr,
+            svt_system_resource_elastic_ctor,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_min_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count,
+            1,
+            EB_ResourceCoordinationProcessInitCount,
+            svt_app_input_buffer_header_creator,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr,
+            0,
+            svt_app_input_buffer_header_destroyer,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.elastic_shrink_time);
+        svt_system_resource_set_release_callback(
+            enc_handle_ptr->input_buffer_resource_ptr,
+            release_app_input_buffer,
+            &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config);
+        EbBufferHeaderType blank_input_buffer = {0};
+        return_error = allocate_frame_buffer(
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr, &blank_input_buffer, EB_TRUE);
+        enc_handle_ptr->blank_input_picture_ptr = (EbPictureBufferDesc*)blank_input_buffer.p_buffer;
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    } else {
+        EB_NEW(
+            enc_handle_ptr->input_buffer_resource_ptr,
+            svt_system_resource_elastic_ctor,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_min_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->input_buffer_fifo_init_count,
+            1,
+            EB_ResourceCoordinationProcessInitCount,
+            svt_input_buffer_header_creator,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr,
+            0,
+            svt_input_buffer_header_destroyer,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.elastic_shrink_time);
+    }
 
     enc_handle_ptr->input_buffer_producer_fifo_ptr = svt_system_resource_get_producer_fifo(enc_handle_ptr->input_buffer_resource_ptr, 0);
 
@@ -1409,15 +1909,23 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     {
         PictureDecisionResultInitData picture_decision_result_init_data;
 
+        // The ME threads also post the global motion tasks, up to one per reference but the
+        // first; the resource grows for them rather than blocking the ME threads
+        const uint32_t me_count =
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->motion_estimation_process_init_count;
         EB_NEW(
             enc_handle_ptr->picture_decision_results_resource_ptr,
-            svt_system_resource_ctor,
+            svt_system_resource_elastic_ctor,
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->picture_decision_fifo_init_count,
-            EB_PictureDecisionProcessInitCount,
-            enc_handle_ptr->scs_instance_array[0]->scs_ptr->motion_estimation_process_init_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->picture_decision_fifo_init_count +
+                me_count * (MAX_NUM_OF_REF_PIC_LIST * REF_LIST_MAX_DEPTH - 1),
+            EB_PictureDecisionProcessInitCount + me_count,
+            me_count,
             picture_decision_result_creator,
             &picture_decision_result_init_data,
-            NULL);
+            sizeof(picture_decision_result_init_data),
+            NULL,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.elastic_shrink_time);
     }
 
     // Motion Estimation Results
@@ -1590,6 +2098,35 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
             &rest_result_init_data,
             NULL);
     }
+    //Quality Metrics tasks
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.stat_report) {
+        EntropyCodingResultsInitData quality_metrics_tasks_init_data;
+
+        EB_NEW(
+            enc_handle_ptr->quality_metrics_tasks_resource_ptr,
+            svt_system_resource_ctor,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->quality_metrics_fifo_init_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->rest_process_init_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->quality_metrics_process_init_count,
+            quality_metrics_tasks_creator,
+            &quality_metrics_tasks_init_data,
+            NULL);
+    }
+    //TPL tasks, posted by the stage running tpl_mc_flow: source based operations or
+    //rate control with the in-loop ME
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.enable_tpl_la) {
+        RateControlTasksInitData tpl_tasks_init_data;
+
+        EB_NEW(
+            enc_handle_ptr->tpl_tasks_resource_ptr,
+            svt_system_resource_ctor,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->tpl_fifo_init_count,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->source_based_operations_process_init_count + 1,
+            enc_handle_ptr->scs_instance_array[0]->scs_ptr->tpl_process_init_count,
+            tpl_tasks_creator,
+            &tpl_tasks_init_data,
+            NULL);
+    }
 
     // Entropy Coding Results
     {
@@ -1606,6 +2143,25 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
             NULL);
     }
 
+    // Lets svt_av1_enc_reset sleep until the stages are done with the stream
+    {
+        EbSystemResource *resources[PIPELINE_RESOURCE_COUNT];
+
+        EB_NEW(enc_handle_ptr->pipeline_idle_signal_ptr, svt_idle_signal_ctor);
+        get_pipeline_resources(enc_handle_ptr, resources);
+        for (uint32_t i = 0; i < PIPELINE_RESOURCE_COUNT; i++) {
+            if (resources[i])
+                svt_system_resource_set_idle_signal(resources[i],
+                                                    enc_handle_ptr->pipeline_idle_signal_ptr);
+        }
+    }
+
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.stage_stats) {
+        return_error = enable_stage_stats(enc_handle_ptr);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+
     /************************************
     * App Callbacks
     ************************************/
@@ -1768,6 +2324,32 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
             1 + process_index);
     }
 
+    // Quality Metrics Contexts
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.stat_report) {
+        EB_ALLOC_PTR_ARRAY(enc_handle_ptr->quality_metrics_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->quality_metrics_process_init_count);
+
+        for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->quality_metrics_process_init_count; ++process_index) {
+            EB_NEW(
+                enc_handle_ptr->quality_metrics_context_ptr_array[process_index],
+                quality_metrics_context_ctor,
+                enc_handle_ptr,
+                process_index);
+        }
+    }
+
+    // TPL Contexts
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.enable_tpl_la) {
+        EB_ALLOC_PTR_ARRAY(enc_handle_ptr->tpl_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->tpl_process_init_count);
+
+        for (process_index = 0; process_index < enc_handle_ptr->scs_instance_array[0]->scs_ptr->tpl_process_init_count; ++process_index) {
+            EB_NEW(
+                enc_handle_ptr->tpl_context_ptr_array[process_index],
+                tpl_context_ctor,
+                enc_handle_ptr,
+                process_index);
+        }
+    }
+
     // Entropy Coding Contexts
     EB_ALLOC_PTR_ARRAY(enc_handle_ptr->entropy_coding_context_ptr_array, enc_handle_ptr->scs_instance_array[0]->scs_ptr->entropy_coding_process_init_count);
 
@@ -1789,6 +2371,33 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
         enc_handle_ptr->scs_instance_array[0]->scs_ptr->source_based_operations_process_init_count +
             enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count);
 
+    // Task Scheduler
+    if (enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.task_scheduler) {
+        EbTaskStageInitData task_stage_init_array[] = {
+            {enc_handle_ptr->picture_decision_results_resource_ptr, motion_estimation_task, (EbPtr *)enc_handle_ptr->motion_estimation_context_ptr_array},
+            {enc_handle_ptr->enc_dec_tasks_resource_ptr, mode_decision_task, (EbPtr *)enc_handle_ptr->enc_dec_context_ptr_array},
+            {enc_handle_ptr->dlf_results_resource_ptr, cdef_task, (EbPtr *)enc_handle_ptr->cdef_context_ptr_array},
+            {enc_handle_ptr->rest_results_resource_ptr, entropy_coding_task, (EbPtr *)enc_handle_ptr->entropy_coding_context_ptr_array},
+            {enc_handle_ptr->quality_metrics_tasks_resource_ptr, quality_metrics_task, (EbPtr *)enc_handle_ptr->quality_metrics_context_ptr_array}};
+        // The quality metrics stage only exists with stat_report, it closes the list
+        uint32_t task_stage_count = sizeof(task_stage_init_array) / sizeof(task_stage_init_array[0]);
+        if (!enc_handle_ptr->quality_metrics_tasks_resource_ptr)
+            task_stage_count--;
+        if (!enc_handle_ptr->shared_engine_ptr)
+            EB_NEW(
+                enc_handle_ptr->task_scheduler_ptr,
+                svt_task_scheduler_ctor,
+                enc_handle_ptr->scs_instance_array[0]->scs_ptr->enc_dec_process_init_count,
+                1);
+        EB_NEW(
+            enc_handle_ptr->task_channel_ptr,
+            svt_task_channel_ctor,
+            enc_handle_ptr->task_scheduler_ptr,
+            enc_handle_ptr->shared_engine_ptr ? enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.channel_id : 0,
+            task_stage_init_array,
+            task_stage_count);
+    }
+
     /************************************
     * Thread Handles
     ************************************/
@@ -1808,9 +2417,10 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
     EB_CREATE_THREAD(enc_handle_ptr->picture_decision_thread_handle, picture_decision_kernel, enc_handle_ptr->picture_decision_context_ptr);
 
     // Motion Estimation
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count,
-        motion_estimation_kernel,
-        enc_handle_ptr->motion_estimation_context_ptr_array);
+    if (!config_ptr->task_scheduler)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->motion_estimation_thread_handle_array, control_set_ptr->motion_estimation_process_init_count,
+            motion_estimation_kernel,
+            enc_handle_ptr->motion_estimation_context_ptr_array);
 
     // Initial Rate Control
     EB_CREATE_THREAD(enc_handle_ptr->initial_rate_control_thread_handle, initial_rate_control_kernel, enc_handle_ptr->initial_rate_control_context_ptr);
@@ -1838,29 +2448,50 @@ EB_API EbErrorType svt_av1_enc_init(EbComponentType *svt_enc_component)
 
 
     // EncDec Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count,
-        mode_decision_kernel,
-        enc_handle_ptr->enc_dec_context_ptr_array);
+    if (!config_ptr->task_scheduler)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->enc_dec_thread_handle_array, control_set_ptr->enc_dec_process_init_count,
+            mode_decision_kernel,
+            enc_handle_ptr->enc_dec_context_ptr_array);
 
     // Dlf Process
     EB_CREATE_THREAD_ARRAY(enc_handle_ptr->dlf_thread_handle_array, control_set_ptr->dlf_process_init_count,
-        dlf_kernel,
-        enc_handle_ptr->dlf_context_ptr_array);
+            dlf_kernel,
+            enc_handle_ptr->dlf_context_ptr_array);
 
     // Cdef Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->cdef_thread_handle_array, control_set_ptr->cdef_process_init_count,
-        cdef_kernel,
-        enc_handle_ptr->cdef_context_ptr_array);
+    if (!config_ptr->task_scheduler)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->cdef_thread_handle_array, control_set_ptr->cdef_process_init_count,
+            cdef_kernel,
+            enc_handle_ptr->cdef_context_ptr_array);
 
     // Rest Process
     EB_CREATE_THREAD_ARRAY(enc_handle_ptr->rest_thread_handle_array, control_set_ptr->rest_process_init_count,
-        rest_kernel,
-        enc_handle_ptr->rest_context_ptr_array);
+            rest_kernel,
+            enc_handle_ptr->rest_context_ptr_array);
+
+    // Quality Metrics Process
+    if (!config_ptr->task_scheduler && config_ptr->stat_report)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->quality_metrics_thread_handle_array, control_set_ptr->quality_metrics_process_init_count,
+            quality_metrics_kernel,
+            enc_handle_ptr->quality_metrics_context_ptr_array);
+
+    // TPL Process
+    if (config_ptr->enable_tpl_la)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->tpl_thread_handle_array, control_set_ptr->tpl_process_init_count,
+            tpl_kernel,
+            enc_handle_ptr->tpl_context_ptr_array);
 
     // Entropy Coding Process
-    EB_CREATE_THREAD_ARRAY(enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count,
-        entropy_coding_kernel,
-        enc_handle_ptr->entropy_coding_context_ptr_array);
+    if (!config_ptr->task_scheduler)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->entropy_coding_thread_handle_array, control_set_ptr->entropy_coding_process_init_count,
+            entropy_coding_kernel,
+            enc_handle_ptr->entropy_coding_context_ptr_array);
+
+    // Task Scheduler Workers, the workers of a shared engine are already running
+    if (config_ptr->task_scheduler && !enc_handle_ptr->shared_engine_ptr)
+        EB_CREATE_THREAD_ARRAY(enc_handle_ptr->task_worker_thread_handle_array, enc_handle_ptr->task_scheduler_ptr->worker_count,
+            svt_task_worker_kernel,
+            enc_handle_ptr->task_scheduler_ptr->worker_ptr_array);
 
     // Packetization
     EB_CREATE_THREAD(enc_handle_ptr->packetization_thread_handle, packetization_kernel, enc_handle_ptr->packetization_context_ptr);
@@ -1882,6 +2513,9 @@ EB_API EbErrorType svt_av1_enc_deinit(EbComponentType *svt_enc_component){
 
     EbEncHandle *handle = (EbEncHandle*)svt_enc_component->p_component_private;
     if (handle) {
+        // The workers of a shared engine keep serving the other channels
+        if (!handle->shared_engine_ptr)
+            svt_task_scheduler_shutdown(handle->task_scheduler_ptr);
         svt_shutdown_process(handle->input_buffer_resource_ptr);
         svt_shutdown_process(handle->resource_coordination_results_resource_ptr);
         svt_shutdown_process(handle->picture_analysis_results_resource_ptr);
@@ -1898,11 +2532,141 @@ EB_API EbErrorType svt_av1_enc_deinit(EbComponentType *svt_enc_component){
         svt_shutdown_process(handle->dlf_results_resource_ptr);
         svt_shutdown_process(handle->cdef_results_resource_ptr);
         svt_shutdown_process(handle->rest_results_resource_ptr);
+        svt_shutdown_process(handle->quality_metrics_tasks_resource_ptr);
+        svt_shutdown_process(handle->tpl_tasks_resource_ptr);
     }
 
     return EB_ErrorNone;
 }
 
+/**********************************
+* wait_pipeline_idle
+*   Returns once no stage has an object queued or in process.
+**********************************/
+static void wait_pipeline_idle(EbEncHandle *enc_handle_ptr) {
+    EbSystemResource *resources[PIPELINE_RESOURCE_COUNT];
+
+    get_pipeline_resources(enc_handle_ptr, resources);
+    svt_system_resource_wait_idle(
+        resources, PIPELINE_RESOURCE_COUNT, enc_handle_ptr->pipeline_idle_signal_ptr);
+}
+
+/**********************************
+* reclaim_stream_objects
+*   Gives back the pictures the stages keep across pictures: the
+*   references, the look ahead and the pictures waiting for their end
+*   of stream. The shared pools only give back the objects of the channel.
+**********************************/
+static void reclaim_stream_objects(EbEncHandle *enc_handle_ptr) {
+    svt_system_resource_reclaim(enc_handle_ptr->scs_pool_ptr, NULL);
+    svt_system_resource_reclaim(enc_handle_ptr->input_buffer_resource_ptr, NULL);
+    for (uint32_t instance_index = 0; instance_index < enc_handle_ptr->encode_instance_total_count; ++instance_index) {
+        EncodeContext *encode_context_ptr = enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr;
+        const EbBool   shared             = enc_handle_ptr->shared_engine_ptr != NULL;
+
+        svt_system_resource_reclaim(enc_handle_ptr->picture_parent_control_set_pool_ptr_array[instance_index], NULL);
+        svt_system_resource_reclaim(enc_handle_ptr->picture_control_set_pool_ptr_array[instance_index], NULL);
+        svt_system_resource_reclaim(enc_handle_ptr->me_pool_ptr_array[instance_index], NULL);
+        svt_system_resource_reclaim(enc_handle_ptr->reference_picture_pool_ptr_array[instance_index],
+            shared ? encode_context_ptr->reference_picture_pool_fifo_ptr : NULL);
+        svt_system_resource_reclaim(enc_handle_ptr->pa_reference_picture_pool_ptr_array[instance_index],
+            shared ? encode_context_ptr->pa_reference_picture_pool_fifo_ptr : NULL);
+        if (enc_handle_ptr->down_scaled_picture_pool_ptr_array)
+            svt_system_resource_reclaim(enc_handle_ptr->down_scaled_picture_pool_ptr_array[instance_index], NULL);
+        if (enc_handle_ptr->overlay_input_picture_pool_ptr_array[instance_index])
+            svt_system_resource_reclaim(enc_handle_ptr->overlay_input_picture_pool_ptr_array[instance_index], NULL);
+    }
+}
+
+/**********************************
+* Reset Encoder Library for a new stream
+**********************************/
+EB_API EbErrorType svt_av1_enc_reset(EbComponentType *svt_enc_component){
+    if(svt_enc_component == NULL)
+        return EB_ErrorBadParameter;
+
+    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
+    if (!enc_handle_ptr || !enc_handle_ptr->eos_delivered)
+        return EB_ErrorBadParameter;
+    const EbSvtAv1EncConfiguration *config = &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config;
+    if (config->rc_firstpass_stats_out || config->rc_twopass_stats_in.sz) {
+        SVT_LOG("Error: svt_av1_enc_reset does not support multi-pass encoding\n");
+        return EB_ErrorBadParameter;
+    }
+
+    // The stages are done with the stream once the last of them is waiting for input
+    wait_pipeline_idle(enc_handle_ptr);
+    reclaim_stream_objects(enc_handle_ptr);
+
+    for (uint32_t instance_index = 0; instance_index < enc_handle_ptr->encode_instance_total_count; ++instance_index) {
+        EbErrorType return_error =
+            encode_context_reset(enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
+    resource_coordination_context_reset(enc_handle_ptr->resource_coordination_context_ptr);
+    picture_decision_context_reset(enc_handle_ptr->picture_decision_context_ptr);
+    picture_manager_context_reset(enc_handle_ptr->picture_manager_context_ptr);
+    EbErrorType return_error =
+        rate_control_context_reset(enc_handle_ptr->rate_control_context_ptr, enc_handle_ptr);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    packetization_context_reset(enc_handle_ptr->packetization_context_ptr);
+    enc_handle_ptr->eos_delivered = EB_FALSE;
+    enc_handle_ptr->sent_picture_count = 0;
+
+    return EB_ErrorNone;
+}
+
+/**********************************
+* Update the rate control targets
+**********************************/
+EB_API EbErrorType svt_av1_enc_update_rate_control(EbComponentType *svt_enc_component,
+                                                   const SvtAv1RateControlTargets *targets){
+    if(svt_enc_component == NULL || targets == NULL)
+        return EB_ErrorBadParameter;
+
+    EbEncHandle *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
+    if (!enc_handle_ptr)
+        return EB_ErrorBadParameter;
+    const EbSvtAv1EncConfiguration *config = &enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config;
+    if (config->rate_control_mode == 0) {
+        SVT_LOG("Error: svt_av1_enc_update_rate_control needs RateControlMode 1 or 2\n");
+        return EB_ErrorBadParameter;
+    }
+    if (config->rc_firstpass_stats_out || config->rc_twopass_stats_in.sz) {
+        SVT_LOG("Error: svt_av1_enc_update_rate_control does not support multi-pass encoding\n");
+        return EB_ErrorBadParameter;
+    }
+    if (targets->target_bit_rate == 0) {
+        SVT_LOG("Error: TargetBitRate must be greater than 0\n");
+        return EB_ErrorBadParameter;
+    }
+    if (targets->max_qp_allowed > MAX_QP_VALUE) {
+        SVT_LOG("Error: MaxQpAllowed must be [0 - %d]\n", MAX_QP_VALUE);
+        return EB_ErrorBadParameter;
+    }
+    if (targets->min_qp_allowed >= MAX_QP_VALUE) {
+        SVT_LOG("Error: MinQpAllowed must be [0 - %d]\n", MAX_QP_VALUE - 1);
+        return EB_ErrorBadParameter;
+    }
+    if (targets->min_qp_allowed > targets->max_qp_allowed) {
+        SVT_LOG("Error: MinQpAllowed must be smaller than MaxQpAllowed\n");
+        return EB_ErrorBadParameter;
+    }
+
+    // Picked up by the picture decision when it starts a mini-GOP with the next picture sent
+    for (uint32_t instance_index = 0; instance_index < enc_handle_ptr->encode_instance_total_count; ++instance_index) {
+        EncodeContext *encode_context_ptr = enc_handle_ptr->scs_instance_array[instance_index]->encode_context_ptr;
+        svt_block_on_mutex(encode_context_ptr->rc_targets_mutex);
+        encode_context_ptr->rc_targets_pending      = *targets;
+        encode_context_ptr->rc_targets_pending_flag = EB_TRUE;
+        encode_context_ptr->rc_targets_pending_picture_number = enc_handle_ptr->sent_picture_count;
+        svt_release_mutex(encode_context_ptr->rc_targets_mutex);
+    }
+    return EB_ErrorNone;
+}
+
 EbErrorType svt_svt_enc_init_parameter(
     EbSvtAv1EncConfiguration * config_ptr);
 
@@ -2078,6 +2842,8 @@ void set_param_based_on_input(SequenceControlSet *scs_ptr)
     scs_ptr->chroma_height = scs_ptr->max_input_luma_height >> subsampling_y;
     scs_ptr->seq_header.max_frame_width = scs_ptr->max_input_luma_width;
     scs_ptr->seq_header.max_frame_height = scs_ptr->max_input_luma_height;
+    scs_ptr->large_alloc_policy = svt_large_alloc_policy(
+        scs_ptr->static_config.huge_pages, scs_ptr->static_config.target_socket);
     scs_ptr->static_config.source_width = scs_ptr->max_input_luma_width;
     scs_ptr->static_config.source_height = scs_ptr->max_input_luma_height;
 
@@ -2311,6 +3077,7 @@ void copy_api_from_app(
     // Adaptive Loop Filter
     scs_ptr->static_config.tile_rows = ((EbSvtAv1EncConfiguration*)config_struct)->tile_rows;
     scs_ptr->static_config.tile_columns = ((EbSvtAv1EncConfiguration*)config_struct)->tile_columns;
+    scs_ptr->static_config.tile_parallel_enc_dec = ((EbSvtAv1EncConfiguration*)config_struct)->tile_parallel_enc_dec;
     scs_ptr->static_config.unrestricted_motion_vector = ((EbSvtAv1EncConfiguration*)config_struct)->unrestricted_motion_vector;
 
     // Rate Control
@@ -2385,6 +3152,22 @@ void copy_api_from_app(
     scs_ptr->static_config.logical_processors = ((EbSvtAv1EncConfiguration*)config_struct)->logical_processors;
     scs_ptr->static_config.unpin = ((EbSvtAv1EncConfiguration*)config_struct)->unpin;
     scs_ptr->static_config.target_socket = ((EbSvtAv1EncConfiguration*)config_struct)->target_socket;
+    scs_ptr->static_config.task_scheduler = ((EbSvtAv1EncConfiguration*)config_struct)->task_scheduler;
+    scs_ptr->static_config.stage_stats = ((EbSvtAv1EncConfiguration*)config_struct)->stage_stats;
+    scs_ptr->static_config.write_packet = ((EbSvtAv1EncConfiguration*)config_struct)->write_packet;
+    scs_ptr->static_config.write_packet_priv =
+        ((EbSvtAv1EncConfiguration*)config_struct)->write_packet_priv;
+    scs_ptr->static_config.release_input = ((EbSvtAv1EncConfiguration*)config_struct)->release_input;
+    scs_ptr->static_config.release_input_priv =
+        ((EbSvtAv1EncConfiguration*)config_struct)->release_input_priv;
+    scs_ptr->static_config.elastic_buffers = ((EbSvtAv1EncConfiguration*)config_struct)->elastic_buffers;
+    scs_ptr->static_config.elastic_shrink_time =
+        ((EbSvtAv1EncConfiguration*)config_struct)->elastic_shrink_time;
+    scs_ptr->static_config.shared_engine = ((EbSvtAv1EncConfiguration*)config_struct)->shared_engine;
+    scs_ptr->static_config.huge_pages = ((EbSvtAv1EncConfiguration*)config_struct)->huge_pages;
+    // The channels of a shared engine run their segment based stages on its scheduler
+    if (scs_ptr->static_config.shared_engine)
+        scs_ptr->static_config.task_scheduler = 1;
     if ((scs_ptr->static_config.unpin == 1) && (scs_ptr->static_config.target_socket != -1)){
         SVT_WARN("unpin 1 and ss %d is not a valid combination: unpin will be set to 0\n", scs_ptr->static_config.target_socket);
         scs_ptr->static_config.unpin = 0;
@@ -3025,6 +3808,42 @@ static EbErrorType verify_settings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->release_input &&
+        (config->encoder_bit_depth != EB_8BIT || config->encoder_color_format != EB_YUV420)) {
+        SVT_LOG("Error instance %u: release_input only supports 8-bit 4:2:0 input\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->shared_engine && config->channel_id >= config->active_channel_count) {
+        SVT_LOG("Error instance %u: the channel id of a shared engine must be below the active channel count\n", channel_number + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->huge_pages > 2) {
+        SVT_LOG("Error instance %u: invalid huge pages mode [0 - 2], your input: %u\n", channel_number + 1, config->huge_pages);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->task_scheduler > 1) {
+        SVT_LOG("Error instance %u: invalid task scheduler flag [0 - 1], your input: %u\n", channel_number + 1, config->task_scheduler);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->stage_stats > 1) {
+        SVT_LOG("Error instance %u: invalid stage stats flag [0 - 1], your input: %u\n", channel_number + 1, config->stage_stats);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->elastic_buffers > 1) {
+        SVT_LOG("Error instance %u: invalid elastic buffers flag [0 - 1], your input: %u\n", channel_number + 1, config->elastic_buffers);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->tile_parallel_enc_dec > 1) {
+        SVT_LOG("Error instance %u: invalid tile parallel flag [0 - 1], your input: %u\n", channel_number + 1, config->tile_parallel_enc_dec);
+        return_error = EB_ErrorBadParameter;
+    }
+
     /* Warnings about the use of features that are incomplete */
     if (config->rc_twopass_stats_in.sz || config->rc_firstpass_stats_out) {
         SVT_WARN("The 2-pass encoding support is a work-in-progress, it is only available for experimental and further development uses and should not be used for benchmarking until fully implemented.\n");
@@ -3061,6 +3880,7 @@ EbErrorType svt_svt_enc_init_parameter(
     config_ptr->stat_report = 0;
     config_ptr->tile_rows = 0;
     config_ptr->tile_columns = 0;
+    config_ptr->tile_parallel_enc_dec = 0;
 
     config_ptr->qp = 50;
     config_ptr->use_qp_file = EB_FALSE;
@@ -3177,6 +3997,16 @@ EbErrorType svt_svt_enc_init_parameter(
     config_ptr->logical_processors = 0;
     config_ptr->unpin = 1;
     config_ptr->target_socket = -1;
+    config_ptr->task_scheduler = 0;
+    config_ptr->stage_stats = 0;
+    config_ptr->write_packet = NULL;
+    config_ptr->write_packet_priv = NULL;
+    config_ptr->release_input = NULL;
+    config_ptr->release_input_priv = NULL;
+    config_ptr->elastic_buffers = 0;
+    config_ptr->elastic_shrink_time = 0;
+    config_ptr->shared_engine = 0;
+    config_ptr->huge_pages = 0;
     config_ptr->channel_id = 0;
     config_ptr->active_channel_count = 1;
 
@@ -3582,8 +4412,7 @@ static EbErrorType copy_frame_buffer(
     }
     return return_error;
 }
-static void copy_input_buffer(
-    SequenceControlSet*    sequenceControlSet,
+static void copy_input_header(
     EbBufferHeaderType*     dst,
     EbBufferHeaderType*     src
 )
@@ -3597,12 +4426,105 @@ static void copy_input_buffer(
     dst->size = src->size;
     dst->qp = src->qp;
     dst->pic_type = src->pic_type;
+}
+static void copy_input_buffer(
+    SequenceControlSet*    sequenceControlSet,
+    EbBufferHeaderType*     dst,
+    EbBufferHeaderType*     src
+)
+{
+    copy_input_header(dst, src);
 
     // Copy the picture buffer
     if (src->p_buffer != NULL)
         copy_frame_buffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
 }
 
+/***********************************************
+**** release_input mode: the input planes must
+**** follow the layout of the library buffers
+************************************************/
+static EbBool app_planes_overlap(
+    uintptr_t                       a_start,
+    size_t                          a_size,
+    uintptr_t                       b_start,
+    size_t                          b_size)
+{
+    return a_start < b_start + b_size && b_start < a_start + a_size;
+}
+static EbErrorType check_app_input_planes(
+    const EbEncHandle              *enc_handle_ptr,
+    const EbSvtIOFormat            *input_ptr)
+{
+    const SequenceControlSet  *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    const EbPictureBufferDesc *layout_ptr = enc_handle_ptr->blank_input_picture_ptr;
+
+    if (!input_ptr->luma || !input_ptr->cb || !input_ptr->cr ||
+        input_ptr->y_stride != layout_ptr->stride_y ||
+        input_ptr->cb_stride != layout_ptr->stride_cb ||
+        input_ptr->cr_stride != layout_ptr->stride_cr) {
+        SVT_ERROR("input planes do not follow the layout of svt_av1_enc_get_input_layout\n");
+        return EB_ErrorBadParameter;
+    }
+    // Each plane spans its padding on all sides, as the library buffer it stands for
+    const size_t luma_buffer_offset =
+        (size_t)layout_ptr->stride_y * scs_ptr->top_padding + scs_ptr->left_padding;
+    const size_t chroma_buffer_offset =
+        (size_t)layout_ptr->stride_cr * (scs_ptr->top_padding >> 1) +
+        (scs_ptr->left_padding >> 1);
+    const uintptr_t luma_start = (uintptr_t)input_ptr->luma - luma_buffer_offset;
+    const uintptr_t cb_start = (uintptr_t)input_ptr->cb - chroma_buffer_offset;
+    const uintptr_t cr_start = (uintptr_t)input_ptr->cr - chroma_buffer_offset;
+
+    if ((uintptr_t)input_ptr->luma < luma_buffer_offset ||
+        (uintptr_t)input_ptr->cb < chroma_buffer_offset ||
+        (uintptr_t)input_ptr->cr < chroma_buffer_offset ||
+        app_planes_overlap(luma_start, layout_ptr->luma_size,
+            cb_start, layout_ptr->chroma_size) ||
+        app_planes_overlap(luma_start, layout_ptr->luma_size,
+            cr_start, layout_ptr->chroma_size) ||
+        app_planes_overlap(cb_start, layout_ptr->chroma_size,
+            cr_start, layout_ptr->chroma_size)) {
+        SVT_ERROR("input planes do not leave the padding of svt_av1_enc_get_input_layout\n");
+        return EB_ErrorBadParameter;
+    }
+    return EB_ErrorNone;
+}
+
+/***********************************************
+**** release_input mode: point the library
+**** buffer to the planes of the application
+************************************************/
+static void reference_input_buffer(
+    const EbEncHandle      *enc_handle_ptr,
+    EbAppInputBuffer       *dst,
+    EbBufferHeaderType     *src)
+{
+    const SequenceControlSet *scs_ptr = enc_handle_ptr->scs_instance_array[0]->scs_ptr;
+    EbPictureBufferDesc *input_picture_ptr = (EbPictureBufferDesc*)dst->header.p_buffer;
+    EbSvtIOFormat       *input_ptr = (EbSvtIOFormat*)src->p_buffer;
+
+    copy_input_header(&dst->header, src);
+    if (input_ptr) {
+        const uint32_t luma_buffer_offset =
+            input_picture_ptr->stride_y * scs_ptr->top_padding + scs_ptr->left_padding;
+        const uint32_t chroma_buffer_offset =
+            input_picture_ptr->stride_cr * (scs_ptr->top_padding >> 1) +
+            (scs_ptr->left_padding >> 1);
+        input_picture_ptr->buffer_y = input_ptr->luma - luma_buffer_offset;
+        input_picture_ptr->buffer_cb = input_ptr->cb - chroma_buffer_offset;
+        input_picture_ptr->buffer_cr = input_ptr->cr - chroma_buffer_offset;
+        dst->app_planes = *input_ptr;
+        dst->app_private = src->p_app_private;
+        dst->holds_app_planes = EB_TRUE;
+    } else {
+        // No picture with the end of stream, the pipeline still reads one
+        input_picture_ptr->buffer_y = enc_handle_ptr->blank_input_picture_ptr->buffer_y;
+        input_picture_ptr->buffer_cb = enc_handle_ptr->blank_input_picture_ptr->buffer_cb;
+        input_picture_ptr->buffer_cr = enc_handle_ptr->blank_input_picture_ptr->buffer_cr;
+    }
+}
+
 /**********************************
 * Empty This Buffer
 **********************************/
@@ -3612,6 +4534,15 @@ EB_API EbErrorType svt_av1_enc_send_picture(
 {
     EbEncHandle          *enc_handle_ptr = (EbEncHandle*)svt_enc_component->p_component_private;
     EbObjectWrapper      *eb_wrapper_ptr;
+    const EbBool          release_input =
+        enc_handle_ptr->scs_instance_array[0]->scs_ptr->static_config.release_input != NULL;
+
+    if (release_input && p_buffer != NULL && p_buffer->p_buffer != NULL) {
+        EbErrorType return_error = check_app_input_planes(
+            enc_handle_ptr, (EbSvtIOFormat*)p_buffer->p_buffer);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+    }
 
     // Take the buffer and put it into our internal queue structure
     svt_get_empty_object(
@@ -3619,10 +4550,18 @@ EB_API EbErrorType svt_av1_enc_send_picture(
         &eb_wrapper_ptr);
 
     if (p_buffer != NULL) {
-        copy_input_buffer(
-            enc_handle_ptr->scs_instance_array[0]->scs_ptr,
-            (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr,
-            p_buffer);
+        if (release_input)
+            reference_input_buffer(
+                enc_handle_ptr,
+                (EbAppInputBuffer*)eb_wrapper_ptr->object_ptr,
+                p_buffer);
+        else
+            copy_input_buffer(
+                enc_handle_ptr->scs_instance_array[0]->scs_ptr,
+                (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr,
+                p_buffer);
+        if (!(p_buffer->flags & EB_BUFFERFLAG_EOS))
+            enc_handle_ptr->sent_picture_count++;
     }
 
     svt_post_full_object(eb_wrapper_ptr);
@@ -3675,6 +4614,8 @@ EB_API EbErrorType svt_av1_enc_get_packet(
         packet = (EbBufferHeaderType*)eb_wrapper_ptr->object_ptr;
         if ( packet->flags & 0xfffffff0 )
             return_error = EB_ErrorMax;
+        if (packet->flags & EB_BUFFERFLAG_EOS)
+            enc_handle->eos_delivered = EB_TRUE;
         // return the output stream buffer
         *p_buffer = packet;
 
@@ -3801,7 +4742,8 @@ EbErrorType init_svt_av1_encoder_handle(
 
 static EbErrorType allocate_frame_buffer(
     SequenceControlSet       *scs_ptr,
-    EbBufferHeaderType        *input_buffer)
+    EbBufferHeaderType        *input_buffer,
+    EbBool                     alloc_planes)
 {
     EbErrorType   return_error = EB_ErrorNone;
     EbPictureBufferDescInitData input_pic_buf_desc_init_data;
@@ -3830,10 +4772,13 @@ static EbErrorType allocate_frame_buffer(
 
     input_pic_buf_desc_init_data.buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
     input_pic_buf_desc_init_data.is_16bit_pipeline = 0;
+    input_pic_buf_desc_init_data.alloc_policy = scs_ptr->large_alloc_policy;
 
     if (is_16bit && config->compressed_ten_bit_format == 1)
         //do special allocation for 2bit data down below.
         input_pic_buf_desc_init_data.split_mode = EB_FALSE;
+    if (!alloc_planes)
+        input_pic_buf_desc_init_data.buffer_enable_mask = 0;
 
     // Enhanced Picture Buffer
     {
@@ -3843,18 +4788,24 @@ static EbErrorType allocate_frame_buffer(
             svt_picture_buffer_desc_ctor,
             (EbPtr)&input_pic_buf_desc_init_data);
         input_buffer->p_buffer = (uint8_t*)buf;
+        // The planes are set per picture, the dctor frees nothing once they are reset to NULL
+        if (!alloc_planes)
+            buf->buffer_enable_mask = PICTURE_BUFFER_DESC_FULL_MASK;
 
         if (is_16bit && config->compressed_ten_bit_format == 1) {
             //pack 4 2bit pixels into 1Byte
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_y,
+            EB_CALLOC_LARGE_ARRAY(buf->buffer_bit_inc_y,
                  (input_pic_buf_desc_init_data.max_width / 4)*
-                 (input_pic_buf_desc_init_data.max_height));
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_cb,
+                 (input_pic_buf_desc_init_data.max_height),
+                 &input_pic_buf_desc_init_data.alloc_policy);
+            EB_CALLOC_LARGE_ARRAY(buf->buffer_bit_inc_cb,
                  (input_pic_buf_desc_init_data.max_width / 8)*
-                 (input_pic_buf_desc_init_data.max_height / 2));
-            EB_MALLOC_ALIGNED_ARRAY(buf->buffer_bit_inc_cr,
+                 (input_pic_buf_desc_init_data.max_height / 2),
+                 &input_pic_buf_desc_init_data.alloc_policy);
+            EB_CALLOC_LARGE_ARRAY(buf->buffer_bit_inc_cr,
                  (input_pic_buf_desc_init_data.max_width / 8)*
-                 (input_pic_buf_desc_init_data.max_height / 2));
+                 (input_pic_buf_desc_init_data.max_height / 2),
+                 &input_pic_buf_desc_init_data.alloc_policy);
         }
     }
 
@@ -3879,7 +4830,8 @@ EbErrorType svt_input_buffer_header_creator(
 
     return_error = allocate_frame_buffer(
         scs_ptr,
-        input_buffer);
+        input_buffer,
+        EB_TRUE);
     if (return_error != EB_ErrorNone)
         return return_error;
 
@@ -3888,20 +4840,77 @@ EbErrorType svt_input_buffer_header_creator(
     return EB_ErrorNone;
 }
 
+/**************************************
+* EbBufferHeaderType Constructor of the release_input mode,
+* the planes are those of the application
+**************************************/
+EbErrorType svt_app_input_buffer_header_creator(
+    EbPtr *object_dbl_ptr,
+    EbPtr  object_init_data_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+    EbAppInputBuffer* input_buffer;
+    SequenceControlSet        *scs_ptr = (SequenceControlSet*)object_init_data_ptr;
+
+    *object_dbl_ptr = NULL;
+    EB_CALLOC(input_buffer, 1, sizeof(EbAppInputBuffer));
+    *object_dbl_ptr = (EbPtr)input_buffer;
+    input_buffer->header.size = sizeof(EbBufferHeaderType);
+
+    return_error = allocate_frame_buffer(
+        scs_ptr,
+        &input_buffer->header,
+        EB_FALSE);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+
+    return EB_ErrorNone;
+}
+
 void svt_input_buffer_header_destroyer(    EbPtr p)
 {
     EbBufferHeaderType *obj = (EbBufferHeaderType*)p;
     EbPictureBufferDesc* buf = (EbPictureBufferDesc*)obj->p_buffer;
     if (buf) {
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_y);
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cb);
-        EB_FREE_ALIGNED_ARRAY(buf->buffer_bit_inc_cr);
+        EB_FREE_LARGE_ARRAY(buf->buffer_bit_inc_y);
+        EB_FREE_LARGE_ARRAY(buf->buffer_bit_inc_cb);
+        EB_FREE_LARGE_ARRAY(buf->buffer_bit_inc_cr);
     }
 
     EB_DELETE(buf);
     EB_FREE(obj);
 }
 
+static void reset_app_input_planes(EbAppInputBuffer *input_buffer) {
+    EbPictureBufferDesc *buf = (EbPictureBufferDesc*)input_buffer->header.p_buffer;
+    buf->buffer_y = NULL;
+    buf->buffer_cb = NULL;
+    buf->buffer_cr = NULL;
+}
+
+void svt_app_input_buffer_header_destroyer(    EbPtr p)
+{
+    EbAppInputBuffer *obj = (EbAppInputBuffer*)p;
+    if (obj->header.p_buffer)
+        reset_app_input_planes(obj);
+    svt_input_buffer_header_destroyer(&obj->header);
+}
+
+/* Object release callback of the input buffers in the release_input mode */
+static void release_app_input_buffer(EbPtr object_ptr, void *priv)
+{
+    EbAppInputBuffer *input_buffer = (EbAppInputBuffer*)object_ptr;
+    const EbSvtAv1EncConfiguration *config = (const EbSvtAv1EncConfiguration*)priv;
+
+    reset_app_input_planes(input_buffer);
+    if (input_buffer->holds_app_planes) {
+        input_buffer->holds_app_planes = EB_FALSE;
+        config->release_input(config->release_input_priv,
+                              &input_buffer->app_planes,
+                              input_buffer->app_private);
+    }
+}
+
 /**************************************
 * EbBufferHeaderType Constructor
 **************************************/
@@ -3928,6 +4937,7 @@ EbErrorType svt_output_buffer_header_creator(
 void svt_output_buffer_header_destroyer(    EbPtr p)
 {
     EbBufferHeaderType* obj = (EbBufferHeaderType*)p;
+    EB_FREE(obj->p_buffer);
     EB_FREE(obj);
 }
 
@@ -3990,4 +5000,68 @@ EB_API EbErrorType svt_av1_enc_get_stream_info(EbComponentType *    svt_enc_comp
     }
     return EB_ErrorBadParameter;
 }
+
+/**********************************
+* svt_av1_enc_get_stage_stats get the statistics of the pipeline stages
+**********************************/
+EB_API EbErrorType svt_av1_enc_get_stage_stats(EbComponentType *svt_enc_component,
+                                               SvtAv1StageStats *stats, uint32_t *stage_count)
+{
+    if (svt_enc_component == NULL || stage_count == NULL)
+        return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle = (EbEncHandle*)svt_enc_component->p_component_private;
+    if (!enc_handle->stage_stats_count)
+        return EB_ErrorBadParameter;
+    if (stats == NULL) {
+        *stage_count = enc_handle->stage_stats_count;
+        return EB_ErrorNone;
+    }
+
+    *stage_count = MIN(*stage_count, enc_handle->stage_stats_count);
+    for (uint32_t i = 0; i < *stage_count; i++) {
+        const EbSystemResource *resource_ptr = enc_handle->stage_stats_resource_ptr_array[i];
+        EbResourceStats *       resource_stats = resource_ptr->stats;
+        SvtAv1StageStats *      stage = &stats[i];
+
+        stage->name = resource_stats->name;
+        // The scheduled stages share the task scheduler workers
+        stage->process_count = resource_ptr->full_queue->task_stage_ptr
+            ? 0 : resource_ptr->full_queue->process_total_count;
+
+        svt_block_on_mutex(resource_stats->lockout_mutex);
+        stage->max_queue_depth = resource_stats->max_queue_depth;
+        stage->posted_count = resource_stats->posted_count;
+        stage->queue_depth_sum = resource_stats->queue_depth_sum;
+        stage->queue_time = resource_stats->queue_time;
+        stage->max_queue_time = resource_stats->max_queue_time;
+        stage->busy_time = resource_stats->busy_time;
+        stage->empty_wait_time = resource_stats->empty_wait_time;
+        svt_release_mutex(resource_stats->lockout_mutex);
+    }
+    return EB_ErrorNone;
+}
+
+/**********************************
+* svt_av1_enc_get_input_layout get the layout of the input planes in the release_input mode
+**********************************/
+EB_API EbErrorType svt_av1_enc_get_input_layout(EbComponentType *  svt_enc_component,
+                                                SvtAv1InputLayout *layout)
+{
+    if (svt_enc_component == NULL || layout == NULL)
+        return EB_ErrorBadParameter;
+    EbEncHandle *enc_handle = (EbEncHandle*)svt_enc_component->p_component_private;
+    const EbPictureBufferDesc *layout_ptr = enc_handle->blank_input_picture_ptr;
+    if (!layout_ptr)
+        return EB_ErrorBadParameter;
+
+    const SequenceControlSet *scs_ptr = enc_handle->scs_instance_array[0]->scs_ptr;
+    layout->y_stride = layout_ptr->stride_y;
+    layout->chroma_stride = layout_ptr->stride_cb;
+    layout->left_padding = scs_ptr->left_padding;
+    layout->top_padding = scs_ptr->top_padding;
+    // The picture is padded to the aligned height in place
+    layout->bottom_padding = layout_ptr->height + layout_ptr->origin_bot_y -
+        (scs_ptr->max_input_luma_height - scs_ptr->max_input_pad_bottom);
+    return EB_ErrorNone;
+}
 // clang-format on
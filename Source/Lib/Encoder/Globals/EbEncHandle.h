@@ -16,9 +16,15 @@
 #include "EbSvtAv1Enc.h"
 #include "EbPictureBufferDesc.h"
 #include "EbSystemResourceManager.h"
+#include "EbTaskScheduler.h"
 #include "EbSequenceControlSet.h"
 #include "EbObject.h"
 
+// One input queue per pipeline stage plus the output stream queue
+#define STAGE_STATS_MAX_COUNT 20
+// The input queues of the pipeline stages
+#define PIPELINE_RESOURCE_COUNT 18
+
 struct _EbThreadContext {
     EbDctor dctor;
     EbPtr   priv;
@@ -76,9 +82,19 @@ struct _EbEncHandle {
     EbHandle *dlf_thread_handle_array;
     EbHandle *cdef_thread_handle_array;
     EbHandle *rest_thread_handle_array;
+    EbHandle *quality_metrics_thread_handle_array;
+    EbHandle *tpl_thread_handle_array;
 
     EbHandle packetization_thread_handle;
 
+    // Shared workers of the stages run on the task scheduler
+    EbTaskScheduler *task_scheduler_ptr;
+    EbHandle *       task_worker_thread_handle_array;
+    EbTaskChannel *  task_channel_ptr;
+    // shared_engine_ptr - owns task_scheduler_ptr and the shared reference
+    //   picture pools when the encoder runs on a shared engine
+    struct EbSharedEngine *shared_engine_ptr;
+
     // Contexts
     EbThreadContext * resource_coordination_context_ptr;
     EbThreadContext **picture_analysis_context_ptr_array;
@@ -95,6 +111,8 @@ struct _EbEncHandle {
     EbThreadContext **dlf_context_ptr_array;
     EbThreadContext **cdef_context_ptr_array;
     EbThreadContext **rest_context_ptr_array;
+    EbThreadContext **quality_metrics_context_ptr_array;
+    EbThreadContext **tpl_context_ptr_array;
     EbThreadContext * packetization_context_ptr;
 
     // System Resource Managers
@@ -117,6 +135,17 @@ struct _EbEncHandle {
     EbSystemResource * dlf_results_resource_ptr;
     EbSystemResource * cdef_results_resource_ptr;
     EbSystemResource * rest_results_resource_ptr;
+    EbSystemResource * quality_metrics_tasks_resource_ptr;
+    EbSystemResource * tpl_tasks_resource_ptr;
+    // stage_stats_resource_ptr_array - the stage inputs with statistics
+    EbSystemResource * stage_stats_resource_ptr_array[STAGE_STATS_MAX_COUNT];
+    uint32_t           stage_stats_count;
+    // pipeline_idle_signal_ptr - posted when a stage input goes idle, see
+    //   svt_av1_enc_reset
+    EbIdleSignal *pipeline_idle_signal_ptr;
+    // blank_input_picture_ptr - planes of the input buffers sent without planes
+    //   (end of stream) when the input planes belong to the application
+    EbPictureBufferDesc *blank_input_picture_ptr;
 
     // Callbacks
     EbCallback **app_callback_ptr_array;
@@ -124,6 +153,12 @@ struct _EbEncHandle {
     EbFifo *input_buffer_producer_fifo_ptr;
     EbFifo *output_stream_buffer_consumer_fifo_ptr;
     EbFifo *output_recon_buffer_consumer_fifo_ptr;
+
+    // eos_delivered - the application got the end of stream packet,
+    //   svt_av1_enc_reset may start a new stream
+    EbBool eos_delivered;
+    // sent_picture_count - pictures given to svt_av1_enc_send_picture in this stream
+    uint64_t sent_picture_count;
 };
 
 #endif // EbEncHandle_h
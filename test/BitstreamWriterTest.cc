@@ -20,6 +20,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <random>
+#include <vector>
 #include "EbCabacContextModel.h"
 #if defined(CHAR_BIT)
 #undef CHAR_BIT  // defined in clang/9.1.0/include/limits.h
@@ -29,6 +30,7 @@
 #include "EbDecHandle.h"
 #include "EbDecBitReader.h"
 #include "EbDecParseFrame.h"
+#include "EbTime.h"
 #include "gtest/gtest.h"
 #include "random.h"
 
@@ -293,4 +295,158 @@ TEST(Entropy_BitstreamWriter, write_symbol_with_update) {
                   rnd(gen));
     }
 }
+
+// Start from an evenly spread CDF of nsymbs symbols in an array of cdf_size
+// entries
+static void init_uniform_cdf(AomCdfProb *cdf, const int nsymbs,
+                             const int cdf_size) {
+    for (int i = 0; i < nsymbs; ++i)
+        cdf[i] = AOM_ICDF((i + 1) * CDF_PROB_TOP / nsymbs);
+    for (int i = nsymbs; i < cdf_size; ++i)
+        cdf[i] = 0;
+}
+
+// Writes num_symbols symbols of an alphabet of nsymbs, most of them small
+// like the coefficient levels, and returns the size of the stream.
+static uint32_t write_symbols(uint8_t *stream_buffer, uint8_t *symbols,
+                              const int num_symbols, const int nsymbs,
+                              const int allow_update) {
+    std::geometric_distribution<int> rnd(0.4);
+    std::mt19937 gen(deterministic_seeds + nsymbs);
+    for (int i = 0; i < num_symbols; ++i)
+        symbols[i] = rnd(gen) % nsymbs;
+
+    DECLARE_ALIGNED(16, AomCdfProb, cdf[CDF_SIZE(16)]);
+    init_uniform_cdf(cdf, nsymbs, CDF_SIZE(16));
+    AomWriter bw;
+    memset(&bw, 0, sizeof(bw));
+    bw.allow_update_cdf = allow_update;
+    aom_start_encode(&bw, stream_buffer);
+    for (int i = 0; i < num_symbols; ++i)
+        aom_write_symbol(&bw, symbols[i], cdf, nsymbs);
+    aom_stop_encode(&bw);
+    return bw.pos;
+}
+
+TEST(Entropy_BitstreamWriter, write_symbol_all_alphabets) {
+    const int num_symbols = 5000;
+    const int buffer_size = 4 * num_symbols;
+    std::vector<uint8_t> stream_buffer(buffer_size);
+    std::vector<uint8_t> symbols(num_symbols);
+
+    for (int nsymbs = 2; nsymbs <= 16; ++nsymbs) {
+        for (int allow_update = 0; allow_update <= 1; ++allow_update) {
+            const uint32_t size = write_symbols(stream_buffer.data(),
+                                                symbols.data(),
+                                                num_symbols,
+                                                nsymbs,
+                                                allow_update);
+
+            DECLARE_ALIGNED(16, AomCdfProb, cdf[CDF_SIZE(16)]);
+            init_uniform_cdf(cdf, nsymbs, CDF_SIZE(16));
+            SvtReader br;
+            init_svt_reader(&br,
+                            stream_buffer.data(),
+                            stream_buffer.data() + buffer_size,
+                            size,
+                            allow_update);
+            for (int i = 0; i < num_symbols; ++i)
+                ASSERT_EQ(svt_read_symbol(&br, cdf, nsymbs, nullptr),
+                          symbols[i])
+                    << "nsymbs " << nsymbs << " update " << allow_update
+                    << " pos " << i;
+        }
+    }
+}
+
+// The CDF tables of FRAME_CONTEXT may end right after the counter, e.g.
+// uv_mode_cdf with its 14 symbols: reading and adapting a CDF must not touch
+// the entries past it
+TEST(Entropy_BitstreamWriter, read_symbol_exact_cdf_size) {
+    const int num_symbols = 1000;
+    const int buffer_size = 4 * num_symbols;
+    std::vector<uint8_t> stream_buffer(buffer_size);
+    std::vector<uint8_t> symbols(num_symbols);
+
+    for (int nsymbs = 2; nsymbs <= 16; ++nsymbs) {
+        const uint32_t size = write_symbols(
+            stream_buffer.data(), symbols.data(), num_symbols, nsymbs, 1);
+
+        // Exactly the size of the CDF, so that the address sanitizer catches
+        // an access past it, and a CDF followed by entries which must stay
+        // unchanged
+        std::vector<AomCdfProb> cdf(CDF_SIZE(nsymbs));
+        DECLARE_ALIGNED(16, AomCdfProb, guarded_cdf[CDF_SIZE(16) + 8]);
+        init_uniform_cdf(cdf.data(), nsymbs, CDF_SIZE(nsymbs));
+        init_uniform_cdf(guarded_cdf, nsymbs, CDF_SIZE(nsymbs));
+        for (int i = CDF_SIZE(nsymbs); i < CDF_SIZE(16) + 8; ++i)
+            guarded_cdf[i] = (AomCdfProb)(0x5a5a + i);
+        SvtReader br, guarded_br;
+        init_svt_reader(&br,
+                        stream_buffer.data(),
+                        stream_buffer.data() + buffer_size,
+                        size,
+                        1);
+        init_svt_reader(&guarded_br,
+                        stream_buffer.data(),
+                        stream_buffer.data() + buffer_size,
+                        size,
+                        1);
+        for (int i = 0; i < num_symbols; ++i) {
+            ASSERT_EQ(svt_read_symbol(&br, cdf.data(), nsymbs, nullptr),
+                      symbols[i])
+                << "nsymbs " << nsymbs << " pos " << i;
+            ASSERT_EQ(
+                svt_read_symbol(&guarded_br, guarded_cdf, nsymbs, nullptr),
+                symbols[i])
+                << "nsymbs " << nsymbs << " pos " << i;
+        }
+        for (int i = CDF_SIZE(nsymbs); i < CDF_SIZE(16) + 8; ++i)
+            ASSERT_EQ(guarded_cdf[i], (AomCdfProb)(0x5a5a + i))
+                << "nsymbs " << nsymbs << " entry " << i;
+    }
+}
+
+// Reports the time to read and adapt a symbol for each alphabet size
+TEST(Entropy_BitstreamWriter, DISABLED_speed_read_symbol) {
+    const int num_symbols = 1000000;
+    const int num_loop = 10;
+    const int buffer_size = 4 * num_symbols;
+    std::vector<uint8_t> stream_buffer(buffer_size);
+    std::vector<uint8_t> symbols(num_symbols);
+
+    printf("Average Nanoseconds per Symbol\n");
+    for (int nsymbs = 2; nsymbs <= 16; ++nsymbs) {
+        const uint32_t size = write_symbols(
+            stream_buffer.data(), symbols.data(), num_symbols, nsymbs, 1);
+        uint64_t start_time_seconds, start_time_useconds;
+        uint64_t finish_time_seconds, finish_time_useconds;
+        int sum = 0;
+
+        svt_av1_get_time(&start_time_seconds, &start_time_useconds);
+        for (int loop = 0; loop < num_loop; ++loop) {
+            DECLARE_ALIGNED(16, AomCdfProb, cdf[CDF_SIZE(16)]);
+            init_uniform_cdf(cdf, nsymbs, CDF_SIZE(16));
+            SvtReader br;
+            init_svt_reader(&br,
+                            stream_buffer.data(),
+                            stream_buffer.data() + buffer_size,
+                            size,
+                            1);
+            for (int i = 0; i < num_symbols; ++i)
+                sum += svt_read_symbol(&br, cdf, nsymbs, nullptr);
+        }
+        svt_av1_get_time(&finish_time_seconds, &finish_time_useconds);
+        const double time =
+            svt_av1_compute_overall_elapsed_time_ms(start_time_seconds,
+                                                    start_time_useconds,
+                                                    finish_time_seconds,
+                                                    finish_time_useconds);
+
+        EXPECT_GT(sum, 0);
+        printf("    svt_read_symbol(), %2d symbols : %6.2f\n",
+               nsymbs,
+               1000000 * time / num_loop / num_symbols);
+    }
+}
 }  // namespace
@@ -25,9 +25,12 @@
 #include "EbUtility.h"
 #include "FilmGrainExpectedResult.h"
 #include "acm_random.h"
+#include "random.h"
 #include "noise_model.h"
 #include "aom_dsp_rtcd.h"
 
+using svt_av1_test_tool::SVTRandom;
+
 static AomFilmGrain film_grain_test_vectors[3] = {
     /* Test 1 */
     {
@@ -267,6 +270,255 @@ TEST_F(AddFilmGrainTest, MatchTest) {
     }
 }
 
+// Stripes are independent, so adding them in reverse order must match the
+// whole picture run
+TEST_F(AddFilmGrainTest, StripeOrderTest) {
+    SVTRandom rnd(8, false);
+    uint8_t *luma_ref = (uint8_t *)svt_aom_malloc(luma_size);
+    uint8_t *cb_ref = (uint8_t *)svt_aom_malloc(chroma_size);
+    uint8_t *cr_ref = (uint8_t *)svt_aom_malloc(chroma_size);
+
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < luma_size; ++j)
+            luma_[j] = luma_ref[j] = rnd.random();
+        for (int j = 0; j < chroma_size; ++j) {
+            cb_[j] = cb_ref[j] = rnd.random();
+            cr_[j] = cr_ref[j] = rnd.random();
+        }
+
+        svt_av1_add_film_grain_run(film_grain_test_vectors + i,
+                                   luma_ref,
+                                   cb_ref,
+                                   cr_ref,
+                                   kHeight,
+                                   kWidth,
+                                   kWidth,
+                                   kWidth / 2,
+                                   0,
+                                   1,
+                                   1);
+
+        FilmGrainFrame fg;
+        const int32_t num_stripes =
+            svt_av1_film_grain_frame_init(&fg,
+                                          film_grain_test_vectors + i,
+                                          luma_,
+                                          cb_,
+                                          cr_,
+                                          kHeight,
+                                          kWidth,
+                                          kWidth,
+                                          kWidth / 2,
+                                          0,
+                                          1,
+                                          1);
+        for (int32_t stripe = num_stripes - 1; stripe >= 0; --stripe)
+            svt_av1_add_film_grain_stripe(&fg, stripe);
+        svt_av1_film_grain_frame_free(&fg);
+
+        EXPECT_EQ(memcmp(luma_, luma_ref, luma_size), 0);
+        EXPECT_EQ(memcmp(cb_, cb_ref, chroma_size), 0);
+        EXPECT_EQ(memcmp(cr_, cr_ref, chroma_size), 0);
+    }
+
+    svt_aom_free(luma_ref);
+    svt_aom_free(cb_ref);
+    svt_aom_free(cr_ref);
+}
+
+/**
+ * @brief Unit test for the grain blending kernels:
+ * - svt_av1_add_luma_grain_avx2
+ * - svt_av1_add_luma_grain_hbd_avx2
+ * - svt_av1_add_chroma_grain_avx2
+ * - svt_av1_add_chroma_grain_hbd_avx2
+ *
+ * Random pixels, grain and scaling tables are blended by the C and the AVX2
+ * kernels on blocks of every width up to 32, and the outputs must match.
+ */
+class AddGrainKernelTest : public ::testing::TestWithParam<int> {
+  protected:
+    static const int kBlock = 32;
+    static const int kStride = 2 * kBlock + 8;
+
+    AddGrainKernelTest() : rnd_(16, false) {
+    }
+
+    void prepare(int bd) {
+        const int grain_range = 256 << (bd - 8);
+        for (int i = 0; i < kStride * kStride; ++i) {
+            luma_[i] = rnd_.random() >> (16 - bd);
+            ref_[i] = tst_[i] = rnd_.random() >> (16 - bd);
+            grain_[i] = rnd_.random() % grain_range - (grain_range >> 1);
+        }
+        for (int i = 0; i < 256; ++i)
+            lut_[i] = rnd_.random() >> 8;
+        lut_[256] = lut_[255];
+    }
+
+    void run_luma(int bd) {
+        for (int h = 1; h <= kBlock; ++h) {
+            for (int w = 1; w <= kBlock; ++w) {
+                prepare(bd);
+                const int32_t sh = 8 + rnd_.random() % 4;
+                const int32_t max = (256 << (bd - 8)) - 1;
+                if (bd == 8) {
+                    uint8_t ref[kStride * kStride], tst[kStride * kStride];
+                    for (int i = 0; i < kStride * kStride; ++i)
+                        ref[i] = tst[i] = (uint8_t)ref_[i];
+                    svt_av1_add_luma_grain_c(
+                        ref, kStride, grain_, kStride, w, h, lut_, sh, 16, 235);
+                    svt_av1_add_luma_grain_avx2(
+                        tst, kStride, grain_, kStride, w, h, lut_, sh, 16, 235);
+                    ASSERT_EQ(memcmp(ref, tst, sizeof(ref)), 0)
+                        << "w " << w << " h " << h;
+                } else {
+                    svt_av1_add_luma_grain_hbd_c(ref_,
+                                                 kStride,
+                                                 grain_,
+                                                 kStride,
+                                                 w,
+                                                 h,
+                                                 lut_,
+                                                 sh,
+                                                 0,
+                                                 max,
+                                                 bd);
+                    svt_av1_add_luma_grain_hbd_avx2(tst_,
+                                                    kStride,
+                                                    grain_,
+                                                    kStride,
+                                                    w,
+                                                    h,
+                                                    lut_,
+                                                    sh,
+                                                    0,
+                                                    max,
+                                                    bd);
+                    ASSERT_EQ(memcmp(ref_, tst_, sizeof(ref_)), 0)
+                        << "w " << w << " h " << h;
+                }
+            }
+        }
+    }
+
+    void run_chroma(int bd, int sy, int sx) {
+        for (int h = 1; h <= (kBlock >> sy); ++h) {
+            for (int w = 1; w <= (kBlock >> sx); ++w) {
+                prepare(bd);
+                const int32_t sh = 8 + rnd_.random() % 4;
+                const int32_t m = rnd_.random() >> 8;
+                const int32_t lm = rnd_.random() >> 8;
+                const int32_t off = rnd_.random() >> 7;
+                const int32_t max = (256 << (bd - 8)) - 1;
+                if (bd == 8) {
+                    uint8_t luma8[kStride * kStride];
+                    uint8_t ref[kStride * kStride], tst[kStride * kStride];
+                    for (int i = 0; i < kStride * kStride; ++i) {
+                        luma8[i] = (uint8_t)luma_[i];
+                        ref[i] = tst[i] = (uint8_t)ref_[i];
+                    }
+                    svt_av1_add_chroma_grain_c(luma8,
+                                               kStride,
+                                               ref,
+                                               kStride,
+                                               grain_,
+                                               kStride,
+                                               w,
+                                               h,
+                                               lut_,
+                                               m,
+                                               lm,
+                                               off,
+                                               sh,
+                                               16,
+                                               240,
+                                               sy,
+                                               sx);
+                    svt_av1_add_chroma_grain_avx2(luma8,
+                                                  kStride,
+                                                  tst,
+                                                  kStride,
+                                                  grain_,
+                                                  kStride,
+                                                  w,
+                                                  h,
+                                                  lut_,
+                                                  m,
+                                                  lm,
+                                                  off,
+                                                  sh,
+                                                  16,
+                                                  240,
+                                                  sy,
+                                                  sx);
+                    ASSERT_EQ(memcmp(ref, tst, sizeof(ref)), 0)
+                        << "w " << w << " h " << h;
+                } else {
+                    svt_av1_add_chroma_grain_hbd_c(luma_,
+                                                   kStride,
+                                                   ref_,
+                                                   kStride,
+                                                   grain_,
+                                                   kStride,
+                                                   w,
+                                                   h,
+                                                   lut_,
+                                                   m,
+                                                   lm,
+                                                   off,
+                                                   sh,
+                                                   0,
+                                                   max,
+                                                   bd,
+                                                   sy,
+                                                   sx);
+                    svt_av1_add_chroma_grain_hbd_avx2(luma_,
+                                                      kStride,
+                                                      tst_,
+                                                      kStride,
+                                                      grain_,
+                                                      kStride,
+                                                      w,
+                                                      h,
+                                                      lut_,
+                                                      m,
+                                                      lm,
+                                                      off,
+                                                      sh,
+                                                      0,
+                                                      max,
+                                                      bd,
+                                                      sy,
+                                                      sx);
+                    ASSERT_EQ(memcmp(ref_, tst_, sizeof(ref_)), 0)
+                        << "w " << w << " h " << h;
+                }
+            }
+        }
+    }
+
+    uint16_t luma_[kStride * kStride];
+    SVTRandom rnd_;
+    uint16_t ref_[kStride * kStride];
+    uint16_t tst_[kStride * kStride];
+    int32_t grain_[kStride * kStride];
+    int32_t lut_[257];
+};
+
+TEST_P(AddGrainKernelTest, LumaMatchTest) {
+    run_luma(GetParam());
+}
+
+TEST_P(AddGrainKernelTest, ChromaMatchTest) {
+    for (int sy = 0; sy <= 1; ++sy)
+        for (int sx = sy; sx <= 1; ++sx)
+            run_chroma(GetParam(), sy, sx);
+}
+
+INSTANTIATE_TEST_CASE_P(FilmGrain, AddGrainKernelTest,
+                        ::testing::Values(8, 10, 12));
+
 extern "C" {
 #include "EbPictureControlSet.h"
 #include "EbPictureBufferDesc.h"
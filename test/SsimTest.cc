@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+ */
+
+/******************************************************************************
+ * @file SsimTest.cc
+ *
+ * @brief Unit test of the SSIM window statistics:
+ * - svt_aom_ssim_parms_8x8_sse2
+ * - svt_aom_highbd_ssim_parms_8x8_sse2
+ *
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+#include "util.h"
+
+namespace {
+using svt_av1_test_tool::SVTRandom;
+
+typedef void (*SsimParmsFunc)(const uint8_t *s, int sp, const uint8_t *r, int rp,
+                              uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+                              uint32_t *sum_sq_r, uint32_t *sum_sxr);
+typedef void (*HbdSsimParmsFunc)(const uint8_t *s, int sp, const uint8_t *sinc, int spinc,
+                                 const uint16_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r,
+                                 uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
+static const int kStride    = 24;
+static const int kTestTimes = 10000;
+
+class SsimParmsTest : public ::testing::TestWithParam<SsimParmsFunc> {
+  protected:
+    void run_test(const int max_value) {
+        SVTRandom rnd(0, max_value);
+        uint8_t   src[8 * kStride], ref[8 * kStride];
+        for (int t = 0; t < kTestTimes; t++) {
+            for (int i = 0; i < 8 * kStride; i++) {
+                src[i] = rnd.random();
+                ref[i] = rnd.random();
+            }
+            // The sums are accumulated, start both from the same value
+            const uint32_t init        = (uint32_t)t;
+            uint32_t       ref_sums[5] = {init, init, init, init, init};
+            uint32_t       tst_sums[5] = {init, init, init, init, init};
+            svt_aom_ssim_parms_8x8_c(src, kStride, ref, kStride, &ref_sums[0], &ref_sums[1],
+                                     &ref_sums[2], &ref_sums[3], &ref_sums[4]);
+            GetParam()(src, kStride, ref, kStride, &tst_sums[0], &tst_sums[1], &tst_sums[2],
+                       &tst_sums[3], &tst_sums[4]);
+            for (int i = 0; i < 5; i++)
+                ASSERT_EQ(ref_sums[i], tst_sums[i]) << "sum " << i << " iteration " << t;
+        }
+    }
+};
+
+TEST_P(SsimParmsTest, MatchTest) {
+    run_test((1 << 8) - 1);
+}
+
+INSTANTIATE_TEST_CASE_P(SSE2, SsimParmsTest, ::testing::Values(svt_aom_ssim_parms_8x8_sse2));
+
+class HbdSsimParmsTest : public ::testing::TestWithParam<HbdSsimParmsFunc> {
+  protected:
+    void run_test(const int max_value) {
+        SVTRandom rnd(0, max_value);
+        uint8_t   src[8 * kStride], src_inc[8 * kStride];
+        uint16_t  ref[8 * kStride];
+        for (int t = 0; t < kTestTimes; t++) {
+            for (int i = 0; i < 8 * kStride; i++) {
+                const int s = rnd.random();
+                src[i]      = (uint8_t)(s >> 2);
+                src_inc[i]  = (uint8_t)((s & 3) << 6);
+                ref[i]      = (uint16_t)rnd.random();
+            }
+            const uint32_t init        = (uint32_t)t;
+            uint32_t       ref_sums[5] = {init, init, init, init, init};
+            uint32_t       tst_sums[5] = {init, init, init, init, init};
+            svt_aom_highbd_ssim_parms_8x8_c(src, kStride, src_inc, kStride, ref, kStride,
+                                            &ref_sums[0], &ref_sums[1], &ref_sums[2],
+                                            &ref_sums[3], &ref_sums[4]);
+            GetParam()(src, kStride, src_inc, kStride, ref, kStride, &tst_sums[0],
+                       &tst_sums[1], &tst_sums[2], &tst_sums[3], &tst_sums[4]);
+            for (int i = 0; i < 5; i++)
+                ASSERT_EQ(ref_sums[i], tst_sums[i]) << "sum " << i << " iteration " << t;
+        }
+    }
+};
+
+TEST_P(HbdSsimParmsTest, MatchTest) {
+    run_test((1 << 10) - 1);
+}
+
+INSTANTIATE_TEST_CASE_P(SSE2, HbdSsimParmsTest,
+                        ::testing::Values(svt_aom_highbd_ssim_parms_8x8_sse2));
+
+}  // namespace
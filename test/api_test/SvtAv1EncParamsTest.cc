@@ -429,4 +429,32 @@ PARAM_TEST(EncParamAltRefsFramesNumTest);
 DEFINE_PARAM_TEST_CLASS(EncParamEnableOverlaysTest, enable_overlays);
 PARAM_TEST(EncParamEnableOverlaysTest);
 
+/** Test case for task_scheduler*/
+DEFINE_PARAM_TEST_CLASS(EncParamTaskSchedulerTest, task_scheduler);
+PARAM_TEST(EncParamTaskSchedulerTest);
+
+/** Test case for stage_stats*/
+DEFINE_PARAM_TEST_CLASS(EncParamStageStatsTest, stage_stats);
+PARAM_TEST(EncParamStageStatsTest);
+
+/** Test case for elastic_buffers*/
+DEFINE_PARAM_TEST_CLASS(EncParamElasticBuffersTest, elastic_buffers);
+PARAM_TEST(EncParamElasticBuffersTest);
+
+/** Test case for elastic_shrink_time*/
+DEFINE_PARAM_TEST_CLASS(EncParamElasticShrinkTimeTest, elastic_shrink_time);
+PARAM_TEST(EncParamElasticShrinkTimeTest);
+
+/** Test case for shared_engine*/
+DEFINE_PARAM_TEST_CLASS(EncParamSharedEngineTest, shared_engine);
+PARAM_TEST(EncParamSharedEngineTest);
+
+/** Test case for huge_pages*/
+DEFINE_PARAM_TEST_CLASS(EncParamHugePagesTest, huge_pages);
+PARAM_TEST(EncParamHugePagesTest);
+
+/** Test case for tile_parallel_enc_dec*/
+DEFINE_PARAM_TEST_CLASS(EncParamTileParallelEncDecTest, tile_parallel_enc_dec);
+PARAM_TEST(EncParamTileParallelEncDecTest);
+
 }  // namespace
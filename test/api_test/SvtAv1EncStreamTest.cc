@@ -0,0 +1,592 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file SvtAv1EncStreamTest.cc
+ *
+ * @brief SVT-AV1 encoder api test, check the api calls made while a stream is
+ * encoded
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+const uint32_t stream_width = 128;
+const uint32_t stream_height = 128;
+
+/** PacketInfo keeps what the tests check of each packet */
+struct PacketInfo {
+    int64_t pts;
+    uint32_t qp;
+    uint32_t size;
+};
+
+/** StreamEncoder drives one encoder through a short stream of synthetic 8-bit
+ * 4:2:0 pictures and collects the bitstream */
+class StreamEncoder {
+  public:
+    StreamEncoder() : eos_(false) {
+        memset(&context_, 0, sizeof(context_));
+        luma_.resize(stream_width * stream_height);
+        cb_.resize(stream_width * stream_height / 4);
+        cr_.resize(stream_width * stream_height / 4);
+    }
+
+    /** Creates the handle, after which the parameters can be changed */
+    EbErrorType create() {
+        EbErrorType ret = svt_av1_enc_init_handle(
+            &context_.enc_handle, &context_, &context_.enc_params);
+        if (ret != EB_ErrorNone)
+            return ret;
+        context_.enc_params.source_width = stream_width;
+        context_.enc_params.source_height = stream_height;
+        context_.enc_params.enc_mode = 8;
+        context_.enc_params.logical_processors = 2;
+        return EB_ErrorNone;
+    }
+
+    EbErrorType open() {
+        EbErrorType ret =
+            svt_av1_enc_set_parameter(context_.enc_handle, &context_.enc_params);
+        if (ret != EB_ErrorNone)
+            return ret;
+        return svt_av1_enc_init(context_.enc_handle);
+    }
+
+    void close() {
+        if (!context_.enc_handle)
+            return;
+        EXPECT_EQ(EB_ErrorNone, svt_av1_enc_deinit(context_.enc_handle));
+        EXPECT_EQ(EB_ErrorNone, svt_av1_enc_deinit_handle(context_.enc_handle));
+        context_.enc_handle = nullptr;
+    }
+
+    /** Fills the planes with a moving gradient and some noise, seeded by the
+     * picture index so every encoder sees the same pictures */
+    static void fill_picture(uint32_t index, uint8_t *luma, uint32_t luma_stride,
+                             uint8_t *cb, uint8_t *cr, uint32_t chroma_stride) {
+        uint32_t seed = index * 2654435761u + 1;
+        for (uint32_t y = 0; y < stream_height; ++y) {
+            for (uint32_t x = 0; x < stream_width; ++x) {
+                seed = seed * 1103515245u + 12345u;
+                luma[y * luma_stride + x] =
+                    (uint8_t)(x + 2 * y + 3 * index + ((seed >> 16) & 7));
+            }
+        }
+        for (uint32_t y = 0; y < stream_height / 2; ++y) {
+            for (uint32_t x = 0; x < stream_width / 2; ++x) {
+                cb[y * chroma_stride + x] = (uint8_t)(96 + ((x + index) & 63));
+                cr[y * chroma_stride + x] = (uint8_t)(160 - ((y + index) & 63));
+            }
+        }
+    }
+
+    EbErrorType send_picture(uint32_t index) {
+        EbSvtIOFormat picture;
+        EbBufferHeaderType header;
+        memset(&picture, 0, sizeof(picture));
+        memset(&header, 0, sizeof(header));
+        fill_picture(index,
+                     luma_.data(),
+                     stream_width,
+                     cb_.data(),
+                     cr_.data(),
+                     stream_width / 2);
+        picture.luma = luma_.data();
+        picture.cb = cb_.data();
+        picture.cr = cr_.data();
+        picture.y_stride = stream_width;
+        picture.cb_stride = stream_width / 2;
+        picture.cr_stride = stream_width / 2;
+        picture.width = stream_width;
+        picture.height = stream_height;
+        picture.color_fmt = EB_YUV420;
+        picture.bit_depth = EB_EIGHT_BIT;
+        header.size = sizeof(header);
+        header.p_buffer = (uint8_t *)&picture;
+        header.n_filled_len = (uint32_t)(luma_.size() + cb_.size() + cr_.size());
+        header.n_alloc_len = header.n_filled_len;
+        header.pts = index;
+        header.pic_type = EB_AV1_INVALID_PICTURE;
+        return svt_av1_enc_send_picture(context_.enc_handle, &header);
+    }
+
+    EbErrorType send_eos() {
+        EbBufferHeaderType header;
+        memset(&header, 0, sizeof(header));
+        header.size = sizeof(header);
+        header.flags = EB_BUFFERFLAG_EOS;
+        header.pic_type = EB_AV1_INVALID_PICTURE;
+        return svt_av1_enc_send_picture(context_.enc_handle, &header);
+    }
+
+    /** Appends the waiting packets to the stream, returns false on an encode
+     * error. With done set, waits for the end of the stream */
+    bool drain(bool done) {
+        while (!eos_) {
+            EbBufferHeaderType *header = nullptr;
+            EbErrorType ret =
+                svt_av1_enc_get_packet(context_.enc_handle, &header, done);
+            if (ret == EB_NoErrorEmptyQueue)
+                return true;
+            if (ret != EB_ErrorNone)
+                return false;
+            if (header->p_buffer) {
+                stream_.insert(stream_.end(),
+                               header->p_buffer,
+                               header->p_buffer + header->n_filled_len);
+                packet_array_.push_back(
+                    {header->pts, header->qp, header->n_filled_len});
+            }
+            eos_ = (header->flags & EB_BUFFERFLAG_EOS) != 0;
+            svt_av1_enc_release_out_buffer(&header);
+        }
+        return true;
+    }
+
+    /** Drains until the end of the stream or until timeout_ms elapsed, returns
+     * whether the stream ended */
+    bool drain_for(uint32_t timeout_ms) {
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(timeout_ms);
+        while (drain(false) && !eos_ &&
+               std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return eos_;
+    }
+
+    /** Sends frame_count pictures and the end of stream, then collects the
+     * whole bitstream */
+    bool encode(uint32_t frame_count) {
+        for (uint32_t index = 0; index < frame_count; ++index) {
+            if (send_picture(index) != EB_ErrorNone || !drain(false))
+                return false;
+        }
+        return send_eos() == EB_ErrorNone && drain(true) && eos_;
+    }
+
+    SvtAv1Context context_;
+    std::vector<uint8_t> stream_;
+    std::vector<PacketInfo> packet_array_;
+    bool eos_;
+
+  private:
+    std::vector<uint8_t> luma_;
+    std::vector<uint8_t> cb_;
+    std::vector<uint8_t> cr_;
+};
+
+/** @brief shared_engine_channels_progress_independently is a api test case
+ * EncApiTest.shared_engine_channels_progress_independently checks that a
+ * channel of a shared engine whose application stopped reading the packets
+ * does not hold up the other channels
+ *
+ * Test strategy: <br>
+ * Open two encoders on one shared engine. Keep sending pictures to the first
+ * one from another thread without reading its packets, and encode a whole
+ * stream with the second one meanwhile. Then read the packets of the first
+ * one until the end of its stream.
+ *
+ * Expected result: <br>
+ * The second encoder reaches the end of its stream while the first one is
+ * stalled, and both streams are complete.
+ *
+ * Test coverage:
+ * shared_engine, channel_id, active_channel_count.
+ */
+TEST(EncApiTest, shared_engine_channels_progress_independently) {
+    const uint32_t frame_count = 40;
+    StreamEncoder stalled, running;
+
+    ASSERT_EQ(EB_ErrorNone, stalled.create());
+    ASSERT_EQ(EB_ErrorNone, running.create());
+    for (StreamEncoder *encoder : {&stalled, &running}) {
+        encoder->context_.enc_params.shared_engine = 1;
+        encoder->context_.enc_params.active_channel_count = 2;
+    }
+    stalled.context_.enc_params.channel_id = 0;
+    running.context_.enc_params.channel_id = 1;
+    ASSERT_EQ(EB_ErrorNone, stalled.open());
+    ASSERT_EQ(EB_ErrorNone, running.open());
+
+    // The pictures of the stalled channel fill its pipeline, send_picture may
+    // block until its packets are read
+    std::thread sender([&stalled, frame_count]() {
+        for (uint32_t index = 0; index < frame_count; ++index)
+            stalled.send_picture(index);
+        stalled.send_eos();
+    });
+
+    for (uint32_t index = 0; index < frame_count; ++index) {
+        ASSERT_EQ(EB_ErrorNone, running.send_picture(index));
+        ASSERT_TRUE(running.drain(false));
+    }
+    ASSERT_EQ(EB_ErrorNone, running.send_eos());
+    const bool running_done = running.drain_for(60000);
+    EXPECT_TRUE(running_done)
+        << "the channel did not progress while the other one was stalled";
+
+    EXPECT_TRUE(stalled.drain(true));
+    sender.join();
+    EXPECT_TRUE(stalled.eos_);
+    EXPECT_FALSE(stalled.stream_.empty());
+    EXPECT_FALSE(running.stream_.empty());
+
+    if (running_done) {
+        running.close();
+        stalled.close();
+    }
+}
+
+/** InputPlanes holds one picture in the layout given by
+ * svt_av1_enc_get_input_layout, for the release_input mode */
+struct InputPlanes {
+    InputPlanes(const SvtAv1InputLayout &layout, uint32_t index) : index_(index) {
+        const uint32_t luma_rows =
+            layout.top_padding + stream_height + layout.bottom_padding;
+        luma_.resize(layout.y_stride * luma_rows);
+        cb_.resize(layout.chroma_stride * (luma_rows >> 1));
+        cr_.resize(layout.chroma_stride * (luma_rows >> 1));
+        memset(&format_, 0, sizeof(format_));
+        format_.luma = luma_.data() + layout.y_stride * layout.top_padding +
+                       layout.left_padding;
+        format_.cb = cb_.data() +
+                     layout.chroma_stride * (layout.top_padding >> 1) +
+                     (layout.left_padding >> 1);
+        format_.cr = cr_.data() +
+                     layout.chroma_stride * (layout.top_padding >> 1) +
+                     (layout.left_padding >> 1);
+        format_.y_stride = layout.y_stride;
+        format_.cb_stride = layout.chroma_stride;
+        format_.cr_stride = layout.chroma_stride;
+        format_.width = stream_width;
+        format_.height = stream_height;
+        format_.color_fmt = EB_YUV420;
+        format_.bit_depth = EB_EIGHT_BIT;
+        StreamEncoder::fill_picture(index,
+                                    format_.luma,
+                                    format_.y_stride,
+                                    format_.cb,
+                                    format_.cr,
+                                    format_.cb_stride);
+    }
+
+    EbErrorType send(EbComponentType *enc_handle, EbSvtIOFormat *format) {
+        EbBufferHeaderType header;
+        memset(&header, 0, sizeof(header));
+        header.size = sizeof(header);
+        header.p_buffer = (uint8_t *)format;
+        header.n_filled_len = (uint32_t)(luma_.size() + cb_.size() + cr_.size());
+        header.n_alloc_len = header.n_filled_len;
+        header.pts = index_;
+        header.pic_type = EB_AV1_INVALID_PICTURE;
+        header.p_app_private = this;
+        return svt_av1_enc_send_picture(enc_handle, &header);
+    }
+
+    uint32_t index_;
+    EbSvtIOFormat format_;
+    std::vector<uint8_t> luma_;
+    std::vector<uint8_t> cb_;
+    std::vector<uint8_t> cr_;
+};
+
+/** ReleasedInputs records the pictures given back through release_input */
+struct ReleasedInputs {
+    static void release(void *priv, const EbSvtIOFormat *planes,
+                        void *p_app_private) {
+        ReleasedInputs *released = (ReleasedInputs *)priv;
+        InputPlanes *input = (InputPlanes *)p_app_private;
+        std::lock_guard<std::mutex> lock(released->mutex_);
+        released->planes_match_ &= planes->luma == input->format_.luma &&
+                                   planes->cb == input->format_.cb &&
+                                   planes->cr == input->format_.cr;
+        released->index_array_.push_back(input->index_);
+    }
+
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_array_.size();
+    }
+
+    std::mutex mutex_;
+    std::vector<uint32_t> index_array_;
+    bool planes_match_ = true;
+};
+
+/** @brief release_input_references_app_planes is a api test case
+ * EncApiTest.release_input_references_app_planes checks that the encoder
+ * works on the planes of the application with release_input set
+ *
+ * Test strategy: <br>
+ * Encode a stream with the input planes copied, then the same stream with
+ * release_input set and planes allocated in the layout of
+ * svt_av1_enc_get_input_layout. Before it, send planes with a wrong stride
+ * and planes whose padded areas overlap.
+ *
+ * Expected result: <br>
+ * The bad planes are rejected, every picture sent is released once with the
+ * planes it was sent with, and both streams are identical.
+ *
+ * Test coverage:
+ * release_input, release_input_priv, svt_av1_enc_get_input_layout.
+ */
+TEST(EncApiTest, release_input_references_app_planes) {
+    const uint32_t frame_count = 12;
+    StreamEncoder copied, referenced;
+    ReleasedInputs released;
+
+    ASSERT_EQ(EB_ErrorNone, copied.create());
+    ASSERT_EQ(EB_ErrorNone, copied.open());
+    ASSERT_TRUE(copied.encode(frame_count));
+    copied.close();
+
+    ASSERT_EQ(EB_ErrorNone, referenced.create());
+    referenced.context_.enc_params.release_input = ReleasedInputs::release;
+    referenced.context_.enc_params.release_input_priv = &released;
+    ASSERT_EQ(EB_ErrorNone, referenced.open());
+    SvtAv1InputLayout layout;
+    ASSERT_EQ(EB_ErrorNone,
+              svt_av1_enc_get_input_layout(referenced.context_.enc_handle,
+                                           &layout));
+    EXPECT_GE(layout.y_stride, stream_width);
+    EXPECT_GE(layout.chroma_stride, stream_width / 2);
+
+    std::vector<std::unique_ptr<InputPlanes>> inputs;
+    for (uint32_t index = 0; index < frame_count; ++index)
+        inputs.emplace_back(new InputPlanes(layout, index));
+
+    EbSvtIOFormat bad_format = inputs[0]->format_;
+    bad_format.y_stride = layout.y_stride + 1;
+    EXPECT_EQ(EB_ErrorBadParameter,
+              inputs[0]->send(referenced.context_.enc_handle, &bad_format));
+    // Chroma in the bottom padding of the luma plane
+    bad_format = inputs[0]->format_;
+    bad_format.cb = bad_format.luma + layout.y_stride * stream_height;
+    EXPECT_EQ(EB_ErrorBadParameter,
+              inputs[0]->send(referenced.context_.enc_handle, &bad_format));
+    // Both chroma planes sharing one buffer
+    bad_format = inputs[0]->format_;
+    bad_format.cr = bad_format.cb;
+    EXPECT_EQ(EB_ErrorBadParameter,
+              inputs[0]->send(referenced.context_.enc_handle, &bad_format));
+
+    for (uint32_t index = 0; index < frame_count; ++index) {
+        ASSERT_EQ(EB_ErrorNone,
+                  inputs[index]->send(referenced.context_.enc_handle,
+                                      &inputs[index]->format_));
+        ASSERT_TRUE(referenced.drain(false));
+    }
+    ASSERT_EQ(EB_ErrorNone, referenced.send_eos());
+    ASSERT_TRUE(referenced.drain(true));
+    ASSERT_TRUE(referenced.eos_);
+
+    // The last pictures may be released by the pipeline after the end of
+    // stream packet
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (released.count() < frame_count &&
+           std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    referenced.close();
+
+    std::vector<uint32_t> index_array = released.index_array_;
+    std::sort(index_array.begin(), index_array.end());
+    ASSERT_EQ(frame_count, index_array.size());
+    for (uint32_t index = 0; index < frame_count; ++index)
+        EXPECT_EQ(index, index_array[index]);
+    EXPECT_TRUE(released.planes_match_);
+    EXPECT_EQ(copied.stream_, referenced.stream_);
+}
+
+/** @brief update_rate_control_mid_stream is a api test case
+ * EncApiTest.update_rate_control_mid_stream checks that the bitrate and the
+ * QP range can change while a stream is encoded
+ *
+ * Test strategy: <br>
+ * Encode with VBR and a high bitrate. Halfway through, try invalid targets,
+ * then lower the bitrate and raise the minimum QP. Also try an update on a
+ * CQP encoder.
+ *
+ * Expected result: <br>
+ * The invalid targets and the CQP update are rejected. The pictures of the
+ * mini-GOPs after the valid update use a QP in the new range and are smaller
+ * than the pictures before it.
+ *
+ * Test coverage:
+ * svt_av1_enc_update_rate_control, target_bit_rate, vbv_bufsize,
+ * max_qp_allowed, min_qp_allowed.
+ */
+TEST(EncApiTest, update_rate_control_mid_stream) {
+    const uint32_t frame_count = 64;
+    const uint32_t update_index = 32;
+    // Mini-GOPs are 16 pictures long, leave one for the update to apply
+    const int64_t updated_pts = update_index + 16;
+    const uint32_t updated_min_qp = 50;
+    StreamEncoder cqp, vbr;
+
+    ASSERT_EQ(EB_ErrorNone, cqp.create());
+    ASSERT_EQ(EB_ErrorNone, cqp.open());
+    SvtAv1RateControlTargets targets = {1000000, 0, 63, 1};
+    EXPECT_EQ(EB_ErrorBadParameter,
+              svt_av1_enc_update_rate_control(cqp.context_.enc_handle, &targets));
+    cqp.close();
+
+    ASSERT_EQ(EB_ErrorNone, vbr.create());
+    vbr.context_.enc_params.rate_control_mode = 1;
+    vbr.context_.enc_params.target_bit_rate = 2000000;
+    ASSERT_EQ(EB_ErrorNone, vbr.open());
+    EXPECT_EQ(EB_ErrorBadParameter,
+              svt_av1_enc_update_rate_control(vbr.context_.enc_handle, nullptr));
+
+    for (uint32_t index = 0; index < frame_count; ++index) {
+        if (index == update_index) {
+            const SvtAv1RateControlTargets bad_targets[] = {
+                {0, 0, 63, 1},  // no bitrate
+                {100000, 0, 64, 1},  // max QP out of range
+                {100000, 0, 63, 63},  // min QP out of range
+                {100000, 0, 40, 50},  // min QP above max QP
+            };
+            for (const SvtAv1RateControlTargets &bad : bad_targets)
+                EXPECT_EQ(EB_ErrorBadParameter,
+                          svt_av1_enc_update_rate_control(
+                              vbr.context_.enc_handle, &bad));
+            targets = {100000, 0, 63, updated_min_qp};
+            ASSERT_EQ(EB_ErrorNone,
+                      svt_av1_enc_update_rate_control(vbr.context_.enc_handle,
+                                                      &targets));
+        }
+        ASSERT_EQ(EB_ErrorNone, vbr.send_picture(index));
+        ASSERT_TRUE(vbr.drain(false));
+    }
+    ASSERT_EQ(EB_ErrorNone, vbr.send_eos());
+    ASSERT_TRUE(vbr.drain(true));
+    ASSERT_TRUE(vbr.eos_);
+    vbr.close();
+
+    uint64_t size_before = 0, size_after = 0;
+    uint32_t count_before = 0, count_after = 0;
+    for (const PacketInfo &packet : vbr.packet_array_) {
+        if (packet.pts >= updated_pts) {
+            EXPECT_GE(packet.qp, updated_min_qp) << "pts " << packet.pts;
+            size_after += packet.size;
+            ++count_after;
+        } else if (packet.pts > 0 && packet.pts < (int64_t)update_index) {
+            // The key frame is left out
+            size_before += packet.size;
+            ++count_before;
+        }
+    }
+    ASSERT_GT(count_before, 0u);
+    ASSERT_GT(count_after, 0u);
+    EXPECT_LT(size_after / count_after, size_before / count_before);
+}
+
+/** @brief reset_encodes_like_a_fresh_encoder is a api test case
+ * EncApiTest.reset_encodes_like_a_fresh_encoder checks that an encoder reset
+ * after a stream encodes the next stream as a new encoder would
+ *
+ * Test strategy: <br>
+ * Try a reset before the end of the first stream. Encode a VBR stream, reset
+ * the encoder and encode the same pictures again. Encode them with a new
+ * encoder too.
+ *
+ * Expected result: <br>
+ * The early reset is rejected. The stream encoded after the reset is the
+ * stream of the new encoder.
+ *
+ * Test coverage:
+ * svt_av1_enc_reset.
+ */
+TEST(EncApiTest, reset_encodes_like_a_fresh_encoder) {
+    const uint32_t frame_count = 24;
+    StreamEncoder reused, fresh;
+
+    for (StreamEncoder *encoder : {&reused, &fresh}) {
+        ASSERT_EQ(EB_ErrorNone, encoder->create());
+        encoder->context_.enc_params.rate_control_mode = 1;
+        encoder->context_.enc_params.target_bit_rate = 500000;
+        ASSERT_EQ(EB_ErrorNone, encoder->open());
+    }
+
+    EXPECT_EQ(EB_ErrorBadParameter, svt_av1_enc_reset(reused.context_.enc_handle));
+    ASSERT_TRUE(reused.encode(frame_count));
+    ASSERT_EQ(EB_ErrorNone, svt_av1_enc_reset(reused.context_.enc_handle));
+    reused.stream_.clear();
+    reused.packet_array_.clear();
+    reused.eos_ = false;
+    ASSERT_TRUE(reused.encode(frame_count));
+    reused.close();
+
+    ASSERT_TRUE(fresh.encode(frame_count));
+    fresh.close();
+
+    EXPECT_EQ(fresh.stream_, reused.stream_);
+}
+
+/** @brief elastic_buffers_encode_like_fixed_pools is a api test case
+ * EncApiTest.elastic_buffers_encode_like_fixed_pools checks that growing and
+ * shrinking the buffer pools while a stream is encoded does not change it
+ *
+ * Test strategy: <br>
+ * Encode a stream with the fixed buffer pools, and again with elastic buffer
+ * pools freeing their extra buffers after 1 ms without a wait. Send the
+ * pictures of the second stream in bursts so that the pools both grow and
+ * shrink.
+ *
+ * Expected result: <br>
+ * Both streams are the same.
+ *
+ * Test coverage:
+ * elastic_buffers, elastic_shrink_time.
+ */
+TEST(EncApiTest, elastic_buffers_encode_like_fixed_pools) {
+    const uint32_t frame_count = 48;
+    StreamEncoder fixed, elastic;
+
+    // The pools of 1 or 2 cores are sized for the minimum already
+    ASSERT_EQ(EB_ErrorNone, fixed.create());
+    fixed.context_.enc_params.logical_processors = 4;
+    ASSERT_EQ(EB_ErrorNone, fixed.open());
+    ASSERT_TRUE(fixed.encode(frame_count));
+    fixed.close();
+
+    ASSERT_EQ(EB_ErrorNone, elastic.create());
+    elastic.context_.enc_params.logical_processors = 4;
+    elastic.context_.enc_params.elastic_buffers = 1;
+    elastic.context_.enc_params.elastic_shrink_time = 1;
+    ASSERT_EQ(EB_ErrorNone, elastic.open());
+    for (uint32_t index = 0; index < frame_count; ++index) {
+        ASSERT_EQ(EB_ErrorNone, elastic.send_picture(index));
+        ASSERT_TRUE(elastic.drain(false));
+        if (index % 16 == 15)
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    ASSERT_EQ(EB_ErrorNone, elastic.send_eos());
+    ASSERT_TRUE(elastic.drain(true));
+    ASSERT_TRUE(elastic.eos_);
+    elastic.close();
+
+    EXPECT_EQ(fixed.stream_, elastic.stream_);
+}
+
+}  // namespace
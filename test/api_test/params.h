@@ -1073,6 +1073,53 @@ static const vector<uint8_t> default_superres_kf_denom = {8};
 static const vector<uint8_t> valid_superres_kf_denom = {8, 9, 10, 11, 12, 13, 14, 15, 16};
 static const vector<uint8_t> invalid_superres_kf_denom = {7};
 
+/* Run the stages as tasks on one pool of worker threads
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_task_scheduler = {0};
+static const vector<uint32_t> valid_task_scheduler = {0, 1};
+static const vector<uint32_t> invalid_task_scheduler = {2};
+
+/* Collect queue and busy time statistics per pipeline stage
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_stage_stats = {0};
+static const vector<uint32_t> valid_stage_stats = {0, 1};
+static const vector<uint32_t> invalid_stage_stats = {2};
+
+/* Buffer pools grow from their minimum count when a stage blocks, and free
+ * their extra buffers after elastic_shrink_time milliseconds without a wait
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_elastic_buffers = {0};
+static const vector<uint32_t> valid_elastic_buffers = {0, 1};
+static const vector<uint32_t> invalid_elastic_buffers = {2};
+
+static const vector<uint32_t> default_elastic_shrink_time = {0};
+static const vector<uint32_t> valid_elastic_shrink_time = {0, 1, 1000, 0xffffffff};
+static const vector<uint32_t> invalid_elastic_shrink_time = {/*none*/};
+
+/* Id of the shared engine the encoder runs on, 0 for its own threads
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_shared_engine = {0};
+static const vector<uint32_t> valid_shared_engine = {0, 1, 0xffffffff};
+static const vector<uint32_t> invalid_shared_engine = {/*none*/};
+
+/* Huge pages for the picture buffers, 0 off, 1 transparent, 2 explicit
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_huge_pages = {0};
+static const vector<uint32_t> valid_huge_pages = {0, 1, 2};
+static const vector<uint32_t> invalid_huge_pages = {3};
+
+/* Encode decode each tile as its own work unit
+ *
+ * Default is 0. */
+static const vector<uint32_t> default_tile_parallel_enc_dec = {0};
+static const vector<uint32_t> valid_tile_parallel_enc_dec = {0, 1};
+static const vector<uint32_t> invalid_tile_parallel_enc_dec = {2};
+
 }  // namespace svt_av1_test_params
 
 /** @} */  // end of svt_av1_test_params
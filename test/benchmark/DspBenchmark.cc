@@ -0,0 +1,702 @@
+/*
+* Copyright(c) 2019 Netflix, Inc.
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at https://www.aomedia.org/license/software-license. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at https://www.aomedia.org/license/patent-license.
+*/
+
+/******************************************************************************
+ * @file DspBenchmark.cc
+ *
+ * @brief Throughput benchmark of the rtcd kernels:
+ * - every benchmark calls the kernel through its rtcd pointer, after
+ *   setup_common_rtcd_internal() and setup_rtcd_internal() ran with the flags
+ *   of one ISA level (C, SSE4.1, AVX2, AVX-512)
+ * - a kernel is timed again at a higher level only when that level installs
+ *   another implementation
+ * - with --benchmark_threads=n, n threads run the kernel on their own buffers
+ *   at once, the way tiles and rows share the cores while encoding
+ *
+ * The command line and the console, json and csv outputs follow Google
+ * Benchmark, so the results of two library versions or CPUs can be diffed
+ * with its compare tools.
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EbSvtAv1.h"
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "common_dsp_rtcd.h"
+#include "EbCdef.h"
+#include "convolve.h"
+#include "filter.h"
+#include "random.h"
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace {
+
+/** Planes hold the largest block with room for the filter taps around it */
+const int kBorder = 32;
+const int kStride = MAX_SB_SIZE + 2 * kBorder;
+const int kPlaneSize = kStride * (MAX_SB_SIZE + 2 * kBorder);
+const int kOffset = kBorder * kStride + kBorder;
+
+/** Buffers of one benchmark thread */
+struct BenchBuffers {
+    explicit BenchBuffers(uint32_t seed)
+        : residual(MAX_SB_SQUARE),
+          coeff(MAX_SB_SQUARE),
+          cdef_in(CDEF_INBUF_SIZE),
+          sink(0),
+          src8_(kPlaneSize),
+          ref8_(kPlaneSize),
+          dst8_(kPlaneSize),
+          src16_(kPlaneSize),
+          ref16_(kPlaneSize),
+          dst16_(kPlaneSize) {
+        SVTRandom rnd8(0, 255, seed);
+        SVTRandom rnd10(0, (1 << 10) - 1, seed + 1);
+        SVTRandom rnd_residual(-255, 255, seed + 2);
+        SVTRandom rnd_coeff(-64, 64, seed + 3);
+        for (int i = 0; i < kPlaneSize; i++) {
+            src8_[i] = rnd8.random();
+            ref8_[i] = rnd8.random();
+            src16_[i] = rnd10.random();
+            ref16_[i] = rnd10.random();
+        }
+        for (int i = 0; i < MAX_SB_SQUARE; i++) {
+            residual[i] = rnd_residual.random();
+            coeff[i] = rnd_coeff.random();
+        }
+        for (int i = 0; i < CDEF_INBUF_SIZE; i++)
+            cdef_in[i] = rnd10.random();
+        src8 = src8_.data() + kOffset;
+        ref8 = ref8_.data() + kOffset;
+        dst8 = dst8_.data() + kOffset;
+        src16 = src16_.data() + kOffset;
+        ref16 = ref16_.data() + kOffset;
+        dst16 = dst16_.data() + kOffset;
+    }
+
+    uint8_t *src8, *ref8, *dst8;
+    uint16_t *src16, *ref16, *dst16;
+    std::vector<int16_t> residual;
+    std::vector<int32_t> coeff;
+    std::vector<uint16_t> cdef_in;
+    uint64_t sink;  // results of the kernels, so no call is optimized out
+
+  private:
+    std::vector<uint8_t> src8_, ref8_, dst8_;
+    std::vector<uint16_t> src16_, ref16_, dst16_;
+};
+
+/** Common type of the rtcd pointers, to tell implementations apart */
+typedef void (*AnyFunc)(void);
+
+template <typename Func>
+AnyFunc any_func(Func func) {
+    return reinterpret_cast<AnyFunc>(func);
+}
+
+struct Benchmark {
+    std::string name;  // rtcd pointer, size and bit depth
+    int width;
+    int height;
+    int bit_depth;
+    std::function<AnyFunc()> kernel;  // rtcd pointer in use
+    std::function<void(BenchBuffers &)> run;
+};
+
+std::string bench_name(const char *kernel, int width, int height, int bit_depth) {
+    return std::string(kernel) + "/" + std::to_string(width) + "x" +
+           std::to_string(height) + "/" + std::to_string(bit_depth) + "bit";
+}
+
+/* The body runs with the buffers of the thread as b, and is the last argument
+ * so it may hold commas */
+#define ADD_BENCH(list, kernel, w, h, bd, ...)                                \
+    list.push_back({bench_name(#kernel, w, h, bd),                            \
+                    w,                                                        \
+                    h,                                                        \
+                    bd,                                                       \
+                    [] { return any_func(kernel); },                          \
+                    [=](BenchBuffers & b) mutable { __VA_ARGS__; }})
+
+#define TX_SIZES(X)                                                           \
+    X(4, 4) X(4, 8) X(8, 4) X(8, 8) X(4, 16) X(16, 4) X(8, 16) X(16, 8)       \
+    X(16, 16) X(8, 32) X(32, 8) X(16, 32) X(32, 16) X(32, 32) X(16, 64)       \
+    X(64, 16) X(32, 64) X(64, 32) X(64, 64)
+
+#define BLOCK_SIZES(X) TX_SIZES(X) X(64, 128) X(128, 64) X(128, 128)
+
+#define SQUARE_SIZES(X) X(8, 8) X(16, 16) X(32, 32) X(64, 64) X(128, 128)
+
+void add_sad(std::vector<Benchmark> &list) {
+#define ADD_SAD(w, h)                                                         \
+    ADD_BENCH(list, svt_aom_sad##w##x##h, w, h, 8,                            \
+              b.sink += svt_aom_sad##w##x##h(b.src8, kStride, b.ref8, kStride));
+    BLOCK_SIZES(ADD_SAD)
+#undef ADD_SAD
+#define ADD_SAD_X4D(w, h)                                                     \
+    ADD_BENCH(list, svt_aom_sad##w##x##h##x4d, w, h, 8, {                     \
+        const uint8_t *const refs[4] = {b.ref8, b.ref8 + 1, b.ref8 + 2, b.ref8 + 3}; \
+        uint32_t sad[4];                                                      \
+        svt_aom_sad##w##x##h##x4d(b.src8, kStride, refs, kStride, sad);        \
+        b.sink += sad[0] + sad[3];                                            \
+    });
+    BLOCK_SIZES(ADD_SAD_X4D)
+#undef ADD_SAD_X4D
+}
+
+void add_variance(std::vector<Benchmark> &list) {
+#define ADD_VARIANCE(w, h)                                                    \
+    ADD_BENCH(list, svt_aom_variance##w##x##h, w, h, 8, {                     \
+        unsigned int sse;                                                     \
+        b.sink += svt_aom_variance##w##x##h(b.src8, kStride, b.ref8, kStride, &sse); \
+    });                                                                       \
+    ADD_BENCH(list, svt_aom_highbd_10_variance##w##x##h, w, h, 10, {          \
+        unsigned int sse;                                                     \
+        b.sink += svt_aom_highbd_10_variance##w##x##h(                        \
+            CONVERT_TO_BYTEPTR(b.src16), kStride, CONVERT_TO_BYTEPTR(b.ref16), kStride, &sse); \
+    });
+    BLOCK_SIZES(ADD_VARIANCE)
+#undef ADD_VARIANCE
+}
+
+void add_fwd_txfm(std::vector<Benchmark> &list) {
+#define ADD_FWD_TXFM(w, h)                                                    \
+    for (int bd = 8; bd <= 10; bd += 2)                                       \
+        ADD_BENCH(list, svt_av1_fwd_txfm2d_##w##x##h, w, h, bd,               \
+                  svt_av1_fwd_txfm2d_##w##x##h(                               \
+                      b.residual.data(), b.coeff.data(), w, DCT_DCT, (uint8_t)bd));
+    TX_SIZES(ADD_FWD_TXFM)
+#undef ADD_FWD_TXFM
+}
+
+/* The inverse transforms of square, rectangular and 4xn/nx4 blocks differ in
+ * their arguments */
+typedef void (*InvTxfmSquare)(const int32_t *input, uint16_t *output_r, int32_t stride_r,
+                              uint16_t *output_w, int32_t stride_w, TxType tx_type,
+                              int32_t bd);
+typedef void (*InvTxfmRect)(const int32_t *input, uint16_t *output_r, int32_t stride_r,
+                            uint16_t *output_w, int32_t stride_w, TxType tx_type,
+                            TxSize tx_size, int32_t eob, int32_t bd);
+typedef void (*InvTxfmRect4)(const int32_t *input, uint16_t *output_r, int32_t stride_r,
+                             uint16_t *output_w, int32_t stride_w, TxType tx_type,
+                             TxSize tx_size, int32_t bd);
+
+void inv_txfm(InvTxfmSquare func, BenchBuffers &b, TxSize, int32_t, int32_t bd) {
+    func(b.coeff.data(), b.dst16, kStride, b.dst16, kStride, DCT_DCT, bd);
+}
+void inv_txfm(InvTxfmRect func, BenchBuffers &b, TxSize tx_size, int32_t eob, int32_t bd) {
+    func(b.coeff.data(), b.dst16, kStride, b.dst16, kStride, DCT_DCT, tx_size, eob, bd);
+}
+void inv_txfm(InvTxfmRect4 func, BenchBuffers &b, TxSize tx_size, int32_t, int32_t bd) {
+    func(b.coeff.data(), b.dst16, kStride, b.dst16, kStride, DCT_DCT, tx_size, bd);
+}
+
+void add_inv_txfm(std::vector<Benchmark> &list) {
+#define ADD_INV_TXFM(w, h)                                                    \
+    for (int bd = 8; bd <= 10; bd += 2)                                       \
+        ADD_BENCH(list, svt_av1_inv_txfm2d_add_##w##x##h, w, h, bd,           \
+                  inv_txfm(svt_av1_inv_txfm2d_add_##w##x##h, b, TX_##w##X##h,  \
+                           AOMMIN(w, 32) * AOMMIN(h, 32), bd));
+    TX_SIZES(ADD_INV_TXFM)
+#undef ADD_INV_TXFM
+}
+
+void add_convolve(std::vector<Benchmark> &list) {
+#define ADD_CONVOLVE(w, h)                                                    \
+    {                                                                         \
+        InterpFilterParams fx = av1_get_interp_filter_params_with_block_size( \
+            EIGHTTAP_REGULAR, w);                                             \
+        InterpFilterParams fy = av1_get_interp_filter_params_with_block_size( \
+            EIGHTTAP_REGULAR, h);                                             \
+        ConvolveParams conv8 = get_conv_params_no_round(0, 0, 0, nullptr, 0, 0, 8); \
+        ConvolveParams conv10 = get_conv_params_no_round(0, 0, 0, nullptr, 0, 0, 10); \
+        ADD_BENCH(list, svt_av1_convolve_2d_sr, w, h, 8,                      \
+                  svt_av1_convolve_2d_sr(                                     \
+                      b.src8, kStride, b.dst8, kStride, w, h, &fx, &fy, 8, 8, &conv8)); \
+        ADD_BENCH(list, svt_av1_convolve_x_sr, w, h, 8,                       \
+                  svt_av1_convolve_x_sr(                                      \
+                      b.src8, kStride, b.dst8, kStride, w, h, &fx, &fy, 8, 0, &conv8)); \
+        ADD_BENCH(list, svt_av1_convolve_y_sr, w, h, 8,                       \
+                  svt_av1_convolve_y_sr(                                      \
+                      b.src8, kStride, b.dst8, kStride, w, h, &fx, &fy, 0, 8, &conv8)); \
+        ADD_BENCH(list, svt_av1_highbd_convolve_2d_sr, w, h, 10,              \
+                  svt_av1_highbd_convolve_2d_sr(                              \
+                      b.src16, kStride, b.dst16, kStride, w, h, &fx, &fy, 8, 8, &conv10, 10)); \
+        ADD_BENCH(list, svt_av1_highbd_convolve_x_sr, w, h, 10,               \
+                  svt_av1_highbd_convolve_x_sr(                               \
+                      b.src16, kStride, b.dst16, kStride, w, h, &fx, &fy, 8, 0, &conv10, 10)); \
+        ADD_BENCH(list, svt_av1_highbd_convolve_y_sr, w, h, 10,               \
+                  svt_av1_highbd_convolve_y_sr(                               \
+                      b.src16, kStride, b.dst16, kStride, w, h, &fx, &fy, 0, 8, &conv10, 10)); \
+    }
+    BLOCK_SIZES(ADD_CONVOLVE)
+#undef ADD_CONVOLVE
+}
+
+void add_intra(std::vector<Benchmark> &list) {
+#define ADD_DC_PRED(w, h)                                                     \
+    ADD_BENCH(list, svt_aom_dc_predictor_##w##x##h, w, h, 8,                  \
+              svt_aom_dc_predictor_##w##x##h(                                 \
+                  b.dst8, kStride, b.ref8 - kStride, b.ref8 - 1));            \
+    ADD_BENCH(list, svt_aom_highbd_dc_predictor_##w##x##h, w, h, 10,          \
+              svt_aom_highbd_dc_predictor_##w##x##h(                          \
+                  b.dst16, kStride, b.ref16 - kStride, b.ref16 - 1, 10));
+    TX_SIZES(ADD_DC_PRED)
+#undef ADD_DC_PRED
+}
+
+void add_picture_operators(std::vector<Benchmark> &list) {
+#define ADD_PICTURE_OPERATORS(w, h)                                           \
+    ADD_BENCH(list, svt_aom_subtract_block, w, h, 8,                          \
+              svt_aom_subtract_block(                                         \
+                  h, w, b.residual.data(), w, b.src8, kStride, b.ref8, kStride)); \
+    ADD_BENCH(list, svt_residual_kernel8bit, w, h, 8,                         \
+              svt_residual_kernel8bit(                                        \
+                  b.src8, kStride, b.ref8, kStride, b.residual.data(), w, w, h)); \
+    ADD_BENCH(list, svt_residual_kernel16bit, w, h, 10,                       \
+              svt_residual_kernel16bit(                                       \
+                  b.src16, kStride, b.ref16, kStride, b.residual.data(), w, w, h)); \
+    ADD_BENCH(list, svt_spatial_full_distortion_kernel, w, h, 8,              \
+              b.sink += svt_spatial_full_distortion_kernel(                   \
+                  b.src8, 0, kStride, b.ref8, 0, kStride, w, h));             \
+    ADD_BENCH(list, svt_full_distortion_kernel16_bits, w, h, 10,              \
+              b.sink += svt_full_distortion_kernel16_bits(                    \
+                  (uint8_t *)b.src16, 0, kStride, (uint8_t *)b.ref16, 0, kStride, w, h)); \
+    ADD_BENCH(list, svt_aom_sse, w, h, 8,                                     \
+              b.sink += svt_aom_sse(b.src8, kStride, b.ref8, kStride, w, h)); \
+    ADD_BENCH(list, svt_aom_highbd_sse, w, h, 10,                             \
+              b.sink += svt_aom_highbd_sse(                                   \
+                  (uint8_t *)b.src16, kStride, (uint8_t *)b.ref16, kStride, w, h)); \
+    ADD_BENCH(list, svt_picture_average_kernel, w, h, 8,                      \
+              svt_picture_average_kernel(                                     \
+                  b.src8, kStride, b.ref8, kStride, b.dst8, kStride, w, h));
+    SQUARE_SIZES(ADD_PICTURE_OPERATORS)
+#undef ADD_PICTURE_OPERATORS
+}
+
+void add_loop_filters(std::vector<Benchmark> &list) {
+    for (int bd = 8; bd <= 10; bd += 2) {
+        const int shift = bd - 8;
+        ADD_BENCH(list, svt_cdef_find_dir, 8, 8, bd, {
+            int32_t var;
+            b.sink += svt_cdef_find_dir(b.src16, kStride, &var, shift);
+        });
+        ADD_BENCH(list, svt_cdef_filter_block, 8, 8, bd,
+                  svt_cdef_filter_block(shift ? nullptr : b.dst8,
+                                        b.dst16,
+                                        kStride,
+                                        b.cdef_in.data() + CDEF_HBORDER +
+                                            CDEF_VBORDER * CDEF_BSTRIDE,
+                                        4 << shift,
+                                        2 << shift,
+                                        2,
+                                        3 + shift,
+                                        3 + shift,
+                                        BLOCK_8X8,
+                                        shift));
+    }
+
+    static const int16_t wiener_filter[8] = {3, -7, 15, -22, 15, -7, 3, 0};
+#define ADD_WIENER(w, h)                                                      \
+    {                                                                         \
+        ConvolveParams conv8 = get_conv_params_wiener(8);                     \
+        ConvolveParams conv10 = get_conv_params_wiener(10);                   \
+        ADD_BENCH(list, svt_av1_wiener_convolve_add_src, w, h, 8,             \
+                  svt_av1_wiener_convolve_add_src(b.src8,                     \
+                                                  kStride,                    \
+                                                  b.dst8,                     \
+                                                  kStride,                    \
+                                                  wiener_filter,              \
+                                                  wiener_filter,              \
+                                                  w,                          \
+                                                  h,                          \
+                                                  &conv8));                   \
+        ADD_BENCH(list, svt_av1_highbd_wiener_convolve_add_src, w, h, 10,     \
+                  svt_av1_highbd_wiener_convolve_add_src(CONVERT_TO_BYTEPTR(b.src16), \
+                                                         kStride,             \
+                                                         CONVERT_TO_BYTEPTR(b.dst16), \
+                                                         kStride,             \
+                                                         wiener_filter,       \
+                                                         wiener_filter,       \
+                                                         w,                   \
+                                                         h,                   \
+                                                         &conv10,             \
+                                                         10));                \
+    }
+    SQUARE_SIZES(ADD_WIENER)
+#undef ADD_WIENER
+}
+
+void add_warp(std::vector<Benchmark> &list) {
+    // Translation by half a sample with a small zoom
+    static const int32_t mat[6] = {1 << (WARPEDMODEL_PREC_BITS - 1),
+                                   1 << (WARPEDMODEL_PREC_BITS - 1),
+                                   (1 << WARPEDMODEL_PREC_BITS) + 64,
+                                   0,
+                                   0,
+                                   (1 << WARPEDMODEL_PREC_BITS) + 64};
+#define ADD_WARP(w, h)                                                        \
+    {                                                                         \
+        ConvolveParams conv8 = get_conv_params_no_round(0, 0, 0, nullptr, 0, 0, 8); \
+        ConvolveParams conv10 = get_conv_params_no_round(0, 0, 0, nullptr, 0, 0, 10); \
+        ADD_BENCH(list, svt_av1_warp_affine, w, h, 8,                         \
+                  svt_av1_warp_affine(mat, b.ref8, MAX_SB_SIZE, MAX_SB_SIZE, kStride, \
+                                      b.dst8, 0, 0, w, h, kStride, 0, 0, &conv8, \
+                                      64, 0, 0, 64));                         \
+        ADD_BENCH(list, svt_av1_highbd_warp_affine, w, h, 10,                 \
+                  svt_av1_highbd_warp_affine(mat, b.ref16, MAX_SB_SIZE, MAX_SB_SIZE, \
+                                             kStride, b.dst16, 0, 0, w, h, kStride, \
+                                             0, 0, 10, &conv10, 64, 0, 0, 64)); \
+    }
+    SQUARE_SIZES(ADD_WARP)
+#undef ADD_WARP
+}
+
+std::vector<Benchmark> all_benchmarks() {
+    std::vector<Benchmark> list;
+    add_sad(list);
+    add_variance(list);
+    add_fwd_txfm(list);
+    add_inv_txfm(list);
+    add_convolve(list);
+    add_intra(list);
+    add_picture_operators(list);
+    add_loop_filters(list);
+    add_warp(list);
+    return list;
+}
+
+struct IsaLevel {
+    const char *name;
+    CPU_FLAGS flags;  // all the flags up to this level
+};
+
+const CPU_FLAGS kSse4_1Flags = CPU_FLAGS_MMX | CPU_FLAGS_SSE | CPU_FLAGS_SSE2 |
+                               CPU_FLAGS_SSE3 | CPU_FLAGS_SSSE3 | CPU_FLAGS_SSE4_1 |
+                               CPU_FLAGS_SSE4_2;
+const CPU_FLAGS kAvx2Flags = kSse4_1Flags | CPU_FLAGS_AVX | CPU_FLAGS_AVX2;
+const CPU_FLAGS kAvx512Flags = kAvx2Flags | CPU_FLAGS_AVX512F | CPU_FLAGS_AVX512CD |
+                               CPU_FLAGS_AVX512DQ | CPU_FLAGS_AVX512BW |
+                               CPU_FLAGS_AVX512VL;
+
+const IsaLevel kIsaLevels[] = {
+    {"c", 0}, {"sse4_1", kSse4_1Flags}, {"avx2", kAvx2Flags}, {"avx512", kAvx512Flags}};
+
+struct Options {
+    std::string filter = ".";
+    std::string format = "console";
+    std::string out;
+    std::string out_format = "json";
+    std::string isa = "c,sse4_1,avx2,avx512";
+    double min_time = 0.1;
+    int threads = 1;
+    bool list_tests = false;
+};
+
+struct Result {
+    std::string name;
+    const char *isa;
+    const Benchmark *bench;
+    int threads;
+    uint64_t iterations;
+    double real_time_ns;  // per call of one thread
+    double items_per_second;  // pixels of all the threads
+};
+
+/* Runs the kernel iterations times on every thread, returns the seconds the
+ * slowest thread took from the common start */
+double time_run(const Benchmark &bench,
+                std::vector<std::unique_ptr<BenchBuffers>> &buffers,
+                uint64_t iterations) {
+    const int threads = (int)buffers.size();
+    if (threads == 1) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++)
+            bench.run(*buffers[0]);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            // each thread its own copy, the kernels keep state in the closures
+            Benchmark local = bench;
+            ready++;
+            while (!go)
+                std::this_thread::yield();
+            for (uint64_t i = 0; i < iterations; i++)
+                local.run(*buffers[t]);
+        });
+    }
+    while (ready != threads)
+        std::this_thread::yield();
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &worker : workers)
+        worker.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Result run_benchmark(const Benchmark &bench, const char *isa, const std::string &name,
+                     const Options &options) {
+    std::vector<std::unique_ptr<BenchBuffers>> buffers;
+    for (int t = 0; t < options.threads; t++)
+        buffers.emplace_back(new BenchBuffers(t + 1));
+
+    // Grow the iterations until a run lasts min_time, as Google Benchmark does
+    uint64_t iterations = 1;
+    double seconds;
+    for (;;) {
+        seconds = time_run(bench, buffers, iterations);
+        if (seconds >= options.min_time || iterations >= 1000000000)
+            break;
+        const double multiplier =
+            std::min(10.0, options.min_time * 1.4 / std::max(seconds, 1e-9));
+        iterations = std::max(iterations + 1, (uint64_t)(iterations * multiplier));
+    }
+
+    Result result;
+    result.name = name;
+    result.isa = isa;
+    result.bench = &bench;
+    result.threads = options.threads;
+    result.iterations = iterations;
+    result.real_time_ns = seconds * 1e9 / iterations;
+    result.items_per_second = (double)bench.width * bench.height * iterations *
+                              options.threads / seconds;
+    for (auto &b : buffers)
+        if (b->sink == 1)  // keeps the results alive
+            fputc(' ', stderr);
+    return result;
+}
+
+void print_console_header(FILE *file) {
+    fprintf(file, "%-60s %14s %12s %12s\n", "Benchmark", "Time", "Iterations", "Pixels");
+    fprintf(file, "%s\n", std::string(101, '-').c_str());
+}
+
+void print_console(FILE *file, const Result &r) {
+    fprintf(file,
+            "%-60s %11.1f ns %12" PRIu64 " %9.1fM/s\n",
+            r.name.c_str(),
+            r.real_time_ns,
+            r.iterations,
+            r.items_per_second / 1e6);
+    fflush(file);
+}
+
+std::string date_string() {
+    char date[64];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    return date;
+}
+
+void print_json(FILE *file, const char *executable, const std::vector<Result> &results) {
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date_string().c_str());
+    fprintf(file, "    \"executable\": \"%s\",\n", executable);
+    fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(file, "    \"cpu_flags\": \"0x%" PRIx64 "\",\n", (uint64_t)get_cpu_flags());
+    fprintf(file,
+            "    \"library_version\": \"%d.%d.%d\",\n",
+            SVT_VERSION_MAJOR,
+            SVT_VERSION_MINOR,
+            SVT_VERSION_PATCHLEVEL);
+#ifdef NDEBUG
+    fprintf(file, "    \"library_build_type\": \"release\"\n");
+#else
+    fprintf(file, "    \"library_build_type\": \"debug\"\n");
+#endif
+    fprintf(file, "  },\n  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(file, "%s\n    {\n", i ? "," : "");
+        fprintf(file, "      \"name\": \"%s\",\n", r.name.c_str());
+        fprintf(file, "      \"run_name\": \"%s\",\n", r.name.c_str());
+        fprintf(file, "      \"run_type\": \"iteration\",\n");
+        fprintf(file, "      \"kernel\": \"%s\",\n", r.bench->name.c_str());
+        fprintf(file, "      \"isa\": \"%s\",\n", r.isa);
+        fprintf(file, "      \"width\": %d,\n", r.bench->width);
+        fprintf(file, "      \"height\": %d,\n", r.bench->height);
+        fprintf(file, "      \"bit_depth\": %d,\n", r.bench->bit_depth);
+        fprintf(file, "      \"threads\": %d,\n", r.threads);
+        fprintf(file, "      \"iterations\": %" PRIu64 ",\n", r.iterations);
+        fprintf(file, "      \"real_time\": %.3f,\n", r.real_time_ns);
+        fprintf(file, "      \"cpu_time\": %.3f,\n", r.real_time_ns);
+        fprintf(file, "      \"time_unit\": \"ns\",\n");
+        fprintf(file, "      \"items_per_second\": %.1f\n", r.items_per_second);
+        fprintf(file, "    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+void print_csv(FILE *file, const std::vector<Result> &results) {
+    fprintf(file,
+            "name,iterations,real_time,cpu_time,time_unit,items_per_second,"
+            "isa,width,height,bit_depth,threads\n");
+    for (const Result &r : results)
+        fprintf(file,
+                "\"%s\",%" PRIu64 ",%.3f,%.3f,ns,%.1f,%s,%d,%d,%d,%d\n",
+                r.name.c_str(),
+                r.iterations,
+                r.real_time_ns,
+                r.real_time_ns,
+                r.items_per_second,
+                r.isa,
+                r.bench->width,
+                r.bench->height,
+                r.bench->bit_depth,
+                r.threads);
+}
+
+void print_results(FILE *file, const std::string &format, const char *executable,
+                   const std::vector<Result> &results) {
+    if (format == "json")
+        print_json(file, executable, results);
+    else if (format == "csv")
+        print_csv(file, results);
+    else {
+        print_console_header(file);
+        for (const Result &r : results)
+            print_console(file, r);
+    }
+}
+
+void usage(const char *executable) {
+    fprintf(stderr,
+            "usage: %s [--benchmark_list_tests]\n"
+            "          [--benchmark_filter=<regex>]\n"
+            "          [--benchmark_min_time=<seconds>]\n"
+            "          [--benchmark_threads=<n>]\n"
+            "          [--benchmark_format=<console|json|csv>]\n"
+            "          [--benchmark_out=<file>]\n"
+            "          [--benchmark_out_format=<console|json|csv>]\n"
+            "          [--isa=<c,sse4_1,avx2,avx512>]\n",
+            executable);
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--benchmark_list_tests")
+            options.list_tests = value.empty() || value == "true";
+        else if (key == "--benchmark_filter")
+            options.filter = value;
+        else if (key == "--benchmark_min_time")
+            options.min_time = atof(value.c_str());
+        else if (key == "--benchmark_threads")
+            options.threads = std::max(1, atoi(value.c_str()));
+        else if (key == "--benchmark_format")
+            options.format = value;
+        else if (key == "--benchmark_out")
+            options.out = value;
+        else if (key == "--benchmark_out_format")
+            options.out_format = value;
+        else if (key == "--isa")
+            options.isa = value;
+        else
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::vector<Benchmark> benchmarks = all_benchmarks();
+    std::regex filter;
+    try {
+        filter = std::regex(options.filter);
+    } catch (const std::regex_error &) {
+        fprintf(stderr, "Invalid --benchmark_filter %s\n", options.filter.c_str());
+        return 1;
+    }
+
+    FILE *out = nullptr;
+    if (!options.out.empty() && !(out = fopen(options.out.c_str(), "w"))) {
+        fprintf(stderr, "Cannot open %s\n", options.out.c_str());
+        return 1;
+    }
+
+    const CPU_FLAGS cpu_flags = get_cpu_flags_to_use();
+    std::vector<AnyFunc> previous(benchmarks.size(), nullptr);
+    std::vector<Result> results;
+    if (options.format == "console" && !options.list_tests)
+        print_console_header(stdout);
+    for (const IsaLevel &level : kIsaLevels) {
+        if (("," + options.isa + ",").find(std::string(",") + level.name + ",") ==
+            std::string::npos)
+            continue;
+        if ((cpu_flags & level.flags) != level.flags) {
+            fprintf(stderr, "Skipping %s, not supported by this CPU\n", level.name);
+            continue;
+        }
+        setup_common_rtcd_internal(level.flags);
+        setup_rtcd_internal(level.flags);
+
+        for (size_t i = 0; i < benchmarks.size(); i++) {
+            const Benchmark &bench = benchmarks[i];
+            // A level without its own implementation would time the one below again
+            const AnyFunc kernel = bench.kernel();
+            if (kernel == previous[i])
+                continue;
+            previous[i] = kernel;
+
+            std::string name = bench.name + "/" + level.name;
+            if (options.threads > 1)
+                name += "/threads:" + std::to_string(options.threads);
+            if (!std::regex_search(name, filter))
+                continue;
+            if (options.list_tests) {
+                printf("%s\n", name.c_str());
+                continue;
+            }
+            results.push_back(run_benchmark(bench, level.name, name, options));
+            if (options.format == "console")
+                print_console(stdout, results.back());
+        }
+    }
+
+    if (options.format != "console" && !options.list_tests)
+        print_results(stdout, options.format, argv[0], results);
+    if (out) {
+        print_results(out, options.out_format, argv[0], results);
+        fclose(out);
+    }
+    return 0;
+}